@@ -0,0 +1,177 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "BasicTypes.h"
+#include "Errors.hpp"
+
+namespace Diligent
+{
+
+/// Registry of per-thread objects that belong to the instances of one owner class.
+
+/// Every owner allocates a slot when it is created. Every thread keeps a table of objects
+/// indexed by the slots, so that an owner finds the object of the calling thread without
+/// any synchronization. The slot of a destroyed owner is reused by the next owner.
+///
+/// ObjectType must be constructible from OwnerType* and must have the std::atomic<OwnerType*> pOwner
+/// member. The owner must reset the member to null under the registry mutex when it is destroyed.
+/// When a thread exits, OwnerType::OnThreadExit(ObjectType&) is called under the registry mutex
+/// for every object of the thread whose owner is still alive; the object is deleted afterwards.
+/// From that point on, GetThreadObject() returns null in this thread, and the owner must use
+/// a path that does not require a thread object (see IsThreadTableDestroyed()).
+template <typename OwnerType, typename ObjectType>
+class ThreadSlotRegistry
+{
+public:
+    /// Protects slot allocation and the links between objects and owners
+    static std::mutex& GetMutex()
+    {
+        static std::mutex RegistryMtx;
+        return RegistryMtx;
+    }
+
+    /// Must be called while the registry mutex is locked
+    static Uint32 AllocateSlot()
+    {
+        auto& FreeSlots = GetFreeSlots();
+        if (!FreeSlots.empty())
+        {
+            auto Slot = FreeSlots.back();
+            FreeSlots.pop_back();
+            return Slot;
+        }
+
+        static Uint32 NextSlot = 0;
+        return NextSlot++;
+    }
+
+    /// Must be called while the registry mutex is locked
+    static void ReleaseSlot(Uint32 Slot)
+    {
+        GetFreeSlots().push_back(Slot);
+    }
+
+    /// Returns true if the table of the calling thread has been destroyed.
+
+    /// This happens when destructors of thread-local objects that run after the table destructor
+    /// use an owner. Such calls must not create thread objects and must fall back to a locked path.
+    static bool IsThreadTableDestroyed()
+    {
+        return GetThreadTableDestroyed();
+    }
+
+    /// Returns the object of the calling thread in the given slot if it belongs to pOwner, and null otherwise.
+    static ObjectType* GetThreadObject(Uint32 Slot, const OwnerType* pOwner)
+    {
+        // The table must not be accessed after it has been destroyed
+        if (GetThreadTableDestroyed())
+            return nullptr;
+
+        const auto& Objects = GetThreadTable().Objects;
+        if (Slot < Objects.size())
+        {
+            auto* pObject = Objects[Slot];
+            // The slot may be occupied by the object of a destroyed owner
+            if (pObject != nullptr && pObject->pOwner.load(std::memory_order_relaxed) == pOwner)
+                return pObject;
+        }
+        return nullptr;
+    }
+
+    /// Creates the object of the calling thread for pOwner in the given slot.
+    /// Must be called while the registry mutex is locked and the thread table has not been destroyed.
+    static ObjectType* CreateThreadObject(Uint32 Slot, OwnerType* pOwner)
+    {
+        VERIFY(!GetThreadTableDestroyed(), "Thread objects can't be created after the thread table has been destroyed");
+
+        auto& Objects = GetThreadTable().Objects;
+        if (Slot >= Objects.size())
+            Objects.resize(size_t{Slot} + 1);
+
+        auto*& pObject = Objects[Slot];
+        if (pObject != nullptr)
+        {
+            // The object was left by a destroyed owner
+            VERIFY_EXPR(pObject->pOwner.load() == nullptr);
+            delete pObject;
+        }
+        pObject = new ObjectType{pOwner};
+        return pObject;
+    }
+
+private:
+    struct ThreadTable
+    {
+        ~ThreadTable()
+        {
+            // Owners used by the destructors below and by the destructors of thread-local
+            // objects destroyed after the table take the locked path
+            GetThreadTableDestroyed() = true;
+
+            std::lock_guard<std::mutex> Lock{GetMutex()};
+            for (auto* pObject : Objects)
+            {
+                if (pObject == nullptr)
+                    continue;
+
+                if (auto* pOwner = pObject->pOwner.load())
+                    pOwner->OnThreadExit(*pObject);
+                delete pObject;
+            }
+        }
+
+        std::vector<ObjectType*> Objects;
+    };
+
+    static ThreadTable& GetThreadTable()
+    {
+        static thread_local ThreadTable Table;
+        return Table;
+    }
+
+    // The flag is trivially destructible, so it remains accessible while the thread-local
+    // objects of the exiting thread are being destroyed
+    static bool& GetThreadTableDestroyed()
+    {
+        static thread_local bool Destroyed = false;
+        return Destroyed;
+    }
+
+    static std::vector<Uint32>& GetFreeSlots()
+    {
+        static std::vector<Uint32> FreeSlots;
+        return FreeSlots;
+    }
+};
+
+} // namespace Diligent
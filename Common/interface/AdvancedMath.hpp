@@ -30,6 +30,7 @@
 #include <float.h>
 
 #include "../../Platforms/interface/PlatformDefinitions.h"
+#include "../../Platforms/interface/PlatformMisc.hpp"
 #include "../../Primitives/interface/FlagEnum.h"
 
 #include "BasicMath.hpp"
@@ -425,6 +426,295 @@ inline BoxVisibility GetBoxVisibility(const ViewFrustumExt& ViewFrustumExt,
     return BoxVisibility::Intersecting;
 }
 
+/// Structure-of-arrays representation of a set of axis-aligned bounding boxes
+/// that is used by the batch culling functions. Box i is defined by
+/// [MinX[i], MaxX[i]] x [MinY[i], MaxY[i]] x [MinZ[i], MaxZ[i]].
+struct BoundBoxSoA
+{
+    const float* MinX = nullptr;
+    const float* MinY = nullptr;
+    const float* MinZ = nullptr;
+    const float* MaxX = nullptr;
+    const float* MaxY = nullptr;
+    const float* MaxZ = nullptr;
+
+    Uint32 NumBoxes = 0;
+};
+
+/// Returns the number of 32-bit words required to store the visibility mask for NumBoxes boxes.
+constexpr Uint32 GetBoxVisibilityMaskSize(Uint32 NumBoxes)
+{
+    return (NumBoxes + 31) / 32;
+}
+
+namespace detail
+{
+
+// Implementation of both GetBoxVisibilityMask() overloads. If pFrustumExt is not null,
+// it must point to Frustum, and the frustum corners are tested against the box planes too.
+inline void GetBoxVisibilityMaskImpl(const ViewFrustum&    Frustum,
+                                     const ViewFrustumExt* pFrustumExt,
+                                     const BoundBoxSoA&    Boxes,
+                                     Uint32*               pVisibleMask,
+                                     Uint32*               pFullyVisibleMask,
+                                     FRUSTUM_PLANE_FLAGS   PlaneFlags,
+                                     Uint32                FirstBox,
+                                     Uint32                NumBoxes)
+{
+    VERIFY((FirstBox % 32) == 0, "First box index (", FirstBox, ") must be a multiple of 32");
+    VERIFY(FirstBox <= Boxes.NumBoxes, "First box index (", FirstBox, ") is out of range");
+    VERIFY_EXPR(pVisibleMask != nullptr);
+
+    NumBoxes = std::min(NumBoxes, Boxes.NumBoxes - FirstBox);
+
+#if DILIGENT_SIMD_MATH_LEVEL > 0
+    const bool TestFrustumCorners = pFrustumExt != nullptr && (PlaneFlags & FRUSTUM_PLANE_FLAG_FULL_FRUSTUM) == FRUSTUM_PLANE_FLAG_FULL_FRUSTUM;
+
+    // Boxes are processed in groups of four. Every group performs exactly the same computations
+    // as GetBoxVisibility(), but without branches, so the results are identical.
+    struct PlaneSIMD
+    {
+        __m128 Nx, Ny, Nz, D;
+        bool   PosX, PosY, PosZ;
+    };
+    PlaneSIMD Planes[ViewFrustum::NUM_PLANES];
+    Uint32    NumPlanes = 0;
+    for (Uint32 plane_idx = 0; plane_idx < ViewFrustum::NUM_PLANES; ++plane_idx)
+    {
+        if ((PlaneFlags & (1 << plane_idx)) == 0)
+            continue;
+
+        const Plane3D& Plane = Frustum.GetPlane(static_cast<ViewFrustum::PLANE_IDX>(plane_idx));
+
+        auto& DstPlane = Planes[NumPlanes++];
+        DstPlane.Nx    = _mm_set1_ps(Plane.Normal.x);
+        DstPlane.Ny    = _mm_set1_ps(Plane.Normal.y);
+        DstPlane.Nz    = _mm_set1_ps(Plane.Normal.z);
+        DstPlane.D     = _mm_set1_ps(Plane.Distance);
+        DstPlane.PosX  = Plane.Normal.x > 0;
+        DstPlane.PosY  = Plane.Normal.y > 0;
+        DstPlane.PosZ  = Plane.Normal.z > 0;
+    }
+
+    // The whole frustum is outside of the bounding box min X plane if all corners
+    // have x <= Box.Min.x, which is equivalent to max(corner.x) <= Box.Min.x.
+    float3 CornerMin, CornerMax;
+    if (TestFrustumCorners)
+    {
+        CornerMin = CornerMax = pFrustumExt->FrustumCorners[0];
+        for (int i = 1; i < 8; ++i)
+        {
+            CornerMin = std::min(CornerMin, pFrustumExt->FrustumCorners[i]);
+            CornerMax = std::max(CornerMax, pFrustumExt->FrustumCorners[i]);
+        }
+    }
+    const __m128 CornerMinX = _mm_set1_ps(CornerMin.x);
+    const __m128 CornerMinY = _mm_set1_ps(CornerMin.y);
+    const __m128 CornerMinZ = _mm_set1_ps(CornerMin.z);
+    const __m128 CornerMaxX = _mm_set1_ps(CornerMax.x);
+    const __m128 CornerMaxY = _mm_set1_ps(CornerMax.y);
+    const __m128 CornerMaxZ = _mm_set1_ps(CornerMax.z);
+#endif
+
+    const Uint32 EndBox = FirstBox + NumBoxes;
+    for (Uint32 WordStart = FirstBox; WordStart < EndBox; WordStart += 32)
+    {
+        const Uint32 WordEnd = std::min(WordStart + 32, EndBox);
+
+        Uint32 VisibleBits      = 0;
+        Uint32 FullyVisibleBits = 0;
+
+        Uint32 box = WordStart;
+#if DILIGENT_SIMD_MATH_LEVEL > 0
+        for (; box + 4 <= WordEnd; box += 4)
+        {
+            const __m128 MinX = _mm_loadu_ps(Boxes.MinX + box);
+            const __m128 MinY = _mm_loadu_ps(Boxes.MinY + box);
+            const __m128 MinZ = _mm_loadu_ps(Boxes.MinZ + box);
+            const __m128 MaxX = _mm_loadu_ps(Boxes.MaxX + box);
+            const __m128 MaxY = _mm_loadu_ps(Boxes.MaxY + box);
+            const __m128 MaxZ = _mm_loadu_ps(Boxes.MaxZ + box);
+
+            const __m128 Zero      = _mm_setzero_ps();
+            __m128       Invisible = _mm_setzero_ps();
+            __m128       AllInside = _mm_cmpeq_ps(Zero, Zero);
+            for (Uint32 p = 0; p < NumPlanes; ++p)
+            {
+                const auto& Plane = Planes[p];
+
+                // See GetBoxVisibilityAgainstPlane()
+                __m128 DMax = _mm_mul_ps(Plane.PosX ? MaxX : MinX, Plane.Nx);
+                DMax        = _mm_add_ps(DMax, _mm_mul_ps(Plane.PosY ? MaxY : MinY, Plane.Ny));
+                DMax        = _mm_add_ps(DMax, _mm_mul_ps(Plane.PosZ ? MaxZ : MinZ, Plane.Nz));
+                DMax        = _mm_add_ps(DMax, Plane.D);
+                Invisible   = _mm_or_ps(Invisible, _mm_cmplt_ps(DMax, Zero));
+
+                __m128 DMin = _mm_mul_ps(Plane.PosX ? MinX : MaxX, Plane.Nx);
+                DMin        = _mm_add_ps(DMin, _mm_mul_ps(Plane.PosY ? MinY : MaxY, Plane.Ny));
+                DMin        = _mm_add_ps(DMin, _mm_mul_ps(Plane.PosZ ? MinZ : MaxZ, Plane.Nz));
+                DMin        = _mm_add_ps(DMin, Plane.D);
+                AllInside   = _mm_and_ps(AllInside, _mm_cmpgt_ps(DMin, Zero));
+            }
+
+            const Uint32 InvisibleBits4    = static_cast<Uint32>(_mm_movemask_ps(Invisible));
+            const Uint32 FullyVisibleBits4 = static_cast<Uint32>(_mm_movemask_ps(AllInside)) & ~InvisibleBits4;
+            Uint32       VisibleBits4      = ~InvisibleBits4 & 0x0Fu;
+            if (TestFrustumCorners)
+            {
+                // See GetBoxVisibility(const ViewFrustumExt&, ...)
+                __m128 Outside = _mm_cmple_ps(CornerMaxX, MinX);
+                Outside        = _mm_or_ps(Outside, _mm_cmple_ps(CornerMaxY, MinY));
+                Outside        = _mm_or_ps(Outside, _mm_cmple_ps(CornerMaxZ, MinZ));
+                Outside        = _mm_or_ps(Outside, _mm_cmpge_ps(CornerMinX, MaxX));
+                Outside        = _mm_or_ps(Outside, _mm_cmpge_ps(CornerMinY, MaxY));
+                Outside        = _mm_or_ps(Outside, _mm_cmpge_ps(CornerMinZ, MaxZ));
+                VisibleBits4 &= ~(static_cast<Uint32>(_mm_movemask_ps(Outside)) & ~FullyVisibleBits4);
+            }
+
+            VisibleBits |= VisibleBits4 << (box - WordStart);
+            FullyVisibleBits |= FullyVisibleBits4 << (box - WordStart);
+        }
+#endif
+
+        for (; box < WordEnd; ++box)
+        {
+            BoundBox Box;
+            Box.Min = float3{Boxes.MinX[box], Boxes.MinY[box], Boxes.MinZ[box]};
+            Box.Max = float3{Boxes.MaxX[box], Boxes.MaxY[box], Boxes.MaxZ[box]};
+
+            const auto Visibility = pFrustumExt != nullptr ?
+                GetBoxVisibility(*pFrustumExt, Box, PlaneFlags) :
+                GetBoxVisibility(Frustum, Box, PlaneFlags);
+
+            if (Visibility != BoxVisibility::Invisible)
+                VisibleBits |= 1u << (box - WordStart);
+            if (Visibility == BoxVisibility::FullyVisible)
+                FullyVisibleBits |= 1u << (box - WordStart);
+        }
+
+        pVisibleMask[WordStart / 32] = VisibleBits;
+        if (pFullyVisibleMask != nullptr)
+            pFullyVisibleMask[WordStart / 32] = FullyVisibleBits;
+    }
+}
+
+} // namespace detail
+
+/// Computes the visibility of a batch of bounding boxes.
+
+/// \param [in]  Frustum           - View frustum.
+/// \param [in]  Boxes             - Bounding boxes in structure-of-arrays layout.
+/// \param [out] pVisibleMask      - Visibility bit mask. Bit i of pVisibleMask[i / 32] is set if
+///                                  box i is not BoxVisibility::Invisible. The array must contain
+///                                  at least GetBoxVisibilityMaskSize(Boxes.NumBoxes) elements.
+/// \param [out] pFullyVisibleMask - Optional bit mask of boxes that are BoxVisibility::FullyVisible.
+/// \param [in]  PlaneFlags        - Frustum planes to test the boxes against.
+/// \param [in]  FirstBox          - Index of the first box to process. Must be a multiple of 32.
+/// \param [in]  NumBoxes          - Number of boxes to process. The range is clamped to Boxes.NumBoxes.
+///
+/// \remarks    The results are identical to calling GetBoxVisibility() for every box.
+///             When DILIGENT_SIMD_MATH_LEVEL > 0, four boxes are tested at once.
+///
+///             Only the mask words that correspond to the [FirstBox, FirstBox + NumBoxes) range are
+///             written, so disjoint ranges may be processed by different threads.
+inline void GetBoxVisibilityMask(const ViewFrustum&  Frustum,
+                                 const BoundBoxSoA&  Boxes,
+                                 Uint32*             pVisibleMask,
+                                 Uint32*             pFullyVisibleMask = nullptr,
+                                 FRUSTUM_PLANE_FLAGS PlaneFlags        = FRUSTUM_PLANE_FLAG_FULL_FRUSTUM,
+                                 Uint32              FirstBox          = 0,
+                                 Uint32              NumBoxes          = ~0u)
+{
+    detail::GetBoxVisibilityMaskImpl(Frustum, nullptr, Boxes, pVisibleMask, pFullyVisibleMask, PlaneFlags, FirstBox, NumBoxes);
+}
+
+/// Computes the visibility of a batch of bounding boxes, and additionally tests the frustum
+/// corners against the box planes, see GetBoxVisibility(const ViewFrustumExt&, ...).
+inline void GetBoxVisibilityMask(const ViewFrustumExt& FrustumExt,
+                                 const BoundBoxSoA&    Boxes,
+                                 Uint32*               pVisibleMask,
+                                 Uint32*               pFullyVisibleMask = nullptr,
+                                 FRUSTUM_PLANE_FLAGS   PlaneFlags        = FRUSTUM_PLANE_FLAG_FULL_FRUSTUM,
+                                 Uint32                FirstBox          = 0,
+                                 Uint32                NumBoxes          = ~0u)
+{
+    detail::GetBoxVisibilityMaskImpl(FrustumExt, &FrustumExt, Boxes, pVisibleMask, pFullyVisibleMask, PlaneFlags, FirstBox, NumBoxes);
+}
+
+/// Computes the visibility of a batch of bounding boxes using the caller-provided parallel-for.
+
+/// \param [in] ParallelFor  - Function object that is called as ParallelFor(NumTasks, Task), where
+///                            Task is a function object that must be invoked as Task(TaskIndex)
+///                            for every TaskIndex in [0, NumTasks). The tasks may run concurrently.
+/// \param [in] BoxesPerTask - Number of boxes processed by one task. The value is rounded up to a multiple of 32.
+///
+/// See GetBoxVisibilityMask() for the description of other parameters.
+template <typename FrustumType, typename ParallelForType>
+void GetBoxVisibilityMaskParallel(const FrustumType&  Frustum,
+                                  const BoundBoxSoA&  Boxes,
+                                  Uint32*             pVisibleMask,
+                                  Uint32*             pFullyVisibleMask,
+                                  FRUSTUM_PLANE_FLAGS PlaneFlags,
+                                  ParallelForType&&   ParallelFor,
+                                  Uint32              BoxesPerTask = 8192)
+{
+    BoxesPerTask = std::max((BoxesPerTask + 31u) & ~31u, 32u);
+
+    const Uint32 NumTasks = (Boxes.NumBoxes + BoxesPerTask - 1) / BoxesPerTask;
+    ParallelFor(NumTasks, [&](Uint32 TaskIndex) {
+        GetBoxVisibilityMask(Frustum, Boxes, pVisibleMask, pFullyVisibleMask, PlaneFlags, TaskIndex * BoxesPerTask, BoxesPerTask);
+    });
+}
+
+/// Writes indices of the bits that are set in the mask to pIndices and returns the number of indices written.
+/// pIndices must be large enough to hold NumBits elements.
+inline Uint32 CompactVisibilityMask(const Uint32* pMask, Uint32 NumBits, Uint32* pIndices)
+{
+    Uint32 Count = 0;
+    for (Uint32 Word = 0; Word < GetBoxVisibilityMaskSize(NumBits); ++Word)
+    {
+        Uint32 Bits = pMask[Word];
+        while (Bits != 0)
+        {
+            const Uint32 Bit = PlatformMisc::GetLSB(Bits);
+            VERIFY_EXPR(Word * 32 + Bit < NumBits);
+            pIndices[Count++] = Word * 32 + Bit;
+            Bits &= Bits - 1;
+        }
+    }
+    return Count;
+}
+
+/// Tests a batch of bounding boxes against the view frustum and writes indices of boxes that
+/// are not invisible to pVisibleIndices. Returns the number of visible boxes.
+/// pVisibleIndices must be large enough to hold Boxes.NumBoxes elements.
+template <typename FrustumType>
+Uint32 CullBoxes(const FrustumType&  Frustum,
+                 const BoundBoxSoA&  Boxes,
+                 Uint32*             pVisibleIndices,
+                 FRUSTUM_PLANE_FLAGS PlaneFlags = FRUSTUM_PLANE_FLAG_FULL_FRUSTUM)
+{
+    Uint32 NumVisible = 0;
+    for (Uint32 FirstBox = 0; FirstBox < Boxes.NumBoxes; FirstBox += 32)
+    {
+        // Process 32 boxes at a time to avoid allocating the whole mask
+        BoundBoxSoA Boxes32;
+        Boxes32.MinX     = Boxes.MinX + FirstBox;
+        Boxes32.MinY     = Boxes.MinY + FirstBox;
+        Boxes32.MinZ     = Boxes.MinZ + FirstBox;
+        Boxes32.MaxX     = Boxes.MaxX + FirstBox;
+        Boxes32.MaxY     = Boxes.MaxY + FirstBox;
+        Boxes32.MaxZ     = Boxes.MaxZ + FirstBox;
+        Boxes32.NumBoxes = std::min(Boxes.NumBoxes - FirstBox, 32u);
+
+        Uint32 VisibleBits = 0;
+        GetBoxVisibilityMask(Frustum, Boxes32, &VisibleBits, nullptr, PlaneFlags);
+        for (; VisibleBits != 0; VisibleBits &= VisibleBits - 1)
+            pVisibleIndices[NumVisible++] = FirstBox + PlatformMisc::GetLSB(VisibleBits);
+    }
+    return NumVisible;
+}
+
 inline float GetPointToBoxDistance(const BoundBox& BndBox, const float3& Pos)
 {
     VERIFY_EXPR(BndBox.Max.x >= BndBox.Min.x &&
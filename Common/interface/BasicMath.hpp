@@ -53,6 +53,7 @@
 #include <iostream>
 
 #include "HashUtils.hpp"
+#include "BasicMathSIMD.hpp"
 
 #ifdef _MSC_VER
 #    pragma warning(push)
@@ -1498,6 +1499,12 @@ template <class T> struct Matrix4x4
     }
 
     static Matrix4x4 Mul(const Matrix4x4& m1, const Matrix4x4& m2)
+    {
+        return MulScalar(m1, m2);
+    }
+
+    /// Scalar implementation of Mul() that is used even when the SIMD path is enabled.
+    static Matrix4x4 MulScalar(const Matrix4x4& m1, const Matrix4x4& m2)
     {
         Matrix4x4 mOut;
         for (int i = 0; i < 4; i++)
@@ -1546,6 +1553,12 @@ template <class T> struct Matrix4x4
     }
 
     Matrix4x4 Inverse() const
+    {
+        return InverseScalar();
+    }
+
+    /// Scalar implementation of Inverse() that is used even when the SIMD path is enabled.
+    Matrix4x4 InverseScalar() const
     {
         Matrix4x4 inv;
 
@@ -1671,6 +1684,34 @@ template <class T> struct Matrix4x4
     }
 };
 
+#if DILIGENT_SIMD_MATH_LEVEL > 0
+
+template <>
+inline Matrix4x4<float> Matrix4x4<float>::Mul(const Matrix4x4<float>& m1, const Matrix4x4<float>& m2)
+{
+    Matrix4x4<float> mOut;
+    SIMD::MultiplyMatrices4x4(m1.Data(), m2.Data(), mOut.Data());
+    return mOut;
+}
+
+template <>
+inline Matrix4x4<float> Matrix4x4<float>::Inverse() const
+{
+    Matrix4x4<float> inv;
+    SIMD::InverseMatrix4x4(Data(), inv.Data());
+    return inv;
+}
+
+template <>
+inline Vector4<float> Vector4<float>::operator*(const Matrix4x4<float>& m) const
+{
+    Vector4<float> out;
+    SIMD::TransformVectors4(Data(), m.Data(), out.Data(), 1);
+    return out;
+}
+
+#endif
+
 // Template Vector Operations
 
 
@@ -1904,6 +1945,59 @@ using double3x3 = Matrix3x3<double>;
 using double2x2 = Matrix2x2<double>;
 
 
+// Bulk operations
+
+/// Transforms an array of row vectors: pDst[i] = pSrc[i] * m.
+/// pDst may be the same as pSrc.
+inline void TransformVectors(const float4* pSrc, float4* pDst, size_t Count, const float4x4& m)
+{
+#if DILIGENT_SIMD_MATH_LEVEL > 0
+    SIMD::TransformVectors4(reinterpret_cast<const float*>(pSrc), m.Data(), reinterpret_cast<float*>(pDst), Count);
+#else
+    for (size_t i = 0; i < Count; ++i)
+        pDst[i] = pSrc[i] * m;
+#endif
+}
+
+/// Transforms an array of points: pDst[i] = pSrc[i] * m, including the perspective division
+/// (see Vector3::operator*(const Matrix4x4&)).
+/// pDst may be the same as pSrc.
+inline void TransformPoints(const float3* pSrc, float3* pDst, size_t Count, const float4x4& m)
+{
+#if DILIGENT_SIMD_MATH_LEVEL > 0
+    SIMD::TransformPoints3(reinterpret_cast<const float*>(pSrc), m.Data(), reinterpret_cast<float*>(pDst), Count);
+#else
+    for (size_t i = 0; i < Count; ++i)
+        pDst[i] = pSrc[i] * m;
+#endif
+}
+
+/// Multiplies two arrays of matrices element-wise: pDst[i] = pSrc1[i] * pSrc2[i].
+/// pDst may be the same as either of the source arrays.
+inline void MultiplyMatrices(const float4x4* pSrc1, const float4x4* pSrc2, float4x4* pDst, size_t Count)
+{
+#if DILIGENT_SIMD_MATH_LEVEL > 0
+    SIMD::MultiplyMatrixArrays4x4(reinterpret_cast<const float*>(pSrc1), reinterpret_cast<const float*>(pSrc2), 1, reinterpret_cast<float*>(pDst), Count);
+#else
+    for (size_t i = 0; i < Count; ++i)
+        pDst[i] = pSrc1[i] * pSrc2[i];
+#endif
+}
+
+/// Multiplies every matrix in the array by the same matrix: pDst[i] = pSrc[i] * m.
+/// This is typically used to compute WorldViewProj matrices for a set of objects.
+/// pDst may be the same as pSrc.
+inline void MultiplyMatrices(const float4x4* pSrc, const float4x4& m, float4x4* pDst, size_t Count)
+{
+#if DILIGENT_SIMD_MATH_LEVEL > 0
+    SIMD::MultiplyMatrixArrays4x4(reinterpret_cast<const float*>(pSrc), m.Data(), 0, reinterpret_cast<float*>(pDst), Count);
+#else
+    for (size_t i = 0; i < Count; ++i)
+        pDst[i] = pSrc[i] * m;
+#endif
+}
+
+
 struct Quaternion
 {
     float4 q;
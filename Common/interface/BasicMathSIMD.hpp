@@ -0,0 +1,278 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// SSE/AVX implementation of performance-critical BasicMath routines.
+///
+/// The instruction set is given by DILIGENT_SIMD_MATH_LEVEL macro:
+/// - 0 - the SIMD path is disabled, and BasicMath uses the scalar implementation;
+/// - 1 - SSE2, used whenever the target supports it (all x64 targets and x86 targets compiled with SSE2);
+/// - 2 - AVX, used when the code is compiled with AVX enabled (see DILIGENT_SIMD_MATH CMake option).
+///
+/// If the macro is not defined, the level is detected from the compiler target. Define it to 0
+/// to force the scalar implementation.
+///
+/// All routines perform exactly the same sequence of floating-point operations as the scalar code
+/// and thus produce bit-identical results (as long as the compiler does not contract the scalar
+/// code into FMA instructions).
+///
+/// The routines operate on raw row-major float data so that this header does not depend on BasicMath.hpp.
+
+#ifndef DILIGENT_SIMD_MATH_LEVEL
+#    if defined(__AVX__)
+#        define DILIGENT_SIMD_MATH_LEVEL 2
+#    elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#        define DILIGENT_SIMD_MATH_LEVEL 1
+#    else
+#        define DILIGENT_SIMD_MATH_LEVEL 0
+#    endif
+#elif DILIGENT_SIMD_MATH_LEVEL >= 2 && !defined(__AVX__)
+#    error DILIGENT_SIMD_MATH_LEVEL 2 requires AVX to be enabled in the compiler
+#endif
+
+#if DILIGENT_SIMD_MATH_LEVEL > 0
+
+#    include <cstddef>
+
+#    include <emmintrin.h>
+#    if DILIGENT_SIMD_MATH_LEVEL >= 2
+#        include <immintrin.h>
+#    endif
+
+namespace Diligent
+{
+
+namespace SIMD
+{
+
+/// Computes v * M, where v is a row vector and M = {M0, M1, M2, M3} is a row-major matrix:
+///
+///     r = ((v.x * M0 + v.y * M1) + v.z * M2) + v.w * M3
+inline __m128 TransformVector(__m128 v, __m128 M0, __m128 M1, __m128 M2, __m128 M3)
+{
+    __m128 r = _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)), M0);
+    r        = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)), M1));
+    r        = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)), M2));
+    r        = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)), M3));
+    return r;
+}
+
+/// Computes one row of the matrix product. Unlike TransformVector, the sum starts with zero
+/// to match the scalar Matrix4x4::Mul(), which accumulates into a zero-initialized matrix.
+inline __m128 MultiplyMatrixRow(__m128 Row, __m128 M0, __m128 M1, __m128 M2, __m128 M3)
+{
+    __m128 r = _mm_add_ps(_mm_setzero_ps(), _mm_mul_ps(_mm_shuffle_ps(Row, Row, _MM_SHUFFLE(0, 0, 0, 0)), M0));
+    r        = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(Row, Row, _MM_SHUFFLE(1, 1, 1, 1)), M1));
+    r        = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(Row, Row, _MM_SHUFFLE(2, 2, 2, 2)), M2));
+    r        = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(Row, Row, _MM_SHUFFLE(3, 3, 3, 3)), M3));
+    return r;
+}
+
+#    if DILIGENT_SIMD_MATH_LEVEL >= 2
+inline __m256 BroadcastRow(__m128 Row)
+{
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(Row), Row, 1);
+}
+
+/// AVX counterpart of TransformVector that processes two vectors at once.
+inline __m256 TransformVector2(__m256 v, __m256 M0, __m256 M1, __m256 M2, __m256 M3)
+{
+    __m256 r = _mm256_mul_ps(_mm256_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)), M0);
+    r        = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)), M1));
+    r        = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)), M2));
+    r        = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)), M3));
+    return r;
+}
+
+/// AVX counterpart of MultiplyMatrixRow that processes two rows at once.
+inline __m256 MultiplyMatrixRow2(__m256 Rows, __m256 M0, __m256 M1, __m256 M2, __m256 M3)
+{
+    __m256 r = _mm256_add_ps(_mm256_setzero_ps(), _mm256_mul_ps(_mm256_shuffle_ps(Rows, Rows, _MM_SHUFFLE(0, 0, 0, 0)), M0));
+    r        = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(Rows, Rows, _MM_SHUFFLE(1, 1, 1, 1)), M1));
+    r        = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(Rows, Rows, _MM_SHUFFLE(2, 2, 2, 2)), M2));
+    r        = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(Rows, Rows, _MM_SHUFFLE(3, 3, 3, 3)), M3));
+    return r;
+}
+#    endif
+
+/// Computes pDst = pSrc1 * pSrc2 for 4x4 row-major matrices. pDst may alias either source.
+inline void MultiplyMatrices4x4(const float* pSrc1, const float* pSrc2, float* pDst)
+{
+#    if DILIGENT_SIMD_MATH_LEVEL >= 2
+    const __m256 M0 = BroadcastRow(_mm_loadu_ps(pSrc2 + 0));
+    const __m256 M1 = BroadcastRow(_mm_loadu_ps(pSrc2 + 4));
+    const __m256 M2 = BroadcastRow(_mm_loadu_ps(pSrc2 + 8));
+    const __m256 M3 = BroadcastRow(_mm_loadu_ps(pSrc2 + 12));
+
+    const __m256 Rows01 = _mm256_loadu_ps(pSrc1 + 0);
+    const __m256 Rows23 = _mm256_loadu_ps(pSrc1 + 8);
+    _mm256_storeu_ps(pDst + 0, MultiplyMatrixRow2(Rows01, M0, M1, M2, M3));
+    _mm256_storeu_ps(pDst + 8, MultiplyMatrixRow2(Rows23, M0, M1, M2, M3));
+#    else
+    const __m128 M0 = _mm_loadu_ps(pSrc2 + 0);
+    const __m128 M1 = _mm_loadu_ps(pSrc2 + 4);
+    const __m128 M2 = _mm_loadu_ps(pSrc2 + 8);
+    const __m128 M3 = _mm_loadu_ps(pSrc2 + 12);
+
+    const __m128 Row0 = _mm_loadu_ps(pSrc1 + 0);
+    const __m128 Row1 = _mm_loadu_ps(pSrc1 + 4);
+    const __m128 Row2 = _mm_loadu_ps(pSrc1 + 8);
+    const __m128 Row3 = _mm_loadu_ps(pSrc1 + 12);
+    _mm_storeu_ps(pDst + 0, MultiplyMatrixRow(Row0, M0, M1, M2, M3));
+    _mm_storeu_ps(pDst + 4, MultiplyMatrixRow(Row1, M0, M1, M2, M3));
+    _mm_storeu_ps(pDst + 8, MultiplyMatrixRow(Row2, M0, M1, M2, M3));
+    _mm_storeu_ps(pDst + 12, MultiplyMatrixRow(Row3, M0, M1, M2, M3));
+#    endif
+}
+
+/// Computes the inverse of a 4x4 row-major matrix. pDst may alias pSrc.
+inline void InverseMatrix4x4(const float* pSrc, float* pDst)
+{
+    // The scalar implementation computes every cofactor as the determinant of a 3x3 minor:
+    //
+    //      det = 0;
+    //      det += a * (e * i - h * f);
+    //      det -= b * (d * i - g * f);
+    //      det += c * (d * h - g * e);
+    //
+    // We compute four cofactors of one row at once. Lane j of MinorCol0/1/2[k] contains
+    // the first/second/third element of the source row k with column j removed:
+    //
+    //      lane:          0  1  2  3
+    //      MinorCol0:     1  0  0  0
+    //      MinorCol1:     2  2  1  1
+    //      MinorCol2:     3  3  3  2
+    __m128 Rows[4];
+    __m128 MinorCol0[4];
+    __m128 MinorCol1[4];
+    __m128 MinorCol2[4];
+    for (int k = 0; k < 4; ++k)
+    {
+        Rows[k]      = _mm_loadu_ps(pSrc + k * 4);
+        MinorCol0[k] = _mm_shuffle_ps(Rows[k], Rows[k], _MM_SHUFFLE(0, 0, 0, 1));
+        MinorCol1[k] = _mm_shuffle_ps(Rows[k], Rows[k], _MM_SHUFFLE(1, 1, 2, 2));
+        MinorCol2[k] = _mm_shuffle_ps(Rows[k], Rows[k], _MM_SHUFFLE(2, 3, 3, 3));
+    }
+
+    // Cofactor signs are (+ - + -) for even rows and (- + - +) for odd rows
+    const __m128 SignMaskEven = _mm_castsi128_ps(_mm_set_epi32(static_cast<int>(0x80000000), 0, static_cast<int>(0x80000000), 0));
+    const __m128 SignMaskOdd  = _mm_castsi128_ps(_mm_set_epi32(0, static_cast<int>(0x80000000), 0, static_cast<int>(0x80000000)));
+
+    __m128 Cofactors[4];
+    for (int r = 0; r < 4; ++r)
+    {
+        // Minor rows are the source rows except r, in ascending order
+        const int r0 = r > 0 ? 0 : 1;
+        const int r1 = r > 1 ? 1 : 2;
+        const int r2 = r > 2 ? 2 : 3;
+
+        const __m128 a = MinorCol0[r0], b = MinorCol1[r0], c = MinorCol2[r0];
+        const __m128 d = MinorCol0[r1], e = MinorCol1[r1], f = MinorCol2[r1];
+        const __m128 g = MinorCol0[r2], h = MinorCol1[r2], i = MinorCol2[r2];
+
+        __m128 det = _mm_setzero_ps();
+        det        = _mm_add_ps(det, _mm_mul_ps(a, _mm_sub_ps(_mm_mul_ps(e, i), _mm_mul_ps(h, f))));
+        det        = _mm_sub_ps(det, _mm_mul_ps(b, _mm_sub_ps(_mm_mul_ps(d, i), _mm_mul_ps(g, f))));
+        det        = _mm_add_ps(det, _mm_mul_ps(c, _mm_sub_ps(_mm_mul_ps(d, h), _mm_mul_ps(g, e))));
+
+        Cofactors[r] = _mm_xor_ps(det, (r & 0x01) ? SignMaskOdd : SignMaskEven);
+    }
+
+    // det = _11 * inv._11 + _12 * inv._12 + _13 * inv._13 + _14 * inv._14
+    alignas(16) float Prod[4];
+    _mm_store_ps(Prod, _mm_mul_ps(Rows[0], Cofactors[0]));
+    const float det = Prod[0] + Prod[1] + Prod[2] + Prod[3];
+
+    _MM_TRANSPOSE4_PS(Cofactors[0], Cofactors[1], Cofactors[2], Cofactors[3]);
+
+    const __m128 InvDet = _mm_set1_ps(1.f / det);
+    for (int k = 0; k < 4; ++k)
+        _mm_storeu_ps(pDst + k * 4, _mm_mul_ps(Cofactors[k], InvDet));
+}
+
+/// Computes pDst[i] = pSrc[i] * M for an array of row 4-component vectors. pDst may alias pSrc.
+inline void TransformVectors4(const float* pSrc, const float* pMatrix, float* pDst, size_t Count)
+{
+    size_t i = 0;
+#    if DILIGENT_SIMD_MATH_LEVEL >= 2
+    {
+        const __m256 M0 = BroadcastRow(_mm_loadu_ps(pMatrix + 0));
+        const __m256 M1 = BroadcastRow(_mm_loadu_ps(pMatrix + 4));
+        const __m256 M2 = BroadcastRow(_mm_loadu_ps(pMatrix + 8));
+        const __m256 M3 = BroadcastRow(_mm_loadu_ps(pMatrix + 12));
+        for (; i + 2 <= Count; i += 2)
+            _mm256_storeu_ps(pDst + i * 4, TransformVector2(_mm256_loadu_ps(pSrc + i * 4), M0, M1, M2, M3));
+    }
+#    endif
+
+    const __m128 M0 = _mm_loadu_ps(pMatrix + 0);
+    const __m128 M1 = _mm_loadu_ps(pMatrix + 4);
+    const __m128 M2 = _mm_loadu_ps(pMatrix + 8);
+    const __m128 M3 = _mm_loadu_ps(pMatrix + 12);
+    for (; i < Count; ++i)
+        _mm_storeu_ps(pDst + i * 4, TransformVector(_mm_loadu_ps(pSrc + i * 4), M0, M1, M2, M3));
+}
+
+/// Computes pDst[i] = (pSrc[i], 1) * M followed by the perspective division
+/// for an array of 3-component points. pDst may alias pSrc.
+inline void TransformPoints3(const float* pSrc, const float* pMatrix, float* pDst, size_t Count)
+{
+    const __m128 M0 = _mm_loadu_ps(pMatrix + 0);
+    const __m128 M1 = _mm_loadu_ps(pMatrix + 4);
+    const __m128 M2 = _mm_loadu_ps(pMatrix + 8);
+    const __m128 M3 = _mm_loadu_ps(pMatrix + 12);
+    for (size_t i = 0; i < Count; ++i)
+    {
+        const float* pSrcPoint = pSrc + i * 3;
+
+        __m128 r = TransformVector(_mm_set_ps(1.f, pSrcPoint[2], pSrcPoint[1], pSrcPoint[0]), M0, M1, M2, M3);
+        r        = _mm_div_ps(r, _mm_shuffle_ps(r, r, _MM_SHUFFLE(3, 3, 3, 3)));
+
+        alignas(16) float Res[4];
+        _mm_store_ps(Res, r);
+        float* pDstPoint = pDst + i * 3;
+        pDstPoint[0]     = Res[0];
+        pDstPoint[1]     = Res[1];
+        pDstPoint[2]     = Res[2];
+    }
+}
+
+/// Computes pDst[i] = pSrc1[i] * pSrc2[i * Src2Stride] for arrays of 4x4 row-major matrices.
+/// Src2Stride is either 1 (element-wise product) or 0 (all matrices are multiplied by the same matrix).
+inline void MultiplyMatrixArrays4x4(const float* pSrc1, const float* pSrc2, size_t Src2Stride, float* pDst, size_t Count)
+{
+    for (size_t i = 0; i < Count; ++i)
+        MultiplyMatrices4x4(pSrc1 + i * 16, pSrc2 + i * Src2Stride * 16, pDst + i * 16);
+}
+
+} // namespace SIMD
+
+} // namespace Diligent
+
+#endif
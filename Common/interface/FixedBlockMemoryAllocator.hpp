@@ -36,6 +36,7 @@
 #include <vector>
 #include <cstring>
 #include <memory>
+#include <atomic>
 #include "../../Primitives/interface/Errors.hpp"
 #include "../../Primitives/interface/MemoryAllocator.h"
 #include "STDAllocator.hpp"
@@ -52,11 +53,40 @@ inline void FillWithDebugPattern(void* ptr, Uint8 Pattern, size_t NumBytes)
 #    define FillWithDebugPattern(...)
 #endif
 
+/// Fixed block memory allocator mode
+enum class FixedBlockAllocatorMode : Uint8
+{
+    /// Every allocation and deallocation is serialized by the allocator mutex.
+    /// Memory pages are never released until the allocator is destroyed.
+    Locked,
+
+    /// Every thread keeps a magazine of free blocks, so that most allocations and
+    /// deallocations do not require any synchronization. The mutex is only taken
+    /// when a magazine is refilled from or flushed to the shared pages.
+    /// Pages are aligned by their size, so that the owning page is found directly
+    /// from the block address. The page size is rounded up to a power of two, and
+    /// the page holds as many blocks as fit into it.
+    ///
+    /// \note Since the raw allocator does not support aligned allocations, pages are
+    ///       carved from larger chunks that are over-allocated by one page to be able to
+    ///       align them. A chunk is returned to the raw allocator when all of its pages
+    ///       become fully free.
+    ThreadCaching
+};
+
+struct FixedBlockAllocatorMagazine;
+
+template <typename OwnerType, typename ObjectType>
+class ThreadSlotRegistry;
+
 /// Memory allocator that allocates memory in a fixed-size chunks
 class FixedBlockMemoryAllocator final : public IMemoryAllocator
 {
 public:
-    FixedBlockMemoryAllocator(IMemoryAllocator& RawMemoryAllocator, size_t BlockSize, Uint32 NumBlocksInPage);
+    FixedBlockMemoryAllocator(IMemoryAllocator&       RawMemoryAllocator,
+                              size_t                  BlockSize,
+                              Uint32                  NumBlocksInPage,
+                              FixedBlockAllocatorMode Mode = FixedBlockAllocatorMode::Locked);
     ~FixedBlockMemoryAllocator();
 
     /// Allocates block of memory
@@ -65,6 +95,18 @@ public:
     /// Releases memory
     virtual void Free(void* Ptr) override final;
 
+    /// Prepares NumBlocks blocks for allocation by the calling thread.
+
+    /// In thread-caching mode, the blocks are moved to the magazine of the calling thread
+    /// under a single lock, so that the next NumBlocks allocations made by this thread
+    /// do not require any synchronization. Blocks that have never been given out are
+    /// taken in address order, so that objects allocated in bulk are located next to
+    /// each other in memory.
+    /// In locked mode, the method has no effect.
+    void Prefetch(Uint32 NumBlocks);
+
+    FixedBlockAllocatorMode GetMode() const { return m_Mode; }
+
 private:
     // clang-format off
     FixedBlockMemoryAllocator             (const FixedBlockMemoryAllocator&) = delete;
@@ -75,6 +117,26 @@ private:
 
     void CreateNewPage();
 
+    // Thread-caching mode
+    friend class ThreadSlotRegistry<FixedBlockMemoryAllocator, FixedBlockAllocatorMagazine>;
+
+    struct AlignedPageHeader;
+
+    void*              AllocateCached();
+    void               FreeCached(void* Ptr);
+    AlignedPageHeader* CreateAlignedPage();
+    void               CreateAlignedPageChunk();
+    void               ReleaseAlignedPage(AlignedPageHeader* pPage);
+    AlignedPageHeader* GetAlignedPage(const void* Ptr) const;
+
+    FixedBlockAllocatorMagazine* GetThreadMagazine(); // Returns null if the thread table has been destroyed
+    FixedBlockAllocatorMagazine& RegisterThreadMagazine();
+    void                         RefillMagazine(FixedBlockAllocatorMagazine& Magazine, Uint32 NumBlocksToFetch);
+    void                         FlushMagazine(FixedBlockAllocatorMagazine& Magazine, Uint32 NumBlocksToKeep);
+
+    // Returns the blocks cached by an exiting thread. Called while the thread cache registry mutex is locked.
+    void OnThreadExit(FixedBlockAllocatorMagazine& Magazine);
+
     // Memory page class is based on the fixed-size memory pool described in "Fast Efficient Fixed-Size Memory Pool"
     // by Ben Kenwright
     class MemoryPage
@@ -231,6 +293,24 @@ private:
     IMemoryAllocator& m_RawMemoryAllocator;
     const size_t      m_BlockSize;
     const Uint32      m_NumBlocksInPage;
+
+    const FixedBlockAllocatorMode m_Mode;
+
+    // Thread-caching mode data. Aligned pages and their counters are protected by m_Mutex.
+    // m_Magazines is protected by the thread cache registry mutex.
+    size_t             m_AlignedPageSize        = 0; // Power of two, also the page alignment
+    size_t             m_FirstBlockOffset       = 0; // Offset of the first block from the page start
+    Uint32             m_NumBlocksInAlignedPage = 0; // Number of blocks that fit into the aligned page
+    Uint32             m_NumPagesInChunk        = 0; // Number of pages carved from one raw allocation
+    Uint32             m_MagazineSize           = 0; // Max number of blocks a thread keeps in its magazine
+    Uint32             m_ThreadCacheSlot        = 0; // Index of the magazine in every thread's cache
+    AlignedPageHeader* m_pAvailablePages        = nullptr;
+    AlignedPageHeader* m_pAllPages              = nullptr;
+    AlignedPageHeader* m_pUnusedPages           = nullptr; // Pages of live chunks that are not in use
+    AlignedPageHeader* m_pChunks                = nullptr; // First pages of all chunks
+    Uint32             m_NumAvailablePages      = 0;
+
+    std::vector<FixedBlockAllocatorMagazine*> m_Magazines;
 };
 
 IMemoryAllocator& GetRawAllocator();
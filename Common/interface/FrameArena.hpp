@@ -0,0 +1,357 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+#pragma once
+
+/// \file
+/// Defines Diligent::FrameArena class and Diligent::FrameArenaAllocator STL allocator adapter
+
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "../../Primitives/interface/BasicTypes.h"
+#include "../../Primitives/interface/MemoryAllocator.h"
+#include "../../Platforms/Basic/interface/DebugUtilities.hpp"
+#include "CompilerDefinitions.h"
+#include "Align.hpp"
+
+namespace Diligent
+{
+
+/// Linear allocator for transient data that lives no longer than one frame.
+
+/// Similar to DynamicLinearAllocator, the arena allocates memory from pages, but it always
+/// bumps the pointer in the current page. This makes it possible to take a marker and later
+/// rewind the arena to it, releasing all allocations made after the marker at once.
+/// When the arena is reset, pages are merged into a single page large enough to hold all data
+/// allocated in the previous frame, so that in a steady state the arena never allocates memory.
+///
+/// The arena is not thread-safe. It must be owned by an object that is used by one thread
+/// at a time, such as a device context, and only the owner may reset it, typically when it
+/// finishes the frame:
+///
+///     FrameArena::ScopedMarker     Marker{m_FrameArena};
+///     FrameVector<VkCommandBuffer> vkCmdBuffs{m_FrameArena};
+class FrameArena
+{
+public:
+    // clang-format off
+    FrameArena           (const FrameArena&) = delete;
+    FrameArena           (FrameArena&&)      = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+    FrameArena& operator=(FrameArena&&)      = delete;
+    // clang-format on
+
+    explicit FrameArena(IMemoryAllocator& Allocator, size_t PageSize = 64 << 10) :
+        m_PageSize{PageSize},
+        m_pAllocator{&Allocator}
+    {
+        VERIFY(IsPowerOfTwo(PageSize), "Page size (", PageSize, ") is not power of two");
+    }
+
+    ~FrameArena()
+    {
+        Free();
+    }
+
+    /// Releases all memory pages.
+    void Free()
+    {
+        for (auto& Page : m_Pages)
+            m_pAllocator->Free(Page.Data);
+        m_Pages.clear();
+        m_CurrPage = 0;
+    }
+
+    NODISCARD void* Allocate(size_t Size, size_t Align)
+    {
+        if (Size == 0)
+            return nullptr;
+
+        VERIFY(IsPowerOfTwo(Align), "Alignment (", Align, ") is not power of two");
+
+        // Pages after the current one are empty, so only the current page can be partially used
+        for (; m_CurrPage < m_Pages.size(); ++m_CurrPage)
+        {
+            auto& Page = m_Pages[m_CurrPage];
+
+            auto* Ptr = AlignUp(Page.Data + Page.Offset, Align);
+            if (Ptr + Size <= Page.Data + Page.Size)
+            {
+                Page.Offset = (Ptr + Size) - Page.Data;
+                return Ptr;
+            }
+
+            if (m_CurrPage + 1 < m_Pages.size())
+                m_Pages[m_CurrPage + 1].Offset = 0;
+        }
+
+        // Create a new page
+        size_t PageSize = m_PageSize;
+        while (PageSize < Size + Align - 1)
+            PageSize *= 2;
+        AddPage(PageSize);
+        m_CurrPage = m_Pages.size() - 1;
+
+        auto& Page = m_Pages.back();
+        auto* Ptr  = AlignUp(Page.Data, Align);
+        VERIFY(Ptr + Size <= Page.Data + Page.Size, "Not enough space in the new page - this is a bug");
+        Page.Offset = (Ptr + Size) - Page.Data;
+        return Ptr;
+    }
+
+    template <typename T>
+    NODISCARD T* Allocate(size_t Count = 1)
+    {
+        return reinterpret_cast<T*>(Allocate(sizeof(T) * Count, alignof(T)));
+    }
+
+    template <typename T, typename... Args>
+    NODISCARD T* Construct(Args&&... args)
+    {
+        T* Ptr = Allocate<T>(1);
+        new (Ptr) T{std::forward<Args>(args)...};
+        return Ptr;
+    }
+
+    NODISCARD Char* CopyString(const Char* Str, size_t Len = 0)
+    {
+        if (Str == nullptr)
+            return nullptr;
+
+        if (Len == 0)
+            Len = strlen(Str);
+        else
+            VERIFY_EXPR(Len <= strlen(Str));
+
+        Char* Dst = Allocate<Char>(Len + 1);
+        memcpy(Dst, Str, sizeof(Char) * Len);
+        Dst[Len] = 0;
+        return Dst;
+    }
+
+    NODISCARD Char* CopyString(const String& Str)
+    {
+        return CopyString(Str.c_str(), Str.length());
+    }
+
+    /// Releases the memory if it is the last allocation made from the arena, and does nothing otherwise.
+    void Deallocate(void* Ptr, size_t Size)
+    {
+        if (Ptr == nullptr || m_CurrPage >= m_Pages.size())
+            return;
+
+        auto& Page = m_Pages[m_CurrPage];
+        if (static_cast<uint8_t*>(Ptr) + Size == Page.Data + Page.Offset)
+            Page.Offset = static_cast<uint8_t*>(Ptr) - Page.Data;
+    }
+
+    /// Arena position that allocations can be rewound to.
+    struct Marker
+    {
+        size_t PageIdx = 0;
+        size_t Offset  = 0;
+    };
+
+    Marker GetMarker() const
+    {
+        Marker M;
+        if (m_CurrPage < m_Pages.size())
+        {
+            M.PageIdx = m_CurrPage;
+            M.Offset  = m_Pages[m_CurrPage].Offset;
+        }
+        return M;
+    }
+
+    /// Releases all allocations made after the marker was taken.
+    void Rewind(const Marker& M)
+    {
+        VERIFY(M.PageIdx < m_Pages.size() || (M.PageIdx == 0 && M.Offset == 0), "Invalid marker");
+        VERIFY(M.PageIdx < m_CurrPage || (M.PageIdx == m_CurrPage && (m_CurrPage >= m_Pages.size() || M.Offset <= m_Pages[m_CurrPage].Offset)),
+               "The marker is ahead of the current position: markers must be rewound in the reverse order");
+
+        m_CurrPage = M.PageIdx;
+        if (m_CurrPage < m_Pages.size())
+            m_Pages[m_CurrPage].Offset = M.Offset;
+    }
+
+    /// Rewinds the arena to the position at which the object was created.
+    class ScopedMarker
+    {
+    public:
+        explicit ScopedMarker(FrameArena& Arena) :
+            m_Arena{Arena},
+            m_Marker{Arena.GetMarker()}
+        {}
+
+        // clang-format off
+        ScopedMarker           (const ScopedMarker&) = delete;
+        ScopedMarker           (ScopedMarker&&)      = delete;
+        ScopedMarker& operator=(const ScopedMarker&) = delete;
+        ScopedMarker& operator=(ScopedMarker&&)      = delete;
+        // clang-format on
+
+        ~ScopedMarker()
+        {
+            m_Arena.Rewind(m_Marker);
+        }
+
+    private:
+        FrameArena&  m_Arena;
+        const Marker m_Marker;
+    };
+
+    /// Releases all allocations. If the data did not fit into a single page, the pages are
+    /// replaced with a single page that is large enough to hold all of it.
+    void Reset()
+    {
+        if (m_Pages.size() > 1 && m_CurrPage > 0)
+        {
+            size_t TotalSize = 0;
+            for (const auto& Page : m_Pages)
+                TotalSize += Page.Size;
+            Free();
+
+            size_t PageSize = m_PageSize;
+            while (PageSize < TotalSize)
+                PageSize *= 2;
+            AddPage(PageSize);
+        }
+
+        m_CurrPage = 0;
+        if (!m_Pages.empty())
+            m_Pages[0].Offset = 0;
+    }
+
+    /// Returns the total size of memory used by allocations, including alignment padding.
+    size_t GetUsedSize() const
+    {
+        size_t UsedSize = 0;
+        for (size_t i = 0; i <= m_CurrPage && i < m_Pages.size(); ++i)
+            UsedSize += m_Pages[i].Offset;
+        return UsedSize;
+    }
+
+    /// Returns the total size of all memory pages.
+    size_t GetCapacity() const
+    {
+        size_t Capacity = 0;
+        for (const auto& Page : m_Pages)
+            Capacity += Page.Size;
+        return Capacity;
+    }
+
+    size_t GetNumPages() const
+    {
+        return m_Pages.size();
+    }
+
+private:
+    void AddPage(size_t Size)
+    {
+        m_Pages.emplace_back(m_pAllocator->Allocate(Size, "frame arena page", __FILE__, __LINE__), Size);
+    }
+
+    struct Page
+    {
+        uint8_t* const Data   = nullptr;
+        size_t const   Size   = 0;
+        size_t         Offset = 0;
+
+        Page(void* _Data, size_t _Size) :
+            Data{static_cast<uint8_t*>(_Data)}, Size{_Size} {}
+    };
+
+    std::vector<Page> m_Pages;
+    size_t            m_CurrPage   = 0;
+    const size_t      m_PageSize   = 64 << 10;
+    IMemoryAllocator* m_pAllocator = nullptr;
+};
+
+/// STL-compatible allocator that allocates memory from the frame arena.
+/// Deallocation only releases memory when it is the last allocation made from the arena.
+template <typename T>
+struct FrameArenaAllocator
+{
+    using value_type      = T;
+    using pointer         = value_type*;
+    using const_pointer   = const value_type*;
+    using reference       = value_type&;
+    using const_reference = const value_type&;
+    using size_type       = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    FrameArenaAllocator(FrameArena& Arena) noexcept :
+        m_pArena{&Arena}
+    {}
+
+    template <class U>
+    FrameArenaAllocator(const FrameArenaAllocator<U>& other) noexcept :
+        m_pArena{other.m_pArena}
+    {}
+
+    template <class U> struct rebind
+    {
+        typedef FrameArenaAllocator<U> other;
+    };
+
+    T* allocate(std::size_t count)
+    {
+        return m_pArena->Allocate<T>(count);
+    }
+
+    void deallocate(T* p, std::size_t count)
+    {
+        m_pArena->Deallocate(p, count * sizeof(T));
+    }
+
+    size_type max_size() const
+    {
+        return std::numeric_limits<size_type>::max() / sizeof(T);
+    }
+
+    FrameArena* m_pArena;
+};
+
+template <class T, class U>
+bool operator==(const FrameArenaAllocator<T>& left, const FrameArenaAllocator<U>& right)
+{
+    return left.m_pArena == right.m_pArena;
+}
+
+template <class T, class U>
+bool operator!=(const FrameArenaAllocator<T>& left, const FrameArenaAllocator<U>& right)
+{
+    return !(left == right);
+}
+
+template <typename T>
+using FrameVector = std::vector<T, FrameArenaAllocator<T>>;
+
+} // namespace Diligent
@@ -29,8 +29,10 @@
 
 #include <functional>
 #include <memory>
+#include <cstdint>
 #include <cstring>
 
+#include "../../Primitives/interface/BasicTypes.h"
 #include "../../Primitives/interface/Errors.hpp"
 #include "../../Platforms/Basic/interface/DebugUtilities.hpp"
 
@@ -39,11 +41,31 @@
 namespace Diligent
 {
 
-// http://www.boost.org/doc/libs/1_35_0/doc/html/hash/combine.html
+/// Mixes the bits of the hash value so that every input bit affects every output bit.
+/// This is the mixing function used by boost::hash_combine since Boost 1.81
+/// (https://www.boost.org/doc/libs/1_81_0/libs/container_hash/doc/html/hash.html#notes_hash_combine).
+constexpr std::size_t HashMix(std::size_t x)
+{
+#if SIZE_MAX > UINT32_MAX
+    x ^= x >> 32;
+    x *= 0xe9846af9b1a615dull;
+    x ^= x >> 32;
+    x *= 0xe9846af9b1a615dull;
+    x ^= x >> 28;
+#else
+    x ^= x >> 16;
+    x *= 0x21f0aaadu;
+    x ^= x >> 15;
+    x *= 0x735a2d97u;
+    x ^= x >> 15;
+#endif
+    return x;
+}
+
 template <typename T>
 void HashCombine(std::size_t& Seed, const T& Val)
 {
-    Seed ^= std::hash<T>{}(Val) + 0x9e3779b9 + (Seed << 6) + (Seed >> 2);
+    Seed = HashMix(Seed + 0x9e3779b9 + std::hash<T>{}(Val));
 }
 
 template <typename FirstArgType, typename... RestArgsType>
@@ -61,16 +83,162 @@ std::size_t ComputeHash(const ArgsType&... Args)
     return Seed;
 }
 
+namespace WyHash
+{
+
+// wyhash final version 4.2 by Wang Yi (https://github.com/wangyi-fudan/wyhash), released into the public domain.
+// All functions are constexpr so that hashes of string literals can be computed at compile time.
+// Data is read byte-by-byte, which makes the result independent of the platform endianness;
+// GCC and Clang combine the reads into a single load.
+
+struct UInt128
+{
+    Uint64 Lo;
+    Uint64 Hi;
+};
+
+constexpr UInt128 Multiply(Uint64 A, Uint64 B)
+{
+#if defined(__SIZEOF_INT128__)
+    const unsigned __int128 r = static_cast<unsigned __int128>(A) * B;
+    return UInt128{static_cast<Uint64>(r), static_cast<Uint64>(r >> 64)};
+#else
+    const Uint64 ha = A >> 32, hb = B >> 32, la = A & 0xFFFFFFFFu, lb = B & 0xFFFFFFFFu;
+    const Uint64 rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    const Uint64 t  = rl + (rm0 << 32);
+    Uint64       c  = t < rl ? 1 : 0;
+    const Uint64 lo = t + (rm1 << 32);
+    c += lo < t ? 1 : 0;
+    const Uint64 hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+    return UInt128{lo, hi};
+#endif
+}
+
+constexpr Uint64 Mix(Uint64 A, Uint64 B)
+{
+    const UInt128 r = Multiply(A, B);
+    return r.Lo ^ r.Hi;
+}
+
+constexpr Uint64 Read1(const char* p, size_t Offset)
+{
+    return static_cast<Uint64>(static_cast<Uint8>(p[Offset]));
+}
+
+constexpr Uint64 Read4(const char* p, size_t Offset)
+{
+    return Read1(p, Offset) | (Read1(p, Offset + 1) << 8) | (Read1(p, Offset + 2) << 16) | (Read1(p, Offset + 3) << 24);
+}
+
+constexpr Uint64 Read8(const char* p, size_t Offset)
+{
+    return Read4(p, Offset) | (Read4(p, Offset + 4) << 32);
+}
+
+constexpr Uint64 Secret0 = 0x2d358dccaa6c78a5ull;
+constexpr Uint64 Secret1 = 0x8bb84b93962eacc9ull;
+constexpr Uint64 Secret2 = 0x4b33a62ed433d4a3ull;
+constexpr Uint64 Secret3 = 0x4d5a2da51de1aa47ull;
+
+constexpr Uint64 Hash(const char* p, size_t Len, Uint64 Seed)
+{
+    Seed ^= Mix(Seed ^ Secret0, Secret1);
+
+    Uint64 a = 0;
+    Uint64 b = 0;
+    if (Len <= 16)
+    {
+        if (Len >= 4)
+        {
+            a = (Read4(p, 0) << 32) | Read4(p, (Len >> 3) << 2);
+            b = (Read4(p, Len - 4) << 32) | Read4(p, Len - 4 - ((Len >> 3) << 2));
+        }
+        else if (Len > 0)
+        {
+            a = (Read1(p, 0) << 16) | (Read1(p, Len >> 1) << 8) | Read1(p, Len - 1);
+        }
+    }
+    else
+    {
+        size_t Offset    = 0;
+        size_t Remaining = Len;
+        if (Remaining > 48)
+        {
+            Uint64 Seed1 = Seed;
+            Uint64 Seed2 = Seed;
+            do
+            {
+                Seed  = Mix(Read8(p, Offset) ^ Secret1, Read8(p, Offset + 8) ^ Seed);
+                Seed1 = Mix(Read8(p, Offset + 16) ^ Secret2, Read8(p, Offset + 24) ^ Seed1);
+                Seed2 = Mix(Read8(p, Offset + 32) ^ Secret3, Read8(p, Offset + 40) ^ Seed2);
+                Offset += 48;
+                Remaining -= 48;
+            } while (Remaining > 48);
+            Seed ^= Seed1 ^ Seed2;
+        }
+        while (Remaining > 16)
+        {
+            Seed = Mix(Read8(p, Offset) ^ Secret1, Read8(p, Offset + 8) ^ Seed);
+            Offset += 16;
+            Remaining -= 16;
+        }
+        a = Read8(p, Offset + Remaining - 16);
+        b = Read8(p, Offset + Remaining - 8);
+    }
+
+    const UInt128 r = Multiply(a ^ Secret1, b ^ Seed);
+    return Mix(r.Lo ^ Secret0 ^ static_cast<Uint64>(Len), r.Hi ^ Secret1);
+}
+
+} // namespace WyHash
+
+/// Returns the length of a null-terminated string. Unlike strlen, the function can be used in constant expressions.
+constexpr size_t StrLen(const char* Str)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_strlen(Str);
+#else
+    size_t Len = 0;
+    while (Str[Len] != 0)
+        ++Len;
+    return Len;
+#endif
+}
+
+/// Computes 64-bit hash of the byte sequence.
+constexpr Uint64 ComputeHash64(const char* Data, size_t Len, Uint64 Seed = 0)
+{
+    return WyHash::Hash(Data, Len, Seed);
+}
+
+/// Computes the hash of a null-terminated string. The function can be evaluated at compile time:
+///
+///     constexpr size_t NameHash = ComputeStringHash("g_Texture");
+///
+/// \note The hash is the same as the one computed by CStringHash<Char> and HashMapStringKey.
+constexpr size_t ComputeStringHash(const Char* Str)
+{
+    return static_cast<size_t>(ComputeHash64(Str, StrLen(Str)));
+}
+
 template <typename CharType>
 struct CStringHash
 {
     size_t operator()(const CharType* str) const
     {
-        // http://www.cse.yorku.ca/~oz/hash.html
-        std::size_t Seed = 0;
-        while (std::size_t Ch = *(str++))
-            Seed = Seed * 65599 + Ch;
-        return Seed;
+        size_t Len = 0;
+        while (str[Len] != 0)
+            ++Len;
+        return static_cast<size_t>(ComputeHash64(reinterpret_cast<const char*>(str), Len * sizeof(CharType)));
+    }
+};
+
+template <>
+struct CStringHash<Char>
+{
+    size_t operator()(const Char* str) const
+    {
+        return ComputeStringHash(str);
     }
 };
 
@@ -103,11 +271,22 @@ public:
     // This constructor can perform implicit const Char* -> HashMapStringKey
     // conversion without copying the string.
     HashMapStringKey(const Char* _Str, bool bMakeCopy = false) :
+        HashMapStringKey{_Str, _Str != nullptr ? ComputeStringHash(_Str) : 0, bMakeCopy}
+    {
+    }
+
+    /// Initializes the key with the precomputed string hash, which must be equal to ComputeStringHash(_Str).
+    /// This allows hashing string literals at compile time:
+    ///
+    ///     constexpr size_t TextureNameHash = ComputeStringHash("g_Texture");
+    ///     auto it = Map.find(HashMapStringKey{"g_Texture", TextureNameHash});
+    HashMapStringKey(const Char* _Str, size_t _Hash, bool bMakeCopy = false) :
         Str{_Str}
     {
         VERIFY(Str, "String pointer must not be null");
+        VERIFY(Str == nullptr || _Hash == ComputeStringHash(Str), "Precomputed hash does not match the hash of string '", Str, "'");
 
-        Ownership_Hash = CStringHash<Char>{}.operator()(Str) & HashMask;
+        Ownership_Hash = _Hash & HashMask;
         if (bMakeCopy)
         {
             auto  LenWithZeroTerm = strlen(Str) + 1;
@@ -24,38 +24,88 @@
  *  all other commercial damages or losses), even if such Contributor has been advised 
  *  of the possibility of such damages.
  */
-
 #pragma once
 
+#include <atomic>
+#include <vector>
+#include <string>
+
+#include "../../Primitives/interface/BasicTypes.h"
 #include "../../Platforms/interface/Atomics.hpp"
 #include "../../Platforms/Basic/interface/DebugUtilities.hpp"
 
 namespace ThreadingTools
 {
 
+/// Contention statistics of all locks that share the same name.
+struct LockStatistics
+{
+    std::atomic<Diligent::Uint64> NumAcquisitions{0}; ///< Total number of times the lock was acquired
+    std::atomic<Diligent::Uint64> NumContentions{0};  ///< Number of acquisitions that found the lock taken
+    std::atomic<Diligent::Uint64> NumSpins{0};        ///< Total number of spin iterations
+    std::atomic<Diligent::Uint64> NumParks{0};        ///< Number of times a thread was put to sleep waiting for the lock
+    std::atomic<Diligent::Uint64> TotalHoldTimeNs{0}; ///< Total time the lock was held, in nanoseconds
+};
+
+/// Snapshot of the statistics of a named lock.
+struct LockStatisticsSnapshot
+{
+    std::string      Name;
+    Diligent::Uint64 NumAcquisitions = 0;
+    Diligent::Uint64 NumContentions  = 0;
+    Diligent::Uint64 NumSpins        = 0;
+    Diligent::Uint64 NumParks        = 0;
+    Diligent::Uint64 TotalHoldTimeNs = 0;
+};
+
+/// Enables or disables collection of contention statistics for named locks.
+/// Statistics collection is disabled by default.
+void EnableLockStatistics(bool Enable) noexcept;
+
+/// Returns the statistics of all named locks.
+std::vector<LockStatisticsSnapshot> GetLockStatistics();
+
+/// Resets the statistics of all named locks.
+void ResetLockStatistics() noexcept;
+
+/// Prints the statistics of all named locks to the log.
+void DumpLockStatistics();
+
 class LockFlag
 {
 public:
     enum
     {
         LOCK_FLAG_UNLOCKED = 0,
-        LOCK_FLAG_LOCKED   = 1
+        LOCK_FLAG_LOCKED   = 1,
+        // The lock is taken and there may be threads sleeping on it
+        LOCK_FLAG_LOCKED_WITH_WAITERS = 2
     };
-    LockFlag(Atomics::Long InitFlag = LOCK_FLAG_UNLOCKED) noexcept
+    LockFlag(Atomics::Long InitFlag = LOCK_FLAG_UNLOCKED) noexcept :
+        m_Flag{static_cast<Diligent::Int32>(InitFlag)}
     {
-        //m_Flag.store(InitFlag);
-        m_Flag = InitFlag;
     }
 
+    /// Creates a named lock. When statistics collection is enabled by EnableLockStatistics(),
+    /// contention statistics of all locks with the same name are accumulated together.
+    /// Registering the name may allocate memory, so unlike the default constructor, this one may throw.
+    explicit LockFlag(const Diligent::Char* Name);
+
     operator Atomics::Long() const { return m_Flag; }
 
 private:
     friend class LockHelper;
-    Atomics::AtomicLong m_Flag;
+    // 32-bit value is required to use the flag as a futex
+    std::atomic<Diligent::Int32> m_Flag;
+
+    LockStatistics*  m_pStats       = nullptr;
+    Diligent::Uint64 m_LockTimeNs   = 0;
+    bool             m_StatsEnabled = false;
 };
 
-// Spinlock implementation. This kind of lock should be used in scenarios
-// where simultaneous access is uncommon but possible.
+// Lock implementation that spins with an exponential backoff for a short time, and then
+// puts the thread to sleep until the lock is released (on Linux and Android). This kind
+// of lock should be used in scenarios where simultaneous access is uncommon but possible.
 class LockHelper
 {
 public:
@@ -86,9 +136,14 @@ public:
 
     static bool UnsafeTryLock(LockFlag& LockFlag) noexcept
     {
-        return Atomics::AtomicCompareExchange(LockFlag.m_Flag,
-                                              static_cast<Atomics::Long>(LockFlag::LOCK_FLAG_LOCKED),
-                                              static_cast<Atomics::Long>(LockFlag::LOCK_FLAG_UNLOCKED)) == LockFlag::LOCK_FLAG_UNLOCKED;
+        Diligent::Int32 Expected = LockFlag::LOCK_FLAG_UNLOCKED;
+        if (LockFlag.m_Flag.compare_exchange_strong(Expected, LockFlag::LOCK_FLAG_LOCKED, std::memory_order_acquire, std::memory_order_relaxed))
+        {
+            if (LockFlag.m_pStats != nullptr)
+                OnLockAcquired(LockFlag, false, 0, 0);
+            return true;
+        }
+        return false;
     }
 
     bool TryLock(LockFlag& LockFlag) noexcept
@@ -102,41 +157,29 @@ public:
             return false;
     }
 
+    /// Maximum number of spin iterations before the thread is put to sleep.
     static constexpr const int DefaultSpinCountToYield = 256;
 
     static void UnsafeLock(LockFlag& LockFlag, int SpinCountToYield = DefaultSpinCountToYield) noexcept
     {
-        int SpinCount = 0;
-        while (!UnsafeTryLock(LockFlag))
-        {
-            ++SpinCount;
-            if (SpinCount == SpinCountToYield)
-            {
-                SpinCount = 0;
-                YieldThread();
-            }
-        }
+        if (!UnsafeTryLock(LockFlag))
+            LockContended(LockFlag, SpinCountToYield);
     }
 
     void Lock(LockFlag& LockFlag, int SpinCountToYield = DefaultSpinCountToYield) noexcept
     {
         VERIFY(m_pLockFlag == NULL, "Object already locked");
-        // Wait for the flag to become unlocked and lock it
-        int SpinCount = 0;
-        while (!TryLock(LockFlag))
-        {
-            ++SpinCount;
-            if (SpinCount == SpinCountToYield)
-            {
-                SpinCount = 0;
-                YieldThread();
-            }
-        }
+        UnsafeLock(LockFlag, SpinCountToYield);
+        m_pLockFlag = &LockFlag;
     }
 
     static void UnsafeUnlock(LockFlag& LockFlag) noexcept
     {
-        LockFlag.m_Flag = LockFlag::LOCK_FLAG_UNLOCKED;
+        if (LockFlag.m_pStats != nullptr)
+            OnLockReleased(LockFlag);
+
+        if (LockFlag.m_Flag.exchange(LockFlag::LOCK_FLAG_UNLOCKED, std::memory_order_release) == LockFlag::LOCK_FLAG_LOCKED_WITH_WAITERS)
+            WakeWaiter(LockFlag);
     }
 
     void Unlock() noexcept
@@ -147,7 +190,10 @@ public:
     }
 
 private:
-    static void YieldThread() noexcept;
+    static void LockContended(LockFlag& LockFlag, int SpinCountToYield) noexcept;
+    static void WakeWaiter(LockFlag& LockFlag) noexcept;
+    static void OnLockAcquired(LockFlag& LockFlag, bool Contended, Diligent::Uint32 NumSpins, Diligent::Uint32 NumParks) noexcept;
+    static void OnLockReleased(LockFlag& LockFlag) noexcept;
 
     LockFlag* m_pLockFlag = nullptr;
 
@@ -0,0 +1,101 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+#pragma once
+
+/// \file
+/// Implementation of the MappedFileStream class
+
+#include "../../Primitives/interface/FileStream.h"
+#include "../../Primitives/interface/DataBlob.h"
+#include "ObjectBase.hpp"
+#include "RefCntAutoPtr.hpp"
+
+namespace Diligent
+{
+
+// {2BDA77DD-CFBE-423A-9C0F-53C9B6E399DA}
+static const INTERFACE_ID IID_MappedFileStream =
+    {0x2bda77dd, 0xcfbe, 0x423a, {0x9c, 0xf, 0x53, 0xc9, 0xb6, 0xe3, 0x99, 0xda}};
+
+/// Read-only file stream that maps the file into memory.
+
+/// Unlike BasicFileStream, the stream does not read the file into a buffer: GetDataBlob()
+/// returns a data blob that references the mapped pages directly. The mapping is private,
+/// so writing to the blob data does not modify the file and only copies the pages that are written.
+/// If the file can't be mapped (or memory mapping is not supported on the platform), IsValid()
+/// returns false and the caller should fall back to BasicFileStream.
+///
+/// \note The file must not be truncated by other processes while it is mapped.
+class MappedFileStream : public ObjectBase<IFileStream>
+{
+public:
+    typedef ObjectBase<IFileStream> TBase;
+
+    MappedFileStream(IReferenceCounters* pRefCounters,
+                     const Char*         Path);
+
+    ~MappedFileStream();
+
+    virtual void DILIGENT_CALL_TYPE QueryInterface(const INTERFACE_ID& IID, IObject** ppInterface) override;
+
+    /// Reads data from the stream. The data is copied into pData; use GetDataBlob() to avoid the copy.
+    virtual void DILIGENT_CALL_TYPE ReadBlob(IDataBlob* pData) override;
+
+    /// Reads data from the stream
+    virtual bool DILIGENT_CALL_TYPE Read(void* Data, size_t Size) override;
+
+    /// Writing to a mapped file stream is not supported; the method always returns false.
+    virtual bool DILIGENT_CALL_TYPE Write(const void* Data, size_t Size) override;
+
+    virtual size_t DILIGENT_CALL_TYPE GetSize() override;
+
+    virtual bool DILIGENT_CALL_TYPE IsValid() override;
+
+    /// Returns the data blob that references the remaining mapped data without copying it,
+    /// and moves the read position to the end of the stream. The blob keeps the mapping alive.
+    void GetDataBlob(IDataBlob** ppBlob);
+
+    /// Returns the pointer to the mapped file data.
+    const void* GetMappedData() const { return m_pData; }
+
+private:
+    void*  m_pData         = nullptr;
+    size_t m_Size          = 0;
+    size_t m_CurrentOffset = 0;
+    bool   m_IsValid       = false;
+#if PLATFORM_WIN32
+    void* m_hFile    = nullptr;
+    void* m_hMapping = nullptr;
+#endif
+};
+
+/// Reads the remaining data of the stream into a data blob. If the stream is a
+/// MappedFileStream, the returned blob references the mapped file without copying.
+/// If the stream is a ReadOnlyMemoryFileStream, the returned blob is the shared blob of the stream.
+RefCntAutoPtr<IDataBlob> ReadFileStreamData(IFileStream* pStream);
+
+} // namespace Diligent
@@ -0,0 +1,82 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Implementation of the ReadOnlyMemoryFileStream class
+
+#include "../../Primitives/interface/FileStream.h"
+#include "../../Primitives/interface/DataBlob.h"
+#include "ObjectBase.hpp"
+#include "RefCntAutoPtr.hpp"
+
+namespace Diligent
+{
+
+// {D2FC297D-155F-4C37-85C5-BB206B3E9256}
+static const INTERFACE_ID IID_ReadOnlyMemoryFileStream =
+    {0xd2fc297d, 0x155f, 0x4c37, {0x85, 0xc5, 0xbb, 0x20, 0x6b, 0x3e, 0x92, 0x56}};
+
+/// Read-only file stream that reads the data from a data blob.
+
+/// Unlike MemoryFileStream, the stream never modifies the blob, so the same blob may
+/// be shared by any number of streams. GetDataBlob() returns the blob itself rather
+/// than a copy if nothing has been read from the stream yet.
+class ReadOnlyMemoryFileStream : public ObjectBase<IFileStream>
+{
+public:
+    typedef ObjectBase<IFileStream> TBase;
+
+    ReadOnlyMemoryFileStream(IReferenceCounters* pRefCounters,
+                             IDataBlob*          pData);
+
+    virtual void DILIGENT_CALL_TYPE QueryInterface(const INTERFACE_ID& IID, IObject** ppInterface) override;
+
+    /// Reads data from the stream. The data is copied into pData; use GetDataBlob() to avoid the copy.
+    virtual void DILIGENT_CALL_TYPE ReadBlob(IDataBlob* pData) override;
+
+    /// Reads data from the stream
+    virtual bool DILIGENT_CALL_TYPE Read(void* Data, size_t Size) override;
+
+    /// Writing to a read-only stream is not supported; the method always returns false.
+    virtual bool DILIGENT_CALL_TYPE Write(const void* Data, size_t Size) override;
+
+    virtual size_t DILIGENT_CALL_TYPE GetSize() override;
+
+    virtual bool DILIGENT_CALL_TYPE IsValid() override;
+
+    /// Returns the data blob with the remaining data of the stream, and moves the read position
+    /// to the end of the stream. The blob must not be modified as it may be shared with other streams.
+    void GetDataBlob(IDataBlob** ppBlob);
+
+private:
+    RefCntAutoPtr<IDataBlob> m_DataBlob;
+    size_t                   m_CurrentOffset = 0;
+};
+
+} // namespace Diligent
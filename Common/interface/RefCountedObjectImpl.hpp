@@ -30,6 +30,8 @@
 /// \file
 /// Implementation of the template base class for reference counting objects
 
+#include <atomic>
+
 #include "../../Primitives/interface/Object.h"
 #include "../../Primitives/interface/MemoryAllocator.h"
 #include "../../Platforms/interface/Atomics.hpp"
@@ -40,7 +42,15 @@
 namespace Diligent
 {
 
-// This class controls the lifetime of a refcounted object
+// This class controls the lifetime of a refcounted object.
+//
+// The reference counters are lock-free:
+//  - Weak-to-strong promotion in GetObject() only increments the strong reference counter if
+//    it is not zero. Once the counter reaches zero, it never goes up again, so the thread that
+//    decrements the counter to zero is the only one that destroys the object.
+//  - All strong references collectively own one weak reference. It is released after the object
+//    is destroyed, and the reference counters object is destroyed by whoever releases the last
+//    weak reference.
 class RefCountersImpl final : public IReferenceCounters
 {
 public:
@@ -57,13 +67,12 @@ public:
         VERIFY(m_ObjectState == ObjectState::Alive, "Attempting to decrement strong reference counter for an object that is not alive");
         VERIFY(m_ObjectWrapperBuffer[0] != 0 && m_ObjectWrapperBuffer[1] != 0, "Object wrapper is not initialized");
 
-        // Decrement strong reference counter without acquiring the lock.
         auto RefCount = Atomics::AtomicDecrement(m_lNumStrongReferences);
         VERIFY(RefCount >= 0, "Inconsistent call to ReleaseStrongRef()");
         if (RefCount == 0)
         {
             PreObjectDestroy();
-            TryDestroyObject();
+            DestroyObject();
         }
 
         return RefCount;
@@ -76,43 +85,25 @@ public:
 
     inline virtual ReferenceCounterValueType AddWeakRef() override final
     {
-        return Atomics::AtomicIncrement(m_lNumWeakReferences);
+        return ExcludeStrongRefsWeakRef(Atomics::AtomicIncrement(m_lNumWeakReferences));
     }
 
     inline virtual ReferenceCounterValueType ReleaseWeakRef() override final
     {
-        // The method must be serialized!
-        ThreadingTools::LockHelper Lock(m_LockFlag);
-        // It is essentially important to check the number of weak references
-        // while holding the lock. Otherwise reference counters object
-        // may be destroyed twice if ReleaseStrongRef() is executed by other
-        // thread.
+        // Other threads may destroy this object as soon as the counter is decremented,
+        // so the object state must be read beforehand.
+        const bool ObjectDestroyed = m_ObjectState == ObjectState::Destroyed;
+
         auto NumWeakReferences = Atomics::AtomicDecrement(m_lNumWeakReferences);
         VERIFY(NumWeakReferences >= 0, "Inconsistent call to ReleaseWeakRef()");
 
-        // There are two special case when we must not destroy the ref counters object even
-        // when NumWeakReferences == 0 && m_lNumStrongReferences == 0 :
+        // The weak reference owned by the strong references is only released after the object
+        // has been destroyed, so if the counter reaches zero, there are no more references of
+        // any kind and no other thread may access this object.
         //
-        //             This thread             |    Another thread - ReleaseStrongRef()
-        //                                     |
-        // 1. Lock the object                  |
-        //                                     |
-        // 2. Decrement m_lNumWeakReferences,  |   1. Decrement m_lNumStrongReferences,
-        //    m_lNumWeakReferences==0          |      RefCount == 0
-        //                                     |
-        //                                     |   2. Start waiting for the lock to destroy
-        //                                     |      the object, m_ObjectState != ObjectState::Destroyed
-        // 3. Do not destroy reference         |
-        //    counters, unlock                 |
-        //                                     |   3. Acquire the lock,
-        //                                     |      destroy the object,
-        //                                     |      read m_lNumWeakReferences==0
-        //                                     |      destroy the reference counters
-        //
-
         // If an exception is thrown during the object construction and there is a weak pointer to the object itself,
-        // we may get to this point, but should not destroy the reference counters, because it will be destroyed by MakeNewRCObj
-        // Consider this example:
+        // the counter does not reach zero here since the weak reference owned by the strong references has not been
+        // released. The reference counters are then destroyed by MakeNewRCObj:
         //
         //   A ==sp==> B ---wp---> A
         //
@@ -121,34 +112,23 @@ public:
         //    {
         //     A.ctor()
         //       B.ctor()
-        //        wp.ctor m_lNumWeakReferences==1
+        //        wp.ctor m_lNumWeakReferences==2
         //        throw
-        //        wp.dtor m_lNumWeakReferences==0, destroy this
+        //        wp.dtor m_lNumWeakReferences==1
         //    }
         //    catch(...)
         //    {
-        //       Destroy ref counters second time
+        //       Destroy ref counters
         //    }
         //
-        if (NumWeakReferences == 0 && /*m_lNumStrongReferences == 0 &&*/ m_ObjectState == ObjectState::Destroyed)
+        if (NumWeakReferences == 0)
         {
-            VERIFY_EXPR(m_lNumStrongReferences == 0);
+            VERIFY_EXPR(m_lNumStrongReferences == 0 && m_ObjectState == ObjectState::Destroyed);
             VERIFY(m_ObjectWrapperBuffer[0] == 0 && m_ObjectWrapperBuffer[1] == 0, "Object wrapper must be null");
-            // m_ObjectState is set to ObjectState::Destroyed under the lock. If the state is not Destroyed,
-            // ReleaseStrongRef() will take care of it.
-            // Access to Object wrapper and decrementing m_lNumWeakReferences is atomic. Since we acquired the lock,
-            // no other thread can access either of them.
-            // Access to m_lNumStrongReferences is NOT PROTECTED by lock.
-
-            // There are no more references to the ref counters object and the object itself
-            // is already destroyed.
-            // We can safely unlock it and destroy.
-            // If we do not unlock it, this->m_LockFlag will expire,
-            // which will cause Lock.~LockHelper() to crash.
-            Lock.Unlock();
             SelfDestroy();
+            return 0;
         }
-        return NumWeakReferences;
+        return ObjectDestroyed ? NumWeakReferences : NumWeakReferences - 1;
     }
 
     inline virtual void GetObject(struct IObject** ppObject) override final
@@ -156,50 +136,36 @@ public:
         if (m_ObjectState != ObjectState::Alive)
             return; // Early exit
 
-        // It is essential to INCREMENT REF COUNTER while HOLDING THE LOCK to make sure that
-        // StrongRefCnt > 1 guarantees that the object is alive.
-
-        // If other thread started deleting the object in ReleaseStrongRef(), then m_lNumStrongReferences==0
-        // We must make sure only one thread is allowed to increment the counter to guarantee that if StrongRefCnt > 1,
-        // there is at least one real strong reference left. Otherwise the following scenario may occur:
+        // Increment the strong reference counter only if it is not zero. If another thread
+        // has decremented the counter to zero, it is destroying the object, and the counter
+        // must never be incremented again. Otherwise the following scenario may occur:
         //
         //                                      m_lNumStrongReferences == 1
         //
-        //    Thread 1 - ReleaseStrongRef()    |     Thread 2 - GetObject()        |     Thread 3 - GetObject()
-        //                                     |                                   |
-        //  - Decrement m_lNumStrongReferences | -Increment m_lNumStrongReferences | -Increment m_lNumStrongReferences
-        //  - Read RefCount == 0               | -Read StrongRefCnt==1             | -Read StrongRefCnt==2
-        //    Destroy the object               |                                   | -Return reference to the soon
-        //                                     |                                   |  to expire object
-        //
-        ThreadingTools::LockHelper Lock(m_LockFlag);
-
-        auto StrongRefCnt = Atomics::AtomicIncrement(m_lNumStrongReferences);
-
-        // Checking if m_ObjectState == ObjectState::Alive only is not reliable:
+        //    Thread 1 - ReleaseStrongRef()    |     Thread 2 - GetObject()
+        //                                     |
+        //  - Decrement m_lNumStrongReferences |
+        //  - Read RefCount == 0               | - Increment m_lNumStrongReferences
+        //    Destroy the object               | - Return reference to the destroyed object
         //
-        //           This thread                    |          Another thread
-        //                                          |
-        //   1. Acquire the lock                    |
-        //                                          |    1. Decrement m_lNumStrongReferences
-        //   2. Increment m_lNumStrongReferences    |    2. Test RefCount==0
-        //   3. Read StrongRefCnt == 1              |    3. Start destroying the object
-        //      m_ObjectState == ObjectState::Alive |
-        //   4. DO NOT return the reference to      |    4. Wait for the lock, m_ObjectState == ObjectState::Alive
-        //      the object                          |
-        //   5. Decrement m_lNumStrongReferences    |
-        //                                          |    5. Destroy the object
-
-        if (m_ObjectState == ObjectState::Alive && StrongRefCnt > 1)
+        auto StrongRefCnt = m_lNumStrongReferences.load();
+        while (StrongRefCnt > 0)
         {
-            VERIFY(m_ObjectWrapperBuffer[0] != 0 && m_ObjectWrapperBuffer[1] != 0, "Object wrapper is not initialized");
-            // QueryInterface() must not lock the object, or a deadlock happens.
-            // The only other two methods that lock the object are ReleaseStrongRef()
-            // and ReleaseWeakRef(), which are never called by QueryInterface()
-            auto* pWrapper = reinterpret_cast<ObjectWrapperBase*>(m_ObjectWrapperBuffer);
-            pWrapper->QueryInterface(IID_Unknown, ppObject);
+            if (m_lNumStrongReferences.compare_exchange_weak(StrongRefCnt, StrongRefCnt + 1))
+            {
+                // We now hold a strong reference, which guarantees that the object is alive
+                VERIFY_EXPR(m_ObjectState == ObjectState::Alive);
+                VERIFY(m_ObjectWrapperBuffer[0] != 0 && m_ObjectWrapperBuffer[1] != 0, "Object wrapper is not initialized");
+                auto* pWrapper = reinterpret_cast<ObjectWrapperBase*>(m_ObjectWrapperBuffer);
+                pWrapper->QueryInterface(IID_Unknown, ppObject);
+
+                // QueryInterface() added its own reference, so the counter cannot reach zero here
+                // unless QueryInterface() failed. In the latter case, release the object properly.
+                ReleaseStrongRef();
+                return;
+            }
+            // compare_exchange_weak() updated StrongRefCnt with the current value of the counter
         }
-        Atomics::AtomicDecrement(m_lNumStrongReferences);
     }
 
     inline virtual ReferenceCounterValueType GetNumStrongRefs() const override final
@@ -209,10 +175,16 @@ public:
 
     inline virtual ReferenceCounterValueType GetNumWeakRefs() const override final
     {
-        return m_lNumWeakReferences;
+        return ExcludeStrongRefsWeakRef(m_lNumWeakReferences);
     }
 
 private:
+    // Excludes the weak reference owned by the strong references from the weak reference count
+    ReferenceCounterValueType ExcludeStrongRefsWeakRef(ReferenceCounterValueType NumWeakRefs) const
+    {
+        return m_ObjectState != ObjectState::Destroyed ? NumWeakRefs - 1 : NumWeakRefs;
+    }
+
     template <typename AllocatorType, typename ObjectType>
     friend class MakeNewRCObj;
 
@@ -269,180 +241,39 @@ private:
         m_ObjectState = ObjectState::Alive;
     }
 
-    void TryDestroyObject()
+    void DestroyObject()
     {
-        // Since RefCount==0, there are no more strong references and the only place
-        // where strong ref counter can be incremented is from GetObject().
-
-        // If several threads were allowed to get to this point, there would
-        // be serious risk that <this> had already been destroyed and m_LockFlag expired.
-        // Consider the following scenario:
-        //                                      |
-        //             This thread              |             Another thread
-        //                                      |
-        //                      m_lNumStrongReferences == 1
-        //                      m_lNumWeakReferences == 1
-        //                                      |
-        // 1. Decrement m_lNumStrongReferences  |
-        //    Read RefCount==0, no lock acquired|
-        //                                      |   1. Run GetObject()
-        //                                      |      - acquire the lock
-        //                                      |      - increment m_lNumStrongReferences
-        //                                      |      - release the lock
-        //                                      |
-        //                                      |   2. Run ReleaseWeakRef()
-        //                                      |      - decrement m_lNumWeakReferences
-        //                                      |
-        //                                      |   3. Run ReleaseStrongRef()
-        //                                      |      - decrement m_lNumStrongReferences
-        //                                      |      - read RefCount==0
-        //
-        //         Both threads will get to this point. The first one will destroy <this>
-        //         The second one will read expired m_LockFlag
-
-        //  IT IS CRUCIALLY IMPORTANT TO ASSURE THAT ONLY ONE THREAD WILL EVER
-        //  EXECUTE THIS CODE
-
-        // The sloution is to atomically increment strong ref counter in GetObject().
-        // There are two possible scenarios depending on who first increments the counter:
-
+        // Since the strong reference counter has reached zero and GetObject() never increments
+        // the counter once it is zero, only one thread may ever get to this point.
+        VERIFY_EXPR(m_lNumStrongReferences == 0 && m_ObjectState == ObjectState::Alive);
+        VERIFY(m_ObjectWrapperBuffer[0] != 0 && m_ObjectWrapperBuffer[1] != 0, "Object wrapper is not initialized");
 
-        //                                                     Scenario I
+        // Copy the object wrapper since the reference counters may be destroyed while the
+        // object destructor is running: m_pObject may not be the only object referencing
+        // the reference counters. All objects that are owned by m_pObject will point to the
+        // same reference counters object, and the weak reference owned by the strong references
+        // is the only thing that keeps it alive.
+        size_t ObjectWrapperBufferCopy[ObjectWrapperBufferSize];
+        memcpy(ObjectWrapperBufferCopy, m_ObjectWrapperBuffer, sizeof(m_ObjectWrapperBuffer));
+        memset(m_ObjectWrapperBuffer, 0, sizeof(m_ObjectWrapperBuffer));
+
+        // Note that this is the only place where m_ObjectState is
+        // modified after the ref counters object has been created
+        m_ObjectState = ObjectState::Destroyed;
+
+        // Destroy referenced object. The object may release weak references to itself,
+        // for example:
         //
-        //             This thread              |      Another thread - GetObject()         |   One more thread - GetObject()
-        //                                      |                                           |
-        //                       m_lNumStrongReferences == 1                                |
-        //                                      |                                           |
-        //                                      |   1. Acquire the lock                     |
-        // 1. Decrement m_lNumStrongReferences  |                                           |   1. Wait for the lock
-        // 2. Read RefCount==0                  |   2. Increment m_lNumStrongReferences     |
-        // 3. Start destroying the object       |   3. Read StrongRefCnt == 1               |
-        // 4. Wait for the lock                 |   4. DO NOT return the reference          |
-        //                                      |      to the object                        |
-        //                                      |   5. Decrement m_lNumStrongReferences     |
-        // _  _  _  _  _  _  _  _  _  _  _  _  _|   6. Release the lock _  _  _  _  _  _  _ |_  _  _  _  _  _  _  _  _  _  _  _  _  _
-        //                                      |                                           |   2. Acquire the lock
-        //                                      |                                           |   3. Increment m_lNumStrongReferences
-        //                                      |                                           |   4. Read StrongRefCnt == 1
-        //                                      |                                           |   5. DO NOT return the reference
-        //                                      |                                           |      to the object
-        //                                      |                                           |   6. Decrement m_lNumStrongReferences
-        //  _  _  _  _  _  _  _  _  _  _  _  _  | _  _  _  _  _  _  _  _  _  _  _  _  _  _  | _ 7. Release the lock _  _  _  _  _  _
-        // 5. Acquire the lock                  |                                           |
-        //   - m_lNumStrongReferences==0        |                                           |
-        // 6. DESTROY the object                |                                           |
-        //                                      |                                           |
-
-        //  GetObject() MUST BE SERIALIZED for this to work properly!
-
-
-        //                                   Scenario II
+        //    A ==sp==> B ---wp---> A
         //
-        //             This thread              |      Another thread - GetObject()
-        //                                      |
-        //                       m_lNumStrongReferences == 1
-        //                                      |
-        //                                      |   1. Acquire the lock
-        //                                      |   2. Increment m_lNumStrongReferences
-        // 1. Decrement m_lNumStrongReferences  |
-        // 2. Read RefCount>0                   |
-        // 3. DO NOT destroy the object         |   3. Read StrongRefCnt > 1 (while m_lNumStrongReferences == 1)
-        //                                      |   4. Return the reference to the object
-        //                                      |       - Increment m_lNumStrongReferences
-        //                                      |   5. Decrement m_lNumStrongReferences
-
-#ifdef DILIGENT_DEBUG
-        {
-            Atomics::Long NumStrongRefs = m_lNumStrongReferences;
-            VERIFY(NumStrongRefs == 0 || NumStrongRefs == 1, "Num strong references (", NumStrongRefs, ") is expected to be 0 or 1");
-        }
-#endif
-
-        // Acquire the lock.
-        ThreadingTools::LockHelper Lock(m_LockFlag);
-
-        // GetObject() first acquires the lock, and only then increments and
-        // decrements the ref counter. If it reads 1 after incremeting the counter,
-        // it does not return the reference to the object and decrements the counter.
-        // If we acquired the lock, GetObject() will not start until we are done
-        VERIFY_EXPR(m_lNumStrongReferences == 0 && m_ObjectState == ObjectState::Alive);
-
-        // Extra caution
-        if (m_lNumStrongReferences == 0 && m_ObjectState == ObjectState::Alive)
-        {
-            VERIFY(m_ObjectWrapperBuffer[0] != 0 && m_ObjectWrapperBuffer[1] != 0, "Object wrapper is not initialized");
-            // We cannot destroy the object while reference counters are locked as this will
-            // cause a deadlock in cases like this:
-            //
-            //    A ==sp==> B ---wp---> A
-            //
-            //    RefCounters_A.Lock();
-            //    delete A{
-            //      A.~dtor(){
-            //          B.~dtor(){
-            //              wpA.ReleaseWeakRef(){
-            //                  RefCounters_A.Lock(); // Deadlock
-            //
-
-            // So we copy the object wrapper and destroy the object after unlocking the
-            // reference counters
-            size_t ObjectWrapperBufferCopy[ObjectWrapperBufferSize];
-            memcpy(ObjectWrapperBufferCopy, m_ObjectWrapperBuffer, sizeof(m_ObjectWrapperBuffer));
-            memset(m_ObjectWrapperBuffer, 0, sizeof(m_ObjectWrapperBuffer));
-
-            auto* pWrapper = reinterpret_cast<ObjectWrapperBase*>(ObjectWrapperBufferCopy);
-
-            // In a multithreaded environment, reference counters object may
-            // be destroyed at any time while m_pObject->~dtor() is running.
-            // NOTE: m_pObject may not be the only object referencing m_pRefCounters.
-            //       All objects that are owned by m_pObject will point to the same
-            //       reference counters object.
-
-            // Note that this is the only place where m_ObjectState is
-            // modified after the ref counters object has been created
-            m_ObjectState = ObjectState::Destroyed;
-            // The object is now detached from the reference counters and it is if
-            // it was destroyed since no one can obtain access to it.
-
-
-            // It is essentially important to check the number of weak references
-            // while the object is locked. Otherwise reference counters object
-            // may be destroyed twice if ReleaseWeakRef() is executed by other thread:
-            //
-            //             This thread             |    Another thread - ReleaseWeakRef()
-            //                                     |
-            // 1. Decrement m_lNumStrongReferences,|
-            //    m_lNumStrongReferences==0,       |
-            //    acquire the lock, destroy        |
-            //    the obj, release the lock        |
-            //    m_lNumWeakReferences == 1        |
-            //                                     |   1. Aacquire the lock,
-            //                                     |      decrement m_lNumWeakReferences,
-            //                                     |      m_lNumWeakReferences == 0,
-            //                                     |      m_ObjectState == ObjectState::Destroyed
-            //                                     |
-            // 2. Read m_lNumWeakReferences == 0   |
-            // 3. Destroy the ref counters obj     |   2. Destroy the ref counters obj
-            //
-            bool bDestroyThis = m_lNumWeakReferences == 0;
-            // ReleaseWeakRef() decrements m_lNumWeakReferences, and checks it for
-            // zero only after acquiring the lock. So if m_lNumWeakReferences==0, no
-            // weak reference-related code may be running
-
-
-            // We must explicitly unlock the object now to avoid deadlocks. Also,
-            // if this is deleted, this->m_LockFlag will expire, which will cause
-            // Lock.~LockHelper() to crash
-            Lock.Unlock();
-
-            // Destroy referenced object
-            pWrapper->DestroyObject();
-
-            // Note that <this> may be destroyed here already,
-            // see comments in ~ControlledObjectType()
-            if (bDestroyThis)
-                SelfDestroy();
-        }
+        // This is safe since the reference counters are kept alive by the weak reference
+        // owned by the strong references.
+        auto* pWrapper = reinterpret_cast<ObjectWrapperBase*>(ObjectWrapperBufferCopy);
+        pWrapper->DestroyObject();
+
+        // Release the weak reference owned by the strong references.
+        // Note that <this> may be destroyed here.
+        ReleaseWeakRef();
     }
 
     void SelfDestroy()
@@ -452,7 +283,9 @@ private:
 
     ~RefCountersImpl()
     {
-        VERIFY(m_lNumStrongReferences == 0 && m_lNumWeakReferences == 0,
+        // If the object constructor has thrown an exception, MakeNewRCObj destroys the reference
+        // counters while the weak reference owned by the strong references is still held.
+        VERIFY(m_lNumStrongReferences == 0 && (m_lNumWeakReferences == 0 || (m_lNumWeakReferences == 1 && m_ObjectState == ObjectState::NotInitialized)),
                "There exist outstanding references to the object being destroyed");
     }
 
@@ -476,9 +309,8 @@ private:
     size_t m_ObjectWrapperBuffer[ObjectWrapperBufferSize]{};
 
     Atomics::AtomicLong m_lNumStrongReferences{0};
-    Atomics::AtomicLong m_lNumWeakReferences{0};
-
-    ThreadingTools::LockFlag m_LockFlag;
+    // The counter includes one weak reference collectively owned by all strong references
+    Atomics::AtomicLong m_lNumWeakReferences{1};
 
     enum class ObjectState : Int32
     {
@@ -486,7 +318,7 @@ private:
         Alive,
         Destroyed
     };
-    volatile ObjectState m_ObjectState = ObjectState::NotInitialized;
+    std::atomic<ObjectState> m_ObjectState{ObjectState::NotInitialized};
 };
 
 
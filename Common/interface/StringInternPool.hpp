@@ -0,0 +1,190 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+#pragma once
+
+/// \file
+/// Defines Diligent::StringInternPool class
+
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+
+#include "../../Primitives/interface/BasicTypes.h"
+#include "../../Primitives/interface/MemoryAllocator.h"
+#include "../../Platforms/Basic/interface/DebugUtilities.hpp"
+#include "DynamicLinearAllocator.hpp"
+#include "HashUtils.hpp"
+#include "STDAllocator.hpp"
+
+namespace Diligent
+{
+
+/// Growable string pool that keeps a single copy of every unique string (string interning).
+
+/// Unlike StringPool, the pool does not need to be reserved up front: strings are copied
+/// into memory pages that are allocated on demand. Pointers returned by Intern() remain valid
+/// until the pool is cleared or destroyed. Since equal strings share the same copy, interned
+/// strings can be compared by pointer:
+///
+///     const auto* Name0 = Pool.Intern("g_Texture");
+///     const auto* Name1 = Pool.Intern(std::string{"g_Texture"});
+///     VERIFY_EXPR(Name0 == Name1);
+///
+/// The string copies and the hash table are allocated through the allocator passed to the constructor.
+/// All methods are thread-safe.
+class StringInternPool
+{
+public:
+    explicit StringInternPool(IMemoryAllocator& Allocator, Uint32 PageSize = 4 << 10) :
+        m_Allocator{Allocator},
+        m_PageSize{PageSize},
+        m_Strings{std::make_unique<DynamicLinearAllocator>(Allocator, PageSize)},
+        m_Entries{0, Entry::Hasher{}, std::equal_to<Entry>{}, STD_ALLOCATOR_RAW_MEM(Entry, Allocator, "Allocator for unordered_set<StringInternPool::Entry>")}
+    {
+    }
+
+    // clang-format off
+    StringInternPool           (const StringInternPool&) = delete;
+    StringInternPool           (StringInternPool&&)      = delete;
+    StringInternPool& operator=(const StringInternPool&) = delete;
+    StringInternPool& operator=(StringInternPool&&)      = delete;
+    // clang-format on
+
+    /// Returns the interned copy of the first Len characters of Str.
+    /// The returned string is always null-terminated.
+    const Char* Intern(const Char* Str, size_t Len)
+    {
+        VERIFY_EXPR(Str != nullptr || Len == 0);
+
+        const Entry Key{Str, Len, static_cast<size_t>(ComputeHash64(Str, Len))};
+
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+
+        auto it = m_Entries.find(Key);
+        if (it != m_Entries.end())
+            return it->Str;
+
+        auto* Copy = m_Strings->Allocate<Char>(Len + 1);
+        if (Len != 0)
+            memcpy(Copy, Str, Len * sizeof(Char));
+        Copy[Len] = 0;
+
+        m_Entries.emplace(Copy, Len, Key.Hash);
+        m_MemorySize += Len + 1;
+        return Copy;
+    }
+
+    /// Returns the interned copy of the null-terminated string Str, or null if Str is null.
+    const Char* Intern(const Char* Str)
+    {
+        return Str != nullptr ? Intern(Str, strlen(Str)) : nullptr;
+    }
+
+    const Char* Intern(const String& Str)
+    {
+        return Intern(Str.c_str(), Str.length());
+    }
+
+    /// Returns the interned copy of Str if the string is in the pool, and null otherwise.
+    const Char* Find(const Char* Str) const
+    {
+        if (Str == nullptr)
+            return nullptr;
+
+        const auto  Len = strlen(Str);
+        const Entry Key{Str, Len, static_cast<size_t>(ComputeHash64(Str, Len))};
+
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+
+        auto it = m_Entries.find(Key);
+        return it != m_Entries.end() ? it->Str : nullptr;
+    }
+
+    /// Releases all strings. All pointers previously returned by the pool become invalid.
+    void Clear()
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+
+        m_Entries.clear();
+        // DynamicLinearAllocator::Free() also resets the allocator pointer, so the allocator is recreated
+        m_Strings    = std::make_unique<DynamicLinearAllocator>(m_Allocator, m_PageSize);
+        m_MemorySize = 0;
+    }
+
+    /// Returns the number of unique strings in the pool.
+    size_t GetNumStrings() const
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        return m_Entries.size();
+    }
+
+    /// Returns the total size of all unique strings, including null terminators.
+    size_t GetMemorySize() const
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        return m_MemorySize;
+    }
+
+private:
+    struct Entry
+    {
+        const Char* Str;
+        size_t      Len;
+        size_t      Hash;
+
+        Entry(const Char* _Str, size_t _Len, size_t _Hash) :
+            Str{_Str},
+            Len{_Len},
+            Hash{_Hash}
+        {}
+
+        bool operator==(const Entry& rhs) const
+        {
+            return Hash == rhs.Hash && Len == rhs.Len && (Len == 0 || memcmp(Str, rhs.Str, Len * sizeof(Char)) == 0);
+        }
+
+        struct Hasher
+        {
+            size_t operator()(const Entry& E) const
+            {
+                return E.Hash;
+            }
+        };
+    };
+
+    IMemoryAllocator& m_Allocator;
+    const Uint32      m_PageSize;
+
+    mutable std::mutex m_Mtx;
+
+    std::unique_ptr<DynamicLinearAllocator>                                                   m_Strings;
+    std::unordered_set<Entry, Entry::Hasher, std::equal_to<Entry>, STDAllocatorRawMem<Entry>> m_Entries;
+    size_t                                                                                    m_MemorySize = 0;
+};
+
+} // namespace Diligent
@@ -0,0 +1,118 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Defines Diligent::ThreadPool class
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+#include "../../Primitives/interface/BasicTypes.h"
+
+namespace Diligent
+{
+
+/// A fixed-size pool of worker threads that executes parallel loops.
+
+/// The thread that calls ParallelFor() takes part in the work, so a pool with N worker
+/// threads runs a loop on up to N + 1 threads. ParallelFor() may be called from multiple
+/// threads at the same time; the loops are then served by the workers in the order of
+/// submission.
+class ThreadPool
+{
+public:
+    struct CreateInfo
+    {
+        /// The number of worker threads. If zero, the pool creates one thread less
+        /// than the number of hardware threads, so that together with the calling
+        /// thread all cores are busy.
+        Uint32 NumThreads = 0;
+
+        /// Optional function called by every worker thread after it has started.
+        std::function<void(Uint32 ThreadId)> OnThreadStarted;
+
+        /// Optional function called by every worker thread before it exits.
+        std::function<void(Uint32 ThreadId)> OnThreadExiting;
+    };
+
+    explicit ThreadPool(const CreateInfo& CI);
+    ~ThreadPool();
+
+    // clang-format off
+    ThreadPool           (const ThreadPool&)  = delete;
+    ThreadPool           (      ThreadPool&&) = delete;
+    ThreadPool& operator=(const ThreadPool&)  = delete;
+    ThreadPool& operator=(      ThreadPool&&) = delete;
+    // clang-format on
+
+    /// Calls Func(i) for every i in [0, Count) and waits until all calls have returned.
+
+    /// The calls are distributed between the worker threads and the calling thread
+    /// in no particular order. Func must not throw exceptions.
+    void ParallelFor(Uint32 Count, const std::function<void(Uint32)>& Func);
+
+    Uint32 GetNumThreads() const
+    {
+        return static_cast<Uint32>(m_Threads.size());
+    }
+
+    /// Returns the process-wide pool that is created on first use with the default number of threads.
+    static ThreadPool& GetGlobal();
+
+private:
+    struct Loop;
+
+    void WorkerThreadProc(Uint32 ThreadId);
+
+    static void RunLoop(Loop& L);
+
+    const CreateInfo m_CI;
+
+    std::mutex              m_Mtx;
+    std::condition_variable m_WorkCV;
+    std::condition_variable m_DoneCV;
+    std::vector<Loop*>      m_Loops; // Loops that still have unclaimed iterations
+    bool                    m_Stop = false;
+
+    std::vector<std::thread> m_Threads;
+};
+
+/// Splits [0, NumItems) into min(NumThreads, NumItems) ranges of equal size and calls
+/// Func(StartItem, EndItem) for every range.
+
+/// A single range is processed by the calling thread. Otherwise, the ranges are processed
+/// by the calling thread and the workers of ThreadPool::GetGlobal(), so no threads are
+/// created by the call. Func must not throw exceptions.
+void ParallelForRanges(Uint32 NumItems, Uint32 NumThreads, const std::function<void(Uint32 StartItem, Uint32 EndItem)>& Func);
+
+} // namespace Diligent
@@ -0,0 +1,190 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Defines Diligent::TrackingMemoryAllocator class
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../../Primitives/interface/BasicTypes.h"
+#include "../../Primitives/interface/MemoryAllocator.h"
+
+namespace Diligent
+{
+
+/// Allocation statistics of one description tag
+struct TrackingAllocatorTagStats
+{
+    /// The number of allocation size classes.
+
+    /// Size class 0 contains allocations of up to 16 bytes, size class i contains
+    /// allocations of (2^(i+3), 2^(i+4)] bytes, and the last class also contains
+    /// all larger allocations.
+    static constexpr Uint32 NumSizeClasses = 24;
+
+    /// Allocation description, see IMemoryAllocator::Allocate().
+    std::string Description;
+
+    /// File name and line number of the first allocation with this description.
+    std::string FirstAllocationSource;
+
+    /// The number of bytes that are currently allocated.
+    Int64 LiveBytes = 0;
+
+    /// The number of allocations that have not been released.
+    Int64 LiveAllocations = 0;
+
+    /// The maximum number of bytes that have been allocated at the same time,
+    /// see TrackingMemoryAllocator::TrackingMemoryAllocator().
+    Int64 PeakBytes = 0;
+
+    /// The total number of allocations.
+    Uint64 TotalAllocations = 0;
+
+    /// The total number of allocated bytes.
+    Uint64 TotalBytes = 0;
+
+    /// The number of allocations of every size class.
+    std::array<Uint64, NumSizeClasses> SizeHistogram = {};
+};
+
+/// Snapshot of the statistics of TrackingMemoryAllocator
+struct TrackingAllocatorSnapshot
+{
+    /// Statistics of all allocations.
+    TrackingAllocatorTagStats Total;
+
+    /// Statistics of every description tag sorted by the number of live bytes in descending order.
+    std::vector<TrackingAllocatorTagStats> Tags;
+
+    /// Returns the change of the statistics since the earlier snapshot of the same allocator.
+
+    /// Live, total and histogram values are the differences between the snapshots, and peak values
+    /// are the values of this snapshot. Tags that have no allocations or deallocations between
+    /// the snapshots are omitted.
+    TrackingAllocatorSnapshot Diff(const TrackingAllocatorSnapshot& Earlier) const;
+
+    /// Returns the snapshot as a JSON string.
+    std::string ToJSON() const;
+};
+
+struct TrackingAllocatorTagInfo;
+struct TrackingAllocatorTagCounters;
+struct TrackingAllocatorThreadCounters;
+
+template <typename OwnerType, typename ObjectType>
+class ThreadSlotRegistry;
+
+/// Memory allocator that forwards allocations to another allocator and collects
+/// allocation statistics for every description tag.
+
+/// Allocations are grouped by their dbgDescription strings. Every thread updates its own
+/// counters, so that allocations made by different threads do not contend. The allocator
+/// is opt-in: pass it to EngineCreateInfo::pRawMemAllocator or to any other object that takes
+/// IMemoryAllocator to track its memory:
+///
+///     TrackingMemoryAllocator Tracker{DefaultRawMemoryAllocator::GetAllocator()};
+///     EngineCI.pRawMemAllocator = &Tracker;
+///     ...
+///     auto Before = Tracker.GetSnapshot();
+///     ...
+///     LOG_INFO_MESSAGE(Tracker.GetSnapshot().Diff(Before).ToJSON());
+///
+/// Every allocation is prefixed with a 16-byte header that holds its size and tag.
+///
+/// \note Descriptions are identified by their text, so descriptions with equal text at
+///       different addresses are merged into one tag, and a buffer may be reused for
+///       different descriptions.
+class TrackingMemoryAllocator final : public IMemoryAllocator
+{
+public:
+    /// \param [in] RawAllocator     - Allocator that allocates the memory.
+    /// \param [in] PeakUpdateBytes  - Threads update peak values when the number of live bytes they
+    ///                                allocated or released for a tag since the last update exceeds
+    ///                                this value, so the peaks may be underestimated by up to
+    ///                                PeakUpdateBytes per thread. Zero makes the peaks exact at the
+    ///                                cost of two atomic operations per allocation and deallocation.
+    explicit TrackingMemoryAllocator(IMemoryAllocator& RawAllocator, Uint32 PeakUpdateBytes = 64 << 10);
+    ~TrackingMemoryAllocator();
+
+    /// Allocates block of memory
+    virtual void* Allocate(size_t Size, const Char* dbgDescription, const char* dbgFileName, const Int32 dbgLineNumber) override final;
+
+    /// Releases memory
+    virtual void Free(void* Ptr) override final;
+
+    /// Returns the current statistics.
+
+    /// Counters that are updated by other threads at the same time may be observed partially.
+    TrackingAllocatorSnapshot GetSnapshot() const;
+
+private:
+    // clang-format off
+    TrackingMemoryAllocator             (const TrackingMemoryAllocator&) = delete;
+    TrackingMemoryAllocator             (TrackingMemoryAllocator&&)      = delete;
+    TrackingMemoryAllocator& operator = (const TrackingMemoryAllocator&) = delete;
+    TrackingMemoryAllocator& operator = (TrackingMemoryAllocator&&)      = delete;
+    // clang-format on
+
+    friend class ThreadSlotRegistry<TrackingMemoryAllocator, TrackingAllocatorThreadCounters>;
+
+    Uint32                           RegisterTag(const Char* dbgDescription, const char* dbgFileName, Int32 dbgLineNumber);
+    TrackingAllocatorThreadCounters* GetThreadCounters(); // Returns null if the thread table has been destroyed
+    TrackingAllocatorThreadCounters& RegisterThreadCounters();
+    TrackingAllocatorTagCounters&    GetTagCounters(TrackingAllocatorThreadCounters& ThreadCounters, Uint32 TagId);
+    void                             UpdateLiveBytes(TrackingAllocatorThreadCounters& ThreadCounters, TrackingAllocatorTagCounters& Counters, Int64 Delta);
+
+    // Updates m_RetiredCounters directly. Used by exiting threads whose counters have already been retired.
+    void UpdateRetiredCounters(Uint32 TagId, size_t Size, bool IsAllocation);
+
+    // Moves the counters of an exiting thread to m_RetiredCounters. Called while the thread cache registry mutex is locked.
+    void OnThreadExit(TrackingAllocatorThreadCounters& ThreadCounters);
+
+    IMemoryAllocator& m_RawAllocator;
+    const Int64       m_PeakUpdateBytes;
+
+    // Tags are never removed, so pointers to them remain valid
+    mutable std::mutex                                     m_TagsMtx;
+    std::vector<std::unique_ptr<TrackingAllocatorTagInfo>> m_Tags;
+    std::unordered_map<std::string, Uint32>                m_TagIds;
+    std::unique_ptr<TrackingAllocatorTagInfo>              m_pTotal;
+
+    // Protected by the thread cache registry mutex
+    Uint32                                        m_ThreadCacheSlot = 0;
+    std::vector<TrackingAllocatorThreadCounters*> m_ThreadCounters;
+    std::vector<TrackingAllocatorTagStats>        m_RetiredCounters; // Counters of exited threads
+};
+
+} // namespace Diligent
@@ -27,8 +27,10 @@
 
 #include "pch.h"
 #include <algorithm>
+#include <cstddef>
 #include "FixedBlockMemoryAllocator.hpp"
 #include "Align.hpp"
+#include "ThreadSlotRegistry.hpp"
 
 namespace Diligent
 {
@@ -38,31 +40,193 @@ static size_t AdjustBlockSize(size_t BlockSize)
     return AlignUp(std::max(BlockSize, size_t{1}), sizeof(void*));
 }
 
-FixedBlockMemoryAllocator::FixedBlockMemoryAllocator(IMemoryAllocator& RawMemoryAllocator,
-                                                     size_t            BlockSize,
-                                                     Uint32            NumBlocksInPage) :
+// Free blocks cached by one thread for one allocator.
+// The blocks are linked through their first bytes.
+struct FixedBlockAllocatorMagazine
+{
+    explicit FixedBlockAllocatorMagazine(FixedBlockMemoryAllocator* _pOwner) noexcept :
+        pOwner{_pOwner}
+    {}
+
+    void Push(void* pBlock)
+    {
+        *reinterpret_cast<void**>(pBlock) = pFirstBlock;
+        pFirstBlock                       = pBlock;
+        ++NumBlocks;
+    }
+
+    void* Pop()
+    {
+        VERIFY_EXPR(NumBlocks > 0 && pFirstBlock != nullptr);
+        void* pBlock = pFirstBlock;
+        pFirstBlock  = *reinterpret_cast<void**>(pBlock);
+        --NumBlocks;
+        return pBlock;
+    }
+
+    // The owner is reset to null under the registry mutex when the allocator is destroyed.
+    std::atomic<FixedBlockMemoryAllocator*> pOwner;
+
+    void*  pFirstBlock = nullptr;
+    Uint32 NumBlocks   = 0;
+};
+
+// Per-thread tables of magazines indexed by the allocator thread cache slot
+using FixedBlockAllocatorThreadCache = ThreadSlotRegistry<FixedBlockMemoryAllocator, FixedBlockAllocatorMagazine>;
+
+// Header located at the beginning of every aligned page in thread-caching mode
+struct FixedBlockMemoryAllocator::AlignedPageHeader
+{
+    void LinkAvailable(AlignedPageHeader*& pHead)
+    {
+        VERIFY_EXPR(pPrevAvailable == nullptr && pNextAvailable == nullptr && pHead != this);
+        pNextAvailable = pHead;
+        if (pHead != nullptr)
+            pHead->pPrevAvailable = this;
+        pHead = this;
+    }
+
+    void UnlinkAvailable(AlignedPageHeader*& pHead)
+    {
+        if (pPrevAvailable != nullptr)
+            pPrevAvailable->pNextAvailable = pNextAvailable;
+        else
+        {
+            VERIFY_EXPR(pHead == this);
+            pHead = pNextAvailable;
+        }
+        if (pNextAvailable != nullptr)
+            pNextAvailable->pPrevAvailable = pPrevAvailable;
+        pPrevAvailable = nullptr;
+        pNextAvailable = nullptr;
+    }
+
+    void* pNextFreeBlock = nullptr; // Head of the list of returned blocks
+
+    Uint32 NumAllocatedBlocks   = 0; // Number of blocks given out to magazines
+    Uint32 NumInitializedBlocks = 0; // Number of blocks that have ever been given out
+
+    // List of pages that have free blocks
+    AlignedPageHeader* pPrevAvailable = nullptr;
+    AlignedPageHeader* pNextAvailable = nullptr;
+
+    // List of all pages in use, or the list of unused pages
+    AlignedPageHeader* pPrevPage = nullptr;
+    AlignedPageHeader* pNextPage = nullptr;
+
+    // The first page of the chunk the page was carved from. Only the first page
+    // keeps the chunk data below.
+    AlignedPageHeader* pChunk = nullptr;
+
+    void*              pChunkRawMemory    = nullptr; // Raw allocation that contains the chunk
+    Uint32             NumChunkPagesInUse = 0;
+    AlignedPageHeader* pPrevChunk         = nullptr;
+    AlignedPageHeader* pNextChunk         = nullptr;
+
+#ifdef DILIGENT_DEBUG
+    const FixedBlockMemoryAllocator* pOwner = nullptr;
+#endif
+};
+
+FixedBlockMemoryAllocator::FixedBlockMemoryAllocator(IMemoryAllocator&       RawMemoryAllocator,
+                                                     size_t                  BlockSize,
+                                                     Uint32                  NumBlocksInPage,
+                                                     FixedBlockAllocatorMode Mode) :
     // clang-format off
     m_PagePool          (STD_ALLOCATOR_RAW_MEM(MemoryPage, RawMemoryAllocator, "Allocator for vector<MemoryPage>")),
     m_AvailablePages    (STD_ALLOCATOR_RAW_MEM(size_t, RawMemoryAllocator, "Allocator for unordered_set<size_t>") ),
     m_AddrToPageId      (STD_ALLOCATOR_RAW_MEM(AddrToPageIdMapElem, RawMemoryAllocator, "Allocator for unordered_map<void*, size_t>")),
     m_RawMemoryAllocator{RawMemoryAllocator        },
     m_BlockSize         {AdjustBlockSize(BlockSize)},
-    m_NumBlocksInPage   {NumBlocksInPage           }
+    m_NumBlocksInPage   {NumBlocksInPage           },
+    m_Mode              {Mode                      }
 // clang-format on
 {
-    // Allocate one page
-    CreateNewPage();
+    VERIFY(m_NumBlocksInPage > 0, "The number of blocks in page must not be zero");
+
+    if (m_Mode == FixedBlockAllocatorMode::ThreadCaching)
+    {
+        static constexpr Uint32 MaxMagazineSize = 64;
+
+        m_FirstBlockOffset = AlignUp(sizeof(AlignedPageHeader), alignof(std::max_align_t));
+
+        // Chunks are over-allocated by one page, which wastes at most 1/MaxPagesInChunk of the memory
+        static constexpr Uint32 MaxPagesInChunk = 8;
+        // Large pages are not combined into chunks to avoid holding too much memory
+        static constexpr size_t MaxChunkSize = size_t{1} << 20;
+
+        const auto MinPageSize = m_FirstBlockOffset + m_BlockSize * m_NumBlocksInPage;
+        m_AlignedPageSize      = 1;
+        while (m_AlignedPageSize < MinPageSize)
+            m_AlignedPageSize <<= 1;
+
+        // Use the space left after rounding the page size up to a power of two
+        m_NumBlocksInAlignedPage = static_cast<Uint32>((m_AlignedPageSize - m_FirstBlockOffset) / m_BlockSize);
+        VERIFY_EXPR(m_NumBlocksInAlignedPage >= m_NumBlocksInPage);
+
+        m_NumPagesInChunk = static_cast<Uint32>(std::max(std::min(MaxChunkSize / m_AlignedPageSize, size_t{MaxPagesInChunk}), size_t{1}));
+
+        m_MagazineSize = std::min(m_NumBlocksInAlignedPage, MaxMagazineSize);
+
+        {
+            std::lock_guard<std::mutex> Lock{FixedBlockAllocatorThreadCache::GetMutex()};
+            m_ThreadCacheSlot = FixedBlockAllocatorThreadCache::AllocateSlot();
+        }
+
+        CreateAlignedPage();
+    }
+    else
+    {
+        // Allocate one page
+        CreateNewPage();
+    }
 }
 
 FixedBlockMemoryAllocator::~FixedBlockMemoryAllocator()
 {
-#ifdef DILIGENT_DEBUG
-    for (size_t p = 0; p < m_PagePool.size(); ++p)
+    if (m_Mode == FixedBlockAllocatorMode::ThreadCaching)
     {
-        VERIFY(!m_PagePool[p].HasAllocations(), "Memory leak detected: memory page has allocated block");
-        VERIFY(m_AvailablePages.find(p) != m_AvailablePages.end(), "Memory page is not in the available page pool");
+        {
+            std::lock_guard<std::mutex> Lock{FixedBlockAllocatorThreadCache::GetMutex()};
+
+#ifdef DILIGENT_DEBUG
+            size_t NumCachedBlocks = 0;
+            for (const auto* pMagazine : m_Magazines)
+                NumCachedBlocks += pMagazine->NumBlocks;
+
+            size_t NumAllocatedBlocks = 0;
+            for (const auto* pPage = m_pAllPages; pPage != nullptr; pPage = pPage->pNextPage)
+                NumAllocatedBlocks += pPage->NumAllocatedBlocks;
+
+            VERIFY(NumAllocatedBlocks == NumCachedBlocks, "Memory leak detected: ", NumAllocatedBlocks - NumCachedBlocks, " block(s) have not been released");
+#endif
+
+            // Blocks cached by other threads are located in the pages that are released below.
+            // The magazines will be deleted by their threads.
+            for (auto* pMagazine : m_Magazines)
+                pMagazine->pOwner.store(nullptr);
+            m_Magazines.clear();
+
+            FixedBlockAllocatorThreadCache::ReleaseSlot(m_ThreadCacheSlot);
+        }
+
+        while (m_pChunks != nullptr)
+        {
+            auto* pChunk = m_pChunks;
+            m_pChunks    = pChunk->pNextChunk;
+            m_RawMemoryAllocator.Free(pChunk->pChunkRawMemory);
+        }
     }
+    else
+    {
+#ifdef DILIGENT_DEBUG
+        for (size_t p = 0; p < m_PagePool.size(); ++p)
+        {
+            VERIFY(!m_PagePool[p].HasAllocations(), "Memory leak detected: memory page has allocated block");
+            VERIFY(m_AvailablePages.find(p) != m_AvailablePages.end(), "Memory page is not in the available page pool");
+        }
 #endif
+    }
 }
 
 void FixedBlockMemoryAllocator::CreateNewPage()
@@ -79,6 +243,9 @@ void* FixedBlockMemoryAllocator::Allocate(size_t Size, const Char* dbgDescriptio
     Size = AdjustBlockSize(Size);
     VERIFY(m_BlockSize == Size, "Requested size (", Size, ") does not match the block size (", m_BlockSize, ")");
 
+    if (m_Mode == FixedBlockAllocatorMode::ThreadCaching)
+        return AllocateCached();
+
     std::lock_guard<std::mutex> LockGuard(m_Mutex);
 
     if (m_AvailablePages.empty())
@@ -100,6 +267,12 @@ void* FixedBlockMemoryAllocator::Allocate(size_t Size, const Char* dbgDescriptio
 
 void FixedBlockMemoryAllocator::Free(void* Ptr)
 {
+    if (m_Mode == FixedBlockAllocatorMode::ThreadCaching)
+    {
+        FreeCached(Ptr);
+        return;
+    }
+
     std::lock_guard<std::mutex> LockGuard(m_Mutex);
     auto                        PageIdIt = m_AddrToPageId.find(Ptr);
     if (PageIdIt != m_AddrToPageId.end())
@@ -124,4 +297,273 @@ void FixedBlockMemoryAllocator::Free(void* Ptr)
     }
 }
 
+void FixedBlockMemoryAllocator::CreateAlignedPageChunk()
+{
+    VERIFY_EXPR(m_pUnusedPages == nullptr);
+
+    // The raw allocator does not support alignment, so allocate one extra page to
+    // be able to align the pages anywhere in the returned memory.
+    const auto ChunkSize = m_AlignedPageSize * (size_t{m_NumPagesInChunk} + 1) - 1;
+    auto*      pRawMem   = m_RawMemoryAllocator.Allocate(ChunkSize, "FixedBlockMemoryAllocator aligned page chunk", __FILE__, __LINE__);
+
+    auto* pFirstPage = reinterpret_cast<Uint8*>(AlignUp(pRawMem, m_AlignedPageSize));
+    auto* pChunk     = new (pFirstPage) AlignedPageHeader{};
+
+    pChunk->pChunkRawMemory = pRawMem;
+    pChunk->pNextChunk      = m_pChunks;
+    if (m_pChunks != nullptr)
+        m_pChunks->pPrevChunk = pChunk;
+    m_pChunks = pChunk;
+
+    // Add the pages to the unused list in reverse order so that they are used in the address order
+    for (Uint32 i = m_NumPagesInChunk; i > 0; --i)
+    {
+        auto* pPage = i > 1 ? new (pFirstPage + m_AlignedPageSize * (i - 1)) AlignedPageHeader{} : pChunk;
+
+        pPage->pChunk    = pChunk;
+        pPage->pNextPage = m_pUnusedPages;
+        if (m_pUnusedPages != nullptr)
+            m_pUnusedPages->pPrevPage = pPage;
+        m_pUnusedPages = pPage;
+    }
+}
+
+FixedBlockMemoryAllocator::AlignedPageHeader* FixedBlockMemoryAllocator::CreateAlignedPage()
+{
+    if (m_pUnusedPages == nullptr)
+        CreateAlignedPageChunk();
+
+    auto* pPage    = m_pUnusedPages;
+    m_pUnusedPages = pPage->pNextPage;
+    if (m_pUnusedPages != nullptr)
+        m_pUnusedPages->pPrevPage = nullptr;
+
+    VERIFY_EXPR(pPage->NumAllocatedBlocks == 0 && pPage->pPrevAvailable == nullptr && pPage->pNextAvailable == nullptr);
+    pPage->pNextFreeBlock       = nullptr;
+    pPage->NumInitializedBlocks = 0;
+    pPage->pPrevPage            = nullptr;
+    pPage->pNextPage            = nullptr;
+    ++pPage->pChunk->NumChunkPagesInUse;
+#ifdef DILIGENT_DEBUG
+    pPage->pOwner = this;
+#endif
+    FillWithDebugPattern(reinterpret_cast<Uint8*>(pPage) + m_FirstBlockOffset, MemoryPage::NewPageMemPattern, m_BlockSize * m_NumBlocksInAlignedPage);
+
+    pPage->pNextPage = m_pAllPages;
+    if (m_pAllPages != nullptr)
+        m_pAllPages->pPrevPage = pPage;
+    m_pAllPages = pPage;
+
+    pPage->LinkAvailable(m_pAvailablePages);
+    ++m_NumAvailablePages;
+
+    return pPage;
+}
+
+void FixedBlockMemoryAllocator::ReleaseAlignedPage(AlignedPageHeader* pPage)
+{
+    VERIFY_EXPR(pPage->NumAllocatedBlocks == 0);
+
+    pPage->UnlinkAvailable(m_pAvailablePages);
+    --m_NumAvailablePages;
+
+    if (pPage->pPrevPage != nullptr)
+        pPage->pPrevPage->pNextPage = pPage->pNextPage;
+    else
+        m_pAllPages = pPage->pNextPage;
+    if (pPage->pNextPage != nullptr)
+        pPage->pNextPage->pPrevPage = pPage->pPrevPage;
+
+    pPage->pPrevPage = nullptr;
+    pPage->pNextPage = m_pUnusedPages;
+    if (m_pUnusedPages != nullptr)
+        m_pUnusedPages->pPrevPage = pPage;
+    m_pUnusedPages = pPage;
+
+    auto* pChunk = pPage->pChunk;
+    VERIFY_EXPR(pChunk->NumChunkPagesInUse > 0);
+    if (--pChunk->NumChunkPagesInUse > 0)
+        return;
+
+    // All pages of the chunk are unused: remove them from the unused list and release the chunk
+    for (Uint32 i = 0; i < m_NumPagesInChunk; ++i)
+    {
+        auto* pUnusedPage = reinterpret_cast<AlignedPageHeader*>(reinterpret_cast<Uint8*>(pChunk) + m_AlignedPageSize * i);
+        if (pUnusedPage->pPrevPage != nullptr)
+            pUnusedPage->pPrevPage->pNextPage = pUnusedPage->pNextPage;
+        else
+        {
+            VERIFY_EXPR(m_pUnusedPages == pUnusedPage);
+            m_pUnusedPages = pUnusedPage->pNextPage;
+        }
+        if (pUnusedPage->pNextPage != nullptr)
+            pUnusedPage->pNextPage->pPrevPage = pUnusedPage->pPrevPage;
+    }
+
+    if (pChunk->pPrevChunk != nullptr)
+        pChunk->pPrevChunk->pNextChunk = pChunk->pNextChunk;
+    else
+    {
+        VERIFY_EXPR(m_pChunks == pChunk);
+        m_pChunks = pChunk->pNextChunk;
+    }
+    if (pChunk->pNextChunk != nullptr)
+        pChunk->pNextChunk->pPrevChunk = pChunk->pPrevChunk;
+
+    m_RawMemoryAllocator.Free(pChunk->pChunkRawMemory);
+}
+
+FixedBlockMemoryAllocator::AlignedPageHeader* FixedBlockMemoryAllocator::GetAlignedPage(const void* Ptr) const
+{
+    auto* pPage = reinterpret_cast<AlignedPageHeader*>(AlignDown(reinterpret_cast<uintptr_t>(Ptr), m_AlignedPageSize));
+#ifdef DILIGENT_DEBUG
+    {
+        VERIFY(pPage->pOwner == this, "The block was not allocated by this allocator");
+        const auto Offset = static_cast<size_t>(reinterpret_cast<const Uint8*>(Ptr) - reinterpret_cast<const Uint8*>(pPage));
+        VERIFY(Offset >= m_FirstBlockOffset && (Offset - m_FirstBlockOffset) % m_BlockSize == 0, "Invalid address");
+        VERIFY((Offset - m_FirstBlockOffset) / m_BlockSize < m_NumBlocksInAlignedPage, "Invalid block index");
+    }
+#endif
+    return pPage;
+}
+
+FixedBlockAllocatorMagazine* FixedBlockMemoryAllocator::GetThreadMagazine()
+{
+    if (auto* pMagazine = FixedBlockAllocatorThreadCache::GetThreadObject(m_ThreadCacheSlot, this))
+        return pMagazine;
+
+    // The magazines of an exiting thread have already been flushed and deleted
+    if (FixedBlockAllocatorThreadCache::IsThreadTableDestroyed())
+        return nullptr;
+
+    return &RegisterThreadMagazine();
+}
+
+FixedBlockAllocatorMagazine& FixedBlockMemoryAllocator::RegisterThreadMagazine()
+{
+    std::lock_guard<std::mutex> Lock{FixedBlockAllocatorThreadCache::GetMutex()};
+
+    // Blocks of the magazine left in the slot by a destroyed allocator have already been released with its pages
+    auto* pMagazine = FixedBlockAllocatorThreadCache::CreateThreadObject(m_ThreadCacheSlot, this);
+    m_Magazines.push_back(pMagazine);
+
+    return *pMagazine;
+}
+
+void FixedBlockMemoryAllocator::OnThreadExit(FixedBlockAllocatorMagazine& Magazine)
+{
+    FlushMagazine(Magazine, 0);
+    m_Magazines.erase(std::find(m_Magazines.begin(), m_Magazines.end(), &Magazine));
+}
+
+void FixedBlockMemoryAllocator::RefillMagazine(FixedBlockAllocatorMagazine& Magazine, Uint32 NumBlocksToFetch)
+{
+    std::lock_guard<std::mutex> LockGuard(m_Mutex);
+    while (Magazine.NumBlocks < NumBlocksToFetch)
+    {
+        auto* pPage = m_pAvailablePages != nullptr ? m_pAvailablePages : CreateAlignedPage();
+        VERIFY_EXPR(pPage->NumAllocatedBlocks < m_NumBlocksInAlignedPage);
+
+        void* pBlock = pPage->pNextFreeBlock;
+        if (pBlock != nullptr)
+        {
+            pPage->pNextFreeBlock = *reinterpret_cast<void**>(pBlock);
+        }
+        else
+        {
+            // All returned blocks are used, take the next block that has never been given out
+            VERIFY_EXPR(pPage->NumInitializedBlocks < m_NumBlocksInAlignedPage);
+            pBlock = reinterpret_cast<Uint8*>(pPage) + m_FirstBlockOffset + m_BlockSize * pPage->NumInitializedBlocks;
+            ++pPage->NumInitializedBlocks;
+        }
+
+        ++pPage->NumAllocatedBlocks;
+        if (pPage->NumAllocatedBlocks == m_NumBlocksInAlignedPage)
+        {
+            pPage->UnlinkAvailable(m_pAvailablePages);
+            --m_NumAvailablePages;
+        }
+
+        Magazine.Push(pBlock);
+    }
+}
+
+void FixedBlockMemoryAllocator::FlushMagazine(FixedBlockAllocatorMagazine& Magazine, Uint32 NumBlocksToKeep)
+{
+    std::lock_guard<std::mutex> LockGuard(m_Mutex);
+    while (Magazine.NumBlocks > NumBlocksToKeep)
+    {
+        void* pBlock = Magazine.Pop();
+        auto* pPage  = GetAlignedPage(pBlock);
+        VERIFY_EXPR(pPage->NumAllocatedBlocks > 0);
+
+        *reinterpret_cast<void**>(pBlock) = pPage->pNextFreeBlock;
+        pPage->pNextFreeBlock             = pBlock;
+
+        if (pPage->NumAllocatedBlocks == m_NumBlocksInAlignedPage)
+        {
+            pPage->LinkAvailable(m_pAvailablePages);
+            ++m_NumAvailablePages;
+        }
+        --pPage->NumAllocatedBlocks;
+
+        // Keep one free page to avoid creating a new page on the next refill
+        if (pPage->NumAllocatedBlocks == 0 && m_NumAvailablePages > 1)
+            ReleaseAlignedPage(pPage);
+    }
+}
+
+void* FixedBlockMemoryAllocator::AllocateCached()
+{
+    void* Ptr = nullptr;
+    if (auto* pMagazine = GetThreadMagazine())
+    {
+        if (pMagazine->NumBlocks == 0)
+            RefillMagazine(*pMagazine, std::max(m_MagazineSize / 2, Uint32{1}));
+        Ptr = pMagazine->Pop();
+    }
+    else
+    {
+        // The thread has no magazine: take a single block under the lock
+        FixedBlockAllocatorMagazine Magazine{this};
+        RefillMagazine(Magazine, 1);
+        Ptr = Magazine.Pop();
+    }
+
+    FillWithDebugPattern(Ptr, MemoryPage::AllocatedBlockMemPattern, m_BlockSize);
+    return Ptr;
+}
+
+void FixedBlockMemoryAllocator::Prefetch(Uint32 NumBlocks)
+{
+    if (m_Mode != FixedBlockAllocatorMode::ThreadCaching)
+        return;
+
+    auto* pMagazine = GetThreadMagazine();
+    if (pMagazine != nullptr && pMagazine->NumBlocks < NumBlocks)
+        RefillMagazine(*pMagazine, NumBlocks);
+}
+
+void FixedBlockMemoryAllocator::FreeCached(void* Ptr)
+{
+#ifdef DILIGENT_DEBUG
+    GetAlignedPage(Ptr);
+#endif
+    FillWithDebugPattern(Ptr, MemoryPage::DeallocatedBlockMemPattern, m_BlockSize);
+
+    if (auto* pMagazine = GetThreadMagazine())
+    {
+        pMagazine->Push(Ptr);
+        if (pMagazine->NumBlocks > m_MagazineSize)
+            FlushMagazine(*pMagazine, m_MagazineSize / 2);
+    }
+    else
+    {
+        // The thread has no magazine: return the block under the lock
+        FixedBlockAllocatorMagazine Magazine{this};
+        Magazine.Push(Ptr);
+        FlushMagazine(Magazine, 0);
+    }
+}
+
 } // namespace Diligent
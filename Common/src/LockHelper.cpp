@@ -25,15 +25,252 @@
  *  of the possibility of such damages.
  */
 
-#include <thread>
 #include "LockHelper.hpp"
 
+#include <thread>
+#include <chrono>
+#include <mutex>
+#include <memory>
+#include <unordered_map>
+#include <algorithm>
+
+#if PLATFORM_LINUX || PLATFORM_ANDROID
+#    include <linux/futex.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#elif PLATFORM_WIN32 || PLATFORM_UNIVERSAL_WINDOWS
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    ifndef WIN32_LEAN_AND_MEAN
+#        define WIN32_LEAN_AND_MEAN
+#    endif
+#    include <Windows.h>
+// WaitOnAddress is available starting with Windows 8
+#    if defined(_WIN32_WINNT) && _WIN32_WINNT >= 0x0602
+#        define DILIGENT_WAIT_ON_ADDRESS 1
+#    endif
+#endif
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#    include <immintrin.h>
+#endif
+
 namespace ThreadingTools
 {
 
-void LockHelper::YieldThread() noexcept
+using namespace Diligent;
+
+namespace
+{
+
+// Maximum number of pause instructions executed between two attempts to acquire the lock
+constexpr Uint32 MaxBackoffPauses = 64;
+
+inline void CpuPause() noexcept
+{
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+    _mm_pause();
+#elif (defined(__arm__) || defined(__aarch64__)) && (defined(__GNUC__) || defined(__clang__))
+    __asm__ __volatile__("yield");
+#endif
+}
+
+// Puts the thread to sleep while the flag value is equal to Value
+void WaitOnFlag(std::atomic<Int32>& Flag, Int32 Value) noexcept
 {
+#if PLATFORM_LINUX || PLATFORM_ANDROID
+    syscall(SYS_futex, reinterpret_cast<Int32*>(&Flag), FUTEX_WAIT_PRIVATE, Value, nullptr, nullptr, 0);
+#elif DILIGENT_WAIT_ON_ADDRESS
+    WaitOnAddress(&Flag, &Value, sizeof(Value), INFINITE);
+#else
+    // There is no portable way to wait on an address before C++20
+    (void)Flag;
+    (void)Value;
     std::this_thread::yield();
+#endif
+}
+
+void WakeOneOnFlag(std::atomic<Int32>& Flag) noexcept
+{
+#if PLATFORM_LINUX || PLATFORM_ANDROID
+    syscall(SYS_futex, reinterpret_cast<Int32*>(&Flag), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#elif DILIGENT_WAIT_ON_ADDRESS
+    WakeByAddressSingle(&Flag);
+#else
+    (void)Flag;
+#endif
+}
+
+Uint64 GetTimeNs() noexcept
+{
+    return static_cast<Uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+class LockStatisticsRegistry
+{
+public:
+    static LockStatisticsRegistry& Get()
+    {
+        static LockStatisticsRegistry Registry;
+        return Registry;
+    }
+
+    LockStatistics* GetStatistics(const Char* Name)
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+
+        auto& pStats = m_Stats[Name];
+        if (!pStats)
+            pStats.reset(new LockStatistics{});
+        return pStats.get();
+    }
+
+    std::vector<LockStatisticsSnapshot> GetSnapshots()
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+
+        std::vector<LockStatisticsSnapshot> Snapshots;
+        Snapshots.reserve(m_Stats.size());
+        for (const auto& it : m_Stats)
+        {
+            Snapshots.emplace_back();
+            auto& Snapshot           = Snapshots.back();
+            Snapshot.Name            = it.first;
+            Snapshot.NumAcquisitions = it.second->NumAcquisitions.load();
+            Snapshot.NumContentions  = it.second->NumContentions.load();
+            Snapshot.NumSpins        = it.second->NumSpins.load();
+            Snapshot.NumParks        = it.second->NumParks.load();
+            Snapshot.TotalHoldTimeNs = it.second->TotalHoldTimeNs.load();
+        }
+        std::sort(Snapshots.begin(), Snapshots.end(),
+                  [](const LockStatisticsSnapshot& lhs, const LockStatisticsSnapshot& rhs) {
+                      return lhs.Name < rhs.Name;
+                  });
+        return Snapshots;
+    }
+
+    void Reset()
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        for (auto& it : m_Stats)
+        {
+            it.second->NumAcquisitions.store(0);
+            it.second->NumContentions.store(0);
+            it.second->NumSpins.store(0);
+            it.second->NumParks.store(0);
+            it.second->TotalHoldTimeNs.store(0);
+        }
+    }
+
+    std::atomic<bool> Enabled{false};
+
+private:
+    std::mutex m_Mtx;
+    // Statistics objects are never deleted since locks keep pointers to them
+    std::unordered_map<std::string, std::unique_ptr<LockStatistics>> m_Stats;
+};
+
+} // namespace
+
+LockFlag::LockFlag(const Char* Name) :
+    m_Flag{LOCK_FLAG_UNLOCKED}
+{
+    VERIFY_EXPR(Name != nullptr);
+    m_pStats = LockStatisticsRegistry::Get().GetStatistics(Name);
+}
+
+void EnableLockStatistics(bool Enable) noexcept
+{
+    LockStatisticsRegistry::Get().Enabled.store(Enable);
+}
+
+std::vector<LockStatisticsSnapshot> GetLockStatistics()
+{
+    return LockStatisticsRegistry::Get().GetSnapshots();
+}
+
+void ResetLockStatistics() noexcept
+{
+    LockStatisticsRegistry::Get().Reset();
+}
+
+void DumpLockStatistics()
+{
+    const auto Snapshots = GetLockStatistics();
+    for (const auto& Stats : Snapshots)
+    {
+        LOG_INFO_MESSAGE("Lock '", Stats.Name, "': ", Stats.NumAcquisitions, " acquisitions, ", Stats.NumContentions, " contended, ",
+                         Stats.NumSpins, " spins, ", Stats.NumParks, " parks, ", Stats.TotalHoldTimeNs / 1000, " us held");
+    }
+}
+
+void LockHelper::LockContended(LockFlag& LockFlag, int SpinCountToYield) noexcept
+{
+    auto& Flag = LockFlag.m_Flag;
+
+    // Spin with exponential backoff. Only attempt to take the lock when it looks free to
+    // avoid bouncing the cache line between cores.
+    Uint32 NumSpins = 0;
+    for (Uint32 Backoff = 1; NumSpins < static_cast<Uint32>(SpinCountToYield); Backoff = std::min(Backoff * 2, MaxBackoffPauses))
+    {
+        for (Uint32 i = 0; i < Backoff; ++i)
+            CpuPause();
+        NumSpins += Backoff;
+
+        Int32 Expected = LockFlag::LOCK_FLAG_UNLOCKED;
+        if (Flag.load(std::memory_order_relaxed) == LockFlag::LOCK_FLAG_UNLOCKED &&
+            Flag.compare_exchange_weak(Expected, LockFlag::LOCK_FLAG_LOCKED, std::memory_order_acquire, std::memory_order_relaxed))
+        {
+            if (LockFlag.m_pStats != nullptr)
+                OnLockAcquired(LockFlag, true, NumSpins, 0);
+            return;
+        }
+    }
+
+    // Mark the lock as having waiters and go to sleep. The thread that acquires the lock
+    // this way keeps the waiters flag, so that unlocking wakes up the next waiter.
+    Uint32 NumParks = 0;
+    while (Flag.exchange(LockFlag::LOCK_FLAG_LOCKED_WITH_WAITERS, std::memory_order_acquire) != LockFlag::LOCK_FLAG_UNLOCKED)
+    {
+        WaitOnFlag(Flag, LockFlag::LOCK_FLAG_LOCKED_WITH_WAITERS);
+        ++NumParks;
+    }
+
+    if (LockFlag.m_pStats != nullptr)
+        OnLockAcquired(LockFlag, true, NumSpins, NumParks);
+}
+
+void LockHelper::WakeWaiter(LockFlag& LockFlag) noexcept
+{
+    WakeOneOnFlag(LockFlag.m_Flag);
+}
+
+void LockHelper::OnLockAcquired(LockFlag& LockFlag, bool Contended, Uint32 NumSpins, Uint32 NumParks) noexcept
+{
+    // The lock is held, so the flag members can be safely modified
+    LockFlag.m_StatsEnabled = LockStatisticsRegistry::Get().Enabled.load(std::memory_order_relaxed);
+    if (!LockFlag.m_StatsEnabled)
+        return;
+
+    auto& Stats = *LockFlag.m_pStats;
+    Stats.NumAcquisitions.fetch_add(1, std::memory_order_relaxed);
+    if (Contended)
+    {
+        Stats.NumContentions.fetch_add(1, std::memory_order_relaxed);
+        Stats.NumSpins.fetch_add(NumSpins, std::memory_order_relaxed);
+        Stats.NumParks.fetch_add(NumParks, std::memory_order_relaxed);
+    }
+    LockFlag.m_LockTimeNs = GetTimeNs();
+}
+
+void LockHelper::OnLockReleased(LockFlag& LockFlag) noexcept
+{
+    if (!LockFlag.m_StatsEnabled)
+        return;
+
+    LockFlag.m_pStats->TotalHoldTimeNs.fetch_add(GetTimeNs() - LockFlag.m_LockTimeNs, std::memory_order_relaxed);
+    LockFlag.m_StatsEnabled = false;
 }
 
 } // namespace ThreadingTools
@@ -0,0 +1,274 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "pch.h"
+
+#include "MappedFileStream.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "DataBlobImpl.hpp"
+#include "ReadOnlyMemoryFileStream.hpp"
+
+#if PLATFORM_WIN32
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    ifndef WIN32_LEAN_AND_MEAN
+#        define WIN32_LEAN_AND_MEAN
+#    endif
+#    include <Windows.h>
+#elif PLATFORM_LINUX || PLATFORM_ANDROID || PLATFORM_MACOS || PLATFORM_IOS || PLATFORM_TVOS
+#    define DILIGENT_POSIX_FILE_MAPPING 1
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+namespace Diligent
+{
+
+namespace
+{
+
+/// Data blob that references a range of the mapped file.
+class MappedFileDataBlob final : public ObjectBase<IDataBlob>
+{
+public:
+    typedef ObjectBase<IDataBlob> TBase;
+
+    MappedFileDataBlob(IReferenceCounters* pRefCounters,
+                       MappedFileStream*   pStream,
+                       size_t              Offset,
+                       size_t              Size) :
+        TBase{pRefCounters},
+        m_pStream{pStream},
+        m_pData{static_cast<Uint8*>(const_cast<void*>(pStream->GetMappedData())) + Offset},
+        m_Size{Size}
+    {
+    }
+
+    IMPLEMENT_QUERY_INTERFACE_IN_PLACE(IID_DataBlob, TBase)
+
+    virtual void DILIGENT_CALL_TYPE Resize(size_t NewSize) override
+    {
+        if (m_pStream && NewSize <= m_Size)
+        {
+            m_Size = NewSize;
+            return;
+        }
+
+        // The blob can't grow in place, so copy the data to a buffer and release the mapping
+        if (m_pStream)
+        {
+            m_Buffer.assign(m_pData, m_pData + m_Size);
+            m_pStream.Release();
+        }
+        m_Buffer.resize(NewSize);
+        m_pData = m_Buffer.data();
+        m_Size  = NewSize;
+    }
+
+    virtual size_t DILIGENT_CALL_TYPE GetSize() const override
+    {
+        return m_Size;
+    }
+
+    virtual void* DILIGENT_CALL_TYPE GetDataPtr() override
+    {
+        return m_pData;
+    }
+
+    virtual const void* DILIGENT_CALL_TYPE GetConstDataPtr() const override
+    {
+        return m_pData;
+    }
+
+private:
+    RefCntAutoPtr<MappedFileStream> m_pStream;
+
+    Uint8* m_pData = nullptr;
+    size_t m_Size  = 0;
+
+    std::vector<Uint8> m_Buffer;
+};
+
+} // namespace
+
+MappedFileStream::MappedFileStream(IReferenceCounters* pRefCounters,
+                                   const Char*         Path) :
+    TBase{pRefCounters}
+{
+#if PLATFORM_WIN32
+    HANDLE hFile = CreateFileA(Path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+        return;
+    m_hFile = hFile;
+
+    LARGE_INTEGER FileSize = {};
+    if (!GetFileSizeEx(hFile, &FileSize))
+        return;
+    m_Size = static_cast<size_t>(FileSize.QuadPart);
+    if (m_Size == 0)
+    {
+        // Empty files can't be mapped
+        m_IsValid = true;
+        return;
+    }
+
+    m_hMapping = CreateFileMappingA(hFile, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    if (m_hMapping == nullptr)
+        return;
+
+    m_pData = MapViewOfFile(m_hMapping, FILE_MAP_COPY, 0, 0, 0);
+    if (m_pData == nullptr)
+        return;
+    m_IsValid = true;
+#elif DILIGENT_POSIX_FILE_MAPPING
+    const int fd = open(Path, O_RDONLY);
+    if (fd < 0)
+        return;
+
+    struct stat FileStat;
+    if (fstat(fd, &FileStat) == 0 && S_ISREG(FileStat.st_mode))
+    {
+        m_Size = static_cast<size_t>(FileStat.st_size);
+        if (m_Size == 0)
+        {
+            // Empty files can't be mapped
+            m_IsValid = true;
+        }
+        else
+        {
+            // The mapping remains valid after the file is closed
+            void* pData = mmap(nullptr, m_Size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            if (pData != MAP_FAILED)
+            {
+                m_pData   = pData;
+                m_IsValid = true;
+            }
+        }
+    }
+    close(fd);
+#else
+    (void)Path;
+#endif
+}
+
+MappedFileStream::~MappedFileStream()
+{
+#if PLATFORM_WIN32
+    if (m_pData != nullptr)
+        UnmapViewOfFile(m_pData);
+    if (m_hMapping != nullptr)
+        CloseHandle(m_hMapping);
+    if (m_hFile != nullptr)
+        CloseHandle(m_hFile);
+#elif DILIGENT_POSIX_FILE_MAPPING
+    if (m_pData != nullptr)
+        munmap(m_pData, m_Size);
+#endif
+}
+
+IMPLEMENT_QUERY_INTERFACE(MappedFileStream, IID_MappedFileStream, TBase)
+
+bool MappedFileStream::Read(void* Data, size_t Size)
+{
+    VERIFY_EXPR(m_CurrentOffset <= m_Size);
+    auto BytesToRead = std::min(m_Size - m_CurrentOffset, Size);
+    if (BytesToRead != 0)
+        memcpy(Data, static_cast<const Uint8*>(m_pData) + m_CurrentOffset, BytesToRead);
+    m_CurrentOffset += BytesToRead;
+    return Size == BytesToRead;
+}
+
+void MappedFileStream::ReadBlob(IDataBlob* pData)
+{
+    pData->Resize(m_Size - m_CurrentOffset);
+    auto res = Read(pData->GetDataPtr(), pData->GetSize());
+    VERIFY_EXPR(res);
+    (void)res;
+}
+
+bool MappedFileStream::Write(const void* /*Data*/, size_t /*Size*/)
+{
+    // Mapped file streams are read-only
+    return false;
+}
+
+size_t MappedFileStream::GetSize()
+{
+    return m_Size;
+}
+
+bool MappedFileStream::IsValid()
+{
+    return m_IsValid;
+}
+
+void MappedFileStream::GetDataBlob(IDataBlob** ppBlob)
+{
+    VERIFY_EXPR(ppBlob != nullptr && *ppBlob == nullptr);
+    VERIFY_EXPR(m_CurrentOffset <= m_Size);
+
+    IDataBlob* pBlob = nullptr;
+    if (m_pData != nullptr)
+        pBlob = MakeNewRCObj<MappedFileDataBlob>()(this, m_CurrentOffset, m_Size - m_CurrentOffset);
+    else
+        pBlob = MakeNewRCObj<DataBlobImpl>()(0);
+    pBlob->QueryInterface(IID_DataBlob, reinterpret_cast<IObject**>(ppBlob));
+    m_CurrentOffset = m_Size;
+}
+
+RefCntAutoPtr<IDataBlob> ReadFileStreamData(IFileStream* pStream)
+{
+    VERIFY_EXPR(pStream != nullptr);
+
+    RefCntAutoPtr<IDataBlob> pData;
+
+    RefCntAutoPtr<MappedFileStream>         pMappedStream{pStream, IID_MappedFileStream};
+    RefCntAutoPtr<ReadOnlyMemoryFileStream> pMemoryStream{pStream, IID_ReadOnlyMemoryFileStream};
+    if (pMappedStream)
+    {
+        pMappedStream->GetDataBlob(&pData);
+    }
+    else if (pMemoryStream)
+    {
+        pMemoryStream->GetDataBlob(&pData);
+    }
+    else
+    {
+        pData = MakeNewRCObj<DataBlobImpl>()(0);
+        pStream->ReadBlob(pData);
+    }
+    return pData;
+}
+
+} // namespace Diligent
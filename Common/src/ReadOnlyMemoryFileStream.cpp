@@ -0,0 +1,104 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "pch.h"
+
+#include "ReadOnlyMemoryFileStream.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "DataBlobImpl.hpp"
+
+namespace Diligent
+{
+
+ReadOnlyMemoryFileStream::ReadOnlyMemoryFileStream(IReferenceCounters* pRefCounters,
+                                                   IDataBlob*          pData) :
+    TBase{pRefCounters},
+    m_DataBlob{pData}
+{
+}
+
+IMPLEMENT_QUERY_INTERFACE(ReadOnlyMemoryFileStream, IID_ReadOnlyMemoryFileStream, TBase)
+
+bool ReadOnlyMemoryFileStream::Read(void* Data, size_t Size)
+{
+    VERIFY_EXPR(m_CurrentOffset <= GetSize());
+    auto  BytesLeft   = GetSize() - m_CurrentOffset;
+    auto  BytesToRead = std::min(BytesLeft, Size);
+    auto* pSrcData    = reinterpret_cast<const Uint8*>(m_DataBlob->GetDataPtr()) + m_CurrentOffset;
+    if (BytesToRead > 0)
+        memcpy(Data, pSrcData, BytesToRead);
+    m_CurrentOffset += BytesToRead;
+    return Size == BytesToRead;
+}
+
+void ReadOnlyMemoryFileStream::ReadBlob(IDataBlob* pData)
+{
+    auto BytesLeft = GetSize() - m_CurrentOffset;
+    pData->Resize(BytesLeft);
+    auto res = Read(pData->GetDataPtr(), pData->GetSize());
+    VERIFY_EXPR(res);
+    (void)res;
+}
+
+bool ReadOnlyMemoryFileStream::Write(const void* /*Data*/, size_t /*Size*/)
+{
+    // The blob may be shared with other streams and must not be modified
+    return false;
+}
+
+size_t ReadOnlyMemoryFileStream::GetSize()
+{
+    return m_DataBlob ? m_DataBlob->GetSize() : 0;
+}
+
+bool ReadOnlyMemoryFileStream::IsValid()
+{
+    return !!m_DataBlob;
+}
+
+void ReadOnlyMemoryFileStream::GetDataBlob(IDataBlob** ppBlob)
+{
+    VERIFY_EXPR(ppBlob != nullptr && *ppBlob == nullptr);
+
+    RefCntAutoPtr<IDataBlob> pBlob;
+    if (m_CurrentOffset == 0 && m_DataBlob)
+    {
+        pBlob = m_DataBlob;
+    }
+    else
+    {
+        pBlob = MakeNewRCObj<DataBlobImpl>()(0);
+        ReadBlob(pBlob);
+    }
+    m_CurrentOffset = GetSize();
+    *ppBlob         = pBlob.Detach();
+}
+
+} // namespace Diligent
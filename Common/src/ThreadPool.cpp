@@ -0,0 +1,181 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+struct ThreadPool::Loop
+{
+    Loop(Uint32 _Count, const std::function<void(Uint32)>& _Func) :
+        Count{_Count},
+        Func{_Func}
+    {}
+
+    const Uint32                       Count;
+    const std::function<void(Uint32)>& Func;
+    std::atomic<Uint32>                NextIndex{0};
+    Uint32                             NumActiveWorkers = 0; // Protected by ThreadPool::m_Mtx
+};
+
+ThreadPool::ThreadPool(const CreateInfo& CI) :
+    m_CI{CI}
+{
+    Uint32 NumThreads = m_CI.NumThreads;
+    if (NumThreads == 0)
+    {
+        const auto NumCores = std::thread::hardware_concurrency();
+        NumThreads          = NumCores > 1 ? NumCores - 1 : 0;
+    }
+
+    m_Threads.reserve(NumThreads);
+    for (Uint32 i = 0; i < NumThreads; ++i)
+        m_Threads.emplace_back(&ThreadPool::WorkerThreadProc, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        VERIFY(m_Loops.empty(), "Destroying the thread pool while parallel loops are still running");
+        m_Stop = true;
+    }
+    m_WorkCV.notify_all();
+
+    for (auto& Thread : m_Threads)
+        Thread.join();
+}
+
+void ThreadPool::RunLoop(Loop& L)
+{
+    for (Uint32 i = L.NextIndex.fetch_add(1); i < L.Count; i = L.NextIndex.fetch_add(1))
+    {
+        try
+        {
+            L.Func(i);
+        }
+        catch (...)
+        {
+            UNEXPECTED("Parallel loop body must not throw exceptions");
+        }
+    }
+}
+
+void ThreadPool::WorkerThreadProc(Uint32 ThreadId)
+{
+    if (m_CI.OnThreadStarted)
+        m_CI.OnThreadStarted(ThreadId);
+
+    std::unique_lock<std::mutex> Lock{m_Mtx};
+    while (true)
+    {
+        m_WorkCV.wait(Lock, [this] { return m_Stop || !m_Loops.empty(); });
+        if (m_Stop)
+            break;
+
+        // The loop can't be destroyed by ParallelFor() while this thread is registered as active
+        auto* pLoop = m_Loops.front();
+        ++pLoop->NumActiveWorkers;
+
+        Lock.unlock();
+        RunLoop(*pLoop);
+        Lock.lock();
+
+        // All iterations have been claimed - remove the loop so that other threads do not pick it up
+        auto it = std::find(m_Loops.begin(), m_Loops.end(), pLoop);
+        if (it != m_Loops.end())
+            m_Loops.erase(it);
+
+        if (--pLoop->NumActiveWorkers == 0)
+            m_DoneCV.notify_all();
+    }
+    Lock.unlock();
+
+    if (m_CI.OnThreadExiting)
+        m_CI.OnThreadExiting(ThreadId);
+}
+
+void ThreadPool::ParallelFor(Uint32 Count, const std::function<void(Uint32)>& Func)
+{
+    if (Count == 0)
+        return;
+
+    Loop L{Count, Func};
+    if (Count == 1 || m_Threads.empty())
+    {
+        // Run the loop on the calling thread the same way the workers do
+        RunLoop(L);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        m_Loops.push_back(&L);
+    }
+    m_WorkCV.notify_all();
+
+    RunLoop(L);
+
+    std::unique_lock<std::mutex> Lock{m_Mtx};
+
+    auto it = std::find(m_Loops.begin(), m_Loops.end(), &L);
+    if (it != m_Loops.end())
+        m_Loops.erase(it);
+
+    // Every iteration has been claimed; wait for the workers to finish the ones they took
+    m_DoneCV.wait(Lock, [&L] { return L.NumActiveWorkers == 0; });
+}
+
+ThreadPool& ThreadPool::GetGlobal()
+{
+    static ThreadPool GlobalPool{CreateInfo{}};
+    return GlobalPool;
+}
+
+void ParallelForRanges(Uint32 NumItems, Uint32 NumThreads, const std::function<void(Uint32 StartItem, Uint32 EndItem)>& Func)
+{
+    if (NumItems == 0)
+        return;
+
+    const Uint32 NumRanges = std::max(std::min(NumThreads, NumItems), 1u);
+    if (NumRanges == 1)
+    {
+        Func(0, NumItems);
+        return;
+    }
+
+    ThreadPool::GetGlobal().ParallelFor(NumRanges, [&](Uint32 Range) {
+        Func(static_cast<Uint32>(Uint64{NumItems} * Range / NumRanges), static_cast<Uint32>(Uint64{NumItems} * (Range + 1) / NumRanges));
+    });
+}
+
+} // namespace Diligent
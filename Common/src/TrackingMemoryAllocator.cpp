@@ -0,0 +1,620 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "pch.h"
+#include "TrackingMemoryAllocator.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+
+#include "PlatformMisc.hpp"
+#include "HashUtils.hpp"
+#include "ThreadSlotRegistry.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+// Header that precedes every allocation. Its size preserves the 16-byte alignment of the raw allocation.
+struct alignas(16) AllocationHeader
+{
+    Uint64 Size;
+    Uint32 TagId;
+};
+static_assert(sizeof(AllocationHeader) == 16, "Unexpected allocation header size");
+
+Uint32 GetSizeClass(size_t Size)
+{
+    if (Size <= 16)
+        return 0;
+
+    // ceil(log2(Size)) - 4
+    const Uint32 SizeClass = PlatformMisc::GetMSB(static_cast<Uint64>(Size - 1)) + 1 - 4;
+    return std::min(SizeClass, TrackingAllocatorTagStats::NumSizeClasses - 1);
+}
+
+// Updates a counter that is written by one thread only
+template <typename T>
+void AddRelaxed(std::atomic<T>& Counter, T Value)
+{
+    Counter.store(Counter.load(std::memory_order_relaxed) + Value, std::memory_order_relaxed);
+}
+
+void UpdateMax(std::atomic<Int64>& Max, Int64 Value)
+{
+    auto CurrMax = Max.load(std::memory_order_relaxed);
+    while (CurrMax < Value && !Max.compare_exchange_weak(CurrMax, Value, std::memory_order_relaxed))
+    {
+    }
+}
+
+void AddStats(TrackingAllocatorTagStats& Dst, const TrackingAllocatorTagStats& Src)
+{
+    Dst.LiveBytes += Src.LiveBytes;
+    Dst.LiveAllocations += Src.LiveAllocations;
+    Dst.TotalAllocations += Src.TotalAllocations;
+    Dst.TotalBytes += Src.TotalBytes;
+    for (Uint32 i = 0; i < TrackingAllocatorTagStats::NumSizeClasses; ++i)
+        Dst.SizeHistogram[i] += Src.SizeHistogram[i];
+}
+
+void SubtractStats(TrackingAllocatorTagStats& Dst, const TrackingAllocatorTagStats& Src)
+{
+    Dst.LiveBytes -= Src.LiveBytes;
+    Dst.LiveAllocations -= Src.LiveAllocations;
+    Dst.TotalAllocations -= Src.TotalAllocations;
+    Dst.TotalBytes -= Src.TotalBytes;
+    for (Uint32 i = 0; i < TrackingAllocatorTagStats::NumSizeClasses; ++i)
+        Dst.SizeHistogram[i] -= Src.SizeHistogram[i];
+}
+
+void SortTags(std::vector<TrackingAllocatorTagStats>& Tags)
+{
+    std::sort(Tags.begin(), Tags.end(),
+              [](const TrackingAllocatorTagStats& Tag0, const TrackingAllocatorTagStats& Tag1) {
+                  if (Tag0.LiveBytes != Tag1.LiveBytes)
+                      return Tag0.LiveBytes > Tag1.LiveBytes;
+                  return Tag0.Description < Tag1.Description;
+              });
+}
+
+void WriteJSONString(std::ostream& Stream, const std::string& Str)
+{
+    Stream << '"';
+    for (auto c : Str)
+    {
+        switch (c)
+        {
+            case '"': Stream << "\\\""; break;
+            case '\\': Stream << "\\\\"; break;
+            case '\n': Stream << "\\n"; break;
+            case '\r': Stream << "\\r"; break;
+            case '\t': Stream << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    static constexpr char HexDigits[] = "0123456789abcdef";
+                    Stream << "\\u00" << HexDigits[(c >> 4) & 0xF] << HexDigits[c & 0xF];
+                }
+                else
+                {
+                    Stream << c;
+                }
+        }
+    }
+    Stream << '"';
+}
+
+void WriteJSONStats(std::ostream& Stream, const TrackingAllocatorTagStats& Stats, const char* Indent)
+{
+    Stream << "{\n";
+    Stream << Indent << "  \"Description\": ";
+    WriteJSONString(Stream, Stats.Description);
+    Stream << ",\n";
+    Stream << Indent << "  \"FirstAllocationSource\": ";
+    WriteJSONString(Stream, Stats.FirstAllocationSource);
+    Stream << ",\n";
+    Stream << Indent << "  \"LiveBytes\": " << Stats.LiveBytes << ",\n";
+    Stream << Indent << "  \"LiveAllocations\": " << Stats.LiveAllocations << ",\n";
+    Stream << Indent << "  \"PeakBytes\": " << Stats.PeakBytes << ",\n";
+    Stream << Indent << "  \"TotalAllocations\": " << Stats.TotalAllocations << ",\n";
+    Stream << Indent << "  \"TotalBytes\": " << Stats.TotalBytes << ",\n";
+    Stream << Indent << "  \"SizeHistogram\": [";
+    for (Uint32 i = 0; i < TrackingAllocatorTagStats::NumSizeClasses; ++i)
+        Stream << (i > 0 ? ", " : "") << Stats.SizeHistogram[i];
+    Stream << "]\n";
+    Stream << Indent << "}";
+}
+
+} // namespace
+
+struct TrackingAllocatorTagInfo
+{
+    std::string Description;
+    std::string FirstAllocationSource;
+
+    // Live bytes published by all threads and their maximum
+    std::atomic<Int64> PublishedLiveBytes{0};
+    std::atomic<Int64> PeakBytes{0};
+
+    void Publish(Int64 Delta)
+    {
+        const auto LiveBytes = PublishedLiveBytes.fetch_add(Delta, std::memory_order_relaxed) + Delta;
+        if (Delta > 0)
+            UpdateMax(PeakBytes, LiveBytes);
+    }
+};
+
+// Counters of one tag written by one thread and read by snapshots
+struct TrackingAllocatorTagCounters
+{
+    TrackingAllocatorTagCounters()
+    {
+        for (auto& Count : SizeHistogram)
+            Count.store(0, std::memory_order_relaxed);
+    }
+
+    void AddTo(TrackingAllocatorTagStats& Stats) const
+    {
+        Stats.LiveBytes += LiveBytes.load(std::memory_order_relaxed);
+        Stats.LiveAllocations += LiveAllocations.load(std::memory_order_relaxed);
+        Stats.TotalAllocations += TotalAllocations.load(std::memory_order_relaxed);
+        Stats.TotalBytes += TotalBytes.load(std::memory_order_relaxed);
+        for (Uint32 i = 0; i < TrackingAllocatorTagStats::NumSizeClasses; ++i)
+            Stats.SizeHistogram[i] += SizeHistogram[i].load(std::memory_order_relaxed);
+    }
+
+    std::atomic<Int64>  LiveBytes{0};
+    std::atomic<Int64>  LiveAllocations{0};
+    std::atomic<Uint64> TotalAllocations{0};
+    std::atomic<Uint64> TotalBytes{0};
+    std::atomic<Uint64> SizeHistogram[TrackingAllocatorTagStats::NumSizeClasses];
+
+    // Accessed by the owning thread only
+    TrackingAllocatorTagInfo* pTag             = nullptr;
+    Int64                     UnpublishedBytes = 0;
+};
+
+// Counters of all tags written by one thread
+struct TrackingAllocatorThreadCounters
+{
+    static constexpr Uint32 TagsPerChunk = 64;
+    static constexpr Uint32 MaxChunks    = 64;
+    static constexpr Uint32 MaxTags      = TagsPerChunk * MaxChunks;
+    static constexpr Uint32 CacheSize    = 64;
+    static constexpr Uint32 InvalidTagId = ~0u;
+
+    struct TagCountersChunk
+    {
+        TrackingAllocatorTagCounters Tags[TagsPerChunk];
+    };
+
+    explicit TrackingAllocatorThreadCounters(TrackingMemoryAllocator* _pOwner) :
+        pOwner{_pOwner}
+    {
+        for (auto& pChunk : Chunks)
+            pChunk.store(nullptr, std::memory_order_relaxed);
+    }
+
+    ~TrackingAllocatorThreadCounters()
+    {
+        for (auto& pChunk : Chunks)
+            delete pChunk.load(std::memory_order_relaxed);
+    }
+
+    template <typename HandlerType>
+    void ProcessTagCounters(HandlerType&& Handler) const
+    {
+        for (Uint32 c = 0; c < MaxChunks; ++c)
+        {
+            // Chunks are published with release semantics by the owning thread
+            if (const auto* pChunk = Chunks[c].load(std::memory_order_acquire))
+            {
+                for (Uint32 t = 0; t < TagsPerChunk; ++t)
+                    Handler(c * TagsPerChunk + t, pChunk->Tags[t]);
+            }
+        }
+    }
+
+    // The owner is reset to null under the registry mutex when the allocator is destroyed.
+    std::atomic<TrackingMemoryAllocator*> pOwner;
+
+    // Chunks are allocated on demand and are never released while the thread is alive
+    std::atomic<TagCountersChunk*> Chunks[MaxChunks];
+
+    // Entries are keyed by the description text rather than its address,
+    // so that a buffer reused for another description gets the right tag
+    struct DescriptionCacheEntry
+    {
+        size_t      Hash = 0;
+        std::string Description;
+        Uint32      TagId = InvalidTagId;
+    };
+
+    // Description pointers are checked before the text is hashed. The text is still compared
+    // with the cached copy, so that a buffer reused for another description is not mistaken.
+    struct DescriptionPointerCacheEntry
+    {
+        const Char*                  pDescription = nullptr;
+        const DescriptionCacheEntry* pEntry       = nullptr;
+    };
+
+    // Accessed by the owning thread only
+    DescriptionCacheEntry        DescriptionCache[CacheSize];
+    DescriptionPointerCacheEntry DescriptionPointerCache[CacheSize];
+    Int64                        UnpublishedTotalBytes = 0;
+};
+
+// Per-thread tables of counters indexed by the allocator thread cache slot
+using TrackingAllocatorThreadCache = ThreadSlotRegistry<TrackingMemoryAllocator, TrackingAllocatorThreadCounters>;
+
+
+TrackingMemoryAllocator::TrackingMemoryAllocator(IMemoryAllocator& RawAllocator, Uint32 PeakUpdateBytes) :
+    // clang-format off
+    m_RawAllocator   {RawAllocator},
+    m_PeakUpdateBytes{PeakUpdateBytes},
+    m_pTotal         {new TrackingAllocatorTagInfo}
+// clang-format on
+{
+    // Tag 0 collects allocations without description
+    RegisterTag(nullptr, nullptr, 0);
+
+    std::lock_guard<std::mutex> Lock{TrackingAllocatorThreadCache::GetMutex()};
+    m_ThreadCacheSlot = TrackingAllocatorThreadCache::AllocateSlot();
+}
+
+TrackingMemoryAllocator::~TrackingMemoryAllocator()
+{
+#ifdef DILIGENT_DEBUG
+    {
+        const auto Snapshot = GetSnapshot();
+        VERIFY(Snapshot.Total.LiveAllocations == 0, "Memory leak detected: ", Snapshot.Total.LiveAllocations,
+               " allocation(s) (", Snapshot.Total.LiveBytes, " bytes) have not been released");
+    }
+#endif
+
+    // Counters of live threads are released when the threads exit or when the slot is reused
+    std::lock_guard<std::mutex> Lock{TrackingAllocatorThreadCache::GetMutex()};
+    for (auto* pCounters : m_ThreadCounters)
+        pCounters->pOwner.store(nullptr);
+    m_ThreadCounters.clear();
+    TrackingAllocatorThreadCache::ReleaseSlot(m_ThreadCacheSlot);
+}
+
+Uint32 TrackingMemoryAllocator::RegisterTag(const Char* dbgDescription, const char* dbgFileName, Int32 dbgLineNumber)
+{
+    std::string Description = dbgDescription != nullptr ? dbgDescription : "<unnamed>";
+
+    std::lock_guard<std::mutex> Lock{m_TagsMtx};
+
+    auto it = m_TagIds.find(Description);
+    if (it != m_TagIds.end())
+        return it->second;
+
+    if (m_Tags.size() >= TrackingAllocatorThreadCounters::MaxTags)
+    {
+        LOG_WARNING_MESSAGE_ONCE("The number of allocation descriptions exceeds ", Uint32{TrackingAllocatorThreadCounters::MaxTags},
+                                 ". Allocations with new descriptions are tracked as unnamed.");
+        return 0;
+    }
+
+    std::unique_ptr<TrackingAllocatorTagInfo> pTag{new TrackingAllocatorTagInfo};
+    pTag->Description = Description;
+    if (dbgFileName != nullptr)
+    {
+        pTag->FirstAllocationSource = dbgFileName;
+        pTag->FirstAllocationSource += ':';
+        pTag->FirstAllocationSource += std::to_string(dbgLineNumber);
+    }
+
+    const auto TagId = static_cast<Uint32>(m_Tags.size());
+    m_Tags.emplace_back(std::move(pTag));
+    m_TagIds.emplace(std::move(Description), TagId);
+    return TagId;
+}
+
+TrackingAllocatorThreadCounters* TrackingMemoryAllocator::GetThreadCounters()
+{
+    if (auto* pCounters = TrackingAllocatorThreadCache::GetThreadObject(m_ThreadCacheSlot, this))
+        return pCounters;
+
+    // The counters of an exiting thread have already been retired
+    if (TrackingAllocatorThreadCache::IsThreadTableDestroyed())
+        return nullptr;
+
+    return &RegisterThreadCounters();
+}
+
+TrackingAllocatorThreadCounters& TrackingMemoryAllocator::RegisterThreadCounters()
+{
+    std::lock_guard<std::mutex> Lock{TrackingAllocatorThreadCache::GetMutex()};
+
+    auto* pCounters = TrackingAllocatorThreadCache::CreateThreadObject(m_ThreadCacheSlot, this);
+    m_ThreadCounters.push_back(pCounters);
+
+    return *pCounters;
+}
+
+TrackingAllocatorTagCounters& TrackingMemoryAllocator::GetTagCounters(TrackingAllocatorThreadCounters& ThreadCounters, Uint32 TagId)
+{
+    VERIFY_EXPR(TagId < TrackingAllocatorThreadCounters::MaxTags);
+
+    auto& Chunk  = ThreadCounters.Chunks[TagId / TrackingAllocatorThreadCounters::TagsPerChunk];
+    auto* pChunk = Chunk.load(std::memory_order_relaxed);
+    if (pChunk == nullptr)
+    {
+        pChunk = new TrackingAllocatorThreadCounters::TagCountersChunk;
+        Chunk.store(pChunk, std::memory_order_release);
+    }
+
+    auto& Counters = pChunk->Tags[TagId % TrackingAllocatorThreadCounters::TagsPerChunk];
+    if (Counters.pTag == nullptr)
+    {
+        std::lock_guard<std::mutex> Lock{m_TagsMtx};
+        Counters.pTag = m_Tags[TagId].get();
+    }
+    return Counters;
+}
+
+void TrackingMemoryAllocator::UpdateLiveBytes(TrackingAllocatorThreadCounters& ThreadCounters, TrackingAllocatorTagCounters& Counters, Int64 Delta)
+{
+    AddRelaxed(Counters.LiveBytes, Delta);
+
+    // Publishing the live bytes is the only operation that touches shared cache lines
+    Counters.UnpublishedBytes += Delta;
+    if (std::abs(Counters.UnpublishedBytes) >= m_PeakUpdateBytes)
+    {
+        Counters.pTag->Publish(Counters.UnpublishedBytes);
+        Counters.UnpublishedBytes = 0;
+    }
+
+    ThreadCounters.UnpublishedTotalBytes += Delta;
+    if (std::abs(ThreadCounters.UnpublishedTotalBytes) >= m_PeakUpdateBytes)
+    {
+        m_pTotal->Publish(ThreadCounters.UnpublishedTotalBytes);
+        ThreadCounters.UnpublishedTotalBytes = 0;
+    }
+}
+
+void* TrackingMemoryAllocator::Allocate(size_t Size, const Char* dbgDescription, const char* dbgFileName, const Int32 dbgLineNumber)
+{
+    auto* pHeader = static_cast<AllocationHeader*>(m_RawAllocator.Allocate(Size + sizeof(AllocationHeader), dbgDescription, dbgFileName, dbgLineNumber));
+    if (pHeader == nullptr)
+        return nullptr;
+
+    auto* pThreadCounters = GetThreadCounters();
+    if (pThreadCounters == nullptr)
+    {
+        pHeader->Size  = Size;
+        pHeader->TagId = dbgDescription != nullptr ? RegisterTag(dbgDescription, dbgFileName, dbgLineNumber) : 0;
+        UpdateRetiredCounters(pHeader->TagId, Size, true);
+        return pHeader + 1;
+    }
+    auto& ThreadCounters = *pThreadCounters;
+
+    Uint32 TagId = 0;
+    if (dbgDescription != nullptr)
+    {
+        const auto PtrSlot  = reinterpret_cast<size_t>(dbgDescription) / sizeof(void*) % TrackingAllocatorThreadCounters::CacheSize;
+        auto&      PtrEntry = ThreadCounters.DescriptionPointerCache[PtrSlot];
+        if (PtrEntry.pDescription == dbgDescription && PtrEntry.pEntry->Description == dbgDescription)
+        {
+            TagId = PtrEntry.pEntry->TagId;
+        }
+        else
+        {
+            const auto Hash  = CStringHash<Char>{}(dbgDescription);
+            auto&      Entry = ThreadCounters.DescriptionCache[Hash % TrackingAllocatorThreadCounters::CacheSize];
+            if (Entry.TagId == TrackingAllocatorThreadCounters::InvalidTagId || Entry.Hash != Hash || Entry.Description != dbgDescription)
+            {
+                Entry.TagId       = RegisterTag(dbgDescription, dbgFileName, dbgLineNumber);
+                Entry.Hash        = Hash;
+                Entry.Description = dbgDescription;
+            }
+            TagId = Entry.TagId;
+
+            PtrEntry.pDescription = dbgDescription;
+            PtrEntry.pEntry       = &Entry;
+        }
+    }
+
+    pHeader->Size  = Size;
+    pHeader->TagId = TagId;
+
+    auto& Counters = GetTagCounters(ThreadCounters, TagId);
+    AddRelaxed(Counters.LiveAllocations, Int64{1});
+    AddRelaxed(Counters.TotalAllocations, Uint64{1});
+    AddRelaxed(Counters.TotalBytes, Uint64{Size});
+    AddRelaxed(Counters.SizeHistogram[GetSizeClass(Size)], Uint64{1});
+    UpdateLiveBytes(ThreadCounters, Counters, static_cast<Int64>(Size));
+
+    return pHeader + 1;
+}
+
+void TrackingMemoryAllocator::Free(void* Ptr)
+{
+    if (Ptr == nullptr)
+        return;
+
+    auto* pHeader = static_cast<AllocationHeader*>(Ptr) - 1;
+
+    // The memory may be released by a thread other than the one that allocated it
+    if (auto* pThreadCounters = GetThreadCounters())
+    {
+        auto& Counters = GetTagCounters(*pThreadCounters, pHeader->TagId);
+        AddRelaxed(Counters.LiveAllocations, Int64{-1});
+        UpdateLiveBytes(*pThreadCounters, Counters, -static_cast<Int64>(pHeader->Size));
+    }
+    else
+    {
+        UpdateRetiredCounters(pHeader->TagId, static_cast<size_t>(pHeader->Size), false);
+    }
+
+    m_RawAllocator.Free(pHeader);
+}
+
+void TrackingMemoryAllocator::UpdateRetiredCounters(Uint32 TagId, size_t Size, bool IsAllocation)
+{
+    const auto Delta = IsAllocation ? static_cast<Int64>(Size) : -static_cast<Int64>(Size);
+
+    std::lock_guard<std::mutex> RegistryLock{TrackingAllocatorThreadCache::GetMutex()};
+
+    if (TagId >= m_RetiredCounters.size())
+        m_RetiredCounters.resize(size_t{TagId} + 1);
+
+    auto& Stats = m_RetiredCounters[TagId];
+    Stats.LiveBytes += Delta;
+    if (IsAllocation)
+    {
+        ++Stats.LiveAllocations;
+        ++Stats.TotalAllocations;
+        Stats.TotalBytes += Size;
+        ++Stats.SizeHistogram[GetSizeClass(Size)];
+    }
+    else
+    {
+        --Stats.LiveAllocations;
+    }
+
+    {
+        std::lock_guard<std::mutex> TagsLock{m_TagsMtx};
+        m_Tags[TagId]->Publish(Delta);
+    }
+    m_pTotal->Publish(Delta);
+}
+
+void TrackingMemoryAllocator::OnThreadExit(TrackingAllocatorThreadCounters& ThreadCounters)
+{
+    m_ThreadCounters.erase(std::find(m_ThreadCounters.begin(), m_ThreadCounters.end(), &ThreadCounters));
+
+    ThreadCounters.ProcessTagCounters([this](Uint32 TagId, const TrackingAllocatorTagCounters& Counters) {
+        if (Counters.pTag == nullptr)
+            return;
+
+        if (Counters.UnpublishedBytes != 0)
+            Counters.pTag->Publish(Counters.UnpublishedBytes);
+
+        if (TagId >= m_RetiredCounters.size())
+            m_RetiredCounters.resize(size_t{TagId} + 1);
+        Counters.AddTo(m_RetiredCounters[TagId]);
+    });
+
+    if (ThreadCounters.UnpublishedTotalBytes != 0)
+        m_pTotal->Publish(ThreadCounters.UnpublishedTotalBytes);
+}
+
+TrackingAllocatorSnapshot TrackingMemoryAllocator::GetSnapshot() const
+{
+    TrackingAllocatorSnapshot Snapshot;
+
+    std::lock_guard<std::mutex> RegistryLock{TrackingAllocatorThreadCache::GetMutex()};
+    std::lock_guard<std::mutex> TagsLock{m_TagsMtx};
+
+    std::vector<TrackingAllocatorTagStats> Tags(m_Tags.size());
+    for (size_t i = 0; i < m_RetiredCounters.size(); ++i)
+        AddStats(Tags[i], m_RetiredCounters[i]);
+
+    for (const auto* pCounters : m_ThreadCounters)
+    {
+        pCounters->ProcessTagCounters([&Tags](Uint32 TagId, const TrackingAllocatorTagCounters& Counters) {
+            // Tags registered after the tags lock was acquired are skipped
+            if (TagId < Tags.size())
+                Counters.AddTo(Tags[TagId]);
+        });
+    }
+
+    Snapshot.Tags.reserve(Tags.size());
+    for (size_t i = 0; i < Tags.size(); ++i)
+    {
+        auto& Tag = Tags[i];
+        if (Tag.TotalAllocations == 0 && Tag.LiveAllocations == 0)
+            continue;
+
+        AddStats(Snapshot.Total, Tag);
+
+        const auto& TagInfo       = *m_Tags[i];
+        Tag.Description           = TagInfo.Description;
+        Tag.FirstAllocationSource = TagInfo.FirstAllocationSource;
+        // Unpublished bytes may make the current value exceed the published peak
+        Tag.PeakBytes = std::max(TagInfo.PeakBytes.load(std::memory_order_relaxed), Tag.LiveBytes);
+        Snapshot.Tags.emplace_back(std::move(Tag));
+    }
+    Snapshot.Total.Description = "<total>";
+    Snapshot.Total.PeakBytes   = std::max(m_pTotal->PeakBytes.load(std::memory_order_relaxed), Snapshot.Total.LiveBytes);
+
+    SortTags(Snapshot.Tags);
+
+    return Snapshot;
+}
+
+TrackingAllocatorSnapshot TrackingAllocatorSnapshot::Diff(const TrackingAllocatorSnapshot& Earlier) const
+{
+    TrackingAllocatorSnapshot Result;
+
+    Result.Total = Total;
+    SubtractStats(Result.Total, Earlier.Total);
+
+    std::unordered_map<std::string, const TrackingAllocatorTagStats*> EarlierTags;
+    for (const auto& Tag : Earlier.Tags)
+        EarlierTags.emplace(Tag.Description, &Tag);
+
+    for (const auto& Tag : Tags)
+    {
+        auto TagDiff = Tag;
+
+        auto it = EarlierTags.find(Tag.Description);
+        if (it != EarlierTags.end())
+            SubtractStats(TagDiff, *it->second);
+
+        if (TagDiff.TotalAllocations != 0 || TagDiff.LiveAllocations != 0)
+            Result.Tags.emplace_back(std::move(TagDiff));
+    }
+
+    SortTags(Result.Tags);
+
+    return Result;
+}
+
+std::string TrackingAllocatorSnapshot::ToJSON() const
+{
+    std::stringstream Stream;
+    Stream << "{\n  \"Total\": ";
+    WriteJSONStats(Stream, Total, "  ");
+    Stream << ",\n  \"Tags\": [";
+    for (size_t i = 0; i < Tags.size(); ++i)
+    {
+        Stream << (i > 0 ? ",\n    " : "\n    ");
+        WriteJSONStats(Stream, Tags[i], "    ");
+    }
+    Stream << (Tags.empty() ? "]\n}\n" : "\n  ]\n}\n");
+    return Stream.str();
+}
+
+} // namespace Diligent
@@ -0,0 +1,249 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Implementation of Diligent::ConcurrentRingBuffer class
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include "../../../../../MultiTouch/DiligentLog/Primitives/interface/MemoryAllocator.h"
+#include "../../../../../MultiTouch/DiligentLog/Platforms/Basic/interface/DebugUtilities.hpp"
+#include "../../../Common/interface/Align.hpp"
+#include "../../../Common/interface/STDAllocator.hpp"
+
+namespace Diligent
+{
+/// Thread-safe version of the ring buffer that allows multiple threads to allocate
+/// space concurrently, e.g. when recording command lists in parallel.
+///
+/// The head of the buffer is a monotonically increasing virtual offset that is advanced
+/// with a single compare-and-swap, so the allocation fast path never takes a lock.
+/// Physical offsets are obtained by wrapping the virtual offset around the buffer size.
+/// To further reduce contention on the head, every recording thread may keep its own
+/// ThreadChunk: a small sub-range of the buffer that is reserved with one atomic operation
+/// and then sub-allocated without any synchronization.
+///
+/// Frame retirement follows the same rules as in RingBuffer:
+/// - Allocate() may be called from any number of threads simultaneously;
+/// - FinishCurrentFrame() and ReleaseCompletedFrames() must be called from one thread at a time.
+///   ReleaseCompletedFrames() may run concurrently with Allocate(), while FinishCurrentFrame()
+///   must only be called after all allocations for the current frame have been made.
+class ConcurrentRingBuffer
+{
+public:
+    using OffsetType = size_t;
+
+    static constexpr const OffsetType InvalidOffset = static_cast<OffsetType>(-1);
+
+    /// Per-thread sub-range of the ring buffer.
+
+    /// A chunk is owned by a single thread and must not be shared. Chunks are
+    /// automatically invalidated when the current frame is finished, so that
+    /// the space reserved in one frame is never used by the next one.
+    struct ThreadChunk
+    {
+        OffsetType Offset     = InvalidOffset;
+        OffsetType Size       = 0;
+        OffsetType UsedSize   = 0;
+        Uint64     FrameIndex = 0;
+    };
+
+    ConcurrentRingBuffer(OffsetType MaxSize, IMemoryAllocator& Allocator, OffsetType ThreadChunkSize = 4096) noexcept :
+        m_CompletedFrameHeads(STD_ALLOCATOR_RAW_MEM(FrameHeadAttribs, Allocator, "Allocator for deque<FrameHeadAttribs>")),
+        m_MaxSize{MaxSize},
+        m_ThreadChunkSize{std::min(ThreadChunkSize, MaxSize)}
+    {}
+
+    // clang-format off
+    ConcurrentRingBuffer             (const ConcurrentRingBuffer&)  = delete;
+    ConcurrentRingBuffer             (      ConcurrentRingBuffer&&) = delete;
+    ConcurrentRingBuffer& operator = (const ConcurrentRingBuffer&)  = delete;
+    ConcurrentRingBuffer& operator = (      ConcurrentRingBuffer&&) = delete;
+    // clang-format on
+
+    ~ConcurrentRingBuffer()
+    {
+        VERIFY(GetUsedSize() == 0, "All space in the ring buffer must be released");
+    }
+
+    /// Allocates space directly from the shared head of the buffer. Thread-safe.
+    OffsetType Allocate(OffsetType Size, OffsetType Alignment)
+    {
+        VERIFY_EXPR(Size > 0);
+        VERIFY(IsPowerOfTwo(Alignment), "Alignment (", Alignment, ") must be power of 2");
+        Size = AlignUp(Size, Alignment);
+        if (Size > m_MaxSize)
+            return InvalidOffset;
+
+        Uint64 Head = m_Head.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            const OffsetType PhysHead = static_cast<OffsetType>(Head % m_MaxSize);
+
+            OffsetType Offset  = AlignUp(PhysHead, Alignment);
+            OffsetType AddSize = Size + (Offset - PhysHead);
+            if (Offset + Size > m_MaxSize)
+            {
+                // Skip the remaining space at the end and allocate from the beginning of the buffer
+                //
+                // Offset              Tail          Head               MaxSize
+                //  |                  |                |<------------->|
+                //  [                  xxxxxxxxxxxxxxxxx++++++++++++++++]
+                //
+                Offset  = 0;
+                AddSize = (m_MaxSize - PhysHead) + Size;
+            }
+
+            // Tail only moves forward, so a stale value may only result in a spurious failure
+            const Uint64 Tail = m_Tail.load(std::memory_order_acquire);
+            if (Head + AddSize - Tail > m_MaxSize)
+                return InvalidOffset;
+
+            if (m_Head.compare_exchange_weak(Head, Head + AddSize, std::memory_order_relaxed))
+                return Offset;
+        }
+    }
+
+    /// Allocates space from the thread chunk, reserving a new chunk from the buffer when the
+    /// current one is exhausted or belongs to a finished frame. Only the thread that owns the
+    /// chunk may use it; allocations from different chunks may run in parallel.
+    OffsetType Allocate(ThreadChunk& Chunk, OffsetType Size, OffsetType Alignment)
+    {
+        VERIFY_EXPR(Size > 0);
+        VERIFY(IsPowerOfTwo(Alignment), "Alignment (", Alignment, ") must be power of 2");
+
+        const Uint64 FrameIndex = m_FrameIndex.load(std::memory_order_acquire);
+        if (Chunk.Offset != InvalidOffset && Chunk.FrameIndex == FrameIndex)
+        {
+            const OffsetType Offset = AlignUp(Chunk.Offset + Chunk.UsedSize, Alignment);
+            if (Offset + Size <= Chunk.Offset + Chunk.Size)
+            {
+                Chunk.UsedSize = Offset + Size - Chunk.Offset;
+                return Offset;
+            }
+        }
+
+        // Large allocations would waste too much of the chunk, so they go directly to the buffer
+        if (AlignUp(Size, Alignment) > m_ThreadChunkSize / 2)
+            return Allocate(Size, Alignment);
+
+        // The rest of the old chunk is released together with the frame it was reserved in
+        const OffsetType ChunkOffset = Allocate(m_ThreadChunkSize, std::max(Alignment, OffsetType{16}));
+        if (ChunkOffset == InvalidOffset)
+        {
+            Chunk = ThreadChunk{};
+            return Allocate(Size, Alignment);
+        }
+
+        Chunk.Offset     = ChunkOffset;
+        Chunk.Size       = m_ThreadChunkSize;
+        Chunk.UsedSize   = Size;
+        Chunk.FrameIndex = FrameIndex;
+        return ChunkOffset;
+    }
+
+    // FenceValue is the fence value associated with the command list in which the head
+    // could have been referenced last time
+    // See http://diligentgraphics.com/diligent-engine/architecture/d3d12/managing-resource-lifetimes/
+    void FinishCurrentFrame(Uint64 FenceValue)
+    {
+#ifdef DILIGENT_DEBUG
+        if (!m_CompletedFrameHeads.empty())
+            VERIFY(FenceValue >= m_CompletedFrameHeads.back().FenceValue, "Current frame fence value (", FenceValue, ") is lower than the fence value of the previous frame (", m_CompletedFrameHeads.back().FenceValue, ")");
+#endif
+        const Uint64 Head = m_Head.load(std::memory_order_relaxed);
+        // Ignore zero-size frames
+        if (Head != m_FrameStart)
+        {
+            m_CompletedFrameHeads.emplace_back(FenceValue, Head);
+            m_FrameStart = Head;
+        }
+        // Invalidate all thread chunks reserved in this frame
+        m_FrameIndex.fetch_add(1, std::memory_order_release);
+    }
+
+    // CompletedFenceValue indicates GPU progress
+    // See http://diligentgraphics.com/diligent-engine/architecture/d3d12/managing-resource-lifetimes/
+    void ReleaseCompletedFrames(Uint64 CompletedFenceValue)
+    {
+        // We can release all heads whose associated fence value is less than or equal to CompletedFenceValue
+        Uint64 Tail = m_Tail.load(std::memory_order_relaxed);
+        while (!m_CompletedFrameHeads.empty() && m_CompletedFrameHeads.front().FenceValue <= CompletedFenceValue)
+        {
+            Tail = m_CompletedFrameHeads.front().Head;
+            m_CompletedFrameHeads.pop_front();
+        }
+        m_Tail.store(Tail, std::memory_order_release);
+    }
+
+    OffsetType GetMaxSize() const { return m_MaxSize; }
+    OffsetType GetThreadChunkSize() const { return m_ThreadChunkSize; }
+
+    /// Returns the size of the space that has not been released yet, including the space
+    /// skipped at the end of the buffer and unused parts of thread chunks.
+    OffsetType GetUsedSize() const
+    {
+        const Uint64 Tail = m_Tail.load(std::memory_order_acquire);
+        const Uint64 Head = m_Head.load(std::memory_order_acquire);
+        return static_cast<OffsetType>(Head - Tail);
+    }
+
+    bool IsFull() const { return GetUsedSize() == m_MaxSize; }
+    bool IsEmpty() const { return GetUsedSize() == 0; }
+
+private:
+    struct FrameHeadAttribs
+    {
+        FrameHeadAttribs(Uint64 fv, Uint64 h) noexcept :
+            FenceValue{fv},
+            Head{h}
+        {}
+
+        // Fence value associated with the command list in which
+        // the allocation could have been referenced last time
+        Uint64 FenceValue;
+        // Virtual offset of the head at the end of the frame
+        Uint64 Head;
+    };
+
+    // Accessed by the thread that finishes and releases frames only
+    std::deque<FrameHeadAttribs, STDAllocatorRawMem<FrameHeadAttribs>> m_CompletedFrameHeads;
+    Uint64                                                             m_FrameStart = 0;
+
+    // clang-format off
+    const OffsetType      m_MaxSize;
+    const OffsetType      m_ThreadChunkSize;
+    std::atomic<Uint64>   m_Head      {0};
+    std::atomic<Uint64>   m_Tail      {0};
+    std::atomic<Uint64>   m_FrameIndex{0};
+    // clang-format on
+};
+
+} // namespace Diligent
@@ -32,7 +32,9 @@
 /// Declaration of DynamicAtlasManager class
 
 #include <map>
+#include <set>
 #include <unordered_map>
+#include <vector>
 
 #include "../../../../../MultiTouch/DiligentLog/Primitives/interface/BasicTypes.h"
 #include "../../../Common/interface/HashUtils.hpp"
@@ -98,7 +100,22 @@ public:
         };
     };
 
-    DynamicAtlasManager(Uint32 Width, Uint32 Height);
+    /// Region packing algorithm
+    enum class PackingAlgorithm : Uint8
+    {
+        /// Guillotine tree that keeps free regions ordered by width and by height.
+        /// Every allocation picks the smallest free region that fits.
+        Guillotine,
+
+        /// Skyline packer that keeps track of the top boundary of the allocated area and
+        /// places every region at the lowest position. Space below the skyline that can't
+        /// be reached is kept in the list of free rectangles and reused for later allocations.
+        /// Skyline packing is faster and denser than the guillotine tree when many small
+        /// regions of similar height are allocated (e.g. glyphs).
+        Skyline
+    };
+
+    DynamicAtlasManager(Uint32 Width, Uint32 Height, PackingAlgorithm Algorithm = PackingAlgorithm::Guillotine);
     ~DynamicAtlasManager();
 
     // clang-format off
@@ -111,15 +128,46 @@ public:
     Region Allocate(Uint32 Width, Uint32 Height);
     void   Free(Region&& R);
 
-    Uint32 GetFreeRegionCount() const
-    {
-        VERIFY_EXPR(m_FreeRegionsByWidth.size() == m_FreeRegionsByHeight.size());
-        return static_cast<Uint32>(m_FreeRegionsByWidth.size());
-    }
+    /// Allocates multiple regions at once.
+
+    /// \param [in, out] pRegions   - Array of NumRegions regions. On input, width and height
+    ///                               of every region define the requested size. On output,
+    ///                               x and y are set to the region position. Regions that
+    ///                               could not be allocated are set to empty regions.
+    /// \param [in]      NumRegions - Number of regions in the array.
+    /// \return          The number of regions that were successfully allocated.
+    ///
+    /// \remarks   The regions are placed in the order of decreasing height and width,
+    ///            which results in denser packing than allocating them one by one.
+    Uint32 Allocate(Region* pRegions, Uint32 NumRegions);
+
+    Uint32 GetFreeRegionCount() const;
 
     Uint32 GetWidth() const { return m_Width; }
     Uint32 GetHeight() const { return m_Height; }
 
+    PackingAlgorithm GetPackingAlgorithm() const { return m_Algorithm; }
+
+    /// Returns the total area of all allocated regions.
+    Uint64 GetAllocatedArea() const { return m_AllocatedArea; }
+
+    /// Returns the fraction of the atlas area that is allocated, from 0 to 1.
+    float GetOccupancy() const
+    {
+        return static_cast<float>(static_cast<double>(m_AllocatedArea) / (static_cast<double>(m_Width) * static_cast<double>(m_Height)));
+    }
+
+    /// Returns the area of the largest free rectangle.
+    Uint64 GetLargestFreeRegionArea() const;
+
+    /// Returns the fragmentation of the free space, from 0 to 1.
+
+    /// Fragmentation is defined as one minus the ratio of the largest free rectangle area to
+    /// the total free area. Zero means that the entire free space can be allocated as a single
+    /// region. Together with GetOccupancy(), this can be used to decide whether new
+    /// allocations should go to another atlas slice.
+    float GetFragmentation() const;
+
 #define CMP(Member)                 \
     if (R0.Member < R1.Member)      \
         return true;                \
@@ -156,11 +204,32 @@ private:
     void DbgVerifyConsistency() const;
     struct Node;
     void DbgRecursiveVerifyConsistency(const Node& N, Uint32& Area) const;
+    void DbgVerifySkyline() const;
 #endif
 
+    Region AllocateGuillotine(Uint32 Width, Uint32 Height);
+    void   FreeGuillotine(Region&& R);
+
+    Region AllocateSkyline(Uint32 Width, Uint32 Height);
+    void   FreeSkyline(Region&& R);
+    void   ResetSkyline();
+    bool   FindSkylinePosition(Uint32 Width, Uint32 Height, size_t& NodeIdx, Uint32& y) const;
+    void   AddSkylineLevel(size_t NodeIdx, Uint32 y, Uint32 Width, Uint32 Height);
+    void   LowerSkyline(Uint32 x, Uint32 Width, Uint32 y);
+    void   MergeSkylineNodes();
+    void   GetSkylineHeightRange(Uint32 x, Uint32 Width, Uint32& MinY, Uint32& MaxY) const;
+    Region AddSkylineFreeRect(Region R);
+    bool   AbsorbSkylineFreeRect(const Region& F);
+    void   RegisterSkylineFreeRect(const Region& R);
+    void   UnregisterSkylineFreeRect(const Region& R);
+
     const Uint32 m_Width;
     const Uint32 m_Height;
 
+    const PackingAlgorithm m_Algorithm;
+
+    Uint64 m_AllocatedArea = 0;
+
     struct Node
     {
         Region R;
@@ -217,8 +286,26 @@ private:
     std::map<Region, Node*, WidthFirstCompare> m_FreeRegionsByWidth;
     // Free regions ordered by height->width->y->x
     std::map<Region, Node*, HeightFirstCompare> m_FreeRegionsByHeight;
-    // Allocated regions
+    // Allocated regions. Nodes are null when skyline packing is used.
     std::unordered_map<Region, Node*, Region::Hasher> m_AllocatedRegions;
+
+    // Skyline segment that spans [x, x + width) at the height y
+    struct SkylineNode
+    {
+        Uint32 x;
+        Uint32 y;
+        Uint32 width;
+    };
+    // Skyline segments ordered by x
+    std::vector<SkylineNode> m_Skyline;
+    // Free rectangles below the skyline ordered by width->height->x->y
+    std::set<Region, WidthFirstCompare> m_SkylineFreeRectsByWidth;
+    // Free rectangles below the skyline ordered by height->width->y->x
+    std::set<Region, HeightFirstCompare> m_SkylineFreeRectsByHeight;
+    // Free rectangles below the skyline keyed by the bottom-left corner as (y << 32) | x
+    std::map<Uint64, Region> m_SkylineFreeRectsByMinCorner;
+    // Free rectangles below the skyline keyed by the top-right corner as (y << 32) | x
+    std::map<Uint64, Region> m_SkylineFreeRectsByMaxCorner;
 };
 
 } // namespace Diligent
@@ -35,15 +35,93 @@
 
 #include <mutex>
 #include <deque>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <iterator>
+#include <new>
 
 #include "../../../../../MultiTouch/DiligentLog/Primitives/interface/MemoryAllocator.h"
 #include "../../../Common/interface/STDAllocator.hpp"
+#include "../../../Common/interface/FixedBlockMemoryAllocator.hpp"
+#include "../../../Common/interface/DefaultRawMemoryAllocator.hpp"
 #include "../../../../../MultiTouch/DiligentLog/Platforms/interface/Atomics.hpp"
 #include "../../../../../MultiTouch/DiligentLog/Platforms/Basic/interface/DebugUtilities.hpp"
 
 namespace Diligent
 {
 
+/// Allocates memory for stale resource wrappers.
+
+/// Stale objects are created and destroyed at a high rate from many threads, so
+/// small objects are served by thread-caching fixed block pools instead of the heap.
+/// Wrappers are created before they are added to a queue and may be shared by several
+/// queues, so the pools are process-wide. Release queue nodes are allocated from the
+/// allocator passed to the ResourceReleaseQueue constructor.
+class StaleResourceAllocator
+{
+public:
+    static void* Allocate(size_t Size)
+    {
+        if (auto* pPool = GetPool(Size))
+            return pPool->Allocate(GetBlockSize(Size), "Stale resource", __FILE__, __LINE__);
+        else
+            return ::operator new(Size);
+    }
+
+    static void Free(void* Ptr, size_t Size)
+    {
+        if (auto* pPool = GetPool(Size))
+            pPool->Free(Ptr);
+        else
+            ::operator delete(Ptr);
+    }
+
+private:
+    static constexpr size_t MinBlockSize = 32;
+    static constexpr size_t MaxBlockSize = 256;
+
+    static size_t GetBlockSize(size_t Size)
+    {
+        size_t BlockSize = MinBlockSize;
+        while (BlockSize < Size)
+            BlockSize *= 2;
+        return BlockSize;
+    }
+
+    static FixedBlockMemoryAllocator* GetPool(size_t Size)
+    {
+        // clang-format off
+        if (Size <=  32) return &GetPool< 32>();
+        if (Size <=  64) return &GetPool< 64>();
+        if (Size <= 128) return &GetPool<128>();
+        if (Size <= 256) return &GetPool<256>();
+        // clang-format on
+        return nullptr;
+    }
+
+    template <size_t BlockSize>
+    static FixedBlockMemoryAllocator& GetPool()
+    {
+        static_assert(BlockSize >= MinBlockSize && BlockSize <= MaxBlockSize, "Unexpected block size");
+        static FixedBlockMemoryAllocator Pool{DefaultRawMemoryAllocator::GetAllocator(), BlockSize, 256, FixedBlockAllocatorMode::ThreadCaching};
+        return Pool;
+    }
+};
+
+/// Base class for objects that are allocated by StaleResourceAllocator
+struct StaleResourceAllocatedObject
+{
+    static void* operator new(size_t Size)
+    {
+        return StaleResourceAllocator::Allocate(Size);
+    }
+    static void operator delete(void* Ptr, size_t Size)
+    {
+        StaleResourceAllocator::Free(Ptr, Size);
+    }
+};
+
 /// Helper class that wraps stale resources of different types
 class DynamicStaleResourceWrapper final
 {
@@ -69,7 +147,7 @@ public:
     {
         VERIFY_EXPR(NumReferences >= 1);
 
-        class SpecificStaleResource final : public StaleResourceBase
+        class SpecificStaleResource final : public StaleResourceBase, public StaleResourceAllocatedObject
         {
         public:
             SpecificStaleResource(ResourceType&& SpecificResource) :
@@ -92,7 +170,7 @@ public:
             ResourceType m_SpecificResource;
         };
 
-        class SpecificSharedStaleResource final : public StaleResourceBase
+        class SpecificSharedStaleResource final : public StaleResourceBase, public StaleResourceAllocatedObject
         {
         public:
             SpecificSharedStaleResource(ResourceType&& SpecificResource, Atomics::Long NumReferences) :
@@ -216,22 +294,59 @@ private:
 ///   the command list
 /// * Resources are removed and actually destroyed from the queue when fence is signaled and the queue is Purged
 ///
+/// Releasing and discarding resources never blocks: every thread pushes its objects onto lock-free lists.
+/// The lists are drained by DiscardStaleResources() and Purge(), which group the objects into buckets
+/// by their fence value, so that a whole bucket is retired at once when its fence completes.
+///
 /// \tparam ResourceWrapperType -  Type of the resource wrapper used by the release queue.
 template <typename ResourceWrapperType>
 class ResourceReleaseQueue
 {
 public:
+    /// Release queue statistics
+    struct Statistics
+    {
+        /// The number of stale resources waiting for their command list to be submitted
+        size_t NumStaleResources = 0;
+
+        /// The number of resources waiting for their fence to complete
+        size_t NumPendingReleaseResources = 0;
+
+        /// The total number of resources destroyed by the queue
+        Uint64 NumReleasedResources = 0;
+
+        /// Average time, in seconds, between the moment a resource was moved to the release queue
+        /// and the moment it was destroyed
+        double AvgReleaseLatency = 0;
+
+        /// Maximum release latency, in seconds
+        double MaxReleaseLatency = 0;
+    };
+
     // clang-format off
     ResourceReleaseQueue(IMemoryAllocator& Allocator) :
-        m_ReleaseQueue  (STD_ALLOCATOR_RAW_MEM(ReleaseQueueElemType, Allocator, "Allocator for deque<ReleaseQueueElemType>")),
-        m_StaleResources(STD_ALLOCATOR_RAW_MEM(ReleaseQueueElemType, Allocator, "Allocator for deque<ReleaseQueueElemType>"))
+        m_NodeAllocator (Allocator, sizeof(Node), 256, FixedBlockAllocatorMode::ThreadCaching),
+        m_ReleaseQueue  (STD_ALLOCATOR_RAW_MEM(ReleaseBucket, Allocator, "Allocator for deque<ReleaseBucket>"))
     {}
     // clang-format on
 
+    // clang-format off
+    ResourceReleaseQueue             (const ResourceReleaseQueue&)  = delete;
+    ResourceReleaseQueue             (      ResourceReleaseQueue&&) = delete;
+    ResourceReleaseQueue& operator = (const ResourceReleaseQueue&)  = delete;
+    ResourceReleaseQueue& operator = (      ResourceReleaseQueue&&) = delete;
+    // clang-format on
+
     ~ResourceReleaseQueue()
     {
-        DEV_CHECK_ERR(m_StaleResources.empty(), "Not all stale objects were destroyed");
-        DEV_CHECK_ERR(m_ReleaseQueue.empty(), "Release queue is not empty");
+        DEV_CHECK_ERR(GetStaleResourceCount() == 0, "Not all stale objects were destroyed");
+        DEV_CHECK_ERR(GetPendingReleaseResourceCount() == 0, "Release queue is not empty");
+
+        m_StaleResources.Append(TakeNodes(m_StaleHead));
+        m_StaleResources.Append(TakeNodes(m_DiscardedHead));
+        DestroyNodes(m_StaleResources);
+        for (auto& Bucket : m_ReleaseQueue)
+            DestroyNodes(Bucket.Nodes);
     }
 
     /// Creates a resource wrapper for the specific resource type
@@ -257,8 +372,9 @@ public:
     /// \param [in] NextCommandListNumber - Number of the command list that will be submitted to the queue next
     void SafeReleaseResource(ResourceWrapperType&& Wrapper, Uint64 NextCommandListNumber)
     {
-        std::lock_guard<std::mutex> LockGuard(m_StaleObjectsMutex);
-        m_StaleResources.emplace_back(NextCommandListNumber, std::move(Wrapper));
+        auto* pNode = CreateNode(NextCommandListNumber, std::move(Wrapper));
+        m_NumStaleResources.fetch_add(1, std::memory_order_relaxed);
+        PushNodes(m_StaleHead, pNode, pNode);
     }
 
     /// Moves a copy of the resource wrapper to the stale resources queue
@@ -266,8 +382,9 @@ public:
     /// \param [in] NextCommandListNumber - Number of the command list that will be submitted to the queue next
     void SafeReleaseResource(const ResourceWrapperType& Wrapper, Uint64 NextCommandListNumber)
     {
-        std::lock_guard<std::mutex> LockGuard(m_StaleObjectsMutex);
-        m_StaleResources.emplace_back(NextCommandListNumber, Wrapper);
+        auto* pNode = CreateNode(NextCommandListNumber, Wrapper);
+        m_NumStaleResources.fetch_add(1, std::memory_order_relaxed);
+        PushNodes(m_StaleHead, pNode, pNode);
     }
 
     /// Adds a resource directly to the release queue
@@ -284,8 +401,9 @@ public:
     /// \param [in] FenceValue  - Fence value indicating when the resource was used last time.
     void DiscardResource(ResourceWrapperType&& Wrapper, Uint64 FenceValue)
     {
-        std::lock_guard<std::mutex> ReleaseQueueLock(m_ReleaseQueueMutex);
-        m_ReleaseQueue.emplace_back(FenceValue, std::move(Wrapper));
+        auto* pNode = CreateNode(FenceValue, std::move(Wrapper));
+        m_NumPendingReleaseResources.fetch_add(1, std::memory_order_relaxed);
+        PushNodes(m_DiscardedHead, pNode, pNode);
     }
 
     /// Adds a copy of the resource wrapper directly to the release queue
@@ -293,8 +411,9 @@ public:
     /// \param [in] FenceValue  - Fence value indicating when the resource was used last time.
     void DiscardResource(const ResourceWrapperType& Wrapper, Uint64 FenceValue)
     {
-        std::lock_guard<std::mutex> ReleaseQueueLock(m_ReleaseQueueMutex);
-        m_ReleaseQueue.emplace_back(FenceValue, Wrapper);
+        auto* pNode = CreateNode(FenceValue, Wrapper);
+        m_NumPendingReleaseResources.fetch_add(1, std::memory_order_relaxed);
+        PushNodes(m_DiscardedHead, pNode, pNode);
     }
 
     /// Adds multiple resources directly to the release queue
@@ -303,11 +422,26 @@ public:
     template <typename ResourceType, typename IteratorType>
     void DiscardResources(Uint64 FenceValue, IteratorType Iterator)
     {
-        std::lock_guard<std::mutex> ReleaseQueueLock(m_ReleaseQueueMutex);
-        ResourceType                Resource;
+        // Build the chain locally and publish it with a single operation.
+        // The lists are kept in reverse order, so every new node is added to the front.
+        Node*        pFirst   = nullptr;
+        Node*        pLast    = nullptr;
+        size_t       NumNodes = 0;
+        ResourceType Resource;
         while (Iterator(Resource))
         {
-            m_ReleaseQueue.emplace_back(FenceValue, CreateWrapper(std::move(Resource), 1));
+            auto* pNode  = CreateNode(FenceValue, CreateWrapper(std::move(Resource), 1));
+            pNode->pNext = pFirst;
+            pFirst       = pNode;
+            if (pLast == nullptr)
+                pLast = pNode;
+            ++NumNodes;
+        }
+
+        if (pFirst != nullptr)
+        {
+            m_NumPendingReleaseResources.fetch_add(NumNodes, std::memory_order_relaxed);
+            PushNodes(m_DiscardedHead, pFirst, pLast);
         }
     }
 
@@ -320,20 +454,28 @@ public:
     ///                                      is greater or equal to the fence value associated with the resource
     void DiscardStaleResources(Uint64 SubmittedCmdBuffNumber, Uint64 FenceValue)
     {
-        // Only discard these stale objects that were released before CmdBuffNumber
-        // was executed
-        std::lock_guard<std::mutex> StaleObjectsLock(m_StaleObjectsMutex);
         std::lock_guard<std::mutex> ReleaseQueueLock(m_ReleaseQueueMutex);
-        while (!m_StaleResources.empty())
+
+        m_StaleResources.Append(TakeNodes(m_StaleHead));
+
+        // Only discard these stale objects that were released before CmdBuffNumber
+        // was executed. Objects released by the same thread are never reordered.
+        NodeList Discarded;
+        NodeList Remaining;
+        while (Node* pNode = m_StaleResources.PopFront())
         {
-            auto& FirstStaleObj = m_StaleResources.front();
-            if (FirstStaleObj.first <= SubmittedCmdBuffNumber)
-            {
-                m_ReleaseQueue.emplace_back(FenceValue, std::move(FirstStaleObj.second));
-                m_StaleResources.pop_front();
-            }
+            if (pNode->Value <= SubmittedCmdBuffNumber)
+                Discarded.PushBack(pNode);
             else
-                break;
+                Remaining.PushBack(pNode);
+        }
+        m_StaleResources = Remaining;
+
+        if (Discarded.Count != 0)
+        {
+            m_NumStaleResources.fetch_sub(Discarded.Count, std::memory_order_relaxed);
+            m_NumPendingReleaseResources.fetch_add(Discarded.Count, std::memory_order_relaxed);
+            AddToReleaseQueue(FenceValue, Discarded);
         }
     }
 
@@ -343,39 +485,245 @@ public:
     /// \param [in] CompletedFenceValue  -  Value of the fence that has been completed by the GPU
     void Purge(Uint64 CompletedFenceValue)
     {
-        std::lock_guard<std::mutex> LockGuard(m_ReleaseQueueMutex);
-
-        // Release all objects whose associated fence value is at most CompletedFenceValue
-        // See http://diligentgraphics.com/diligent-engine/architecture/d3d12/managing-resource-lifetimes/
-        while (!m_ReleaseQueue.empty())
+        NodeList Completed;
+        Uint64   TotalLatency = 0;
+        Uint64   MaxLatency   = 0;
         {
-            auto& FirstObj = m_ReleaseQueue.front();
-            if (FirstObj.first <= CompletedFenceValue)
+            std::lock_guard<std::mutex> LockGuard(m_ReleaseQueueMutex);
+
+            // Distribute directly discarded objects between the buckets
+            NodeList Discarded = TakeNodes(m_DiscardedHead);
+            while (Node* pNode = Discarded.PopFront())
+            {
+                NodeList Single;
+                Single.PushBack(pNode);
+                AddToReleaseQueue(pNode->Value, Single);
+            }
+
+            // Release all objects whose associated fence value is at most CompletedFenceValue
+            // See http://diligentgraphics.com/diligent-engine/architecture/d3d12/managing-resource-lifetimes/
+            const Uint64 CurrTime = !m_ReleaseQueue.empty() ? GetTimeNs() : 0;
+            while (!m_ReleaseQueue.empty() && m_ReleaseQueue.front().FenceValue <= CompletedFenceValue)
+            {
+                auto& Bucket = m_ReleaseQueue.front();
+
+                const Uint64 Latency = CurrTime - std::min(Bucket.TimeNs, CurrTime);
+                TotalLatency += Latency * Bucket.Nodes.Count;
+                MaxLatency = std::max(MaxLatency, Latency);
+
+                Completed.Append(Bucket.Nodes);
                 m_ReleaseQueue.pop_front();
-            else
-                break;
+            }
+        }
+
+        // Destroy the objects outside of the lock
+        if (Completed.Count != 0)
+        {
+            m_NumPendingReleaseResources.fetch_sub(Completed.Count, std::memory_order_relaxed);
+            m_NumReleasedResources.fetch_add(Completed.Count, std::memory_order_relaxed);
+            m_TotalReleaseLatency.fetch_add(TotalLatency, std::memory_order_relaxed);
+            Uint64 PrevMaxLatency = m_MaxReleaseLatency.load(std::memory_order_relaxed);
+            while (PrevMaxLatency < MaxLatency && !m_MaxReleaseLatency.compare_exchange_weak(PrevMaxLatency, MaxLatency, std::memory_order_relaxed))
+            {
+            }
+            DestroyNodes(Completed);
         }
     }
 
     /// Returns the number of stale resources
     size_t GetStaleResourceCount() const
     {
-        return m_StaleResources.size();
+        return m_NumStaleResources.load(std::memory_order_relaxed);
     }
 
     /// Returns the number of resources pending release
     size_t GetPendingReleaseResourceCount() const
     {
-        return m_ReleaseQueue.size();
+        return m_NumPendingReleaseResources.load(std::memory_order_relaxed);
+    }
+
+    /// Returns the release queue statistics
+    Statistics GetStatistics() const
+    {
+        Statistics Stats;
+        Stats.NumStaleResources          = GetStaleResourceCount();
+        Stats.NumPendingReleaseResources = GetPendingReleaseResourceCount();
+        Stats.NumReleasedResources       = m_NumReleasedResources.load(std::memory_order_relaxed);
+        if (Stats.NumReleasedResources != 0)
+        {
+            const auto TotalLatency = m_TotalReleaseLatency.load(std::memory_order_relaxed);
+            Stats.AvgReleaseLatency = static_cast<double>(TotalLatency) / static_cast<double>(Stats.NumReleasedResources) * 1e-9;
+        }
+        Stats.MaxReleaseLatency = static_cast<double>(m_MaxReleaseLatency.load(std::memory_order_relaxed)) * 1e-9;
+        return Stats;
     }
 
 private:
+    static Uint64 GetTimeNs()
+    {
+        return static_cast<Uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    struct Node
+    {
+        template <typename WrapperType>
+        Node(Uint64 _Value, WrapperType&& _Wrapper) :
+            Value{_Value},
+            Wrapper{std::forward<WrapperType>(_Wrapper)}
+        {}
+
+        Node* pNext = nullptr;
+
+        // Command list number for stale resources, fence value for resources in the release queue
+        const Uint64 Value;
+
+        ResourceWrapperType Wrapper;
+    };
+
+    // Singly-linked FIFO list of nodes
+    struct NodeList
+    {
+        Node*  pFirst = nullptr;
+        Node*  pLast  = nullptr;
+        size_t Count  = 0;
+
+        void PushBack(Node* pNode)
+        {
+            pNode->pNext = nullptr;
+            if (pLast != nullptr)
+                pLast->pNext = pNode;
+            else
+                pFirst = pNode;
+            pLast = pNode;
+            ++Count;
+        }
+
+        Node* PopFront()
+        {
+            Node* pNode = pFirst;
+            if (pNode != nullptr)
+            {
+                pFirst = pNode->pNext;
+                if (pFirst == nullptr)
+                    pLast = nullptr;
+                --Count;
+            }
+            return pNode;
+        }
+
+        void Append(NodeList& List)
+        {
+            if (List.pFirst == nullptr)
+                return;
+            if (pLast != nullptr)
+                pLast->pNext = List.pFirst;
+            else
+                pFirst = List.pFirst;
+            pLast = List.pLast;
+            Count += List.Count;
+            List = NodeList{};
+        }
+
+        void Append(NodeList&& List)
+        {
+            Append(List);
+        }
+    };
+
+    // Pushes the chain of nodes [pFirst, pLast] onto the lock-free list
+    static void PushNodes(std::atomic<Node*>& Head, Node* pFirst, Node* pLast)
+    {
+        pLast->pNext = Head.load(std::memory_order_relaxed);
+        while (!Head.compare_exchange_weak(pLast->pNext, pFirst, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    // Takes all nodes from the lock-free list. Since the nodes are only ever popped all at once,
+    // the list is not prone to the ABA problem.
+    static NodeList TakeNodes(std::atomic<Node*>& Head)
+    {
+        Node* pNode = Head.exchange(nullptr, std::memory_order_acquire);
+
+        // The list is in reverse order - restore the order in which the nodes were added
+        NodeList List;
+        List.pLast = pNode;
+        while (pNode != nullptr)
+        {
+            Node* pNext  = pNode->pNext;
+            pNode->pNext = List.pFirst;
+            List.pFirst  = pNode;
+            pNode        = pNext;
+            ++List.Count;
+        }
+        return List;
+    }
+
+    template <typename WrapperType>
+    Node* CreateNode(Uint64 Value, WrapperType&& Wrapper)
+    {
+        void* pRawMem = m_NodeAllocator.Allocate(sizeof(Node), "Release queue node", __FILE__, __LINE__);
+        return new (pRawMem) Node{Value, std::forward<WrapperType>(Wrapper)};
+    }
+
+    void DestroyNodes(NodeList& List)
+    {
+        while (Node* pNode = List.PopFront())
+        {
+            pNode->~Node();
+            m_NodeAllocator.Free(pNode);
+        }
+    }
+
+    // Adds the nodes to the bucket with the given fence value. Buckets are sorted by fence values.
+    // Must be called with m_ReleaseQueueMutex locked.
+    void AddToReleaseQueue(Uint64 FenceValue, NodeList& Nodes)
+    {
+        // Fence values almost always grow, so start searching from the back
+        auto it = m_ReleaseQueue.end();
+        while (it != m_ReleaseQueue.begin() && std::prev(it)->FenceValue > FenceValue)
+            --it;
+
+        if (it != m_ReleaseQueue.begin() && std::prev(it)->FenceValue == FenceValue)
+            std::prev(it)->Nodes.Append(Nodes);
+        else
+            m_ReleaseQueue.emplace(it, FenceValue)->Nodes.Append(Nodes);
+    }
+
+    struct ReleaseBucket
+    {
+        explicit ReleaseBucket(Uint64 _FenceValue) :
+            FenceValue{_FenceValue}
+        {}
+
+        Uint64   FenceValue;
+        NodeList Nodes;
+
+        // Time when the bucket was added to the release queue
+        Uint64 TimeNs = GetTimeNs();
+    };
+
+    // Allocates the nodes from the memory allocator passed to the constructor
+    FixedBlockMemoryAllocator m_NodeAllocator;
+
+    // Lock-free lists of nodes added by SafeReleaseResource() and DiscardResource()
+    std::atomic<Node*> m_StaleHead{nullptr};
+    std::atomic<Node*> m_DiscardedHead{nullptr};
+
+    std::atomic<size_t> m_NumStaleResources{0};
+    std::atomic<size_t> m_NumPendingReleaseResources{0};
+
+    std::atomic<Uint64> m_NumReleasedResources{0};
+    std::atomic<Uint64> m_TotalReleaseLatency{0};
+    std::atomic<Uint64> m_MaxReleaseLatency{0};
+
+    // Protects m_StaleResources and m_ReleaseQueue
     std::mutex m_ReleaseQueueMutex;
-    using ReleaseQueueElemType = std::pair<Uint64, ResourceWrapperType>;
-    std::deque<ReleaseQueueElemType, STDAllocatorRawMem<ReleaseQueueElemType>> m_ReleaseQueue;
 
-    std::mutex                                                                 m_StaleObjectsMutex;
-    std::deque<ReleaseQueueElemType, STDAllocatorRawMem<ReleaseQueueElemType>> m_StaleResources;
+    // Stale resources whose command list has not been submitted yet
+    NodeList m_StaleResources;
+
+    std::deque<ReleaseBucket, STDAllocatorRawMem<ReleaseBucket>> m_ReleaseQueue;
 };
 
 } // namespace Diligent
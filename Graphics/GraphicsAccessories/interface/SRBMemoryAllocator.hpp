@@ -49,6 +49,10 @@ public:
                     Uint32              ResourceCacheDataAllocatorCount,
                     const size_t* const ResourceCacheDataSizes);
 
+    /// Prepares memory for NumSRBs shader resource binding objects that will be
+    /// created by the calling thread, see FixedBlockMemoryAllocator::Prefetch().
+    void Prefetch(Uint32 NumSRBs);
+
     IMemoryAllocator& GetShaderVariableDataAllocator(Uint32 Ind)
     {
         VERIFY_EXPR(m_DataAllocators == nullptr || Ind < m_ShaderVariableDataAllocatorCount);
@@ -64,11 +68,14 @@ public:
 private:
     IMemoryAllocator& m_RawMemAllocator;
 
-    // Fixed-block allocators for every shader stage
+    // Thread-caching fixed-block allocators for every shader stage
     FixedBlockMemoryAllocator* m_DataAllocators = nullptr;
 
     Uint32 m_ShaderVariableDataAllocatorCount = 0;
     Uint32 m_ResourceCacheDataAllocatorCount  = 0;
+
+    // Bit mask of the allocators that have non-zero block size and will actually be used
+    Uint32 m_NonEmptyAllocatorMask = 0;
 };
 
 } // namespace Diligent
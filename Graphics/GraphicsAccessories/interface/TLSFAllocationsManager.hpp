@@ -0,0 +1,716 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+// Helper class that handles free memory block management using the two-level segregated fit (TLSF) algorithm
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+#include "../../../../../MultiTouch/DiligentLog/Primitives/interface/MemoryAllocator.h"
+#include "../../../../../MultiTouch/DiligentLog/Platforms/Basic/interface/DebugUtilities.hpp"
+#include "../../../../../MultiTouch/DiligentLog/Platforms/interface/PlatformMisc.hpp"
+#include "../../../Common/interface/Align.hpp"
+#include "../../../Common/interface/STDAllocator.hpp"
+#include "VariableSizeAllocationsManager.hpp"
+
+namespace Diligent
+{
+// The class is a drop-in replacement for VariableSizeAllocationsManager that performs allocations and
+// deallocations in constant time. Like VariableSizeAllocationsManager, it only keeps track of free blocks
+// and uses the same Allocation structure and alignment rules.
+//
+// Free blocks are kept in segregated lists. The first-level index is the position of the most significant
+// bit of the block size, and the second-level index linearly subdivides every power-of-two range into
+// SLCount lists. Two bitmaps record which lists are not empty, so that a suitable list is found with
+// a couple of bit scans:
+//
+//      FL bitmap      0  1  1  0  ...
+//                        |  |
+//      SL bitmaps        |  '--> 0 1 0 0 ... 0
+//                        |         |
+//                        '-----> 0 0 ... 1   '--> [Offset=64, Size=40] <--> [Offset=512, Size=36]
+//
+// Allocate() rounds the requested size up to the next list boundary, so that any block in the list found is
+// large enough (good fit rather than best fit). Block descriptions are stored in a pool indexed by 32-bit
+// handles. Two open-addressing hash tables map block start and end offsets to the blocks to find physical
+// neighbors in Free(). Storage only grows when the number of free blocks exceeds the previous maximum,
+// so there are no per-block heap allocations.
+class TLSFAllocationsManager
+{
+public:
+    using OffsetType = VariableSizeAllocationsManager::OffsetType;
+    using Allocation = VariableSizeAllocationsManager::Allocation;
+
+private:
+    static constexpr Uint32 InvalidIndex = ~Uint32{0};
+
+    // Log2 of the number of second-level lists
+    static constexpr Uint32 SLBits  = 5;
+    static constexpr Uint32 SLCount = 1u << SLBits;
+    static constexpr Uint32 FLCount = sizeof(OffsetType) * 8 - SLBits + 1;
+
+    struct FreeBlockInfo
+    {
+        OffsetType Offset = 0;
+        OffsetType Size   = 0;
+
+        // Links in the segregated free list. For unused pool entries, NextFree links the list of unused entries.
+        Uint32 PrevFree = InvalidIndex;
+        Uint32 NextFree = InvalidIndex;
+    };
+
+    // Open-addressing hash table with linear probing that maps offsets to block indices
+    class OffsetHashTable
+    {
+    public:
+        OffsetHashTable(IMemoryAllocator& Allocator) :
+            m_Slots(STD_ALLOCATOR_RAW_MEM(Slot, Allocator, "Allocator for vector<OffsetHashTable::Slot>"))
+        {}
+
+        // clang-format off
+        OffsetHashTable(OffsetHashTable&& rhs) noexcept :
+            m_Slots   {std::move(rhs.m_Slots)},
+            m_Count   {rhs.m_Count           },
+            m_Log2Size{rhs.m_Log2Size        }
+        {
+            // clang-format on
+            rhs.Clear();
+        }
+
+        OffsetHashTable& operator=(OffsetHashTable&& rhs) noexcept
+        {
+            m_Slots    = std::move(rhs.m_Slots);
+            m_Count    = rhs.m_Count;
+            m_Log2Size = rhs.m_Log2Size;
+            rhs.Clear();
+            return *this;
+        }
+
+        void Clear()
+        {
+            m_Slots.clear();
+            m_Count    = 0;
+            m_Log2Size = 0;
+        }
+
+        Uint32 Find(OffsetType Key) const
+        {
+            if (m_Slots.empty())
+                return InvalidIndex;
+
+            const auto Mask = m_Slots.size() - 1;
+            for (auto i = GetHomeSlot(Key);; i = (i + 1) & Mask)
+            {
+                const auto& S = m_Slots[i];
+                if (S.BlockIdx == InvalidIndex)
+                    return InvalidIndex;
+                if (S.Key == Key)
+                    return S.BlockIdx;
+            }
+        }
+
+        void Insert(OffsetType Key, Uint32 BlockIdx)
+        {
+            VERIFY_EXPR(BlockIdx != InvalidIndex);
+            // Keep load factor below 3/4
+            if ((m_Count + 1) * 4 > m_Slots.size() * 3)
+                Rehash(std::max(m_Slots.size() * 2, size_t{64}));
+
+            const auto Mask = m_Slots.size() - 1;
+            auto       i    = GetHomeSlot(Key);
+            while (m_Slots[i].BlockIdx != InvalidIndex)
+            {
+                VERIFY(m_Slots[i].Key != Key, "Offset ", Key, " is already in the table");
+                i = (i + 1) & Mask;
+            }
+            m_Slots[i] = Slot{Key, BlockIdx};
+            ++m_Count;
+        }
+
+        void Erase(OffsetType Key)
+        {
+            VERIFY_EXPR(!m_Slots.empty());
+            const auto Mask = m_Slots.size() - 1;
+
+            auto i = GetHomeSlot(Key);
+            while (m_Slots[i].Key != Key)
+            {
+                if (m_Slots[i].BlockIdx == InvalidIndex)
+                {
+                    UNEXPECTED("Offset ", Key, " is not found in the table");
+                    return;
+                }
+                i = (i + 1) & Mask;
+            }
+
+            // Shift subsequent entries of the probe sequence back to keep it contiguous
+            for (auto j = (i + 1) & Mask; m_Slots[j].BlockIdx != InvalidIndex; j = (j + 1) & Mask)
+            {
+                const auto Home = GetHomeSlot(m_Slots[j].Key);
+                // Move the entry if its home slot is not cyclically in (i, j]
+                if ((i <= j) ? (Home <= i || Home > j) : (Home <= i && Home > j))
+                {
+                    m_Slots[i] = m_Slots[j];
+                    i          = j;
+                }
+            }
+            m_Slots[i] = Slot{};
+            --m_Count;
+        }
+
+        size_t GetCount() const { return m_Count; }
+
+    private:
+        struct Slot
+        {
+            OffsetType Key      = 0;
+            Uint32     BlockIdx = InvalidIndex;
+        };
+
+        size_t GetHomeSlot(OffsetType Key) const
+        {
+            // Fibonacci hashing
+            return static_cast<size_t>((static_cast<Uint64>(Key) * 0x9E3779B97F4A7C15ull) >> (64 - m_Log2Size));
+        }
+
+        void Rehash(size_t NewSize)
+        {
+            VERIFY_EXPR(IsPowerOfTwo(NewSize));
+            decltype(m_Slots) OldSlots(NewSize, Slot{}, m_Slots.get_allocator());
+            OldSlots.swap(m_Slots);
+            m_Log2Size = PlatformMisc::GetMSB(static_cast<Uint64>(NewSize));
+            m_Count    = 0;
+            for (const auto& S : OldSlots)
+            {
+                if (S.BlockIdx != InvalidIndex)
+                    Insert(S.Key, S.BlockIdx);
+            }
+        }
+
+        std::vector<Slot, STDAllocatorRawMem<Slot>> m_Slots;
+
+        size_t m_Count    = 0;
+        Uint32 m_Log2Size = 0;
+    };
+
+public:
+    TLSFAllocationsManager(OffsetType MaxSize, IMemoryAllocator& Allocator) :
+        m_Blocks(STD_ALLOCATOR_RAW_MEM(FreeBlockInfo, Allocator, "Allocator for vector<FreeBlockInfo>")),
+        m_BlocksByStart{Allocator},
+        m_BlocksByEnd{Allocator},
+        m_MaxSize{MaxSize},
+        m_FreeSize{MaxSize}
+    {
+        ResetFreeLists();
+
+        // Insert single maximum-size block
+        if (MaxSize > 0)
+            AddNewBlock(0, m_MaxSize);
+        ResetCurrAlignment();
+
+#ifdef DILIGENT_DEBUG
+        DbgVerifyList();
+#endif
+    }
+
+    ~TLSFAllocationsManager()
+    {
+#ifdef DILIGENT_DEBUG
+        if (m_NumFreeBlocks != 0)
+        {
+            VERIFY(m_NumFreeBlocks == 1, "Single free block is expected");
+            const auto BlockIdx = m_BlocksByStart.Find(0);
+            VERIFY(BlockIdx != InvalidIndex, "Head chunk offset is expected to be 0");
+            VERIFY(BlockIdx == InvalidIndex || m_Blocks[BlockIdx].Size == m_MaxSize, "Head chunk size is expected to be ", m_MaxSize);
+        }
+#endif
+    }
+
+    // clang-format off
+    TLSFAllocationsManager(TLSFAllocationsManager&& rhs) noexcept :
+        m_Blocks          {std::move(rhs.m_Blocks)       },
+        m_BlocksByStart   {std::move(rhs.m_BlocksByStart)},
+        m_BlocksByEnd     {std::move(rhs.m_BlocksByEnd)  },
+        m_UnusedBlocks    {rhs.m_UnusedBlocks      },
+        m_NumFreeBlocks   {rhs.m_NumFreeBlocks     },
+        m_FLBitmap        {rhs.m_FLBitmap          },
+        m_MaxSize         {rhs.m_MaxSize           },
+        m_FreeSize        {rhs.m_FreeSize          },
+        m_CurrAlignment   {rhs.m_CurrAlignment     }
+    {
+        // clang-format on
+        std::copy(std::begin(rhs.m_SLBitmaps), std::end(rhs.m_SLBitmaps), m_SLBitmaps);
+        std::copy(&rhs.m_FreeLists[0][0], &rhs.m_FreeLists[0][0] + FLCount * SLCount, &m_FreeLists[0][0]);
+
+        rhs.m_Blocks.clear();
+        rhs.m_UnusedBlocks  = InvalidIndex;
+        rhs.m_NumFreeBlocks = 0;
+        rhs.m_MaxSize       = 0;
+        rhs.m_FreeSize      = 0;
+        rhs.m_CurrAlignment = 0;
+        rhs.ResetFreeLists();
+    }
+
+    TLSFAllocationsManager& operator=(TLSFAllocationsManager&& rhs) noexcept
+    {
+        if (this == &rhs)
+            return *this;
+
+        m_Blocks        = std::move(rhs.m_Blocks);
+        m_BlocksByStart = std::move(rhs.m_BlocksByStart);
+        m_BlocksByEnd   = std::move(rhs.m_BlocksByEnd);
+        m_UnusedBlocks  = rhs.m_UnusedBlocks;
+        m_NumFreeBlocks = rhs.m_NumFreeBlocks;
+        m_FLBitmap      = rhs.m_FLBitmap;
+        m_MaxSize       = rhs.m_MaxSize;
+        m_FreeSize      = rhs.m_FreeSize;
+        m_CurrAlignment = rhs.m_CurrAlignment;
+        std::copy(std::begin(rhs.m_SLBitmaps), std::end(rhs.m_SLBitmaps), m_SLBitmaps);
+        std::copy(&rhs.m_FreeLists[0][0], &rhs.m_FreeLists[0][0] + FLCount * SLCount, &m_FreeLists[0][0]);
+
+        rhs.m_Blocks.clear();
+        rhs.m_UnusedBlocks  = InvalidIndex;
+        rhs.m_NumFreeBlocks = 0;
+        rhs.m_MaxSize       = 0;
+        rhs.m_FreeSize      = 0;
+        rhs.m_CurrAlignment = 0;
+        rhs.ResetFreeLists();
+
+        return *this;
+    }
+
+    // clang-format off
+    TLSFAllocationsManager             (const TLSFAllocationsManager&) = delete;
+    TLSFAllocationsManager& operator = (const TLSFAllocationsManager&) = delete;
+    // clang-format on
+
+    Allocation Allocate(OffsetType Size, OffsetType Alignment)
+    {
+        VERIFY_EXPR(Size > 0);
+        VERIFY(IsPowerOfTwo(Alignment), "Alignment (", Alignment, ") must be power of 2");
+        Size = AlignUp(Size, Alignment);
+        if (m_FreeSize < Size)
+            return Allocation::InvalidAllocation();
+
+        auto AlignmentReserve = (Alignment > m_CurrAlignment) ? Alignment - m_CurrAlignment : 0;
+
+        const auto BlockIdx = FindFreeBlock(Size + AlignmentReserve);
+        if (BlockIdx == InvalidIndex)
+            return Allocation::InvalidAllocation();
+
+        VERIFY_EXPR(Size + AlignmentReserve <= m_Blocks[BlockIdx].Size);
+        VERIFY_EXPR(m_Blocks[BlockIdx].Offset % m_CurrAlignment == 0);
+        VERIFY_EXPR(AlignUp(m_Blocks[BlockIdx].Offset, Alignment) - m_Blocks[BlockIdx].Offset <= AlignmentReserve);
+
+        return AllocateFromBlock(BlockIdx, Size, Alignment);
+    }
+
+    // Allocates space from the free block with the lowest offset that can accommodate the
+    // request and ends at or before EndOffset. Unlike Allocate(), the method runs in time
+    // linear in the number of free blocks and is intended for compacting the space.
+    Allocation AllocateFirstFit(OffsetType Size, OffsetType Alignment, OffsetType EndOffset = Allocation::InvalidOffset)
+    {
+        VERIFY_EXPR(Size > 0);
+        VERIFY(IsPowerOfTwo(Alignment), "Alignment (", Alignment, ") must be power of 2");
+        Size = AlignUp(Size, Alignment);
+        if (m_FreeSize < Size)
+            return Allocation::InvalidAllocation();
+
+        auto BestIdx = InvalidIndex;
+        for (Uint32 BlockIdx = 0; BlockIdx < m_Blocks.size(); ++BlockIdx)
+        {
+            const auto& Block = m_Blocks[BlockIdx];
+            // Unused entries have zero size
+            if (Block.Size == 0 || (BestIdx != InvalidIndex && Block.Offset > m_Blocks[BestIdx].Offset))
+                continue;
+
+            const auto AlignedEnd = AlignUp(Block.Offset, Alignment) + Size;
+            if (AlignedEnd <= EndOffset && AlignedEnd <= Block.Offset + Block.Size)
+                BestIdx = BlockIdx;
+        }
+
+        return BestIdx != InvalidIndex ?
+            AllocateFromBlock(BestIdx, Size, Alignment) :
+            Allocation::InvalidAllocation();
+    }
+
+private:
+    Allocation AllocateFromBlock(Uint32 BlockIdx, OffsetType Size, OffsetType Alignment)
+    {
+        const auto Offset    = m_Blocks[BlockIdx].Offset;
+        const auto BlockSize = m_Blocks[BlockIdx].Size;
+
+        auto AlignedOffset = AlignUp(Offset, Alignment);
+        auto AdjustedSize  = Size + (AlignedOffset - Offset);
+        VERIFY_EXPR(AdjustedSize <= BlockSize);
+
+        RemoveBlock(BlockIdx);
+        if (BlockSize > AdjustedSize)
+        {
+            AddNewBlock(Offset + AdjustedSize, BlockSize - AdjustedSize);
+        }
+
+        m_FreeSize -= AdjustedSize;
+
+        if ((Size & (m_CurrAlignment - 1)) != 0)
+        {
+            if (IsPowerOfTwo(Size))
+            {
+                VERIFY_EXPR(Size >= Alignment && Size < m_CurrAlignment);
+                m_CurrAlignment = Size;
+            }
+            else
+            {
+                m_CurrAlignment = std::min(m_CurrAlignment, Alignment);
+            }
+        }
+
+#ifdef DILIGENT_DEBUG
+        DbgVerifyList();
+#endif
+        return Allocation{Offset, AdjustedSize};
+    }
+
+public:
+    void Free(Allocation&& allocation)
+    {
+        VERIFY_EXPR(allocation.IsValid());
+        Free(allocation.UnalignedOffset, allocation.Size);
+        allocation = Allocation{};
+    }
+
+    void Free(OffsetType Offset, OffsetType Size)
+    {
+        VERIFY_EXPR(Offset != Allocation::InvalidOffset && Offset + Size <= m_MaxSize);
+        VERIFY(m_BlocksByStart.Find(Offset) == InvalidIndex, "Block at offset ", Offset, " is already free");
+
+        auto NewOffset = Offset;
+        auto NewSize   = Size;
+
+        //   PrevBlock.Offset           Offset
+        //     |                          |
+        //     |<-----PrevBlock.Size----->|<------Size-------->|
+        //
+        const auto PrevBlockIdx = m_BlocksByEnd.Find(Offset);
+        if (PrevBlockIdx != InvalidIndex)
+        {
+            NewOffset = m_Blocks[PrevBlockIdx].Offset;
+            NewSize += m_Blocks[PrevBlockIdx].Size;
+            RemoveBlock(PrevBlockIdx);
+        }
+
+        //                     Offset            NextBlock.Offset
+        //                       |                    |
+        //                       |<------Size-------->|<-----NextBlock.Size----->|
+        //
+        const auto NextBlockIdx = m_BlocksByStart.Find(Offset + Size);
+        if (NextBlockIdx != InvalidIndex)
+        {
+            NewSize += m_Blocks[NextBlockIdx].Size;
+            RemoveBlock(NextBlockIdx);
+        }
+
+        AddNewBlock(NewOffset, NewSize);
+
+        m_FreeSize += Size;
+        if (IsEmpty())
+        {
+            // Reset current alignment
+            VERIFY_EXPR(GetNumFreeBlocks() == 1);
+            ResetCurrAlignment();
+        }
+
+#ifdef DILIGENT_DEBUG
+        DbgVerifyList();
+#endif
+    }
+
+    // clang-format off
+    bool IsFull() const{ return m_FreeSize==0; };
+    bool IsEmpty()const{ return m_FreeSize==m_MaxSize; };
+    OffsetType GetMaxSize() const{return m_MaxSize;}
+    OffsetType GetFreeSize()const{return m_FreeSize;}
+    OffsetType GetUsedSize()const{return m_MaxSize - m_FreeSize;}
+    // clang-format on
+
+    size_t GetNumFreeBlocks() const
+    {
+        return m_NumFreeBlocks;
+    }
+
+    OffsetType GetLargestFreeBlockSize() const
+    {
+        if (m_FLBitmap == 0)
+            return 0;
+
+        // The largest block is in the highest non-empty list
+        const auto FL = PlatformMisc::GetMSB(m_FLBitmap);
+        const auto SL = PlatformMisc::GetMSB(m_SLBitmaps[FL]);
+
+        OffsetType MaxSize = 0;
+        for (auto BlockIdx = m_FreeLists[FL][SL]; BlockIdx != InvalidIndex; BlockIdx = m_Blocks[BlockIdx].NextFree)
+            MaxSize = std::max(MaxSize, m_Blocks[BlockIdx].Size);
+        return MaxSize;
+    }
+
+    void Extend(size_t ExtraSize)
+    {
+        size_t NewBlockOffset = m_MaxSize;
+        size_t NewBlockSize   = ExtraSize;
+
+        const auto LastBlockIdx = m_BlocksByEnd.Find(m_MaxSize);
+        if (LastBlockIdx != InvalidIndex)
+        {
+            // Extend the last block
+            NewBlockOffset = m_Blocks[LastBlockIdx].Offset;
+            NewBlockSize += m_Blocks[LastBlockIdx].Size;
+            RemoveBlock(LastBlockIdx);
+        }
+
+        AddNewBlock(NewBlockOffset, NewBlockSize);
+
+        m_MaxSize += ExtraSize;
+        m_FreeSize += ExtraSize;
+
+#ifdef DILIGENT_DEBUG
+        DbgVerifyList();
+#endif
+    }
+
+private:
+    // Returns the list that contains blocks of the given size
+    static void MapSizeToList(OffsetType Size, Uint32& FL, Uint32& SL)
+    {
+        if (Size < SLCount)
+        {
+            FL = 0;
+            SL = static_cast<Uint32>(Size);
+        }
+        else
+        {
+            const auto MSB = PlatformMisc::GetMSB(static_cast<Uint64>(Size));
+            FL             = MSB - SLBits + 1;
+            SL             = static_cast<Uint32>(Size >> (MSB - SLBits)) - SLCount;
+        }
+        VERIFY_EXPR(FL < FLCount && SL < SLCount);
+    }
+
+    Uint32 FindFreeBlock(OffsetType Size) const
+    {
+        // Round the size up to the next list boundary so that every block in the list is large enough
+        auto RoundedSize = Size;
+        if (Size >= SLCount)
+            RoundedSize += (OffsetType{1} << (PlatformMisc::GetMSB(static_cast<Uint64>(Size)) - SLBits)) - 1;
+
+        if (RoundedSize >= Size)
+        {
+            Uint32 FL = 0, SL = 0;
+            MapSizeToList(RoundedSize, FL, SL);
+
+            auto SLMap = m_SLBitmaps[FL] & (~Uint32{0} << SL);
+            if (SLMap == 0)
+            {
+                const auto FLMap = FL + 1 < 64 ? m_FLBitmap & (~Uint64{0} << (FL + 1)) : Uint64{0};
+                if (FLMap != 0)
+                {
+                    FL    = PlatformMisc::GetLSB(FLMap);
+                    SLMap = m_SLBitmaps[FL];
+                    VERIFY_EXPR(SLMap != 0);
+                }
+            }
+
+            if (SLMap != 0)
+            {
+                SL = PlatformMisc::GetLSB(SLMap);
+                VERIFY_EXPR(m_FreeLists[FL][SL] != InvalidIndex && m_Blocks[m_FreeLists[FL][SL]].Size >= Size);
+                return m_FreeLists[FL][SL];
+            }
+        }
+
+        // There are no lists that are guaranteed to satisfy the request, but the list that
+        // Size maps to may still contain a large enough block.
+        Uint32 FL = 0, SL = 0;
+        MapSizeToList(Size, FL, SL);
+        for (auto BlockIdx = m_FreeLists[FL][SL]; BlockIdx != InvalidIndex; BlockIdx = m_Blocks[BlockIdx].NextFree)
+        {
+            if (m_Blocks[BlockIdx].Size >= Size)
+                return BlockIdx;
+        }
+
+        return InvalidIndex;
+    }
+
+    void AddNewBlock(OffsetType Offset, OffsetType Size)
+    {
+        VERIFY_EXPR(Size > 0);
+
+        Uint32 BlockIdx = m_UnusedBlocks;
+        if (BlockIdx != InvalidIndex)
+        {
+            m_UnusedBlocks = m_Blocks[BlockIdx].NextFree;
+        }
+        else
+        {
+            BlockIdx = static_cast<Uint32>(m_Blocks.size());
+            m_Blocks.emplace_back();
+        }
+
+        auto& Block  = m_Blocks[BlockIdx];
+        Block.Offset = Offset;
+        Block.Size   = Size;
+
+        Uint32 FL = 0, SL = 0;
+        MapSizeToList(Size, FL, SL);
+        Block.PrevFree = InvalidIndex;
+        Block.NextFree = m_FreeLists[FL][SL];
+        if (Block.NextFree != InvalidIndex)
+            m_Blocks[Block.NextFree].PrevFree = BlockIdx;
+        m_FreeLists[FL][SL] = BlockIdx;
+        m_FLBitmap |= Uint64{1} << FL;
+        m_SLBitmaps[FL] |= 1u << SL;
+
+        m_BlocksByStart.Insert(Offset, BlockIdx);
+        m_BlocksByEnd.Insert(Offset + Size, BlockIdx);
+        ++m_NumFreeBlocks;
+    }
+
+    void RemoveBlock(Uint32 BlockIdx)
+    {
+        auto& Block = m_Blocks[BlockIdx];
+
+        Uint32 FL = 0, SL = 0;
+        MapSizeToList(Block.Size, FL, SL);
+        if (Block.PrevFree != InvalidIndex)
+        {
+            m_Blocks[Block.PrevFree].NextFree = Block.NextFree;
+        }
+        else
+        {
+            VERIFY_EXPR(m_FreeLists[FL][SL] == BlockIdx);
+            m_FreeLists[FL][SL] = Block.NextFree;
+            if (Block.NextFree == InvalidIndex)
+            {
+                m_SLBitmaps[FL] &= ~(1u << SL);
+                if (m_SLBitmaps[FL] == 0)
+                    m_FLBitmap &= ~(Uint64{1} << FL);
+            }
+        }
+        if (Block.NextFree != InvalidIndex)
+            m_Blocks[Block.NextFree].PrevFree = Block.PrevFree;
+
+        m_BlocksByStart.Erase(Block.Offset);
+        m_BlocksByEnd.Erase(Block.Offset + Block.Size);
+        VERIFY_EXPR(m_NumFreeBlocks > 0);
+        --m_NumFreeBlocks;
+
+        Block.Offset   = 0;
+        Block.Size     = 0;
+        Block.PrevFree = InvalidIndex;
+        Block.NextFree = m_UnusedBlocks;
+        m_UnusedBlocks = BlockIdx;
+    }
+
+    void ResetFreeLists()
+    {
+        m_FLBitmap = 0;
+        std::fill(std::begin(m_SLBitmaps), std::end(m_SLBitmaps), Uint32{0});
+        std::fill(&m_FreeLists[0][0], &m_FreeLists[0][0] + FLCount * SLCount, Uint32{InvalidIndex});
+    }
+
+    void ResetCurrAlignment()
+    {
+        for (m_CurrAlignment = 1; m_CurrAlignment * 2 <= m_MaxSize; m_CurrAlignment *= 2)
+        {}
+    }
+
+#ifdef DILIGENT_DEBUG
+    void DbgVerifyList()
+    {
+        OffsetType TotalFreeSize = 0;
+        size_t     NumBlocks     = 0;
+
+        VERIFY_EXPR(IsPowerOfTwo(m_CurrAlignment));
+        for (Uint32 FL = 0; FL < FLCount; ++FL)
+        {
+            VERIFY_EXPR(((m_FLBitmap >> FL) & 1) == (m_SLBitmaps[FL] != 0 ? 1 : 0));
+            for (Uint32 SL = 0; SL < SLCount; ++SL)
+            {
+                VERIFY_EXPR(((m_SLBitmaps[FL] >> SL) & 1) == (m_FreeLists[FL][SL] != InvalidIndex ? 1u : 0u));
+
+                auto PrevIdx = InvalidIndex;
+                for (auto BlockIdx = m_FreeLists[FL][SL]; BlockIdx != InvalidIndex; BlockIdx = m_Blocks[BlockIdx].NextFree)
+                {
+                    const auto& Block = m_Blocks[BlockIdx];
+                    VERIFY_EXPR(Block.PrevFree == PrevIdx);
+                    VERIFY_EXPR(Block.Offset + Block.Size <= m_MaxSize);
+
+                    Uint32 BlockFL = 0, BlockSL = 0;
+                    MapSizeToList(Block.Size, BlockFL, BlockSL);
+                    VERIFY(BlockFL == FL && BlockSL == SL, "Block is in the wrong list");
+
+                    VERIFY((Block.Offset & (m_CurrAlignment - 1)) == 0, "Block offset (", Block.Offset, ") is not ", m_CurrAlignment, "-aligned");
+                    if (Block.Offset + Block.Size < m_MaxSize)
+                        VERIFY((Block.Size & (m_CurrAlignment - 1)) == 0, "All block sizes except for the last one must be ", m_CurrAlignment, "-aligned");
+
+                    VERIFY_EXPR(m_BlocksByStart.Find(Block.Offset) == BlockIdx);
+                    VERIFY_EXPR(m_BlocksByEnd.Find(Block.Offset + Block.Size) == BlockIdx);
+                    VERIFY(m_BlocksByStart.Find(Block.Offset + Block.Size) == InvalidIndex, "Unmerged adjacent blocks detected");
+
+                    TotalFreeSize += Block.Size;
+                    ++NumBlocks;
+                    PrevIdx = BlockIdx;
+                }
+            }
+        }
+
+        VERIFY_EXPR(NumBlocks == m_NumFreeBlocks);
+        VERIFY_EXPR(m_BlocksByStart.GetCount() == m_NumFreeBlocks && m_BlocksByEnd.GetCount() == m_NumFreeBlocks);
+        VERIFY_EXPR(TotalFreeSize == m_FreeSize);
+    }
+#endif
+
+    std::vector<FreeBlockInfo, STDAllocatorRawMem<FreeBlockInfo>> m_Blocks;
+
+    OffsetHashTable m_BlocksByStart;
+    OffsetHashTable m_BlocksByEnd;
+
+    // Head of the list of unused entries in m_Blocks
+    Uint32 m_UnusedBlocks  = InvalidIndex;
+    size_t m_NumFreeBlocks = 0;
+
+    Uint64 m_FLBitmap = 0;
+    Uint32 m_SLBitmaps[FLCount];
+    Uint32 m_FreeLists[FLCount][SLCount];
+
+    OffsetType m_MaxSize       = 0;
+    OffsetType m_FreeSize      = 0;
+    OffsetType m_CurrAlignment = 0;
+    // When adding new members, do not forget to update move ctor
+};
+} // namespace Diligent
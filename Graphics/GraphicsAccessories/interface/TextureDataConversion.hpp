@@ -0,0 +1,124 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Declaration of Diligent::ConvertTextureData function
+
+#include "../../GraphicsEngine/interface/GraphicsTypes.h"
+
+namespace Diligent
+{
+
+/// Attributes of the ConvertTextureData() function
+struct TextureDataConversionAttribs
+{
+    /// Source data format.
+    TEXTURE_FORMAT SrcFormat = TEX_FORMAT_UNKNOWN;
+
+    /// Destination data format.
+    TEXTURE_FORMAT DstFormat = TEX_FORMAT_UNKNOWN;
+
+    /// The number of components in one source texel, or 0 to use the number of
+    /// components of the source format.
+
+    /// This allows describing data that does not have a matching texture format,
+    /// for instance, TEX_FORMAT_RGBA8_UNORM with 3 components describes tightly
+    /// packed 24-bit RGB data, and TEX_FORMAT_BGRA8_UNORM with 3 components
+    /// describes 24-bit BGR data.
+    Uint32 SrcComponentCount = 0;
+
+    /// The number of components in one destination texel, or 0 to use the number of
+    /// components of the destination format, see SrcComponentCount.
+    Uint32 DstComponentCount = 0;
+
+    /// Pointer to the source data.
+    const void* pSrcData = nullptr;
+
+    /// Source row stride in bytes. If zero, the rows are tightly packed.
+    Uint64 SrcStride = 0;
+
+    /// Source depth slice stride in bytes. If zero, the slices are tightly packed.
+    Uint64 SrcDepthStride = 0;
+
+    /// Pointer to the destination data.
+    void* pDstData = nullptr;
+
+    /// Destination row stride in bytes. If zero, the rows are tightly packed.
+    Uint64 DstStride = 0;
+
+    /// Destination depth slice stride in bytes. If zero, the slices are tightly packed.
+    Uint64 DstDepthStride = 0;
+
+    /// Region width, in texels.
+    Uint32 Width = 0;
+
+    /// Region height, in texels.
+    Uint32 Height = 1;
+
+    /// Region depth, in texels.
+    Uint32 Depth = 1;
+
+    /// The number of row ranges that are processed in parallel, see Diligent::ParallelForRanges().
+    Uint32 NumThreads = 1;
+};
+
+/// Checks if the data of the source format can be converted to the destination format
+/// by ConvertTextureData().
+
+/// Conversion is supported between all non-typeless formats with 8-, 16- and 32-bit
+/// UNORM, SNORM, UINT and SINT components, 8-bit sRGB components, and 16- and 32-bit
+/// floating-point components. Compressed, packed and depth-stencil formats are not supported.
+bool IsTextureDataConversionSupported(TEXTURE_FORMAT SrcFormat, TEXTURE_FORMAT DstFormat);
+
+/// Converts texture data from one format to another.
+
+/// \param [in] Attribs - Conversion attributes, see Diligent::TextureDataConversionAttribs.
+///
+/// \return     true if the data was converted successfully, and false otherwise.
+///
+/// \remarks    Every texel is converted as follows:
+///             - The texel is expanded to four components, where missing components are
+///               set to (0, 0, 0, 1). BGR(A) formats are read in RGBA order.
+///             - sRGB color components are converted to linear space; alpha is always linear.
+///             - Normalized values are clamped to the range of the destination format
+///               and rounded to the nearest representable value.
+///             - Integer values are converted numerically, for example UINT 5 becomes FLOAT 5.0.
+///               Conversion between two integer formats does not go through floating point,
+///               so all values are preserved exactly, and out-of-range values are clamped.
+///
+///             Rows of identical layouts are copied as is. Other common pairs have dedicated
+///             vectorized paths (SSE2/SSSE3/AVX2/F16C on x86, NEON on ARM) that produce the
+///             same results as the general path:
+///             - 8-bit RGB to RGBA and BGRA, and RGBA to BGRA swizzles;
+///             - 8-bit sRGB to and from 8-bit linear;
+///             - 8-bit UNORM, 8-bit sRGB and 16-bit UNORM to 32-bit float;
+///             - 32-bit float to and from 16-bit float.
+bool ConvertTextureData(const TextureDataConversionAttribs& Attribs);
+
+} // namespace Diligent
@@ -204,24 +204,54 @@ public:
         auto SmallestBlockIt = SmallestBlockItIt->second;
         VERIFY_EXPR(Size + AlignmentReserve <= SmallestBlockIt->second.Size);
         VERIFY_EXPR(SmallestBlockIt->second.Size == SmallestBlockItIt->first);
+        VERIFY_EXPR(SmallestBlockIt->first % m_CurrAlignment == 0);
+        VERIFY_EXPR(AlignUp(SmallestBlockIt->first, Alignment) - SmallestBlockIt->first <= AlignmentReserve);
 
-        //     SmallestBlockIt.Offset
+        return AllocateFromBlock(SmallestBlockIt, Size, Alignment);
+    }
+
+    // Allocates space from the free block with the lowest offset that can accommodate the
+    // request and ends at or before EndOffset. Unlike Allocate(), which looks for the
+    // best-fitting block, this method is intended for moving allocations towards the
+    // start of the space when compacting it.
+    Allocation AllocateFirstFit(OffsetType Size, OffsetType Alignment, OffsetType EndOffset = Allocation::InvalidOffset)
+    {
+        VERIFY_EXPR(Size > 0);
+        VERIFY(IsPowerOfTwo(Alignment), "Alignment (", Alignment, ") must be power of 2");
+        Size = AlignUp(Size, Alignment);
+        if (m_FreeSize < Size)
+            return Allocation::InvalidAllocation();
+
+        for (auto BlockIt = m_FreeBlocksByOffset.begin(); BlockIt != m_FreeBlocksByOffset.end() && BlockIt->first < EndOffset; ++BlockIt)
+        {
+            const auto AlignedEnd = AlignUp(BlockIt->first, Alignment) + Size;
+            if (AlignedEnd > EndOffset)
+                break;
+            if (AlignedEnd <= BlockIt->first + BlockIt->second.Size)
+                return AllocateFromBlock(BlockIt, Size, Alignment);
+        }
+
+        return Allocation::InvalidAllocation();
+    }
+
+private:
+    Allocation AllocateFromBlock(TFreeBlocksByOffsetMap::iterator BlockIt, OffsetType Size, OffsetType Alignment)
+    {
+        //       BlockIt.Offset
         //        |                                  |
-        //        |<------SmallestBlockIt.Size------>|
+        //        |<-----------BlockIt.Size--------->|
         //        |<------Size------>|<---NewSize--->|
         //        |                  |
         //      Offset              NewOffset
         //
-        auto Offset = SmallestBlockIt->first;
-        VERIFY_EXPR(Offset % m_CurrAlignment == 0);
+        auto Offset        = BlockIt->first;
         auto AlignedOffset = AlignUp(Offset, Alignment);
         auto AdjustedSize  = Size + (AlignedOffset - Offset);
-        VERIFY_EXPR(AdjustedSize <= Size + AlignmentReserve);
+        VERIFY_EXPR(AdjustedSize <= BlockIt->second.Size);
         auto NewOffset = Offset + AdjustedSize;
-        auto NewSize   = SmallestBlockIt->second.Size - AdjustedSize;
-        VERIFY_EXPR(SmallestBlockItIt == SmallestBlockIt->second.OrderBySizeIt);
-        m_FreeBlocksBySize.erase(SmallestBlockItIt);
-        m_FreeBlocksByOffset.erase(SmallestBlockIt);
+        auto NewSize   = BlockIt->second.Size - AdjustedSize;
+        m_FreeBlocksBySize.erase(BlockIt->second.OrderBySizeIt);
+        m_FreeBlocksByOffset.erase(BlockIt);
         if (NewSize > 0)
         {
             AddNewBlock(NewOffset, NewSize);
@@ -248,6 +278,7 @@ public:
         return Allocation{Offset, AdjustedSize};
     }
 
+public:
     void Free(Allocation&& allocation)
     {
         VERIFY_EXPR(allocation.IsValid());
@@ -364,6 +395,11 @@ public:
         return m_FreeBlocksByOffset.size();
     }
 
+    OffsetType GetLargestFreeBlockSize() const
+    {
+        return !m_FreeBlocksBySize.empty() ? m_FreeBlocksBySize.rbegin()->first : 0;
+    }
+
     void Extend(size_t ExtraSize)
     {
         size_t NewBlockOffset = m_MaxSize;
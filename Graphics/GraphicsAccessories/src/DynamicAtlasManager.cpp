@@ -28,6 +28,8 @@
 #include "DynamicAtlasManager.hpp"
 
 #include <climits>
+#include <algorithm>
+#include <numeric>
 
 #include "AdvancedMath.hpp"
 
@@ -36,6 +38,12 @@ namespace Diligent
 
 static const DynamicAtlasManager::Region InvalidRegion{UINT_MAX, UINT_MAX, 0, 0};
 
+// Key of a corner of a skyline free rectangle. The keys are ordered by y, then by x.
+static Uint64 SkylineCornerKey(Uint32 x, Uint32 y)
+{
+    return (Uint64{y} << 32u) | Uint64{x};
+}
+
 #if DILIGENT_DEBUG
 void DynamicAtlasManager::Node::Validate() const
 {
@@ -110,12 +118,22 @@ void DynamicAtlasManager::Node::MergeChildren()
 }
 
 
-DynamicAtlasManager::DynamicAtlasManager(Uint32 Width, Uint32 Height) :
+DynamicAtlasManager::DynamicAtlasManager(Uint32 Width, Uint32 Height, PackingAlgorithm Algorithm) :
     m_Width{Width},
-    m_Height{Height}
+    m_Height{Height},
+    m_Algorithm{Algorithm}
 {
-    m_Root->R = Region{0, 0, Width, Height};
-    RegisterNode(*m_Root);
+    if (m_Algorithm == PackingAlgorithm::Skyline)
+    {
+        // The guillotine tree is not used
+        m_Root.reset();
+        ResetSkyline();
+    }
+    else
+    {
+        m_Root->R = Region{0, 0, Width, Height};
+        RegisterNode(*m_Root);
+    }
 }
 
 
@@ -132,6 +150,14 @@ DynamicAtlasManager::~DynamicAtlasManager()
         DEV_CHECK_ERR(m_FreeRegionsByWidth.size() == 1, "There expected to be a single free region");
         DEV_CHECK_ERR(m_AllocatedRegions.empty(), "There must be no allocated regions");
     }
+    else if (m_Algorithm == PackingAlgorithm::Skyline && !m_Skyline.empty())
+    {
+#if DILIGENT_DEBUG
+        DbgVerifySkyline();
+#endif
+        DEV_CHECK_ERR(m_AllocatedRegions.empty(), "There must be no allocated regions");
+        DEV_CHECK_ERR(m_Skyline.size() == 1 && m_Skyline[0].y == 0 && m_SkylineFreeRectsByWidth.empty(), "The skyline is expected to be reset");
+    }
     else
     {
         VERIFY_EXPR(m_FreeRegionsByWidth.empty());
@@ -182,6 +208,155 @@ void DynamicAtlasManager::UnregisterNode(const Node& N)
 
 
 DynamicAtlasManager::Region DynamicAtlasManager::Allocate(Uint32 Width, Uint32 Height)
+{
+    auto R = m_Algorithm == PackingAlgorithm::Skyline ?
+        AllocateSkyline(Width, Height) :
+        AllocateGuillotine(Width, Height);
+    if (!R.IsEmpty())
+        m_AllocatedArea += Uint64{R.width} * Uint64{R.height};
+
+#if DILIGENT_DEBUG
+    if (m_Algorithm == PackingAlgorithm::Skyline)
+        DbgVerifySkyline();
+#endif
+
+    return R;
+}
+
+
+Uint32 DynamicAtlasManager::Allocate(Region* pRegions, Uint32 NumRegions)
+{
+    VERIFY_EXPR(pRegions != nullptr || NumRegions == 0);
+
+    // Place larger regions first: tall regions define the skyline levels (or the guillotine splits)
+    // and small regions fill the remaining gaps.
+    std::vector<Uint32> Order(NumRegions);
+    std::iota(Order.begin(), Order.end(), 0u);
+    std::sort(Order.begin(), Order.end(),
+              [pRegions](Uint32 i0, Uint32 i1) //
+              {
+                  const auto& R0 = pRegions[i0];
+                  const auto& R1 = pRegions[i1];
+                  if (R0.height != R1.height)
+                      return R0.height > R1.height;
+                  if (R0.width != R1.width)
+                      return R0.width > R1.width;
+                  return i0 < i1;
+              });
+
+    Uint32 NumAllocated = 0;
+    for (auto Idx : Order)
+    {
+        auto& R = pRegions[Idx];
+        if (!R.IsEmpty())
+            R = Allocate(R.width, R.height);
+        else
+            R = Region{};
+
+        if (!R.IsEmpty())
+            ++NumAllocated;
+    }
+
+    return NumAllocated;
+}
+
+
+Uint32 DynamicAtlasManager::GetFreeRegionCount() const
+{
+    if (m_Algorithm == PackingAlgorithm::Skyline)
+    {
+        Uint32 Count = static_cast<Uint32>(m_SkylineFreeRectsByWidth.size());
+        for (const auto& Node : m_Skyline)
+        {
+            if (Node.y < m_Height)
+                ++Count;
+        }
+        return Count;
+    }
+    else
+    {
+        VERIFY_EXPR(m_FreeRegionsByWidth.size() == m_FreeRegionsByHeight.size());
+        return static_cast<Uint32>(m_FreeRegionsByWidth.size());
+    }
+}
+
+
+Uint64 DynamicAtlasManager::GetLargestFreeRegionArea() const
+{
+    Uint64 MaxArea = 0;
+    if (m_Algorithm == PackingAlgorithm::Skyline)
+    {
+        for (const auto& R : m_SkylineFreeRectsByWidth)
+            MaxArea = std::max(MaxArea, Uint64{R.width} * Uint64{R.height});
+
+        // Find the largest rectangle above the skyline. The free space above the skyline is a histogram
+        // with bars of height m_Height - y, so we use the classic stack-based algorithm.
+        struct StackElem
+        {
+            Uint32 x;
+            Uint32 Height;
+        };
+        std::vector<StackElem> Stack;
+        Stack.reserve(m_Skyline.size() + 1);
+        for (size_t i = 0; i <= m_Skyline.size(); ++i)
+        {
+            const auto x      = i < m_Skyline.size() ? m_Skyline[i].x : m_Width;
+            const auto Height = i < m_Skyline.size() ? m_Height - m_Skyline[i].y : 0;
+
+            auto StartX = x;
+            while (!Stack.empty() && Stack.back().Height >= Height)
+            {
+                MaxArea = std::max(MaxArea, Uint64{Stack.back().Height} * Uint64{x - Stack.back().x});
+                StartX  = Stack.back().x;
+                Stack.pop_back();
+            }
+            Stack.push_back({StartX, Height});
+        }
+    }
+    else
+    {
+        for (const auto& it : m_FreeRegionsByWidth)
+            MaxArea = std::max(MaxArea, Uint64{it.first.width} * Uint64{it.first.height});
+    }
+
+    return MaxArea;
+}
+
+
+float DynamicAtlasManager::GetFragmentation() const
+{
+    const auto FreeArea = Uint64{m_Width} * Uint64{m_Height} - m_AllocatedArea;
+    if (FreeArea == 0)
+        return 0;
+
+    return 1.f - static_cast<float>(static_cast<double>(GetLargestFreeRegionArea()) / static_cast<double>(FreeArea));
+}
+
+
+void DynamicAtlasManager::Free(Region&& R)
+{
+#if DILIGENT_DEBUG
+    DbgVerifyRegion(R);
+#endif
+
+    const auto Area = Uint64{R.width} * Uint64{R.height};
+    if (m_AllocatedRegions.find(R) == m_AllocatedRegions.end())
+    {
+        UNEXPECTED("Unable to find region [", R.x, ", ", R.x + R.width, ") x [", R.y, ", ", R.y + R.height, ") among allocated regions. Have you ever allocated it?");
+        return;
+    }
+
+    VERIFY_EXPR(m_AllocatedArea >= Area);
+    m_AllocatedArea -= Area;
+
+    if (m_Algorithm == PackingAlgorithm::Skyline)
+        FreeSkyline(std::move(R));
+    else
+        FreeGuillotine(std::move(R));
+}
+
+
+DynamicAtlasManager::Region DynamicAtlasManager::AllocateGuillotine(Uint32 Width, Uint32 Height)
 {
     auto it_w = m_FreeRegionsByWidth.lower_bound(Region{0, 0, Width, 0});
     while (it_w != m_FreeRegionsByWidth.end() && it_w->first.height < Height)
@@ -323,12 +498,8 @@ DynamicAtlasManager::Region DynamicAtlasManager::Allocate(Uint32 Width, Uint32 H
 }
 
 
-void DynamicAtlasManager::Free(Region&& R)
+void DynamicAtlasManager::FreeGuillotine(Region&& R)
 {
-#if DILIGENT_DEBUG
-    DbgVerifyRegion(R);
-#endif
-
     auto node_it = m_AllocatedRegions.find(R);
     if (node_it == m_AllocatedRegions.end())
     {
@@ -364,6 +535,362 @@ void DynamicAtlasManager::Free(Region&& R)
 }
 
 
+void DynamicAtlasManager::ResetSkyline()
+{
+    m_Skyline.clear();
+    m_Skyline.push_back(SkylineNode{0, 0, m_Width});
+    m_SkylineFreeRectsByWidth.clear();
+    m_SkylineFreeRectsByHeight.clear();
+    m_SkylineFreeRectsByMinCorner.clear();
+    m_SkylineFreeRectsByMaxCorner.clear();
+}
+
+
+DynamicAtlasManager::Region DynamicAtlasManager::AllocateSkyline(Uint32 Width, Uint32 Height)
+{
+    if (Width == 0 || Height == 0 || Width > m_Width || Height > m_Height)
+        return Region{};
+
+    Region R;
+
+    // Try the free rectangles below the skyline first. Same as for the guillotine packing,
+    // take the narrowest and the lowest rectangles that fit and use the smaller one.
+    auto it_w = m_SkylineFreeRectsByWidth.lower_bound(Region{0, 0, Width, 0});
+    while (it_w != m_SkylineFreeRectsByWidth.end() && it_w->height < Height)
+        ++it_w;
+
+    auto it_h = m_SkylineFreeRectsByHeight.lower_bound(Region{0, 0, 0, Height});
+    while (it_h != m_SkylineFreeRectsByHeight.end() && it_h->width < Width)
+        ++it_h;
+
+    const auto AreaW = it_w != m_SkylineFreeRectsByWidth.end() ? Uint64{it_w->width} * Uint64{it_w->height} : 0;
+    const auto AreaH = it_h != m_SkylineFreeRectsByHeight.end() ? Uint64{it_h->width} * Uint64{it_h->height} : 0;
+
+    if (AreaW > 0 || AreaH > 0)
+    {
+        const auto F = (AreaW > 0 && (AreaH == 0 || AreaW < AreaH)) ? *it_w : *it_h;
+        VERIFY_EXPR(F.width >= Width && F.height >= Height);
+        UnregisterSkylineFreeRect(F);
+
+        R = Region{F.x, F.y, Width, Height};
+
+        // Split the remaining space along the shorter leftover axis
+        const auto LeftoverW = F.width - Width;
+        const auto LeftoverH = F.height - Height;
+        Region     Right, Top;
+        if (LeftoverW < LeftoverH)
+        {
+            //   ___________
+            //  |           |
+            //  |    Top    |
+            //  |____ ______|
+            //  |    |      |
+            //  | R  |Right |
+            //  |____|______|
+            //
+            Right = Region{F.x + Width, F.y, LeftoverW, Height};
+            Top   = Region{F.x, F.y + Height, F.width, LeftoverH};
+        }
+        else
+        {
+            //   ____ ______
+            //  |    |      |
+            //  |Top |      |
+            //  |____|Right |
+            //  |    |      |
+            //  | R  |      |
+            //  |____|______|
+            //
+            Right = Region{F.x + Width, F.y, LeftoverW, F.height};
+            Top   = Region{F.x, F.y + Height, Width, LeftoverH};
+        }
+        if (!Right.IsEmpty())
+            RegisterSkylineFreeRect(Right);
+        if (!Top.IsEmpty())
+            RegisterSkylineFreeRect(Top);
+    }
+    else
+    {
+        size_t NodeIdx = 0;
+        Uint32 y       = 0;
+        if (!FindSkylinePosition(Width, Height, NodeIdx, y))
+            return Region{};
+
+        R = Region{m_Skyline[NodeIdx].x, y, Width, Height};
+        AddSkylineLevel(NodeIdx, y, Width, Height);
+    }
+
+    m_AllocatedRegions.emplace(R, nullptr);
+
+    return R;
+}
+
+
+bool DynamicAtlasManager::FindSkylinePosition(Uint32 Width, Uint32 Height, size_t& NodeIdx, Uint32& y) const
+{
+    Uint32 BestTop   = UINT_MAX;
+    Uint32 BestWidth = UINT_MAX;
+    for (size_t i = 0; i < m_Skyline.size(); ++i)
+    {
+        const auto& Node = m_Skyline[i];
+        if (Node.x + Width > m_Width)
+            break;
+
+        // The region must be placed above all skyline segments it spans
+        const auto Right = Node.x + Width;
+
+        Uint32 MaxY = 0;
+        for (auto j = i; j < m_Skyline.size() && m_Skyline[j].x < Right; ++j)
+        {
+            MaxY = std::max(MaxY, m_Skyline[j].y);
+            // Stop early if this position can't be better than the best one
+            if (MaxY + Height > std::min(m_Height, BestTop))
+                break;
+        }
+
+        const auto Top = MaxY + Height;
+        if (Top > m_Height)
+            continue;
+        if (Top < BestTop || (Top == BestTop && Node.width < BestWidth))
+        {
+            BestTop   = Top;
+            BestWidth = Node.width;
+            NodeIdx   = i;
+            y         = MaxY;
+        }
+    }
+
+    return BestTop != UINT_MAX;
+}
+
+
+void DynamicAtlasManager::AddSkylineLevel(size_t NodeIdx, Uint32 y, Uint32 Width, Uint32 Height)
+{
+    const auto x     = m_Skyline[NodeIdx].x;
+    const auto Right = x + Width;
+
+    //            ______________
+    //           |              |
+    //           |      R       |
+    //    _______|______________|
+    //   |       |//////|       |
+    //   |       |//////|_______|
+    //
+    // Record the space between the old skyline and the new region as free rectangles
+    // and remove the segments that are covered by the region.
+    auto i = NodeIdx;
+    for (; i < m_Skyline.size() && m_Skyline[i].x < Right; ++i)
+    {
+        auto& Node = m_Skyline[i];
+        VERIFY_EXPR(Node.y <= y);
+
+        const auto NodeRight = Node.x + Node.width;
+        if (Node.y < y)
+            AddSkylineFreeRect(Region{Node.x, Node.y, std::min(NodeRight, Right) - Node.x, y - Node.y});
+
+        if (NodeRight > Right)
+        {
+            // The segment is partially covered
+            Node.width = NodeRight - Right;
+            Node.x     = Right;
+            break;
+        }
+    }
+    m_Skyline.erase(m_Skyline.begin() + NodeIdx, m_Skyline.begin() + i);
+    m_Skyline.insert(m_Skyline.begin() + NodeIdx, SkylineNode{x, y + Height, Width});
+
+    MergeSkylineNodes();
+}
+
+
+void DynamicAtlasManager::LowerSkyline(Uint32 x, Uint32 Width, Uint32 y)
+{
+    const auto Right = x + Width;
+
+    // Find the range of segments that overlap [x, Right)
+    auto First = std::upper_bound(m_Skyline.begin(), m_Skyline.end(), x,
+                                  [](Uint32 x, const SkylineNode& Node) //
+                                  {
+                                      return x < Node.x + Node.width;
+                                  });
+    auto Last  = First;
+    while (Last != m_Skyline.end() && Last->x < Right)
+        ++Last;
+    VERIFY_EXPR(First != Last);
+
+    SkylineNode NewNodes[3];
+    size_t      NumNewNodes = 0;
+    if (First->x < x)
+        NewNodes[NumNewNodes++] = SkylineNode{First->x, First->y, x - First->x};
+    NewNodes[NumNewNodes++] = SkylineNode{x, y, Width};
+    {
+        const auto& LastNode  = *(Last - 1);
+        const auto  LastRight = LastNode.x + LastNode.width;
+        if (LastRight > Right)
+            NewNodes[NumNewNodes++] = SkylineNode{Right, LastNode.y, LastRight - Right};
+    }
+
+    const auto Pos = m_Skyline.erase(First, Last);
+    m_Skyline.insert(Pos, NewNodes, NewNodes + NumNewNodes);
+
+    MergeSkylineNodes();
+}
+
+
+void DynamicAtlasManager::MergeSkylineNodes()
+{
+    size_t Dst = 0;
+    for (size_t Src = 1; Src < m_Skyline.size(); ++Src)
+    {
+        if (m_Skyline[Src].y == m_Skyline[Dst].y)
+            m_Skyline[Dst].width += m_Skyline[Src].width;
+        else
+            m_Skyline[++Dst] = m_Skyline[Src];
+    }
+    m_Skyline.resize(Dst + 1);
+}
+
+
+void DynamicAtlasManager::GetSkylineHeightRange(Uint32 x, Uint32 Width, Uint32& MinY, Uint32& MaxY) const
+{
+    VERIFY_EXPR(x + Width <= m_Width);
+
+    // Find the first segment that ends after x
+    auto it = std::upper_bound(m_Skyline.begin(), m_Skyline.end(), x,
+                               [](Uint32 x, const SkylineNode& Node) //
+                               {
+                                   return x < Node.x + Node.width;
+                               });
+
+    MinY = UINT_MAX;
+    MaxY = 0;
+    for (; it != m_Skyline.end() && it->x < x + Width; ++it)
+    {
+        MinY = std::min(MinY, it->y);
+        MaxY = std::max(MaxY, it->y);
+    }
+}
+
+
+void DynamicAtlasManager::RegisterSkylineFreeRect(const Region& R)
+{
+    VERIFY_EXPR(!R.IsEmpty());
+
+    const auto MinKey = SkylineCornerKey(R.x, R.y);
+    const auto MaxKey = SkylineCornerKey(R.x + R.width, R.y + R.height);
+    VERIFY(m_SkylineFreeRectsByMinCorner.find(MinKey) == m_SkylineFreeRectsByMinCorner.end(), "Free rectangles must not overlap");
+    VERIFY(m_SkylineFreeRectsByMaxCorner.find(MaxKey) == m_SkylineFreeRectsByMaxCorner.end(), "Free rectangles must not overlap");
+
+    m_SkylineFreeRectsByWidth.insert(R);
+    m_SkylineFreeRectsByHeight.insert(R);
+    m_SkylineFreeRectsByMinCorner.emplace(MinKey, R);
+    m_SkylineFreeRectsByMaxCorner.emplace(MaxKey, R);
+}
+
+
+void DynamicAtlasManager::UnregisterSkylineFreeRect(const Region& R)
+{
+    VERIFY(m_SkylineFreeRectsByWidth.find(R) != m_SkylineFreeRectsByWidth.end(), "Free rectangle is not found");
+
+    m_SkylineFreeRectsByWidth.erase(R);
+    m_SkylineFreeRectsByHeight.erase(R);
+    m_SkylineFreeRectsByMinCorner.erase(SkylineCornerKey(R.x, R.y));
+    m_SkylineFreeRectsByMaxCorner.erase(SkylineCornerKey(R.x + R.width, R.y + R.height));
+}
+
+
+DynamicAtlasManager::Region DynamicAtlasManager::AddSkylineFreeRect(Region R)
+{
+    VERIFY_EXPR(!R.IsEmpty());
+
+    const auto FindRect = [](const std::map<Uint64, Region>& Rects, Uint32 x, Uint32 y, Region& F) //
+    {
+        auto it = Rects.find(SkylineCornerKey(x, y));
+        if (it == Rects.end())
+            return false;
+        F = it->second;
+        return true;
+    };
+
+    // Merge the rectangle with free rectangles that share an entire edge with it.
+    // Free rectangles do not overlap, so only the four neighbors need to be checked:
+    // the ones above and to the right start at the corners of R, and the ones
+    // below and to the left end at the corners of R.
+    while (true)
+    {
+        Region F;
+        if (FindRect(m_SkylineFreeRectsByMinCorner, R.x, R.y + R.height, F) && F.width == R.width)
+            R = Region{R.x, R.y, R.width, R.height + F.height}; // Above
+        else if (FindRect(m_SkylineFreeRectsByMaxCorner, R.x + R.width, R.y, F) && F.x == R.x)
+            R = Region{R.x, F.y, R.width, R.height + F.height}; // Below
+        else if (FindRect(m_SkylineFreeRectsByMinCorner, R.x + R.width, R.y, F) && F.height == R.height)
+            R = Region{R.x, R.y, R.width + F.width, R.height}; // Right
+        else if (FindRect(m_SkylineFreeRectsByMaxCorner, R.x, R.y + R.height, F) && F.y == R.y)
+            R = Region{F.x, R.y, R.width + F.width, R.height}; // Left
+        else
+            break;
+
+        UnregisterSkylineFreeRect(F);
+    }
+
+    RegisterSkylineFreeRect(R);
+
+    return R;
+}
+
+
+bool DynamicAtlasManager::AbsorbSkylineFreeRect(const Region& F)
+{
+    // The rectangle can be absorbed if it lies directly below a flat part of the skyline
+    Uint32 MinY = 0, MaxY = 0;
+    GetSkylineHeightRange(F.x, F.width, MinY, MaxY);
+    if (MinY != F.y + F.height || MaxY != MinY)
+        return false;
+
+    UnregisterSkylineFreeRect(F);
+    LowerSkyline(F.x, F.width, F.y);
+
+    // Free rectangles directly below F may now touch the skyline. Their top edges are at F.y,
+    // so their top-right corners are ordered by x, starting after F.x.
+    auto it = m_SkylineFreeRectsByMaxCorner.upper_bound(SkylineCornerKey(F.x, F.y));
+    while (it != m_SkylineFreeRectsByMaxCorner.end() && it->second.y + it->second.height == F.y && it->second.x < F.x + F.width)
+    {
+        const auto C = it->second;
+        if (AbsorbSkylineFreeRect(C))
+        {
+            // Absorbing C removes it and the rectangles below it from the map
+            it = m_SkylineFreeRectsByMaxCorner.upper_bound(SkylineCornerKey(C.x + C.width, F.y));
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    return true;
+}
+
+
+void DynamicAtlasManager::FreeSkyline(Region&& R)
+{
+    m_AllocatedRegions.erase(R);
+    if (m_AllocatedRegions.empty())
+    {
+        ResetSkyline();
+    }
+    else
+    {
+        AbsorbSkylineFreeRect(AddSkylineFreeRect(R));
+    }
+
+#if DILIGENT_DEBUG
+    DbgVerifySkyline();
+#endif
+
+    R = InvalidRegion;
+}
+
+
 #if DILIGENT_DEBUG
 
 void DynamicAtlasManager::DbgVerifyRegion(const Region& R) const
@@ -420,6 +947,50 @@ void DynamicAtlasManager::DbgVerifyConsistency() const
 
     VERIFY(Area == m_Width * m_Height, "Not entire atlas area has been covered");
 }
+
+void DynamicAtlasManager::DbgVerifySkyline() const
+{
+    VERIFY(!m_Skyline.empty(), "Skyline must not be empty");
+    Uint32 x = 0;
+    for (size_t i = 0; i < m_Skyline.size(); ++i)
+    {
+        const auto& Node = m_Skyline[i];
+        VERIFY(Node.x == x, "Skyline segments must be contiguous");
+        VERIFY(Node.width > 0, "Skyline segment must not be empty");
+        VERIFY(Node.y <= m_Height, "Skyline segment height (", Node.y, ") exceeds atlas height (", m_Height, ")");
+        VERIFY(i == 0 || Node.y != m_Skyline[i - 1].y, "Adjacent skyline segments with equal heights must be merged");
+        x += Node.width;
+    }
+    VERIFY(x == m_Width, "Skyline must cover the entire atlas width");
+
+    VERIFY_EXPR(m_SkylineFreeRectsByWidth.size() == m_SkylineFreeRectsByHeight.size());
+    VERIFY_EXPR(m_SkylineFreeRectsByWidth.size() == m_SkylineFreeRectsByMinCorner.size());
+    VERIFY_EXPR(m_SkylineFreeRectsByWidth.size() == m_SkylineFreeRectsByMaxCorner.size());
+    for (const auto& F : m_SkylineFreeRectsByWidth)
+    {
+        DbgVerifyRegion(F);
+
+        Uint32 MinY = 0, MaxY = 0;
+        GetSkylineHeightRange(F.x, F.width, MinY, MaxY);
+        VERIFY(F.y + F.height <= MinY, "Free rectangle [", F.x, ", ", F.x + F.width, ") x [", F.y, ", ", F.y + F.height, ") is above the skyline");
+
+        for (const auto& it : m_AllocatedRegions)
+        {
+            const auto& A = it.first;
+            if (CheckBox2DBox2DOverlap<false>(uint2{F.x, F.y}, uint2{F.x + F.width, F.y + F.height},
+                                              uint2{A.x, A.y}, uint2{A.x + A.width, A.y + A.height}))
+            {
+                UNEXPECTED("Free rectangle [", F.x, ", ", F.x + F.width, ") x [", F.y, ", ", F.y + F.height,
+                           ") overlaps allocated region [", A.x, ", ", A.x + A.width, ") x [", A.y, ", ", A.y + A.height, ")");
+            }
+        }
+    }
+
+    Uint64 Area = 0;
+    for (const auto& it : m_AllocatedRegions)
+        Area += Uint64{it.first.width} * Uint64{it.first.height};
+    VERIFY(Area == m_AllocatedArea, "Allocated area is inconsistent");
+}
 #endif // DILIGENT_DEBUG
 
 } // namespace Diligent
@@ -58,6 +58,7 @@ void SRBMemoryAllocator::Initialize(Uint32              SRBAllocationGranularity
 
     if (TotalAllocatorCount == 0)
         return;
+    VERIFY(TotalAllocatorCount <= sizeof(m_NonEmptyAllocatorMask) * 8, "Too many allocators");
 
     auto* pAllocatorsRawMem = m_RawMemAllocator.Allocate(
         sizeof(FixedBlockMemoryAllocator) * TotalAllocatorCount,
@@ -68,7 +69,22 @@ void SRBMemoryAllocator::Initialize(Uint32              SRBAllocationGranularity
     for (Uint32 s = 0; s < TotalAllocatorCount; ++s)
     {
         auto size = s < ShaderVariableDataAllocatorCount ? ShaderVariableDataSizes[s] : ResourceCacheDataSizes[s - ShaderVariableDataAllocatorCount];
-        new (m_DataAllocators + s) FixedBlockMemoryAllocator(GetRawAllocator(), size, SRBAllocationGranularity);
+        new (m_DataAllocators + s) FixedBlockMemoryAllocator(GetRawAllocator(), size, SRBAllocationGranularity, FixedBlockAllocatorMode::ThreadCaching);
+        if (size > 0)
+            m_NonEmptyAllocatorMask |= 1u << s;
+    }
+}
+
+void SRBMemoryAllocator::Prefetch(Uint32 NumSRBs)
+{
+    if (m_DataAllocators == nullptr)
+        return;
+
+    auto TotalAllocatorCount = m_ShaderVariableDataAllocatorCount + m_ResourceCacheDataAllocatorCount;
+    for (Uint32 s = 0; s < TotalAllocatorCount; ++s)
+    {
+        if (m_NonEmptyAllocatorMask & (1u << s))
+            m_DataAllocators[s].Prefetch(NumSRBs);
     }
 }
 
@@ -0,0 +1,987 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "TextureDataConversion.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "GraphicsAccessories.hpp"
+#include "ColorConversion.h"
+#include "ThreadPool.hpp"
+
+// The vectorized paths are selected at compile time by the instruction sets enabled for the target.
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define DILIGENT_TEX_CONV_SSE2 1
+#    include <emmintrin.h>
+#    if defined(__SSSE3__) || defined(__AVX__)
+#        define DILIGENT_TEX_CONV_SSSE3 1
+#        include <tmmintrin.h>
+#    endif
+#    if defined(__AVX2__)
+#        define DILIGENT_TEX_CONV_AVX2 1
+#        include <immintrin.h>
+#    endif
+// All AVX2-capable CPUs support F16C, but MSVC does not define a separate macro for it
+#    if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+#        define DILIGENT_TEX_CONV_F16C 1
+#        include <immintrin.h>
+#    endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#    define DILIGENT_TEX_CONV_NEON 1
+#    include <arm_neon.h>
+#endif
+
+namespace Diligent
+{
+
+namespace
+{
+
+// Memory layout of one texel
+struct TexelLayout
+{
+    COMPONENT_TYPE Type          = COMPONENT_TYPE_UNDEFINED;
+    Uint32         ComponentSize = 0;
+    Uint32         NumComponents = 0;
+
+    // Components are stored in BGR(A) order
+    bool SwapRB = false;
+
+    // The only component is alpha (A8 format)
+    bool AlphaOnly = false;
+
+    Uint32 GetTexelSize() const
+    {
+        return ComponentSize * NumComponents;
+    }
+
+    // Returns the RGBA channel that the component is read from or written to
+    Uint32 GetChannel(Uint32 Component) const
+    {
+        if (AlphaOnly)
+            return 3;
+        return (SwapRB && Component != 1 && Component < 3) ? 2 - Component : Component;
+    }
+
+    bool IsSRGBColor(Uint32 Channel) const
+    {
+        return Type == COMPONENT_TYPE_UNORM_SRGB && Channel < 3;
+    }
+
+    bool operator==(const TexelLayout& rhs) const
+    {
+        // clang-format off
+        return Type          == rhs.Type          &&
+               ComponentSize == rhs.ComponentSize &&
+               NumComponents == rhs.NumComponents &&
+               SwapRB        == rhs.SwapRB        &&
+               AlphaOnly     == rhs.AlphaOnly;
+        // clang-format on
+    }
+
+    // Returns true if both layouts store the same channels in the same order
+    bool HasSameChannels(const TexelLayout& rhs) const
+    {
+        return NumComponents == rhs.NumComponents && SwapRB == rhs.SwapRB && AlphaOnly == rhs.AlphaOnly;
+    }
+};
+
+bool GetTexelLayout(TEXTURE_FORMAT Format, Uint32 ComponentCount, TexelLayout& Layout)
+{
+    switch (Format)
+    {
+        // Bit-packed and subsampled formats
+        case TEX_FORMAT_R1_UNORM:
+        case TEX_FORMAT_RG8_B8G8_UNORM:
+        case TEX_FORMAT_G8R8_G8B8_UNORM:
+            return false;
+
+        default:
+            break;
+    }
+
+    const auto& FmtAttribs = GetTextureFormatAttribs(Format);
+    if (Format == TEX_FORMAT_UNKNOWN || FmtAttribs.IsTypeless)
+        return false;
+
+    switch (FmtAttribs.ComponentType)
+    {
+        case COMPONENT_TYPE_UNORM:
+        case COMPONENT_TYPE_SNORM:
+        case COMPONENT_TYPE_UINT:
+        case COMPONENT_TYPE_SINT:
+            if (FmtAttribs.ComponentSize != 1 && FmtAttribs.ComponentSize != 2 && FmtAttribs.ComponentSize != 4)
+                return false;
+            break;
+
+        case COMPONENT_TYPE_UNORM_SRGB:
+            if (FmtAttribs.ComponentSize != 1)
+                return false;
+            break;
+
+        case COMPONENT_TYPE_FLOAT:
+            if (FmtAttribs.ComponentSize != 2 && FmtAttribs.ComponentSize != 4)
+                return false;
+            break;
+
+        default:
+            return false;
+    }
+
+    if (ComponentCount > FmtAttribs.NumComponents)
+        return false;
+
+    Layout.Type          = FmtAttribs.ComponentType;
+    Layout.ComponentSize = FmtAttribs.ComponentSize;
+    Layout.NumComponents = ComponentCount != 0 ? ComponentCount : Uint32{FmtAttribs.NumComponents};
+    // clang-format off
+    Layout.SwapRB        = Format == TEX_FORMAT_BGRA8_UNORM      ||
+                           Format == TEX_FORMAT_BGRX8_UNORM      ||
+                           Format == TEX_FORMAT_BGRA8_UNORM_SRGB ||
+                           Format == TEX_FORMAT_BGRX8_UNORM_SRGB;
+    // clang-format on
+    Layout.AlphaOnly = Format == TEX_FORMAT_A8_UNORM;
+
+    return true;
+}
+
+
+// https://fgiesen.wordpress.com/2012/03/28/half-to-float-done-quic/
+// Converts a 32-bit float to a 16-bit float with rounding to nearest even.
+Uint16 FloatToHalf(float f)
+{
+    Uint32 u = 0;
+    memcpy(&u, &f, sizeof(u));
+
+    constexpr Uint32 F32Infinity  = 255u << 23;
+    constexpr Uint32 F16Max       = (127u + 16u) << 23;
+    constexpr Uint32 DenormMagicU = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+
+    const Uint32 Sign = u & 0x80000000u;
+    u ^= Sign;
+
+    Uint32 h = 0;
+    if (u >= F16Max)
+    {
+        // Inf or NaN
+        h = u > F32Infinity ? 0x7E00u : 0x7C00u;
+    }
+    else if (u < (113u << 23))
+    {
+        // The result is a denormal or zero. Adding the magic value aligns the 10 mantissa bits
+        // at the bottom of the float, with the rounding done by the floating-point addition.
+        float DenormMagic = 0;
+        memcpy(&DenormMagic, &DenormMagicU, sizeof(DenormMagic));
+        float fa = 0;
+        memcpy(&fa, &u, sizeof(fa));
+        fa += DenormMagic;
+        memcpy(&u, &fa, sizeof(u));
+        h = u - DenormMagicU;
+    }
+    else
+    {
+        const Uint32 MantissaOdd = (u >> 13) & 1u;
+        // Rebias the exponent and round
+        u += (static_cast<Uint32>(15 - 127) << 23) + 0xFFFu + MantissaOdd;
+        h = u >> 13;
+    }
+
+    return static_cast<Uint16>(h | (Sign >> 16));
+}
+
+float HalfToFloat(Uint16 h)
+{
+    constexpr Uint32 ShiftedExp = 0x7C00u << 13;
+    constexpr Uint32 MagicU     = 113u << 23;
+
+    Uint32       u   = (Uint32{h} & 0x7FFFu) << 13;
+    const Uint32 Exp = u & ShiftedExp;
+    u += (127u - 15u) << 23;
+
+    if (Exp == ShiftedExp)
+    {
+        // Inf or NaN
+        u += (128u - 16u) << 23;
+    }
+    else if (Exp == 0)
+    {
+        // Zero or denormal: renormalize
+        u += 1u << 23;
+        float Magic = 0;
+        memcpy(&Magic, &MagicU, sizeof(Magic));
+        float f = 0;
+        memcpy(&f, &u, sizeof(f));
+        f -= Magic;
+        memcpy(&u, &f, sizeof(u));
+    }
+
+    u |= (Uint32{h} & 0x8000u) << 16;
+
+    float f = 0;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+template <typename T>
+T LoadComponent(const Uint8* pSrc)
+{
+    T Val;
+    memcpy(&Val, pSrc, sizeof(T));
+    return Val;
+}
+
+template <typename T>
+void StoreComponent(Uint8* pDst, T Val)
+{
+    memcpy(pDst, &Val, sizeof(T));
+}
+
+// Normalized integer conversion rules follow the D3D data conversion rules
+template <typename T>
+float DecodeUNorm(const Uint8* pSrc)
+{
+    constexpr float Scale = 1.f / static_cast<float>(std::numeric_limits<T>::max());
+    return static_cast<float>(LoadComponent<T>(pSrc)) * Scale;
+}
+
+template <typename T>
+float DecodeSNorm(const Uint8* pSrc)
+{
+    constexpr float Scale = 1.f / static_cast<float>(std::numeric_limits<T>::max());
+    return std::max(static_cast<float>(LoadComponent<T>(pSrc)) * Scale, -1.f);
+}
+
+template <typename T>
+float DecodeInt(const Uint8* pSrc)
+{
+    return static_cast<float>(LoadComponent<T>(pSrc));
+}
+
+template <typename T>
+void EncodeUNorm(Uint8* pDst, float Val)
+{
+    constexpr double MaxVal = static_cast<double>(std::numeric_limits<T>::max());
+    // Note that comparisons are false for NaN, which thus becomes 0
+    const double Clamped = Val > 0.f ? std::min(static_cast<double>(Val), 1.0) : 0.0;
+    StoreComponent(pDst, static_cast<T>(Clamped * MaxVal + 0.5));
+}
+
+template <typename T>
+void EncodeSNorm(Uint8* pDst, float Val)
+{
+    constexpr double MaxVal  = static_cast<double>(std::numeric_limits<T>::max());
+    const double     Clamped = Val > -1.f ? std::min(static_cast<double>(Val), 1.0) * MaxVal : (Val == Val ? -MaxVal : 0.0);
+    StoreComponent(pDst, static_cast<T>(Clamped >= 0 ? Clamped + 0.5 : Clamped - 0.5));
+}
+
+template <typename T>
+void EncodeInt(Uint8* pDst, float Val)
+{
+    constexpr double MinVal  = static_cast<double>(std::numeric_limits<T>::min());
+    constexpr double MaxVal  = static_cast<double>(std::numeric_limits<T>::max());
+    const double     Clamped = Val > MinVal ? std::min(static_cast<double>(Val), MaxVal) : (Val == Val ? MinVal : 0.0);
+    StoreComponent(pDst, static_cast<T>(Clamped >= 0 ? Clamped + 0.5 : Clamped - 0.5));
+}
+
+// Integer to integer conversion does not go through float, which cannot represent all 32-bit values
+template <typename T>
+Int64 DecodeInt64(const Uint8* pSrc)
+{
+    return static_cast<Int64>(LoadComponent<T>(pSrc));
+}
+
+template <typename T>
+void EncodeInt64(Uint8* pDst, Int64 Val)
+{
+    constexpr Int64 MinVal = static_cast<Int64>(std::numeric_limits<T>::min());
+    constexpr Int64 MaxVal = static_cast<Int64>(std::numeric_limits<T>::max());
+    StoreComponent(pDst, static_cast<T>(std::min(std::max(Val, MinVal), MaxVal)));
+}
+
+Uint8 LinearToSRGB8(float Val)
+{
+    const float Clamped = Val > 0.f ? std::min(Val, 1.f) : 0.f;
+    return static_cast<Uint8>(LinearToSRGB(Clamped) * 255.f + 0.5f);
+}
+
+using DecodeComponentFunc = float (*)(const Uint8* pSrc);
+using EncodeComponentFunc = void (*)(Uint8* pDst, float Val);
+
+using DecodeIntComponentFunc = Int64 (*)(const Uint8* pSrc);
+using EncodeIntComponentFunc = void (*)(Uint8* pDst, Int64 Val);
+
+bool IsIntegerLayout(const TexelLayout& Layout)
+{
+    return Layout.Type == COMPONENT_TYPE_UINT || Layout.Type == COMPONENT_TYPE_SINT;
+}
+
+DecodeIntComponentFunc GetDecodeIntFunc(const TexelLayout& Layout)
+{
+    VERIFY_EXPR(IsIntegerLayout(Layout));
+    // clang-format off
+    if (Layout.Type == COMPONENT_TYPE_UINT)
+        return Layout.ComponentSize == 1 ? DecodeInt64<Uint8> : Layout.ComponentSize == 2 ? DecodeInt64<Uint16> : DecodeInt64<Uint32>;
+    else
+        return Layout.ComponentSize == 1 ? DecodeInt64<Int8>  : Layout.ComponentSize == 2 ? DecodeInt64<Int16>  : DecodeInt64<Int32>;
+    // clang-format on
+}
+
+EncodeIntComponentFunc GetEncodeIntFunc(const TexelLayout& Layout)
+{
+    VERIFY_EXPR(IsIntegerLayout(Layout));
+    // clang-format off
+    if (Layout.Type == COMPONENT_TYPE_UINT)
+        return Layout.ComponentSize == 1 ? EncodeInt64<Uint8> : Layout.ComponentSize == 2 ? EncodeInt64<Uint16> : EncodeInt64<Uint32>;
+    else
+        return Layout.ComponentSize == 1 ? EncodeInt64<Int8>  : Layout.ComponentSize == 2 ? EncodeInt64<Int16>  : EncodeInt64<Int32>;
+    // clang-format on
+}
+
+DecodeComponentFunc GetDecodeFunc(const TexelLayout& Layout)
+{
+    switch (Layout.Type)
+    {
+        // clang-format off
+        case COMPONENT_TYPE_UNORM:
+            return Layout.ComponentSize == 1 ? DecodeUNorm<Uint8> : Layout.ComponentSize == 2 ? DecodeUNorm<Uint16> : DecodeUNorm<Uint32>;
+        case COMPONENT_TYPE_SNORM:
+            return Layout.ComponentSize == 1 ? DecodeSNorm<Int8>  : Layout.ComponentSize == 2 ? DecodeSNorm<Int16>  : DecodeSNorm<Int32>;
+        case COMPONENT_TYPE_UINT:
+            return Layout.ComponentSize == 1 ? DecodeInt<Uint8>   : Layout.ComponentSize == 2 ? DecodeInt<Uint16>   : DecodeInt<Uint32>;
+        case COMPONENT_TYPE_SINT:
+            return Layout.ComponentSize == 1 ? DecodeInt<Int8>    : Layout.ComponentSize == 2 ? DecodeInt<Int16>    : DecodeInt<Int32>;
+            // clang-format on
+
+        case COMPONENT_TYPE_UNORM_SRGB:
+            // sRGB color components are handled separately, this function is used for alpha
+            return DecodeUNorm<Uint8>;
+
+        case COMPONENT_TYPE_FLOAT:
+            if (Layout.ComponentSize == 2)
+                return [](const Uint8* pSrc) {
+                    return HalfToFloat(LoadComponent<Uint16>(pSrc));
+                };
+            else
+                return [](const Uint8* pSrc) {
+                    return LoadComponent<float>(pSrc);
+                };
+
+        default:
+            UNEXPECTED("Unexpected component type");
+            return nullptr;
+    }
+}
+
+EncodeComponentFunc GetEncodeFunc(const TexelLayout& Layout)
+{
+    switch (Layout.Type)
+    {
+        // clang-format off
+        case COMPONENT_TYPE_UNORM:
+            return Layout.ComponentSize == 1 ? EncodeUNorm<Uint8> : Layout.ComponentSize == 2 ? EncodeUNorm<Uint16> : EncodeUNorm<Uint32>;
+        case COMPONENT_TYPE_SNORM:
+            return Layout.ComponentSize == 1 ? EncodeSNorm<Int8>  : Layout.ComponentSize == 2 ? EncodeSNorm<Int16>  : EncodeSNorm<Int32>;
+        case COMPONENT_TYPE_UINT:
+            return Layout.ComponentSize == 1 ? EncodeInt<Uint8>   : Layout.ComponentSize == 2 ? EncodeInt<Uint16>   : EncodeInt<Uint32>;
+        case COMPONENT_TYPE_SINT:
+            return Layout.ComponentSize == 1 ? EncodeInt<Int8>    : Layout.ComponentSize == 2 ? EncodeInt<Int16>    : EncodeInt<Int32>;
+            // clang-format on
+
+        case COMPONENT_TYPE_UNORM_SRGB:
+            // sRGB color components are handled separately, this function is used for alpha
+            return EncodeUNorm<Uint8>;
+
+        case COMPONENT_TYPE_FLOAT:
+            if (Layout.ComponentSize == 2)
+                return [](Uint8* pDst, float Val) {
+                    StoreComponent(pDst, FloatToHalf(Val));
+                };
+            else
+                return [](Uint8* pDst, float Val) {
+                    StoreComponent(pDst, Val);
+                };
+
+        default:
+            UNEXPECTED("Unexpected component type");
+            return nullptr;
+    }
+}
+
+
+// 8-bit sRGB <-> 8-bit linear tables
+struct SRGB8Tables
+{
+    SRGB8Tables() noexcept
+    {
+        for (Uint32 i = 0; i < 256; ++i)
+        {
+            // Use the same functions as the general path to get identical results
+            const auto Val = static_cast<Uint8>(i);
+            EncodeUNorm<Uint8>(&ToLinear[i], SRGBToLinear(Val));
+            ToSRGB[i]   = LinearToSRGB8(DecodeUNorm<Uint8>(&Val));
+            Identity[i] = Val;
+        }
+    }
+
+    static const SRGB8Tables& Get()
+    {
+        static const SRGB8Tables Tables;
+        return Tables;
+    }
+
+    std::array<Uint8, 256> ToLinear;
+    std::array<Uint8, 256> ToSRGB;
+    // Alpha is always linear
+    std::array<Uint8, 256> Identity;
+};
+
+
+// Parameters of a single row conversion
+struct RowConversionInfo
+{
+    TexelLayout Src;
+    TexelLayout Dst;
+
+    DecodeComponentFunc Decode = nullptr;
+    EncodeComponentFunc Encode = nullptr;
+
+    DecodeIntComponentFunc DecodeInt = nullptr;
+    EncodeIntComponentFunc EncodeInt = nullptr;
+};
+
+using ConvertRowFunc = void (*)(const RowConversionInfo& Info, const Uint8* pSrc, Uint8* pDst, Uint32 Width, float* pScratch);
+
+// General path: decodes the row into RGBA float texels and encodes them into the destination format
+void ConvertRowGeneral(const RowConversionInfo& Info, const Uint8* pSrc, Uint8* pDst, Uint32 Width, float* pScratch)
+{
+    const auto& Src = Info.Src;
+    const auto& Dst = Info.Dst;
+
+    for (Uint32 x = 0; x < Width; ++x)
+    {
+        float* Texel = pScratch + size_t{x} * 4;
+        Texel[0]     = 0;
+        Texel[1]     = 0;
+        Texel[2]     = 0;
+        Texel[3]     = 1;
+
+        for (Uint32 c = 0; c < Src.NumComponents; ++c)
+        {
+            const auto  Channel = Src.GetChannel(c);
+            const auto* pComp   = pSrc + c * Src.ComponentSize;
+            Texel[Channel]      = Src.IsSRGBColor(Channel) ? SRGBToLinear(*pComp) : Info.Decode(pComp);
+        }
+        pSrc += Src.GetTexelSize();
+    }
+
+    for (Uint32 x = 0; x < Width; ++x)
+    {
+        const float* Texel = pScratch + size_t{x} * 4;
+        for (Uint32 c = 0; c < Dst.NumComponents; ++c)
+        {
+            const auto Channel = Dst.GetChannel(c);
+            auto*      pComp   = pDst + c * Dst.ComponentSize;
+            if (Dst.IsSRGBColor(Channel))
+                *pComp = LinearToSRGB8(Texel[Channel]);
+            else
+                Info.Encode(pComp, Texel[Channel]);
+        }
+        pDst += Dst.GetTexelSize();
+    }
+}
+
+// Integer path: same as the general path, but the values are kept in 64-bit integers
+void ConvertRowInteger(const RowConversionInfo& Info, const Uint8* pSrc, Uint8* pDst, Uint32 Width, float* /*pScratch*/)
+{
+    const auto& Src = Info.Src;
+    const auto& Dst = Info.Dst;
+
+    for (Uint32 x = 0; x < Width; ++x)
+    {
+        Int64 Texel[4] = {0, 0, 0, 1};
+        for (Uint32 c = 0; c < Src.NumComponents; ++c)
+            Texel[Src.GetChannel(c)] = Info.DecodeInt(pSrc + c * Src.ComponentSize);
+
+        for (Uint32 c = 0; c < Dst.NumComponents; ++c)
+            Info.EncodeInt(pDst + c * Dst.ComponentSize, Texel[Dst.GetChannel(c)]);
+
+        pSrc += Src.GetTexelSize();
+        pDst += Dst.GetTexelSize();
+    }
+}
+
+void CopyRow(const RowConversionInfo& Info, const Uint8* pSrc, Uint8* pDst, Uint32 Width, float* /*pScratch*/)
+{
+    memcpy(pDst, pSrc, size_t{Width} * Info.Src.GetTexelSize());
+}
+
+// 8-bit RGB -> RGBA with the alpha set to 0xFF, optionally swapping R and B
+template <bool SwapRB>
+void ExpandRGB8ToRGBA8(const RowConversionInfo& /*Info*/, const Uint8* pSrc, Uint8* pDst, Uint32 Width, float* /*pScratch*/)
+{
+    Uint32 x = 0;
+#if DILIGENT_TEX_CONV_SSSE3
+    {
+        // clang-format off
+        const __m128i Shuffle = SwapRB ?
+            _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10,  9, -1) :
+            _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1,  9, 10, 11, -1);
+        // clang-format on
+        const __m128i Alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+        // Every iteration reads 16 bytes and uses 12 of them
+        for (; x + 6 <= Width; x += 4)
+        {
+            const __m128i RGB = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + x * 3));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + x * 4), _mm_or_si128(_mm_shuffle_epi8(RGB, Shuffle), Alpha));
+        }
+    }
+#elif DILIGENT_TEX_CONV_NEON
+    for (; x + 16 <= Width; x += 16)
+    {
+        const uint8x16x3_t RGB = vld3q_u8(pSrc + x * 3);
+        uint8x16x4_t       RGBA;
+        RGBA.val[0] = SwapRB ? RGB.val[2] : RGB.val[0];
+        RGBA.val[1] = RGB.val[1];
+        RGBA.val[2] = SwapRB ? RGB.val[0] : RGB.val[2];
+        RGBA.val[3] = vdupq_n_u8(0xFF);
+        vst4q_u8(pDst + x * 4, RGBA);
+    }
+#endif
+    for (; x < Width; ++x)
+    {
+        pDst[x * 4 + 0] = pSrc[x * 3 + (SwapRB ? 2 : 0)];
+        pDst[x * 4 + 1] = pSrc[x * 3 + 1];
+        pDst[x * 4 + 2] = pSrc[x * 3 + (SwapRB ? 0 : 2)];
+        pDst[x * 4 + 3] = 0xFF;
+    }
+}
+
+// 8-bit RGBA <-> BGRA
+void SwapRB8(const RowConversionInfo& /*Info*/, const Uint8* pSrc, Uint8* pDst, Uint32 Width, float* /*pScratch*/)
+{
+    Uint32 x = 0;
+#if DILIGENT_TEX_CONV_AVX2
+    {
+        const __m256i MaskAG = _mm256_set1_epi32(static_cast<int>(0xFF00FF00u));
+        const __m256i MaskRB = _mm256_set1_epi32(0x00FF00FF);
+        for (; x + 8 <= Width; x += 8)
+        {
+            const __m256i Texels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pSrc + x * 4));
+            const __m256i RB     = _mm256_and_si256(Texels, MaskRB);
+            const __m256i BR     = _mm256_or_si256(_mm256_slli_epi32(RB, 16), _mm256_srli_epi32(RB, 16));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(pDst + x * 4), _mm256_or_si256(_mm256_and_si256(Texels, MaskAG), BR));
+        }
+    }
+#endif
+#if DILIGENT_TEX_CONV_SSE2
+    {
+        const __m128i MaskAG = _mm_set1_epi32(static_cast<int>(0xFF00FF00u));
+        const __m128i MaskRB = _mm_set1_epi32(0x00FF00FF);
+        for (; x + 4 <= Width; x += 4)
+        {
+            const __m128i Texels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + x * 4));
+            const __m128i RB     = _mm_and_si128(Texels, MaskRB);
+            const __m128i BR     = _mm_or_si128(_mm_slli_epi32(RB, 16), _mm_srli_epi32(RB, 16));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + x * 4), _mm_or_si128(_mm_and_si128(Texels, MaskAG), BR));
+        }
+    }
+#elif DILIGENT_TEX_CONV_NEON
+    for (; x + 16 <= Width; x += 16)
+    {
+        uint8x16x4_t Texels = vld4q_u8(pSrc + x * 4);
+        std::swap(Texels.val[0], Texels.val[2]);
+        vst4q_u8(pDst + x * 4, Texels);
+    }
+#endif
+    for (; x < Width; ++x)
+    {
+        const Uint8 R   = pSrc[x * 4 + 0];
+        pDst[x * 4 + 0] = pSrc[x * 4 + 2];
+        pDst[x * 4 + 1] = pSrc[x * 4 + 1];
+        pDst[x * 4 + 2] = R;
+        pDst[x * 4 + 3] = pSrc[x * 4 + 3];
+    }
+}
+
+// 8-bit sRGB <-> 8-bit linear with the same channel layout. Alpha is copied.
+template <bool ToLinear>
+void ConvertSRGB8(const RowConversionInfo& Info, const Uint8* pSrc, Uint8* pDst, Uint32 Width, float* /*pScratch*/)
+{
+    const auto& Tables        = SRGB8Tables::Get();
+    const auto& ColorTable    = ToLinear ? Tables.ToLinear : Tables.ToSRGB;
+    const auto  NumComponents = Info.Src.NumComponents;
+
+    // Resolve the table for every component once rather than per texel
+    const Uint8* ComponentTables[4] = {};
+    for (Uint32 c = 0; c < NumComponents; ++c)
+        ComponentTables[c] = Info.Src.GetChannel(c) < 3 ? ColorTable.data() : Tables.Identity.data();
+
+    if (NumComponents == 4)
+    {
+        const Uint8* T0 = ComponentTables[0];
+        const Uint8* T1 = ComponentTables[1];
+        const Uint8* T2 = ComponentTables[2];
+        const Uint8* T3 = ComponentTables[3];
+        for (Uint32 x = 0; x < Width; ++x, pSrc += 4, pDst += 4)
+        {
+            pDst[0] = T0[pSrc[0]];
+            pDst[1] = T1[pSrc[1]];
+            pDst[2] = T2[pSrc[2]];
+            pDst[3] = T3[pSrc[3]];
+        }
+    }
+    else
+    {
+        for (Uint32 x = 0; x < Width; ++x)
+        {
+            for (Uint32 c = 0; c < NumComponents; ++c, ++pSrc, ++pDst)
+                *pDst = ComponentTables[c][*pSrc];
+        }
+    }
+}
+
+// 8-bit sRGB -> 32-bit float
+void SRGB8ToFloat(const RowConversionInfo& Info, const Uint8* pSrc, Uint8* pDst, Uint32 Width, float* /*pScratch*/)
+{
+    const auto NumComponents = Info.Src.NumComponents;
+    auto*      pDstFloat     = reinterpret_cast<float*>(pDst);
+    for (Uint32 x = 0; x < Width; ++x)
+    {
+        for (Uint32 c = 0; c < NumComponents; ++c)
+        {
+            const auto Val = pSrc[x * NumComponents + c];
+            const auto f   = Info.Src.GetChannel(c) < 3 ? SRGBToLinear(Val) : static_cast<float>(Val) * (1.f / 255.f);
+            StoreComponent(reinterpret_cast<Uint8*>(pDstFloat + x * NumComponents + c), f);
+        }
+    }
+}
+
+// 8-bit or 16-bit UNORM -> 32-bit float, component-wise
+template <typename T>
+void UNormToFloat(const RowConversionInfo& Info, const Uint8* pSrc, Uint8* pDst, Uint32 Width, float* /*pScratch*/)
+{
+    const size_t NumValues = size_t{Width} * Info.Src.NumComponents;
+
+    size_t i = 0;
+#if DILIGENT_TEX_CONV_SSE2 || DILIGENT_TEX_CONV_NEON
+    // Must be the same scale as in DecodeUNorm() so that the tail produces identical results
+    constexpr float Scale = 1.f / static_cast<float>(std::numeric_limits<T>::max());
+#endif
+#if DILIGENT_TEX_CONV_AVX2
+    {
+        const __m256 vScale = _mm256_set1_ps(Scale);
+        for (; i + 8 <= NumValues; i += 8)
+        {
+            const __m256i Ints = sizeof(T) == 1 ?
+                _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pSrc + i))) :
+                _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i * 2)));
+            _mm256_storeu_ps(reinterpret_cast<float*>(pDst) + i, _mm256_mul_ps(_mm256_cvtepi32_ps(Ints), vScale));
+        }
+    }
+#elif DILIGENT_TEX_CONV_SSE2
+    {
+        const __m128  vScale = _mm_set1_ps(Scale);
+        const __m128i Zero   = _mm_setzero_si128();
+        for (; i + 8 <= NumValues; i += 8)
+        {
+            const __m128i Ints16 = sizeof(T) == 1 ?
+                _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pSrc + i)), Zero) :
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i * 2));
+            const __m128 Lo = _mm_cvtepi32_ps(_mm_unpacklo_epi16(Ints16, Zero));
+            const __m128 Hi = _mm_cvtepi32_ps(_mm_unpackhi_epi16(Ints16, Zero));
+            _mm_storeu_ps(reinterpret_cast<float*>(pDst) + i + 0, _mm_mul_ps(Lo, vScale));
+            _mm_storeu_ps(reinterpret_cast<float*>(pDst) + i + 4, _mm_mul_ps(Hi, vScale));
+        }
+    }
+#elif DILIGENT_TEX_CONV_NEON
+    for (; i + 8 <= NumValues; i += 8)
+    {
+        const uint16x8_t Ints16 = sizeof(T) == 1 ?
+            vmovl_u8(vld1_u8(pSrc + i)) :
+            vreinterpretq_u16_u8(vld1q_u8(pSrc + i * 2));
+        const float32x4_t Lo = vcvtq_f32_u32(vmovl_u16(vget_low_u16(Ints16)));
+        const float32x4_t Hi = vcvtq_f32_u32(vmovl_u16(vget_high_u16(Ints16)));
+        vst1q_f32(reinterpret_cast<float*>(pDst) + i + 0, vmulq_n_f32(Lo, Scale));
+        vst1q_f32(reinterpret_cast<float*>(pDst) + i + 4, vmulq_n_f32(Hi, Scale));
+    }
+#endif
+    for (; i < NumValues; ++i)
+        StoreComponent(pDst + i * 4, DecodeUNorm<T>(pSrc + i * sizeof(T)));
+}
+
+#if DILIGENT_TEX_CONV_SSE2 && !DILIGENT_TEX_CONV_F16C
+// SSE2 version of FloatToHalf() for four values. The results are returned in 32-bit lanes.
+__m128i FloatToHalfSSE2(__m128 f)
+{
+    const __m128i F32Infinity  = _mm_set1_epi32(255 << 23);
+    const __m128i F16MaxMinus1 = _mm_set1_epi32(((127 + 16) << 23) - 1);
+    const __m128i MinNormal    = _mm_set1_epi32(113 << 23);
+    const __m128i DenormMagic  = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+    const __m128i One          = _mm_set1_epi32(1);
+
+    const __m128i u    = _mm_castps_si128(f);
+    const __m128i Sign = _mm_and_si128(u, _mm_set1_epi32(static_cast<int>(0x80000000u)));
+    const __m128i a    = _mm_xor_si128(u, Sign); // Non-negative, so signed comparisons are valid
+
+    // Inf or NaN
+    const __m128i IsInfNaN = _mm_cmpgt_epi32(a, F16MaxMinus1);
+    const __m128i InfNaN   = _mm_or_si128(_mm_set1_epi32(0x7C00), _mm_and_si128(_mm_cmpgt_epi32(a, F32Infinity), _mm_set1_epi32(0x200)));
+
+    // Denormal or zero
+    const __m128i IsDenorm = _mm_cmpgt_epi32(MinNormal, a);
+    const __m128i Denorm   = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(DenormMagic))), DenormMagic);
+
+    // Normal
+    const __m128i MantissaOdd = _mm_and_si128(_mm_srli_epi32(a, 13), One);
+    const __m128i Rebiased    = _mm_add_epi32(_mm_add_epi32(a, _mm_set1_epi32(-((127 - 15) << 23) + 0xFFF)), MantissaOdd);
+    const __m128i Normal      = _mm_srli_epi32(Rebiased, 13);
+
+    __m128i h = _mm_or_si128(_mm_and_si128(IsDenorm, Denorm), _mm_andnot_si128(IsDenorm, Normal));
+    h         = _mm_or_si128(_mm_and_si128(IsInfNaN, InfNaN), _mm_andnot_si128(IsInfNaN, h));
+    return _mm_or_si128(h, _mm_srli_epi32(Sign, 16));
+}
+
+// SSE2 version of HalfToFloat() for four values stored in 32-bit lanes
+__m128 HalfToFloatSSE2(__m128i h)
+{
+    const __m128i ShiftedExp = _mm_set1_epi32(0x7C00 << 13);
+    const __m128i Magic      = _mm_set1_epi32(113 << 23);
+
+    __m128i       u   = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x7FFF)), 13);
+    const __m128i Exp = _mm_and_si128(u, ShiftedExp);
+    u                 = _mm_add_epi32(u, _mm_set1_epi32((127 - 15) << 23));
+
+    const __m128i IsInfNaN = _mm_cmpeq_epi32(Exp, ShiftedExp);
+    const __m128i IsDenorm = _mm_cmpeq_epi32(Exp, _mm_setzero_si128());
+
+    const __m128i InfNaN = _mm_add_epi32(u, _mm_set1_epi32((128 - 16) << 23));
+    const __m128i Denorm = _mm_castps_si128(_mm_sub_ps(_mm_castsi128_ps(_mm_add_epi32(u, _mm_set1_epi32(1 << 23))), _mm_castsi128_ps(Magic)));
+
+    u = _mm_or_si128(_mm_and_si128(IsInfNaN, InfNaN), _mm_andnot_si128(IsInfNaN, u));
+    u = _mm_or_si128(_mm_and_si128(IsDenorm, Denorm), _mm_andnot_si128(IsDenorm, u));
+    u = _mm_or_si128(u, _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x8000)), 16));
+    return _mm_castsi128_ps(u);
+}
+#endif
+
+// 32-bit float -> 16-bit float, component-wise
+void FloatToHalfRow(const RowConversionInfo& Info, const Uint8* pSrc, Uint8* pDst, Uint32 Width, float* /*pScratch*/)
+{
+    const size_t NumValues = size_t{Width} * Info.Src.NumComponents;
+
+    size_t i = 0;
+#if DILIGENT_TEX_CONV_F16C
+    for (; i + 8 <= NumValues; i += 8)
+    {
+        const __m256 f = _mm256_loadu_ps(reinterpret_cast<const float*>(pSrc) + i);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i * 2), _mm256_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT));
+    }
+#elif DILIGENT_TEX_CONV_SSE2
+    for (; i + 8 <= NumValues; i += 8)
+    {
+        const __m128i Lo = FloatToHalfSSE2(_mm_loadu_ps(reinterpret_cast<const float*>(pSrc) + i + 0));
+        const __m128i Hi = FloatToHalfSSE2(_mm_loadu_ps(reinterpret_cast<const float*>(pSrc) + i + 4));
+        // Sign-extend the 16-bit values so that the signed saturation of packs is a no-op
+        const __m128i Packed = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(Lo, 16), 16), _mm_srai_epi32(_mm_slli_epi32(Hi, 16), 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i * 2), Packed);
+    }
+#elif DILIGENT_TEX_CONV_NEON && defined(__aarch64__)
+    for (; i + 4 <= NumValues; i += 4)
+    {
+        const float16x4_t h = vcvt_f16_f32(vld1q_f32(reinterpret_cast<const float*>(pSrc) + i));
+        vst1_u16(reinterpret_cast<uint16_t*>(pDst + i * 2), vreinterpret_u16_f16(h));
+    }
+#endif
+    for (; i < NumValues; ++i)
+        StoreComponent(pDst + i * 2, FloatToHalf(LoadComponent<float>(pSrc + i * 4)));
+}
+
+// 16-bit float -> 32-bit float, component-wise
+void HalfToFloatRow(const RowConversionInfo& Info, const Uint8* pSrc, Uint8* pDst, Uint32 Width, float* /*pScratch*/)
+{
+    const size_t NumValues = size_t{Width} * Info.Src.NumComponents;
+
+    size_t i = 0;
+#if DILIGENT_TEX_CONV_F16C
+    for (; i + 8 <= NumValues; i += 8)
+    {
+        const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i * 2));
+        _mm256_storeu_ps(reinterpret_cast<float*>(pDst) + i, _mm256_cvtph_ps(h));
+    }
+#elif DILIGENT_TEX_CONV_SSE2
+    for (; i + 8 <= NumValues; i += 8)
+    {
+        const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i * 2));
+        _mm_storeu_ps(reinterpret_cast<float*>(pDst) + i + 0, HalfToFloatSSE2(_mm_unpacklo_epi16(h, _mm_setzero_si128())));
+        _mm_storeu_ps(reinterpret_cast<float*>(pDst) + i + 4, HalfToFloatSSE2(_mm_unpackhi_epi16(h, _mm_setzero_si128())));
+    }
+#elif DILIGENT_TEX_CONV_NEON && defined(__aarch64__)
+    for (; i + 4 <= NumValues; i += 4)
+    {
+        const float16x4_t h = vreinterpret_f16_u16(vld1_u16(reinterpret_cast<const uint16_t*>(pSrc + i * 2)));
+        vst1q_f32(reinterpret_cast<float*>(pDst) + i, vcvt_f32_f16(h));
+    }
+#endif
+    for (; i < NumValues; ++i)
+        StoreComponent(pDst + i * 4, HalfToFloat(LoadComponent<Uint16>(pSrc + i * 2)));
+}
+
+ConvertRowFunc FindRowConversionFunc(const TexelLayout& Src, const TexelLayout& Dst)
+{
+    if (Src == Dst)
+        return CopyRow;
+
+    if (IsIntegerLayout(Src) && IsIntegerLayout(Dst))
+        return ConvertRowInteger;
+
+    const bool Is8BitColor = //
+        Src.ComponentSize == 1 && Dst.ComponentSize == 1 &&
+        !Src.AlphaOnly && !Dst.AlphaOnly &&
+        (Src.Type == COMPONENT_TYPE_UNORM || Src.Type == COMPONENT_TYPE_UNORM_SRGB);
+
+    if (Is8BitColor && Src.Type == Dst.Type)
+    {
+        if (Src.NumComponents == 3 && Dst.NumComponents == 4)
+            return Src.SwapRB != Dst.SwapRB ? ExpandRGB8ToRGBA8<true> : ExpandRGB8ToRGBA8<false>;
+        if (Src.NumComponents == 4 && Dst.NumComponents == 4 && Src.SwapRB != Dst.SwapRB)
+            return SwapRB8;
+    }
+
+    if (!Src.HasSameChannels(Dst))
+        return ConvertRowGeneral;
+
+    if (Is8BitColor)
+    {
+        if (Src.Type == COMPONENT_TYPE_UNORM_SRGB && Dst.Type == COMPONENT_TYPE_UNORM)
+            return ConvertSRGB8<true>;
+        if (Src.Type == COMPONENT_TYPE_UNORM && Dst.Type == COMPONENT_TYPE_UNORM_SRGB)
+            return ConvertSRGB8<false>;
+    }
+
+    if (Dst.Type == COMPONENT_TYPE_FLOAT && Dst.ComponentSize == 4)
+    {
+        if (Src.Type == COMPONENT_TYPE_UNORM_SRGB)
+            return SRGB8ToFloat;
+        if (Src.Type == COMPONENT_TYPE_UNORM && Src.ComponentSize == 1)
+            return UNormToFloat<Uint8>;
+        if (Src.Type == COMPONENT_TYPE_UNORM && Src.ComponentSize == 2)
+            return UNormToFloat<Uint16>;
+        if (Src.Type == COMPONENT_TYPE_FLOAT && Src.ComponentSize == 2)
+            return HalfToFloatRow;
+    }
+
+    if (Src.Type == COMPONENT_TYPE_FLOAT && Src.ComponentSize == 4 && Dst.Type == COMPONENT_TYPE_FLOAT && Dst.ComponentSize == 2)
+        return FloatToHalfRow;
+
+    return ConvertRowGeneral;
+}
+
+} // namespace
+
+bool IsTextureDataConversionSupported(TEXTURE_FORMAT SrcFormat, TEXTURE_FORMAT DstFormat)
+{
+    TexelLayout Src, Dst;
+    return GetTexelLayout(SrcFormat, 0, Src) && GetTexelLayout(DstFormat, 0, Dst);
+}
+
+bool ConvertTextureData(const TextureDataConversionAttribs& Attribs)
+{
+    RowConversionInfo Info;
+    if (!GetTexelLayout(Attribs.SrcFormat, Attribs.SrcComponentCount, Info.Src) ||
+        !GetTexelLayout(Attribs.DstFormat, Attribs.DstComponentCount, Info.Dst))
+    {
+        LOG_ERROR_MESSAGE("Conversion from ", GetTextureFormatAttribs(Attribs.SrcFormat).Name, " (", Attribs.SrcComponentCount,
+                          " components) to ", GetTextureFormatAttribs(Attribs.DstFormat).Name, " (", Attribs.DstComponentCount,
+                          " components) is not supported");
+        return false;
+    }
+
+    if (Attribs.Width == 0 || Attribs.Height == 0 || Attribs.Depth == 0)
+        return true;
+
+    if (Attribs.pSrcData == nullptr || Attribs.pDstData == nullptr)
+    {
+        LOG_ERROR_MESSAGE("Source and destination data must not be null");
+        return false;
+    }
+
+    const auto SrcRowSize     = Uint64{Attribs.Width} * Info.Src.GetTexelSize();
+    const auto DstRowSize     = Uint64{Attribs.Width} * Info.Dst.GetTexelSize();
+    const auto SrcStride      = Attribs.SrcStride != 0 ? Attribs.SrcStride : SrcRowSize;
+    const auto DstStride      = Attribs.DstStride != 0 ? Attribs.DstStride : DstRowSize;
+    const auto SrcDepthStride = Attribs.SrcDepthStride != 0 ? Attribs.SrcDepthStride : SrcStride * Attribs.Height;
+    const auto DstDepthStride = Attribs.DstDepthStride != 0 ? Attribs.DstDepthStride : DstStride * Attribs.Height;
+    if (SrcStride < SrcRowSize || DstStride < DstRowSize)
+    {
+        LOG_ERROR_MESSAGE("Row stride (", SrcStride, " source, ", DstStride, " destination) is smaller than the row size (",
+                          SrcRowSize, " source, ", DstRowSize, " destination)");
+        return false;
+    }
+    if ((Attribs.Depth > 1) && (SrcDepthStride < SrcStride * Attribs.Height || DstDepthStride < DstStride * Attribs.Height))
+    {
+        LOG_ERROR_MESSAGE("Depth stride is smaller than the depth slice size");
+        return false;
+    }
+
+    const auto ConvertRow = FindRowConversionFunc(Info.Src, Info.Dst);
+    if (ConvertRow == ConvertRowGeneral)
+    {
+        Info.Decode = GetDecodeFunc(Info.Src);
+        Info.Encode = GetEncodeFunc(Info.Dst);
+    }
+    else if (ConvertRow == ConvertRowInteger)
+    {
+        Info.DecodeInt = GetDecodeIntFunc(Info.Src);
+        Info.EncodeInt = GetEncodeIntFunc(Info.Dst);
+    }
+
+    const auto* const pSrcData = static_cast<const Uint8*>(Attribs.pSrcData);
+    auto* const       pDstData = static_cast<Uint8*>(Attribs.pDstData);
+
+    const Uint32 NumRows = Attribs.Height * Attribs.Depth;
+
+    ParallelForRanges(NumRows, Attribs.NumThreads, [&](Uint32 FirstRow, Uint32 EndRow) {
+        std::vector<float> Scratch(ConvertRow == ConvertRowGeneral ? size_t{Attribs.Width} * 4 : 0);
+        for (Uint32 row = FirstRow; row < EndRow; ++row)
+        {
+            const Uint32 y = row % Attribs.Height;
+            const Uint32 z = row / Attribs.Height;
+
+            const auto* pSrc = pSrcData + z * SrcDepthStride + y * SrcStride;
+            auto*       pDst = pDstData + z * DstDepthStride + y * DstStride;
+            ConvertRow(Info, pSrc, pDst, Attribs.Width, Scratch.data());
+        }
+    });
+
+    return true;
+}
+
+} // namespace Diligent
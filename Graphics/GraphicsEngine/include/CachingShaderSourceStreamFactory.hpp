@@ -0,0 +1,101 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Declaration of the caching shader source stream factory
+
+#include <vector>
+
+#include "../../GraphicsEngine/interface/Shader.h"
+
+namespace Diligent
+{
+
+// {45A8F723-AAA3-4B2E-A1CB-580D210940AF}
+static const INTERFACE_ID IID_CachingShaderSourceStreamFactory =
+    {0x45a8f723, 0xaaa3, 0x4b2e, {0xa1, 0xcb, 0x58, 0xd, 0x21, 0x9, 0x40, 0xaf}};
+
+/// Caching shader source stream factory statistics
+struct CachingShaderSourceStreamFactoryStats
+{
+    /// The number of streams created from the cached data.
+    Uint64 Hits = 0;
+
+    /// The number of files requested from the base factory, including the files that were not found.
+    Uint64 Misses = 0;
+
+    /// The number of cached files.
+    Uint32 NumFiles = 0;
+
+    /// The total size of the cached data, in bytes.
+    Uint64 Size = 0;
+};
+
+/// Shader source stream factory that caches the files loaded by another factory.
+
+/// Every file is requested from the base factory only once, and all streams created for the file
+/// share the same immutable data blob. Compiling shaders that include the same headers thus
+/// does not search, open or read the headers again. Files that were not found are remembered too.
+///
+/// Every loaded file is scanned for #include directives to build the include dependency graph
+/// (see GetDependencies()). The scan does not evaluate preprocessor conditions, so the graph may
+/// list files that a particular compilation does not include.
+///
+/// The cache is never invalidated implicitly, so that hits do not access the file system.
+/// If the base factory implements IShaderSourceFileStreamFactory (the default factory does),
+/// InvalidateModifiedFiles() finds the cached files that were modified or created and removes them.
+///
+/// All methods are thread-safe.
+class ICachingShaderSourceStreamFactory : public IShaderSourceInputStreamFactory
+{
+public:
+    /// Writes the names of the files that the file includes directly or indirectly to Dependencies.
+    /// Every name is listed once, as written in the #include directive. Only the files loaded by
+    /// the factory are scanned, which, after the shader has been compiled, includes all its dependencies.
+    virtual void DILIGENT_CALL_TYPE GetDependencies(const Char* Name, std::vector<String>& Dependencies) = 0;
+
+    /// Removes the cached files that were modified or deleted since they were loaded, as well as
+    /// the files that were not found but have been created since. Returns the number of removed files.
+    /// If pModifiedFiles is not null, the names of the modified, deleted or created files are appended to it.
+    /// A shader needs to be recompiled if its source file or any of its dependencies is in this list.
+    virtual Uint32 DILIGENT_CALL_TYPE InvalidateModifiedFiles(std::vector<String>* pModifiedFiles = nullptr) = 0;
+
+    /// Removes all files from the cache
+    virtual void DILIGENT_CALL_TYPE Clear() = 0;
+
+    virtual CachingShaderSourceStreamFactoryStats DILIGENT_CALL_TYPE GetStats() = 0;
+};
+
+/// Creates the caching shader source stream factory
+/// \param [in]  pBaseFactory - Factory that loads the files that are not in the cache.
+/// \param [out] ppFactory    - Memory address where the pointer to the caching factory will be written.
+void CreateCachingShaderSourceStreamFactory(IShaderSourceInputStreamFactory*    pBaseFactory,
+                                            ICachingShaderSourceStreamFactory** ppFactory);
+
+} // namespace Diligent
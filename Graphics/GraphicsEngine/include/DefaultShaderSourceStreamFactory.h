@@ -38,4 +38,28 @@ DILIGENT_BEGIN_NAMESPACE(Diligent)
 void CreateDefaultShaderSourceStreamFactory(const Char*                       SearchDirectories,
                                             IShaderSourceInputStreamFactory** ppShaderSourceStreamFactory);
 
+#if DILIGENT_CPP_INTERFACE
+
+// {B6658E19-872F-48AE-8F36-3D020F7EC873}
+static const INTERFACE_ID IID_ShaderSourceFileStreamFactory =
+    {0xb6658e19, 0x872f, 0x48ae, {0x8f, 0x36, 0x3d, 0x2, 0xf, 0x7e, 0xc8, 0x73}};
+
+/// Shader source stream factory that loads the files from the file system.
+
+/// The interface is implemented by the default shader source stream factory. It lets
+/// the caching factory (see CachingShaderSourceStreamFactory.hpp) find out which file
+/// was opened, so that it can detect when the file is modified.
+class IShaderSourceFileStreamFactory : public IShaderSourceInputStreamFactory
+{
+public:
+    /// Creates the input stream the same way as CreateInputStream2() does, and writes
+    /// the path of the file that was opened to FullPath.
+    virtual void DILIGENT_CALL_TYPE CreateFileInputStream(const Char*                             Name,
+                                                          CREATE_SHADER_SOURCE_INPUT_STREAM_FLAGS Flags,
+                                                          IFileStream**                           ppStream,
+                                                          String&                                 FullPath) = 0;
+};
+
+#endif
+
 DILIGENT_END_NAMESPACE // namespace Diligent
@@ -254,6 +254,28 @@ public:
         pResBindingImpl->QueryInterface(IID_ShaderResourceBinding, reinterpret_cast<IObject**>(ppShaderResourceBinding));
     }
 
+    /// Implementation of IPipelineResourceSignature::CreateShaderResourceBindings.
+    virtual void DILIGENT_CALL_TYPE CreateShaderResourceBindings(Uint32                   NumSRBs,
+                                                                 IShaderResourceBinding** ppShaderResourceBindings,
+                                                                 bool                     InitStaticResources) override final
+    {
+        DEV_CHECK_ERR(NumSRBs == 0 || ppShaderResourceBindings != nullptr, "ppShaderResourceBindings must not be null");
+
+        auto* pThisImpl{static_cast<PipelineResourceSignatureImplType*>(this)};
+        auto& SRBAllocator{pThisImpl->m_pDevice->GetSRBAllocator()};
+
+        // Move all required blocks to this thread's caches at once. Every SRB is then created
+        // the same way as by CreateShaderResourceBinding(), so that it can be released on its own.
+        SRBAllocator.Prefetch(NumSRBs);
+        m_SRBMemAllocator.Prefetch(NumSRBs);
+
+        for (Uint32 i = 0; i < NumSRBs; ++i)
+        {
+            DEV_CHECK_ERR(ppShaderResourceBindings[i] == nullptr, "Overwriting reference to existing object may cause memory leaks");
+            CreateShaderResourceBinding(&ppShaderResourceBindings[i], InitStaticResources);
+        }
+    }
+
     /// Implementation of IPipelineResourceSignature::InitializeStaticSRBResources.
     virtual void DILIGENT_CALL_TYPE InitializeStaticSRBResources(IShaderResourceBinding* pSRB) const override final
     {
@@ -368,10 +390,11 @@ public:
     /// index in m_Desc.Resources[], or InvalidResourceIndex if the resource is not found.
     Uint32 FindResource(SHADER_TYPE ShaderStage, const char* ResourceName) const
     {
+        const auto NameHash = ComputeStringHash(ResourceName);
         for (Uint32 r = 0; r < this->m_Desc.NumResources; ++r)
         {
             const auto& ResDesc = this->m_Desc.Resources[r];
-            if ((ResDesc.ShaderStages & ShaderStage) != 0 && strcmp(ResDesc.Name, ResourceName) == 0)
+            if ((ResDesc.ShaderStages & ShaderStage) != 0 && m_pResourceNameHashes[r] == NameHash && strcmp(ResDesc.Name, ResourceName) == 0)
                 return r;
         }
 
@@ -386,6 +409,13 @@ public:
                                               ShaderStage, ResourceName, GetCombinedSamplerSuffix());
     }
 
+    /// Returns the hash of the name of the resource with index ResIndex, see ComputeStringHash().
+    size_t GetResourceNameHash(Uint32 ResIndex) const
+    {
+        VERIFY_EXPR(ResIndex < this->m_Desc.NumResources);
+        return m_pResourceNameHashes[ResIndex];
+    }
+
     const PipelineResourceDesc& GetResourceDesc(Uint32 ResIndex) const
     {
         VERIFY_EXPR(ResIndex < this->m_Desc.NumResources);
@@ -546,6 +576,7 @@ private:
     {
         Allocator.AddSpace<PipelineResourceDesc>(Desc.NumResources);
         Allocator.AddSpace<ImmutableSamplerDesc>(Desc.NumImmutableSamplers);
+        Allocator.AddSpace<size_t>(Desc.NumResources);
 
         for (Uint32 i = 0; i < Desc.NumResources; ++i)
         {
@@ -573,8 +604,9 @@ private:
 
     void CopyDescription(FixedLinearAllocator& Allocator, const PipelineResourceSignatureDesc& Desc) noexcept(false)
     {
-        PipelineResourceDesc* pResources = Allocator.ConstructArray<PipelineResourceDesc>(Desc.NumResources);
-        ImmutableSamplerDesc* pSamplers  = Allocator.ConstructArray<ImmutableSamplerDesc>(Desc.NumImmutableSamplers);
+        PipelineResourceDesc* pResources  = Allocator.ConstructArray<PipelineResourceDesc>(Desc.NumResources);
+        ImmutableSamplerDesc* pSamplers   = Allocator.ConstructArray<ImmutableSamplerDesc>(Desc.NumImmutableSamplers);
+        size_t*               pNameHashes = Allocator.ConstructArray<size_t>(Desc.NumResources);
 
         for (Uint32 i = 0; i < Desc.NumResources; ++i)
         {
@@ -607,6 +639,11 @@ private:
         }
 #endif
 
+        // Name hashes are computed after the resources have been sorted
+        for (Uint32 i = 0; i < Desc.NumResources; ++i)
+            pNameHashes[i] = ComputeStringHash(pResources[i].Name);
+        m_pResourceNameHashes = pNameHashes;
+
         for (Uint32 i = 0; i < Desc.NumImmutableSamplers; ++i)
         {
             const auto& SrcSam = Desc.ImmutableSamplers[i];
@@ -632,6 +669,7 @@ protected:
         this->m_Desc.Resources             = nullptr;
         this->m_Desc.ImmutableSamplers     = nullptr;
         this->m_Desc.CombinedSamplerSuffix = nullptr;
+        m_pResourceNameHashes              = nullptr;
 
         auto& RawAllocator = GetRawAllocator();
 
@@ -713,6 +751,9 @@ protected:
     // Pipeline resource attributes
     PipelineResourceAttribsType* m_pResourceAttribs = nullptr; // [m_Desc.NumResources]
 
+    // Resource name hashes that are compared before the names themselves
+    const size_t* m_pResourceNameHashes = nullptr; // [m_Desc.NumResources]
+
     // Static resource cache for all static resources
     ShaderResourceCacheImplType* m_pStaticResCache = nullptr;
 
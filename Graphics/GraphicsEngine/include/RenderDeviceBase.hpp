@@ -41,6 +41,7 @@
 #include "SwapChain.h"
 #include "GraphicsAccessories.hpp"
 #include "FixedBlockMemoryAllocator.hpp"
+#include "ThreadPool.hpp"
 #include "EngineMemory.h"
 #include "STDAllocator.hpp"
 #include "IndexWrapper.hpp"
@@ -260,7 +261,7 @@ public:
         m_ShaderObjAllocator    {RawMemAllocator, sizeof(ShaderImplType),                     32},
         m_SamplerObjAllocator   {RawMemAllocator, sizeof(SamplerImplType),                    32},
         m_PSOAllocator          {RawMemAllocator, sizeof(PipelineStateImplType),             128},
-        m_SRBAllocator          {RawMemAllocator, sizeof(ShaderResourceBindingImplType),    1024},
+        m_SRBAllocator          {RawMemAllocator, sizeof(ShaderResourceBindingImplType),    1024, FixedBlockAllocatorMode::ThreadCaching},
         m_ResMappingAllocator   {RawMemAllocator, sizeof(ResourceMappingImpl),                16},
         m_FenceAllocator        {RawMemAllocator, sizeof(FenceImplType),                      16},
         m_QueryAllocator        {RawMemAllocator, sizeof(QueryImplType),                      16},
@@ -439,6 +440,25 @@ public:
 
     VALIDATION_FLAGS GetValidationFlags() const { return m_ValidationFlags; }
 
+    /// Implementation of IRenderDevice::CreateShaders.
+    virtual void DILIGENT_CALL_TYPE CreateShaders(Uint32                  NumShaders,
+                                                  const ShaderCreateInfo* pShaderCIs,
+                                                  IShader**               ppShaders) override
+    {
+        DEV_CHECK_ERR(NumShaders == 0 || (pShaderCIs != nullptr && ppShaders != nullptr), "pShaderCIs and ppShaders must not be null");
+        if (NumShaders == 0 || pShaderCIs == nullptr || ppShaders == nullptr)
+            return;
+
+        auto* pThisImpl{static_cast<RenderDeviceImplType*>(this)};
+        // The loop body must not throw, so every shader is created through the guarded helper,
+        // whether the pool runs the loop on the calling thread or on the worker threads.
+        GetShaderCompilationPool().ParallelFor(NumShaders,
+                                               [&](Uint32 i) //
+                                               {
+                                                   CreateShaderNoThrow(*pThisImpl, pShaderCIs[i], ppShaders[i]);
+                                               });
+    }
+
     // Convenience function
     const DeviceFeatures& GetFeatures() const
     {
@@ -448,6 +468,42 @@ public:
 protected:
     virtual void TestTextureFormat(TEXTURE_FORMAT TexFormat) = 0;
 
+    /// Returns the create info of the thread pool that compiles shaders in CreateShaders().
+
+    /// Backends override this method to set up per-thread compiler state. The pool is destroyed
+    /// by the RenderDeviceBase destructor, so the thread callbacks must not reference the device.
+    virtual ThreadPool::CreateInfo GetShaderCompilationPoolCreateInfo() const
+    {
+        return ThreadPool::CreateInfo{};
+    }
+
+    /// Creates the shader and sets pShader to null if an exception is thrown.
+    static void CreateShaderNoThrow(RenderDeviceImplType& Device, const ShaderCreateInfo& ShaderCI, IShader*& pShader) noexcept
+    {
+        try
+        {
+            Device.CreateShader(ShaderCI, &pShader);
+        }
+        catch (...)
+        {
+            if (pShader != nullptr)
+            {
+                pShader->Release();
+                pShader = nullptr;
+            }
+            LOG_ERROR_MESSAGE("Failed to create shader '", (ShaderCI.Desc.Name != nullptr ? ShaderCI.Desc.Name : ""), "'");
+        }
+    }
+
+    /// Returns the shader compilation thread pool, creating it on first use.
+    ThreadPool& GetShaderCompilationPool()
+    {
+        std::lock_guard<std::mutex> Lock{m_ShaderCompilationPoolMtx};
+        if (!m_pShaderCompilationPool)
+            m_pShaderCompilationPool.reset(new ThreadPool{GetShaderCompilationPoolCreateInfo()});
+        return *m_pShaderCompilationPool;
+    }
+
     /// Helper template function to facilitate device object creation
 
     /// \tparam ObjectType            - The type of the object being created (IBuffer, ITexture, etc.).
@@ -690,6 +746,9 @@ protected:
     FixedBlockMemoryAllocator m_TLASAllocator;        ///< Allocator for top-level acceleration structure objects
     FixedBlockMemoryAllocator m_SBTAllocator;         ///< Allocator for shader binding table objects
     FixedBlockMemoryAllocator m_PipeResSignAllocator; ///< Allocator for pipeline resource signature objects
+
+    std::mutex                  m_ShaderCompilationPoolMtx;
+    std::unique_ptr<ThreadPool> m_pShaderCompilationPool; ///< Worker threads used by CreateShaders(), created on first use
 };
 
 } // namespace Diligent
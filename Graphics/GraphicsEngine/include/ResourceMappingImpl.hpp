@@ -124,7 +124,7 @@ private:
 
     ThreadingTools::LockHelper Lock();
 
-    ThreadingTools::LockFlag m_LockFlag;
+    ThreadingTools::LockFlag m_LockFlag{"ResourceMapping"};
 
     using HashTableElem = std::pair<const ResMappingHashKey, RefCntAutoPtr<IDeviceObject>>;
     std::unordered_map<ResMappingHashKey,
@@ -784,6 +784,8 @@ struct ShaderVariableBase : public ResourceVariableBaseInterface
 
     const PipelineResourceDesc& GetDesc() const { return m_ParentManager.GetResourceDesc(m_ResIndex); }
 
+    size_t GetNameHash() const { return m_ParentManager.GetResourceNameHash(m_ResIndex); }
+
 protected:
     // Variable manager that owns this variable
     VarManagerType& m_ParentManager;
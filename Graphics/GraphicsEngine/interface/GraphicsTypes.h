@@ -2878,6 +2878,18 @@ struct EngineVkCreateInfo DILIGENT_DERIVE(EngineCreateInfo)
     /// features when compiling shaders from HLSL.
     const char* pDxCompilerPath DEFAULT_INITIALIZER(nullptr);
 
+    /// Path to the directory of the persistent shader bytecode cache.
+
+    /// When not null, SPIR-V produced from HLSL and GLSL source is stored in this
+    /// directory and reused by subsequent runs, as long as the preprocessed source,
+    /// the macros, the entry point and the compiler version do not change.
+    /// The directory may be shared by several processes.
+    const char* pShaderBytecodeCacheDirectory DEFAULT_INITIALIZER(nullptr);
+
+    /// The maximum total size, in bytes, of the shader bytecode cache.
+    /// When the limit is exceeded, least recently used entries are evicted.
+    Uint64 ShaderBytecodeCacheMaxSize DEFAULT_INITIALIZER(256 << 20);
+
 #if DILIGENT_CPP_INTERFACE
     EngineVkCreateInfo() noexcept :
         EngineVkCreateInfo{EngineCreateInfo{}}
@@ -240,6 +240,27 @@ DILIGENT_BEGIN_INTERFACE(IPipelineResourceSignature, IDeviceObject)
     VIRTUAL void METHOD(CreateShaderResourceBinding)(THIS_
                                                      IShaderResourceBinding** ppShaderResourceBinding,
                                                      bool                     InitStaticResources DEFAULT_VALUE(false)) PURE;
+
+    /// Creates multiple shader resource binding objects
+
+    /// \param [in]  NumSRBs                 - The number of shader resource binding objects to create.
+    /// \param [out] ppShaderResourceBindings - Pointer to the array of NumSRBs elements where pointers
+    ///                                         to the new shader resource binding objects are written.
+    /// \param [in]  InitStaticResources     - If set to true, the method will initialize static resources in
+    ///                                         all created objects, see IPipelineResourceSignature::CreateShaderResourceBinding().
+    ///
+    /// \remarks   The method has the same effect as calling IPipelineResourceSignature::CreateShaderResourceBinding()
+    ///            NumSRBs times. Before the objects are created, the blocks for all objects, their resource caches
+    ///            and variable managers are moved to the calling thread's allocator caches under one lock, so that
+    ///            the creation does not contend with other threads that create SRBs at the same time.
+    ///
+    ///            Every object is still allocated individually and can be released independently. The objects
+    ///            are not placed in one contiguous block: blocks that were never used before are handed out in
+    ///            address order, but blocks that were freed by other SRBs are reused first.
+    VIRTUAL void METHOD(CreateShaderResourceBindings)(THIS_
+                                                      Uint32                   NumSRBs,
+                                                      IShaderResourceBinding** ppShaderResourceBindings,
+                                                      bool                     InitStaticResources DEFAULT_VALUE(false)) PURE;
     
 
     /// Binds static resources for the specified shader stages in the pipeline resource signature.
@@ -349,6 +370,7 @@ DILIGENT_END_INTERFACE
 #    define IPipelineResourceSignature_GetDesc(This) (const struct PipelineResourceSignatureDesc*)IDeviceObject_GetDesc(This)
 
 #    define IPipelineResourceSignature_CreateShaderResourceBinding(This, ...)  CALL_IFACE_METHOD(PipelineResourceSignature, CreateShaderResourceBinding, This, __VA_ARGS__)
+#    define IPipelineResourceSignature_CreateShaderResourceBindings(This, ...) CALL_IFACE_METHOD(PipelineResourceSignature, CreateShaderResourceBindings,This, __VA_ARGS__)
 #    define IPipelineResourceSignature_BindStaticResources(This, ...)          CALL_IFACE_METHOD(PipelineResourceSignature, BindStaticResources,         This, __VA_ARGS__)
 #    define IPipelineResourceSignature_GetStaticVariableByName(This, ...)      CALL_IFACE_METHOD(PipelineResourceSignature, GetStaticVariableByName,     This, __VA_ARGS__)
 #    define IPipelineResourceSignature_GetStaticVariableByIndex(This, ...)     CALL_IFACE_METHOD(PipelineResourceSignature, GetStaticVariableByIndex,    This, __VA_ARGS__)
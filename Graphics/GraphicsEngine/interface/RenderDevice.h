@@ -105,6 +105,26 @@ DILIGENT_BEGIN_INTERFACE(IRenderDevice, IObject)
                                       const ShaderCreateInfo REF ShaderCI,
                                       IShader**                   ppShader) PURE;
 
+    /// Creates multiple shader objects
+
+    /// \param [in]  NumShaders - The number of shaders to create.
+    /// \param [in]  pShaderCIs - Pointer to the array of NumShaders shader create info structures,
+    ///                           see Diligent::ShaderCreateInfo for details.
+    /// \param [out] ppShaders  - Pointer to the array of NumShaders elements where pointers to the
+    ///                           new shader interfaces will be written. The function calls AddRef()
+    ///                           for every created shader. If a shader fails to compile, the
+    ///                           corresponding element is set to null.
+    ///
+    /// \remarks   The method has the same effect as calling IRenderDevice::CreateShader() for every
+    ///            element of pShaderCIs, but the shaders are compiled in parallel by an internal pool
+    ///            of worker threads and the calling thread. Compiler messages of every shader are
+    ///            returned through the ppCompilerOutput member of its create info structure.\n
+    ///            OpenGL backend creates the shaders one by one in the calling thread.
+    VIRTUAL void METHOD(CreateShaders)(THIS_
+                                       Uint32                  NumShaders,
+                                       const ShaderCreateInfo* pShaderCIs,
+                                       IShader**               ppShaders) PURE;
+
     /// Creates a new texture object
 
     /// \param [in] TexDesc - Texture description, see Diligent::TextureDesc for details.
@@ -359,6 +379,7 @@ DILIGENT_END_INTERFACE
 // clang-format off
 #    define IRenderDevice_CreateBuffer(This, ...)                    CALL_IFACE_METHOD(RenderDevice, CreateBuffer,                    This, __VA_ARGS__)
 #    define IRenderDevice_CreateShader(This, ...)                    CALL_IFACE_METHOD(RenderDevice, CreateShader,                    This, __VA_ARGS__)
+#    define IRenderDevice_CreateShaders(This, ...)                   CALL_IFACE_METHOD(RenderDevice, CreateShaders,                   This, __VA_ARGS__)
 #    define IRenderDevice_CreateTexture(This, ...)                   CALL_IFACE_METHOD(RenderDevice, CreateTexture,                   This, __VA_ARGS__)
 #    define IRenderDevice_CreateSampler(This, ...)                   CALL_IFACE_METHOD(RenderDevice, CreateSampler,                   This, __VA_ARGS__)
 #    define IRenderDevice_CreateResourceMapping(This, ...)           CALL_IFACE_METHOD(RenderDevice, CreateResourceMapping,           This, __VA_ARGS__)
@@ -107,6 +107,13 @@ DILIGENT_TYPED_ENUM(CREATE_SHADER_SOURCE_INPUT_STREAM_FLAGS, Uint32)
     /// Do not output any messages if the file is not found or
     /// other errors occur.
     CREATE_SHADER_SOURCE_INPUT_STREAM_FLAG_SILENT = 0x01,
+
+    /// Map the file into memory instead of reading it, if supported by the factory.
+    ///
+    /// \note  Mapped files must not be truncated while the stream or the data read
+    ///        from it is alive (for instance, by an editor when shaders are hot-reloaded).
+    ///        Otherwise accessing the data results in a bus error.
+    CREATE_SHADER_SOURCE_INPUT_STREAM_FLAG_MAP_FILE = 0x02,
 };
 DEFINE_FLAG_ENUM_OPERATORS(CREATE_SHADER_SOURCE_INPUT_STREAM_FLAGS);
 
@@ -244,6 +251,20 @@ struct ShaderCreateInfo
     /// Byte code size (in bytes) must be provided if ByteCode is not null
     size_t ByteCodeSize DEFAULT_INITIALIZER(0);
 
+    /// Serialized shader reflection data.
+
+    /// If not null, the engine initializes shader resources from this data instead
+    /// of reflecting the shader. The data must be obtained from a shader created from
+    /// the same bytecode or source (see IShaderVk::GetReflectionData() and
+    /// IShaderGL::GetReflectionData()) and is validated against the hash of the bytecode
+    /// (of the full source and the driver in OpenGL).
+    /// If the data does not match the shader, it is ignored and the shader is reflected.
+    /// \note This option is supported for Vulkan and OpenGL backends. Other backends ignore it.
+    const void* ReflectionData DEFAULT_INITIALIZER(nullptr);
+
+    /// Size of the serialized shader reflection data, in bytes.
+    size_t ReflectionDataSize DEFAULT_INITIALIZER(0);
+
     /// Shader entry point
 
     /// This member is ignored if ByteCode is not null
@@ -0,0 +1,477 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "CachingShaderSourceStreamFactory.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "DefaultShaderSourceStreamFactory.h"
+#include "ObjectBase.hpp"
+#include "RefCntAutoPtr.hpp"
+#include "EngineMemory.h"
+#include "FileSystem.hpp"
+#include "DataBlobImpl.hpp"
+#include "ReadOnlyMemoryFileStream.hpp"
+
+#if PLATFORM_WIN32
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    ifndef WIN32_LEAN_AND_MEAN
+#        define WIN32_LEAN_AND_MEAN
+#    endif
+#    include <Windows.h>
+#elif PLATFORM_LINUX || PLATFORM_ANDROID || PLATFORM_MACOS || PLATFORM_IOS || PLATFORM_TVOS
+#    define DILIGENT_POSIX_FILE_STAT 1
+#    include <sys/stat.h>
+#endif
+
+namespace Diligent
+{
+
+namespace
+{
+
+struct FileTimestamp
+{
+    Uint64 ModificationTime = 0;
+    Uint64 Size             = 0;
+
+    bool operator==(const FileTimestamp& rhs) const
+    {
+        return ModificationTime == rhs.ModificationTime && Size == rhs.Size;
+    }
+};
+
+bool GetFileTimestamp(const String& Path, FileTimestamp& Timestamp)
+{
+#if PLATFORM_WIN32
+    WIN32_FILE_ATTRIBUTE_DATA Attribs = {};
+    if (!GetFileAttributesExA(Path.c_str(), GetFileExInfoStandard, &Attribs))
+        return false;
+
+    Timestamp.ModificationTime = (Uint64{Attribs.ftLastWriteTime.dwHighDateTime} << 32u) | Attribs.ftLastWriteTime.dwLowDateTime;
+    Timestamp.Size             = (Uint64{Attribs.nFileSizeHigh} << 32u) | Attribs.nFileSizeLow;
+    return true;
+#elif DILIGENT_POSIX_FILE_STAT
+    // The default factory uses backslashes to join search directories and file names
+    String CorrectedPath{Path};
+    FileSystem::CorrectSlashes(CorrectedPath);
+
+    struct stat Stat;
+    if (stat(CorrectedPath.c_str(), &Stat) != 0)
+        return false;
+
+        // Use nanoseconds so that edits made within one second are detected
+#    if PLATFORM_MACOS || PLATFORM_IOS || PLATFORM_TVOS
+    const auto& MTime          = Stat.st_mtimespec;
+#    else
+    const auto& MTime = Stat.st_mtim;
+#    endif
+    Timestamp.ModificationTime = static_cast<Uint64>(MTime.tv_sec) * 1000000000ull + static_cast<Uint64>(MTime.tv_nsec);
+    Timestamp.Size             = static_cast<Uint64>(Stat.st_size);
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Finds the #include directives in the source and appends the file names to Includes.
+// Conditional compilation and block comments are not taken into account.
+void FindIncludes(const char* pSource, size_t Size, std::vector<String>& Includes)
+{
+    static constexpr char   Directive[]  = "include";
+    static constexpr size_t DirectiveLen = sizeof(Directive) - 1;
+
+    const char* const pEnd = pSource + Size;
+    const char*       Pos  = pSource;
+
+    auto SkipSpaces = [&]() {
+        while (Pos < pEnd && (*Pos == ' ' || *Pos == '\t'))
+            ++Pos;
+    };
+
+    while (Pos < pEnd)
+    {
+        SkipSpaces();
+        if (Pos < pEnd && *Pos == '#')
+        {
+            ++Pos;
+            SkipSpaces();
+            if (static_cast<size_t>(pEnd - Pos) > DirectiveLen && memcmp(Pos, Directive, DirectiveLen) == 0)
+            {
+                Pos += DirectiveLen;
+                SkipSpaces();
+                if (Pos < pEnd && (*Pos == '"' || *Pos == '<'))
+                {
+                    const char  Closing   = *Pos == '"' ? '"' : '>';
+                    const char* NameStart = ++Pos;
+                    while (Pos < pEnd && *Pos != Closing && *Pos != '\n')
+                        ++Pos;
+
+                    if (Pos < pEnd && *Pos == Closing && Pos > NameStart)
+                    {
+                        String Name{NameStart, Pos};
+                        // Remove "./" the same way the DXC include handler does
+                        if (Name.size() > 2 && Name[0] == '.' && (Name[1] == '\\' || Name[1] == '/'))
+                            Name.erase(0, 2);
+
+                        if (std::find(Includes.begin(), Includes.end(), Name) == Includes.end())
+                            Includes.emplace_back(std::move(Name));
+                    }
+                }
+            }
+        }
+
+        // Go to the next line
+        while (Pos < pEnd && *Pos != '\n')
+            ++Pos;
+        if (Pos < pEnd)
+            ++Pos;
+    }
+}
+
+} // namespace
+
+class CachingShaderSourceStreamFactory final : public ObjectBase<ICachingShaderSourceStreamFactory>
+{
+public:
+    using TBase = ObjectBase<ICachingShaderSourceStreamFactory>;
+
+    CachingShaderSourceStreamFactory(IReferenceCounters* pRefCounters, IShaderSourceInputStreamFactory* pBaseFactory);
+
+    virtual void DILIGENT_CALL_TYPE QueryInterface(const INTERFACE_ID& IID, IObject** ppInterface) override final;
+
+    virtual void DILIGENT_CALL_TYPE CreateInputStream(const Char* Name, IFileStream** ppStream) override final;
+
+    virtual void DILIGENT_CALL_TYPE CreateInputStream2(const Char*                             Name,
+                                                       CREATE_SHADER_SOURCE_INPUT_STREAM_FLAGS Flags,
+                                                       IFileStream**                           ppStream) override final;
+
+    virtual void DILIGENT_CALL_TYPE GetDependencies(const Char* Name, std::vector<String>& Dependencies) override final;
+
+    virtual Uint32 DILIGENT_CALL_TYPE InvalidateModifiedFiles(std::vector<String>* pModifiedFiles) override final;
+
+    virtual void DILIGENT_CALL_TYPE Clear() override final;
+
+    virtual CachingShaderSourceStreamFactoryStats DILIGENT_CALL_TYPE GetStats() override final;
+
+private:
+    struct FileInfo
+    {
+        // File data, or null if the file was not found
+        RefCntAutoPtr<IDataBlob> pData;
+
+        // Path of the file, or empty string if the modifications can't be tracked
+        String        FullPath;
+        FileTimestamp Timestamp;
+
+        // Names in the #include directives of the file
+        std::vector<String> Includes;
+    };
+
+    // Returns false if the file was modified while it was being read, in which case the data must not be cached
+    bool LoadFile(const Char* Name, CREATE_SHADER_SOURCE_INPUT_STREAM_FLAGS Flags, FileInfo& Info);
+
+    // Returns true if the base factory can open the file
+    bool FileExists(const Char* Name);
+
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> m_pBaseFactory;
+    // Not null if the base factory reports the paths of the opened files
+    RefCntAutoPtr<IShaderSourceFileStreamFactory> m_pFileFactory;
+
+    std::mutex                            m_FilesMtx;
+    std::unordered_map<String, FileInfo>  m_Files;
+    CachingShaderSourceStreamFactoryStats m_Stats;
+};
+
+CachingShaderSourceStreamFactory::CachingShaderSourceStreamFactory(IReferenceCounters*              pRefCounters,
+                                                                   IShaderSourceInputStreamFactory* pBaseFactory) :
+    // clang-format off
+    TBase         {pRefCounters},
+    m_pBaseFactory{pBaseFactory},
+    m_pFileFactory{pBaseFactory, IID_ShaderSourceFileStreamFactory}
+// clang-format on
+{
+}
+
+void CachingShaderSourceStreamFactory::QueryInterface(const INTERFACE_ID& IID, IObject** ppInterface)
+{
+    if (ppInterface == nullptr)
+        return;
+
+    if (IID == IID_IShaderSourceInputStreamFactory || IID == IID_CachingShaderSourceStreamFactory)
+    {
+        *ppInterface = this;
+        (*ppInterface)->AddRef();
+    }
+    else
+    {
+        TBase::QueryInterface(IID, ppInterface);
+    }
+}
+
+bool CachingShaderSourceStreamFactory::LoadFile(const Char* Name, CREATE_SHADER_SOURCE_INPUT_STREAM_FLAGS Flags, FileInfo& Info)
+{
+    RefCntAutoPtr<IFileStream> pStream;
+    if (m_pFileFactory)
+        m_pFileFactory->CreateFileInputStream(Name, Flags, &pStream, Info.FullPath);
+    else
+        m_pBaseFactory->CreateInputStream2(Name, Flags, &pStream);
+
+    if (!pStream)
+        return true;
+
+    // Get the timestamp before reading the data so that modifications made while
+    // the file is being read are detected by InvalidateModifiedFiles().
+    if (!Info.FullPath.empty() && !GetFileTimestamp(Info.FullPath, Info.Timestamp))
+        Info.FullPath.clear();
+
+    // Always copy the data: keeping the file mapped would prevent the file
+    // from being edited on some platforms while it is in the cache.
+    Info.pData = MakeNewRCObj<DataBlobImpl>()(0);
+    pStream->ReadBlob(Info.pData);
+
+    FindIncludes(reinterpret_cast<const char*>(Info.pData->GetDataPtr()), Info.pData->GetSize(), Info.Includes);
+
+    if (!Info.FullPath.empty())
+    {
+        FileTimestamp Timestamp;
+        if (!GetFileTimestamp(Info.FullPath, Timestamp) || !(Timestamp == Info.Timestamp))
+            return false;
+    }
+
+    return true;
+}
+
+void CachingShaderSourceStreamFactory::CreateInputStream(const Char*   Name,
+                                                         IFileStream** ppStream)
+{
+    CreateInputStream2(Name, CREATE_SHADER_SOURCE_INPUT_STREAM_FLAG_NONE, ppStream);
+}
+
+void CachingShaderSourceStreamFactory::CreateInputStream2(const Char*                             Name,
+                                                          CREATE_SHADER_SOURCE_INPUT_STREAM_FLAGS Flags,
+                                                          IFileStream**                           ppStream)
+{
+    DEV_CHECK_ERR(Name != nullptr, "File name must not be null");
+    DEV_CHECK_ERR(ppStream != nullptr, "ppStream must not be null");
+    *ppStream = nullptr;
+
+    RefCntAutoPtr<IDataBlob> pData;
+    bool                     Found = false;
+    {
+        std::lock_guard<std::mutex> Lock{m_FilesMtx};
+
+        auto it = m_Files.find(Name);
+        if (it != m_Files.end())
+        {
+            pData = it->second.pData;
+            Found = true;
+            ++m_Stats.Hits;
+        }
+    }
+
+    if (Found)
+    {
+        if (!pData && (Flags & CREATE_SHADER_SOURCE_INPUT_STREAM_FLAG_SILENT) == 0)
+        {
+            LOG_ERROR("Failed to create input stream for source file ", Name);
+        }
+    }
+    else
+    {
+        // Load the file without holding the lock so that other files can be accessed
+        // in the meantime. If another thread loads the same file, its data is used.
+        FileInfo   Info;
+        const bool CanCache = LoadFile(Name, Flags, Info);
+
+        std::lock_guard<std::mutex> Lock{m_FilesMtx};
+
+        ++m_Stats.Misses;
+        if (CanCache)
+            pData = m_Files.emplace(Name, std::move(Info)).first->second.pData;
+        else
+            pData = std::move(Info.pData);
+    }
+
+    if (pData)
+    {
+        RefCntAutoPtr<ReadOnlyMemoryFileStream> pStream{MakeNewRCObj<ReadOnlyMemoryFileStream>()(pData)};
+        *ppStream = pStream.Detach();
+    }
+}
+
+void CachingShaderSourceStreamFactory::GetDependencies(const Char* Name, std::vector<String>& Dependencies)
+{
+    DEV_CHECK_ERR(Name != nullptr, "File name must not be null");
+    Dependencies.clear();
+
+    std::unordered_set<String> Visited{Name};
+
+    std::lock_guard<std::mutex> Lock{m_FilesMtx};
+
+    auto AddIncludes = [&](const String& FileName) {
+        auto it = m_Files.find(FileName);
+        if (it == m_Files.end())
+            return;
+
+        for (const auto& Include : it->second.Includes)
+        {
+            if (Visited.insert(Include).second)
+                Dependencies.push_back(Include);
+        }
+    };
+
+    AddIncludes(Name);
+    for (size_t i = 0; i < Dependencies.size(); ++i)
+    {
+        // Copy the name as the vector may be reallocated
+        const String FileName = Dependencies[i];
+        AddIncludes(FileName);
+    }
+}
+
+bool CachingShaderSourceStreamFactory::FileExists(const Char* Name)
+{
+    RefCntAutoPtr<IFileStream> pStream;
+    if (m_pFileFactory)
+    {
+        String FullPath;
+        m_pFileFactory->CreateFileInputStream(Name, CREATE_SHADER_SOURCE_INPUT_STREAM_FLAG_SILENT, &pStream, FullPath);
+    }
+    else
+    {
+        m_pBaseFactory->CreateInputStream2(Name, CREATE_SHADER_SOURCE_INPUT_STREAM_FLAG_SILENT, &pStream);
+    }
+    return pStream.RawPtr() != nullptr;
+}
+
+Uint32 CachingShaderSourceStreamFactory::InvalidateModifiedFiles(std::vector<String>* pModifiedFiles)
+{
+    Uint32 NumRemovedFiles = 0;
+
+    // Files that were not found when they were requested
+    std::vector<String> MissingFiles;
+    {
+        std::lock_guard<std::mutex> Lock{m_FilesMtx};
+
+        for (auto it = m_Files.begin(); it != m_Files.end();)
+        {
+            const auto& Info = it->second;
+
+            bool Remove = false;
+            if (!Info.pData)
+            {
+                MissingFiles.push_back(it->first);
+            }
+            else if (!Info.FullPath.empty())
+            {
+                FileTimestamp Timestamp;
+                if (!GetFileTimestamp(Info.FullPath, Timestamp) || !(Timestamp == Info.Timestamp))
+                {
+                    Remove = true;
+                    if (pModifiedFiles != nullptr)
+                        pModifiedFiles->push_back(it->first);
+                }
+            }
+
+            if (Remove)
+            {
+                it = m_Files.erase(it);
+                ++NumRemovedFiles;
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    // Check if the missing files have been created. The files are opened without holding the lock.
+    for (const auto& Name : MissingFiles)
+    {
+        if (!FileExists(Name.c_str()))
+            continue;
+
+        std::lock_guard<std::mutex> Lock{m_FilesMtx};
+
+        auto it = m_Files.find(Name);
+        if (it != m_Files.end() && !it->second.pData)
+        {
+            m_Files.erase(it);
+            ++NumRemovedFiles;
+            if (pModifiedFiles != nullptr)
+                pModifiedFiles->push_back(Name);
+        }
+    }
+
+    return NumRemovedFiles;
+}
+
+void CachingShaderSourceStreamFactory::Clear()
+{
+    std::lock_guard<std::mutex> Lock{m_FilesMtx};
+    m_Files.clear();
+}
+
+CachingShaderSourceStreamFactoryStats CachingShaderSourceStreamFactory::GetStats()
+{
+    std::lock_guard<std::mutex> Lock{m_FilesMtx};
+
+    auto Stats     = m_Stats;
+    Stats.NumFiles = static_cast<Uint32>(m_Files.size());
+    Stats.Size     = 0;
+    for (const auto& it : m_Files)
+    {
+        if (it.second.pData)
+            Stats.Size += it.second.pData->GetSize();
+    }
+    return Stats;
+}
+
+void CreateCachingShaderSourceStreamFactory(IShaderSourceInputStreamFactory*    pBaseFactory,
+                                            ICachingShaderSourceStreamFactory** ppFactory)
+{
+    DEV_CHECK_ERR(ppFactory != nullptr && *ppFactory == nullptr, "ppFactory must not be null and must point to null");
+    if (pBaseFactory == nullptr)
+    {
+        LOG_ERROR("Base shader source stream factory must not be null");
+        return;
+    }
+
+    auto&                             Allocator = GetRawAllocator();
+    CachingShaderSourceStreamFactory* pFactory =
+        NEW_RC_OBJ(Allocator, "CachingShaderSourceStreamFactory instance", CachingShaderSourceStreamFactory)(pBaseFactory);
+    pFactory->QueryInterface(IID_CachingShaderSourceStreamFactory, reinterpret_cast<IObject**>(ppFactory));
+}
+
+} // namespace Diligent
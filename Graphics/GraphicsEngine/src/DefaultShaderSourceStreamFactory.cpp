@@ -31,29 +31,37 @@
 #include "RefCntAutoPtr.hpp"
 #include "EngineMemory.h"
 #include "BasicFileStream.hpp"
+#include "MappedFileStream.hpp"
 
 namespace Diligent
 {
 
-class DefaultShaderSourceStreamFactory final : public ObjectBase<IShaderSourceInputStreamFactory>
+class DefaultShaderSourceStreamFactory final : public ObjectBase<IShaderSourceFileStreamFactory>
 {
 public:
+    using TBase = ObjectBase<IShaderSourceFileStreamFactory>;
+
     DefaultShaderSourceStreamFactory(IReferenceCounters* pRefCounters, const Char* SearchDirectories);
 
+    virtual void DILIGENT_CALL_TYPE QueryInterface(const INTERFACE_ID& IID, IObject** ppInterface) override final;
+
     virtual void DILIGENT_CALL_TYPE CreateInputStream(const Char* Name, IFileStream** ppStream) override final;
 
     virtual void DILIGENT_CALL_TYPE CreateInputStream2(const Char*                             Name,
                                                        CREATE_SHADER_SOURCE_INPUT_STREAM_FLAGS Flags,
                                                        IFileStream**                           ppStream) override final;
 
-    IMPLEMENT_QUERY_INTERFACE_IN_PLACE(IID_IShaderSourceInputStreamFactory, ObjectBase<IShaderSourceInputStreamFactory>);
+    virtual void DILIGENT_CALL_TYPE CreateFileInputStream(const Char*                             Name,
+                                                          CREATE_SHADER_SOURCE_INPUT_STREAM_FLAGS Flags,
+                                                          IFileStream**                           ppStream,
+                                                          String&                                 FullPath) override final;
 
 private:
     std::vector<String> m_SearchDirectories;
 };
 
 DefaultShaderSourceStreamFactory::DefaultShaderSourceStreamFactory(IReferenceCounters* pRefCounters, const Char* SearchDirectories) :
-    ObjectBase<IShaderSourceInputStreamFactory>(pRefCounters)
+    TBase{pRefCounters}
 {
     while (SearchDirectories)
     {
@@ -80,6 +88,22 @@ DefaultShaderSourceStreamFactory::DefaultShaderSourceStreamFactory(IReferenceCou
     m_SearchDirectories.push_back("");
 }
 
+void DefaultShaderSourceStreamFactory::QueryInterface(const INTERFACE_ID& IID, IObject** ppInterface)
+{
+    if (ppInterface == nullptr)
+        return;
+
+    if (IID == IID_IShaderSourceInputStreamFactory || IID == IID_ShaderSourceFileStreamFactory)
+    {
+        *ppInterface = this;
+        (*ppInterface)->AddRef();
+    }
+    else
+    {
+        TBase::QueryInterface(IID, ppInterface);
+    }
+}
+
 void DefaultShaderSourceStreamFactory::CreateInputStream(const Char*   Name,
                                                          IFileStream** ppStream)
 {
@@ -90,31 +114,50 @@ void DefaultShaderSourceStreamFactory::CreateInputStream2(const Char*
                                                           CREATE_SHADER_SOURCE_INPUT_STREAM_FLAGS Flags,
                                                           IFileStream**                           ppStream)
 {
-    bool                                     bFileCreated = false;
-    Diligent::RefCntAutoPtr<BasicFileStream> pBasicFileStream;
+    String FullPath;
+    CreateFileInputStream(Name, Flags, ppStream, FullPath);
+}
+
+void DefaultShaderSourceStreamFactory::CreateFileInputStream(const Char*                             Name,
+                                                             CREATE_SHADER_SOURCE_INPUT_STREAM_FLAGS Flags,
+                                                             IFileStream**                           ppStream,
+                                                             String&                                 FullPath)
+{
+    RefCntAutoPtr<IFileStream> pFileStream;
     for (const auto& SearchDir : m_SearchDirectories)
     {
-        String FullPath = SearchDir + ((Name[0] == '\\' || Name[0] == '/') ? Name + 1 : Name);
+        FullPath = SearchDir + ((Name[0] == '\\' || Name[0] == '/') ? Name + 1 : Name);
         if (!FileSystem::FileExists(FullPath.c_str()))
             continue;
-        pBasicFileStream = MakeNewRCObj<BasicFileStream>()(FullPath.c_str(), EFileAccessMode::Read);
-        if (pBasicFileStream->IsValid())
+
+        // Mapping avoids copying the file contents, but the file must not be truncated while
+        // it is mapped, so it is only used when requested. Fall back to buffered reads if
+        // the file can't be mapped.
+        if ((Flags & CREATE_SHADER_SOURCE_INPUT_STREAM_FLAG_MAP_FILE) != 0)
         {
-            bFileCreated = true;
-            break;
+            RefCntAutoPtr<MappedFileStream> pMappedFileStream{MakeNewRCObj<MappedFileStream>()(FullPath.c_str())};
+            if (pMappedFileStream->IsValid())
+            {
+                pFileStream = pMappedFileStream;
+                break;
+            }
         }
-        else
+
+        RefCntAutoPtr<BasicFileStream> pBasicFileStream{MakeNewRCObj<BasicFileStream>()(FullPath.c_str(), EFileAccessMode::Read)};
+        if (pBasicFileStream->IsValid())
         {
-            pBasicFileStream.Release();
+            pFileStream = pBasicFileStream;
+            break;
         }
     }
-    if (bFileCreated)
+    if (pFileStream)
     {
-        pBasicFileStream->QueryInterface(IID_FileStream, reinterpret_cast<IObject**>(ppStream));
+        *ppStream = pFileStream.Detach();
     }
     else
     {
         *ppStream = nullptr;
+        FullPath.clear();
         if ((Flags & CREATE_SHADER_SOURCE_INPUT_STREAM_FLAG_SILENT) == 0)
         {
             LOG_ERROR("Failed to create input stream for source file ", Name);
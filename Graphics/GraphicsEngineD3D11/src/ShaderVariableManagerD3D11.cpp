@@ -101,6 +101,12 @@ const PipelineResourceDesc& ShaderVariableManagerD3D11::GetResourceDesc(Uint32 I
     return m_pSignature->GetResourceDesc(Index);
 }
 
+size_t ShaderVariableManagerD3D11::GetResourceNameHash(Uint32 Index) const
+{
+    VERIFY_EXPR(m_pSignature);
+    return m_pSignature->GetResourceNameHash(Index);
+}
+
 const PipelineResourceAttribsD3D11& ShaderVariableManagerD3D11::GetResourceAttribs(Uint32 Index) const
 {
     VERIFY_EXPR(m_pSignature);
@@ -523,13 +529,13 @@ void ShaderVariableManagerD3D11::BindResources(IResourceMapping* pResourceMappin
 }
 
 template <typename ResourceType>
-IShaderResourceVariable* ShaderVariableManagerD3D11::GetResourceByName(const Char* Name) const
+IShaderResourceVariable* ShaderVariableManagerD3D11::GetResourceByName(const Char* Name, size_t NameHash) const
 {
     auto NumResources = GetNumResources<ResourceType>();
     for (Uint32 res = 0; res < NumResources; ++res)
     {
         auto& Resource = GetResource<ResourceType>(res);
-        if (strcmp(Resource.GetDesc().Name, Name) == 0)
+        if (Resource.GetNameHash() == NameHash && strcmp(Resource.GetDesc().Name, Name) == 0)
             return &Resource;
     }
 
@@ -538,25 +544,27 @@ IShaderResourceVariable* ShaderVariableManagerD3D11::GetResourceByName(const Cha
 
 IShaderResourceVariable* ShaderVariableManagerD3D11::GetVariable(const Char* Name) const
 {
-    if (auto* pCB = GetResourceByName<ConstBuffBindInfo>(Name))
+    const auto NameHash = ComputeStringHash(Name);
+
+    if (auto* pCB = GetResourceByName<ConstBuffBindInfo>(Name, NameHash))
         return pCB;
 
-    if (auto* pTexSRV = GetResourceByName<TexSRVBindInfo>(Name))
+    if (auto* pTexSRV = GetResourceByName<TexSRVBindInfo>(Name, NameHash))
         return pTexSRV;
 
-    if (auto* pTexUAV = GetResourceByName<TexUAVBindInfo>(Name))
+    if (auto* pTexUAV = GetResourceByName<TexUAVBindInfo>(Name, NameHash))
         return pTexUAV;
 
-    if (auto* pBuffSRV = GetResourceByName<BuffSRVBindInfo>(Name))
+    if (auto* pBuffSRV = GetResourceByName<BuffSRVBindInfo>(Name, NameHash))
         return pBuffSRV;
 
-    if (auto* pBuffUAV = GetResourceByName<BuffUAVBindInfo>(Name))
+    if (auto* pBuffUAV = GetResourceByName<BuffUAVBindInfo>(Name, NameHash))
         return pBuffUAV;
 
     if (!m_pSignature->IsUsingCombinedSamplers())
     {
         // Immutable samplers are never initialized as variables
-        if (auto* pSampler = GetResourceByName<SamplerBindInfo>(Name))
+        if (auto* pSampler = GetResourceByName<SamplerBindInfo>(Name, NameHash))
             return pSampler;
     }
 
@@ -126,6 +126,12 @@ const PipelineResourceDesc& ShaderVariableManagerD3D12::GetResourceDesc(Uint32 I
     return m_pSignature->GetResourceDesc(Index);
 }
 
+size_t ShaderVariableManagerD3D12::GetResourceNameHash(Uint32 Index) const
+{
+    VERIFY_EXPR(m_pSignature != nullptr);
+    return m_pSignature->GetResourceNameHash(Index);
+}
+
 const ShaderVariableManagerD3D12::ResourceAttribs& ShaderVariableManagerD3D12::GetResourceAttribs(Uint32 Index) const
 {
     VERIFY_EXPR(m_pSignature != nullptr);
@@ -135,10 +141,11 @@ const ShaderVariableManagerD3D12::ResourceAttribs& ShaderVariableManagerD3D12::G
 
 ShaderVariableD3D12Impl* ShaderVariableManagerD3D12::GetVariable(const Char* Name) const
 {
+    const auto NameHash = ComputeStringHash(Name);
     for (Uint32 v = 0; v < m_NumVariables; ++v)
     {
         auto& Var = m_pVariables[v];
-        if (strcmp(Var.GetDesc().Name, Name) == 0)
+        if (Var.GetNameHash() == NameHash && strcmp(Var.GetDesc().Name, Name) == 0)
             return &Var;
     }
     return nullptr;
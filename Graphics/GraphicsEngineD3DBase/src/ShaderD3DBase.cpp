@@ -39,6 +39,7 @@
 
 #include "D3DErrors.hpp"
 #include "DataBlobImpl.hpp"
+#include "MappedFileStream.hpp"
 #include "RefCntAutoPtr.hpp"
 #include "ShaderD3DBase.hpp"
 #include "DXCompiler.hpp"
@@ -71,8 +72,8 @@ public:
             return E_FAIL;
         }
 
-        RefCntAutoPtr<IDataBlob> pFileData(MakeNewRCObj<DataBlobImpl>{}(0));
-        pSourceStream->ReadBlob(pFileData);
+        RefCntAutoPtr<IDataBlob> pFileData = ReadFileStreamData(pSourceStream);
+
         *ppData = pFileData->GetDataPtr();
         *pBytes = static_cast<UINT>(pFileData->GetSize());
 
@@ -92,7 +92,7 @@ private:
 
 
     friend class RenderDeviceGLImpl;
-    ThreadingTools::LockFlag                                                                 m_CacheLockFlag;
+    ThreadingTools::LockFlag                                                                 m_CacheLockFlag{"FBOCache"};
     std::unordered_map<FBOCacheKey, GLObjectWrappers::GLFrameBufferObj, FBOCacheKeyHashFunc> m_Cache;
 
     // Multimap that sets up correspondence between unique texture id and all
@@ -72,6 +72,11 @@ public:
     virtual void DILIGENT_CALL_TYPE CreateShader(const ShaderCreateInfo& ShaderCreateInfo,
                                                  IShader**               ppShader) override final;
 
+    /// Implementation of IRenderDevice::CreateShaders() in OpenGL backend.
+    virtual void DILIGENT_CALL_TYPE CreateShaders(Uint32                  NumShaders,
+                                                  const ShaderCreateInfo* pShaderCIs,
+                                                  IShader**               ppShaders) override final;
+
     /// Implementation of IRenderDevice::CreateTexture() in OpenGL backend.
     void                            CreateTexture(const TextureDesc& TexDesc,
                                                   const TextureData* pData,
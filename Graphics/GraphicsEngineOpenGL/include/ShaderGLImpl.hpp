@@ -55,6 +55,9 @@ public:
     /// Implementation of IShader::GetResource() in OpenGL backend.
     virtual void DILIGENT_CALL_TYPE GetResourceDesc(Uint32 Index, ShaderResourceDesc& ResourceDesc) const override final;
 
+    /// Implementation of IShaderGL::GetReflectionData().
+    virtual void DILIGENT_CALL_TYPE GetReflectionData(IDataBlob** ppData) const override final;
+
     static GLObjectWrappers::GLProgramObj LinkProgram(ShaderGLImpl* const* ppShaders, Uint32 NumShaders, bool IsSeparableProgram);
 
     const std::shared_ptr<const ShaderResourcesGL>& GetShaderResources() const { return m_pShaderResources; }
@@ -62,6 +65,10 @@ public:
 private:
     GLObjectWrappers::GLShaderObj            m_GLShaderObj;
     std::shared_ptr<const ShaderResourcesGL> m_pShaderResources;
+
+    // Hash of the full shader source and the GL driver identification strings
+    // that is used to validate serialized reflection data.
+    Uint64 m_SourceHash = 0;
 };
 
 } // namespace Diligent
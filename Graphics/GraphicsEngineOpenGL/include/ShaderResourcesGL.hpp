@@ -42,6 +42,8 @@
 #include <vector>
 
 #include "Object.h"
+#include "DataBlob.h"
+#include "RefCntAutoPtr.hpp"
 #include "StringPool.hpp"
 #include "HashUtils.hpp"
 #include "ShaderResourceVariableBase.hpp"
@@ -67,6 +69,18 @@ public:
                       const GLObjectWrappers::GLProgramObj& GLProgram,
                       class GLContextState&                 State);
 
+    /// Restores the resources from the data produced by Serialize() without linking the program.
+    /// Returns false if the data is invalid or was created for a different source, in which case
+    /// the resources are left empty and the caller should fall back to LoadUniforms().
+    bool Deserialize(SHADER_TYPE ShaderStages,
+                     const void* pData,
+                     size_t      DataSize,
+                     Uint64      SourceHash,
+                     const char* ShaderName);
+
+    /// Serializes the resources so that they can later be restored by Deserialize()
+    RefCntAutoPtr<IDataBlob> Serialize(Uint64 SourceHash) const;
+
     struct GLResourceAttribs
     {
         // clang-format off
@@ -96,9 +96,10 @@ public:
 
     using ResourceAttribs = PipelineResourceAttribsGL;
 
-    // These two methods can't be implemented in the header because they depend on PipelineResourceSignatureGLImpl
+    // These methods can't be implemented in the header because they depend on PipelineResourceSignatureGLImpl
     const PipelineResourceDesc& GetResourceDesc(Uint32 Index) const;
     const ResourceAttribs&      GetResourceAttribs(Uint32 Index) const;
+    size_t                      GetResourceNameHash(Uint32 Index) const;
 
     template <typename ThisImplType>
     struct GLVariableBase : public ShaderVariableBase<ThisImplType, ShaderVariableManagerGL>
@@ -252,7 +253,7 @@ private:
     }
 
     template <typename ResourceType>
-    IShaderResourceVariable* GetResourceByName(const Char* Name) const;
+    IShaderResourceVariable* GetResourceByName(const Char* Name, size_t NameHash) const;
 
     template <typename THandleUB,
               typename THandleTexture,
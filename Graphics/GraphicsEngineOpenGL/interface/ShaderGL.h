@@ -42,25 +42,30 @@ static const INTERFACE_ID IID_ShaderGL =
 #include "../../../../../MultiTouch/DiligentLog/Primitives/interface/DefineInterfaceHelperMacros.h"
 
 #define IShaderGLInclusiveMethods \
-    IShaderInclusiveMethods
-//IShaderGLMethods ShaderGL
-
-#if DILIGENT_CPP_INTERFACE
+    IShaderInclusiveMethods;      \
+    IShaderGLMethods ShaderGL
 
 /// Exposes OpenGL-specific functionality of a shader object.
-DILIGENT_BEGIN_INTERFACE(IShaderGL, IShader){};
-DILIGENT_END_INTERFACE
+DILIGENT_BEGIN_INTERFACE(IShaderGL, IShader)
+{
+    /// Serializes the shader resources so that the next time the shader is created, the data can be
+    /// passed to ShaderCreateInfo::ReflectionData to skip the program link that is otherwise required
+    /// to query the resources.
 
-#endif
+    /// \param [out] ppData - Address of the memory location where the pointer to the data blob will be written.
+    ///
+    /// \remarks   Resource indices are assigned by the driver, so the data is only valid for the same
+    ///            shader source, GL vendor, renderer and version. Mismatching data is ignored.
+    ///            If separable programs are not supported, null is written to ppData.
+    VIRTUAL void METHOD(GetReflectionData)(THIS_ IDataBlob** ppData) CONST PURE;
+};
+DILIGENT_END_INTERFACE
 
 #include "../../../../../MultiTouch/DiligentLog/Primitives/interface/UndefInterfaceHelperMacros.h"
 
 #if DILIGENT_C_INTERFACE
 
-typedef struct IShaderGLVtbl
-{
-    IShaderGLInclusiveMethods;
-} IShaderGLVtbl;
+#    define IShaderGL_GetReflectionData(This, ...) CALL_IFACE_METHOD(ShaderGL, GetReflectionData, This, __VA_ARGS__)
 
 #endif
 
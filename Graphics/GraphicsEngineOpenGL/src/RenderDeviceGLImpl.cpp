@@ -315,6 +315,17 @@ void RenderDeviceGLImpl::CreateShader(const ShaderCreateInfo& ShaderCreateInfo,
     CreateShader(ShaderCreateInfo, ppShader, false);
 }
 
+void RenderDeviceGLImpl::CreateShaders(Uint32 NumShaders, const ShaderCreateInfo* pShaderCIs, IShader** ppShaders)
+{
+    DEV_CHECK_ERR(NumShaders == 0 || (pShaderCIs != nullptr && ppShaders != nullptr), "pShaderCIs and ppShaders must not be null");
+    if (pShaderCIs == nullptr || ppShaders == nullptr)
+        return;
+
+    // GL shader objects can only be created in the thread that owns the GL context
+    for (Uint32 i = 0; i < NumShaders; ++i)
+        CreateShader(pShaderCIs[i], &ppShaders[i], false);
+}
+
 void RenderDeviceGLImpl::CreateTexture(const TextureDesc& TexDesc, const TextureData* pData, ITexture** ppTexture, bool bIsDeviceInternal)
 {
     CreateDeviceObject(
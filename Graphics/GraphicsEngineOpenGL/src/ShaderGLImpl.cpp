@@ -37,6 +37,7 @@
 #include "GLSLUtils.hpp"
 #include "ShaderToolsCommon.hpp"
 #include "GLTypeConversions.hpp"
+#include "HashUtils.hpp"
 
 using namespace Diligent;
 
@@ -161,14 +162,28 @@ ShaderGLImpl::ShaderGLImpl(IReferenceCounters*     pRefCounters,
 
     if (DeviceInfo.Features.SeparablePrograms)
     {
-        ShaderGLImpl* const            ThisShader[]  = {this};
-        GLObjectWrappers::GLProgramObj Program       = LinkProgram(ThisShader, 1, true);
-        auto                           pImmediateCtx = m_pDevice->GetImmediateContext();
-        VERIFY_EXPR(pImmediateCtx);
-        auto& GLState = pImmediateCtx.RawPtr<DeviceContextGLImpl>()->GetContextState();
+        // Resource indices are assigned by the driver, so the serialized reflection data
+        // is only valid for the same source and the same driver.
+        Uint64 DriverHash = 0;
+        for (GLenum Name : {GL_VENDOR, GL_RENDERER, GL_VERSION})
+        {
+            if (const auto* Str = reinterpret_cast<const char*>(glGetString(Name)))
+                DriverHash = ComputeHash64(Str, strlen(Str), DriverHash);
+        }
+        m_SourceHash = ComputeHash64(ShaderStrings[0], static_cast<size_t>(Lengths[0]), DriverHash);
 
         std::unique_ptr<ShaderResourcesGL> pResources{new ShaderResourcesGL{}};
-        pResources->LoadUniforms(m_Desc.ShaderType, Program, GLState);
+        if (ShaderCI.ReflectionData == nullptr ||
+            !pResources->Deserialize(m_Desc.ShaderType, ShaderCI.ReflectionData, ShaderCI.ReflectionDataSize, m_SourceHash, m_Desc.Name))
+        {
+            ShaderGLImpl* const            ThisShader[]  = {this};
+            GLObjectWrappers::GLProgramObj Program       = LinkProgram(ThisShader, 1, true);
+            auto                           pImmediateCtx = m_pDevice->GetImmediateContext();
+            VERIFY_EXPR(pImmediateCtx);
+            auto& GLState = pImmediateCtx.RawPtr<DeviceContextGLImpl>()->GetContextState();
+
+            pResources->LoadUniforms(m_Desc.ShaderType, Program, GLState);
+        }
         m_pShaderResources.reset(pResources.release());
     }
 }
@@ -265,4 +280,19 @@ void ShaderGLImpl::GetResourceDesc(Uint32 Index, ShaderResourceDesc& ResourceDes
     }
 }
 
+void ShaderGLImpl::GetReflectionData(IDataBlob** ppData) const
+{
+    DEV_CHECK_ERR(ppData != nullptr && *ppData == nullptr, "ppData must not be null and must point to null");
+
+    if (m_pShaderResources)
+    {
+        *ppData = m_pShaderResources->Serialize(m_SourceHash).Detach();
+    }
+    else
+    {
+        LOG_WARNING_MESSAGE("Shader reflection data is not available when separate shader objects are unsupported");
+        *ppData = nullptr;
+    }
+}
+
 } // namespace Diligent
@@ -36,6 +36,7 @@
 #include "ShaderResourceVariableBase.hpp"
 #include "Align.hpp"
 #include "GLTypeConversions.hpp"
+#include "ShaderReflectionData.hpp"
 
 namespace Diligent
 {
@@ -549,6 +550,214 @@ void ShaderResourcesGL::LoadUniforms(SHADER_TYPE                           Shade
     AllocateResources(UniformBlocks, Textures, Images, StorageBlocks);
 }
 
+bool ShaderResourcesGL::Deserialize(SHADER_TYPE ShaderStages,
+                                    const void* pData,
+                                    size_t      DataSize,
+                                    Uint64      SourceHash,
+                                    const char* ShaderName)
+{
+    VERIFY(m_UniformBuffers == nullptr, "Resources have already been allocated!");
+
+    ShaderReflectionDataReader Reader{pData, DataSize, ShaderReflectionDataType::GL, SourceHash, ShaderName};
+    if (!Reader.IsValid())
+        return false;
+
+    auto Reject = [ShaderName]() //
+    {
+        LOG_WARNING_MESSAGE("Reflection data of shader '", (ShaderName != nullptr ? ShaderName : ""), "' is damaged or does not match the shader description and will be ignored");
+        return false;
+    };
+
+    Uint32 Stages            = 0;
+    Uint32 NumUniformBuffers = 0;
+    Uint32 NumTextures       = 0;
+    Uint32 NumImages         = 0;
+    Uint32 NumStorageBlocks  = 0;
+    // clang-format off
+    if (!Reader.Read(Stages)            ||
+        !Reader.Read(NumUniformBuffers) ||
+        !Reader.Read(NumTextures)       ||
+        !Reader.Read(NumImages)         ||
+        !Reader.Read(NumStorageBlocks))
+        return Reject();
+    // clang-format on
+
+    if (static_cast<SHADER_TYPE>(Stages) != ShaderStages)
+        return Reject();
+
+    // Every record takes at least 13 bytes. Check the counts before allocating the memory.
+    constexpr size_t MinRecordSize = 13;
+    const size_t     NumResources  = size_t{NumUniformBuffers} + NumTextures + NumImages + NumStorageBlocks;
+    if (NumResources * MinRecordSize > Reader.GetRemainingSize())
+        return Reject();
+
+    m_ShaderStages = ShaderStages;
+    if (NumResources == 0)
+        return true;
+
+    // clang-format off
+    const size_t StringPoolDataSize = Reader.GetStringsSize();
+    const size_t TotalMemorySize    =
+        NumUniformBuffers * sizeof(UniformBufferInfo) +
+        NumTextures       * sizeof(TextureInfo) +
+        NumImages         * sizeof(ImageInfo) +
+        NumStorageBlocks  * sizeof(StorageBlockInfo) +
+        AlignUp(StringPoolDataSize, sizeof(void*)) * sizeof(Char);
+    // clang-format on
+
+    auto& MemAllocator = GetRawAllocator();
+    void* RawMemory    = ALLOCATE_RAW(MemAllocator, "Memory buffer for ShaderResourcesGL", TotalMemorySize);
+
+    // clang-format off
+    m_UniformBuffers = reinterpret_cast<UniformBufferInfo*>(RawMemory);
+    m_Textures       = reinterpret_cast<TextureInfo*>     (m_UniformBuffers + NumUniformBuffers);
+    m_Images         = reinterpret_cast<ImageInfo*>       (m_Textures       + NumTextures);
+    m_StorageBlocks  = reinterpret_cast<StorageBlockInfo*>(m_Images         + NumImages);
+    void* EndOfResourceData =                              m_StorageBlocks + NumStorageBlocks;
+    Char* StringPoolData = reinterpret_cast<Char*>(EndOfResourceData);
+    // clang-format on
+
+    // The string table is copied as is, so resource names simply point into it
+    memcpy(StringPoolData, Reader.GetStrings(), StringPoolDataSize);
+
+    Uint32               NameOffset   = 0;
+    SHADER_RESOURCE_TYPE ResourceType = SHADER_RESOURCE_TYPE_UNKNOWN;
+    Uint32               ArraySize    = 0;
+
+    auto ReadAttribs = [&]() //
+    {
+        Uint8 Type = 0;
+        if (!Reader.ReadString(NameOffset) || !Reader.Read(Type) || !Reader.Read(ArraySize))
+            return false;
+        if (Type == SHADER_RESOURCE_TYPE_UNKNOWN || Type > SHADER_RESOURCE_TYPE_LAST || ArraySize == 0)
+            return false;
+        ResourceType = static_cast<SHADER_RESOURCE_TYPE>(Type);
+        return true;
+    };
+
+    auto ReadTextureAttribs = [&](Uint32& GLType, RESOURCE_DIMENSION& ResourceDim, bool& IsMultisample) //
+    {
+        Uint8 Dim  = 0;
+        Uint8 IsMS = 0;
+        if (!Reader.Read(GLType) || !Reader.Read(Dim) || !Reader.Read(IsMS))
+            return false;
+        if (Dim >= RESOURCE_DIM_NUM_DIMENSIONS)
+            return false;
+        ResourceDim   = static_cast<RESOURCE_DIMENSION>(Dim);
+        IsMultisample = IsMS != 0;
+        return true;
+    };
+
+    // The counters are incremented as the resources are constructed so that
+    // partially initialized resources are properly released on failure.
+    bool Succeeded = true;
+    for (Uint32 ub = 0; ub < NumUniformBuffers && Succeeded; ++ub)
+    {
+        Uint32 UBIndex = 0;
+        Succeeded      = ReadAttribs() && Reader.Read(UBIndex);
+        if (Succeeded)
+        {
+            new (m_UniformBuffers + ub) UniformBufferInfo{StringPoolData + NameOffset, ShaderStages, ResourceType, ArraySize, UBIndex};
+            ++m_NumUniformBuffers;
+        }
+    }
+
+    for (Uint32 s = 0; s < NumTextures && Succeeded; ++s)
+    {
+        Uint32             TextureType   = 0;
+        RESOURCE_DIMENSION ResourceDim   = RESOURCE_DIM_UNDEFINED;
+        bool               IsMultisample = false;
+        Succeeded                        = ReadAttribs() && ReadTextureAttribs(TextureType, ResourceDim, IsMultisample);
+        if (Succeeded)
+        {
+            new (m_Textures + s) TextureInfo{StringPoolData + NameOffset, ShaderStages, ResourceType, ArraySize, TextureType, ResourceDim, IsMultisample};
+            ++m_NumTextures;
+        }
+    }
+
+    for (Uint32 img = 0; img < NumImages && Succeeded; ++img)
+    {
+        Uint32             ImageType     = 0;
+        RESOURCE_DIMENSION ResourceDim   = RESOURCE_DIM_UNDEFINED;
+        bool               IsMultisample = false;
+        Succeeded                        = ReadAttribs() && ReadTextureAttribs(ImageType, ResourceDim, IsMultisample);
+        if (Succeeded)
+        {
+            new (m_Images + img) ImageInfo{StringPoolData + NameOffset, ShaderStages, ResourceType, ArraySize, ImageType, ResourceDim, IsMultisample};
+            ++m_NumImages;
+        }
+    }
+
+    for (Uint32 sb = 0; sb < NumStorageBlocks && Succeeded; ++sb)
+    {
+        Int32 SBIndex = 0;
+        Succeeded     = ReadAttribs() && Reader.Read(SBIndex);
+        if (Succeeded)
+        {
+            new (m_StorageBlocks + sb) StorageBlockInfo{StringPoolData + NameOffset, ShaderStages, ResourceType, ArraySize, SBIndex};
+            ++m_NumStorageBlocks;
+        }
+    }
+
+    if (!Succeeded)
+    {
+        // Move the resources into a temporary object that releases them
+        ShaderResourcesGL Released{std::move(*this)};
+        m_ShaderStages = SHADER_TYPE_UNKNOWN;
+        return Reject();
+    }
+
+    return true;
+}
+
+RefCntAutoPtr<IDataBlob> ShaderResourcesGL::Serialize(Uint64 SourceHash) const
+{
+    ShaderReflectionDataWriter Writer;
+    Writer.Write(static_cast<Uint32>(m_ShaderStages));
+    Writer.Write(m_NumUniformBuffers);
+    Writer.Write(m_NumTextures);
+    Writer.Write(m_NumImages);
+    Writer.Write(m_NumStorageBlocks);
+
+    auto WriteAttribs = [&Writer](const GLResourceAttribs& Attribs) //
+    {
+        Writer.WriteString(Attribs.Name);
+        Writer.Write(static_cast<Uint8>(Attribs.ResourceType));
+        Writer.Write(Attribs.ArraySize);
+    };
+
+    // clang-format off
+    ProcessConstResources(
+        [&](const UniformBufferInfo& UB)
+        {
+            WriteAttribs(UB);
+            Writer.Write(Uint32{UB.UBIndex});
+        },
+        [&](const TextureInfo& Tex)
+        {
+            WriteAttribs(Tex);
+            Writer.Write(Uint32{Tex.TextureType});
+            Writer.Write(static_cast<Uint8>(Tex.ResourceDim));
+            Writer.Write(static_cast<Uint8>(Tex.IsMultisample ? 1 : 0));
+        },
+        [&](const ImageInfo& Img)
+        {
+            WriteAttribs(Img);
+            Writer.Write(Uint32{Img.ImageType});
+            Writer.Write(static_cast<Uint8>(Img.ResourceDim));
+            Writer.Write(static_cast<Uint8>(Img.IsMultisample ? 1 : 0));
+        },
+        [&](const StorageBlockInfo& SB)
+        {
+            WriteAttribs(SB);
+            Writer.Write(Int32{SB.SBIndex});
+        }
+    );
+    // clang-format on
+
+    return Writer.Finish(ShaderReflectionDataType::GL, SourceHash);
+}
+
 ShaderResourceDesc ShaderResourcesGL::GetResourceDesc(Uint32 Index) const
 {
     if (Index < m_NumUniformBuffers)
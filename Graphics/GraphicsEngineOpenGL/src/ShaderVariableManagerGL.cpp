@@ -446,14 +446,13 @@ void ShaderVariableManagerGL::CheckResources(IResourceMapping*
 }
 
 template <typename ResourceType>
-IShaderResourceVariable* ShaderVariableManagerGL::GetResourceByName(const Char* Name) const
+IShaderResourceVariable* ShaderVariableManagerGL::GetResourceByName(const Char* Name, size_t NameHash) const
 {
     auto NumResources = GetNumResources<ResourceType>();
     for (Uint32 res = 0; res < NumResources; ++res)
     {
-        auto&       Resource = GetResource<ResourceType>(res);
-        const auto& ResDesc  = Resource.GetDesc();
-        if (strcmp(ResDesc.Name, Name) == 0)
+        auto& Resource = GetResource<ResourceType>(res);
+        if (Resource.GetNameHash() == NameHash && strcmp(Resource.GetDesc().Name, Name) == 0)
             return &Resource;
     }
 
@@ -463,16 +462,18 @@ IShaderResourceVariable* ShaderVariableManagerGL::GetResourceByName(const Char*
 
 IShaderResourceVariable* ShaderVariableManagerGL::GetVariable(const Char* Name) const
 {
-    if (auto* pUB = GetResourceByName<UniformBuffBindInfo>(Name))
+    const auto NameHash = ComputeStringHash(Name);
+
+    if (auto* pUB = GetResourceByName<UniformBuffBindInfo>(Name, NameHash))
         return pUB;
 
-    if (auto* pTexture = GetResourceByName<TextureBindInfo>(Name))
+    if (auto* pTexture = GetResourceByName<TextureBindInfo>(Name, NameHash))
         return pTexture;
 
-    if (auto* pImage = GetResourceByName<ImageBindInfo>(Name))
+    if (auto* pImage = GetResourceByName<ImageBindInfo>(Name, NameHash))
         return pImage;
 
-    if (auto* pSSBO = GetResourceByName<StorageBufferBindInfo>(Name))
+    if (auto* pSSBO = GetResourceByName<StorageBufferBindInfo>(Name, NameHash))
         return pSSBO;
 
     return nullptr;
@@ -602,6 +603,12 @@ const PipelineResourceDesc& ShaderVariableManagerGL::GetResourceDesc(Uint32 Inde
     return m_pSignature->GetResourceDesc(Index);
 }
 
+size_t ShaderVariableManagerGL::GetResourceNameHash(Uint32 Index) const
+{
+    VERIFY_EXPR(m_pSignature);
+    return m_pSignature->GetResourceNameHash(Index);
+}
+
 const ShaderVariableManagerGL::ResourceAttribs& ShaderVariableManagerGL::GetResourceAttribs(Uint32 Index) const
 {
     VERIFY_EXPR(m_pSignature);
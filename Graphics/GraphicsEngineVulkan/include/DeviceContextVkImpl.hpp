@@ -58,6 +58,7 @@
 #include "ResourceReleaseQueue.hpp"
 #include "DescriptorPoolManager.hpp"
 #include "HashUtils.hpp"
+#include "FrameArena.hpp"
 #include "ManagedVulkanObject.hpp"
 #include "QueryManagerVk.hpp"
 
@@ -557,6 +558,9 @@ private:
 
     FixedBlockMemoryAllocator m_CmdListAllocator;
 
+    // Temporary data used while recording commands. The arena is reset when the frame is finished.
+    FrameArena m_FrameArena;
+
     // Semaphores are not owned by the command context
     std::vector<RefCntAutoPtr<ManagedSemaphore>>          m_WaitManagedSemaphores;
     std::vector<RefCntAutoPtr<ManagedSemaphore>>          m_SignalManagedSemaphores;
@@ -52,6 +52,7 @@
 #include "RenderPassCache.hpp"
 #include "CommandPoolManager.hpp"
 #include "DXCompiler.hpp"
+#include "ShaderBytecodeCache.hpp"
 
 namespace Diligent
 {
@@ -233,6 +234,8 @@ public:
 
     IDXCompiler* GetDxCompiler() const { return m_pDxCompiler.get(); }
 
+    ShaderBytecodeCache* GetShaderBytecodeCache() const { return m_pShaderBytecodeCache.get(); }
+
     struct Properties
     {
         const Uint32 ShaderGroupHandleSize;
@@ -251,6 +254,8 @@ public:
 private:
     virtual void TestTextureFormat(TEXTURE_FORMAT TexFormat) override final;
 
+    virtual ThreadPool::CreateInfo GetShaderCompilationPoolCreateInfo() const override final;
+
     // Submits command buffer(s) for execution to the command queue and
     // returns the submitted command buffer(s) number and the fence value.
     // If SubmitInfo contains multiple command buffers, they all are treated
@@ -282,6 +287,9 @@ private:
 
     VulkanDynamicMemoryManager m_DynamicMemoryManager;
 
+    // Must be destroyed after the compiler that references it
+    std::unique_ptr<ShaderBytecodeCache> m_pShaderBytecodeCache;
+
     std::unique_ptr<IDXCompiler> m_pDxCompiler;
 };
 
@@ -127,9 +127,10 @@ private:
 
     Uint32 GetVariableIndex(const ShaderVariableVkImpl& Variable);
 
-    // These two methods can't be implemented in the header because they depend on PipelineResourceSignatureVkImpl
+    // These methods can't be implemented in the header because they depend on PipelineResourceSignatureVkImpl
     const PipelineResourceDesc& GetResourceDesc(Uint32 Index) const;
     const ResourceAttribs&      GetResourceAttribs(Uint32 Index) const;
+    size_t                      GetResourceNameHash(Uint32 Index) const;
 
 private:
     Uint32 m_NumVariables = 0;
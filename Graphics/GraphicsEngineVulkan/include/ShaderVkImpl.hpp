@@ -63,6 +63,9 @@ public:
         return m_SPIRV;
     }
 
+    /// Implementation of IShaderVk::GetReflectionData().
+    virtual void DILIGENT_CALL_TYPE GetReflectionData(IDataBlob** ppData) const override final;
+
     const std::shared_ptr<const SPIRVShaderResources>& GetShaderResources() const { return m_pShaderResources; }
 
     const char* GetEntryPoint() const { return m_EntryPoint.c_str(); }
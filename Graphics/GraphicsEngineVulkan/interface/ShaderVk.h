@@ -55,6 +55,13 @@ class IShaderVk : public IShader
 public:
     /// Returns SPIRV bytecode
     virtual const std::vector<uint32_t>& DILIGENT_CALL_TYPE GetSPIRV() const = 0;
+
+    /// Serializes shader resources into a data blob.
+
+    /// The blob can be stored next to the bytecode returned by GetSPIRV() and passed
+    /// to ShaderCreateInfo::ReflectionData when the shader is created from that bytecode,
+    /// which skips SPIRV reflection.
+    virtual void DILIGENT_CALL_TYPE GetReflectionData(IDataBlob** ppData) const = 0;
 };
 
 #endif
@@ -70,6 +70,7 @@ DeviceContextVkImpl::DeviceContextVkImpl(IReferenceCounters*                   p
         Desc
     },
     m_CmdListAllocator { GetRawAllocator(), sizeof(CommandListVkImpl), 64 },
+    m_FrameArena       { GetRawAllocator(), 16 << 10 },
     // Upload heap must always be thread-safe as Finish() may be called from another thread
     m_QueueFamilyCmdPools
     {
@@ -1226,6 +1227,9 @@ void DeviceContextVkImpl::FinishFrame()
     // be destroyed before the pools are actually returned to the global pool manager.
     m_DynamicDescrSetAllocator.ReleasePools(QueueMask);
 
+    // Frame arena merges its pages so that the next frame does not need to allocate memory.
+    m_FrameArena.Reset();
+
     EndFrame();
 }
 
@@ -1246,9 +1250,9 @@ void DeviceContextVkImpl::Flush(Uint32               NumCommandLists,
     DEV_CHECK_ERR(m_pActiveRenderPass == nullptr,
                   "Flushing device context inside an active render pass.");
 
-    // TODO: replace with small_vector
-    std::vector<VkCommandBuffer>               vkCmdBuffs;
-    std::vector<RefCntAutoPtr<IDeviceContext>> DeferredCtxs;
+    FrameArena::ScopedMarker                   ArenaMarker{m_FrameArena};
+    FrameVector<VkCommandBuffer>               vkCmdBuffs{m_FrameArena};
+    FrameVector<RefCntAutoPtr<IDeviceContext>> DeferredCtxs{m_FrameArena};
     vkCmdBuffs.reserve(NumCommandLists + 1);
     DeferredCtxs.reserve(NumCommandLists + 1);
 
@@ -3099,9 +3103,10 @@ void DeviceContextVkImpl::BuildBLAS(const BuildBLASAttribs& Attribs)
     TransitionOrVerifyBLASState(*pBLASVk, Attribs.BLASTransitionMode, RESOURCE_STATE_BUILD_AS_WRITE, OpName);
     TransitionOrVerifyBufferState(*pScratchVk, Attribs.ScratchBufferTransitionMode, RESOURCE_STATE_BUILD_AS_WRITE, VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR, OpName);
 
+    FrameArena::ScopedMarker                              ArenaMarker{m_FrameArena};
     VkAccelerationStructureBuildGeometryInfoKHR           vkASBuildInfo = {};
-    std::vector<VkAccelerationStructureBuildRangeInfoKHR> vkRanges;
-    std::vector<VkAccelerationStructureGeometryKHR>       vkGeometries;
+    FrameVector<VkAccelerationStructureBuildRangeInfoKHR> vkRanges{m_FrameArena};
+    FrameVector<VkAccelerationStructureGeometryKHR>       vkGeometries{m_FrameArena};
 
     if (Attribs.pTriangleData != nullptr)
     {
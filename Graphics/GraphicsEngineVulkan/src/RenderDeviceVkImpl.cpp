@@ -49,6 +49,10 @@
 #include "VulkanTypeConversions.hpp"
 #include "EngineMemory.h"
 
+#if !DILIGENT_NO_GLSLANG
+#    include "GLSLangUtils.hpp"
+#endif
+
 namespace Diligent
 {
 
@@ -174,6 +178,25 @@ RenderDeviceVkImpl::RenderDeviceVkImpl(IReferenceCounters*
         }
     }
 
+    if (EngineCI.pShaderBytecodeCacheDirectory != nullptr && *EngineCI.pShaderBytecodeCacheDirectory != '\0')
+    {
+        try
+        {
+            ShaderBytecodeCache::CreateInfo CacheCI;
+            CacheCI.Directory = EngineCI.pShaderBytecodeCacheDirectory;
+            CacheCI.MaxSize   = EngineCI.ShaderBytecodeCacheMaxSize;
+
+            m_pShaderBytecodeCache.reset(new ShaderBytecodeCache{CacheCI});
+            if (m_pDxCompiler)
+                m_pDxCompiler->SetBytecodeCache(m_pShaderBytecodeCache.get());
+        }
+        catch (...)
+        {
+            LOG_WARNING_MESSAGE("Failed to initialize the shader bytecode cache in '", EngineCI.pShaderBytecodeCacheDirectory,
+                                "'. Shaders will be compiled without caching.");
+        }
+    }
+
     for (Uint32 fmt = 1; fmt < m_TextureFormatsInfo.size(); ++fmt)
         m_TextureFormatsInfo[fmt].Supported = true; // We will test every format on a specific hardware device
 }
@@ -429,6 +452,22 @@ void RenderDeviceVkImpl::ReleaseStaleResources(bool ForceRelease)
 }
 
 
+ThreadPool::CreateInfo RenderDeviceVkImpl::GetShaderCompilationPoolCreateInfo() const
+{
+    ThreadPool::CreateInfo PoolCI;
+#if !DILIGENT_NO_GLSLANG
+    // Every compilation thread holds its own reference to the glslang process state,
+    // so that the state outlives the threads even if the Vulkan instance is destroyed first.
+    PoolCI.OnThreadStarted = [](Uint32) {
+        GLSLangUtils::InitializeGlslang();
+    };
+    PoolCI.OnThreadExiting = [](Uint32) {
+        GLSLangUtils::FinalizeGlslang();
+    };
+#endif
+    return PoolCI;
+}
+
 void RenderDeviceVkImpl::TestTextureFormat(TEXTURE_FORMAT TexFormat)
 {
     auto& TexFormatInfo = m_TextureFormatsInfo[TexFormat];
@@ -116,10 +116,11 @@ void ShaderVariableManagerVk::Destroy(IMemoryAllocator& Allocator)
 
 ShaderVariableVkImpl* ShaderVariableManagerVk::GetVariable(const Char* Name) const
 {
+    const auto NameHash = ComputeStringHash(Name);
     for (Uint32 v = 0; v < m_NumVariables; ++v)
     {
         auto& Var = m_pVariables[v];
-        if (strcmp(Var.GetDesc().Name, Name) == 0)
+        if (Var.GetNameHash() == NameHash && strcmp(Var.GetDesc().Name, Name) == 0)
             return &Var;
     }
     return nullptr;
@@ -163,6 +164,12 @@ const PipelineResourceDesc& ShaderVariableManagerVk::GetResourceDesc(Uint32 Inde
     return m_pSignature->GetResourceDesc(Index);
 }
 
+size_t ShaderVariableManagerVk::GetResourceNameHash(Uint32 Index) const
+{
+    VERIFY_EXPR(m_pSignature);
+    return m_pSignature->GetResourceNameHash(Index);
+}
+
 const ShaderVariableManagerVk::ResourceAttribs& ShaderVariableManagerVk::GetResourceAttribs(Uint32 Index) const
 {
     VERIFY_EXPR(m_pSignature);
@@ -102,7 +102,7 @@ ShaderVkImpl::ShaderVkImpl(IReferenceCounters*     pRefCounters,
 #else
                 if (ShaderCI.SourceLanguage == SHADER_SOURCE_LANGUAGE_HLSL)
                 {
-                    m_SPIRV = GLSLangUtils::HLSLtoSPIRV(ShaderCI, VulkanDefine, ShaderCI.ppCompilerOutput);
+                    m_SPIRV = GLSLangUtils::HLSLtoSPIRV(ShaderCI, VulkanDefine, ShaderCI.ppCompilerOutput, pRenderDeviceVk->GetShaderBytecodeCache());
                 }
                 else
                 {
@@ -143,6 +143,7 @@ ShaderVkImpl::ShaderVkImpl(IReferenceCounters*     pRefCounters,
                     Attribs.AssignBindings             = true;
                     Attribs.pShaderSourceStreamFactory = ShaderCI.pShaderSourceStreamFactory;
                     Attribs.ppCompilerOutput           = ShaderCI.ppCompilerOutput;
+                    Attribs.pBytecodeCache             = pRenderDeviceVk->GetShaderBytecodeCache();
 
                     if (VkVersion >= VK_API_VERSION_1_2)
                         Attribs.Version = GLSLangUtils::SpirvVersion::Vk120;
@@ -190,7 +191,10 @@ ShaderVkImpl::ShaderVkImpl(IReferenceCounters*     pRefCounters,
             m_Desc,
             ShaderCI.UseCombinedTextureSamplers ? ShaderCI.CombinedSamplerSuffix : nullptr,
             LoadShaderInputs,
-            m_EntryPoint //
+            m_EntryPoint,
+            SPIRVReflectionMode::Direct,
+            ShaderCI.ReflectionData,
+            ShaderCI.ReflectionDataSize //
         };
     m_pShaderResources.reset(pResources, STDDeleterRawMem<SPIRVShaderResources>(Allocator));
 
@@ -235,6 +239,13 @@ ShaderVkImpl::~ShaderVkImpl()
 {
 }
 
+void ShaderVkImpl::GetReflectionData(IDataBlob** ppData) const
+{
+    DEV_CHECK_ERR(ppData != nullptr && *ppData == nullptr, "ppData must not be null and must point to null");
+    auto pData = m_pShaderResources->Serialize(m_SPIRV, m_EntryPoint.c_str());
+    *ppData    = pData.Detach();
+}
+
 void ShaderVkImpl::GetResourceDesc(Uint32 Index, ShaderResourceDesc& ResourceDesc) const
 {
     auto ResCount = GetResourceCount();
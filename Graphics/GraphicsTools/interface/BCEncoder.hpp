@@ -0,0 +1,133 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Declaration of the CPU block-compression encoder
+
+#include "../../GraphicsEngine/interface/GraphicsTypes.h"
+
+namespace Diligent
+{
+
+class IUploadBuffer;
+
+/// Block-compression encoder quality level
+enum BC_ENCODE_QUALITY : Uint8
+{
+    /// Endpoints are selected from the bounding box (BC1, BC3, BC4, BC5)
+    /// or the principal axis (BC7) of the block; no refinement is performed.
+    BC_ENCODE_QUALITY_FAST = 0,
+
+    /// Endpoints are selected from the principal axis of the block and refined
+    /// with least squares; all encoding modes supported by the encoder are tried.
+    BC_ENCODE_QUALITY_NORMAL
+};
+
+/// Attributes of the EncodeBC() function
+struct BCEncodeAttribs
+{
+    /// Compressed format. Supported formats are BC1_UNORM(_SRGB), BC3_UNORM(_SRGB),
+    /// BC4_UNORM, BC5_UNORM and BC7_UNORM(_SRGB), see IsBCEncodingSupported().
+    TEXTURE_FORMAT Format = TEX_FORMAT_UNKNOWN;
+
+    /// Region width, in texels. Does not need to be a multiple of 4.
+    Uint32 Width = 0;
+
+    /// Region height, in texels. Does not need to be a multiple of 4.
+    Uint32 Height = 0;
+
+    /// Pointer to the source RGBA8 texels.
+    const void* pSrcData = nullptr;
+
+    /// Source row stride in bytes. If zero, the rows are tightly packed.
+    Uint64 SrcStride = 0;
+
+    /// Pointer to the destination blocks.
+    void* pDstData = nullptr;
+
+    /// Stride in bytes between rows of 4x4 blocks. If zero, the rows are tightly packed.
+    Uint64 DstStride = 0;
+
+    /// Encoding quality.
+    BC_ENCODE_QUALITY Quality = BC_ENCODE_QUALITY_NORMAL;
+
+    /// The number of block row ranges that are processed in parallel, see Diligent::ParallelForRanges().
+    Uint32 NumThreads = 1;
+};
+
+/// Checks if EncodeBC() can compress data to the given format.
+bool IsBCEncodingSupported(TEXTURE_FORMAT Format);
+
+/// Compresses RGBA8 texels to a BC format.
+
+/// \param [in] Attribs - Encoding attributes, see Diligent::BCEncodeAttribs.
+///
+/// \return     true if the data was encoded successfully, and false otherwise.
+///
+/// \remarks    BC1 and BC3 use the red, green and blue components for color, BC3 uses alpha
+///             for the alpha block, BC4 uses red, and BC5 uses red and green.
+///             BC1 switches to the three-color mode with transparent black for blocks that
+///             contain texels with alpha below 128. BC7 blocks are encoded in mode 6
+///             (single subset, RGBA endpoints with per-endpoint P-bits, 4-bit indices).
+///             In normal quality, opaque BC7 blocks also try modes 1 and 3 (two subsets,
+///             RGB endpoints) with the partitions of the lowest estimated error.
+///
+///             sRGB formats are encoded in the same way as UNORM formats, i.e. the error
+///             is minimized in the sRGB space.
+///
+///             Incomplete blocks at the right and bottom edges are padded by replicating
+///             the last column and row of the region.
+///
+///             Index selection is vectorized (SSE2 on x86, NEON on ARM).
+bool EncodeBC(const BCEncodeAttribs& Attribs);
+
+/// Compresses RGBA8 texels to the mapped subresource of an upload buffer.
+
+/// \param [in] pUploadBuffer - Upload buffer whose format is one of the formats supported by EncodeBC().
+/// \param [in] Mip           - Mip level of the buffer subresource.
+/// \param [in] Slice         - Array slice of the buffer subresource.
+/// \param [in] pSrcData      - Source RGBA8 texels of the whole mip level.
+/// \param [in] SrcStride     - Source row stride in bytes. If zero, the rows are tightly packed.
+/// \param [in] Quality       - Encoding quality.
+/// \param [in] NumThreads    - The number of threads to use, see BCEncodeAttribs::NumThreads.
+///
+/// \return     true if the data was encoded successfully, and false otherwise.
+///
+/// \remarks    The buffer must have been returned by ITextureUploader::AllocateUploadBuffer(),
+///             and must be mapped, i.e. the producer must call this function before
+///             ITextureUploader::ScheduleGPUCopy().
+bool EncodeBCToUploadBuffer(IUploadBuffer*    pUploadBuffer,
+                            Uint32            Mip,
+                            Uint32            Slice,
+                            const void*       pSrcData,
+                            Uint64            SrcStride,
+                            BC_ENCODE_QUALITY Quality    = BC_ENCODE_QUALITY_NORMAL,
+                            Uint32            NumThreads = 1);
+
+} // namespace Diligent
@@ -53,6 +53,9 @@ static const INTERFACE_ID IID_BufferSuballocator =
 struct IBufferSuballocation : public IObject
 {
     /// Returns the start offset of the suballocation.
+
+    /// \note   The offset may change when the parent allocator is defragmented,
+    ///         see IBufferSuballocator::Defragment().
     virtual Uint32 GetOffset() const = 0;
 
     /// Returns the suballocation size.
@@ -116,8 +119,47 @@ struct IBufferSuballocator : public IObject
 
 
     /// Returns internal buffer version. The version is incremented every time
-    /// the buffer is expanded.
+    /// the buffer is expanded or defragmented.
     virtual Uint32 GetVersion() const = 0;
+
+
+    /// Moves suballocations towards the beginning of the buffer to reduce fragmentation.
+
+    /// \param[in]  pDevice        - Pointer to the render device that will be used to create
+    ///                              the internal buffer, if necessary, and the scratch buffer.
+    /// \param[in]  pContext       - Pointer to the device context that will be used to
+    ///                              copy suballocation data.
+    /// \param[in]  MaxBytesToMove - The maximum number of bytes to move, e.g. the per-frame budget.
+    ///                              If zero, all suballocations that can be moved are moved.
+    ///
+    /// \return     The number of bytes moved.
+    ///
+    /// \remarks    Every suballocation is moved into the lowest free region that is located
+    ///             entirely before it, starting from the suballocations at the end of the buffer.
+    ///             The data is copied by the GPU through a scratch buffer, so that source and
+    ///             destination regions of a single copy never belong to the same buffer.
+    ///             The moves are performed in batches that reuse the scratch buffer, whose size
+    ///             is limited by BufferSuballocatorCreateInfo::MaxDefragmentationScratchSize.
+    ///             The scratch buffer is released when the method returns.
+    ///             The regions released by the moves become available when the copies have
+    ///             been recorded, so they are only used as destinations by the next call.
+    ///
+    ///             If any suballocation has been moved, its offset is updated and the buffer
+    ///             version is incremented. An application should compare the version to the one
+    ///             it saw last time and re-read the offsets of its suballocations.
+    ///
+    ///             The method is not thread-safe with respect to GetBuffer() and must be called
+    ///             from the thread that owns pContext. Allocate() may be called simultaneously.
+    virtual Uint32 Defragment(IRenderDevice*  pDevice,
+                              IDeviceContext* pContext,
+                              Uint32          MaxBytesToMove) = 0;
+
+
+    /// Returns the size of the largest free region.
+
+    /// \note   An allocation larger than this size will cause the buffer to be expanded,
+    ///         even if the total free size, see GetFreeSize(), is sufficient.
+    virtual Uint32 GetLargestFreeRegionSize() = 0;
 };
 
 /// Buffer suballocator create information.
@@ -141,6 +183,22 @@ struct BufferSuballocatorCreateInfo
     /// of IBufferSuballocation implementation class. This member defines
     /// the number of objects in one page.
     Uint32 SuballocationObjAllocationGranularity = 64;
+
+
+    /// Whether to use the constant-time TLSF allocations manager.
+
+    /// When true, the suballocator uses TLSFAllocationsManager that allocates and frees
+    /// subregions in constant time without per-block heap allocations. This is beneficial
+    /// when the buffer holds a large number of suballocations. When false,
+    /// VariableSizeAllocationsManager is used, which finds the best-fitting free block.
+    bool UseTLSF = false;
+
+
+    /// Maximum size of the scratch buffer used by IBufferSuballocator::Defragment(), in bytes.
+
+    /// Suballocations are moved in batches that fit into the scratch buffer. A suballocation
+    /// larger than this size is moved in a batch of its own.
+    Uint32 MaxDefragmentationScratchSize = 4u << 20u;
 };
 
 /// Creates a new buffer suballocator.
@@ -61,4 +61,73 @@ void DILIGENT_GLOBAL_FUNCTION(ComputeMipLevel)(Uint32         FineLevelWidth,
                                                void*          pCoarseLevelData,
                                                Uint32         CoarseDataStrideInBytes);
 
+
+/// Filter used by ComputeMipChain() to compute coarse mip levels
+DILIGENT_TYPED_ENUM(MIP_FILTER_TYPE, Uint8)
+{
+    /// 2x2 box filter. The results are bit-exact with ComputeMipLevel()
+    /// applied to every level in turn.
+    MIP_FILTER_TYPE_BOX = 0,
+
+    /// Kaiser-windowed sinc filter (radius 3, alpha 4)
+    MIP_FILTER_TYPE_KAISER,
+
+    /// Lanczos filter (radius 3)
+    MIP_FILTER_TYPE_LANCZOS
+};
+
+/// Mip chain computation attributes, see ComputeMipChain()
+struct ComputeMipChainAttribs
+{
+    /// Texture format
+    TEXTURE_FORMAT Format DEFAULT_INITIALIZER(TEX_FORMAT_UNKNOWN);
+
+    /// Width of the finest mip level
+    Uint32 FineLevelWidth DEFAULT_INITIALIZER(0);
+
+    /// Height of the finest mip level
+    Uint32 FineLevelHeight DEFAULT_INITIALIZER(0);
+
+    /// Finest mip level data
+    const void* pFineLevelData DEFAULT_INITIALIZER(nullptr);
+
+    /// Row stride of the finest mip level data, in bytes.
+    /// If zero, the rows are assumed to be tightly packed.
+    Uint32 FineLevelStride DEFAULT_INITIALIZER(0);
+
+    /// The number of coarse mip levels to compute
+    Uint32 NumCoarseLevels DEFAULT_INITIALIZER(0);
+
+    /// Array of NumCoarseLevels pointers to the coarse mip levels data.
+    /// ppCoarseLevelsData[0] receives mip level 1, ppCoarseLevelsData[1] - mip level 2, etc.
+    void* const* ppCoarseLevelsData DEFAULT_INITIALIZER(nullptr);
+
+    /// Optional array of NumCoarseLevels row strides of the coarse mip levels, in bytes.
+    /// If null, the rows are assumed to be tightly packed.
+    const Uint32* pCoarseLevelStrides DEFAULT_INITIALIZER(nullptr);
+
+    /// Filter type
+    MIP_FILTER_TYPE FilterType DEFAULT_INITIALIZER(MIP_FILTER_TYPE_BOX);
+
+    /// If greater than zero, alpha values of every coarse level are scaled
+    /// so that the fraction of texels that pass the alpha test with this reference
+    /// value matches that of the finest level.
+    /// Only formats with an alpha channel are affected.
+    Float32 AlphaCutoff DEFAULT_INITIALIZER(0);
+
+    /// The number of row ranges that are processed in parallel, see Diligent::ParallelForRanges()
+    Uint32 NumThreads DEFAULT_INITIALIZER(1);
+};
+typedef struct ComputeMipChainAttribs ComputeMipChainAttribs;
+
+/// Computes a chain of coarse mip levels from the finest one.
+
+/// \remarks   Compared to calling ComputeMipLevel() for every level, the box filter
+///            processes the top levels in strips that fit into the cache and
+///            uses vectorized kernels for 8-bit RGBA (including sRGB) and 32-bit float RGBA formats.
+///            Kaiser and Lanczos filters are separable and are applied to every level
+///            in linear space. They are only supported for UNORM, UNORM_SRGB, SNORM and
+///            32-bit float formats.
+void DILIGENT_GLOBAL_FUNCTION(ComputeMipChain)(const ComputeMipChainAttribs REF Attribs);
+
 DILIGENT_END_NAMESPACE // namespace Diligent
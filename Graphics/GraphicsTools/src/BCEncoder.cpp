@@ -0,0 +1,1439 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "BCEncoder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+#include "TextureUploader.hpp"
+#include "DebugUtilities.hpp"
+#include "GraphicsAccessories.hpp"
+#include "ThreadPool.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    include <emmintrin.h>
+#    define DILIGENT_BC_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#    include <arm_neon.h>
+#    define DILIGENT_BC_NEON 1
+#endif
+
+namespace Diligent
+{
+
+namespace
+{
+
+// 4x4 block of texels stored as a structure of arrays, so that
+// four texels of one channel can be processed at once.
+struct BlockTexels
+{
+    alignas(16) float Ch[4][16];
+};
+
+// Palette of up to 16 interpolated colors, stored by channel
+struct BlockPalette
+{
+    alignas(16) float Ch[4][16];
+    Uint32 Size = 0;
+};
+
+constexpr Uint32 AllTexelsMask = 0xFFFFu;
+
+void LoadBlock(const Uint8* pSrc, size_t SrcStride, Uint32 x0, Uint32 y0, Uint32 Width, Uint32 Height, BlockTexels& Block)
+{
+#if DILIGENT_BC_SSE2 || DILIGENT_BC_NEON
+    if (x0 + 4 <= Width && y0 + 4 <= Height)
+    {
+        for (Uint32 y = 0; y < 4; ++y)
+        {
+            const Uint8* pRow = pSrc + (y0 + y) * SrcStride + x0 * 4;
+#    if DILIGENT_BC_SSE2
+            const __m128i Zero  = _mm_setzero_si128();
+            const __m128i Row   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow));
+            const __m128i Row01 = _mm_unpacklo_epi8(Row, Zero);
+            const __m128i Row23 = _mm_unpackhi_epi8(Row, Zero);
+
+            __m128 T0 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(Row01, Zero));
+            __m128 T1 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(Row01, Zero));
+            __m128 T2 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(Row23, Zero));
+            __m128 T3 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(Row23, Zero));
+            _MM_TRANSPOSE4_PS(T0, T1, T2, T3);
+            _mm_store_ps(&Block.Ch[0][y * 4], T0);
+            _mm_store_ps(&Block.Ch[1][y * 4], T1);
+            _mm_store_ps(&Block.Ch[2][y * 4], T2);
+            _mm_store_ps(&Block.Ch[3][y * 4], T3);
+#    else
+            const uint8x16_t Row   = vld1q_u8(pRow);
+            const uint16x8_t Row01 = vmovl_u8(vget_low_u8(Row));
+            const uint16x8_t Row23 = vmovl_u8(vget_high_u8(Row));
+
+            const float32x4_t T0 = vcvtq_f32_u32(vmovl_u16(vget_low_u16(Row01)));
+            const float32x4_t T1 = vcvtq_f32_u32(vmovl_u16(vget_high_u16(Row01)));
+            const float32x4_t T2 = vcvtq_f32_u32(vmovl_u16(vget_low_u16(Row23)));
+            const float32x4_t T3 = vcvtq_f32_u32(vmovl_u16(vget_high_u16(Row23)));
+
+            // (r0 r1 b0 b1) (g0 g1 a0 a1) and (r2 r3 b2 b3) (g2 g3 a2 a3)
+            const float32x4x2_t T01 = vtrnq_f32(T0, T1);
+            const float32x4x2_t T23 = vtrnq_f32(T2, T3);
+            vst1q_f32(&Block.Ch[0][y * 4], vcombine_f32(vget_low_f32(T01.val[0]), vget_low_f32(T23.val[0])));
+            vst1q_f32(&Block.Ch[1][y * 4], vcombine_f32(vget_low_f32(T01.val[1]), vget_low_f32(T23.val[1])));
+            vst1q_f32(&Block.Ch[2][y * 4], vcombine_f32(vget_high_f32(T01.val[0]), vget_high_f32(T23.val[0])));
+            vst1q_f32(&Block.Ch[3][y * 4], vcombine_f32(vget_high_f32(T01.val[1]), vget_high_f32(T23.val[1])));
+#    endif
+        }
+        return;
+    }
+#endif
+
+    // Incomplete blocks replicate the last column and row
+    for (Uint32 y = 0; y < 4; ++y)
+    {
+        const Uint8* pRow = pSrc + std::min(y0 + y, Height - 1) * SrcStride;
+        for (Uint32 x = 0; x < 4; ++x)
+        {
+            const Uint8* pTexel = pRow + std::min(x0 + x, Width - 1) * 4;
+            for (Uint32 c = 0; c < 4; ++c)
+                Block.Ch[c][y * 4 + x] = pTexel[c];
+        }
+    }
+}
+
+// Finds the closest palette entry for every texel of the block using channels [FirstCh, FirstCh + NumCh).
+// Returns the total squared error of the texels in Mask.
+float SelectIndices(const BlockTexels& Block, const BlockPalette& Pal, Uint32 FirstCh, Uint32 NumCh, Uint32 Mask, Uint8 Indices[16])
+{
+    VERIFY_EXPR(Pal.Size > 0 && Pal.Size <= 16 && FirstCh + NumCh <= 4);
+
+    alignas(16) float Errors[16];
+    alignas(16) Int32 BestIndices[16];
+#if DILIGENT_BC_SSE2
+    for (Uint32 i = 0; i < 16; i += 4)
+    {
+        __m128 Texels[4];
+        for (Uint32 c = 0; c < NumCh; ++c)
+            Texels[c] = _mm_load_ps(&Block.Ch[FirstCh + c][i]);
+
+        __m128  BestErr = _mm_set1_ps(FLT_MAX);
+        __m128i BestIdx = _mm_setzero_si128();
+        for (Uint32 p = 0; p < Pal.Size; ++p)
+        {
+            __m128 Err = _mm_setzero_ps();
+            for (Uint32 c = 0; c < NumCh; ++c)
+            {
+                const __m128 Diff = _mm_sub_ps(Texels[c], _mm_set1_ps(Pal.Ch[FirstCh + c][p]));
+                Err               = _mm_add_ps(Err, _mm_mul_ps(Diff, Diff));
+            }
+            const __m128i Less = _mm_castps_si128(_mm_cmplt_ps(Err, BestErr));
+            BestErr            = _mm_min_ps(Err, BestErr);
+            BestIdx            = _mm_or_si128(_mm_and_si128(Less, _mm_set1_epi32(static_cast<int>(p))), _mm_andnot_si128(Less, BestIdx));
+        }
+        _mm_store_ps(&Errors[i], BestErr);
+        _mm_store_si128(reinterpret_cast<__m128i*>(&BestIndices[i]), BestIdx);
+    }
+#elif DILIGENT_BC_NEON
+    for (Uint32 i = 0; i < 16; i += 4)
+    {
+        float32x4_t Texels[4];
+        for (Uint32 c = 0; c < NumCh; ++c)
+            Texels[c] = vld1q_f32(&Block.Ch[FirstCh + c][i]);
+
+        float32x4_t BestErr = vdupq_n_f32(FLT_MAX);
+        uint32x4_t  BestIdx = vdupq_n_u32(0);
+        for (Uint32 p = 0; p < Pal.Size; ++p)
+        {
+            float32x4_t Err = vdupq_n_f32(0);
+            for (Uint32 c = 0; c < NumCh; ++c)
+            {
+                const float32x4_t Diff = vsubq_f32(Texels[c], vdupq_n_f32(Pal.Ch[FirstCh + c][p]));
+                Err                    = vmlaq_f32(Err, Diff, Diff);
+            }
+            const uint32x4_t Less = vcltq_f32(Err, BestErr);
+            BestErr               = vminq_f32(Err, BestErr);
+            BestIdx               = vbslq_u32(Less, vdupq_n_u32(p), BestIdx);
+        }
+        vst1q_f32(&Errors[i], BestErr);
+        vst1q_s32(&BestIndices[i], vreinterpretq_s32_u32(BestIdx));
+    }
+#else
+    for (Uint32 i = 0; i < 16; ++i)
+    {
+        float BestErr = FLT_MAX;
+        Int32 BestIdx = 0;
+        for (Uint32 p = 0; p < Pal.Size; ++p)
+        {
+            float Err = 0;
+            for (Uint32 c = FirstCh; c < FirstCh + NumCh; ++c)
+            {
+                const float Diff = Block.Ch[c][i] - Pal.Ch[c][p];
+                Err += Diff * Diff;
+            }
+            if (Err < BestErr)
+            {
+                BestErr = Err;
+                BestIdx = static_cast<Int32>(p);
+            }
+        }
+        Errors[i]      = BestErr;
+        BestIndices[i] = BestIdx;
+    }
+#endif
+
+    float TotalErr = 0;
+    for (Uint32 i = 0; i < 16; ++i)
+    {
+        Indices[i] = static_cast<Uint8>(BestIndices[i]);
+        if (Mask & (1u << i))
+            TotalErr += Errors[i];
+    }
+    return TotalErr;
+}
+
+// Finds the closest of NumSteps + 1 evenly spaced points on the segment from E0 (step 0) to E1
+// (step NumSteps) for every texel using channels [FirstCh, FirstCh + NumCh). As the points are
+// collinear, the closest point is the one closest to the projection of the texel onto the segment.
+// Writes the steps and the squared errors of all texels.
+void SelectSteps(const BlockTexels& Block, Uint32 FirstCh, Uint32 NumCh, const float E0[4], const float E1[4], Uint32 NumSteps, Uint8 Steps[16], float Errors[16])
+{
+    VERIFY_EXPR(NumSteps > 0 && FirstCh + NumCh <= 4);
+
+    float Dir[4]     = {};
+    float StepDir[4] = {};
+    float DirLenSq   = 0;
+    for (Uint32 c = 0; c < NumCh; ++c)
+    {
+        Dir[c]     = E1[FirstCh + c] - E0[FirstCh + c];
+        StepDir[c] = Dir[c] / static_cast<float>(NumSteps);
+        DirLenSq += Dir[c] * Dir[c];
+    }
+    const float ProjScale = DirLenSq > 0 ? static_cast<float>(NumSteps) / DirLenSq : 0.f;
+
+    alignas(16) Int32 StepsI[16];
+#if DILIGENT_BC_SSE2
+    const __m128 MaxStep = _mm_set1_ps(static_cast<float>(NumSteps));
+    for (Uint32 i = 0; i < 16; i += 4)
+    {
+        __m128 Texels[4];
+        __m128 t = _mm_setzero_ps();
+        for (Uint32 c = 0; c < NumCh; ++c)
+        {
+            Texels[c] = _mm_load_ps(&Block.Ch[FirstCh + c][i]);
+            t         = _mm_add_ps(t, _mm_mul_ps(_mm_sub_ps(Texels[c], _mm_set1_ps(E0[FirstCh + c])), _mm_set1_ps(Dir[c])));
+        }
+        t = _mm_min_ps(_mm_max_ps(_mm_mul_ps(t, _mm_set1_ps(ProjScale)), _mm_setzero_ps()), MaxStep);
+
+        const __m128i Step  = _mm_cvttps_epi32(_mm_add_ps(t, _mm_set1_ps(0.5f)));
+        const __m128  StepF = _mm_cvtepi32_ps(Step);
+
+        __m128 Err = _mm_setzero_ps();
+        for (Uint32 c = 0; c < NumCh; ++c)
+        {
+            const __m128 Diff = _mm_sub_ps(Texels[c], _mm_add_ps(_mm_set1_ps(E0[FirstCh + c]), _mm_mul_ps(StepF, _mm_set1_ps(StepDir[c]))));
+            Err               = _mm_add_ps(Err, _mm_mul_ps(Diff, Diff));
+        }
+        _mm_store_ps(&Errors[i], Err);
+        _mm_store_si128(reinterpret_cast<__m128i*>(&StepsI[i]), Step);
+    }
+#elif DILIGENT_BC_NEON
+    const float32x4_t MaxStep = vdupq_n_f32(static_cast<float>(NumSteps));
+    for (Uint32 i = 0; i < 16; i += 4)
+    {
+        float32x4_t Texels[4];
+        float32x4_t t = vdupq_n_f32(0);
+        for (Uint32 c = 0; c < NumCh; ++c)
+        {
+            Texels[c] = vld1q_f32(&Block.Ch[FirstCh + c][i]);
+            t         = vmlaq_f32(t, vsubq_f32(Texels[c], vdupq_n_f32(E0[FirstCh + c])), vdupq_n_f32(Dir[c]));
+        }
+        t = vminq_f32(vmaxq_f32(vmulq_f32(t, vdupq_n_f32(ProjScale)), vdupq_n_f32(0)), MaxStep);
+
+        const int32x4_t   Step  = vcvtq_s32_f32(vaddq_f32(t, vdupq_n_f32(0.5f)));
+        const float32x4_t StepF = vcvtq_f32_s32(Step);
+
+        float32x4_t Err = vdupq_n_f32(0);
+        for (Uint32 c = 0; c < NumCh; ++c)
+        {
+            const float32x4_t Diff = vsubq_f32(Texels[c], vmlaq_f32(vdupq_n_f32(E0[FirstCh + c]), StepF, vdupq_n_f32(StepDir[c])));
+            Err                    = vmlaq_f32(Err, Diff, Diff);
+        }
+        vst1q_f32(&Errors[i], Err);
+        vst1q_s32(&StepsI[i], Step);
+    }
+#else
+    for (Uint32 i = 0; i < 16; ++i)
+    {
+        float t = 0;
+        for (Uint32 c = 0; c < NumCh; ++c)
+            t += (Block.Ch[FirstCh + c][i] - E0[FirstCh + c]) * Dir[c];
+        t = std::min(std::max(t * ProjScale, 0.f), static_cast<float>(NumSteps));
+
+        StepsI[i]         = static_cast<Int32>(t + 0.5f);
+        const float StepF = static_cast<float>(StepsI[i]);
+
+        float Err = 0;
+        for (Uint32 c = 0; c < NumCh; ++c)
+        {
+            const float Diff = Block.Ch[FirstCh + c][i] - (E0[FirstCh + c] + StepF * StepDir[c]);
+            Err += Diff * Diff;
+        }
+        Errors[i] = Err;
+    }
+#endif
+
+    for (Uint32 i = 0; i < 16; ++i)
+        Steps[i] = static_cast<Uint8>(StepsI[i]);
+}
+
+float SumErrors(const float Errors[16], Uint32 Mask)
+{
+    float TotalErr = 0;
+    for (Uint32 i = 0; i < 16; ++i)
+    {
+        if (Mask & (1u << i))
+            TotalErr += Errors[i];
+    }
+    return TotalErr;
+}
+
+// Selects the endpoints as the corners of the bounding box of the block, inset by 1/16 of
+// its size. The channels that are negatively correlated with the channel of the largest
+// range are flipped, so that the endpoints follow the diagonal the colors are spread along.
+void FitBoundingBox(const BlockTexels& Block, Uint32 FirstCh, Uint32 NumCh, Uint32 Mask, float E0[4], float E1[4])
+{
+    float  Mean[4]   = {};
+    Uint32 NumTexels = 0;
+    for (Uint32 c = FirstCh; c < FirstCh + NumCh; ++c)
+    {
+        E0[c] = 255;
+        E1[c] = 0;
+    }
+    for (Uint32 i = 0; i < 16; ++i)
+    {
+        if ((Mask & (1u << i)) == 0)
+            continue;
+        for (Uint32 c = FirstCh; c < FirstCh + NumCh; ++c)
+        {
+            E0[c] = std::min(E0[c], Block.Ch[c][i]);
+            E1[c] = std::max(E1[c], Block.Ch[c][i]);
+            Mean[c] += Block.Ch[c][i];
+        }
+        ++NumTexels;
+    }
+    VERIFY_EXPR(NumTexels > 0);
+
+    Uint32 MainCh = FirstCh;
+    for (Uint32 c = FirstCh; c < FirstCh + NumCh; ++c)
+    {
+        Mean[c] /= static_cast<float>(NumTexels);
+        if (E1[c] - E0[c] > E1[MainCh] - E0[MainCh])
+            MainCh = c;
+    }
+
+    for (Uint32 c = FirstCh; c < FirstCh + NumCh; ++c)
+    {
+        if (c != MainCh)
+        {
+            float Cov = 0;
+            for (Uint32 i = 0; i < 16; ++i)
+            {
+                if (Mask & (1u << i))
+                    Cov += (Block.Ch[c][i] - Mean[c]) * (Block.Ch[MainCh][i] - Mean[MainCh]);
+            }
+            if (Cov < 0)
+                std::swap(E0[c], E1[c]);
+        }
+
+        const float Inset = (E1[c] - E0[c]) / 16.f;
+        E0[c] += Inset;
+        E1[c] -= Inset;
+    }
+}
+
+// Selects the endpoints as the extreme projections of the texels onto the principal axis of the block
+void FitPrincipalAxis(const BlockTexels& Block, Uint32 FirstCh, Uint32 NumCh, Uint32 Mask, float E0[4], float E1[4])
+{
+    float  Mean[4]   = {};
+    Uint32 NumTexels = 0;
+    for (Uint32 i = 0; i < 16; ++i)
+    {
+        if ((Mask & (1u << i)) == 0)
+            continue;
+        for (Uint32 c = 0; c < NumCh; ++c)
+            Mean[c] += Block.Ch[FirstCh + c][i];
+        ++NumTexels;
+    }
+    VERIFY_EXPR(NumTexels > 0);
+    for (Uint32 c = 0; c < NumCh; ++c)
+        Mean[c] /= static_cast<float>(NumTexels);
+
+    float Cov[4][4] = {};
+    for (Uint32 i = 0; i < 16; ++i)
+    {
+        if ((Mask & (1u << i)) == 0)
+            continue;
+        float d[4];
+        for (Uint32 c = 0; c < NumCh; ++c)
+            d[c] = Block.Ch[FirstCh + c][i] - Mean[c];
+        for (Uint32 r = 0; r < NumCh; ++r)
+        {
+            for (Uint32 c = r; c < NumCh; ++c)
+                Cov[r][c] += d[r] * d[c];
+        }
+    }
+    for (Uint32 r = 0; r < NumCh; ++r)
+    {
+        for (Uint32 c = 0; c < r; ++c)
+            Cov[r][c] = Cov[c][r];
+    }
+
+    // Power iteration, starting from the row of the channel with the largest variance
+    Uint32 MaxVarCh = 0;
+    for (Uint32 c = 1; c < NumCh; ++c)
+    {
+        if (Cov[c][c] > Cov[MaxVarCh][MaxVarCh])
+            MaxVarCh = c;
+    }
+
+    float Axis[4] = {};
+    for (Uint32 c = 0; c < NumCh; ++c)
+        Axis[c] = Cov[MaxVarCh][c];
+
+    float AxisLenSq = 0;
+    for (int Iter = 0; Iter < 8; ++Iter)
+    {
+        float NewAxis[4] = {};
+        for (Uint32 r = 0; r < NumCh; ++r)
+        {
+            for (Uint32 c = 0; c < NumCh; ++c)
+                NewAxis[r] += Cov[r][c] * Axis[c];
+        }
+
+        AxisLenSq = 0;
+        for (Uint32 c = 0; c < NumCh; ++c)
+            AxisLenSq += NewAxis[c] * NewAxis[c];
+        if (AxisLenSq < 1e-12f)
+            break;
+
+        const float InvLen = 1.f / std::sqrt(AxisLenSq);
+        for (Uint32 c = 0; c < NumCh; ++c)
+            Axis[c] = NewAxis[c] * InvLen;
+    }
+
+    if (AxisLenSq < 1e-12f)
+    {
+        // All texels are the same
+        for (Uint32 c = 0; c < NumCh; ++c)
+            E0[FirstCh + c] = E1[FirstCh + c] = Mean[c];
+        return;
+    }
+
+    float MinT = FLT_MAX;
+    float MaxT = -FLT_MAX;
+    for (Uint32 i = 0; i < 16; ++i)
+    {
+        if ((Mask & (1u << i)) == 0)
+            continue;
+        float t = 0;
+        for (Uint32 c = 0; c < NumCh; ++c)
+            t += (Block.Ch[FirstCh + c][i] - Mean[c]) * Axis[c];
+        MinT = std::min(MinT, t);
+        MaxT = std::max(MaxT, t);
+    }
+
+    for (Uint32 c = 0; c < NumCh; ++c)
+    {
+        E0[FirstCh + c] = std::min(std::max(Mean[c] + MinT * Axis[c], 0.f), 255.f);
+        E1[FirstCh + c] = std::min(std::max(Mean[c] + MaxT * Axis[c], 0.f), 255.f);
+    }
+}
+
+// Finds the endpoints that minimize the squared error of the texels in Mask, where every texel
+// is interpolated between the endpoints with the given weight (0 - first endpoint, 1 - second endpoint).
+bool RefineEndpoints(const BlockTexels& Block, Uint32 FirstCh, Uint32 NumCh, Uint32 Mask, const float Weights[16], float E0[4], float E1[4])
+{
+    float A = 0, B = 0, C = 0;
+    float X0[4] = {};
+    float X1[4] = {};
+    for (Uint32 i = 0; i < 16; ++i)
+    {
+        if ((Mask & (1u << i)) == 0)
+            continue;
+        const float w1 = Weights[i];
+        const float w0 = 1.f - w1;
+        A += w0 * w0;
+        B += w0 * w1;
+        C += w1 * w1;
+        for (Uint32 c = 0; c < NumCh; ++c)
+        {
+            X0[c] += w0 * Block.Ch[FirstCh + c][i];
+            X1[c] += w1 * Block.Ch[FirstCh + c][i];
+        }
+    }
+
+    const float Det = A * C - B * B;
+    if (std::abs(Det) < 1e-6f)
+        return false;
+
+    const float InvDet = 1.f / Det;
+    for (Uint32 c = 0; c < NumCh; ++c)
+    {
+        E0[FirstCh + c] = std::min(std::max((C * X0[c] - B * X1[c]) * InvDet, 0.f), 255.f);
+        E1[FirstCh + c] = std::min(std::max((A * X1[c] - B * X0[c]) * InvDet, 0.f), 255.f);
+    }
+    return true;
+}
+
+// Number of endpoint refinement iterations in normal quality mode
+constexpr int NumRefineIterations = 2;
+
+
+// BC1 color block
+
+Uint16 PackRGB565(const float RGB[3])
+{
+    const auto r = static_cast<Uint32>(RGB[0] * (31.f / 255.f) + 0.5f);
+    const auto g = static_cast<Uint32>(RGB[1] * (63.f / 255.f) + 0.5f);
+    const auto b = static_cast<Uint32>(RGB[2] * (31.f / 255.f) + 0.5f);
+    return static_cast<Uint16>((r << 11) | (g << 5) | b);
+}
+
+void UnpackRGB565(Uint32 Color, float RGB[3])
+{
+    const Uint32 r = (Color >> 11) & 0x1F;
+    const Uint32 g = (Color >> 5) & 0x3F;
+    const Uint32 b = Color & 0x1F;
+    RGB[0]         = static_cast<float>((r << 3) | (r >> 2));
+    RGB[1]         = static_cast<float>((g << 2) | (g >> 4));
+    RGB[2]         = static_cast<float>((b << 3) | (b >> 2));
+}
+
+// BC1 blocks with Color0 > Color1 use four colors, otherwise three colors and transparent black.
+// The color block of BC3 always uses four colors. The texels are stored as steps from Color0
+// to Color1 and are converted to indices when the block is written.
+struct BC1ColorBlock
+{
+    Uint16 Color0    = 0;
+    Uint16 Color1    = 0;
+    Uint32 NumSteps  = 3; // 3 - four colors, 2 - three colors
+    Uint8  Steps[16] = {};
+    float  Error     = FLT_MAX;
+};
+
+// Quantizes the endpoints, selects the steps and keeps the block if it is better than the current one
+void EvaluateBC1(const BlockTexels& Block, Uint32 Mask, const float E0[4], const float E1[4], bool ThreeColors, bool IsBC3, BC1ColorBlock& Best)
+{
+    BC1ColorBlock Candidate;
+    Candidate.Color0 = PackRGB565(E0);
+    Candidate.Color1 = PackRGB565(E1);
+    if (!IsBC3 && (ThreeColors ? Candidate.Color0 > Candidate.Color1 : Candidate.Color0 < Candidate.Color1))
+        std::swap(Candidate.Color0, Candidate.Color1);
+    // Index 3 in the three-color mode is transparent black and is never selected for opaque texels
+    Candidate.NumSteps = (IsBC3 || Candidate.Color0 > Candidate.Color1) ? 3 : 2;
+
+    float C0[4], C1[4];
+    UnpackRGB565(Candidate.Color0, C0);
+    UnpackRGB565(Candidate.Color1, C1);
+
+    alignas(16) float Errors[16];
+    SelectSteps(Block, 0, 3, C0, C1, Candidate.NumSteps, Candidate.Steps, Errors);
+    Candidate.Error = SumErrors(Errors, Mask);
+    if (Candidate.Error < Best.Error)
+        Best = Candidate;
+}
+
+// For every 8-bit value, the pair of 5- or 6-bit endpoints whose 1/3 interpolant is the closest to the value
+struct SingleColorTables
+{
+    Uint8 Match5[256][2];
+    Uint8 Match6[256][2];
+
+    SingleColorTables()
+    {
+        InitTable(Match5, 5);
+        InitTable(Match6, 6);
+    }
+
+private:
+    static void InitTable(Uint8 Table[256][2], Uint32 NumBits)
+    {
+        const Uint32 MaxVal = (1u << NumBits) - 1;
+        for (Uint32 v = 0; v < 256; ++v)
+        {
+            float BestErr = FLT_MAX;
+            for (Uint32 a = 0; a <= MaxVal; ++a)
+            {
+                for (Uint32 b = 0; b <= MaxVal; ++b)
+                {
+                    const auto  ea  = static_cast<float>((a << (8 - NumBits)) | (a >> (2 * NumBits - 8)));
+                    const auto  eb  = static_cast<float>((b << (8 - NumBits)) | (b >> (2 * NumBits - 8)));
+                    const float Err = std::abs((2.f * ea + eb) / 3.f - static_cast<float>(v));
+                    if (Err < BestErr)
+                    {
+                        BestErr     = Err;
+                        Table[v][0] = static_cast<Uint8>(a);
+                        Table[v][1] = static_cast<Uint8>(b);
+                    }
+                }
+            }
+        }
+    }
+};
+
+// Texels that are not in Mask are written as transparent black
+void WriteBC1ColorBlock(const BC1ColorBlock& Block, Uint32 Mask, Uint8* pDst)
+{
+    static constexpr Uint8 FourColorIndices[]  = {0, 2, 3, 1};
+    static constexpr Uint8 ThreeColorIndices[] = {0, 2, 1};
+
+    Uint32 Indices = 0;
+    for (Uint32 i = 0; i < 16; ++i)
+    {
+        Uint32 Idx = 3;
+        if (Mask & (1u << i))
+            Idx = Block.NumSteps == 3 ? FourColorIndices[Block.Steps[i]] : ThreeColorIndices[Block.Steps[i]];
+        Indices |= Idx << (i * 2);
+    }
+
+    pDst[0] = static_cast<Uint8>(Block.Color0);
+    pDst[1] = static_cast<Uint8>(Block.Color0 >> 8);
+    pDst[2] = static_cast<Uint8>(Block.Color1);
+    pDst[3] = static_cast<Uint8>(Block.Color1 >> 8);
+    for (Uint32 i = 0; i < 4; ++i)
+        pDst[4 + i] = static_cast<Uint8>(Indices >> (i * 8));
+}
+
+void EncodeBC1Color(const BlockTexels& Block, BC_ENCODE_QUALITY Quality, bool IsBC3, Uint8* pDst)
+{
+    BC1ColorBlock Best;
+
+    // Texels with alpha below 128 are encoded as transparent black in BC1
+    Uint32 Mask = AllTexelsMask;
+    if (!IsBC3)
+    {
+        for (Uint32 i = 0; i < 16; ++i)
+        {
+            if (Block.Ch[3][i] < 128.f)
+                Mask &= ~(1u << i);
+        }
+        if (Mask == 0)
+        {
+            Best.Color0 = Best.Color1 = 0;
+            WriteBC1ColorBlock(Best, Mask, pDst);
+            return;
+        }
+    }
+    const bool ThreeColors = Mask != AllTexelsMask;
+
+    bool IsSolid = !ThreeColors;
+    for (Uint32 i = 1; i < 16 && IsSolid; ++i)
+        IsSolid = Block.Ch[0][i] == Block.Ch[0][0] && Block.Ch[1][i] == Block.Ch[1][0] && Block.Ch[2][i] == Block.Ch[2][0];
+    if (IsSolid)
+    {
+        // Use the 1/3 interpolant of the endpoints that are the closest to the color
+        static const SingleColorTables Tables;
+
+        const auto r = static_cast<Uint32>(Block.Ch[0][0]);
+        const auto g = static_cast<Uint32>(Block.Ch[1][0]);
+        const auto b = static_cast<Uint32>(Block.Ch[2][0]);
+
+        Best.Color0 = static_cast<Uint16>((Tables.Match5[r][0] << 11) | (Tables.Match6[g][0] << 5) | Tables.Match5[b][0]);
+        Best.Color1 = static_cast<Uint16>((Tables.Match5[r][1] << 11) | (Tables.Match6[g][1] << 5) | Tables.Match5[b][1]);
+
+        Uint8 Step = 1;
+        if (Best.Color0 == Best.Color1)
+        {
+            Step = 0;
+        }
+        else if (!IsBC3 && Best.Color0 < Best.Color1)
+        {
+            std::swap(Best.Color0, Best.Color1);
+            Step = 2;
+        }
+        Best.NumSteps = (IsBC3 || Best.Color0 > Best.Color1) ? 3 : 2;
+        for (auto& S : Best.Steps)
+            S = Step;
+        WriteBC1ColorBlock(Best, Mask, pDst);
+        return;
+    }
+
+    float E0[4], E1[4];
+    if (Quality == BC_ENCODE_QUALITY_FAST)
+        FitBoundingBox(Block, 0, 3, Mask, E0, E1);
+    else
+        FitPrincipalAxis(Block, 0, 3, Mask, E0, E1);
+    EvaluateBC1(Block, Mask, E0, E1, ThreeColors, IsBC3, Best);
+
+    if (Quality != BC_ENCODE_QUALITY_FAST)
+    {
+        if (!ThreeColors && !IsBC3)
+        {
+            // The three-color mode may be a better fit for opaque blocks too
+            EvaluateBC1(Block, Mask, E0, E1, true, false, Best);
+        }
+
+        for (int Iter = 0; Iter < NumRefineIterations; ++Iter)
+        {
+            float Weights[16];
+            for (Uint32 i = 0; i < 16; ++i)
+                Weights[i] = static_cast<float>(Best.Steps[i]) / static_cast<float>(Best.NumSteps);
+
+            const float PrevError = Best.Error;
+            if (!RefineEndpoints(Block, 0, 3, Mask, Weights, E0, E1))
+                break;
+            EvaluateBC1(Block, Mask, E0, E1, Best.NumSteps == 2, IsBC3, Best);
+            if (Best.Error >= PrevError)
+                break;
+        }
+    }
+
+    WriteBC1ColorBlock(Best, Mask, pDst);
+}
+
+
+// BC4 single-channel block
+
+// Blocks with Value0 > Value1 interpolate eight values, otherwise six values plus 0 and 255
+struct BC4Block
+{
+    Uint8 Value0      = 0;
+    Uint8 Value1      = 0;
+    Uint8 Indices[16] = {};
+    float Error       = FLT_MAX;
+};
+
+void EvaluateBC4(const BlockTexels& Block, Uint32 Ch, float E0, float E1, bool SixValues, BC4Block& Best)
+{
+    auto Value0 = static_cast<Uint32>(std::min(std::max(E0, 0.f), 255.f) + 0.5f);
+    auto Value1 = static_cast<Uint32>(std::min(std::max(E1, 0.f), 255.f) + 0.5f);
+    if (SixValues ? Value0 > Value1 : Value0 < Value1)
+        std::swap(Value0, Value1);
+    if (!SixValues && Value0 == Value1)
+        return;
+
+    const Uint32 NumSteps = SixValues ? 5 : 7;
+
+    float V0[4], V1[4];
+    V0[Ch] = static_cast<float>(Value0);
+    V1[Ch] = static_cast<float>(Value1);
+
+    Uint8             Steps[16];
+    alignas(16) float Errors[16];
+    SelectSteps(Block, Ch, 1, V0, V1, NumSteps, Steps, Errors);
+
+    BC4Block Candidate;
+    Candidate.Value0 = static_cast<Uint8>(Value0);
+    Candidate.Value1 = static_cast<Uint8>(Value1);
+    Candidate.Error  = 0;
+    for (Uint32 i = 0; i < 16; ++i)
+    {
+        // Index 0 is Value0, index 1 is Value1, indices 2 .. NumSteps are the interpolated values
+        const Uint32 Step = Steps[i];
+        Uint32       Idx  = Step == 0 ? 0 : (Step == NumSteps ? 1 : Step + 1);
+        float        Err  = Errors[i];
+        if (SixValues)
+        {
+            const float Val = Block.Ch[Ch][i];
+            if (Val * Val < Err)
+            {
+                Idx = 6;
+                Err = Val * Val;
+            }
+            if ((255.f - Val) * (255.f - Val) < Err)
+            {
+                Idx = 7;
+                Err = (255.f - Val) * (255.f - Val);
+            }
+        }
+        Candidate.Indices[i] = static_cast<Uint8>(Idx);
+        Candidate.Error += Err;
+    }
+
+    if (Candidate.Error < Best.Error)
+        Best = Candidate;
+}
+
+void RefineBC4(const BlockTexels& Block, Uint32 Ch, bool SixValues, BC4Block& Best)
+{
+    for (int Iter = 0; Iter < NumRefineIterations; ++Iter)
+    {
+        // Only the texels that use the interpolated values are included, so
+        // that 0 and 255 of the six-value mode do not affect the endpoints
+        const Uint32 NumSteps = SixValues ? 5 : 7;
+        float        Weights[16];
+        Uint32       Mask = 0;
+        for (Uint32 i = 0; i < 16; ++i)
+        {
+            const Uint32 Idx = Best.Indices[i];
+            if (Idx <= NumSteps)
+            {
+                Weights[i] = Idx == 0 ? 0.f : (Idx == 1 ? 1.f : static_cast<float>(Idx - 1) / static_cast<float>(NumSteps));
+                Mask |= 1u << i;
+            }
+        }
+
+        float E0[4], E1[4];
+        if (Mask == 0 || !RefineEndpoints(Block, Ch, 1, Mask, Weights, E0, E1))
+            break;
+
+        const float PrevError = Best.Error;
+        EvaluateBC4(Block, Ch, E0[Ch], E1[Ch], SixValues, Best);
+        if (Best.Error >= PrevError)
+            break;
+    }
+}
+
+void EncodeBC4(const BlockTexels& Block, Uint32 Ch, BC_ENCODE_QUALITY Quality, Uint8* pDst)
+{
+    float MinVal = 255, MaxVal = 0;
+    // Range of the values excluding 0 and 255 that are explicitly encoded by the six-value mode
+    float MinInner = 255, MaxInner = 0;
+    for (Uint32 i = 0; i < 16; ++i)
+    {
+        const float Val = Block.Ch[Ch][i];
+        MinVal          = std::min(MinVal, Val);
+        MaxVal          = std::max(MaxVal, Val);
+        if (Val > 0 && Val < 255)
+        {
+            MinInner = std::min(MinInner, Val);
+            MaxInner = std::max(MaxInner, Val);
+        }
+    }
+
+    BC4Block Best;
+    if (MinVal == MaxVal)
+    {
+        Best.Value0 = Best.Value1 = static_cast<Uint8>(MinVal);
+    }
+    else
+    {
+        EvaluateBC4(Block, Ch, MaxVal, MinVal, false, Best);
+        if (Quality != BC_ENCODE_QUALITY_FAST)
+        {
+            RefineBC4(Block, Ch, false, Best);
+
+            if (MinVal == 0 || MaxVal == 255)
+            {
+                const bool HasInner = MinInner <= MaxInner;
+                EvaluateBC4(Block, Ch, HasInner ? MinInner : 0.f, HasInner ? MaxInner : 255.f, true, Best);
+                RefineBC4(Block, Ch, true, Best);
+            }
+        }
+    }
+
+    Uint64 Indices = 0;
+    for (Uint32 i = 0; i < 16; ++i)
+        Indices |= Uint64{Best.Indices[i]} << (i * 3);
+
+    pDst[0] = Best.Value0;
+    pDst[1] = Best.Value1;
+    for (Uint32 i = 0; i < 6; ++i)
+        pDst[2 + i] = static_cast<Uint8>(Indices >> (i * 8));
+}
+
+
+// BC7 mode 6 block
+
+constexpr Uint32 BC7Weights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+struct BC7Mode6Block
+{
+    Uint8 Endpoints[2][4] = {}; // 7-bit values
+    Uint8 PBits[2]        = {};
+    Uint8 Indices[16]     = {};
+    float Error           = FLT_MAX;
+};
+
+// Quantizes the endpoint to 7 bits with the given P-bit; returns the squared quantization error
+float QuantizeBC7Endpoint(const float E[4], Uint32 PBit, Uint8 Q[4])
+{
+    float Err = 0;
+    for (Uint32 c = 0; c < 4; ++c)
+    {
+        const float q = std::min(std::max(std::floor((E[c] - static_cast<float>(PBit)) * 0.5f + 0.5f), 0.f), 127.f);
+        const float d = q * 2.f + static_cast<float>(PBit) - E[c];
+        Q[c]          = static_cast<Uint8>(q);
+        Err += d * d;
+    }
+    return Err;
+}
+
+// Selects the P-bit that minimizes the quantization error of the endpoint
+Uint32 SelectBC7PBit(const float E[4])
+{
+    Uint8 Q[4];
+    return QuantizeBC7Endpoint(E, 1, Q) < QuantizeBC7Endpoint(E, 0, Q) ? 1 : 0;
+}
+
+// Returns true if the block is better than the current one
+bool EvaluateBC7Mode6(const BlockTexels& Block, const float E0[4], const float E1[4], Uint32 PBit0, Uint32 PBit1, BC7Mode6Block& Best)
+{
+    BC7Mode6Block Candidate;
+    Candidate.PBits[0] = static_cast<Uint8>(PBit0);
+    Candidate.PBits[1] = static_cast<Uint8>(PBit1);
+    QuantizeBC7Endpoint(E0, PBit0, Candidate.Endpoints[0]);
+    QuantizeBC7Endpoint(E1, PBit1, Candidate.Endpoints[1]);
+
+    BlockPalette Pal;
+    for (Uint32 c = 0; c < 4; ++c)
+    {
+        const Uint32 v0 = (Uint32{Candidate.Endpoints[0][c]} << 1) | PBit0;
+        const Uint32 v1 = (Uint32{Candidate.Endpoints[1][c]} << 1) | PBit1;
+        for (Uint32 i = 0; i < 16; ++i)
+            Pal.Ch[c][i] = static_cast<float>(((64 - BC7Weights4[i]) * v0 + BC7Weights4[i] * v1 + 32) >> 6);
+    }
+    Pal.Size = 16;
+
+    Candidate.Error = SelectIndices(Block, Pal, 0, 4, AllTexelsMask, Candidate.Indices);
+    if (Candidate.Error >= Best.Error)
+        return false;
+
+    Best = Candidate;
+    return true;
+}
+
+class BC7BitWriter
+{
+public:
+    void Write(Uint32 Value, Uint32 NumBits)
+    {
+        VERIFY_EXPR(NumBits < 32 && m_Pos + NumBits <= 128);
+        if (m_Pos < 64)
+        {
+            m_Bits[0] |= Uint64{Value} << m_Pos;
+            if (m_Pos + NumBits > 64)
+                m_Bits[1] |= Uint64{Value} >> (64 - m_Pos);
+        }
+        else
+        {
+            m_Bits[1] |= Uint64{Value} << (m_Pos - 64);
+        }
+        m_Pos += NumBits;
+    }
+
+    void Store(Uint8* pDst) const
+    {
+        VERIFY_EXPR(m_Pos == 128);
+        for (Uint32 i = 0; i < 16; ++i)
+            pDst[i] = static_cast<Uint8>(m_Bits[i / 8] >> ((i % 8) * 8));
+    }
+
+private:
+    Uint64 m_Bits[2] = {};
+    Uint32 m_Pos     = 0;
+};
+
+// BC7 mode 1 and 3 blocks: two subsets with RGB endpoints, alpha is always 255
+
+// Texel masks of the second subset of the two-subset partitions
+constexpr Uint16 BC7Partitions2[64] = {
+    0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80, 0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+    0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE, 0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+    0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A, 0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+    0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C, 0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22,
+};
+
+// Anchor texels of the second subset of the two-subset partitions
+constexpr Uint8 BC7Anchors2[64] = {
+    15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+    15, 2, 8, 2, 2, 8, 8, 15, 2, 8, 2, 2, 8, 8, 2, 2,
+    15, 15, 6, 8, 2, 8, 15, 15, 2, 8, 2, 2, 2, 15, 15, 6,
+    6, 2, 6, 8, 15, 15, 2, 2, 15, 15, 15, 15, 15, 2, 2, 15,
+};
+
+constexpr Uint32 BC7Weights2[4] = {0, 21, 43, 64};
+constexpr Uint32 BC7Weights3[8] = {0, 9, 18, 27, 37, 46, 55, 64};
+
+struct BC7TwoSubsetMode
+{
+    Uint32        Mode;
+    Uint32        EndpointBits; // Without the P-bit
+    bool          SharedPBits;  // One P-bit per subset rather than per endpoint
+    Uint32        IndexBits;
+    const Uint32* Weights;
+};
+
+constexpr BC7TwoSubsetMode BC7Mode1{1, 6, true, 3, BC7Weights3};
+constexpr BC7TwoSubsetMode BC7Mode3{3, 7, false, 2, BC7Weights2};
+
+// Number of the partitions with the lowest estimated error that are fully evaluated
+constexpr Uint32 NumBC7PartitionCandidates = 4;
+
+struct BC7TwoSubsetBlock
+{
+    const BC7TwoSubsetMode* pMode = nullptr;
+
+    Uint32 Partition       = 0;
+    Uint8  Endpoints[4][3] = {}; // Subset s uses endpoints 2s and 2s + 1
+    Uint8  PBits[4]        = {};
+    Uint8  Indices[16]     = {};
+    float  Error           = FLT_MAX;
+};
+
+Uint32 GetBC7SubsetMask(Uint32 Partition, Uint32 Subset)
+{
+    return Subset == 0 ? (~Uint32{BC7Partitions2[Partition]} & AllTexelsMask) : Uint32{BC7Partitions2[Partition]};
+}
+
+// Expands the quantized endpoint component with the P-bit to 8 bits
+Uint32 ExpandBC7Component(Uint32 Q, Uint32 PBit, Uint32 EndpointBits)
+{
+    const Uint32 NumBits = EndpointBits + 1;
+    const Uint32 Value   = (Q << 1u) | PBit;
+    return NumBits < 8 ? (Value << (8 - NumBits)) | (Value >> (2 * NumBits - 8)) : Value;
+}
+
+// Quantizes the RGB endpoint with the given P-bit; returns the squared quantization error
+float QuantizeBC7EndpointRGB(const float E[4], Uint32 PBit, Uint32 EndpointBits, Uint8 Q[3])
+{
+    const float MaxQ  = static_cast<float>((1u << EndpointBits) - 1);
+    const float Scale = static_cast<float>((2u << EndpointBits) - 1) / 255.f;
+
+    float Err = 0;
+    for (Uint32 c = 0; c < 3; ++c)
+    {
+        const float q = std::min(std::max(std::floor((E[c] * Scale - static_cast<float>(PBit)) * 0.5f + 0.5f), 0.f), MaxQ);
+        Q[c]          = static_cast<Uint8>(q);
+        const float d = static_cast<float>(ExpandBC7Component(Q[c], PBit, EndpointBits)) - E[c];
+        Err += d * d;
+    }
+    return Err;
+}
+
+// Quantizes the endpoints of both subsets and selects the indices. Returns true if the block is better than the current one.
+bool EvaluateBC7TwoSubsets(const BlockTexels& Block, const BC7TwoSubsetMode& Mode, Uint32 Partition, const float E[4][4], BC7TwoSubsetBlock& Best)
+{
+    BC7TwoSubsetBlock Candidate;
+    Candidate.pMode     = &Mode;
+    Candidate.Partition = Partition;
+    Candidate.Error     = 0;
+
+    const Uint32 NumWeights = 1u << Mode.IndexBits;
+    for (Uint32 s = 0; s < 2; ++s)
+    {
+        Uint8 Q[3];
+        if (Mode.SharedPBits)
+        {
+            const float Err0 = QuantizeBC7EndpointRGB(E[s * 2], 0, Mode.EndpointBits, Q) + QuantizeBC7EndpointRGB(E[s * 2 + 1], 0, Mode.EndpointBits, Q);
+            const float Err1 = QuantizeBC7EndpointRGB(E[s * 2], 1, Mode.EndpointBits, Q) + QuantizeBC7EndpointRGB(E[s * 2 + 1], 1, Mode.EndpointBits, Q);
+
+            Candidate.PBits[s * 2] = Candidate.PBits[s * 2 + 1] = Err1 < Err0 ? 1 : 0;
+        }
+        else
+        {
+            for (Uint32 e = s * 2; e < s * 2 + 2; ++e)
+                Candidate.PBits[e] = QuantizeBC7EndpointRGB(E[e], 1, Mode.EndpointBits, Q) < QuantizeBC7EndpointRGB(E[e], 0, Mode.EndpointBits, Q) ? 1 : 0;
+        }
+        for (Uint32 e = s * 2; e < s * 2 + 2; ++e)
+            QuantizeBC7EndpointRGB(E[e], Candidate.PBits[e], Mode.EndpointBits, Candidate.Endpoints[e]);
+
+        BlockPalette Pal;
+        for (Uint32 c = 0; c < 3; ++c)
+        {
+            const Uint32 v0 = ExpandBC7Component(Candidate.Endpoints[s * 2][c], Candidate.PBits[s * 2], Mode.EndpointBits);
+            const Uint32 v1 = ExpandBC7Component(Candidate.Endpoints[s * 2 + 1][c], Candidate.PBits[s * 2 + 1], Mode.EndpointBits);
+            for (Uint32 i = 0; i < NumWeights; ++i)
+                Pal.Ch[c][i] = static_cast<float>(((64 - Mode.Weights[i]) * v0 + Mode.Weights[i] * v1 + 32) >> 6);
+        }
+        Pal.Size = NumWeights;
+
+        const Uint32 Mask = GetBC7SubsetMask(Partition, s);
+
+        Uint8 Indices[16];
+        Candidate.Error += SelectIndices(Block, Pal, 0, 3, Mask, Indices);
+        if (Candidate.Error >= Best.Error)
+            return false;
+
+        for (Uint32 i = 0; i < 16; ++i)
+        {
+            if (Mask & (1u << i))
+                Candidate.Indices[i] = Indices[i];
+        }
+    }
+
+    Best = Candidate;
+    return true;
+}
+
+// Fits and refines the endpoints of both subsets of the partition
+void EncodeBC7TwoSubsets(const BlockTexels& Block, const BC7TwoSubsetMode& Mode, Uint32 Partition, BC7TwoSubsetBlock& Best)
+{
+    float E[4][4] = {};
+    for (Uint32 s = 0; s < 2; ++s)
+        FitPrincipalAxis(Block, 0, 3, GetBC7SubsetMask(Partition, s), E[s * 2], E[s * 2 + 1]);
+
+    BC7TwoSubsetBlock Candidate;
+    EvaluateBC7TwoSubsets(Block, Mode, Partition, E, Candidate);
+    for (int Iter = 0; Iter < NumRefineIterations; ++Iter)
+    {
+        float Weights[16];
+        for (Uint32 i = 0; i < 16; ++i)
+            Weights[i] = static_cast<float>(Mode.Weights[Candidate.Indices[i]]) / 64.f;
+
+        bool Refined = false;
+        for (Uint32 s = 0; s < 2; ++s)
+            Refined = RefineEndpoints(Block, 0, 3, GetBC7SubsetMask(Partition, s), Weights, E[s * 2], E[s * 2 + 1]) || Refined;
+        if (!Refined || !EvaluateBC7TwoSubsets(Block, Mode, Partition, E, Candidate))
+            break;
+    }
+
+    if (Candidate.Error < Best.Error)
+        Best = Candidate;
+}
+
+// Estimates the error of the partition with the unquantized endpoints on the principal axes of the subsets
+float EstimateBC7Partition(const BlockTexels& Block, Uint32 Partition, Uint32 NumSteps)
+{
+    float Err = 0;
+    for (Uint32 s = 0; s < 2; ++s)
+    {
+        const Uint32 Mask = GetBC7SubsetMask(Partition, s);
+
+        float E0[4], E1[4];
+        FitPrincipalAxis(Block, 0, 3, Mask, E0, E1);
+
+        Uint8 Steps[16];
+        float Errors[16];
+        SelectSteps(Block, 0, 3, E0, E1, NumSteps, Steps, Errors);
+        Err += SumErrors(Errors, Mask);
+    }
+    return Err;
+}
+
+// Evaluates modes 1 and 3 for the partitions with the lowest estimated errors
+void SearchBC7Partitions(const BlockTexels& Block, BC7TwoSubsetBlock& Best)
+{
+    Uint32 Candidates[NumBC7PartitionCandidates] = {};
+    float  CandidateErrors[NumBC7PartitionCandidates];
+    std::fill_n(CandidateErrors, NumBC7PartitionCandidates, FLT_MAX);
+    for (Uint32 Partition = 0; Partition < 64; ++Partition)
+    {
+        const float Err = EstimateBC7Partition(Block, Partition, 7);
+
+        Uint32 Pos = NumBC7PartitionCandidates;
+        while (Pos > 0 && Err < CandidateErrors[Pos - 1])
+        {
+            if (Pos < NumBC7PartitionCandidates)
+            {
+                Candidates[Pos]      = Candidates[Pos - 1];
+                CandidateErrors[Pos] = CandidateErrors[Pos - 1];
+            }
+            --Pos;
+        }
+        if (Pos < NumBC7PartitionCandidates)
+        {
+            Candidates[Pos]      = Partition;
+            CandidateErrors[Pos] = Err;
+        }
+    }
+
+    for (Uint32 i = 0; i < NumBC7PartitionCandidates; ++i)
+    {
+        EncodeBC7TwoSubsets(Block, BC7Mode1, Candidates[i], Best);
+        EncodeBC7TwoSubsets(Block, BC7Mode3, Candidates[i], Best);
+    }
+}
+
+void WriteBC7TwoSubsetBlock(BC7TwoSubsetBlock& Block, Uint8* pDst)
+{
+    const BC7TwoSubsetMode& Mode = *Block.pMode;
+
+    // The most significant bit of the index of the anchor texel of every subset is implicitly zero
+    const Uint32 Anchors[2] = {0, BC7Anchors2[Block.Partition]};
+    const Uint32 MaxIndex   = (1u << Mode.IndexBits) - 1;
+    for (Uint32 s = 0; s < 2; ++s)
+    {
+        if ((Block.Indices[Anchors[s]] >> (Mode.IndexBits - 1)) == 0)
+            continue;
+
+        for (Uint32 c = 0; c < 3; ++c)
+            std::swap(Block.Endpoints[s * 2][c], Block.Endpoints[s * 2 + 1][c]);
+        std::swap(Block.PBits[s * 2], Block.PBits[s * 2 + 1]);
+
+        const Uint32 Mask = GetBC7SubsetMask(Block.Partition, s);
+        for (Uint32 i = 0; i < 16; ++i)
+        {
+            if (Mask & (1u << i))
+                Block.Indices[i] = static_cast<Uint8>(MaxIndex - Block.Indices[i]);
+        }
+    }
+
+    BC7BitWriter Writer;
+    Writer.Write(1u << Mode.Mode, Mode.Mode + 1);
+    Writer.Write(Block.Partition, 6);
+    for (Uint32 c = 0; c < 3; ++c)
+    {
+        for (Uint32 e = 0; e < 4; ++e)
+            Writer.Write(Block.Endpoints[e][c], Mode.EndpointBits);
+    }
+    if (Mode.SharedPBits)
+    {
+        Writer.Write(Block.PBits[0], 1);
+        Writer.Write(Block.PBits[2], 1);
+    }
+    else
+    {
+        for (Uint32 e = 0; e < 4; ++e)
+            Writer.Write(Block.PBits[e], 1);
+    }
+    for (Uint32 i = 0; i < 16; ++i)
+        Writer.Write(Block.Indices[i], i == Anchors[0] || i == Anchors[1] ? Mode.IndexBits - 1 : Mode.IndexBits);
+    Writer.Store(pDst);
+}
+
+void WriteBC7Mode6Block(BC7Mode6Block& Block, Uint8* pDst)
+{
+    // The most significant bit of the first index is implicitly zero
+    if (Block.Indices[0] & 0x8)
+    {
+        for (Uint32 c = 0; c < 4; ++c)
+            std::swap(Block.Endpoints[0][c], Block.Endpoints[1][c]);
+        std::swap(Block.PBits[0], Block.PBits[1]);
+        for (auto& Idx : Block.Indices)
+            Idx = static_cast<Uint8>(15 - Idx);
+    }
+
+    BC7BitWriter Writer;
+    Writer.Write(1u << 6, 7); // Mode 6
+    for (Uint32 c = 0; c < 4; ++c)
+    {
+        Writer.Write(Block.Endpoints[0][c], 7);
+        Writer.Write(Block.Endpoints[1][c], 7);
+    }
+    Writer.Write(Block.PBits[0], 1);
+    Writer.Write(Block.PBits[1], 1);
+    Writer.Write(Block.Indices[0], 3);
+    for (Uint32 i = 1; i < 16; ++i)
+        Writer.Write(Block.Indices[i], 4);
+    Writer.Store(pDst);
+}
+
+bool IsOpaque(const BlockTexels& Block)
+{
+    for (Uint32 i = 0; i < 16; ++i)
+    {
+        if (Block.Ch[3][i] != 255.f)
+            return false;
+    }
+    return true;
+}
+
+void EncodeBC7(const BlockTexels& Block, BC_ENCODE_QUALITY Quality, Uint8* pDst)
+{
+    BC7Mode6Block Best;
+
+    float E0[4], E1[4];
+    FitPrincipalAxis(Block, 0, 4, AllTexelsMask, E0, E1);
+    EvaluateBC7Mode6(Block, E0, E1, SelectBC7PBit(E0), SelectBC7PBit(E1), Best);
+
+    if (Quality != BC_ENCODE_QUALITY_FAST)
+    {
+        float BestE0[4], BestE1[4];
+        std::copy_n(E0, 4, BestE0);
+        std::copy_n(E1, 4, BestE1);
+        for (int Iter = 0; Iter < NumRefineIterations; ++Iter)
+        {
+            float Weights[16];
+            for (Uint32 i = 0; i < 16; ++i)
+                Weights[i] = static_cast<float>(BC7Weights4[Best.Indices[i]]) / 64.f;
+
+            if (!RefineEndpoints(Block, 0, 4, AllTexelsMask, Weights, E0, E1) ||
+                !EvaluateBC7Mode6(Block, E0, E1, SelectBC7PBit(E0), SelectBC7PBit(E1), Best))
+                break;
+            std::copy_n(E0, 4, BestE0);
+            std::copy_n(E1, 4, BestE1);
+        }
+
+        // The P-bits that minimize the quantization errors of the endpoints
+        // are not necessarily the best for the block, so try the others
+        const Uint32 SelectedPBits = SelectBC7PBit(BestE0) | (SelectBC7PBit(BestE1) << 1u);
+        for (Uint32 PBits = 0; PBits < 4; ++PBits)
+        {
+            if (PBits != SelectedPBits)
+                EvaluateBC7Mode6(Block, BestE0, BestE1, PBits & 1u, PBits >> 1u, Best);
+        }
+
+        // Opaque blocks may be better encoded with two subsets, where the color is not spread along one line
+        if (IsOpaque(Block) && Best.Error > 0)
+        {
+            BC7TwoSubsetBlock BestTwoSubsets;
+            BestTwoSubsets.Error = Best.Error;
+            SearchBC7Partitions(Block, BestTwoSubsets);
+            if (BestTwoSubsets.pMode != nullptr)
+            {
+                WriteBC7TwoSubsetBlock(BestTwoSubsets, pDst);
+                return;
+            }
+        }
+    }
+
+    WriteBC7Mode6Block(Best, pDst);
+}
+
+} // namespace
+
+
+bool IsBCEncodingSupported(TEXTURE_FORMAT Format)
+{
+    switch (Format)
+    {
+        case TEX_FORMAT_BC1_UNORM:
+        case TEX_FORMAT_BC1_UNORM_SRGB:
+        case TEX_FORMAT_BC3_UNORM:
+        case TEX_FORMAT_BC3_UNORM_SRGB:
+        case TEX_FORMAT_BC4_UNORM:
+        case TEX_FORMAT_BC5_UNORM:
+        case TEX_FORMAT_BC7_UNORM:
+        case TEX_FORMAT_BC7_UNORM_SRGB:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+bool EncodeBC(const BCEncodeAttribs& Attribs)
+{
+    if (!IsBCEncodingSupported(Attribs.Format))
+    {
+        LOG_ERROR_MESSAGE("Encoding to ", GetTextureFormatAttribs(Attribs.Format).Name, " is not supported");
+        return false;
+    }
+
+    if (Attribs.Width == 0 || Attribs.Height == 0)
+        return true;
+
+    if (Attribs.pSrcData == nullptr || Attribs.pDstData == nullptr)
+    {
+        LOG_ERROR_MESSAGE("Source and destination data must not be null");
+        return false;
+    }
+
+    const auto& FmtAttribs = GetTextureFormatAttribs(Attribs.Format);
+    VERIFY_EXPR(FmtAttribs.BlockWidth == 4 && FmtAttribs.BlockHeight == 4);
+
+    const Uint32 BlockSize  = FmtAttribs.ComponentSize; // For compressed formats, this is the block size in bytes
+    const Uint32 NumBlocksX = (Attribs.Width + 3) / 4;
+    const Uint32 NumBlocksY = (Attribs.Height + 3) / 4;
+    const auto   SrcRowSize = Uint64{Attribs.Width} * 4;
+    const auto   DstRowSize = Uint64{NumBlocksX} * BlockSize;
+    const auto   SrcStride  = Attribs.SrcStride != 0 ? Attribs.SrcStride : SrcRowSize;
+    const auto   DstStride  = Attribs.DstStride != 0 ? Attribs.DstStride : DstRowSize;
+    if (SrcStride < SrcRowSize || DstStride < DstRowSize)
+    {
+        LOG_ERROR_MESSAGE("Row stride (", SrcStride, " source, ", DstStride, " destination) is smaller than the row size (",
+                          SrcRowSize, " source, ", DstRowSize, " destination)");
+        return false;
+    }
+
+    const auto* const pSrcData = static_cast<const Uint8*>(Attribs.pSrcData);
+    auto* const       pDstData = static_cast<Uint8*>(Attribs.pDstData);
+
+    ParallelForRanges(NumBlocksY, Attribs.NumThreads, [&](Uint32 StartRow, Uint32 EndRow) {
+        BlockTexels Block;
+        for (Uint32 by = StartRow; by < EndRow; ++by)
+        {
+            Uint8* pDstRow = pDstData + by * DstStride;
+            for (Uint32 bx = 0; bx < NumBlocksX; ++bx)
+            {
+                LoadBlock(pSrcData, static_cast<size_t>(SrcStride), bx * 4, by * 4, Attribs.Width, Attribs.Height, Block);
+
+                Uint8* pDst = pDstRow + bx * BlockSize;
+                switch (Attribs.Format)
+                {
+                    case TEX_FORMAT_BC1_UNORM:
+                    case TEX_FORMAT_BC1_UNORM_SRGB:
+                        EncodeBC1Color(Block, Attribs.Quality, false, pDst);
+                        break;
+
+                    case TEX_FORMAT_BC3_UNORM:
+                    case TEX_FORMAT_BC3_UNORM_SRGB:
+                        EncodeBC4(Block, 3, Attribs.Quality, pDst);
+                        EncodeBC1Color(Block, Attribs.Quality, true, pDst + 8);
+                        break;
+
+                    case TEX_FORMAT_BC4_UNORM:
+                        EncodeBC4(Block, 0, Attribs.Quality, pDst);
+                        break;
+
+                    case TEX_FORMAT_BC5_UNORM:
+                        EncodeBC4(Block, 0, Attribs.Quality, pDst);
+                        EncodeBC4(Block, 1, Attribs.Quality, pDst + 8);
+                        break;
+
+                    case TEX_FORMAT_BC7_UNORM:
+                    case TEX_FORMAT_BC7_UNORM_SRGB:
+                        EncodeBC7(Block, Attribs.Quality, pDst);
+                        break;
+
+                    default:
+                        UNEXPECTED("Unexpected format");
+                }
+            }
+        }
+    });
+
+    return true;
+}
+
+bool EncodeBCToUploadBuffer(IUploadBuffer*    pUploadBuffer,
+                            Uint32            Mip,
+                            Uint32            Slice,
+                            const void*       pSrcData,
+                            Uint64            SrcStride,
+                            BC_ENCODE_QUALITY Quality,
+                            Uint32            NumThreads)
+{
+    DEV_CHECK_ERR(pUploadBuffer != nullptr, "Upload buffer must not be null");
+
+    const auto& Desc = pUploadBuffer->GetDesc();
+    DEV_CHECK_ERR(Mip < Desc.MipLevels && Slice < Desc.ArraySize, "Subresource (", Mip, ", ", Slice, ") is out of range");
+
+    const auto MappedData = pUploadBuffer->GetMappedData(Mip, Slice);
+    if (MappedData.pData == nullptr)
+    {
+        LOG_ERROR_MESSAGE("Upload buffer subresource (", Mip, ", ", Slice, ") is not mapped");
+        return false;
+    }
+
+    BCEncodeAttribs Attribs;
+    Attribs.Format     = Desc.Format;
+    Attribs.Width      = std::max(Desc.Width >> Mip, 1u);
+    Attribs.Height     = std::max(Desc.Height >> Mip, 1u);
+    Attribs.pSrcData   = pSrcData;
+    Attribs.SrcStride  = SrcStride;
+    Attribs.pDstData   = MappedData.pData;
+    Attribs.DstStride  = MappedData.Stride;
+    Attribs.Quality    = Quality;
+    Attribs.NumThreads = NumThreads;
+    return EncodeBC(Attribs);
+}
+
+} // namespace Diligent
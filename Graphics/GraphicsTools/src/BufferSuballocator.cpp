@@ -28,12 +28,18 @@
 #include "BufferSuballocator.h"
 
 #include <mutex>
+#include <memory>
+#include <atomic>
+#include <vector>
+#include <string>
+#include <algorithm>
 
 #include "DebugUtilities.hpp"
 #include "ObjectBase.hpp"
 #include "RefCntAutoPtr.hpp"
 #include "DynamicBuffer.hpp"
 #include "VariableSizeAllocationsManager.hpp"
+#include "TLSFAllocationsManager.hpp"
 #include "Align.hpp"
 #include "DefaultRawMemoryAllocator.hpp"
 #include "FixedBlockMemoryAllocator.hpp"
@@ -43,6 +49,68 @@ namespace Diligent
 
 class BufferSuballocatorImpl;
 
+// Forwards calls to either VariableSizeAllocationsManager or TLSFAllocationsManager
+class SuballocationsManager
+{
+public:
+    using OffsetType = VariableSizeAllocationsManager::OffsetType;
+    using Allocation = VariableSizeAllocationsManager::Allocation;
+
+    SuballocationsManager(OffsetType MaxSize, bool UseTLSF)
+    {
+        auto& Allocator = DefaultRawMemoryAllocator::GetAllocator();
+        if (UseTLSF)
+            m_TLSFMgr.reset(new TLSFAllocationsManager{MaxSize, Allocator});
+        else
+            m_ListMgr.reset(new VariableSizeAllocationsManager{MaxSize, Allocator});
+    }
+
+    Allocation Allocate(OffsetType Size, OffsetType Alignment)
+    {
+        return m_TLSFMgr ? m_TLSFMgr->Allocate(Size, Alignment) : m_ListMgr->Allocate(Size, Alignment);
+    }
+
+    Allocation AllocateFirstFit(OffsetType Size, OffsetType Alignment, OffsetType EndOffset)
+    {
+        return m_TLSFMgr ? m_TLSFMgr->AllocateFirstFit(Size, Alignment, EndOffset) : m_ListMgr->AllocateFirstFit(Size, Alignment, EndOffset);
+    }
+
+    void Free(Allocation&& allocation)
+    {
+        if (m_TLSFMgr)
+            m_TLSFMgr->Free(std::move(allocation));
+        else
+            m_ListMgr->Free(std::move(allocation));
+    }
+
+    void Extend(size_t ExtraSize)
+    {
+        if (m_TLSFMgr)
+            m_TLSFMgr->Extend(ExtraSize);
+        else
+            m_ListMgr->Extend(ExtraSize);
+    }
+
+    OffsetType GetMaxSize() const
+    {
+        return m_TLSFMgr ? m_TLSFMgr->GetMaxSize() : m_ListMgr->GetMaxSize();
+    }
+
+    OffsetType GetFreeSize() const
+    {
+        return m_TLSFMgr ? m_TLSFMgr->GetFreeSize() : m_ListMgr->GetFreeSize();
+    }
+
+    OffsetType GetLargestFreeBlockSize() const
+    {
+        return m_TLSFMgr ? m_TLSFMgr->GetLargestFreeBlockSize() : m_ListMgr->GetLargestFreeBlockSize();
+    }
+
+private:
+    std::unique_ptr<VariableSizeAllocationsManager> m_ListMgr;
+    std::unique_ptr<TLSFAllocationsManager>         m_TLSFMgr;
+};
+
 class BufferSuballocationImpl final : public ObjectBase<IBufferSuballocation>
 {
 public:
@@ -51,13 +119,15 @@ public:
                             BufferSuballocatorImpl*                      pParentAllocator,
                             Uint32                                       Offset,
                             Uint32                                       Size,
+                            Uint32                                       Alignment,
                             VariableSizeAllocationsManager::Allocation&& Subregion) :
         // clang-format off
         TBase             {pRefCounters},
         m_pParentAllocator{pParentAllocator},
         m_Subregion       {std::move(Subregion)},
         m_Offset          {Offset},
-        m_Size            {Size}
+        m_Size            {Size},
+        m_Alignment       {Alignment}
     // clang-format on
     {
         VERIFY_EXPR(m_pParentAllocator);
@@ -82,7 +152,7 @@ public:
 
     virtual Uint32 GetOffset() const override final
     {
-        return m_Offset;
+        return m_Offset.load();
     }
 
     virtual Uint32 GetSize() const override final
@@ -103,12 +173,21 @@ public:
     }
 
 private:
+    friend BufferSuballocatorImpl;
+
     RefCntAutoPtr<BufferSuballocatorImpl> m_pParentAllocator;
 
+    // The subregion, the offset and the list links are protected by the parent allocator mutex.
+    // The offset may be read without the lock.
     VariableSizeAllocationsManager::Allocation m_Subregion;
 
-    const Uint32 m_Offset;
-    const Uint32 m_Size;
+    std::atomic<Uint32> m_Offset;
+    const Uint32        m_Size;
+    const Uint32        m_Alignment;
+
+    // Links in the list of all suballocations of the parent
+    BufferSuballocationImpl* m_pPrev = nullptr;
+    BufferSuballocationImpl* m_pNext = nullptr;
 
     RefCntAutoPtr<IObject> m_pUserData;
 };
@@ -125,9 +204,10 @@ public:
                            const BufferSuballocatorCreateInfo& CreateInfo) :
         // clang-format off
         TBase                    {pRefCounters},
-        m_Mgr                    {CreateInfo.Desc.uiSizeInBytes, DefaultRawMemoryAllocator::GetAllocator()},
+        m_Mgr                    {CreateInfo.Desc.uiSizeInBytes, CreateInfo.UseTLSF},
         m_Buffer                 {pDevice, CreateInfo.Desc},
         m_ExpansionSize          {CreateInfo.ExpansionSize},
+        m_MaxScratchSize         {CreateInfo.MaxDefragmentationScratchSize},
         m_SuballocationsAllocator
         {
             DefaultRawMemoryAllocator::GetAllocator(),
@@ -168,22 +248,20 @@ public:
             return;
         }
 
-        VariableSizeAllocationsManager::Allocation Subregion;
-        {
-            std::lock_guard<std::mutex> Lock{m_MgrMtx};
-            Subregion = m_Mgr.Allocate(Size, Alignment);
+        std::lock_guard<std::mutex> Lock{m_MgrMtx};
 
-            while (!Subregion.IsValid())
-            {
-                auto ExtraSize = m_ExpansionSize != 0 ?
-                    std::max(m_ExpansionSize, AlignUp(Size, Alignment)) :
-                    m_Mgr.GetMaxSize();
+        auto Subregion = m_Mgr.Allocate(Size, Alignment);
+        while (!Subregion.IsValid())
+        {
+            auto ExtraSize = m_ExpansionSize != 0 ?
+                std::max(m_ExpansionSize, AlignUp(Size, Alignment)) :
+                m_Mgr.GetMaxSize();
 
-                m_Mgr.Extend(ExtraSize);
-                Subregion = m_Mgr.Allocate(Size, Alignment);
-            }
+            m_Mgr.Extend(ExtraSize);
+            Subregion = m_Mgr.Allocate(Size, Alignment);
         }
 
+        // The object is created under the lock so that Defragment() never misses it
         // clang-format off
         BufferSuballocationImpl* pSuballocation{
             NEW_RC_OBJ(m_SuballocationsAllocator, "BufferSuballocationImpl instance", BufferSuballocationImpl)
@@ -191,23 +269,45 @@ public:
                 this, 
                 AlignUp(static_cast<Uint32>(Subregion.UnalignedOffset), Alignment),
                 Size,
+                Alignment,
                 std::move(Subregion)
             )
         };
         // clang-format on
 
+        pSuballocation->m_pNext = m_pSuballocations;
+        if (m_pSuballocations != nullptr)
+            m_pSuballocations->m_pPrev = pSuballocation;
+        m_pSuballocations = pSuballocation;
+
         pSuballocation->QueryInterface(IID_BufferSuballocation, reinterpret_cast<IObject**>(ppSuballocation));
     }
 
-    void Free(VariableSizeAllocationsManager::Allocation&& Subregion)
+    void Free(BufferSuballocationImpl& Suballocation)
     {
         std::lock_guard<std::mutex> Lock{m_MgrMtx};
-        m_Mgr.Free(std::move(Subregion));
+
+        if (Suballocation.m_pPrev != nullptr)
+            Suballocation.m_pPrev->m_pNext = Suballocation.m_pNext;
+        else
+        {
+            VERIFY_EXPR(m_pSuballocations == &Suballocation);
+            m_pSuballocations = Suballocation.m_pNext;
+        }
+        if (Suballocation.m_pNext != nullptr)
+            Suballocation.m_pNext->m_pPrev = Suballocation.m_pPrev;
+
+        // While the copies recorded by Defragment() are in flight, the region may be the
+        // destination of a copy, so it is released when the copies have been recorded.
+        if (m_DefragmentationInProgress)
+            m_DeferredFrees.emplace_back(std::move(Suballocation.m_Subregion));
+        else
+            m_Mgr.Free(std::move(Suballocation.m_Subregion));
     }
 
     virtual Uint32 GetVersion() const override final
     {
-        return m_Buffer.GetVersion();
+        return m_Buffer.GetVersion() + m_DefragmentationCount.load();
     }
 
     virtual Uint32 GetFreeSize() override final
@@ -216,21 +316,228 @@ public:
         return static_cast<Uint32>(m_Mgr.GetFreeSize());
     }
 
+    virtual Uint32 GetLargestFreeRegionSize() override final
+    {
+        std::lock_guard<std::mutex> Lock{m_MgrMtx};
+        return static_cast<Uint32>(m_Mgr.GetLargestFreeBlockSize());
+    }
+
+    virtual Uint32 Defragment(IRenderDevice*  pDevice,
+                              IDeviceContext* pContext,
+                              Uint32          MaxBytesToMove) override final
+    {
+        DEV_CHECK_ERR(pContext != nullptr, "Device context must not be null");
+
+        auto* pBuffer = GetBuffer(pDevice, pContext);
+        if (pBuffer == nullptr)
+            return 0;
+
+        // Scratch buffer offsets are aligned to keep the copies efficient
+        static constexpr Uint32 ScratchAlignment = 16;
+
+        // The moves are performed in batches that reuse the scratch buffer, so that its size does
+        // not depend on the amount of live data. Larger suballocations are moved one at a time.
+        Uint32 ScratchCapacity = 0;
+        {
+            std::lock_guard<std::mutex> Lock{m_MgrMtx};
+            if (m_Mgr.GetFreeSize() == 0)
+                return 0;
+
+            Uint32 TotalSize   = 0;
+            Uint32 LargestSize = 0;
+            bool   CanMove     = false;
+            for (const auto* pSuballoc = m_pSuballocations; pSuballoc != nullptr; pSuballoc = pSuballoc->m_pNext)
+            {
+                const auto AlignedSize = AlignUp(pSuballoc->m_Size, ScratchAlignment);
+                TotalSize += AlignedSize;
+                LargestSize = std::max(LargestSize, AlignedSize);
+
+                if (!CanMove && (MaxBytesToMove == 0 || pSuballoc->m_Size <= MaxBytesToMove))
+                {
+                    // Do not create the scratch buffer if no suballocation can be moved
+                    auto Subregion = m_Mgr.AllocateFirstFit(pSuballoc->m_Size, pSuballoc->m_Alignment, pSuballoc->m_Subregion.UnalignedOffset);
+                    if (Subregion.IsValid())
+                    {
+                        m_Mgr.Free(std::move(Subregion));
+                        CanMove = true;
+                    }
+                }
+            }
+            if (!CanMove)
+                return 0;
+
+            if (MaxBytesToMove != 0)
+                TotalSize = std::min(TotalSize, AlignUp(MaxBytesToMove, ScratchAlignment));
+
+            ScratchCapacity = std::min(TotalSize, std::max(m_MaxScratchSize, LargestSize));
+        }
+
+        // The scratch buffer is created without holding the lock and is released when the method returns.
+        // The engine keeps it alive until the GPU is done with it.
+        auto pScratchBuffer = CreateScratchBuffer(pDevice, ScratchCapacity);
+        if (!pScratchBuffer)
+            return 0;
+
+        struct MoveInfo
+        {
+            Uint32 SrcOffset;
+            Uint32 DstOffset;
+            Uint32 ScratchOffset;
+            Uint32 Size;
+        };
+        std::vector<MoveInfo> Moves;
+        // Index of the first move of every batch
+        std::vector<size_t> Batches;
+
+        Uint32 BytesToMove = 0;
+        {
+            // The moves are planned under the lock, and the copies are recorded without it
+            std::lock_guard<std::mutex> Lock{m_MgrMtx};
+
+            if (m_Mgr.GetMaxSize() != pBuffer->GetDesc().uiSizeInBytes)
+            {
+                // The buffer has been expanded by another thread
+                return 0;
+            }
+
+            VERIFY(!m_DefragmentationInProgress, "Defragment() must not be called by multiple threads simultaneously");
+            m_DefragmentationInProgress = true;
+
+            std::vector<BufferSuballocationImpl*> Suballocations;
+            for (auto* pSuballoc = m_pSuballocations; pSuballoc != nullptr; pSuballoc = pSuballoc->m_pNext)
+                Suballocations.push_back(pSuballoc);
+
+            // Start from the end of the buffer, where the moves release the most space
+            std::sort(Suballocations.begin(), Suballocations.end(),
+                      [](const BufferSuballocationImpl* lhs, const BufferSuballocationImpl* rhs) {
+                          return lhs->m_Subregion.UnalignedOffset > rhs->m_Subregion.UnalignedOffset;
+                      });
+
+            Uint32 ScratchSize = 0;
+            for (auto* pSuballoc : Suballocations)
+            {
+                const auto Size        = pSuballoc->m_Size;
+                const auto AlignedSize = AlignUp(Size, ScratchAlignment);
+                if (MaxBytesToMove != 0 && BytesToMove + Size > MaxBytesToMove)
+                    continue;
+                if (AlignedSize > ScratchCapacity)
+                    continue;
+
+                // The new region must lie entirely before the current one so that every
+                // move makes progress and source and destination never overlap.
+                auto NewSubregion = m_Mgr.AllocateFirstFit(Size, pSuballoc->m_Alignment, pSuballoc->m_Subregion.UnalignedOffset);
+                if (!NewSubregion.IsValid())
+                    continue;
+
+                if (Batches.empty() || ScratchSize + AlignedSize > ScratchCapacity)
+                {
+                    Batches.push_back(Moves.size());
+                    ScratchSize = 0;
+                }
+
+                const auto SrcOffset = pSuballoc->m_Offset.load();
+                const auto DstOffset = AlignUp(static_cast<Uint32>(NewSubregion.UnalignedOffset), pSuballoc->m_Alignment);
+                VERIFY_EXPR(DstOffset + Size <= SrcOffset);
+
+                // The source region is released after the copies have been recorded, so that
+                // it can't be reused by the allocations made in the meantime.
+                m_DeferredFrees.emplace_back(std::move(pSuballoc->m_Subregion));
+                pSuballoc->m_Subregion = std::move(NewSubregion);
+                pSuballoc->m_Offset.store(DstOffset);
+
+                Moves.push_back({SrcOffset, DstOffset, ScratchSize, Size});
+                ScratchSize += AlignedSize;
+                BytesToMove += Size;
+            }
+        }
+
+        // Every batch copies all its data to the scratch buffer first, and then to the new locations.
+        // This way, only two state transitions are required for each buffer. The next batch may
+        // overwrite the scratch data of this one, but its copies are recorded later.
+        for (size_t b = 0; b < Batches.size(); ++b)
+        {
+            const auto FirstMove = Batches[b];
+            const auto EndMove   = b + 1 < Batches.size() ? Batches[b + 1] : Moves.size();
+            for (auto m = FirstMove; m < EndMove; ++m)
+            {
+                const auto& Move = Moves[m];
+                pContext->CopyBuffer(pBuffer, Move.SrcOffset, RESOURCE_STATE_TRANSITION_MODE_TRANSITION,
+                                     pScratchBuffer, Move.ScratchOffset, Move.Size, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+            }
+            for (auto m = FirstMove; m < EndMove; ++m)
+            {
+                const auto& Move = Moves[m];
+                pContext->CopyBuffer(pScratchBuffer, Move.ScratchOffset, RESOURCE_STATE_TRANSITION_MODE_TRANSITION,
+                                     pBuffer, Move.DstOffset, Move.Size, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> Lock{m_MgrMtx};
+            for (auto& Subregion : m_DeferredFrees)
+                m_Mgr.Free(std::move(Subregion));
+            m_DeferredFrees.clear();
+            m_DefragmentationInProgress = false;
+        }
+
+        if (BytesToMove == 0)
+            return 0;
+
+        m_DefragmentationCount.fetch_add(1);
+
+        return BytesToMove;
+    }
+
 private:
-    std::mutex                     m_MgrMtx;
-    VariableSizeAllocationsManager m_Mgr;
+    RefCntAutoPtr<IBuffer> CreateScratchBuffer(IRenderDevice* pDevice, Uint32 Size)
+    {
+        if (pDevice == nullptr)
+        {
+            UNEXPECTED("Render device must not be null when the scratch buffer needs to be created");
+            return {};
+        }
+
+        std::string Name = m_Buffer.GetDesc().Name != nullptr ? m_Buffer.GetDesc().Name : "Buffer suballocator";
+        Name += " - defragmentation scratch buffer";
+
+        BufferDesc ScratchDesc;
+        ScratchDesc.Name          = Name.c_str();
+        ScratchDesc.uiSizeInBytes = Size;
+        ScratchDesc.Usage         = USAGE_DEFAULT;
+        ScratchDesc.BindFlags     = BIND_NONE;
+
+        RefCntAutoPtr<IBuffer> pScratchBuffer;
+        pDevice->CreateBuffer(ScratchDesc, nullptr, &pScratchBuffer);
+        if (!pScratchBuffer)
+            LOG_ERROR_MESSAGE("Failed to create the defragmentation scratch buffer");
+
+        return pScratchBuffer;
+    }
+
+    std::mutex            m_MgrMtx;
+    SuballocationsManager m_Mgr;
 
     DynamicBuffer m_Buffer;
 
     const Uint32 m_ExpansionSize;
+    const Uint32 m_MaxScratchSize;
 
     FixedBlockMemoryAllocator m_SuballocationsAllocator;
+
+    // List of all live suballocations, protected by m_MgrMtx
+    BufferSuballocationImpl* m_pSuballocations = nullptr;
+
+    // Regions that are released when Defragment() has recorded the copies, protected by m_MgrMtx
+    std::vector<SuballocationsManager::Allocation> m_DeferredFrees;
+    bool                                           m_DefragmentationInProgress = false;
+
+    std::atomic<Uint32> m_DefragmentationCount{0};
 };
 
 
 BufferSuballocationImpl::~BufferSuballocationImpl()
 {
-    m_pParentAllocator->Free(std::move(m_Subregion));
+    m_pParentAllocator->Free(*this);
 }
 
 IBufferSuballocator* BufferSuballocationImpl::GetAllocator()
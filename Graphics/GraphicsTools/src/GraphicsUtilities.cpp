@@ -26,16 +26,29 @@
  */
 
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstring>
+#include <functional>
 #include <limits>
+#include <vector>
 
 #include "GraphicsUtilities.h"
 #include "DebugUtilities.hpp"
 #include "GraphicsAccessories.hpp"
 #include "ColorConversion.h"
+#include "ThreadPool.hpp"
 
 #define PI_F 3.1415926f
 
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define DILIGENT_MIP_SSE2 1
+#    include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#    define DILIGENT_MIP_NEON 1
+#    include <arm_neon.h>
+#endif
+
 namespace Diligent
 {
 
@@ -133,205 +146,1051 @@ void GenerateCheckerBoardPattern(Uint32 Width, Uint32 Height, TEXTURE_FORMAT Fmt
 
 
 
-template <typename ChannelType>
-ChannelType SRGBAverage(ChannelType c0, ChannelType c1, ChannelType c2, ChannelType c3)
+namespace
 {
-    static_assert(std::numeric_limits<ChannelType>::is_integer && !std::numeric_limits<ChannelType>::is_signed, "Unsigned integers are expected");
 
-    static constexpr float MaxVal    = static_cast<float>(std::numeric_limits<ChannelType>::max());
-    static constexpr float MaxValInv = 1.f / MaxVal;
+// Values of FastSRGBToLinear() for every 8-bit channel value
+class FastSRGBToLinearTable
+{
+public:
+    FastSRGBToLinearTable() noexcept
+    {
+        for (Uint32 i = 0; i < m_Table.size(); ++i)
+            m_Table[i] = FastSRGBToLinear(static_cast<float>(i) * (1.f / 255.f));
+    }
 
-    float fc0 = static_cast<float>(c0) * MaxValInv;
-    float fc1 = static_cast<float>(c1) * MaxValInv;
-    float fc2 = static_cast<float>(c2) * MaxValInv;
-    float fc3 = static_cast<float>(c3) * MaxValInv;
+    float operator[](Uint8 x) const
+    {
+        return m_Table[x];
+    }
 
-    float fLinearAverage = (FastSRGBToLinear(fc0) + FastSRGBToLinear(fc1) + FastSRGBToLinear(fc2) + FastSRGBToLinear(fc3)) * 0.25f;
-    float fSRGBAverage   = FastLinearToSRGB(fLinearAverage) * MaxVal;
+    static const FastSRGBToLinearTable& Get()
+    {
+        static const FastSRGBToLinearTable Table;
+        return Table;
+    }
 
-    // Clamping on both ends is essential because fast SRGB math is imprecise
-    fSRGBAverage = std::max(fSRGBAverage, 0.f);
-    fSRGBAverage = std::min(fSRGBAverage, MaxVal);
+private:
+    std::array<float, 256> m_Table;
+};
 
-    return static_cast<ChannelType>(fSRGBAverage);
-}
+struct SRGBAverage
+{
+    Uint8 operator()(Uint8 c0, Uint8 c1, Uint8 c2, Uint8 c3) const
+    {
+        static constexpr float MaxVal = 255.f;
+
+        // The table contains exactly the same values as FastSRGBToLinear(c * (1/255.f))
+        const auto& ToLinear = FastSRGBToLinearTable::Get();
+
+        float fLinearAverage = (ToLinear[c0] + ToLinear[c1] + ToLinear[c2] + ToLinear[c3]) * 0.25f;
+        float fSRGBAverage   = FastLinearToSRGB(fLinearAverage) * MaxVal;
+
+        // Clamping on both ends is essential because fast SRGB math is imprecise
+        fSRGBAverage = std::max(fSRGBAverage, 0.f);
+        fSRGBAverage = std::min(fSRGBAverage, MaxVal);
+
+        return static_cast<Uint8>(fSRGBAverage);
+    }
+};
 
 template <typename ChannelType>
-ChannelType LinearAverage(ChannelType c0, ChannelType c1, ChannelType c2, ChannelType c3);
+struct LinearAverage;
 
 template <>
-Uint8 LinearAverage<Uint8>(Uint8 c0, Uint8 c1, Uint8 c2, Uint8 c3)
+struct LinearAverage<Uint8>
 {
-    return static_cast<Uint8>((static_cast<Uint32>(c0) + static_cast<Uint32>(c1) + static_cast<Uint32>(c2) + static_cast<Uint32>(c3)) >> 2);
-}
+    Uint8 operator()(Uint8 c0, Uint8 c1, Uint8 c2, Uint8 c3) const
+    {
+        return static_cast<Uint8>((static_cast<Uint32>(c0) + static_cast<Uint32>(c1) + static_cast<Uint32>(c2) + static_cast<Uint32>(c3)) >> 2);
+    }
+};
 
 template <>
-Uint16 LinearAverage<Uint16>(Uint16 c0, Uint16 c1, Uint16 c2, Uint16 c3)
+struct LinearAverage<Uint16>
 {
-    return static_cast<Uint16>((static_cast<Uint32>(c0) + static_cast<Uint32>(c1) + static_cast<Uint32>(c2) + static_cast<Uint32>(c3)) >> 2);
-}
+    Uint16 operator()(Uint16 c0, Uint16 c1, Uint16 c2, Uint16 c3) const
+    {
+        return static_cast<Uint16>((static_cast<Uint32>(c0) + static_cast<Uint32>(c1) + static_cast<Uint32>(c2) + static_cast<Uint32>(c3)) >> 2);
+    }
+};
 
 template <>
-Uint32 LinearAverage<Uint32>(Uint32 c0, Uint32 c1, Uint32 c2, Uint32 c3)
+struct LinearAverage<Uint32>
 {
-    return (c0 + c1 + c2 + c3) >> 2;
-}
+    Uint32 operator()(Uint32 c0, Uint32 c1, Uint32 c2, Uint32 c3) const
+    {
+        return (c0 + c1 + c2 + c3) >> 2;
+    }
+};
 
 template <>
-Int8 LinearAverage<Int8>(Int8 c0, Int8 c1, Int8 c2, Int8 c3)
+struct LinearAverage<Int8>
 {
-    return static_cast<Int8>((static_cast<Int32>(c0) + static_cast<Int32>(c1) + static_cast<Int32>(c2) + static_cast<Int32>(c3)) / 4);
-}
+    Int8 operator()(Int8 c0, Int8 c1, Int8 c2, Int8 c3) const
+    {
+        return static_cast<Int8>((static_cast<Int32>(c0) + static_cast<Int32>(c1) + static_cast<Int32>(c2) + static_cast<Int32>(c3)) / 4);
+    }
+};
 
 template <>
-Int16 LinearAverage<Int16>(Int16 c0, Int16 c1, Int16 c2, Int16 c3)
+struct LinearAverage<Int16>
 {
-    return static_cast<Int16>((static_cast<Int32>(c0) + static_cast<Int32>(c1) + static_cast<Int32>(c2) + static_cast<Int32>(c3)) / 4);
-}
+    Int16 operator()(Int16 c0, Int16 c1, Int16 c2, Int16 c3) const
+    {
+        return static_cast<Int16>((static_cast<Int32>(c0) + static_cast<Int32>(c1) + static_cast<Int32>(c2) + static_cast<Int32>(c3)) / 4);
+    }
+};
 
 template <>
-Int32 LinearAverage<Int32>(Int32 c0, Int32 c1, Int32 c2, Int32 c3)
+struct LinearAverage<Int32>
 {
-    return (c0 + c1 + c2 + c3) / 4;
-}
+    Int32 operator()(Int32 c0, Int32 c1, Int32 c2, Int32 c3) const
+    {
+        return (c0 + c1 + c2 + c3) / 4;
+    }
+};
 
 template <>
-float LinearAverage<float>(float c0, float c1, float c2, float c3)
+struct LinearAverage<Float32>
 {
-    return (c0 + c1 + c2 + c3) * 0.25f;
-}
+    Float32 operator()(Float32 c0, Float32 c1, Float32 c2, Float32 c3) const
+    {
+        return (c0 + c1 + c2 + c3) * 0.25f;
+    }
+};
 
-struct ComputeCoarseMipHelper
+
+// Computes texels [StartCol, EndCol) of one row of the coarse mip level
+// from two rows of the fine level.
+using BoxFilterRowFuncType = void (*)(const void* pFineRow0,
+                                      const void* pFineRow1,
+                                      void*       pCoarseRow,
+                                      Uint32      StartCol,
+                                      Uint32      EndCol,
+                                      Uint32      FineWidth,
+                                      Uint32      NumChannels);
+
+template <typename ChannelType, typename AverageFuncType, Uint32 StaticNumChannels>
+void BoxFilterRow(const void* pFineRow0,
+                  const void* pFineRow1,
+                  void*       pCoarseRow,
+                  Uint32      StartCol,
+                  Uint32      EndCol,
+                  Uint32      FineWidth,
+                  Uint32      DynamicNumChannels)
 {
-    const Uint32 FineMipWidth;
-    const Uint32 FineMipHeight;
+    const Uint32 NumChannels = StaticNumChannels != 0 ? StaticNumChannels : DynamicNumChannels;
 
-    const void* const pFineMip;
-    const Uint32      FineMipStride;
+    const auto* pSrcRow0 = static_cast<const ChannelType*>(pFineRow0);
+    const auto* pSrcRow1 = static_cast<const ChannelType*>(pFineRow1);
+    auto*       pDstRow  = static_cast<ChannelType*>(pCoarseRow);
 
-    void* const  pCoarseMip;
-    const Uint32 CoarseMipStride;
+    const AverageFuncType ComputeAverage;
+    for (Uint32 col = StartCol; col < EndCol; ++col)
+    {
+        const auto src_col0 = col * 2;
+        const auto src_col1 = std::min(col * 2 + 1, FineWidth - 1);
+
+        for (Uint32 c = 0; c < NumChannels; ++c)
+        {
+            const auto Chnl00 = pSrcRow0[src_col0 * NumChannels + c];
+            const auto Chnl01 = pSrcRow0[src_col1 * NumChannels + c];
+            const auto Chnl10 = pSrcRow1[src_col0 * NumChannels + c];
+            const auto Chnl11 = pSrcRow1[src_col1 * NumChannels + c];
+
+            pDstRow[col * NumChannels + c] = ComputeAverage(Chnl00, Chnl01, Chnl10, Chnl11);
+        }
+    }
+}
 
-    const Uint32 NumChannels;
+// 8-bit RGBA linear average
+void BoxFilterRowRGBA8(const void* pFineRow0,
+                       const void* pFineRow1,
+                       void*       pCoarseRow,
+                       Uint32      StartCol,
+                       Uint32      EndCol,
+                       Uint32      FineWidth,
+                       Uint32      NumChannels)
+{
+    VERIFY_EXPR(NumChannels == 4);
 
-    template <typename ChannelType,
-              typename AverageFuncType>
-    void Run(AverageFuncType ComputeAverage) const
+    Uint32 col = StartCol;
+#if DILIGENT_MIP_SSE2 || DILIGENT_MIP_NEON
+    if (FineWidth > 1)
     {
-        VERIFY_EXPR(FineMipWidth > 0 && FineMipHeight > 0);
-        VERIFY(FineMipHeight == 1 || FineMipStride >= FineMipWidth * sizeof(ChannelType) * NumChannels, "Fine mip level stride is too small");
+        // Since the coarse width is FineWidth / 2, both source columns are always in range
+        const auto* pSrcRow0 = static_cast<const Uint8*>(pFineRow0);
+        const auto* pSrcRow1 = static_cast<const Uint8*>(pFineRow1);
+        auto*       pDstRow  = static_cast<Uint8*>(pCoarseRow);
+#    if DILIGENT_MIP_SSE2
+        const __m128i Zero = _mm_setzero_si128();
+        for (; col + 2 <= EndCol; col += 2)
+        {
+            // Four fine texels of each row -> two coarse texels
+            const __m128i Row0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrcRow0 + col * 8));
+            const __m128i Row1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrcRow1 + col * 8));
+
+            // Texels 0,1 and 2,3 of both rows as 16-bit values
+            const __m128i Lo = _mm_add_epi16(_mm_unpacklo_epi8(Row0, Zero), _mm_unpacklo_epi8(Row1, Zero));
+            const __m128i Hi = _mm_add_epi16(_mm_unpackhi_epi8(Row0, Zero), _mm_unpackhi_epi8(Row1, Zero));
+
+            // (t0 + t1, t2 + t3)
+            __m128i Sum = _mm_add_epi16(_mm_unpacklo_epi64(Lo, Hi), _mm_unpackhi_epi64(Lo, Hi));
+            Sum         = _mm_srli_epi16(Sum, 2);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(pDstRow + col * 4), _mm_packus_epi16(Sum, Sum));
+        }
+#    else
+        for (; col + 2 <= EndCol; col += 2)
+        {
+            const uint8x16_t Row0 = vld1q_u8(pSrcRow0 + col * 8);
+            const uint8x16_t Row1 = vld1q_u8(pSrcRow1 + col * 8);
+
+            const uint16x8_t Lo  = vaddl_u8(vget_low_u8(Row0), vget_low_u8(Row1));
+            const uint16x8_t Hi  = vaddl_u8(vget_high_u8(Row0), vget_high_u8(Row1));
+            const uint16x8_t Sum = vcombine_u16(vadd_u16(vget_low_u16(Lo), vget_high_u16(Lo)),
+                                                vadd_u16(vget_low_u16(Hi), vget_high_u16(Hi)));
+            vst1_u8(pDstRow + col * 4, vshrn_n_u16(Sum, 2));
+        }
+#    endif
+    }
+#endif
+    BoxFilterRow<Uint8, LinearAverage<Uint8>, 4>(pFineRow0, pFineRow1, pCoarseRow, col, EndCol, FineWidth, 4);
+}
 
-        const auto CoarseMipWidth  = std::max(FineMipWidth / Uint32{2}, Uint32{1});
-        const auto CoarseMipHeight = std::max(FineMipHeight / Uint32{2}, Uint32{1});
+// 8-bit sRGB RGBA average
+void BoxFilterRowSRGBA8(const void* pFineRow0,
+                        const void* pFineRow1,
+                        void*       pCoarseRow,
+                        Uint32      StartCol,
+                        Uint32      EndCol,
+                        Uint32      FineWidth,
+                        Uint32      NumChannels)
+{
+    VERIFY_EXPR(NumChannels == 4);
+
+    Uint32 col = StartCol;
+    // vsqrtq_f32 is only available on AArch64
+#if DILIGENT_MIP_SSE2 || (DILIGENT_MIP_NEON && (defined(__aarch64__) || defined(_M_ARM64)))
+    if (FineWidth > 1)
+    {
+        const auto& ToLinear = FastSRGBToLinearTable::Get();
 
-        VERIFY(CoarseMipHeight == 1 || CoarseMipStride >= CoarseMipWidth * sizeof(ChannelType) * NumChannels, "Coarse mip level stride is too small");
+        const auto* pSrcRow0 = static_cast<const Uint8*>(pFineRow0);
+        const auto* pSrcRow1 = static_cast<const Uint8*>(pFineRow1);
+        auto*       pDstRow  = static_cast<Uint8*>(pCoarseRow);
 
-        for (Uint32 row = 0; row < CoarseMipHeight; ++row)
+#    if DILIGENT_MIP_SSE2
+        const __m128 AbsMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        for (; col < EndCol; ++col)
         {
-            auto src_row0 = row * 2;
-            auto src_row1 = std::min(row * 2 + 1, FineMipHeight - 1);
+            const Uint8* pTexel00 = pSrcRow0 + col * 8;
+            const Uint8* pTexel10 = pSrcRow1 + col * 8;
 
-            auto pSrcRow0 = reinterpret_cast<const ChannelType*>(reinterpret_cast<const Uint8*>(pFineMip) + src_row0 * FineMipStride);
-            auto pSrcRow1 = reinterpret_cast<const ChannelType*>(reinterpret_cast<const Uint8*>(pFineMip) + src_row1 * FineMipStride);
+            // Same operations in the same order as in SRGBAverage and FastLinearToSRGB
+            __m128 x = _mm_setr_ps(ToLinear[pTexel00[0]], ToLinear[pTexel00[1]], ToLinear[pTexel00[2]], ToLinear[pTexel00[3]]);
+            x        = _mm_add_ps(x, _mm_setr_ps(ToLinear[pTexel00[4]], ToLinear[pTexel00[5]], ToLinear[pTexel00[6]], ToLinear[pTexel00[7]]));
+            x        = _mm_add_ps(x, _mm_setr_ps(ToLinear[pTexel10[0]], ToLinear[pTexel10[1]], ToLinear[pTexel10[2]], ToLinear[pTexel10[3]]));
+            x        = _mm_add_ps(x, _mm_setr_ps(ToLinear[pTexel10[4]], ToLinear[pTexel10[5]], ToLinear[pTexel10[6]], ToLinear[pTexel10[7]]));
+            x        = _mm_mul_ps(x, _mm_set1_ps(0.25f));
 
-            for (Uint32 col = 0; col < CoarseMipWidth; ++col)
-            {
-                auto src_col0 = col * 2;
-                auto src_col1 = std::min(col * 2 + 1, FineMipWidth - 1);
+            const __m128 Linear = _mm_mul_ps(_mm_set1_ps(12.92f), x);
+
+            __m128 Curve = _mm_mul_ps(_mm_set1_ps(1.13005f), _mm_sqrt_ps(_mm_and_ps(_mm_sub_ps(x, _mm_set1_ps(0.00228f)), AbsMask)));
+            Curve        = _mm_sub_ps(Curve, _mm_mul_ps(_mm_set1_ps(0.13448f), x));
+            Curve        = _mm_add_ps(Curve, _mm_set1_ps(0.005719f));
+
+            const __m128 IsLinear = _mm_cmplt_ps(x, _mm_set1_ps(0.0031308f));
+
+            __m128 SRGB = _mm_or_ps(_mm_and_ps(IsLinear, Linear), _mm_andnot_ps(IsLinear, Curve));
+            SRGB        = _mm_mul_ps(SRGB, _mm_set1_ps(255.f));
+            SRGB        = _mm_min_ps(_mm_max_ps(SRGB, _mm_setzero_ps()), _mm_set1_ps(255.f));
+
+            __m128i Bytes = _mm_cvttps_epi32(SRGB);
+            Bytes         = _mm_packs_epi32(Bytes, Bytes);
+            Bytes         = _mm_packus_epi16(Bytes, Bytes);
+
+            const Int32 Texel = _mm_cvtsi128_si32(Bytes);
+            memcpy(pDstRow + col * 4, &Texel, sizeof(Texel));
+        }
+#    else
+        for (; col < EndCol; ++col)
+        {
+            const Uint8* pTexel00 = pSrcRow0 + col * 8;
+            const Uint8* pTexel10 = pSrcRow1 + col * 8;
 
-                for (Uint32 c = 0; c < NumChannels; ++c)
+            // Same operations in the same order as in SRGBAverage and FastLinearToSRGB
+            const float Texels[16] = //
                 {
-                    const auto Chnl00 = pSrcRow0[src_col0 * NumChannels + c];
-                    const auto Chnl01 = pSrcRow0[src_col1 * NumChannels + c];
-                    const auto Chnl10 = pSrcRow1[src_col0 * NumChannels + c];
-                    const auto Chnl11 = pSrcRow1[src_col1 * NumChannels + c];
+                    ToLinear[pTexel00[0]], ToLinear[pTexel00[1]], ToLinear[pTexel00[2]], ToLinear[pTexel00[3]],
+                    ToLinear[pTexel00[4]], ToLinear[pTexel00[5]], ToLinear[pTexel00[6]], ToLinear[pTexel00[7]],
+                    ToLinear[pTexel10[0]], ToLinear[pTexel10[1]], ToLinear[pTexel10[2]], ToLinear[pTexel10[3]],
+                    ToLinear[pTexel10[4]], ToLinear[pTexel10[5]], ToLinear[pTexel10[6]], ToLinear[pTexel10[7]],
+                };
+            float32x4_t x = vld1q_f32(Texels);
+            x             = vaddq_f32(x, vld1q_f32(Texels + 4));
+            x             = vaddq_f32(x, vld1q_f32(Texels + 8));
+            x             = vaddq_f32(x, vld1q_f32(Texels + 12));
+            x             = vmulq_n_f32(x, 0.25f);
 
-                    auto& DstCol = reinterpret_cast<ChannelType*>(reinterpret_cast<Uint8*>(pCoarseMip) + row * CoarseMipStride)[col * NumChannels + c];
+            const float32x4_t Linear = vmulq_n_f32(x, 12.92f);
 
-                    DstCol = ComputeAverage(Chnl00, Chnl01, Chnl10, Chnl11);
-                }
-            }
+            float32x4_t Curve = vmulq_n_f32(vsqrtq_f32(vabsq_f32(vsubq_f32(x, vdupq_n_f32(0.00228f)))), 1.13005f);
+            Curve             = vsubq_f32(Curve, vmulq_n_f32(x, 0.13448f));
+            Curve             = vaddq_f32(Curve, vdupq_n_f32(0.005719f));
+
+            const uint32x4_t IsLinear = vcltq_f32(x, vdupq_n_f32(0.0031308f));
+
+            float32x4_t SRGB = vbslq_f32(IsLinear, Linear, Curve);
+            SRGB             = vmulq_n_f32(SRGB, 255.f);
+            SRGB             = vminq_f32(vmaxq_f32(SRGB, vdupq_n_f32(0.f)), vdupq_n_f32(255.f));
+
+            const uint16x4_t Words = vmovn_u32(vcvtq_u32_f32(SRGB));
+            const uint8x8_t  Bytes = vmovn_u16(vcombine_u16(Words, Words));
+            const Uint32 Texel = vget_lane_u32(vreinterpret_u32_u8(Bytes), 0);
+            memcpy(pDstRow + col * 4, &Texel, sizeof(Texel));
         }
+#    endif
     }
-};
+#endif
+    BoxFilterRow<Uint8, SRGBAverage, 4>(pFineRow0, pFineRow1, pCoarseRow, col, EndCol, FineWidth, 4);
+}
 
-void ComputeMipLevel(Uint32         FineLevelWidth,
-                     Uint32         FineLevelHeight,
-                     TEXTURE_FORMAT Fmt,
-                     const void*    pFineLevelData,
-                     Uint32         FineDataStrideInBytes,
-                     void*          pCoarseLevelData,
-                     Uint32         CoarseDataStrideInBytes)
+// 32-bit float RGBA average
+void BoxFilterRowRGBA32F(const void* pFineRow0,
+                         const void* pFineRow1,
+                         void*       pCoarseRow,
+                         Uint32      StartCol,
+                         Uint32      EndCol,
+                         Uint32      FineWidth,
+                         Uint32      NumChannels)
 {
-    const auto& FmtAttribs = GetTextureFormatAttribs(Fmt);
+    VERIFY_EXPR(NumChannels == 4);
 
-    ComputeCoarseMipHelper ComputeMipHelper //
+    Uint32 col = StartCol;
+#if DILIGENT_MIP_SSE2 || DILIGENT_MIP_NEON
+    if (FineWidth > 1)
+    {
+        const auto* pSrcRow0 = static_cast<const float*>(pFineRow0);
+        const auto* pSrcRow1 = static_cast<const float*>(pFineRow1);
+        auto*       pDstRow  = static_cast<float*>(pCoarseRow);
+        for (; col < EndCol; ++col)
         {
-            FineLevelWidth,
-            FineLevelHeight,
-            pFineLevelData,
-            FineDataStrideInBytes,
-            pCoarseLevelData,
-            CoarseDataStrideInBytes,
-            FmtAttribs.NumComponents //
-        };
+            // The order of additions is the same as in LinearAverage<Float32>
+#    if DILIGENT_MIP_SSE2
+            const __m128 Sum = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_loadu_ps(pSrcRow0 + col * 8), _mm_loadu_ps(pSrcRow0 + col * 8 + 4)),
+                                                     _mm_loadu_ps(pSrcRow1 + col * 8)),
+                                          _mm_loadu_ps(pSrcRow1 + col * 8 + 4));
+            _mm_storeu_ps(pDstRow + col * 4, _mm_mul_ps(Sum, _mm_set1_ps(0.25f)));
+#    else
+            const float32x4_t Sum = vaddq_f32(vaddq_f32(vaddq_f32(vld1q_f32(pSrcRow0 + col * 8), vld1q_f32(pSrcRow0 + col * 8 + 4)),
+                                                        vld1q_f32(pSrcRow1 + col * 8)),
+                                              vld1q_f32(pSrcRow1 + col * 8 + 4));
+            vst1q_f32(pDstRow + col * 4, vmulq_n_f32(Sum, 0.25f));
+#    endif
+        }
+    }
+#endif
+    BoxFilterRow<Float32, LinearAverage<Float32>, 4>(pFineRow0, pFineRow1, pCoarseRow, col, EndCol, FineWidth, 4);
+}
+
+template <typename ChannelType, typename AverageFuncType>
+BoxFilterRowFuncType GetBoxFilterRowFunc(Uint32 NumChannels)
+{
+    switch (NumChannels)
+    {
+        case 1: return BoxFilterRow<ChannelType, AverageFuncType, 1>;
+        case 2: return BoxFilterRow<ChannelType, AverageFuncType, 2>;
+        case 4: return BoxFilterRow<ChannelType, AverageFuncType, 4>;
+        default: return BoxFilterRow<ChannelType, AverageFuncType, 0>;
+    }
+}
 
+BoxFilterRowFuncType GetBoxFilterRowFunc(const TextureFormatAttribs& FmtAttribs)
+{
+    const Uint32 NumChannels = FmtAttribs.NumComponents;
     switch (FmtAttribs.ComponentType)
     {
         case COMPONENT_TYPE_UNORM_SRGB:
             VERIFY(FmtAttribs.ComponentSize == 1, "Only 8-bit sRGB formats are expected");
-            ComputeMipHelper.Run<Uint8>(SRGBAverage<Uint8>);
-            break;
+            return NumChannels == 4 ? BoxFilterRowSRGBA8 : GetBoxFilterRowFunc<Uint8, SRGBAverage>(NumChannels);
 
         case COMPONENT_TYPE_UNORM:
         case COMPONENT_TYPE_UINT:
             switch (FmtAttribs.ComponentSize)
             {
                 case 1:
-                    ComputeMipHelper.Run<Uint8>(LinearAverage<Uint8>);
-                    break;
+                    return NumChannels == 4 ? BoxFilterRowRGBA8 : GetBoxFilterRowFunc<Uint8, LinearAverage<Uint8>>(NumChannels);
 
                 case 2:
-                    ComputeMipHelper.Run<Uint16>(LinearAverage<Uint16>);
-                    break;
+                    return GetBoxFilterRowFunc<Uint16, LinearAverage<Uint16>>(NumChannels);
 
                 case 4:
-                    ComputeMipHelper.Run<Uint32>(LinearAverage<Uint32>);
-                    break;
+                    return GetBoxFilterRowFunc<Uint32, LinearAverage<Uint32>>(NumChannels);
 
                 default:
                     UNEXPECTED("Unexpected component size (", FmtAttribs.ComponentSize, ") for UNORM/UINT texture format");
+                    return nullptr;
             }
-            break;
 
         case COMPONENT_TYPE_SNORM:
         case COMPONENT_TYPE_SINT:
             switch (FmtAttribs.ComponentSize)
             {
                 case 1:
-                    ComputeMipHelper.Run<Int8>(LinearAverage<Int8>);
-                    break;
+                    return GetBoxFilterRowFunc<Int8, LinearAverage<Int8>>(NumChannels);
 
                 case 2:
-                    ComputeMipHelper.Run<Int16>(LinearAverage<Int16>);
-                    break;
+                    return GetBoxFilterRowFunc<Int16, LinearAverage<Int16>>(NumChannels);
 
                 case 4:
-                    ComputeMipHelper.Run<Int32>(LinearAverage<Int32>);
-                    break;
+                    return GetBoxFilterRowFunc<Int32, LinearAverage<Int32>>(NumChannels);
 
                 default:
                     UNEXPECTED("Unexpected component size (", FmtAttribs.ComponentSize, ") for UINT/SINT texture format");
+                    return nullptr;
             }
-            break;
 
         case COMPONENT_TYPE_FLOAT:
             VERIFY(FmtAttribs.ComponentSize == 4, "Only 32-bit float formats are currently supported");
-            ComputeMipHelper.Run<Float32>(LinearAverage<Float32>);
-            break;
+            return NumChannels == 4 ? BoxFilterRowRGBA32F : GetBoxFilterRowFunc<Float32, LinearAverage<Float32>>(NumChannels);
 
         default:
             UNEXPECTED("Unsupported component type");
+            return nullptr;
+    }
+}
+
+struct MipLevelInfo
+{
+    Uint8* pData  = nullptr;
+    Uint32 Stride = 0;
+    Uint32 Width  = 0;
+    Uint32 Height = 0;
+
+    Uint8* GetRow(Uint32 Row) const
+    {
+        return pData + size_t{Row} * Stride;
+    }
+};
+
+// Computes texels [StartCol, EndCol) x [StartRow, EndRow) of the coarse level
+void BoxFilterRect(BoxFilterRowFuncType FilterRow,
+                   Uint32               NumChannels,
+                   const MipLevelInfo&  FineLevel,
+                   const MipLevelInfo&  CoarseLevel,
+                   Uint32               StartCol,
+                   Uint32               EndCol,
+                   Uint32               StartRow,
+                   Uint32               EndRow)
+{
+    for (Uint32 row = StartRow; row < EndRow; ++row)
+    {
+        const auto src_row0 = row * 2;
+        const auto src_row1 = std::min(row * 2 + 1, FineLevel.Height - 1);
+        FilterRow(FineLevel.GetRow(src_row0), FineLevel.GetRow(src_row1), CoarseLevel.GetRow(row), StartCol, EndCol, FineLevel.Width, NumChannels);
+    }
+}
+
+void ComputeBoxMipChain(const std::vector<MipLevelInfo>& Levels, const TextureFormatAttribs& FmtAttribs, Uint32 NumThreads)
+{
+    const auto FilterRow = GetBoxFilterRowFunc(FmtAttribs);
+    if (FilterRow == nullptr)
+        return;
+
+    const Uint32 NumChannels = FmtAttribs.NumComponents;
+
+    // The top levels are computed in horizontal strips: a strip of 2^N rows of the finest
+    // level produces 2^(N-1) rows of level 1, 2^(N-2) rows of level 2, and so on, and every
+    // coarse row only depends on the rows of the same strip. The strip height is selected
+    // so that the strip stays in the cache while its levels are computed. Full-width strips
+    // (rather than square tiles) keep the memory accesses sequential.
+    constexpr size_t TargetStripSize    = size_t{256} << 10;
+    constexpr Uint32 MaxStripHeightLog2 = 7;
+
+    const size_t FineRowSize     = size_t{Levels[0].Width} * FmtAttribs.ComponentSize * NumChannels;
+    Uint32       StripHeightLog2 = 1;
+    while (StripHeightLog2 < MaxStripHeightLog2 && (FineRowSize << (StripHeightLog2 + 1)) <= TargetStripSize)
+        ++StripHeightLog2;
+
+    const Uint32 NumStripLevels = std::min(static_cast<Uint32>(Levels.size() - 1), StripHeightLog2);
+    const Uint32 StripHeight    = 1u << StripHeightLog2;
+    const Uint32 NumStrips      = (Levels[0].Height + StripHeight - 1) / StripHeight;
+
+    ParallelForRanges(NumStrips, NumThreads, [&](Uint32 StartStrip, Uint32 EndStrip) {
+        for (Uint32 Strip = StartStrip; Strip < EndStrip; ++Strip)
+        {
+            for (Uint32 Level = 1; Level <= NumStripLevels; ++Level)
+            {
+                const auto& CoarseLevel = Levels[Level];
+
+                const Uint32 StartRow = (Strip * StripHeight) >> Level;
+                const Uint32 EndRow   = std::min(((Strip + 1) * StripHeight) >> Level, CoarseLevel.Height);
+                if (StartRow >= EndRow)
+                    break;
+
+                BoxFilterRect(FilterRow, NumChannels, Levels[Level - 1], CoarseLevel, 0, CoarseLevel.Width, StartRow, EndRow);
+            }
+        }
+    });
+
+    // The remaining levels are small
+    for (size_t Level = NumStripLevels + 1; Level < Levels.size(); ++Level)
+    {
+        const auto& CoarseLevel = Levels[Level];
+        BoxFilterRect(FilterRow, NumChannels, Levels[Level - 1], CoarseLevel, 0, CoarseLevel.Width, 0, CoarseLevel.Height);
+    }
+}
+
+
+float Sinc(float x)
+{
+    if (std::abs(x) < 1e-6f)
+        return 1.f;
+    x *= PI_F;
+    return std::sin(x) / x;
+}
+
+// Modified Bessel function of the first kind of order zero
+float BesselI0(float x)
+{
+    float Sum  = 1.f;
+    float Term = 1.f;
+    for (int k = 1; k < 32 && Term > Sum * 1e-8f; ++k)
+    {
+        const float HalfXOverK = x * 0.5f / static_cast<float>(k);
+        Term *= HalfXOverK * HalfXOverK;
+        Sum += Term;
+    }
+    return Sum;
+}
+
+// Filter radius in coarse texels
+constexpr float MipFilterRadius = 3.f;
+
+float EvaluateMipFilter(MIP_FILTER_TYPE FilterType, float x)
+{
+    x = std::abs(x);
+    if (x >= MipFilterRadius)
+        return 0.f;
+
+    switch (FilterType)
+    {
+        case MIP_FILTER_TYPE_KAISER:
+        {
+            constexpr float Alpha = 4.f;
+            const float     t     = x / MipFilterRadius;
+            return Sinc(x) * BesselI0(Alpha * std::sqrt(1.f - t * t)) / BesselI0(Alpha);
+        }
+
+        case MIP_FILTER_TYPE_LANCZOS:
+            return Sinc(x) * Sinc(x / MipFilterRadius);
+
+        default:
+            UNEXPECTED("Unexpected filter type");
+            return 0.f;
+    }
+}
+
+// Normalized weights of the fine texels that contribute to every coarse texel
+struct MipFilterKernel
+{
+    MipFilterKernel(MIP_FILTER_TYPE FilterType, Uint32 FineSize, Uint32 CoarseSize)
+    {
+        if (FineSize == CoarseSize)
+        {
+            NumTaps = 1;
+            Indices.resize(CoarseSize);
+            Weights.resize(CoarseSize, 1.f);
+            for (Uint32 i = 0; i < CoarseSize; ++i)
+                Indices[i] = i;
+            return;
+        }
+
+        const float Scale     = static_cast<float>(FineSize) / static_cast<float>(CoarseSize);
+        const float HalfWidth = MipFilterRadius * Scale;
+
+        NumTaps = static_cast<Uint32>(std::ceil(HalfWidth * 2.f)) + 1;
+        Indices.resize(size_t{CoarseSize} * NumTaps);
+        Weights.resize(size_t{CoarseSize} * NumTaps);
+        for (Uint32 i = 0; i < CoarseSize; ++i)
+        {
+            const float Center = (static_cast<float>(i) + 0.5f) * Scale;
+            const int   First  = static_cast<int>(std::floor(Center - HalfWidth));
+
+            float WeightSum = 0;
+            for (Uint32 t = 0; t < NumTaps; ++t)
+            {
+                const int   FineIdx = First + static_cast<int>(t);
+                const float Weight  = EvaluateMipFilter(FilterType, (static_cast<float>(FineIdx) + 0.5f - Center) / Scale);
+
+                // Clamp to edge
+                Indices[size_t{i} * NumTaps + t] = static_cast<Uint32>(std::min(std::max(FineIdx, 0), static_cast<int>(FineSize) - 1));
+                Weights[size_t{i} * NumTaps + t] = Weight;
+                WeightSum += Weight;
+            }
+            for (Uint32 t = 0; t < NumTaps; ++t)
+                Weights[size_t{i} * NumTaps + t] /= WeightSum;
+        }
+    }
+
+    Uint32              NumTaps = 0;
+    std::vector<Uint32> Indices;
+    std::vector<float>  Weights;
+};
+
+// Linear value thresholds that separate adjacent 8-bit sRGB values
+class LinearToSRGB8Table
+{
+public:
+    LinearToSRGB8Table() noexcept
+    {
+        for (Uint32 i = 0; i < m_Thresholds.size(); ++i)
+            m_Thresholds[i] = SRGBToLinear((static_cast<float>(i) + 0.5f) / 255.f);
+    }
+
+    Uint8 operator()(float x) const
+    {
+        return static_cast<Uint8>(std::upper_bound(m_Thresholds.begin(), m_Thresholds.end(), x) - m_Thresholds.begin());
+    }
+
+    static const LinearToSRGB8Table& Get()
+    {
+        static const LinearToSRGB8Table Table;
+        return Table;
+    }
+
+private:
+    std::array<float, 255> m_Thresholds;
+};
+
+// Converts NumValues channel values of a row to/from linear floating-point values.
+// Alpha channels of sRGB formats are linear.
+using DecodeMipRowFuncType = void (*)(const void* pSrc, float* pDst, Uint32 NumValues, Uint32 NumChannels);
+using EncodeMipRowFuncType = void (*)(const float* pSrc, void* pDst, Uint32 NumValues, Uint32 NumChannels);
+
+template <typename ChannelType>
+void DecodeUNormRow(const void* pSrc, float* pDst, Uint32 NumValues, Uint32 /*NumChannels*/)
+{
+    constexpr float Scale = 1.f / static_cast<float>(std::numeric_limits<ChannelType>::max());
+    for (Uint32 i = 0; i < NumValues; ++i)
+        pDst[i] = static_cast<float>(static_cast<const ChannelType*>(pSrc)[i]) * Scale;
+}
+
+template <typename ChannelType>
+void EncodeUNormRow(const float* pSrc, void* pDst, Uint32 NumValues, Uint32 /*NumChannels*/)
+{
+    constexpr float MaxVal = static_cast<float>(std::numeric_limits<ChannelType>::max());
+    for (Uint32 i = 0; i < NumValues; ++i)
+        static_cast<ChannelType*>(pDst)[i] = static_cast<ChannelType>(std::min(std::max(pSrc[i], 0.f), 1.f) * MaxVal + 0.5f);
+}
+
+template <typename ChannelType>
+void DecodeSNormRow(const void* pSrc, float* pDst, Uint32 NumValues, Uint32 /*NumChannels*/)
+{
+    constexpr float Scale = 1.f / static_cast<float>(std::numeric_limits<ChannelType>::max());
+    for (Uint32 i = 0; i < NumValues; ++i)
+        pDst[i] = std::max(static_cast<float>(static_cast<const ChannelType*>(pSrc)[i]) * Scale, -1.f);
+}
+
+template <typename ChannelType>
+void EncodeSNormRow(const float* pSrc, void* pDst, Uint32 NumValues, Uint32 /*NumChannels*/)
+{
+    constexpr float MaxVal = static_cast<float>(std::numeric_limits<ChannelType>::max());
+    for (Uint32 i = 0; i < NumValues; ++i)
+        static_cast<ChannelType*>(pDst)[i] = static_cast<ChannelType>(std::round(std::min(std::max(pSrc[i], -1.f), 1.f) * MaxVal));
+}
+
+void DecodeSRGB8Row(const void* pSrc, float* pDst, Uint32 NumValues, Uint32 NumChannels)
+{
+    const auto* pSrc8 = static_cast<const Uint8*>(pSrc);
+    for (Uint32 i = 0; i < NumValues; ++i)
+        pDst[i] = (NumChannels == 4 && i % 4 == 3) ? static_cast<float>(pSrc8[i]) * (1.f / 255.f) : SRGBToLinear(pSrc8[i]);
+}
+
+void EncodeSRGB8Row(const float* pSrc, void* pDst, Uint32 NumValues, Uint32 NumChannels)
+{
+    const auto& ToSRGB = LinearToSRGB8Table::Get();
+
+    auto* pDst8 = static_cast<Uint8*>(pDst);
+    for (Uint32 i = 0; i < NumValues; ++i)
+        pDst8[i] = (NumChannels == 4 && i % 4 == 3) ? static_cast<Uint8>(std::min(std::max(pSrc[i], 0.f), 1.f) * 255.f + 0.5f) : ToSRGB(pSrc[i]);
+}
+
+void DecodeFloatRow(const void* pSrc, float* pDst, Uint32 NumValues, Uint32 /*NumChannels*/)
+{
+    memcpy(pDst, pSrc, sizeof(float) * NumValues);
+}
+
+void EncodeFloatRow(const float* pSrc, void* pDst, Uint32 NumValues, Uint32 /*NumChannels*/)
+{
+    memcpy(pDst, pSrc, sizeof(float) * NumValues);
+}
+
+bool GetMipRowCodec(const TextureFormatAttribs& FmtAttribs, DecodeMipRowFuncType& Decode, EncodeMipRowFuncType& Encode)
+{
+    switch (FmtAttribs.ComponentType)
+    {
+        case COMPONENT_TYPE_UNORM_SRGB:
+            if (FmtAttribs.ComponentSize != 1)
+                return false;
+            Decode = DecodeSRGB8Row;
+            Encode = EncodeSRGB8Row;
+            return true;
+
+        case COMPONENT_TYPE_UNORM:
+            if (FmtAttribs.ComponentSize == 1)
+            {
+                Decode = DecodeUNormRow<Uint8>;
+                Encode = EncodeUNormRow<Uint8>;
+                return true;
+            }
+            if (FmtAttribs.ComponentSize == 2)
+            {
+                Decode = DecodeUNormRow<Uint16>;
+                Encode = EncodeUNormRow<Uint16>;
+                return true;
+            }
+            return false;
+
+        case COMPONENT_TYPE_SNORM:
+            if (FmtAttribs.ComponentSize == 1)
+            {
+                Decode = DecodeSNormRow<Int8>;
+                Encode = EncodeSNormRow<Int8>;
+                return true;
+            }
+            if (FmtAttribs.ComponentSize == 2)
+            {
+                Decode = DecodeSNormRow<Int16>;
+                Encode = EncodeSNormRow<Int16>;
+                return true;
+            }
+            return false;
+
+        case COMPONENT_TYPE_FLOAT:
+            if (FmtAttribs.ComponentSize != 4)
+                return false;
+            Decode = DecodeFloatRow;
+            Encode = EncodeFloatRow;
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+// pDst[i] += pSrc[i] * Weight
+void AccumulateWeighted(float* pDst, const float* pSrc, float Weight, size_t NumValues)
+{
+    size_t i = 0;
+#if DILIGENT_MIP_SSE2
+    const __m128 vWeight = _mm_set1_ps(Weight);
+    for (; i + 4 <= NumValues; i += 4)
+        _mm_storeu_ps(pDst + i, _mm_add_ps(_mm_loadu_ps(pDst + i), _mm_mul_ps(_mm_loadu_ps(pSrc + i), vWeight)));
+#elif DILIGENT_MIP_NEON
+    for (; i + 4 <= NumValues; i += 4)
+        vst1q_f32(pDst + i, vmlaq_n_f32(vld1q_f32(pDst + i), vld1q_f32(pSrc + i), Weight));
+#endif
+    for (; i < NumValues; ++i)
+        pDst[i] += pSrc[i] * Weight;
+}
+
+// Computes every coarse level from the previous one with a separable filter.
+void ComputeFilteredMipChain(const std::vector<MipLevelInfo>& Levels, const TextureFormatAttribs& FmtAttribs, MIP_FILTER_TYPE FilterType, Uint32 NumThreads)
+{
+    DecodeMipRowFuncType Decode = nullptr;
+    EncodeMipRowFuncType Encode = nullptr;
+    if (!GetMipRowCodec(FmtAttribs, Decode, Encode))
+    {
+        LOG_ERROR_MESSAGE("Format ", FmtAttribs.Name, " is not supported by the ", (FilterType == MIP_FILTER_TYPE_KAISER ? "Kaiser" : "Lanczos"),
+                          " mip filter. Only UNORM, UNORM_SRGB, SNORM and 32-bit FLOAT formats are supported.");
+        return;
+    }
+
+    const Uint32 NumChannels = FmtAttribs.NumComponents;
+    for (size_t Level = 1; Level < Levels.size(); ++Level)
+    {
+        const auto& FineLevel   = Levels[Level - 1];
+        const auto& CoarseLevel = Levels[Level];
+
+        const MipFilterKernel HorzKernel{FilterType, FineLevel.Width, CoarseLevel.Width};
+        const MipFilterKernel VertKernel{FilterType, FineLevel.Height, CoarseLevel.Height};
+
+        ParallelForRanges(CoarseLevel.Height, NumThreads, [&](Uint32 StartRow, Uint32 EndRow) {
+            const size_t FineRowSize   = size_t{FineLevel.Width} * NumChannels;
+            const size_t CoarseRowSize = size_t{CoarseLevel.Width} * NumChannels;
+
+            // Horizontally filtered fine rows. As coarse rows are processed in order,
+            // the window of fine rows slides down, so a ring buffer of NumTaps rows
+            // makes every fine row filtered at most once.
+            const Uint32        NumRingRows = VertKernel.NumTaps;
+            std::vector<float>  Ring(CoarseRowSize * NumRingRows);
+            std::vector<Uint32> RingRowIdx(NumRingRows, ~0u);
+
+            std::vector<float> DecodedRow(FineRowSize);
+            std::vector<float> CoarseRow(CoarseRowSize);
+
+            auto GetHorzFilteredRow = [&](Uint32 FineRow) -> const float* {
+                const Uint32 Slot = FineRow % NumRingRows;
+                float*       pRow = &Ring[CoarseRowSize * Slot];
+                if (RingRowIdx[Slot] == FineRow)
+                    return pRow;
+
+                Decode(FineLevel.GetRow(FineRow), DecodedRow.data(), static_cast<Uint32>(FineRowSize), NumChannels);
+                for (Uint32 x = 0; x < CoarseLevel.Width; ++x)
+                {
+                    const Uint32* pIndices = &HorzKernel.Indices[size_t{x} * HorzKernel.NumTaps];
+                    const float*  pWeights = &HorzKernel.Weights[size_t{x} * HorzKernel.NumTaps];
+#if DILIGENT_MIP_SSE2
+                    if (NumChannels == 4)
+                    {
+                        __m128 Sum = _mm_setzero_ps();
+                        for (Uint32 t = 0; t < HorzKernel.NumTaps; ++t)
+                            Sum = _mm_add_ps(Sum, _mm_mul_ps(_mm_loadu_ps(&DecodedRow[pIndices[t] * 4]), _mm_set1_ps(pWeights[t])));
+                        _mm_storeu_ps(&pRow[x * 4], Sum);
+                        continue;
+                    }
+#endif
+                    for (Uint32 c = 0; c < NumChannels; ++c)
+                        pRow[x * NumChannels + c] = 0;
+                    for (Uint32 t = 0; t < HorzKernel.NumTaps; ++t)
+                        AccumulateWeighted(&pRow[x * NumChannels], &DecodedRow[pIndices[t] * NumChannels], pWeights[t], NumChannels);
+                }
+                RingRowIdx[Slot] = FineRow;
+                return pRow;
+            };
+
+            for (Uint32 y = StartRow; y < EndRow; ++y)
+            {
+                std::fill(CoarseRow.begin(), CoarseRow.end(), 0.f);
+                for (Uint32 t = 0; t < VertKernel.NumTaps; ++t)
+                {
+                    const float  Weight = VertKernel.Weights[size_t{y} * VertKernel.NumTaps + t];
+                    const float* pRow   = GetHorzFilteredRow(VertKernel.Indices[size_t{y} * VertKernel.NumTaps + t]);
+                    AccumulateWeighted(CoarseRow.data(), pRow, Weight, CoarseRowSize);
+                }
+                Encode(CoarseRow.data(), CoarseLevel.GetRow(y), static_cast<Uint32>(CoarseRowSize), NumChannels);
+            }
+        });
+    }
+}
+
+
+// Alpha channel accessor for the alpha coverage preservation
+struct AlphaChannelInfo
+{
+    Uint32 Offset    = 0; // Offset of the alpha channel in the texel, in bytes
+    Uint32 TexelSize = 0;
+
+    COMPONENT_TYPE Type = COMPONENT_TYPE_UNDEFINED;
+    Uint32         Size = 0;
+
+    float Read(const Uint8* pTexel) const
+    {
+        const auto* pAlpha = pTexel + Offset;
+        if (Type == COMPONENT_TYPE_FLOAT)
+        {
+            float Alpha;
+            memcpy(&Alpha, pAlpha, sizeof(Alpha));
+            return Alpha;
+        }
+        else if (Size == 1)
+        {
+            return static_cast<float>(*pAlpha) * (1.f / 255.f);
+        }
+        else
+        {
+            Uint16 Alpha;
+            memcpy(&Alpha, pAlpha, sizeof(Alpha));
+            return static_cast<float>(Alpha) * (1.f / 65535.f);
+        }
+    }
+
+    void Write(Uint8* pTexel, float Alpha) const
+    {
+        auto* pAlpha = pTexel + Offset;
+        if (Type == COMPONENT_TYPE_FLOAT)
+        {
+            memcpy(pAlpha, &Alpha, sizeof(Alpha));
+        }
+        else if (Size == 1)
+        {
+            *pAlpha = static_cast<Uint8>(std::min(Alpha, 1.f) * 255.f + 0.5f);
+        }
+        else
+        {
+            const auto Alpha16 = static_cast<Uint16>(std::min(Alpha, 1.f) * 65535.f + 0.5f);
+            memcpy(pAlpha, &Alpha16, sizeof(Alpha16));
+        }
+    }
+};
+
+bool GetAlphaChannelInfo(const TextureFormatAttribs& FmtAttribs, TEXTURE_FORMAT Fmt, AlphaChannelInfo& Info)
+{
+    Uint32 AlphaIdx = 0;
+    if (Fmt == TEX_FORMAT_A8_UNORM)
+        AlphaIdx = 0;
+    else if (FmtAttribs.NumComponents == 4 && FmtAttribs.ComponentType != COMPONENT_TYPE_COMPOUND)
+        AlphaIdx = 3;
+    else
+        return false;
+
+    const bool IsSupported =
+        ((FmtAttribs.ComponentType == COMPONENT_TYPE_UNORM || FmtAttribs.ComponentType == COMPONENT_TYPE_UNORM_SRGB) && FmtAttribs.ComponentSize <= 2) ||
+        (FmtAttribs.ComponentType == COMPONENT_TYPE_FLOAT && FmtAttribs.ComponentSize == 4);
+    if (!IsSupported)
+        return false;
+
+    Info.Offset    = AlphaIdx * FmtAttribs.ComponentSize;
+    Info.TexelSize = Uint32{FmtAttribs.ComponentSize} * Uint32{FmtAttribs.NumComponents};
+    Info.Type      = FmtAttribs.ComponentType;
+    Info.Size      = FmtAttribs.ComponentSize;
+    return true;
+}
+
+// Scales alpha values of every coarse level so that the fraction of texels
+// with alpha above the cutoff matches that of the finest level.
+void PreserveAlphaCoverage(const std::vector<MipLevelInfo>& Levels, const AlphaChannelInfo& Alpha, float AlphaCutoff)
+{
+    std::vector<float> Values;
+
+    auto ReadAlpha = [&](const MipLevelInfo& Level) {
+        Values.resize(size_t{Level.Width} * Level.Height);
+        for (Uint32 y = 0; y < Level.Height; ++y)
+        {
+            const auto* pRow = Level.GetRow(y);
+            for (Uint32 x = 0; x < Level.Width; ++x)
+                Values[size_t{y} * Level.Width + x] = Alpha.Read(pRow + x * Alpha.TexelSize);
+        }
+    };
+
+    ReadAlpha(Levels[0]);
+    const auto   NumPassed = std::count_if(Values.begin(), Values.end(), [AlphaCutoff](float a) { return a > AlphaCutoff; });
+    const double Coverage  = static_cast<double>(NumPassed) / static_cast<double>(Values.size());
+
+    for (size_t Level = 1; Level < Levels.size(); ++Level)
+    {
+        const auto& CoarseLevel = Levels[Level];
+        ReadAlpha(CoarseLevel);
+
+        // The number of texels that should pass the alpha test
+        const size_t NumToPass = std::min(static_cast<size_t>(Coverage * static_cast<double>(Values.size()) + 0.5), Values.size());
+
+        // Many texels may have the same alpha, so find the boundary between two distinct
+        // values that is the closest to the target number of texels.
+        std::sort(Values.begin(), Values.end(), std::greater<float>{});
+        size_t BestNumPassed = 0;
+        for (size_t i = 1; i <= Values.size(); ++i)
+        {
+            const bool IsBoundary = i == Values.size() || Values[i] != Values[i - 1];
+            if (!IsBoundary)
+                continue;
+            if (std::abs(static_cast<double>(i) - static_cast<double>(NumToPass)) < std::abs(static_cast<double>(BestNumPassed) - static_cast<double>(NumToPass)))
+                BestNumPassed = i;
+            if (i >= NumToPass)
+                break;
+        }
+
+        // Scale the alpha so that the cutoff falls between the last passed and the first failed values
+        float Scale = 1;
+        if (BestNumPassed == 0)
+        {
+            if (Values[0] > AlphaCutoff)
+                Scale = AlphaCutoff / Values[0];
+        }
+        else
+        {
+            const float LowestPassed  = Values[BestNumPassed - 1];
+            const float HighestFailed = BestNumPassed < Values.size() ? Values[BestNumPassed] : 0.f;
+            const float Threshold     = (LowestPassed + HighestFailed) * 0.5f;
+            if (Threshold > 0)
+                Scale = AlphaCutoff / Threshold;
+        }
+
+        if (Scale == 1.f)
+            continue;
+
+        for (Uint32 y = 0; y < CoarseLevel.Height; ++y)
+        {
+            auto* pRow = CoarseLevel.GetRow(y);
+            for (Uint32 x = 0; x < CoarseLevel.Width; ++x)
+                Alpha.Write(pRow + x * Alpha.TexelSize, Alpha.Read(pRow + x * Alpha.TexelSize) * Scale);
+        }
+    }
+}
+
+} // namespace
+
+void ComputeMipLevel(Uint32         FineLevelWidth,
+                     Uint32         FineLevelHeight,
+                     TEXTURE_FORMAT Fmt,
+                     const void*    pFineLevelData,
+                     Uint32         FineDataStrideInBytes,
+                     void*          pCoarseLevelData,
+                     Uint32         CoarseDataStrideInBytes)
+{
+    VERIFY_EXPR(FineLevelWidth > 0 && FineLevelHeight > 0);
+
+    const auto& FmtAttribs = GetTextureFormatAttribs(Fmt);
+
+    const auto FilterRow = GetBoxFilterRowFunc(FmtAttribs);
+    if (FilterRow == nullptr)
+        return;
+
+    MipLevelInfo FineLevel;
+    FineLevel.pData  = static_cast<Uint8*>(const_cast<void*>(pFineLevelData));
+    FineLevel.Stride = FineDataStrideInBytes;
+    FineLevel.Width  = FineLevelWidth;
+    FineLevel.Height = FineLevelHeight;
+    VERIFY(FineLevel.Height == 1 || FineLevel.Stride >= FineLevel.Width * FmtAttribs.ComponentSize * FmtAttribs.NumComponents, "Fine mip level stride is too small");
+
+    MipLevelInfo CoarseLevel;
+    CoarseLevel.pData  = static_cast<Uint8*>(pCoarseLevelData);
+    CoarseLevel.Stride = CoarseDataStrideInBytes;
+    CoarseLevel.Width  = std::max(FineLevelWidth / 2u, 1u);
+    CoarseLevel.Height = std::max(FineLevelHeight / 2u, 1u);
+    VERIFY(CoarseLevel.Height == 1 || CoarseLevel.Stride >= CoarseLevel.Width * FmtAttribs.ComponentSize * FmtAttribs.NumComponents, "Coarse mip level stride is too small");
+
+    BoxFilterRect(FilterRow, FmtAttribs.NumComponents, FineLevel, CoarseLevel, 0, CoarseLevel.Width, 0, CoarseLevel.Height);
+}
+
+void ComputeMipChain(const ComputeMipChainAttribs& Attribs)
+{
+    DEV_CHECK_ERR(Attribs.FineLevelWidth > 0 && Attribs.FineLevelHeight > 0, "Fine level size must not be zero");
+    DEV_CHECK_ERR(Attribs.pFineLevelData != nullptr, "Fine level data must not be null");
+    DEV_CHECK_ERR(Attribs.NumCoarseLevels == 0 || Attribs.ppCoarseLevelsData != nullptr, "Coarse level data must not be null");
+
+    const auto&  FmtAttribs = GetTextureFormatAttribs(Attribs.Format);
+    const Uint32 TexelSize  = Uint32{FmtAttribs.ComponentSize} * Uint32{FmtAttribs.NumComponents};
+
+    std::vector<MipLevelInfo> Levels(size_t{Attribs.NumCoarseLevels} + 1);
+    Levels[0].pData  = static_cast<Uint8*>(const_cast<void*>(Attribs.pFineLevelData));
+    Levels[0].Stride = Attribs.FineLevelStride != 0 ? Attribs.FineLevelStride : Attribs.FineLevelWidth * TexelSize;
+    Levels[0].Width  = Attribs.FineLevelWidth;
+    Levels[0].Height = Attribs.FineLevelHeight;
+    DEV_CHECK_ERR(Levels[0].Height == 1 || Levels[0].Stride >= Levels[0].Width * TexelSize, "Fine level stride is too small");
+    for (Uint32 Level = 1; Level <= Attribs.NumCoarseLevels; ++Level)
+    {
+        auto& CoarseLevel  = Levels[Level];
+        CoarseLevel.Width  = std::max(Levels[Level - 1].Width / 2u, 1u);
+        CoarseLevel.Height = std::max(Levels[Level - 1].Height / 2u, 1u);
+        CoarseLevel.pData  = static_cast<Uint8*>(Attribs.ppCoarseLevelsData[Level - 1]);
+        CoarseLevel.Stride = Attribs.pCoarseLevelStrides != nullptr ? Attribs.pCoarseLevelStrides[Level - 1] : CoarseLevel.Width * TexelSize;
+        DEV_CHECK_ERR(CoarseLevel.pData != nullptr, "Data of mip level ", Level, " must not be null");
+        DEV_CHECK_ERR(CoarseLevel.Height == 1 || CoarseLevel.Stride >= CoarseLevel.Width * TexelSize, "Stride of mip level ", Level, " is too small");
+    }
+
+    if (Attribs.FilterType == MIP_FILTER_TYPE_BOX)
+        ComputeBoxMipChain(Levels, FmtAttribs, Attribs.NumThreads);
+    else
+        ComputeFilteredMipChain(Levels, FmtAttribs, Attribs.FilterType, Attribs.NumThreads);
+
+    if (Attribs.AlphaCutoff > 0)
+    {
+        AlphaChannelInfo Alpha;
+        if (GetAlphaChannelInfo(FmtAttribs, Attribs.Format, Alpha))
+            PreserveAlphaCoverage(Levels, Alpha, Attribs.AlphaCutoff);
     }
 }
 
@@ -374,4 +1233,9 @@ extern "C"
         ComputeMipLevel(FineLevelWidth, FineLevelHeight, Fmt, pFineLevelData,
                         FineDataStrideInBytes, pCoarseLevelData, CoarseDataStrideInBytes);
     }
+
+    void Diligent_ComputeMipChain(const Diligent::ComputeMipChainAttribs& Attribs)
+    {
+        Diligent::ComputeMipChain(Attribs);
+    }
 }
@@ -45,6 +45,8 @@ struct ID3D12ShaderReflection;
 namespace Diligent
 {
 
+class ShaderBytecodeCache;
+
 enum class DXCompilerTarget
 {
     Direct3D12, // compiles to DXIL
@@ -87,6 +89,13 @@ public:
                          IDataBlob**             ppCompilerOutput) noexcept(false) = 0;
 
 
+    /// Sets the persistent bytecode cache used by Compile(const ShaderCreateInfo&, ...).
+
+    /// The cache key is computed from the preprocessed source, so that changes to
+    /// any included file invalidate the entry. The cache must outlive the compiler.
+    /// Pass null to disable caching.
+    virtual void SetBytecodeCache(ShaderBytecodeCache* pCache) = 0;
+
     using BindInfo            = ResourceBinding::BindInfo;
     using TResourceBindingMap = ResourceBinding::TMap;
 
@@ -34,6 +34,8 @@
 namespace Diligent
 {
 
+class ShaderBytecodeCache;
+
 namespace GLSLangUtils
 {
 
@@ -45,6 +47,8 @@ enum class SpirvVersion
     Vk120,         // SPIRV 1.5
 };
 
+/// Adds a reference to the glslang process-wide state. Every call
+/// must be matched by a call to FinalizeGlslang(). Thread-safe.
 void InitializeGlslang();
 void FinalizeGlslang();
 
@@ -58,13 +62,15 @@ struct GLSLtoSPIRVAttribs
     SpirvVersion                     Version                    = SpirvVersion::Vk100;
     IDataBlob**                      ppCompilerOutput           = nullptr;
     bool                             AssignBindings             = true;
+    ShaderBytecodeCache*             pBytecodeCache             = nullptr;
 };
 
 std::vector<unsigned int> GLSLtoSPIRV(const GLSLtoSPIRVAttribs& Attribs);
 
 std::vector<unsigned int> HLSLtoSPIRV(const ShaderCreateInfo& ShaderCI,
                                       const char*             ExtraDefinitions,
-                                      IDataBlob**             ppCompilerOutput);
+                                      IDataBlob**             ppCompilerOutput,
+                                      ShaderBytecodeCache*    pBytecodeCache = nullptr);
 
 } // namespace GLSLangUtils
 
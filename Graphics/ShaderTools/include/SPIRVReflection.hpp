@@ -0,0 +1,115 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Declaration of the lightweight SPIR-V reflection used by Diligent::SPIRVShaderResources
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "SPIRVShaderResources.hpp"
+
+namespace Diligent
+{
+
+/// Shader resources extracted from a SPIR-V module, before they are packed into SPIRVShaderResources.
+
+/// The data is produced either by ReflectSPIRVModule() or by SPIRV-Cross, and both
+/// back-ends must produce identical results for the same module.
+struct SPIRVReflection
+{
+    struct Resource
+    {
+        std::string                              Name;
+        SPIRVShaderResourceAttribs::ResourceType Type      = SPIRVShaderResourceAttribs::ResourceType::NumResourceTypes;
+        Uint32                                   ArraySize = 1;
+
+        RESOURCE_DIMENSION ResourceDim = RESOURCE_DIM_UNDEFINED;
+        bool               IsMS        = false;
+
+        // Offsets in SPIRV words of the binding & descriptor set decoration literals, or 0 if not declared
+        uint32_t BindingDecorationOffset       = 0;
+        uint32_t DescriptorSetDecorationOffset = 0;
+
+        Uint32 BufferStaticSize = 0;
+        Uint32 BufferStride     = 0;
+    };
+
+    struct StageInput
+    {
+        std::string Name;
+        // Empty if the input does not have HlslSemanticGOOGLE decoration
+        std::string Semantic;
+        bool        HasSemantic              = false;
+        uint32_t    LocationDecorationOffset = 0;
+    };
+
+    // Resources in the order they are declared in the module
+    std::vector<Resource> UniformBuffers;
+    std::vector<Resource> StorageBuffers;
+    std::vector<Resource> StorageImages;
+    std::vector<Resource> SampledImages;
+    std::vector<Resource> AtomicCounters;
+    std::vector<Resource> SeparateSamplers;
+    std::vector<Resource> SeparateImages;
+    std::vector<Resource> InputAttachments;
+    std::vector<Resource> AccelStructs;
+    static_assert(Uint32{SPIRVShaderResourceAttribs::ResourceType::NumResourceTypes} == 12, "Please add the list for the new resource type here, if needed");
+
+    std::vector<StageInput> StageInputs;
+
+    std::string EntryPoint;
+
+    std::array<Uint32, 3> ComputeGroupSize = {};
+
+    bool IsHLSLSource = false;
+
+    // Indicates if the module declares SPV_GOOGLE_hlsl_functionality1 extension
+    bool HlslFunctionality1 = false;
+};
+
+/// Reflects the SPIR-V module in a single pass over its instructions without building the full IR.
+
+/// \param [in]  SPIRV      - SPIR-V binary.
+/// \param [in]  ShaderType - Type of the entry point to reflect.
+/// \param [out] Reflection - Reflection data.
+///
+/// \return     true if the module was successfully reflected, and false otherwise.
+///
+/// \remarks    The function returns false rather than guessing whenever the module uses
+///             a construct whose reflection by SPIRV-Cross it does not replicate exactly
+///             (decoration groups, specialization constant array sizes, names that
+///             SPIRV-Cross would sanitize, ambiguous entry points, etc.). The caller
+///             is expected to fall back to SPIRV-Cross in this case.
+bool ReflectSPIRVModule(const std::vector<uint32_t>& SPIRV,
+                        SHADER_TYPE                  ShaderType,
+                        SPIRVReflection&             Reflection);
+
+} // namespace Diligent
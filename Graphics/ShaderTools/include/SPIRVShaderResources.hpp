@@ -46,15 +46,25 @@
 #include "STDAllocator.hpp"
 #include "RefCntAutoPtr.hpp"
 #include "StringPool.hpp"
+#include "DataBlob.h"
 
-namespace diligent_spirv_cross
+namespace Diligent
 {
-class Compiler;
-struct Resource;
-} // namespace diligent_spirv_cross
 
-namespace Diligent
+/// Back-end that SPIRVShaderResources uses to reflect the SPIR-V module
+enum class SPIRVReflectionMode : Uint8
 {
+    /// Single-pass reflection of the module instructions (see ReflectSPIRVModule()).
+    /// Falls back to SPIRV-Cross if the module uses constructs that the parser does not handle.
+    Direct,
+
+    /// Reflection through SPIRV-Cross compiler.
+    SPIRVCross,
+
+    /// Reflects the module with both back-ends, reports any differences as errors and
+    /// uses the results produced by SPIRV-Cross.
+    Validate
+};
 
 // sizeof(SPIRVShaderResourceAttribs) == 32, msvc x64
 struct SPIRVShaderResourceAttribs
@@ -98,12 +108,15 @@ struct SPIRVShaderResourceAttribs
 
     // clang-format on
 
-    SPIRVShaderResourceAttribs(const diligent_spirv_cross::Compiler& Compiler,
-                               const diligent_spirv_cross::Resource& Res,
-                               const char*                           _Name,
-                               ResourceType                          _Type,
-                               Uint32                                _BufferStaticSize = 0,
-                               Uint32                                _BufferStride     = 0) noexcept;
+    SPIRVShaderResourceAttribs(const char*        _Name,
+                               ResourceType       _Type,
+                               Uint16             _ArraySize,
+                               RESOURCE_DIMENSION _ResourceDim,
+                               bool               _IsMS,
+                               uint32_t           _BindingDecorationOffset,
+                               uint32_t           _DescriptorSetDecorationOffset,
+                               Uint32             _BufferStaticSize = 0,
+                               Uint32             _BufferStride     = 0) noexcept;
 
     ShaderResourceDesc GetResourceDesc() const
     {
@@ -146,7 +159,10 @@ public:
                          const ShaderDesc&     shaderDesc,
                          const char*           CombinedSamplerSuffix,
                          bool                  LoadShaderStageInputs,
-                         std::string&          EntryPoint);
+                         std::string&          EntryPoint,
+                         SPIRVReflectionMode   ReflectionMode     = SPIRVReflectionMode::Direct,
+                         const void*           pSerializedData    = nullptr,
+                         size_t                SerializedDataSize = 0);
 
     // clang-format off
     SPIRVShaderResources             (const SPIRVShaderResources&)  = delete;
@@ -310,7 +326,22 @@ public:
 
     bool IsHLSLSource() const { return m_IsHLSLSource; }
 
+    /// Serializes the resources into a relocatable blob that can be passed to the constructor
+    /// to skip reflection. The blob is bound to the SPIRV bytecode by its hash.
+    RefCntAutoPtr<IDataBlob> Serialize(const std::vector<uint32_t>& SPIRV, const char* EntryPoint) const;
+
 private:
+    // Initializes the resources from the serialized data. Returns false if the data
+    // is damaged or does not match the shader description. SPIRVSize is the size of
+    // the bytecode in words that is used to validate the decoration offsets.
+    bool Deserialize(IMemoryAllocator&                  Allocator,
+                     class ShaderReflectionDataReader& Reader,
+                     size_t                             SPIRVSize,
+                     const ShaderDesc&                  shaderDesc,
+                     const char*                        CombinedSamplerSuffix,
+                     bool                               LoadShaderStageInputs,
+                     std::string&                       EntryPoint);
+
     void Initialize(IMemoryAllocator&       Allocator,
                     const ResourceCounters& Counters,
                     Uint32                  NumShaderStageInputs,
@@ -376,6 +407,9 @@ private:
 
     // Indicates if the shader was compiled from HLSL source.
     bool m_IsHLSLSource = false;
+
+    // Indicates if the resources were created with LoadShaderStageInputs flag.
+    bool m_StageInputsRequested = false;
 };
 
 } // namespace Diligent
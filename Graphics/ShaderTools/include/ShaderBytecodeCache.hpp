@@ -0,0 +1,163 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Defines Diligent::ShaderBytecodeCache class
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <string>
+
+#include "BasicTypes.h"
+#include "DataBlob.h"
+#include "RefCntAutoPtr.hpp"
+
+namespace Diligent
+{
+
+/// SHA-256 hash of everything that affects the compiler output
+using ShaderBytecodeKey = std::array<Uint8, 32>;
+
+/// Computes ShaderBytecodeKey.
+
+/// Strings and byte ranges are length-prefixed, so that different sequences
+/// of values never produce the same hash input.
+class ShaderBytecodeKeyBuilder
+{
+public:
+    ShaderBytecodeKeyBuilder();
+
+    ShaderBytecodeKeyBuilder& AddBytes(const void* pData, size_t Size);
+
+    /// Null string is distinct from the empty string.
+    ShaderBytecodeKeyBuilder& AddString(const char* Str);
+
+    ShaderBytecodeKeyBuilder& AddString(const std::string& Str)
+    {
+        return AddBytes(Str.data(), Str.length());
+    }
+
+    ShaderBytecodeKeyBuilder& AddUint(Uint64 Value);
+
+    /// Returns the key. The builder must not be used after this call.
+    ShaderBytecodeKey Finish();
+
+private:
+    void Update(const void* pData, size_t Size);
+    void ProcessBlock(const Uint8* pBlock);
+
+    Uint32 m_State[8];
+    Uint64 m_Length = 0;
+    Uint8  m_Block[64];
+};
+
+/// Shader bytecode cache statistics
+struct ShaderBytecodeCacheStats
+{
+    /// The number of successful lookups.
+    Uint64 Hits = 0;
+
+    /// The number of lookups that did not find a valid entry.
+    Uint64 Misses = 0;
+
+    /// The number of stored entries.
+    Uint64 Stores = 0;
+
+    /// The number of entries removed to keep the cache size within the limit.
+    Uint64 Evictions = 0;
+
+    /// Approximate total size of the entries, in bytes.
+    Uint64 Size = 0;
+};
+
+/// Persistent content-addressed cache of compiled shader bytecode.
+
+/// Every entry is stored in a separate file in the cache directory named after its key.
+/// An entry is written to a temporary file that is then renamed, so several processes
+/// may share the directory: a reader sees either a complete entry or no entry. Entries
+/// are validated when loaded, and damaged entries are removed and reported as misses.
+///
+/// When the total size of the entries exceeds the limit, the least recently used entries
+/// are removed until the size drops to 3/4 of the limit. The modification time of an entry
+/// is updated on every hit and serves as its last use time.
+///
+/// The cache does not know what affects the compiler output, so the key must include the
+/// fully preprocessed source, the compiler name and version, and every compiler option.
+/// All methods are thread-safe.
+class ShaderBytecodeCache
+{
+public:
+    struct CreateInfo
+    {
+        /// Cache directory. It is created if it does not exist.
+        const char* Directory = nullptr;
+
+        /// The maximum total size of the entries, in bytes.
+        Uint64 MaxSize = Uint64{256} << 20;
+    };
+
+    explicit ShaderBytecodeCache(const CreateInfo& CI) noexcept(false);
+
+    // clang-format off
+    ShaderBytecodeCache             (const ShaderBytecodeCache&) = delete;
+    ShaderBytecodeCache             (ShaderBytecodeCache&&)      = delete;
+    ShaderBytecodeCache& operator = (const ShaderBytecodeCache&) = delete;
+    ShaderBytecodeCache& operator = (ShaderBytecodeCache&&)      = delete;
+    // clang-format on
+
+    /// Returns the bytecode stored with the key, or null if there is no valid entry.
+    RefCntAutoPtr<IDataBlob> Load(const ShaderBytecodeKey& Key);
+
+    /// Stores the bytecode with the key, replacing the existing entry.
+    bool Store(const ShaderBytecodeKey& Key, const void* pBytecode, size_t Size);
+
+    ShaderBytecodeCacheStats GetStats() const;
+
+    const std::string& GetDirectory() const { return m_Directory; }
+
+private:
+    std::string GetEntryPath(const ShaderBytecodeKey& Key) const;
+
+    // Scans the directory and removes the least recently used entries
+    void Evict(Uint64 TargetSize);
+
+    const std::string m_Directory;
+    const Uint64      m_MaxSize;
+
+    std::mutex m_EvictionMtx;
+
+    std::atomic<Uint64> m_Hits{0};
+    std::atomic<Uint64> m_Misses{0};
+    std::atomic<Uint64> m_Stores{0};
+    std::atomic<Uint64> m_Evictions{0};
+    std::atomic<Uint64> m_Size{0};
+};
+
+} // namespace Diligent
@@ -0,0 +1,163 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Defines serialized shader reflection data helpers
+
+// Serialized reflection data has the following layout:
+//
+//   | ShaderReflectionDataHeader |   Records   |   String table   |
+//
+// Records are a sequence of integers in native byte order written by the backend. Strings
+// are stored in the string table and are referenced by their offsets from the start
+// of the table, so the data is relocatable and can be copied as is. The table is
+// null-terminated.
+
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "BasicTypes.h"
+#include "DataBlob.h"
+#include "RefCntAutoPtr.hpp"
+
+namespace Diligent
+{
+
+/// Type of the shader resources stored in the serialized reflection data
+enum class ShaderReflectionDataType : Uint16
+{
+    SPIRV = 1,
+    GL    = 2
+};
+
+struct ShaderReflectionDataHeader
+{
+    static constexpr Uint32 MagicValue   = 0x46525344; // 'DSRF'
+    static constexpr Uint16 VersionValue = 1;
+
+    Uint32 Magic   = MagicValue;
+    Uint16 Version = VersionValue;
+    Uint16 Type    = 0;
+
+    // Size of the records, in bytes
+    Uint32 RecordsSize = 0;
+
+    // Size of the string table, in bytes
+    Uint32 StringsSize = 0;
+
+    // Hash of the bytecode the data was produced for
+    Uint64 BytecodeHash = 0;
+};
+static_assert(sizeof(ShaderReflectionDataHeader) == 24, "Unexpected reflection data header size");
+
+
+/// Writes serialized shader reflection data
+class ShaderReflectionDataWriter
+{
+public:
+    template <typename T>
+    void Write(T Value)
+    {
+        static_assert(std::is_integral<T>::value || std::is_enum<T>::value, "Only integer values can be serialized");
+        const auto* pBytes = reinterpret_cast<const Uint8*>(&Value);
+        m_Records.insert(m_Records.end(), pBytes, pBytes + sizeof(Value));
+    }
+
+    /// Adds the string to the string table and writes its offset
+    void WriteString(const char* Str);
+
+    /// Creates the data blob
+    RefCntAutoPtr<IDataBlob> Finish(ShaderReflectionDataType Type, Uint64 BytecodeHash) const;
+
+private:
+    std::vector<Uint8> m_Records;
+    std::vector<char>  m_Strings;
+};
+
+
+/// Reads serialized shader reflection data.
+
+/// All reads are bounds-checked, so that damaged data never results in
+/// out-of-range memory accesses.
+class ShaderReflectionDataReader
+{
+public:
+    /// Validates the header. If the data is not valid for the given type and bytecode hash,
+    /// logs a warning and marks the reader as invalid.
+    ShaderReflectionDataReader(const void*              pData,
+                               size_t                   Size,
+                               ShaderReflectionDataType Type,
+                               Uint64                   BytecodeHash,
+                               const char*              ShaderName);
+
+    bool IsValid() const { return m_IsValid; }
+
+    template <typename T>
+    bool Read(T& Value)
+    {
+        static_assert(std::is_integral<T>::value || std::is_enum<T>::value, "Only integer values can be deserialized");
+        if (!m_IsValid || m_RecordsSize - m_Offset < sizeof(Value))
+        {
+            m_IsValid = false;
+            return false;
+        }
+        memcpy(&Value, m_pRecords + m_Offset, sizeof(Value));
+        m_Offset += sizeof(Value);
+        return true;
+    }
+
+    /// Reads the string offset and checks that it is within the string table
+    bool ReadString(Uint32& Offset)
+    {
+        if (!Read(Offset) || Offset >= m_StringsSize)
+        {
+            m_IsValid = false;
+            return false;
+        }
+        return true;
+    }
+
+    /// Returns the size of the records that have not been read yet. Backends use it
+    /// to check the resource counts before allocating memory.
+    size_t GetRemainingSize() const { return m_IsValid ? m_RecordsSize - m_Offset : 0; }
+
+    const char* GetStrings() const { return m_pStrings; }
+    size_t      GetStringsSize() const { return m_StringsSize; }
+
+private:
+    const Uint8* m_pRecords    = nullptr;
+    const char*  m_pStrings    = nullptr;
+    size_t       m_RecordsSize = 0;
+    size_t       m_StringsSize = 0;
+    size_t       m_Offset      = 0;
+    bool         m_IsValid     = false;
+};
+
+} // namespace Diligent
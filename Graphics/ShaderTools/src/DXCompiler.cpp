@@ -41,8 +41,10 @@
 #endif
 
 #include "DataBlobImpl.hpp"
+#include "MappedFileStream.hpp"
 #include "RefCntAutoPtr.hpp"
 #include "ShaderToolsCommon.hpp"
+#include "ShaderBytecodeCache.hpp"
 
 #if D3D12_SUPPORTED
 #    include <d3d12shader.h>
@@ -67,6 +69,9 @@ namespace
 constexpr Uint32 VK_API_VERSION_1_1 = (1u << 22) | (1u << 12);
 constexpr Uint32 VK_API_VERSION_1_2 = (1u << 22) | (2u << 12);
 
+// Increment this value to invalidate all previously cached bytecode
+constexpr Uint32 BytecodeCacheVersion = 1;
+
 
 class DXCompilerImpl final : public DXCompilerBase
 {
@@ -116,6 +121,11 @@ public:
                                        IDxcBlob*                  pSrcBytecode,
                                        IDxcBlob**                 ppDstByteCode) override final;
 
+    virtual void SetBytecodeCache(ShaderBytecodeCache* pCache) override final
+    {
+        m_pBytecodeCache = pCache;
+    }
+
 private:
     DxcCreateInstanceProc Load()
     {
@@ -159,6 +169,11 @@ private:
 
     bool ValidateAndSign(DxcCreateInstanceProc CreateInstance, IDxcLibrary* library, CComPtr<IDxcBlob>& compiled, IDxcBlob** ppBlobOut) const;
 
+    // Runs the preprocessor with the same arguments, defines and include handler as Compile().
+    bool Preprocess(const CompileAttribs& Attribs, std::string& PreprocessedSource);
+
+    CComPtr<IDxcBlob> LoadCachedBytecode(const ShaderBytecodeKey& Key);
+
     enum RES_TYPE : Uint32
     {
         RES_TYPE_CBV     = 0,
@@ -194,6 +209,8 @@ private:
     // Compiler version
     UINT32 m_MajorVer = 0;
     UINT32 m_MinorVer = 0;
+
+    ShaderBytecodeCache* m_pBytecodeCache = nullptr;
 };
 
 
@@ -236,8 +253,7 @@ public:
             return E_FAIL;
         }
 
-        RefCntAutoPtr<IDataBlob> pFileData{MakeNewRCObj<DataBlobImpl>()(0)};
-        pSourceStream->ReadBlob(pFileData);
+        RefCntAutoPtr<IDataBlob> pFileData = ReadFileStreamData(pSourceStream);
 
         CComPtr<IDxcBlobEncoding> sourceBlob;
 
@@ -383,6 +399,66 @@ bool DXCompilerImpl::Compile(const CompileAttribs& Attribs)
     return true;
 }
 
+bool DXCompilerImpl::Preprocess(const CompileAttribs& Attribs, std::string& PreprocessedSource)
+{
+    auto CreateInstance = GetCreateInstaceProc();
+    if (CreateInstance == nullptr)
+        return false;
+
+    CComPtr<IDxcLibrary> library;
+    if (FAILED(CreateInstance(CLSID_DxcLibrary, IID_PPV_ARGS(&library))))
+        return false;
+
+    CComPtr<IDxcCompiler> compiler;
+    if (FAILED(CreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&compiler))))
+        return false;
+
+    CComPtr<IDxcBlobEncoding> sourceBlob;
+    if (FAILED(library->CreateBlobWithEncodingFromPinned(Attribs.Source, UINT32{Attribs.SourceLength}, CP_UTF8, &sourceBlob)))
+        return false;
+
+    DxcIncludeHandlerImpl IncludeHandler{Attribs.pShaderSourceStreamFactory, library};
+
+    CComPtr<IDxcOperationResult> result;
+    HRESULT                      hr = compiler->Preprocess(
+        sourceBlob,
+        L"",
+        Attribs.pArgs, UINT32{Attribs.ArgsCount},
+        Attribs.pDefines, UINT32{Attribs.DefinesCount},
+        Attribs.pShaderSourceStreamFactory ? &IncludeHandler : nullptr,
+        &result);
+
+    HRESULT status = E_FAIL;
+    if (FAILED(hr) || !result || FAILED(result->GetStatus(&status)) || FAILED(status))
+        return false;
+
+    CComPtr<IDxcBlob> preprocessed;
+    if (FAILED(result->GetResult(&preprocessed)) || !preprocessed)
+        return false;
+
+    PreprocessedSource.assign(static_cast<const char*>(preprocessed->GetBufferPointer()), preprocessed->GetBufferSize());
+    return true;
+}
+
+CComPtr<IDxcBlob> DXCompilerImpl::LoadCachedBytecode(const ShaderBytecodeKey& Key)
+{
+    auto pData = m_pBytecodeCache->Load(Key);
+    if (!pData)
+        return {};
+
+    auto CreateInstance = GetCreateInstaceProc();
+
+    CComPtr<IDxcLibrary> library;
+    if (CreateInstance == nullptr || FAILED(CreateInstance(CLSID_DxcLibrary, IID_PPV_ARGS(&library))))
+        return {};
+
+    CComPtr<IDxcBlobEncoding> blob;
+    if (FAILED(library->CreateBlobWithEncodingOnHeapCopy(pData->GetDataPtr(), static_cast<UINT32>(pData->GetSize()), CP_ACP, &blob)))
+        return {};
+
+    return CComPtr<IDxcBlob>{blob.p};
+}
+
 bool DXCompilerImpl::ValidateAndSign(DxcCreateInstanceProc CreateInstance, IDxcLibrary* library, CComPtr<IDxcBlob>& compiled, IDxcBlob** ppBlobOut) const
 {
     HRESULT                hr;
@@ -796,8 +872,49 @@ void DXCompilerImpl::Compile(const ShaderCreateInfo& ShaderCI,
     CA.ppBlobOut                  = &pDXIL;
     CA.ppCompilerOutput           = &pDxcLog;
 
-    auto result = Compile(CA);
-    HandleHLSLCompilerResult(result, pDxcLog.p, Source, ShaderCI.Desc.Name, ppCompilerOutput);
+    ShaderBytecodeKey CacheKey{};
+    bool              UseCache = false;
+    std::string       PreprocessedSource;
+    if (m_pBytecodeCache != nullptr)
+    {
+        // Preprocessing is much cheaper than compilation and captures the contents of all included files.
+        if (Preprocess(CA, PreprocessedSource))
+        {
+            ShaderBytecodeKeyBuilder KeyBuilder;
+            KeyBuilder
+                .AddString("DXC")
+                .AddUint(BytecodeCacheVersion)
+                .AddUint(m_MajorVer)
+                .AddUint(m_MinorVer)
+                .AddUint(static_cast<Uint32>(m_Target))
+                .AddUint(m_APIVersion)
+                .AddString(Profile)
+                .AddString(ShaderCI.EntryPoint);
+            for (const auto* Arg : DxilArgs)
+                KeyBuilder.AddBytes(Arg, wcslen(Arg) * sizeof(wchar_t));
+            KeyBuilder.AddString(PreprocessedSource);
+            CacheKey = KeyBuilder.Finish();
+            UseCache = true;
+
+            pDXIL = LoadCachedBytecode(CacheKey);
+        }
+    }
+
+    bool result = true;
+    if (!pDXIL)
+    {
+        if (UseCache)
+        {
+            // Compile the preprocessed source rather than preprocess the shader again
+            CA.Source       = PreprocessedSource.c_str();
+            CA.SourceLength = static_cast<Uint32>(PreprocessedSource.length());
+        }
+        result = Compile(CA);
+        HandleHLSLCompilerResult(result, pDxcLog.p, Source, ShaderCI.Desc.Name, ppCompilerOutput);
+
+        if (result && UseCache && pDXIL && pDXIL->GetBufferSize() > 0)
+            m_pBytecodeCache->Store(CacheKey, pDXIL->GetBufferPointer(), pDXIL->GetBufferSize());
+    }
 
     if (result && pDXIL && pDXIL->GetBufferSize() > 0)
     {
@@ -29,6 +29,7 @@
 #include <unordered_map>
 #include <memory>
 #include <array>
+#include <mutex>
 
 #if (defined(VK_USE_PLATFORM_IOS_MVK) || defined(VK_USE_PLATFORM_MACOS_MVK))
 #    include <MoltenGLSLToSPIRVConverter/GLSLToSPIRVConverter.h>
@@ -40,10 +41,13 @@
 #include "GLSLangUtils.hpp"
 #include "DebugUtilities.hpp"
 #include "DataBlobImpl.hpp"
+#include "MappedFileStream.hpp"
 #include "RefCntAutoPtr.hpp"
 #include "ShaderToolsCommon.hpp"
 #include "SPIRVTools.hpp"
+#include "ShaderBytecodeCache.hpp"
 
+#include "spirv-tools/libspirv.h"
 #include "spirv-tools/optimizer.hpp"
 
 // clang-format off
@@ -59,13 +63,24 @@ namespace Diligent
 namespace GLSLangUtils
 {
 
+namespace
+{
+
+// InitializeProcess() and FinalizeProcess() are reference-counted by glslang, but
+// are not safe to call concurrently with each other.
+std::mutex g_GlslangProcessMtx;
+
+} // namespace
+
 void InitializeGlslang()
 {
+    std::lock_guard<std::mutex> Lock{g_GlslangProcessMtx};
     ::glslang::InitializeProcess();
 }
 
 void FinalizeGlslang()
 {
+    std::lock_guard<std::mutex> Lock{g_GlslangProcessMtx};
     ::glslang::FinalizeProcess();
 }
 
@@ -297,8 +312,8 @@ public:
             return nullptr;
         }
 
-        RefCntAutoPtr<IDataBlob> pFileData(MakeNewRCObj<DataBlobImpl>()(0));
-        pSourceStream->ReadBlob(pFileData);
+        RefCntAutoPtr<IDataBlob> pFileData = ReadFileStreamData(pSourceStream);
+
         auto* pNewInclude =
             new IncludeResult{
                 headerName,
@@ -334,15 +349,90 @@ private:
     std::unordered_map<IncludeResult*, RefCntAutoPtr<IDataBlob>> m_DataBlobs;
 };
 
+// Must be incremented when the compiler options or the optimization passes change,
+// so that the bytecode compiled with the old settings is not loaded from the cache.
+// Changes in glslang and SPIRV-Tools themselves are covered by their version strings
+// that are also part of the key.
+constexpr Uint32 BytecodeCacheVersion = 1;
+
+// Preprocesses the shader and computes the bytecode cache key from the preprocessed source.
+// Returns false if the source can't be preprocessed, in which case the errors are reported
+// when the shader is compiled.
+bool ComputeBytecodeCacheKey(::glslang::TShader&       Shader,
+                             EShMessages               messages,
+                             IncluderImpl&             Includer,
+                             ShaderBytecodeKeyBuilder& KeyBuilder,
+                             std::string&              PreprocessedSource,
+                             ShaderBytecodeKey&        Key)
+{
+    TBuiltInResource Resources = InitResources();
+    if (!Shader.preprocess(&Resources, 100, ENoProfile, false, false, messages, &PreprocessedSource, Includer))
+        return false;
+
+    Key = KeyBuilder
+              .AddString("glslang")
+              .AddString(::glslang::GetGlslVersionString())
+              .AddString("SPIRV-Tools")
+              .AddString(spvSoftwareVersionDetailsString())
+              .AddUint(BytecodeCacheVersion)
+              .AddUint(messages)
+              .AddString(PreprocessedSource)
+              .Finish();
+    return true;
+}
+
+std::vector<unsigned int> LoadCachedSPIRV(ShaderBytecodeCache& Cache, const ShaderBytecodeKey& Key)
+{
+    std::vector<unsigned int> SPIRV;
+    if (auto pBytecode = Cache.Load(Key))
+    {
+        const auto* pWords = static_cast<const unsigned int*>(pBytecode->GetConstDataPtr());
+        SPIRV.assign(pWords, pWords + pBytecode->GetSize() / sizeof(unsigned int));
+    }
+    return SPIRV;
+}
+
+spv_target_env SetSpirvVersion(::glslang::TShader& Shader, EShLanguage ShLang, SpirvVersion Version)
+{
+    switch (Version)
+    {
+        case SpirvVersion::Vk100:
+            // keep default
+            return SPV_ENV_VULKAN_1_0;
+
+        case SpirvVersion::Vk110:
+            Shader.setEnvInput(::glslang::EShSourceGlsl, ShLang, ::glslang::EShClientVulkan, 110);
+            Shader.setEnvClient(::glslang::EShClientVulkan, ::glslang::EShTargetVulkan_1_1);
+            Shader.setEnvTarget(::glslang::EShTargetSpv, ::glslang::EShTargetSpv_1_3);
+            return SPV_ENV_VULKAN_1_1;
+
+        case SpirvVersion::Vk110_Spirv14:
+            Shader.setEnvInput(::glslang::EShSourceGlsl, ShLang, ::glslang::EShClientVulkan, 110);
+            Shader.setEnvClient(::glslang::EShClientVulkan, ::glslang::EShTargetVulkan_1_1);
+            Shader.setEnvTarget(::glslang::EShTargetSpv, ::glslang::EShTargetSpv_1_4);
+            return SPV_ENV_VULKAN_1_1_SPIRV_1_4;
+
+        case SpirvVersion::Vk120:
+            Shader.setEnvInput(::glslang::EShSourceGlsl, ShLang, ::glslang::EShClientVulkan, 120);
+            Shader.setEnvClient(::glslang::EShClientVulkan, ::glslang::EShTargetVulkan_1_2);
+            Shader.setEnvTarget(::glslang::EShTargetSpv, ::glslang::EShTargetSpv_1_5);
+            return SPV_ENV_VULKAN_1_2;
+
+        default:
+            UNEXPECTED("Unknown SPIRV version");
+            return SPV_ENV_VULKAN_1_0;
+    }
+}
+
 } // namespace
 
 std::vector<unsigned int> HLSLtoSPIRV(const ShaderCreateInfo& ShaderCI,
                                       const char*             ExtraDefinitions,
-                                      IDataBlob**             ppCompilerOutput)
+                                      IDataBlob**             ppCompilerOutput,
+                                      ShaderBytecodeCache*    pBytecodeCache)
 {
-    EShLanguage        ShLang = ShaderTypeToShLanguage(ShaderCI.Desc.ShaderType);
-    ::glslang::TShader Shader{ShLang};
-    EShMessages        messages = (EShMessages)(EShMsgSpvRules | EShMsgVulkanRules | EShMsgReadHlsl | EShMsgHlslLegalization);
+    EShLanguage ShLang   = ShaderTypeToShLanguage(ShaderCI.Desc.ShaderType);
+    EShMessages messages = (EShMessages)(EShMsgSpvRules | EShMsgVulkanRules | EShMsgReadHlsl | EShMsgHlslLegalization);
 
     VERIFY_EXPR(ShaderCI.SourceLanguage == SHADER_SOURCE_LANGUAGE_HLSL);
 
@@ -351,13 +441,6 @@ std::vector<unsigned int> HLSLtoSPIRV(const ShaderCreateInfo& ShaderCI,
     VERIFY(ShLang != EShLangTaskNV && ShLang != EShLangMeshNV,
            "Mesh shaders are not supported, use DXCompiler to build SPIRV from HLSL");
 
-    Shader.setEnvInput(::glslang::EShSourceHlsl, ShLang, ::glslang::EShClientVulkan, 100);
-    Shader.setEnvClient(::glslang::EShClientVulkan, ::glslang::EShTargetVulkan_1_0);
-    Shader.setEnvTarget(::glslang::EShTargetSpv, ::glslang::EShTargetSpv_1_0);
-    Shader.setHlslIoMapping(true);
-    Shader.setEntryPoint(ShaderCI.EntryPoint);
-    Shader.setEnvTargetHlslFunctionality1();
-
     RefCntAutoPtr<IDataBlob> pFileData;
     size_t                   SourceCodeLen = 0;
 
@@ -375,16 +458,59 @@ std::vector<unsigned int> HLSLtoSPIRV(const ShaderCreateInfo& ShaderCI,
         Defines += '\n';
         AppendShaderMacros(Defines, ShaderCI.Macros);
     }
-    Shader.setPreamble(Defines.c_str());
 
     const char* ShaderStrings[]       = {SourceCode};
     const int   ShaderStringLengths[] = {static_cast<int>(SourceCodeLen)};
     const char* Names[]               = {ShaderCI.FilePath != nullptr ? ShaderCI.FilePath : ""};
-    Shader.setStringsWithLengthsAndNames(ShaderStrings, ShaderStringLengths, Names, 1);
+
+    auto InitShader = [&](::glslang::TShader& Shader) {
+        Shader.setEnvInput(::glslang::EShSourceHlsl, ShLang, ::glslang::EShClientVulkan, 100);
+        Shader.setEnvClient(::glslang::EShClientVulkan, ::glslang::EShTargetVulkan_1_0);
+        Shader.setEnvTarget(::glslang::EShTargetSpv, ::glslang::EShTargetSpv_1_0);
+        Shader.setHlslIoMapping(true);
+        Shader.setEntryPoint(ShaderCI.EntryPoint);
+        Shader.setEnvTargetHlslFunctionality1();
+        Shader.setPreamble(Defines.c_str());
+        Shader.setStringsWithLengthsAndNames(ShaderStrings, ShaderStringLengths, Names, 1);
+    };
+
+    ShaderBytecodeKey CacheKey;
+    bool              UseCache = false;
+    std::string       PreprocessedSource;
+    if (pBytecodeCache != nullptr)
+    {
+        ::glslang::TShader PreprocessShader{ShLang};
+        InitShader(PreprocessShader);
+        IncluderImpl PreprocessIncluder{ShaderCI.pShaderSourceStreamFactory};
+
+        ShaderBytecodeKeyBuilder KeyBuilder;
+        KeyBuilder.AddString("HLSL").AddUint(ShaderCI.Desc.ShaderType).AddString(ShaderCI.EntryPoint);
+        UseCache = ComputeBytecodeCacheKey(PreprocessShader, messages, PreprocessIncluder, KeyBuilder, PreprocessedSource, CacheKey);
+        if (UseCache)
+        {
+            auto CachedSPIRV = LoadCachedSPIRV(*pBytecodeCache, CacheKey);
+            if (!CachedSPIRV.empty())
+                return CachedSPIRV;
+        }
+    }
+
+    ::glslang::TShader Shader{ShLang};
+    InitShader(Shader);
+
+    // On a cache miss, compile the preprocessed source rather than preprocess the shader again.
+    // The preamble and the included files are already part of it.
+    const char* CompiledSource        = UseCache ? PreprocessedSource.c_str() : SourceCode;
+    const int   CompiledSourceLen     = UseCache ? static_cast<int>(PreprocessedSource.length()) : static_cast<int>(SourceCodeLen);
+    const char* CompiledStrings[]     = {CompiledSource};
+    if (UseCache)
+    {
+        Shader.setPreamble("");
+        Shader.setStringsWithLengthsAndNames(CompiledStrings, &CompiledSourceLen, Names, 1);
+    }
 
     IncluderImpl Includer{ShaderCI.pShaderSourceStreamFactory};
 
-    auto SPIRV = CompileShaderInternal(Shader, messages, &Includer, SourceCode, SourceCodeLen, true, ppCompilerOutput);
+    auto SPIRV = CompileShaderInternal(Shader, messages, &Includer, CompiledSource, CompiledSourceLen, true, ppCompilerOutput);
     if (SPIRV.empty())
         return SPIRV;
 
@@ -397,6 +523,8 @@ std::vector<unsigned int> HLSLtoSPIRV(const ShaderCreateInfo& ShaderCI,
     std::vector<uint32_t> LegalizedSPIRV;
     if (SpirvOptimizer.Run(SPIRV.data(), SPIRV.size(), &LegalizedSPIRV))
     {
+        if (UseCache)
+            pBytecodeCache->Store(CacheKey, LegalizedSPIRV.data(), LegalizedSPIRV.size() * sizeof(LegalizedSPIRV[0]));
         return LegalizedSPIRV;
     }
     else
@@ -410,53 +538,60 @@ std::vector<unsigned int> GLSLtoSPIRV(const GLSLtoSPIRVAttribs& Attribs)
 {
     VERIFY_EXPR(Attribs.ShaderSource != nullptr && Attribs.SourceCodeLen > 0);
 
-    EShLanguage        ShLang = ShaderTypeToShLanguage(Attribs.ShaderType);
-    ::glslang::TShader Shader(ShLang);
-    spv_target_env     spvTarget = SPV_ENV_VULKAN_1_0;
-
-    switch (Attribs.Version)
-    {
-        case SpirvVersion::Vk100:
-            // keep default
-            break;
-        case SpirvVersion::Vk110:
-            Shader.setEnvInput(::glslang::EShSourceGlsl, ShLang, ::glslang::EShClientVulkan, 110);
-            Shader.setEnvClient(::glslang::EShClientVulkan, ::glslang::EShTargetVulkan_1_1);
-            Shader.setEnvTarget(::glslang::EShTargetSpv, ::glslang::EShTargetSpv_1_3);
-            spvTarget = SPV_ENV_VULKAN_1_1;
-            break;
-        case SpirvVersion::Vk110_Spirv14:
-            Shader.setEnvInput(::glslang::EShSourceGlsl, ShLang, ::glslang::EShClientVulkan, 110);
-            Shader.setEnvClient(::glslang::EShClientVulkan, ::glslang::EShTargetVulkan_1_1);
-            Shader.setEnvTarget(::glslang::EShTargetSpv, ::glslang::EShTargetSpv_1_4);
-            spvTarget = SPV_ENV_VULKAN_1_1_SPIRV_1_4;
-            break;
-        case SpirvVersion::Vk120:
-            Shader.setEnvInput(::glslang::EShSourceGlsl, ShLang, ::glslang::EShClientVulkan, 120);
-            Shader.setEnvClient(::glslang::EShClientVulkan, ::glslang::EShTargetVulkan_1_2);
-            Shader.setEnvTarget(::glslang::EShTargetSpv, ::glslang::EShTargetSpv_1_5);
-            spvTarget = SPV_ENV_VULKAN_1_2;
-            break;
-        default:
-            UNEXPECTED("Unknown SPIRV version");
-    }
-
+    EShLanguage ShLang   = ShaderTypeToShLanguage(Attribs.ShaderType);
     EShMessages messages = (EShMessages)(EShMsgSpvRules | EShMsgVulkanRules);
 
     const char* ShaderStrings[] = {Attribs.ShaderSource};
     int         Lengths[]       = {Attribs.SourceCodeLen};
-    Shader.setStringsWithLengths(ShaderStrings, Lengths, 1);
 
     std::string Defines{"#define GLSLANG\n\n"};
     if (Attribs.Macros != nullptr)
-    {
         AppendShaderMacros(Defines, Attribs.Macros);
-        Shader.setPreamble(Defines.c_str());
+
+    auto InitShader = [&](::glslang::TShader& Shader) {
+        const auto spvTarget = SetSpirvVersion(Shader, ShLang, Attribs.Version);
+        Shader.setStringsWithLengths(ShaderStrings, Lengths, 1);
+        if (Attribs.Macros != nullptr)
+            Shader.setPreamble(Defines.c_str());
+        return spvTarget;
+    };
+
+    ShaderBytecodeKey CacheKey;
+    bool              UseCache = false;
+    std::string       PreprocessedSource;
+    if (Attribs.pBytecodeCache != nullptr)
+    {
+        ::glslang::TShader PreprocessShader{ShLang};
+        InitShader(PreprocessShader);
+        IncluderImpl PreprocessIncluder{Attribs.pShaderSourceStreamFactory};
+
+        ShaderBytecodeKeyBuilder KeyBuilder;
+        KeyBuilder.AddString("GLSL").AddUint(Attribs.ShaderType).AddUint(static_cast<Uint32>(Attribs.Version)).AddUint(Attribs.AssignBindings);
+        UseCache = ComputeBytecodeCacheKey(PreprocessShader, messages, PreprocessIncluder, KeyBuilder, PreprocessedSource, CacheKey);
+        if (UseCache)
+        {
+            auto CachedSPIRV = LoadCachedSPIRV(*Attribs.pBytecodeCache, CacheKey);
+            if (!CachedSPIRV.empty())
+                return CachedSPIRV;
+        }
+    }
+
+    ::glslang::TShader Shader{ShLang};
+    const auto         spvTarget = InitShader(Shader);
+
+    // On a cache miss, compile the preprocessed source rather than preprocess the shader again
+    const char* CompiledSource        = UseCache ? PreprocessedSource.c_str() : Attribs.ShaderSource;
+    const int   CompiledSourceLen     = UseCache ? static_cast<int>(PreprocessedSource.length()) : Attribs.SourceCodeLen;
+    const char* CompiledStrings[]     = {CompiledSource};
+    if (UseCache)
+    {
+        Shader.setPreamble("");
+        Shader.setStringsWithLengths(CompiledStrings, &CompiledSourceLen, 1);
     }
 
     IncluderImpl Includer{Attribs.pShaderSourceStreamFactory};
 
-    auto SPIRV = CompileShaderInternal(Shader, messages, &Includer, Attribs.ShaderSource, Attribs.SourceCodeLen, Attribs.AssignBindings, Attribs.ppCompilerOutput);
+    auto SPIRV = CompileShaderInternal(Shader, messages, &Includer, CompiledSource, CompiledSourceLen, Attribs.AssignBindings, Attribs.ppCompilerOutput);
     if (SPIRV.empty())
         return SPIRV;
 
@@ -466,6 +601,8 @@ std::vector<unsigned int> GLSLtoSPIRV(const GLSLtoSPIRVAttribs& Attribs)
     std::vector<uint32_t> OptimizedSPIRV;
     if (SpirvOptimizer.Run(SPIRV.data(), SPIRV.size(), &OptimizedSPIRV))
     {
+        if (UseCache)
+            Attribs.pBytecodeCache->Store(CacheKey, OptimizedSPIRV.data(), OptimizedSPIRV.size() * sizeof(OptimizedSPIRV[0]));
         return OptimizedSPIRV;
     }
     else
@@ -0,0 +1,1067 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "SPIRVReflection.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "spirv.hpp"
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+// Defined in SPIRVShaderResources.cpp
+spv::ExecutionModel ShaderTypeToSpvExecutionModel(SHADER_TYPE ShaderType);
+
+namespace
+{
+
+// Reflects resources the same way SPIRV-Cross does in Compiler::get_shader_resources(),
+// but only records the handful of instructions that are needed for that:
+// names, decorations, types, constants and global variables.
+// All instructions that define ids precede the first function, so parsing stops there.
+class SPIRVModuleReflector
+{
+public:
+    SPIRVModuleReflector(const std::vector<uint32_t>& SPIRV,
+                         SHADER_TYPE                  ShaderType,
+                         SPIRVReflection&             Reflection) :
+        m_SPIRV{SPIRV},
+        m_ShaderType{ShaderType},
+        m_Reflection{Reflection}
+    {}
+
+    bool Reflect()
+    {
+        return ParseInstructions() && ProcessEntryPoint() && ProcessVariables();
+    }
+
+private:
+    struct IdInfo
+    {
+        // Word offset of the instruction that defines the id (types, constants and variables only)
+        uint32_t InstrOffset = 0;
+
+        const char* Name     = nullptr;
+        const char* Semantic = nullptr;
+
+        uint32_t BindingOffset       = 0;
+        uint32_t DescriptorSetOffset = 0;
+        uint32_t LocationOffset      = 0;
+        uint32_t ArrayStride         = 0;
+
+        bool HasArrayStride   = false;
+        bool BuiltIn          = false;
+        bool HasBuiltInMember = false;
+        bool Block            = false;
+        bool BufferBlock      = false;
+        bool NonWritable      = false;
+        bool IsWorkgroupSize  = false;
+        bool InInterface      = false;
+    };
+
+    struct MemberDecoration
+    {
+        uint32_t StructId;
+        uint32_t Member;
+        uint32_t Decoration;
+        uint32_t Value;
+    };
+
+    struct MemberDecorations
+    {
+        bool     HasOffset       = false;
+        uint32_t Offset          = 0;
+        bool     HasMatrixStride = false;
+        uint32_t MatrixStride    = 0;
+        bool     RowMajor        = false;
+        bool     ColMajor        = false;
+        bool     NonWritable     = false;
+    };
+
+    struct EntryPointInfo
+    {
+        uint32_t    Model;
+        uint32_t    Id;
+        const char* Name;
+        uint32_t    InterfaceStart;
+        uint32_t    InterfaceEnd;
+    };
+
+    struct LocalSizeInfo
+    {
+        uint32_t EntryPointId;
+        uint32_t Size[3];
+    };
+
+    struct ImageInfo
+    {
+        uint32_t Dim     = 0;
+        bool     Arrayed = false;
+        bool     MS      = false;
+        uint32_t Sampled = 0;
+    };
+
+    // Minimal word count of the type instructions whose operands are accessed
+    static uint32_t GetMinTypeWordCount(spv::Op OpCode)
+    {
+        switch (OpCode)
+        {
+            // clang-format off
+            case spv::OpTypeImage:        return 9;
+            case spv::OpTypeInt:          return 4;
+            case spv::OpTypeVector:       return 4;
+            case spv::OpTypeMatrix:       return 4;
+            case spv::OpTypeArray:        return 4;
+            case spv::OpTypePointer:      return 4;
+            case spv::OpTypeFloat:        return 3;
+            case spv::OpTypeRuntimeArray: return 3;
+            case spv::OpTypeSampledImage: return 3;
+            default:                      return 2;
+                // clang-format on
+        }
+    }
+
+    uint32_t GetOpCode(uint32_t InstrOffset) const
+    {
+        return m_SPIRV[InstrOffset] & spv::OpCodeMask;
+    }
+
+    uint32_t GetWordCount(uint32_t InstrOffset) const
+    {
+        return m_SPIRV[InstrOffset] >> spv::WordCountShift;
+    }
+
+    IdInfo* GetId(uint32_t Id)
+    {
+        return Id < m_Ids.size() ? &m_Ids[Id] : nullptr;
+    }
+
+    // Returns the offset of the instruction that defines the id, or 0 if the id is not defined by a recorded instruction
+    uint32_t GetDefinition(uint32_t Id) const
+    {
+        return Id < m_Ids.size() ? m_Ids[Id].InstrOffset : 0;
+    }
+
+    // Reads null-terminated literal string that starts at word Offset and must end before word End.
+    const char* ReadString(uint32_t Offset, uint32_t End, uint32_t* pNextWord = nullptr) const
+    {
+        if (Offset >= End)
+            return nullptr;
+
+        const auto* Str    = reinterpret_cast<const char*>(&m_SPIRV[Offset]);
+        const auto  MaxLen = size_t{End - Offset} * sizeof(uint32_t);
+        const auto* pNull  = static_cast<const char*>(memchr(Str, 0, MaxLen));
+        if (pNull == nullptr)
+            return nullptr;
+
+        if (pNextWord != nullptr)
+            *pNextWord = Offset + static_cast<uint32_t>((pNull - Str) / sizeof(uint32_t) + 1);
+        return Str;
+    }
+
+    bool ParseInstructions();
+    bool ProcessEntryPoint();
+    bool ProcessVariables();
+
+    MemberDecorations GetMemberDecorations(uint32_t StructId, uint32_t Member) const;
+
+    bool AllMembersNonWritable(uint32_t StructId) const;
+
+    // Strips array types and returns the id of the element type. Sets ArraySize to the
+    // size of the innermost array, which is what SPIRV-Cross reports as type.array[0].
+    bool GetArrayElementType(uint32_t TypeId, uint32_t& ElementTypeId, uint32_t* pArraySize, uint32_t* pNumDims) const;
+
+    bool GetArrayLength(uint32_t ArrayTypeInstr, uint32_t& Length) const;
+
+    bool GetImageInfo(uint32_t TypeId, ImageInfo& Info) const;
+
+    bool GetDeclaredStructSize(uint32_t StructId, Uint32& Size, Uint32 Depth) const;
+    bool GetDeclaredStructMemberSize(uint32_t StructId, uint32_t Member, Uint32& Size, Uint32 Depth) const;
+    bool GetRuntimeArrayStride(uint32_t StructId, Uint32& Stride) const;
+
+    bool IsSSBOInstanceNameSignificant() const;
+
+    bool InitResource(uint32_t VarId, uint32_t BaseTypeId, uint32_t ArraySize, SPIRVShaderResourceAttribs::ResourceType Type, std::vector<SPIRVReflection::Resource>& Resources);
+
+    // Returns false for names that SPIRV-Cross may alter when they are set
+    static bool IsPlainIdentifier(const char* Name);
+
+    const char* GetName(uint32_t Id) const
+    {
+        const auto* Name = Id < m_Ids.size() ? m_Ids[Id].Name : nullptr;
+        return Name != nullptr ? Name : "";
+    }
+
+    static constexpr Uint32 MaxStructNestingDepth = 64;
+
+    const std::vector<uint32_t>& m_SPIRV;
+    const SHADER_TYPE            m_ShaderType;
+    SPIRVReflection&             m_Reflection;
+
+    uint32_t m_Version = 0;
+
+    bool m_SourceKnown  = false;
+    bool m_IsHLSLSource = false;
+
+    std::vector<IdInfo>           m_Ids;
+    std::vector<MemberDecoration> m_MemberDecorations;
+    std::vector<EntryPointInfo>   m_EntryPoints;
+    std::vector<LocalSizeInfo>    m_LocalSizes;
+    std::vector<uint32_t>         m_GlobalVariables;
+
+    uint32_t m_WorkgroupSizeConstant = 0;
+
+    bool m_SSBOInstanceName = false;
+
+    const EntryPointInfo* m_pEntryPoint = nullptr;
+};
+
+bool SPIRVModuleReflector::ParseInstructions()
+{
+    // https://www.khronos.org/registry/spir-v/specs/unified1/SPIRV.html#_a_id_physicallayout_a_physical_layout_of_a_spir_v_module_and_instruction
+    constexpr uint32_t HeaderSize = 5;
+    if (m_SPIRV.size() < HeaderSize || m_SPIRV.size() > std::numeric_limits<uint32_t>::max())
+        return false;
+    if (m_SPIRV[0] != spv::MagicNumber)
+        return false;
+
+    m_Version = m_SPIRV[1];
+
+    const auto Bound = m_SPIRV[3];
+    // Every id is defined by an instruction of at least two words
+    if (Bound > m_SPIRV.size())
+        return false;
+    m_Ids.resize(Bound);
+
+    const auto NumWords = static_cast<uint32_t>(m_SPIRV.size());
+    for (uint32_t Offset = HeaderSize; Offset < NumWords;)
+    {
+        const auto WordCount = GetWordCount(Offset);
+        if (WordCount == 0 || WordCount > NumWords - Offset)
+            return false;
+
+        const auto  OpCode = static_cast<spv::Op>(GetOpCode(Offset));
+        const auto  End    = Offset + WordCount;
+        const auto* ops    = &m_SPIRV[Offset + 1];
+        const auto  Length = WordCount - 1;
+
+        switch (OpCode)
+        {
+            case spv::OpSource:
+                if (Length < 1)
+                    return false;
+                switch (ops[0])
+                {
+                    case spv::SourceLanguageESSL:
+                    case spv::SourceLanguageGLSL:
+                        m_SourceKnown  = true;
+                        m_IsHLSLSource = false;
+                        break;
+
+                    case spv::SourceLanguageHLSL:
+                        m_SourceKnown  = true;
+                        m_IsHLSLSource = true;
+                        break;
+
+                    default:
+                        // Same as SPIRV-Cross: the language is unknown, but HLSL flag is not reset
+                        m_SourceKnown = false;
+                }
+                break;
+
+            case spv::OpName:
+            {
+                auto* pId = Length >= 2 ? GetId(ops[0]) : nullptr;
+                if (pId == nullptr)
+                    return false;
+                pId->Name = ReadString(Offset + 2, End);
+                if (pId->Name == nullptr)
+                    return false;
+                break;
+            }
+
+            case spv::OpExtension:
+            {
+                const auto* Extension = ReadString(Offset + 1, End);
+                if (Extension == nullptr)
+                    return false;
+                if (strcmp(Extension, "SPV_GOOGLE_hlsl_functionality1") == 0)
+                    m_Reflection.HlslFunctionality1 = true;
+                break;
+            }
+
+            case spv::OpEntryPoint:
+            {
+                if (Length < 3)
+                    return false;
+                EntryPointInfo EntryPoint{};
+                EntryPoint.Model = ops[0];
+                EntryPoint.Id    = ops[1];
+                EntryPoint.Name  = ReadString(Offset + 3, End, &EntryPoint.InterfaceStart);
+                if (EntryPoint.Name == nullptr)
+                    return false;
+                EntryPoint.InterfaceEnd = End;
+                m_EntryPoints.push_back(EntryPoint);
+                break;
+            }
+
+            case spv::OpExecutionMode:
+                if (Length < 2)
+                    return false;
+                if (ops[1] == spv::ExecutionModeLocalSize)
+                {
+                    if (Length < 5)
+                        return false;
+                    m_LocalSizes.push_back({ops[0], {ops[2], ops[3], ops[4]}});
+                }
+                break;
+
+            case spv::OpDecorate:
+            case spv::OpDecorateId:
+            {
+                auto* pId = Length >= 2 ? GetId(ops[0]) : nullptr;
+                if (pId == nullptr)
+                    return false;
+
+                // Offset of the first decoration literal, see ParsedIR::meta::decoration_word_offset
+                const auto LiteralOffset = Length >= 3 ? Offset + 3 : 0;
+                const auto Literal       = Length >= 3 ? ops[2] : 0;
+                switch (ops[1])
+                {
+                    // clang-format off
+                    case spv::DecorationBinding:       pId->BindingOffset       = LiteralOffset; break;
+                    case spv::DecorationDescriptorSet: pId->DescriptorSetOffset = LiteralOffset; break;
+                    case spv::DecorationLocation:      pId->LocationOffset      = LiteralOffset; break;
+                    case spv::DecorationBlock:         pId->Block               = true;          break;
+                    case spv::DecorationBufferBlock:   pId->BufferBlock         = true;          break;
+                    case spv::DecorationNonWritable:   pId->NonWritable         = true;          break;
+                        // clang-format on
+
+                    case spv::DecorationArrayStride:
+                        pId->HasArrayStride = true;
+                        pId->ArrayStride    = Literal;
+                        break;
+
+                    case spv::DecorationBuiltIn:
+                        pId->BuiltIn = true;
+                        if (Literal == spv::BuiltInWorkgroupSize)
+                            pId->IsWorkgroupSize = true;
+                        break;
+                }
+                break;
+            }
+
+            case spv::OpDecorateString:
+                if (Length >= 3 && ops[1] == spv::DecorationHlslSemanticGOOGLE)
+                {
+                    auto* pId = GetId(ops[0]);
+                    if (pId == nullptr)
+                        return false;
+                    pId->Semantic = ReadString(Offset + 3, End);
+                    if (pId->Semantic == nullptr)
+                        return false;
+                }
+                break;
+
+            case spv::OpMemberDecorate:
+            {
+                auto* pId = Length >= 3 ? GetId(ops[0]) : nullptr;
+                if (pId == nullptr)
+                    return false;
+                if (ops[2] == spv::DecorationBuiltIn)
+                    pId->HasBuiltInMember = true;
+                m_MemberDecorations.push_back({ops[0], ops[1], ops[2], Length >= 4 ? ops[3] : 0});
+                break;
+            }
+
+            case spv::OpGroupDecorate:
+            case spv::OpGroupMemberDecorate:
+                // Decoration groups are deprecated and are not emitted by modern compilers
+                return false;
+
+            case spv::OpTypeVoid:
+            case spv::OpTypeBool:
+            case spv::OpTypeInt:
+            case spv::OpTypeFloat:
+            case spv::OpTypeVector:
+            case spv::OpTypeMatrix:
+            case spv::OpTypeImage:
+            case spv::OpTypeSampler:
+            case spv::OpTypeSampledImage:
+            case spv::OpTypeArray:
+            case spv::OpTypeRuntimeArray:
+            case spv::OpTypeStruct:
+            case spv::OpTypeOpaque:
+            case spv::OpTypePointer:
+            case spv::OpTypeFunction:
+            case spv::OpTypeAccelerationStructureKHR:
+            case spv::OpTypeRayQueryKHR:
+            {
+                auto* pId = Length >= 1 ? GetId(ops[0]) : nullptr;
+                if (pId == nullptr || WordCount < GetMinTypeWordCount(OpCode))
+                    return false;
+                pId->InstrOffset = Offset;
+                break;
+            }
+
+            case spv::OpConstant:
+            case spv::OpSpecConstant:
+            case spv::OpConstantComposite:
+            case spv::OpSpecConstantComposite:
+            case spv::OpVariable:
+            {
+                // Result type, result id and the value or storage class
+                auto* pId = Length >= 3 ? GetId(ops[1]) : nullptr;
+                if (pId == nullptr)
+                    return false;
+                pId->InstrOffset = Offset;
+
+                if (OpCode == spv::OpVariable)
+                {
+                    if (ops[2] != spv::StorageClassFunction)
+                        m_GlobalVariables.push_back(ops[1]);
+                }
+                else if ((OpCode == spv::OpConstantComposite || OpCode == spv::OpSpecConstantComposite) && pId->IsWorkgroupSize)
+                {
+                    // Decorations always precede constants. If there are several
+                    // such constants, SPIRV-Cross uses the last one.
+                    m_WorkgroupSizeConstant = ops[1];
+                }
+                break;
+            }
+
+            case spv::OpFunction:
+                // Functions follow all global declarations
+                Offset = NumWords;
+                continue;
+
+            default:
+                break;
+        }
+
+        Offset = End;
+    }
+
+    std::sort(m_MemberDecorations.begin(), m_MemberDecorations.end(),
+              [](const MemberDecoration& lhs, const MemberDecoration& rhs) {
+                  return lhs.StructId < rhs.StructId || (lhs.StructId == rhs.StructId && lhs.Member < rhs.Member);
+              });
+
+    return true;
+}
+
+bool SPIRVModuleReflector::ProcessEntryPoint()
+{
+    const auto ExecutionModel = static_cast<uint32_t>(ShaderTypeToSpvExecutionModel(m_ShaderType));
+    for (const auto& EntryPoint : m_EntryPoints)
+    {
+        if (EntryPoint.Model == ExecutionModel)
+        {
+            // Let SPIRV-Cross path report the ambiguity
+            if (m_pEntryPoint != nullptr)
+                return false;
+            m_pEntryPoint = &EntryPoint;
+        }
+    }
+    if (m_pEntryPoint == nullptr)
+        return false;
+
+    m_Reflection.EntryPoint = m_pEntryPoint->Name;
+
+    for (auto Offset = m_pEntryPoint->InterfaceStart; Offset < m_pEntryPoint->InterfaceEnd; ++Offset)
+    {
+        auto* pId = GetId(m_SPIRV[Offset]);
+        if (pId == nullptr)
+            return false;
+        pId->InInterface = true;
+    }
+
+    m_Reflection.ComputeGroupSize = {};
+    if (m_WorkgroupSizeConstant != 0)
+    {
+        // WorkgroupSize built-in takes precedence over LocalSize execution mode
+        const auto Instr = GetDefinition(m_WorkgroupSizeConstant);
+        if (GetWordCount(Instr) != 6)
+            return false;
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            const auto Component = GetDefinition(m_SPIRV[Instr + 3 + i]);
+            if (Component == 0)
+                return false;
+            const auto OpCode = GetOpCode(Component);
+            if ((OpCode != spv::OpConstant && OpCode != spv::OpSpecConstant) || GetWordCount(Component) < 4)
+                return false;
+            m_Reflection.ComputeGroupSize[i] = m_SPIRV[Component + 3];
+        }
+    }
+    else
+    {
+        for (const auto& LocalSize : m_LocalSizes)
+        {
+            if (LocalSize.EntryPointId == m_pEntryPoint->Id)
+            {
+                for (uint32_t i = 0; i < 3; ++i)
+                    m_Reflection.ComputeGroupSize[i] = LocalSize.Size[i];
+            }
+        }
+    }
+
+    return true;
+}
+
+SPIRVModuleReflector::MemberDecorations SPIRVModuleReflector::GetMemberDecorations(uint32_t StructId, uint32_t Member) const
+{
+    MemberDecorations Decorations;
+
+    auto it = std::lower_bound(m_MemberDecorations.begin(), m_MemberDecorations.end(), MemberDecoration{StructId, Member, 0, 0},
+                               [](const MemberDecoration& lhs, const MemberDecoration& rhs) {
+                                   return lhs.StructId < rhs.StructId || (lhs.StructId == rhs.StructId && lhs.Member < rhs.Member);
+                               });
+    for (; it != m_MemberDecorations.end() && it->StructId == StructId && it->Member == Member; ++it)
+    {
+        switch (it->Decoration)
+        {
+            case spv::DecorationOffset:
+                Decorations.HasOffset = true;
+                Decorations.Offset    = it->Value;
+                break;
+
+            case spv::DecorationMatrixStride:
+                Decorations.HasMatrixStride = true;
+                Decorations.MatrixStride    = it->Value;
+                break;
+
+            // clang-format off
+            case spv::DecorationRowMajor:    Decorations.RowMajor    = true; break;
+            case spv::DecorationColMajor:    Decorations.ColMajor    = true; break;
+            case spv::DecorationNonWritable: Decorations.NonWritable = true; break;
+                // clang-format on
+        }
+    }
+
+    return Decorations;
+}
+
+bool SPIRVModuleReflector::AllMembersNonWritable(uint32_t StructId) const
+{
+    const auto Instr      = GetDefinition(StructId);
+    const auto NumMembers = GetWordCount(Instr) - 2;
+    if (NumMembers == 0)
+        return false;
+
+    for (uint32_t Member = 0; Member < NumMembers; ++Member)
+    {
+        if (!GetMemberDecorations(StructId, Member).NonWritable)
+            return false;
+    }
+    return true;
+}
+
+bool SPIRVModuleReflector::GetArrayLength(uint32_t ArrayTypeInstr, uint32_t& Length) const
+{
+    if (GetOpCode(ArrayTypeInstr) == spv::OpTypeRuntimeArray)
+    {
+        Length = 0;
+        return true;
+    }
+
+    VERIFY_EXPR(GetOpCode(ArrayTypeInstr) == spv::OpTypeArray);
+    if (GetWordCount(ArrayTypeInstr) < 4)
+        return false;
+
+    // Specialization constants are not literal array sizes
+    const auto Constant = GetDefinition(m_SPIRV[ArrayTypeInstr + 3]);
+    if (Constant == 0 || GetOpCode(Constant) != spv::OpConstant || GetWordCount(Constant) < 4)
+        return false;
+
+    Length = m_SPIRV[Constant + 3];
+    return true;
+}
+
+bool SPIRVModuleReflector::GetArrayElementType(uint32_t TypeId, uint32_t& ElementTypeId, uint32_t* pArraySize, uint32_t* pNumDims) const
+{
+    if (pArraySize != nullptr)
+        *pArraySize = 1;
+    if (pNumDims != nullptr)
+        *pNumDims = 0;
+
+    for (Uint32 Depth = 0; Depth < MaxStructNestingDepth; ++Depth)
+    {
+        const auto Instr = GetDefinition(TypeId);
+        if (Instr == 0)
+            return false;
+
+        const auto OpCode = GetOpCode(Instr);
+        if (OpCode != spv::OpTypeArray && OpCode != spv::OpTypeRuntimeArray)
+        {
+            ElementTypeId = TypeId;
+            return true;
+        }
+
+        if (GetWordCount(Instr) < 3)
+            return false;
+
+        if (pArraySize != nullptr && !GetArrayLength(Instr, *pArraySize))
+            return false;
+        if (pNumDims != nullptr)
+            ++(*pNumDims);
+
+        TypeId = m_SPIRV[Instr + 2];
+    }
+
+    return false;
+}
+
+bool SPIRVModuleReflector::GetImageInfo(uint32_t TypeId, ImageInfo& Info) const
+{
+    auto Instr = GetDefinition(TypeId);
+    if (Instr != 0 && GetOpCode(Instr) == spv::OpTypeSampledImage)
+    {
+        if (GetWordCount(Instr) < 3)
+            return false;
+        Instr = GetDefinition(m_SPIRV[Instr + 2]);
+    }
+
+    if (Instr == 0 || GetOpCode(Instr) != spv::OpTypeImage || GetWordCount(Instr) < 9)
+        return false;
+
+    // OpTypeImage Result SampledType Dim Depth Arrayed MS Sampled Format [Access]
+    Info.Dim     = m_SPIRV[Instr + 3];
+    Info.Arrayed = m_SPIRV[Instr + 5] != 0;
+    Info.MS      = m_SPIRV[Instr + 6] != 0;
+    Info.Sampled = m_SPIRV[Instr + 7];
+    return true;
+}
+
+// Follows Compiler::get_declared_struct_size()
+bool SPIRVModuleReflector::GetDeclaredStructSize(uint32_t StructId, Uint32& Size, Uint32 Depth) const
+{
+    const auto Instr = GetDefinition(StructId);
+    if (Instr == 0 || GetOpCode(Instr) != spv::OpTypeStruct || Depth >= MaxStructNestingDepth)
+        return false;
+
+    const auto NumMembers = GetWordCount(Instr) - 2;
+    if (NumMembers == 0)
+        return false;
+
+    // Offsets can be declared out of order, so use the member with the highest offset
+    uint32_t LastMember    = 0;
+    uint32_t HighestOffset = 0;
+    for (uint32_t Member = 0; Member < NumMembers; ++Member)
+    {
+        const auto Decorations = GetMemberDecorations(StructId, Member);
+        if (!Decorations.HasOffset)
+            return false;
+        if (Decorations.Offset > HighestOffset)
+        {
+            HighestOffset = Decorations.Offset;
+            LastMember    = Member;
+        }
+    }
+
+    Uint32 MemberSize = 0;
+    if (!GetDeclaredStructMemberSize(StructId, LastMember, MemberSize, Depth))
+        return false;
+
+    Size = HighestOffset + MemberSize;
+    return true;
+}
+
+// Follows Compiler::get_declared_struct_member_size()
+bool SPIRVModuleReflector::GetDeclaredStructMemberSize(uint32_t StructId, uint32_t Member, Uint32& Size, Uint32 Depth) const
+{
+    const auto StructInstr  = GetDefinition(StructId);
+    const auto MemberTypeId = m_SPIRV[StructInstr + 2 + Member];
+    const auto Instr        = GetDefinition(MemberTypeId);
+    if (Instr == 0)
+        return false;
+
+    switch (GetOpCode(Instr))
+    {
+        case spv::OpTypeArray:
+        case spv::OpTypeRuntimeArray:
+        {
+            // Array stride is decorated on the array type, and the size of the outermost dimension is used
+            uint32_t Length = 0;
+            if (!m_Ids[MemberTypeId].HasArrayStride || !GetArrayLength(Instr, Length))
+                return false;
+            Size = m_Ids[MemberTypeId].ArrayStride * Length;
+            return true;
+        }
+
+        case spv::OpTypeStruct:
+            return GetDeclaredStructSize(MemberTypeId, Size, Depth + 1);
+
+        case spv::OpTypeInt:
+        case spv::OpTypeFloat:
+            Size = m_SPIRV[Instr + 2] / 8;
+            return true;
+
+        case spv::OpTypeVector:
+        {
+            const auto ComponentInstr = GetDefinition(m_SPIRV[Instr + 2]);
+            if (ComponentInstr == 0 || (GetOpCode(ComponentInstr) != spv::OpTypeInt && GetOpCode(ComponentInstr) != spv::OpTypeFloat))
+                return false;
+            Size = m_SPIRV[Instr + 3] * (m_SPIRV[ComponentInstr + 2] / 8);
+            return true;
+        }
+
+        case spv::OpTypeMatrix:
+        {
+            const auto ColumnInstr = GetDefinition(m_SPIRV[Instr + 2]);
+            if (ColumnInstr == 0 || GetOpCode(ColumnInstr) != spv::OpTypeVector)
+                return false;
+            const auto VecSize    = m_SPIRV[ColumnInstr + 3];
+            const auto NumColumns = m_SPIRV[Instr + 3];
+
+            const auto Decorations = GetMemberDecorations(StructId, Member);
+            if (!Decorations.HasMatrixStride)
+                return false;
+            if (Decorations.RowMajor)
+                Size = Decorations.MatrixStride * VecSize;
+            else if (Decorations.ColMajor)
+                Size = Decorations.MatrixStride * NumColumns;
+            else
+                return false;
+            return true;
+        }
+
+        default:
+            // Booleans, opaque types and physical pointers
+            return false;
+    }
+}
+
+// Follows Compiler::get_declared_struct_size_runtime_array(Type, 1) - Compiler::get_declared_struct_size(Type)
+bool SPIRVModuleReflector::GetRuntimeArrayStride(uint32_t StructId, Uint32& Stride) const
+{
+    Stride = 0;
+
+    const auto Instr          = GetDefinition(StructId);
+    const auto LastMemberType = m_SPIRV[Instr + GetWordCount(Instr) - 1];
+
+    // SPIRV-Cross checks the innermost dimension (type.array[0]) of the last declared member
+    uint32_t ElementType = 0;
+    uint32_t NumDims     = 0;
+    if (!GetArrayElementType(LastMemberType, ElementType, nullptr, &NumDims))
+        return false;
+    if (NumDims == 0)
+        return true;
+
+    auto InnermostArray = LastMemberType;
+    for (uint32_t Dim = 1; Dim < NumDims; ++Dim)
+        InnermostArray = m_SPIRV[GetDefinition(InnermostArray) + 2];
+    if (GetOpCode(GetDefinition(InnermostArray)) != spv::OpTypeRuntimeArray)
+        return true;
+
+    if (!m_Ids[LastMemberType].HasArrayStride)
+        return false;
+    Stride = m_Ids[LastMemberType].ArrayStride;
+    return true;
+}
+
+// Follows Compiler::reflection_ssbo_instance_name_is_significant()
+bool SPIRVModuleReflector::IsSSBOInstanceNameSignificant() const
+{
+    if (m_SourceKnown)
+    {
+        // UAVs from HLSL source tend to be declared in a way where the type is reused,
+        // but the instance name is significant.
+        return m_IsHLSLSource;
+    }
+
+    // If the block type is aliased, assume HLSL-style UAV declarations
+    std::vector<uint32_t> SSBOTypes;
+    for (auto VarId : m_GlobalVariables)
+    {
+        const auto PointerInstr = GetDefinition(m_SPIRV[GetDefinition(VarId) + 1]);
+        if (PointerInstr == 0 || GetOpCode(PointerInstr) != spv::OpTypePointer)
+            continue;
+
+        uint32_t BaseType = 0;
+        if (!GetArrayElementType(m_SPIRV[PointerInstr + 3], BaseType, nullptr, nullptr))
+            continue;
+
+        const auto Storage = m_SPIRV[GetDefinition(VarId) + 3];
+        if (Storage == spv::StorageClassStorageBuffer || (Storage == spv::StorageClassUniform && m_Ids[BaseType].BufferBlock))
+        {
+            if (std::find(SSBOTypes.begin(), SSBOTypes.end(), BaseType) != SSBOTypes.end())
+                return true;
+            SSBOTypes.push_back(BaseType);
+        }
+    }
+    return false;
+}
+
+bool SPIRVModuleReflector::IsPlainIdentifier(const char* Name)
+{
+    // Depending on the version, SPIRV-Cross replaces invalid characters, collapses
+    // double underscores and drops names reserved for temporaries (_<digit>...).
+    if (Name[0] == 0)
+        return true;
+    if (Name[0] >= '0' && Name[0] <= '9')
+        return false;
+    if (Name[0] == '_' && Name[1] >= '0' && Name[1] <= '9')
+        return false;
+
+    for (const auto* c = Name; *c != 0; ++c)
+    {
+        const bool IsAlphaNumeric = (*c >= 'a' && *c <= 'z') || (*c >= 'A' && *c <= 'Z') || (*c >= '0' && *c <= '9');
+        if (!IsAlphaNumeric && *c != '_')
+            return false;
+        if (c[0] == '_' && c[1] == '_')
+            return false;
+    }
+    return true;
+}
+
+bool SPIRVModuleReflector::InitResource(uint32_t                                 VarId,
+                                        uint32_t                                 BaseTypeId,
+                                        uint32_t                                 ArraySize,
+                                        SPIRVShaderResourceAttribs::ResourceType Type,
+                                        std::vector<SPIRVReflection::Resource>&  Resources)
+{
+    const auto& Var = m_Ids[VarId];
+
+    SPIRVReflection::Resource Res;
+    Res.Type                          = Type;
+    Res.ArraySize                     = ArraySize;
+    Res.BindingDecorationOffset       = Var.BindingOffset;
+    Res.DescriptorSetDecorationOffset = Var.DescriptorSetOffset;
+
+    const auto BaseOpCode = GetOpCode(GetDefinition(BaseTypeId));
+    if (BaseOpCode == spv::OpTypeImage || BaseOpCode == spv::OpTypeSampledImage)
+    {
+        ImageInfo Info;
+        if (!GetImageInfo(BaseTypeId, Info))
+            return false;
+
+        switch (Info.Dim)
+        {
+            // clang-format off
+            case spv::Dim1D:     Res.ResourceDim = Info.Arrayed ? RESOURCE_DIM_TEX_1D_ARRAY : RESOURCE_DIM_TEX_1D;     break;
+            case spv::Dim2D:     Res.ResourceDim = Info.Arrayed ? RESOURCE_DIM_TEX_2D_ARRAY : RESOURCE_DIM_TEX_2D;     break;
+            case spv::Dim3D:     Res.ResourceDim = RESOURCE_DIM_TEX_3D;                                                 break;
+            case spv::DimCube:   Res.ResourceDim = Info.Arrayed ? RESOURCE_DIM_TEX_CUBE_ARRAY : RESOURCE_DIM_TEX_CUBE; break;
+            case spv::DimBuffer: Res.ResourceDim = RESOURCE_DIM_BUFFER;                                                 break;
+            default:             Res.ResourceDim = RESOURCE_DIM_UNDEFINED;
+                // clang-format on
+        }
+        Res.IsMS = Info.MS;
+    }
+
+    const char* VarName = GetName(VarId);
+    if (!IsPlainIdentifier(VarName))
+        return false;
+
+    if (Type == SPIRVShaderResourceAttribs::ResourceType::UniformBuffer ||
+        Type == SPIRVShaderResourceAttribs::ResourceType::ROStorageBuffer ||
+        Type == SPIRVShaderResourceAttribs::ResourceType::RWStorageBuffer)
+    {
+        const bool IsUB = Type == SPIRVShaderResourceAttribs::ResourceType::UniformBuffer;
+
+        // See GetUBName() and Compiler::get_remapped_declared_block_name()
+        if ((IsUB && m_IsHLSLSource && VarName[0] != 0) || (!IsUB && m_SSBOInstanceName))
+        {
+            Res.Name = VarName[0] != 0 ? std::string{VarName} : "_" + std::to_string(VarId);
+        }
+        else
+        {
+            const char* BlockName = GetName(BaseTypeId);
+            if (!IsPlainIdentifier(BlockName))
+                return false;
+            if (BlockName[0] != 0)
+                Res.Name = BlockName;
+            else if (VarName[0] != 0)
+                Res.Name = VarName;
+            else
+                Res.Name = "_" + std::to_string(BaseTypeId) + "_" + std::to_string(VarId);
+        }
+
+        if (!GetDeclaredStructSize(BaseTypeId, Res.BufferStaticSize, 0))
+            return false;
+
+        if (!IsUB && !GetRuntimeArrayStride(BaseTypeId, Res.BufferStride))
+            return false;
+    }
+    else
+    {
+        Res.Name = VarName;
+    }
+
+    Resources.emplace_back(std::move(Res));
+    return true;
+}
+
+// Follows Compiler::get_shader_resources()
+bool SPIRVModuleReflector::ProcessVariables()
+{
+    m_Reflection.IsHLSLSource = m_IsHLSLSource;
+    m_SSBOInstanceName        = IsSSBOInstanceNameSignificant();
+
+    for (auto VarId : m_GlobalVariables)
+    {
+        const auto VarInstr     = GetDefinition(VarId);
+        const auto PointerInstr = GetDefinition(m_SPIRV[VarInstr + 1]);
+        if (PointerInstr == 0 || GetOpCode(PointerInstr) != spv::OpTypePointer || GetWordCount(PointerInstr) < 4)
+            return false;
+
+        const auto& Var     = m_Ids[VarId];
+        const auto  Storage = m_SPIRV[VarInstr + 3];
+
+        // In SPIR-V 1.4 and later, every global must be listed in the entry point interface.
+        // Earlier versions only list inputs and outputs, and single entry point modules
+        // are assumed to use all of them.
+        bool IsActive = true;
+        if (m_Version >= 0x10400)
+            IsActive = Var.InInterface;
+        else if (Storage == spv::StorageClassInput || Storage == spv::StorageClassOutput)
+            IsActive = m_EntryPoints.size() <= 1 || Var.InInterface;
+        if (!IsActive)
+            continue;
+
+        // The size of the innermost array dimension, the same as type.array[0] in SPIRV-Cross
+        uint32_t BaseTypeId = 0;
+        if (!GetArrayElementType(m_SPIRV[PointerInstr + 3], BaseTypeId, nullptr, nullptr))
+            return false;
+
+        const auto& BaseType = m_Ids[BaseTypeId];
+        if (Var.BuiltIn || BaseType.HasBuiltInMember)
+            continue;
+
+        const auto TypeStorage = m_SPIRV[PointerInstr + 2];
+        const auto BaseOpCode  = GetOpCode(BaseType.InstrOffset);
+
+        auto GetArraySize = [&](uint32_t& ArraySize) {
+            uint32_t ElementType = 0;
+            uint32_t NumDims     = 0;
+            if (!GetArrayElementType(m_SPIRV[PointerInstr + 3], ElementType, &ArraySize, &NumDims))
+                return false;
+            VERIFY(NumDims <= 1, "Only one-dimensional arrays are currently supported");
+            return true;
+        };
+
+        auto AddResource = [&](SPIRVShaderResourceAttribs::ResourceType Type, std::vector<SPIRVReflection::Resource>& Resources) {
+            uint32_t ArraySize = 1;
+            return GetArraySize(ArraySize) && InitResource(VarId, BaseTypeId, ArraySize, Type, Resources);
+        };
+
+        ImageInfo  Image;
+        const bool IsImage = (BaseOpCode == spv::OpTypeImage || BaseOpCode == spv::OpTypeSampledImage) && GetImageInfo(BaseTypeId, Image);
+
+        bool Succeeded = true;
+        if (Storage == spv::StorageClassInput)
+        {
+            SPIRVReflection::StageInput Input;
+            Input.Name                     = GetName(VarId);
+            Input.HasSemantic              = Var.Semantic != nullptr;
+            Input.Semantic                 = Input.HasSemantic ? Var.Semantic : "";
+            Input.LocationDecorationOffset = Var.LocationOffset;
+            m_Reflection.StageInputs.emplace_back(std::move(Input));
+        }
+        else if (Storage == spv::StorageClassUniformConstant && IsImage && Image.Dim == spv::DimSubpassData)
+        {
+            Succeeded = AddResource(SPIRVShaderResourceAttribs::ResourceType::InputAttachment, m_Reflection.InputAttachments);
+        }
+        else if (Storage == spv::StorageClassOutput)
+        {
+        }
+        else if (TypeStorage == spv::StorageClassUniform && BaseType.Block)
+        {
+            Succeeded = AddResource(SPIRVShaderResourceAttribs::ResourceType::UniformBuffer, m_Reflection.UniformBuffers);
+        }
+        else if ((TypeStorage == spv::StorageClassUniform && BaseType.BufferBlock) || TypeStorage == spv::StorageClassStorageBuffer)
+        {
+            const bool IsReadOnly = Var.NonWritable || AllMembersNonWritable(BaseTypeId);
+            Succeeded             = AddResource(IsReadOnly ?
+                                        SPIRVShaderResourceAttribs::ResourceType::ROStorageBuffer :
+                                        SPIRVShaderResourceAttribs::ResourceType::RWStorageBuffer,
+                                    m_Reflection.StorageBuffers);
+        }
+        else if (TypeStorage == spv::StorageClassPushConstant || TypeStorage == spv::StorageClassShaderRecordBufferKHR)
+        {
+        }
+        else if (TypeStorage == spv::StorageClassUniformConstant && BaseOpCode == spv::OpTypeImage && IsImage && Image.Sampled == 2)
+        {
+            Succeeded = AddResource(Image.Dim == spv::DimBuffer ?
+                                        SPIRVShaderResourceAttribs::ResourceType::StorageTexelBuffer :
+                                        SPIRVShaderResourceAttribs::ResourceType::StorageImage,
+                                    m_Reflection.StorageImages);
+        }
+        else if (TypeStorage == spv::StorageClassUniformConstant && BaseOpCode == spv::OpTypeImage && IsImage && Image.Sampled == 1)
+        {
+            Succeeded = AddResource(Image.Dim == spv::DimBuffer ?
+                                        SPIRVShaderResourceAttribs::ResourceType::UniformTexelBuffer :
+                                        SPIRVShaderResourceAttribs::ResourceType::SeparateImage,
+                                    m_Reflection.SeparateImages);
+        }
+        else if (TypeStorage == spv::StorageClassUniformConstant && BaseOpCode == spv::OpTypeSampler)
+        {
+            Succeeded = AddResource(SPIRVShaderResourceAttribs::ResourceType::SeparateSampler, m_Reflection.SeparateSamplers);
+        }
+        else if (TypeStorage == spv::StorageClassUniformConstant && BaseOpCode == spv::OpTypeSampledImage)
+        {
+            Succeeded = IsImage &&
+                AddResource(Image.Dim == spv::DimBuffer ?
+                                SPIRVShaderResourceAttribs::ResourceType::UniformTexelBuffer :
+                                SPIRVShaderResourceAttribs::ResourceType::SampledImage,
+                            m_Reflection.SampledImages);
+        }
+        else if (TypeStorage == spv::StorageClassAtomicCounter)
+        {
+            Succeeded = AddResource(SPIRVShaderResourceAttribs::ResourceType::AtomicCounter, m_Reflection.AtomicCounters);
+        }
+        else if (TypeStorage == spv::StorageClassUniformConstant && BaseOpCode == spv::OpTypeAccelerationStructureKHR)
+        {
+            Succeeded = AddResource(SPIRVShaderResourceAttribs::ResourceType::AccelerationStructure, m_Reflection.AccelStructs);
+        }
+        static_assert(Uint32{SPIRVShaderResourceAttribs::ResourceType::NumResourceTypes} == 12, "Please handle the new resource type here, if needed");
+
+        if (!Succeeded)
+            return false;
+    }
+
+    return true;
+}
+
+} // namespace
+
+bool ReflectSPIRVModule(const std::vector<uint32_t>& SPIRV,
+                        SHADER_TYPE                  ShaderType,
+                        SPIRVReflection&             Reflection)
+{
+    Reflection = SPIRVReflection{};
+
+    SPIRVModuleReflector Reflector{SPIRV, ShaderType, Reflection};
+    return Reflector.Reflect();
+}
+
+} // namespace Diligent
@@ -27,19 +27,21 @@
 
 #include <iomanip>
 #include "SPIRVShaderResources.hpp"
+#include "SPIRVReflection.hpp"
+#include "ShaderReflectionData.hpp"
 #include "spirv_parser.hpp"
 #include "spirv_cross.hpp"
 #include "ShaderBase.hpp"
 #include "GraphicsAccessories.hpp"
 #include "StringTools.hpp"
 #include "Align.hpp"
+#include "HashUtils.hpp"
 
 namespace Diligent
 {
 
-template <typename Type>
-Type GetResourceArraySize(const diligent_spirv_cross::Compiler& Compiler,
-                          const diligent_spirv_cross::Resource& Res)
+static Uint32 GetResourceArraySize(const diligent_spirv_cross::Compiler& Compiler,
+                                   const diligent_spirv_cross::Resource& Res)
 {
     const auto& type    = Compiler.get_type(Res.type_id);
     uint32_t    arrSize = 1;
@@ -49,8 +51,7 @@ Type GetResourceArraySize(const diligent_spirv_cross::Compiler& Compiler,
         VERIFY(type.array.size() == 1, "Only one-dimensional arrays are currently supported");
         arrSize = type.array[0];
     }
-    VERIFY(arrSize <= std::numeric_limits<Type>::max(), "Array size exceeds maximum representable value ", std::numeric_limits<Type>::max());
-    return static_cast<Type>(arrSize);
+    return arrSize;
 }
 
 static RESOURCE_DIMENSION GetResourceDimension(const diligent_spirv_cross::Compiler& Compiler,
@@ -89,7 +90,7 @@ static bool IsMultisample(const diligent_spirv_cross::Compiler& Compiler,
     }
     else
     {
-        return RESOURCE_DIM_UNDEFINED;
+        return false;
     }
 }
 
@@ -105,20 +106,23 @@ static uint32_t GetDecorationOffset(const diligent_spirv_cross::Compiler& Compil
     return offset;
 }
 
-SPIRVShaderResourceAttribs::SPIRVShaderResourceAttribs(const diligent_spirv_cross::Compiler& Compiler,
-                                                       const diligent_spirv_cross::Resource& Res,
-                                                       const char*                           _Name,
-                                                       ResourceType                          _Type,
-                                                       Uint32                                _BufferStaticSize,
-                                                       Uint32                                _BufferStride) noexcept :
+SPIRVShaderResourceAttribs::SPIRVShaderResourceAttribs(const char*        _Name,
+                                                       ResourceType       _Type,
+                                                       Uint16             _ArraySize,
+                                                       RESOURCE_DIMENSION _ResourceDim,
+                                                       bool               _IsMS,
+                                                       uint32_t           _BindingDecorationOffset,
+                                                       uint32_t           _DescriptorSetDecorationOffset,
+                                                       Uint32             _BufferStaticSize,
+                                                       Uint32             _BufferStride) noexcept :
     // clang-format off
     Name                          {_Name},
-    ArraySize                     {GetResourceArraySize<decltype(ArraySize)>(Compiler, Res)},
+    ArraySize                     {_ArraySize},
     Type                          {_Type},
-    ResourceDim                   {Diligent::GetResourceDimension(Compiler, Res)},
-    IsMS                          {Diligent::IsMultisample(Compiler, Res) ? Uint8{1} : Uint8{0}},
-    BindingDecorationOffset       {GetDecorationOffset(Compiler, Res, spv::Decoration::DecorationBinding)},
-    DescriptorSetDecorationOffset {GetDecorationOffset(Compiler, Res, spv::Decoration::DecorationDescriptorSet)},
+    ResourceDim                   {static_cast<Uint8>(_ResourceDim)},
+    IsMS                          {_IsMS ? Uint8{1} : Uint8{0}},
+    BindingDecorationOffset       {_BindingDecorationOffset},
+    DescriptorSetDecorationOffset {_DescriptorSetDecorationOffset},
     BufferStaticSize              {_BufferStaticSize},
     BufferStride                  {_BufferStride}
 // clang-format on
@@ -260,19 +264,18 @@ const std::string& GetUBName(diligent_spirv_cross::Compiler&               Compi
     return (IRSource.hlsl && !instance_name.empty()) ? instance_name : UB.name;
 }
 
-SPIRVShaderResources::SPIRVShaderResources(IMemoryAllocator&     Allocator,
-                                           std::vector<uint32_t> spirv_binary,
-                                           const ShaderDesc&     shaderDesc,
-                                           const char*           CombinedSamplerSuffix,
-                                           bool                  LoadShaderStageInputs,
-                                           std::string&          EntryPoint) :
-    m_ShaderType{shaderDesc.ShaderType}
+static void ReflectSPIRVWithSPIRVCross(std::vector<uint32_t> spirv_binary,
+                                       const ShaderDesc&     shaderDesc,
+                                       std::string           EntryPoint,
+                                       SPIRVReflection&      Reflection)
 {
+    Reflection = SPIRVReflection{};
+
     // https://github.com/KhronosGroup/SPIRV-Cross/wiki/Reflection-API-user-guide
     diligent_spirv_cross::Parser parser(move(spirv_binary));
     parser.parse();
     const auto ParsedIRSource = parser.get_parsed_ir().source;
-    m_IsHLSLSource            = ParsedIRSource.hlsl;
+    Reflection.IsHLSLSource   = ParsedIRSource.hlsl;
     diligent_spirv_cross::Compiler Compiler(std::move(parser.get_parsed_ir()));
 
     spv::ExecutionModel ExecutionModel = ShaderTypeToSpvExecutionModel(shaderDesc.ShaderType);
@@ -296,28 +299,293 @@ SPIRVShaderResources::SPIRVShaderResources(IMemoryAllocator&     Allocator,
         LOG_ERROR_AND_THROW("Unable to find entry point of type ", GetShaderTypeLiteralName(shaderDesc.ShaderType), " in SPIRV binary for shader '", shaderDesc.Name, "'");
     }
     Compiler.set_entry_point(EntryPoint, ExecutionModel);
+    Reflection.EntryPoint = EntryPoint;
 
     // The SPIR-V is now parsed, and we can perform reflection on it.
     diligent_spirv_cross::ShaderResources resources = Compiler.get_shader_resources();
 
+    auto AddResource = [&](const diligent_spirv_cross::Resource&    Res,
+                           std::string                              Name,
+                           SPIRVShaderResourceAttribs::ResourceType Type,
+                           std::vector<SPIRVReflection::Resource>&  Resources) -> SPIRVReflection::Resource& {
+        SPIRVReflection::Resource Attribs;
+        Attribs.Name                          = std::move(Name);
+        Attribs.Type                          = Type;
+        Attribs.ArraySize                     = GetResourceArraySize(Compiler, Res);
+        Attribs.ResourceDim                   = GetResourceDimension(Compiler, Res);
+        Attribs.IsMS                          = IsMultisample(Compiler, Res);
+        Attribs.BindingDecorationOffset       = GetDecorationOffset(Compiler, Res, spv::Decoration::DecorationBinding);
+        Attribs.DescriptorSetDecorationOffset = GetDecorationOffset(Compiler, Res, spv::Decoration::DecorationDescriptorSet);
+        Resources.emplace_back(std::move(Attribs));
+        return Resources.back();
+    };
+
+    for (const auto& UB : resources.uniform_buffers)
+    {
+        const auto& Type = Compiler.get_type(UB.type_id);
+        const auto  Size = Compiler.get_declared_struct_size(Type);
+
+        auto& Res            = AddResource(UB, GetUBName(Compiler, UB, ParsedIRSource), SPIRVShaderResourceAttribs::ResourceType::UniformBuffer, Reflection.UniformBuffers);
+        Res.BufferStaticSize = static_cast<Uint32>(Size);
+    }
+
+    for (const auto& SB : resources.storage_buffers)
+    {
+        auto BufferFlags = Compiler.get_buffer_block_flags(SB.id);
+        auto IsReadOnly  = BufferFlags.get(spv::DecorationNonWritable);
+        auto ResType     = IsReadOnly ?
+            SPIRVShaderResourceAttribs::ResourceType::ROStorageBuffer :
+            SPIRVShaderResourceAttribs::ResourceType::RWStorageBuffer;
+        const auto& Type   = Compiler.get_type(SB.type_id);
+        const auto  Size   = Compiler.get_declared_struct_size(Type);
+        const auto  Stride = Compiler.get_declared_struct_size_runtime_array(Type, 1) - Size;
+
+        auto& Res            = AddResource(SB, SB.name, ResType, Reflection.StorageBuffers);
+        Res.BufferStaticSize = static_cast<Uint32>(Size);
+        Res.BufferStride     = static_cast<Uint32>(Stride);
+    }
+
+    for (const auto& SmplImg : resources.sampled_images)
+    {
+        const auto& type    = Compiler.get_type(SmplImg.type_id);
+        auto        ResType = type.image.dim == spv::DimBuffer ?
+            SPIRVShaderResourceAttribs::ResourceType::UniformTexelBuffer :
+            SPIRVShaderResourceAttribs::ResourceType::SampledImage;
+        AddResource(SmplImg, SmplImg.name, ResType, Reflection.SampledImages);
+    }
+
+    for (const auto& Img : resources.storage_images)
+    {
+        const auto& type    = Compiler.get_type(Img.type_id);
+        auto        ResType = type.image.dim == spv::DimBuffer ?
+            SPIRVShaderResourceAttribs::ResourceType::StorageTexelBuffer :
+            SPIRVShaderResourceAttribs::ResourceType::StorageImage;
+        AddResource(Img, Img.name, ResType, Reflection.StorageImages);
+    }
+
+    for (const auto& AC : resources.atomic_counters)
+        AddResource(AC, AC.name, SPIRVShaderResourceAttribs::ResourceType::AtomicCounter, Reflection.AtomicCounters);
+
+    for (const auto& SepSam : resources.separate_samplers)
+        AddResource(SepSam, SepSam.name, SPIRVShaderResourceAttribs::ResourceType::SeparateSampler, Reflection.SeparateSamplers);
+
+    for (const auto& SepImg : resources.separate_images)
+    {
+        const auto& type    = Compiler.get_type(SepImg.type_id);
+        const auto  ResType = type.image.dim == spv::DimBuffer ?
+            SPIRVShaderResourceAttribs::ResourceType::UniformTexelBuffer :
+            SPIRVShaderResourceAttribs::ResourceType::SeparateImage;
+        AddResource(SepImg, SepImg.name, ResType, Reflection.SeparateImages);
+    }
+
+    for (const auto& SubpassInput : resources.subpass_inputs)
+        AddResource(SubpassInput, SubpassInput.name, SPIRVShaderResourceAttribs::ResourceType::InputAttachment, Reflection.InputAttachments);
+
+    for (const auto& AccelStruct : resources.acceleration_structures)
+        AddResource(AccelStruct, AccelStruct.name, SPIRVShaderResourceAttribs::ResourceType::AccelerationStructure, Reflection.AccelStructs);
+
+    static_assert(Uint32{SPIRVShaderResourceAttribs::ResourceType::NumResourceTypes} == 12, "Please handle the new resource type here");
+
+    for (const auto& ext : Compiler.get_declared_extensions())
+    {
+        if (ext == "SPV_GOOGLE_hlsl_functionality1")
+        {
+            Reflection.HlslFunctionality1 = true;
+            break;
+        }
+    }
+
+    for (const auto& Input : resources.stage_inputs)
+    {
+        SPIRVReflection::StageInput StageInput;
+        StageInput.Name        = Input.name;
+        StageInput.HasSemantic = Compiler.has_decoration(Input.id, spv::Decoration::DecorationHlslSemanticGOOGLE);
+        if (StageInput.HasSemantic)
+        {
+            StageInput.Semantic                 = Compiler.get_decoration_string(Input.id, spv::Decoration::DecorationHlslSemanticGOOGLE);
+            StageInput.LocationDecorationOffset = GetDecorationOffset(Compiler, Input, spv::Decoration::DecorationLocation);
+        }
+        Reflection.StageInputs.emplace_back(std::move(StageInput));
+    }
+
+    if (shaderDesc.ShaderType == SHADER_TYPE_COMPUTE)
+    {
+        for (uint32_t i = 0; i < Reflection.ComputeGroupSize.size(); ++i)
+            Reflection.ComputeGroupSize[i] = Compiler.get_execution_mode_argument(spv::ExecutionModeLocalSize, i);
+    }
+}
+
+// Reports all differences between the results of the two reflection back-ends
+static bool CompareReflections(const SPIRVReflection& Direct,
+                               const SPIRVReflection& SPIRVCross,
+                               const ShaderDesc&      shaderDesc)
+{
+    bool Equal = true;
+
+    auto CompareResources = [&](const std::vector<SPIRVReflection::Resource>& DirectRes,
+                                const std::vector<SPIRVReflection::Resource>& SPIRVCrossRes,
+                                const char*                                   Group) {
+        if (DirectRes.size() != SPIRVCrossRes.size())
+        {
+            LOG_ERROR_MESSAGE("Direct SPIRV reflection of shader '", shaderDesc.Name, "' found ", DirectRes.size(), ' ', Group,
+                              " while SPIRV-Cross found ", SPIRVCrossRes.size());
+            Equal = false;
+            return;
+        }
+
+        for (size_t i = 0; i < DirectRes.size(); ++i)
+        {
+            const auto& Res0 = DirectRes[i];
+            const auto& Res1 = SPIRVCrossRes[i];
+            // clang-format off
+            if (Res0.Name                          != Res1.Name                          ||
+                Res0.Type                          != Res1.Type                          ||
+                Res0.ArraySize                     != Res1.ArraySize                     ||
+                Res0.ResourceDim                   != Res1.ResourceDim                   ||
+                Res0.IsMS                          != Res1.IsMS                          ||
+                Res0.BindingDecorationOffset       != Res1.BindingDecorationOffset       ||
+                Res0.DescriptorSetDecorationOffset != Res1.DescriptorSetDecorationOffset ||
+                Res0.BufferStaticSize              != Res1.BufferStaticSize              ||
+                Res0.BufferStride                  != Res1.BufferStride)
+            // clang-format on
+            {
+                LOG_ERROR_MESSAGE("Direct SPIRV reflection of shader '", shaderDesc.Name, "' does not match SPIRV-Cross for resource ", i, " in ", Group,
+                                  ": name '", Res0.Name, "' vs '", Res1.Name, "', type ", Uint32{Res0.Type}, " vs ", Uint32{Res1.Type},
+                                  ", array size ", Res0.ArraySize, " vs ", Res1.ArraySize,
+                                  ", dimension ", Uint32{Res0.ResourceDim}, " vs ", Uint32{Res1.ResourceDim},
+                                  ", multisample ", Res0.IsMS, " vs ", Res1.IsMS,
+                                  ", binding offset ", Res0.BindingDecorationOffset, " vs ", Res1.BindingDecorationOffset,
+                                  ", descriptor set offset ", Res0.DescriptorSetDecorationOffset, " vs ", Res1.DescriptorSetDecorationOffset,
+                                  ", static size ", Res0.BufferStaticSize, " vs ", Res1.BufferStaticSize,
+                                  ", stride ", Res0.BufferStride, " vs ", Res1.BufferStride);
+                Equal = false;
+            }
+        }
+    };
+
+    CompareResources(Direct.UniformBuffers, SPIRVCross.UniformBuffers, "uniform buffers");
+    CompareResources(Direct.StorageBuffers, SPIRVCross.StorageBuffers, "storage buffers");
+    CompareResources(Direct.StorageImages, SPIRVCross.StorageImages, "storage images");
+    CompareResources(Direct.SampledImages, SPIRVCross.SampledImages, "sampled images");
+    CompareResources(Direct.AtomicCounters, SPIRVCross.AtomicCounters, "atomic counters");
+    CompareResources(Direct.SeparateSamplers, SPIRVCross.SeparateSamplers, "separate samplers");
+    CompareResources(Direct.SeparateImages, SPIRVCross.SeparateImages, "separate images");
+    CompareResources(Direct.InputAttachments, SPIRVCross.InputAttachments, "input attachments");
+    CompareResources(Direct.AccelStructs, SPIRVCross.AccelStructs, "acceleration structures");
+    static_assert(Uint32{SPIRVShaderResourceAttribs::ResourceType::NumResourceTypes} == 12, "Please compare the new resource type here");
+
+    if (Direct.StageInputs.size() != SPIRVCross.StageInputs.size())
+    {
+        LOG_ERROR_MESSAGE("Direct SPIRV reflection of shader '", shaderDesc.Name, "' found ", Direct.StageInputs.size(),
+                          " stage inputs while SPIRV-Cross found ", SPIRVCross.StageInputs.size());
+        Equal = false;
+    }
+    else
+    {
+        for (size_t i = 0; i < Direct.StageInputs.size(); ++i)
+        {
+            const auto& Input0 = Direct.StageInputs[i];
+            const auto& Input1 = SPIRVCross.StageInputs[i];
+            if (Input0.HasSemantic != Input1.HasSemantic ||
+                (Input0.HasSemantic && (Input0.Semantic != Input1.Semantic || Input0.LocationDecorationOffset != Input1.LocationDecorationOffset)))
+            {
+                LOG_ERROR_MESSAGE("Direct SPIRV reflection of shader '", shaderDesc.Name, "' does not match SPIRV-Cross for stage input ", i,
+                                  ": semantic '", Input0.Semantic, "' vs '", Input1.Semantic, "', location offset ",
+                                  Input0.LocationDecorationOffset, " vs ", Input1.LocationDecorationOffset);
+                Equal = false;
+            }
+        }
+    }
+
+    // clang-format off
+    if (Direct.EntryPoint         != SPIRVCross.EntryPoint         ||
+        Direct.IsHLSLSource       != SPIRVCross.IsHLSLSource       ||
+        Direct.HlslFunctionality1 != SPIRVCross.HlslFunctionality1 ||
+        (shaderDesc.ShaderType == SHADER_TYPE_COMPUTE && Direct.ComputeGroupSize != SPIRVCross.ComputeGroupSize))
+    // clang-format on
+    {
+        LOG_ERROR_MESSAGE("Direct SPIRV reflection of shader '", shaderDesc.Name, "' does not match SPIRV-Cross: entry point '",
+                          Direct.EntryPoint, "' vs '", SPIRVCross.EntryPoint, "', HLSL source ", Direct.IsHLSLSource, " vs ", SPIRVCross.IsHLSLSource,
+                          ", hlsl_functionality1 ", Direct.HlslFunctionality1, " vs ", SPIRVCross.HlslFunctionality1,
+                          ", group size (", Direct.ComputeGroupSize[0], ", ", Direct.ComputeGroupSize[1], ", ", Direct.ComputeGroupSize[2], ") vs (",
+                          SPIRVCross.ComputeGroupSize[0], ", ", SPIRVCross.ComputeGroupSize[1], ", ", SPIRVCross.ComputeGroupSize[2], ')');
+        Equal = false;
+    }
+
+    return Equal;
+}
+
+static Uint64 ComputeSPIRVHash(const std::vector<uint32_t>& SPIRV)
+{
+    return ComputeHash64(reinterpret_cast<const char*>(SPIRV.data()), SPIRV.size() * sizeof(uint32_t));
+}
+
+SPIRVShaderResources::SPIRVShaderResources(IMemoryAllocator&     Allocator,
+                                           std::vector<uint32_t> spirv_binary,
+                                           const ShaderDesc&     shaderDesc,
+                                           const char*           CombinedSamplerSuffix,
+                                           bool                  LoadShaderStageInputs,
+                                           std::string&          EntryPoint,
+                                           SPIRVReflectionMode   ReflectionMode,
+                                           const void*           pSerializedData,
+                                           size_t                SerializedDataSize) :
+    m_ShaderType{shaderDesc.ShaderType},
+    m_StageInputsRequested{LoadShaderStageInputs}
+{
+    if (pSerializedData != nullptr)
+    {
+        ShaderReflectionDataReader Reader{pSerializedData, SerializedDataSize, ShaderReflectionDataType::SPIRV, ComputeSPIRVHash(spirv_binary), shaderDesc.Name};
+        if (Reader.IsValid())
+        {
+            if (Deserialize(Allocator, Reader, spirv_binary.size(), shaderDesc, CombinedSamplerSuffix, LoadShaderStageInputs, EntryPoint))
+                return;
+
+            LOG_WARNING_MESSAGE("Reflection data of shader '", shaderDesc.Name, "' is damaged or does not match the shader description and will be ignored");
+        }
+    }
+
+    SPIRVReflection Reflection;
+
+    // The direct path always picks the only entry point of the matching type
+    bool Reflected = false;
+    if (ReflectionMode != SPIRVReflectionMode::SPIRVCross && EntryPoint.empty())
+    {
+        Reflected = ReflectSPIRVModule(spirv_binary, shaderDesc.ShaderType, Reflection);
+    }
+
+    if (ReflectionMode == SPIRVReflectionMode::Validate)
+    {
+        SPIRVReflection SPIRVCrossReflection;
+        ReflectSPIRVWithSPIRVCross(std::move(spirv_binary), shaderDesc, EntryPoint, SPIRVCrossReflection);
+        if (Reflected)
+            CompareReflections(Reflection, SPIRVCrossReflection, shaderDesc);
+        Reflection = std::move(SPIRVCrossReflection);
+    }
+    else if (!Reflected)
+    {
+        ReflectSPIRVWithSPIRVCross(std::move(spirv_binary), shaderDesc, EntryPoint, Reflection);
+    }
+
+    EntryPoint     = Reflection.EntryPoint;
+    m_IsHLSLSource = Reflection.IsHLSLSource;
+
     size_t ResourceNamesPoolSize = 0;
-    for (const auto& ub : resources.uniform_buffers)
-        ResourceNamesPoolSize += GetUBName(Compiler, ub, ParsedIRSource).length() + 1;
     static_assert(Uint32{SPIRVShaderResourceAttribs::ResourceType::NumResourceTypes} == 12, "Please account for the new resource type below");
     for (auto* pResType :
          {
-             &resources.storage_buffers,
-             &resources.storage_images,
-             &resources.sampled_images,
-             &resources.atomic_counters,
-             &resources.separate_images,
-             &resources.separate_samplers,
-             &resources.subpass_inputs,
-             &resources.acceleration_structures //
-         })                                     //
+             &Reflection.UniformBuffers,
+             &Reflection.StorageBuffers,
+             &Reflection.StorageImages,
+             &Reflection.SampledImages,
+             &Reflection.AtomicCounters,
+             &Reflection.SeparateImages,
+             &Reflection.SeparateSamplers,
+             &Reflection.InputAttachments,
+             &Reflection.AccelStructs //
+         })                           //
     {
         for (const auto& res : *pResType)
-            ResourceNamesPoolSize += res.name.length() + 1;
+            ResourceNamesPoolSize += res.Name.length() + 1;
     }
 
     if (CombinedSamplerSuffix != nullptr)
@@ -330,32 +598,22 @@ SPIRVShaderResources::SPIRVShaderResources(IMemoryAllocator&     Allocator,
 
     Uint32 NumShaderStageInputs = 0;
 
-    if (!m_IsHLSLSource || resources.stage_inputs.empty())
+    if (!m_IsHLSLSource || Reflection.StageInputs.empty())
         LoadShaderStageInputs = false;
     if (LoadShaderStageInputs)
     {
-        const auto& Extensions         = Compiler.get_declared_extensions();
-        bool        HlslFunctionality1 = false;
-        for (const auto& ext : Extensions)
+        if (Reflection.HlslFunctionality1)
         {
-            HlslFunctionality1 = (ext == "SPV_GOOGLE_hlsl_functionality1");
-            if (HlslFunctionality1)
-                break;
-        }
-
-        if (HlslFunctionality1)
-        {
-            for (const auto& Input : resources.stage_inputs)
+            for (const auto& Input : Reflection.StageInputs)
             {
-                if (Compiler.has_decoration(Input.id, spv::Decoration::DecorationHlslSemanticGOOGLE))
+                if (Input.HasSemantic)
                 {
-                    const auto& Semantic = Compiler.get_decoration_string(Input.id, spv::Decoration::DecorationHlslSemanticGOOGLE);
-                    ResourceNamesPoolSize += Semantic.length() + 1;
+                    ResourceNamesPoolSize += Input.Semantic.length() + 1;
                     ++NumShaderStageInputs;
                 }
                 else
                 {
-                    LOG_ERROR_MESSAGE("Shader input '", Input.name, "' does not have DecorationHlslSemanticGOOGLE decoration, which is unexpected as the shader declares SPV_GOOGLE_hlsl_functionality1 extension");
+                    LOG_ERROR_MESSAGE("Shader input '", Input.Name, "' does not have DecorationHlslSemanticGOOGLE decoration, which is unexpected as the shader declares SPV_GOOGLE_hlsl_functionality1 extension");
                 }
             }
         }
@@ -374,219 +632,286 @@ SPIRVShaderResources::SPIRVShaderResources(IMemoryAllocator&     Allocator,
     }
 
     ResourceCounters ResCounters;
-    ResCounters.NumUBs          = static_cast<Uint32>(resources.uniform_buffers.size());
-    ResCounters.NumSBs          = static_cast<Uint32>(resources.storage_buffers.size());
-    ResCounters.NumImgs         = static_cast<Uint32>(resources.storage_images.size());
-    ResCounters.NumSmpldImgs    = static_cast<Uint32>(resources.sampled_images.size());
-    ResCounters.NumACs          = static_cast<Uint32>(resources.atomic_counters.size());
-    ResCounters.NumSepSmplrs    = static_cast<Uint32>(resources.separate_samplers.size());
-    ResCounters.NumSepImgs      = static_cast<Uint32>(resources.separate_images.size());
-    ResCounters.NumInptAtts     = static_cast<Uint32>(resources.subpass_inputs.size());
-    ResCounters.NumAccelStructs = static_cast<Uint32>(resources.acceleration_structures.size());
+    ResCounters.NumUBs          = static_cast<Uint32>(Reflection.UniformBuffers.size());
+    ResCounters.NumSBs          = static_cast<Uint32>(Reflection.StorageBuffers.size());
+    ResCounters.NumImgs         = static_cast<Uint32>(Reflection.StorageImages.size());
+    ResCounters.NumSmpldImgs    = static_cast<Uint32>(Reflection.SampledImages.size());
+    ResCounters.NumACs          = static_cast<Uint32>(Reflection.AtomicCounters.size());
+    ResCounters.NumSepSmplrs    = static_cast<Uint32>(Reflection.SeparateSamplers.size());
+    ResCounters.NumSepImgs      = static_cast<Uint32>(Reflection.SeparateImages.size());
+    ResCounters.NumInptAtts     = static_cast<Uint32>(Reflection.InputAttachments.size());
+    ResCounters.NumAccelStructs = static_cast<Uint32>(Reflection.AccelStructs.size());
     static_assert(Uint32{SPIRVShaderResourceAttribs::ResourceType::NumResourceTypes} == 12, "Please set the new resource type counter here");
 
     // Resource names pool is only needed to facilitate string allocation.
     StringPool ResourceNamesPool;
     Initialize(Allocator, ResCounters, NumShaderStageInputs, ResourceNamesPoolSize, ResourceNamesPool);
 
-    {
-        Uint32 CurrUB = 0;
-        for (const auto& UB : resources.uniform_buffers)
+    auto InitResources = [&](const std::vector<SPIRVReflection::Resource>& Resources, Uint32 Offset) {
+        for (Uint32 n = 0; n < Resources.size(); ++n)
         {
-            const auto& name = GetUBName(Compiler, UB, ParsedIRSource);
-            const auto& Type = Compiler.get_type(UB.type_id);
-            const auto  Size = Compiler.get_declared_struct_size(Type);
-            new (&GetUB(CurrUB++)) SPIRVShaderResourceAttribs //
+            const auto& Res = Resources[n];
+            VERIFY(Res.ArraySize <= std::numeric_limits<Uint16>::max(), "Array size exceeds maximum representable value ", std::numeric_limits<Uint16>::max());
+            new (&GetResAttribs(n, static_cast<Uint32>(Resources.size()), Offset)) SPIRVShaderResourceAttribs //
                 {
-                    Compiler,
-                    UB,
-                    ResourceNamesPool.CopyString(name),
-                    SPIRVShaderResourceAttribs::ResourceType::UniformBuffer,
-                    static_cast<Uint32>(Size) //
+                    ResourceNamesPool.CopyString(Res.Name),
+                    Res.Type,
+                    static_cast<Uint16>(Res.ArraySize),
+                    Res.ResourceDim,
+                    Res.IsMS,
+                    Res.BindingDecorationOffset,
+                    Res.DescriptorSetDecorationOffset,
+                    Res.BufferStaticSize,
+                    Res.BufferStride //
                 };
         }
-        VERIFY_EXPR(CurrUB == GetNumUBs());
-    }
+    };
+
+    InitResources(Reflection.UniformBuffers, 0);
+    InitResources(Reflection.StorageBuffers, m_StorageBufferOffset);
+    InitResources(Reflection.StorageImages, m_StorageImageOffset);
+    InitResources(Reflection.SampledImages, m_SampledImageOffset);
+    InitResources(Reflection.AtomicCounters, m_AtomicCounterOffset);
+    InitResources(Reflection.SeparateSamplers, m_SeparateSamplerOffset);
+    InitResources(Reflection.SeparateImages, m_SeparateImageOffset);
+    InitResources(Reflection.InputAttachments, m_InputAttachmentOffset);
+    InitResources(Reflection.AccelStructs, m_AccelStructOffset);
+    static_assert(Uint32{SPIRVShaderResourceAttribs::ResourceType::NumResourceTypes} == 12, "Please initialize SPIRVShaderResourceAttribs for the new resource type here");
 
+    if (CombinedSamplerSuffix != nullptr)
     {
-        Uint32 CurrSB = 0;
-        for (const auto& SB : resources.storage_buffers)
-        {
-            auto BufferFlags = Compiler.get_buffer_block_flags(SB.id);
-            auto IsReadOnly  = BufferFlags.get(spv::DecorationNonWritable);
-            auto ResType     = IsReadOnly ?
-                SPIRVShaderResourceAttribs::ResourceType::ROStorageBuffer :
-                SPIRVShaderResourceAttribs::ResourceType::RWStorageBuffer;
-            const auto& Type   = Compiler.get_type(SB.type_id);
-            const auto  Size   = Compiler.get_declared_struct_size(Type);
-            const auto  Stride = Compiler.get_declared_struct_size_runtime_array(Type, 1) - Size;
-            new (&GetSB(CurrSB++)) SPIRVShaderResourceAttribs //
-                {
-                    Compiler,
-                    SB,
-                    ResourceNamesPool.CopyString(SB.name),
-                    ResType,
-                    static_cast<Uint32>(Size),
-                    static_cast<Uint32>(Stride) //
-                };
-        }
-        VERIFY_EXPR(CurrSB == GetNumSBs());
+        m_CombinedSamplerSuffix = ResourceNamesPool.CopyString(CombinedSamplerSuffix);
     }
 
+    m_ShaderName = ResourceNamesPool.CopyString(shaderDesc.Name);
+
+    if (LoadShaderStageInputs)
     {
-        Uint32 CurrSmplImg = 0;
-        for (const auto& SmplImg : resources.sampled_images)
+        Uint32 CurrStageInput = 0;
+        for (const auto& Input : Reflection.StageInputs)
         {
-            const auto& type    = Compiler.get_type(SmplImg.type_id);
-            auto        ResType = type.image.dim == spv::DimBuffer ?
-                SPIRVShaderResourceAttribs::ResourceType::UniformTexelBuffer :
-                SPIRVShaderResourceAttribs::ResourceType::SampledImage;
-            new (&GetSmpldImg(CurrSmplImg++)) SPIRVShaderResourceAttribs //
-                {
-                    Compiler,
-                    SmplImg,
-                    ResourceNamesPool.CopyString(SmplImg.name),
-                    ResType //
-                };
+            if (Input.HasSemantic)
+            {
+                new (&GetShaderStageInputAttribs(CurrStageInput++)) SPIRVShaderStageInputAttribs //
+                    {
+                        ResourceNamesPool.CopyString(Input.Semantic),
+                        Input.LocationDecorationOffset //
+                    };
+            }
         }
-        VERIFY_EXPR(CurrSmplImg == GetNumSmpldImgs());
+        VERIFY_EXPR(CurrStageInput == GetNumShaderStageInputs());
     }
 
+    VERIFY(ResourceNamesPool.GetRemainingSize() == 0, "Names pool must be empty");
+
+    if (shaderDesc.ShaderType == SHADER_TYPE_COMPUTE)
     {
-        Uint32 CurrImg = 0;
-        for (const auto& Img : resources.storage_images)
-        {
-            const auto& type    = Compiler.get_type(Img.type_id);
-            auto        ResType = type.image.dim == spv::DimBuffer ?
-                SPIRVShaderResourceAttribs::ResourceType::StorageTexelBuffer :
-                SPIRVShaderResourceAttribs::ResourceType::StorageImage;
-            new (&GetImg(CurrImg++)) SPIRVShaderResourceAttribs //
-                {
-                    Compiler,
-                    Img,
-                    ResourceNamesPool.CopyString(Img.name),
-                    ResType //
-                };
-        }
-        VERIFY_EXPR(CurrImg == GetNumImgs());
+        m_ComputeGroupSize = Reflection.ComputeGroupSize;
     }
 
+    //LOG_INFO_MESSAGE(DumpResources());
+}
+
+RefCntAutoPtr<IDataBlob> SPIRVShaderResources::Serialize(const std::vector<uint32_t>& SPIRV, const char* EntryPoint) const
+{
+    ShaderReflectionDataWriter Writer;
+    Writer.Write(static_cast<Uint32>(m_ShaderType));
+    Writer.Write(static_cast<Uint8>(m_IsHLSLSource));
+    Writer.Write(static_cast<Uint8>(m_StageInputsRequested));
+    for (auto GroupSize : m_ComputeGroupSize)
+        Writer.Write(GroupSize);
+    Writer.WriteString(EntryPoint);
+
+    // clang-format off
+    Writer.Write(GetNumUBs());
+    Writer.Write(GetNumSBs());
+    Writer.Write(GetNumImgs());
+    Writer.Write(GetNumSmpldImgs());
+    Writer.Write(GetNumACs());
+    Writer.Write(GetNumSepSmplrs());
+    Writer.Write(GetNumSepImgs());
+    Writer.Write(GetNumInptAtts());
+    Writer.Write(GetNumAccelStructs());
+    Writer.Write(GetNumShaderStageInputs());
+    static_assert(Uint32{SPIRVShaderResourceAttribs::ResourceType::NumResourceTypes} == 12, "Please serialize the new resource type counter here");
+    // clang-format on
+
+    for (Uint32 n = 0; n < GetTotalResources(); ++n)
     {
-        Uint32 CurrAC = 0;
-        for (const auto& AC : resources.atomic_counters)
-        {
-            new (&GetAC(CurrAC++)) SPIRVShaderResourceAttribs //
-                {
-                    Compiler,
-                    AC,
-                    ResourceNamesPool.CopyString(AC.name),
-                    SPIRVShaderResourceAttribs::ResourceType::AtomicCounter //
-                };
-        }
-        VERIFY_EXPR(CurrAC == GetNumACs());
+        const auto& Res = GetResource(n);
+        Writer.WriteString(Res.Name);
+        Writer.Write(Res.ArraySize);
+        Writer.Write(static_cast<Uint8>(Res.Type));
+        Writer.Write(static_cast<Uint8>(Res.ResourceDim));
+        Writer.Write(static_cast<Uint8>(Res.IsMS));
+        Writer.Write(Res.BindingDecorationOffset);
+        Writer.Write(Res.DescriptorSetDecorationOffset);
+        Writer.Write(Res.BufferStaticSize);
+        Writer.Write(Res.BufferStride);
     }
 
+    for (Uint32 n = 0; n < GetNumShaderStageInputs(); ++n)
     {
-        Uint32 CurrSepSmpl = 0;
-        for (const auto& SepSam : resources.separate_samplers)
-        {
-            new (&GetSepSmplr(CurrSepSmpl++)) SPIRVShaderResourceAttribs //
-                {
-                    Compiler,
-                    SepSam,
-                    ResourceNamesPool.CopyString(SepSam.name),
-                    SPIRVShaderResourceAttribs::ResourceType::SeparateSampler //
-                };
-        }
-        VERIFY_EXPR(CurrSepSmpl == GetNumSepSmplrs());
+        const auto& Input = GetShaderStageInputAttribs(n);
+        Writer.WriteString(Input.Semantic);
+        Writer.Write(Input.LocationDecorationOffset);
     }
 
-    {
-        Uint32 CurrSepImg = 0;
-        for (const auto& SepImg : resources.separate_images)
-        {
-            const auto& type    = Compiler.get_type(SepImg.type_id);
-            const auto  ResType = type.image.dim == spv::DimBuffer ?
-                SPIRVShaderResourceAttribs::ResourceType::UniformTexelBuffer :
-                SPIRVShaderResourceAttribs::ResourceType::SeparateImage;
+    return Writer.Finish(ShaderReflectionDataType::SPIRV, ComputeSPIRVHash(SPIRV));
+}
 
-            new (&GetSepImg(CurrSepImg++)) SPIRVShaderResourceAttribs //
-                {
-                    Compiler,
-                    SepImg,
-                    ResourceNamesPool.CopyString(SepImg.name),
-                    ResType //
-                };
-        }
-        VERIFY_EXPR(CurrSepImg == GetNumSepImgs());
-    }
+bool SPIRVShaderResources::Deserialize(IMemoryAllocator&           Allocator,
+                                       ShaderReflectionDataReader& Reader,
+                                       size_t                      SPIRVSize,
+                                       const ShaderDesc&           shaderDesc,
+                                       const char*                 CombinedSamplerSuffix,
+                                       bool                        LoadShaderStageInputs,
+                                       std::string&                EntryPoint)
+{
+    Uint32                ShaderType           = 0;
+    Uint8                 IsHLSLSource         = 0;
+    Uint8                 StageInputsRequested = 0;
+    std::array<Uint32, 3> ComputeGroupSize     = {};
+    Uint32                EntryPointOffset     = 0;
+    ResourceCounters      Counters;
+    Uint32                NumShaderStageInputs = 0;
+    // clang-format off
+    if (!Reader.Read(ShaderType)              ||
+        !Reader.Read(IsHLSLSource)            ||
+        !Reader.Read(StageInputsRequested)    ||
+        !Reader.Read(ComputeGroupSize[0])     ||
+        !Reader.Read(ComputeGroupSize[1])     ||
+        !Reader.Read(ComputeGroupSize[2])     ||
+        !Reader.ReadString(EntryPointOffset)  ||
+        !Reader.Read(Counters.NumUBs)         ||
+        !Reader.Read(Counters.NumSBs)         ||
+        !Reader.Read(Counters.NumImgs)        ||
+        !Reader.Read(Counters.NumSmpldImgs)   ||
+        !Reader.Read(Counters.NumACs)         ||
+        !Reader.Read(Counters.NumSepSmplrs)   ||
+        !Reader.Read(Counters.NumSepImgs)     ||
+        !Reader.Read(Counters.NumInptAtts)    ||
+        !Reader.Read(Counters.NumAccelStructs)||
+        !Reader.Read(NumShaderStageInputs))
+        return false;
+    static_assert(Uint32{SPIRVShaderResourceAttribs::ResourceType::NumResourceTypes} == 12, "Please deserialize the new resource type counter here");
+    // clang-format on
 
+    // Stage inputs can only be omitted if they were not requested
+    if (ShaderType != static_cast<Uint32>(shaderDesc.ShaderType) || (LoadShaderStageInputs && StageInputsRequested == 0))
+        return false;
+
+    const char* SerializedEntryPoint = Reader.GetStrings() + EntryPointOffset;
+    if (!EntryPoint.empty() && EntryPoint != SerializedEntryPoint)
+        return false;
+
+    // clang-format off
+    const Uint64 TotalResources =
+        Uint64{Counters.NumUBs}       + Uint64{Counters.NumSBs}       + Uint64{Counters.NumImgs}     +
+        Uint64{Counters.NumSmpldImgs} + Uint64{Counters.NumACs}       + Uint64{Counters.NumSepSmplrs}+
+        Uint64{Counters.NumSepImgs}   + Uint64{Counters.NumInptAtts}  + Uint64{Counters.NumAccelStructs};
+    // clang-format on
+    constexpr Uint32 MaxOffset = std::numeric_limits<OffsetType>::max();
+    if (TotalResources > MaxOffset || NumShaderStageInputs > MaxOffset)
+        return false;
+
+    if (!LoadShaderStageInputs)
+        NumShaderStageInputs = 0;
+
+    // Check the counts against the size of the records before allocating the memory
+    constexpr size_t ResourceRecordSize   = 25;
+    constexpr size_t StageInputRecordSize = 8;
+    if (TotalResources * ResourceRecordSize + NumShaderStageInputs * StageInputRecordSize > Reader.GetRemainingSize())
+        return false;
+
+    // Names in the string table are referenced by their offsets, so the entire
+    // table is copied to the names pool and no strings need to be processed.
+    const auto StringsSize           = Reader.GetStringsSize();
+    size_t     ResourceNamesPoolSize = StringsSize + strlen(shaderDesc.Name) + 1;
+    if (CombinedSamplerSuffix != nullptr)
+        ResourceNamesPoolSize += strlen(CombinedSamplerSuffix) + 1;
+
+    StringPool ResourceNamesPool;
+    Initialize(Allocator, Counters, NumShaderStageInputs, ResourceNamesPoolSize, ResourceNamesPool);
+
+    auto* const Strings = ResourceNamesPool.Allocate(StringsSize);
+    if (StringsSize != 0)
+        memcpy(Strings, Reader.GetStrings(), StringsSize);
+
+    for (Uint32 n = 0; n < m_TotalResources; ++n)
     {
-        Uint32 CurrSubpassInput = 0;
-        for (const auto& SubpassInput : resources.subpass_inputs)
+        Uint32 NameOffset                    = 0;
+        Uint16 ArraySize                     = 0;
+        Uint8  Type                          = 0;
+        Uint8  ResourceDim                   = 0;
+        Uint8  IsMS                          = 0;
+        Uint32 BindingDecorationOffset       = 0;
+        Uint32 DescriptorSetDecorationOffset = 0;
+        Uint32 BufferStaticSize              = 0;
+        Uint32 BufferStride                  = 0;
+        // clang-format off
+        if (!Reader.ReadString(NameOffset)                  ||
+            !Reader.Read(ArraySize)                         ||
+            !Reader.Read(Type)                              ||
+            !Reader.Read(ResourceDim)                       ||
+            !Reader.Read(IsMS)                              ||
+            !Reader.Read(BindingDecorationOffset)           ||
+            !Reader.Read(DescriptorSetDecorationOffset)     ||
+            !Reader.Read(BufferStaticSize)                  ||
+            !Reader.Read(BufferStride)                      ||
+            Type        >= SPIRVShaderResourceAttribs::ResourceType::NumResourceTypes ||
+            ResourceDim >= RESOURCE_DIM_NUM_DIMENSIONS ||
+            // Decoration offsets are used to patch the bytecode and must point inside it
+            BindingDecorationOffset       >= SPIRVSize ||
+            DescriptorSetDecorationOffset >= SPIRVSize)
         {
-            new (&GetInptAtt(CurrSubpassInput++)) SPIRVShaderResourceAttribs //
-                {
-                    Compiler,
-                    SubpassInput,
-                    ResourceNamesPool.CopyString(SubpassInput.name),
-                    SPIRVShaderResourceAttribs::ResourceType::InputAttachment //
-                };
+            // Attributes are trivially destructible
+            m_MemoryBuffer.reset();
+            return false;
         }
-        VERIFY_EXPR(CurrSubpassInput == GetNumInptAtts());
+        // clang-format on
+
+        new (&GetResource(n)) SPIRVShaderResourceAttribs //
+            {
+                Strings + NameOffset,
+                static_cast<SPIRVShaderResourceAttribs::ResourceType>(Type),
+                ArraySize,
+                static_cast<RESOURCE_DIMENSION>(ResourceDim),
+                IsMS != 0,
+                BindingDecorationOffset,
+                DescriptorSetDecorationOffset,
+                BufferStaticSize,
+                BufferStride //
+            };
     }
 
+    for (Uint32 n = 0; n < m_NumShaderStageInputs; ++n)
     {
-        Uint32 CurrAccelStruct = 0;
-        for (const auto& AccelStruct : resources.acceleration_structures)
+        Uint32 SemanticOffset           = 0;
+        Uint32 LocationDecorationOffset = 0;
+        if (!Reader.ReadString(SemanticOffset) || !Reader.Read(LocationDecorationOffset) || LocationDecorationOffset >= SPIRVSize)
         {
-            new (&GetAccelStruct(CurrAccelStruct++)) SPIRVShaderResourceAttribs //
-                {
-                    Compiler,
-                    AccelStruct,
-                    ResourceNamesPool.CopyString(AccelStruct.name),
-                    SPIRVShaderResourceAttribs::ResourceType::AccelerationStructure //
-                };
+            m_MemoryBuffer.reset();
+            return false;
         }
-        VERIFY_EXPR(CurrAccelStruct == GetNumAccelStructs());
+        new (&GetShaderStageInputAttribs(n)) SPIRVShaderStageInputAttribs{Strings + SemanticOffset, LocationDecorationOffset};
     }
 
-    static_assert(Uint32{SPIRVShaderResourceAttribs::ResourceType::NumResourceTypes} == 12, "Please initialize SPIRVShaderResourceAttribs for the new resource type here");
-
     if (CombinedSamplerSuffix != nullptr)
     {
         m_CombinedSamplerSuffix = ResourceNamesPool.CopyString(CombinedSamplerSuffix);
     }
-
     m_ShaderName = ResourceNamesPool.CopyString(shaderDesc.Name);
-
-    if (LoadShaderStageInputs)
-    {
-        Uint32 CurrStageInput = 0;
-        for (const auto& Input : resources.stage_inputs)
-        {
-            if (Compiler.has_decoration(Input.id, spv::Decoration::DecorationHlslSemanticGOOGLE))
-            {
-                const auto& Semantic = Compiler.get_decoration_string(Input.id, spv::Decoration::DecorationHlslSemanticGOOGLE);
-                new (&GetShaderStageInputAttribs(CurrStageInput++)) SPIRVShaderStageInputAttribs //
-                    {
-                        ResourceNamesPool.CopyString(Semantic),
-                        GetDecorationOffset(Compiler, Input, spv::Decoration::DecorationLocation) //
-                    };
-            }
-        }
-        VERIFY_EXPR(CurrStageInput == GetNumShaderStageInputs());
-    }
-
     VERIFY(ResourceNamesPool.GetRemainingSize() == 0, "Names pool must be empty");
 
+    m_IsHLSLSource = IsHLSLSource != 0;
     if (shaderDesc.ShaderType == SHADER_TYPE_COMPUTE)
     {
-        for (uint32_t i = 0; i < m_ComputeGroupSize.size(); ++i)
-            m_ComputeGroupSize[i] = Compiler.get_execution_mode_argument(spv::ExecutionModeLocalSize, i);
+        m_ComputeGroupSize = ComputeGroupSize;
     }
+    EntryPoint = SerializedEntryPoint;
 
-    //LOG_INFO_MESSAGE(DumpResources());
+    return true;
 }
 
 void SPIRVShaderResources::Initialize(IMemoryAllocator&       Allocator,
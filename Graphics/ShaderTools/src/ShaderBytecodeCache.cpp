@@ -0,0 +1,641 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "ShaderBytecodeCache.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+#include "DebugUtilities.hpp"
+#include "DataBlobImpl.hpp"
+#include "FileWrapper.hpp"
+#include "HashUtils.hpp"
+
+#if PLATFORM_WIN32
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    ifndef WIN32_LEAN_AND_MEAN
+#        define WIN32_LEAN_AND_MEAN
+#    endif
+#    include <Windows.h>
+#elif PLATFORM_LINUX || PLATFORM_ANDROID || PLATFORM_MACOS || PLATFORM_IOS || PLATFORM_TVOS
+#    define DILIGENT_POSIX_SHADER_CACHE 1
+#    include <dirent.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#    include <utime.h>
+#endif
+
+namespace Diligent
+{
+
+namespace
+{
+
+// clang-format off
+constexpr Uint32 SHA256RoundConstants[64] =
+{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+// clang-format on
+
+inline Uint32 RotateRight(Uint32 x, Uint32 n)
+{
+    return (x >> n) | (x << (32 - n));
+}
+
+// Entry file layout: EntryHeader followed by the bytecode
+struct EntryHeader
+{
+    static constexpr Uint32 MagicValue   = 0x43425344; // 'DSBC'
+    static constexpr Uint32 VersionValue = 1;
+
+    Uint32            Magic   = MagicValue;
+    Uint32            Version = VersionValue;
+    ShaderBytecodeKey Key     = {};
+    Uint64            Size    = 0;
+    Uint64            Hash    = 0; // Hash of the bytecode
+};
+static_assert(sizeof(EntryHeader) == 56, "Unexpected entry header size");
+
+constexpr char EntryExtension[] = ".bin";
+constexpr char TempExtension[]  = ".tmp";
+
+// Temporary files older than this are left by crashed processes
+constexpr Uint64 StaleTempFileAge = 60 * 60;
+
+bool EndsWith(const std::string& Str, const char* Suffix)
+{
+    const auto SuffixLen = strlen(Suffix);
+    return Str.length() >= SuffixLen && Str.compare(Str.length() - SuffixLen, SuffixLen, Suffix) == 0;
+}
+
+struct CacheFileInfo
+{
+    std::string Name;
+    Uint64      Size          = 0;
+    Uint64      LastWriteTime = 0; // Seconds since the Unix epoch
+};
+
+#if PLATFORM_WIN32
+
+bool CreateCacheDirectory(const std::string& Path)
+{
+    return CreateDirectoryA(Path.c_str(), nullptr) != FALSE || GetLastError() == ERROR_ALREADY_EXISTS;
+}
+
+bool ListCacheDirectory(const std::string& Directory, std::vector<CacheFileInfo>& Files)
+{
+    WIN32_FIND_DATAA FindData;
+
+    HANDLE hFind = FindFirstFileA((Directory + "\\*").c_str(), &FindData);
+    if (hFind == INVALID_HANDLE_VALUE)
+        return false;
+
+    do
+    {
+        if ((FindData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0)
+            continue;
+
+        CacheFileInfo Info;
+        Info.Name = FindData.cFileName;
+        Info.Size = (Uint64{FindData.nFileSizeHigh} << 32) | FindData.nFileSizeLow;
+
+        // FILETIME counts 100-nanosecond intervals since January 1, 1601
+        const auto FileTime = (Uint64{FindData.ftLastWriteTime.dwHighDateTime} << 32) | FindData.ftLastWriteTime.dwLowDateTime;
+        Info.LastWriteTime  = FileTime / 10000000 - 11644473600ull;
+        Files.emplace_back(std::move(Info));
+    } while (FindNextFileA(hFind, &FindData));
+
+    FindClose(hFind);
+    return true;
+}
+
+bool GetCacheFileSize(const std::string& Path, Uint64& Size)
+{
+    WIN32_FILE_ATTRIBUTE_DATA FileData;
+    if (GetFileAttributesExA(Path.c_str(), GetFileExInfoStandard, &FileData) == FALSE)
+        return false;
+
+    Size = (Uint64{FileData.nFileSizeHigh} << 32) | FileData.nFileSizeLow;
+    return true;
+}
+
+bool ReplaceCacheFile(const std::string& Src, const std::string& Dst)
+{
+    return MoveFileExA(Src.c_str(), Dst.c_str(), MOVEFILE_REPLACE_EXISTING) != FALSE;
+}
+
+void TouchCacheFile(const std::string& Path)
+{
+    HANDLE hFile = CreateFileA(Path.c_str(), FILE_WRITE_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+        return;
+
+    FILETIME   CurrTime;
+    SYSTEMTIME SystemTime;
+    GetSystemTime(&SystemTime);
+    SystemTimeToFileTime(&SystemTime, &CurrTime);
+    SetFileTime(hFile, nullptr, nullptr, &CurrTime);
+    CloseHandle(hFile);
+}
+
+Uint64 GetCurrentProcessUniqueId()
+{
+    return GetCurrentProcessId();
+}
+
+#elif DILIGENT_POSIX_SHADER_CACHE
+
+bool CreateCacheDirectory(const std::string& Path)
+{
+    return mkdir(Path.c_str(), 0755) == 0 || errno == EEXIST;
+}
+
+bool ListCacheDirectory(const std::string& Directory, std::vector<CacheFileInfo>& Files)
+{
+    DIR* pDir = opendir(Directory.c_str());
+    if (pDir == nullptr)
+        return false;
+
+    while (const dirent* pEntry = readdir(pDir))
+    {
+        CacheFileInfo Info;
+        Info.Name = pEntry->d_name;
+
+        struct stat Stat;
+        if (stat((Directory + '/' + Info.Name).c_str(), &Stat) != 0 || !S_ISREG(Stat.st_mode))
+            continue;
+
+        Info.Size          = static_cast<Uint64>(Stat.st_size);
+        Info.LastWriteTime = static_cast<Uint64>(Stat.st_mtime);
+        Files.emplace_back(std::move(Info));
+    }
+
+    closedir(pDir);
+    return true;
+}
+
+bool GetCacheFileSize(const std::string& Path, Uint64& Size)
+{
+    struct stat Stat;
+    if (stat(Path.c_str(), &Stat) != 0 || !S_ISREG(Stat.st_mode))
+        return false;
+
+    Size = static_cast<Uint64>(Stat.st_size);
+    return true;
+}
+
+bool ReplaceCacheFile(const std::string& Src, const std::string& Dst)
+{
+    // rename() atomically replaces the destination
+    return rename(Src.c_str(), Dst.c_str()) == 0;
+}
+
+void TouchCacheFile(const std::string& Path)
+{
+    utime(Path.c_str(), nullptr);
+}
+
+Uint64 GetCurrentProcessUniqueId()
+{
+    return static_cast<Uint64>(getpid());
+}
+
+#else
+
+bool CreateCacheDirectory(const std::string&)
+{
+    return false;
+}
+
+bool ListCacheDirectory(const std::string&, std::vector<CacheFileInfo>&)
+{
+    return false;
+}
+
+bool GetCacheFileSize(const std::string&, Uint64&)
+{
+    return false;
+}
+
+bool ReplaceCacheFile(const std::string&, const std::string&)
+{
+    return false;
+}
+
+void TouchCacheFile(const std::string&)
+{
+}
+
+Uint64 GetCurrentProcessUniqueId()
+{
+    return 0;
+}
+
+#endif
+
+// Creates the directory and all its parents
+bool CreateCacheDirectories(const std::string& Path)
+{
+    for (size_t Pos = Path.find_first_of("/\\", 1); Pos != std::string::npos; Pos = Path.find_first_of("/\\", Pos + 1))
+    {
+        // Skip the drive name on Windows
+        if (Path[Pos - 1] == ':')
+            continue;
+        CreateCacheDirectory(Path.substr(0, Pos));
+    }
+    return CreateCacheDirectory(Path);
+}
+
+} // namespace
+
+
+ShaderBytecodeKeyBuilder::ShaderBytecodeKeyBuilder() :
+    // clang-format off
+    m_State
+    {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    }
+// clang-format on
+{
+}
+
+void ShaderBytecodeKeyBuilder::ProcessBlock(const Uint8* pBlock)
+{
+    Uint32 w[64];
+    for (Uint32 i = 0; i < 16; ++i)
+    {
+        w[i] = (Uint32{pBlock[i * 4 + 0]} << 24) |
+            (Uint32{pBlock[i * 4 + 1]} << 16) |
+            (Uint32{pBlock[i * 4 + 2]} << 8) |
+            (Uint32{pBlock[i * 4 + 3]} << 0);
+    }
+    for (Uint32 i = 16; i < 64; ++i)
+    {
+        const Uint32 s0 = RotateRight(w[i - 15], 7) ^ RotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        const Uint32 s1 = RotateRight(w[i - 2], 17) ^ RotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i]            = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    Uint32 a = m_State[0];
+    Uint32 b = m_State[1];
+    Uint32 c = m_State[2];
+    Uint32 d = m_State[3];
+    Uint32 e = m_State[4];
+    Uint32 f = m_State[5];
+    Uint32 g = m_State[6];
+    Uint32 h = m_State[7];
+    for (Uint32 i = 0; i < 64; ++i)
+    {
+        const Uint32 S1    = RotateRight(e, 6) ^ RotateRight(e, 11) ^ RotateRight(e, 25);
+        const Uint32 Ch    = (e & f) ^ (~e & g);
+        const Uint32 Temp1 = h + S1 + Ch + SHA256RoundConstants[i] + w[i];
+        const Uint32 S0    = RotateRight(a, 2) ^ RotateRight(a, 13) ^ RotateRight(a, 22);
+        const Uint32 Maj   = (a & b) ^ (a & c) ^ (b & c);
+        const Uint32 Temp2 = S0 + Maj;
+
+        h = g;
+        g = f;
+        f = e;
+        e = d + Temp1;
+        d = c;
+        c = b;
+        b = a;
+        a = Temp1 + Temp2;
+    }
+
+    m_State[0] += a;
+    m_State[1] += b;
+    m_State[2] += c;
+    m_State[3] += d;
+    m_State[4] += e;
+    m_State[5] += f;
+    m_State[6] += g;
+    m_State[7] += h;
+}
+
+void ShaderBytecodeKeyBuilder::Update(const void* pData, size_t Size)
+{
+    if (Size == 0)
+        return;
+
+    const auto* pSrc   = static_cast<const Uint8*>(pData);
+    auto        Offset = static_cast<size_t>(m_Length % 64);
+    m_Length += Size;
+
+    if (Offset != 0)
+    {
+        const auto NumBytes = std::min(64 - Offset, Size);
+        memcpy(m_Block + Offset, pSrc, NumBytes);
+        pSrc += NumBytes;
+        Size -= NumBytes;
+        if (Offset + NumBytes < 64)
+            return;
+        ProcessBlock(m_Block);
+    }
+
+    for (; Size >= 64; pSrc += 64, Size -= 64)
+        ProcessBlock(pSrc);
+
+    if (Size > 0)
+        memcpy(m_Block, pSrc, Size);
+}
+
+ShaderBytecodeKeyBuilder& ShaderBytecodeKeyBuilder::AddUint(Uint64 Value)
+{
+    Uint8 Bytes[8];
+    for (Uint32 i = 0; i < 8; ++i)
+        Bytes[i] = static_cast<Uint8>(Value >> (i * 8));
+    Update(Bytes, sizeof(Bytes));
+    return *this;
+}
+
+ShaderBytecodeKeyBuilder& ShaderBytecodeKeyBuilder::AddBytes(const void* pData, size_t Size)
+{
+    AddUint(Size);
+    Update(pData, Size);
+    return *this;
+}
+
+ShaderBytecodeKeyBuilder& ShaderBytecodeKeyBuilder::AddString(const char* Str)
+{
+    if (Str == nullptr)
+        return AddUint(~Uint64{0});
+
+    return AddBytes(Str, strlen(Str));
+}
+
+ShaderBytecodeKey ShaderBytecodeKeyBuilder::Finish()
+{
+    const Uint64 BitLength = m_Length * 8;
+
+    // Pad the message with 0x80 followed by zeros up to 56 bytes modulo 64
+    static constexpr Uint8 Padding[64] = {0x80};
+    const auto             Offset      = static_cast<size_t>(m_Length % 64);
+    Update(Padding, Offset < 56 ? 56 - Offset : 120 - Offset);
+
+    Uint8 LengthBytes[8];
+    for (Uint32 i = 0; i < 8; ++i)
+        LengthBytes[i] = static_cast<Uint8>(BitLength >> (56 - i * 8));
+    Update(LengthBytes, sizeof(LengthBytes));
+    VERIFY_EXPR(m_Length % 64 == 0);
+
+    ShaderBytecodeKey Key;
+    for (Uint32 i = 0; i < 8; ++i)
+    {
+        Key[i * 4 + 0] = static_cast<Uint8>(m_State[i] >> 24);
+        Key[i * 4 + 1] = static_cast<Uint8>(m_State[i] >> 16);
+        Key[i * 4 + 2] = static_cast<Uint8>(m_State[i] >> 8);
+        Key[i * 4 + 3] = static_cast<Uint8>(m_State[i] >> 0);
+    }
+    return Key;
+}
+
+
+ShaderBytecodeCache::ShaderBytecodeCache(const CreateInfo& CI) noexcept(false) :
+    // clang-format off
+    m_Directory{CI.Directory != nullptr ? CI.Directory : ""},
+    m_MaxSize  {CI.MaxSize}
+// clang-format on
+{
+    if (m_Directory.empty())
+        LOG_ERROR_AND_THROW("Shader bytecode cache directory must not be empty");
+
+    if (!CreateCacheDirectories(m_Directory))
+        LOG_ERROR_AND_THROW("Failed to create shader bytecode cache directory '", m_Directory, "'");
+
+    std::vector<CacheFileInfo> Files;
+    ListCacheDirectory(m_Directory, Files);
+
+    Uint64 Size = 0;
+    for (const auto& File : Files)
+    {
+        if (EndsWith(File.Name, EntryExtension))
+            Size += File.Size;
+    }
+    m_Size.store(Size);
+
+    if (Size > m_MaxSize)
+        Evict(m_MaxSize / 4 * 3);
+}
+
+std::string ShaderBytecodeCache::GetEntryPath(const ShaderBytecodeKey& Key) const
+{
+    static constexpr char HexDigits[] = "0123456789abcdef";
+
+    std::string Path;
+    Path.reserve(m_Directory.length() + 1 + Key.size() * 2 + sizeof(EntryExtension));
+    Path.append(m_Directory);
+    Path.push_back('/');
+    for (auto Byte : Key)
+    {
+        Path.push_back(HexDigits[Byte >> 4]);
+        Path.push_back(HexDigits[Byte & 0xF]);
+    }
+    Path.append(EntryExtension);
+    return Path;
+}
+
+RefCntAutoPtr<IDataBlob> ShaderBytecodeCache::Load(const ShaderBytecodeKey& Key)
+{
+    const auto Path = GetEntryPath(Key);
+
+    RefCntAutoPtr<IDataBlob> pBytecode;
+    bool                     IsDamaged = false;
+    {
+        FileWrapper File{Path.c_str(), EFileAccessMode::Read};
+        if (File)
+        {
+            const auto  FileSize = File->GetSize();
+            EntryHeader Header;
+            if (FileSize >= sizeof(Header) && File->Read(&Header, sizeof(Header)) &&
+                Header.Magic == EntryHeader::MagicValue &&
+                Header.Version == EntryHeader::VersionValue &&
+                Header.Key == Key &&
+                Header.Size == FileSize - sizeof(Header))
+            {
+                RefCntAutoPtr<DataBlobImpl> pData{MakeNewRCObj<DataBlobImpl>()(static_cast<size_t>(Header.Size))};
+                if (File->Read(pData->GetDataPtr(), pData->GetSize()) &&
+                    ComputeHash64(static_cast<const char*>(pData->GetDataPtr()), pData->GetSize()) == Header.Hash)
+                {
+                    pBytecode = pData;
+                }
+            }
+            IsDamaged = !pBytecode;
+        }
+    }
+
+    if (!pBytecode)
+    {
+        if (IsDamaged)
+        {
+            LOG_WARNING_MESSAGE("Shader bytecode cache entry '", Path, "' is damaged and will be removed");
+            std::remove(Path.c_str());
+        }
+        m_Misses.fetch_add(1);
+        return {};
+    }
+
+    // The modification time is the last use time of the entry
+    TouchCacheFile(Path);
+    m_Hits.fetch_add(1);
+    return pBytecode;
+}
+
+bool ShaderBytecodeCache::Store(const ShaderBytecodeKey& Key, const void* pBytecode, size_t Size)
+{
+    DEV_CHECK_ERR(pBytecode != nullptr && Size > 0, "Bytecode must not be empty");
+
+    EntryHeader Header;
+    Header.Key  = Key;
+    Header.Size = Size;
+    Header.Hash = ComputeHash64(static_cast<const char*>(pBytecode), Size);
+
+    const auto Path = GetEntryPath(Key);
+
+    // Write a temporary file unique across processes and threads, and rename it when it is complete
+    static std::atomic<Uint32> TempFileCounter{0};
+
+    auto TempPath = Path;
+    TempPath.append(".");
+    TempPath.append(std::to_string(GetCurrentProcessUniqueId()));
+    TempPath.append(".");
+    TempPath.append(std::to_string(TempFileCounter.fetch_add(1)));
+    TempPath.append(TempExtension);
+
+    bool Written = false;
+    {
+        FileWrapper File{TempPath.c_str(), EFileAccessMode::Overwrite};
+        if (File)
+            Written = File->Write(&Header, sizeof(Header)) && File->Write(pBytecode, Size);
+    }
+
+    // The size of the entry that is replaced, if any
+    Uint64 OldSize = 0;
+    if (Written && !GetCacheFileSize(Path, OldSize))
+        OldSize = 0;
+
+    if (!Written || !ReplaceCacheFile(TempPath, Path))
+    {
+        // Another process may be holding the entry open on Windows, in which case the entry already exists
+        std::remove(TempPath.c_str());
+        return false;
+    }
+
+    m_Stores.fetch_add(1);
+
+    const Uint64 EntrySize = sizeof(Header) + Size;
+
+    Uint64 NewSize = 0;
+    if (EntrySize >= OldSize)
+        NewSize = m_Size.fetch_add(EntrySize - OldSize) + (EntrySize - OldSize);
+    else
+        NewSize = m_Size.fetch_sub(OldSize - EntrySize) - (OldSize - EntrySize);
+    if (NewSize > m_MaxSize)
+    {
+        // Evict down to 3/4 of the limit, so that the directory is not scanned on every store
+        Evict(m_MaxSize / 4 * 3);
+    }
+
+    return true;
+}
+
+void ShaderBytecodeCache::Evict(Uint64 TargetSize)
+{
+    std::unique_lock<std::mutex> Lock{m_EvictionMtx, std::try_to_lock};
+    if (!Lock)
+    {
+        // Another thread is already evicting entries
+        return;
+    }
+
+    std::vector<CacheFileInfo> Files;
+    if (!ListCacheDirectory(m_Directory, Files))
+        return;
+
+    const auto CurrTime = static_cast<Uint64>(time(nullptr));
+
+    // The directory may be shared with other processes, so the actual size is recomputed
+    std::vector<const CacheFileInfo*> Entries;
+    Uint64                            Size = 0;
+    for (const auto& File : Files)
+    {
+        if (EndsWith(File.Name, EntryExtension))
+        {
+            Entries.push_back(&File);
+            Size += File.Size;
+        }
+        else if (EndsWith(File.Name, TempExtension) && File.LastWriteTime + StaleTempFileAge < CurrTime)
+        {
+            std::remove((m_Directory + '/' + File.Name).c_str());
+        }
+    }
+
+    std::sort(Entries.begin(), Entries.end(),
+              [](const CacheFileInfo* pEntry0, const CacheFileInfo* pEntry1) {
+                  return pEntry0->LastWriteTime < pEntry1->LastWriteTime;
+              });
+
+    Uint64 NumEvicted = 0;
+    for (auto it = Entries.begin(); it != Entries.end() && Size > TargetSize; ++it)
+    {
+        // The entry may have already been removed by another process
+        std::remove((m_Directory + '/' + (*it)->Name).c_str());
+        Size -= (*it)->Size;
+        ++NumEvicted;
+    }
+
+    m_Evictions.fetch_add(NumEvicted);
+    m_Size.store(Size);
+}
+
+ShaderBytecodeCacheStats ShaderBytecodeCache::GetStats() const
+{
+    ShaderBytecodeCacheStats Stats;
+    Stats.Hits      = m_Hits.load();
+    Stats.Misses    = m_Misses.load();
+    Stats.Stores    = m_Stores.load();
+    Stats.Evictions = m_Evictions.load();
+    Stats.Size      = m_Size.load();
+    return Stats;
+}
+
+} // namespace Diligent
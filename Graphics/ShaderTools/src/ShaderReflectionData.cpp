@@ -0,0 +1,106 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "ShaderReflectionData.hpp"
+
+#include "DebugUtilities.hpp"
+#include "DataBlobImpl.hpp"
+
+namespace Diligent
+{
+
+void ShaderReflectionDataWriter::WriteString(const char* Str)
+{
+    VERIFY_EXPR(Str != nullptr);
+    Write(static_cast<Uint32>(m_Strings.size()));
+    m_Strings.insert(m_Strings.end(), Str, Str + strlen(Str) + 1);
+}
+
+RefCntAutoPtr<IDataBlob> ShaderReflectionDataWriter::Finish(ShaderReflectionDataType Type, Uint64 BytecodeHash) const
+{
+    ShaderReflectionDataHeader Header;
+    Header.Type         = static_cast<Uint16>(Type);
+    Header.RecordsSize  = static_cast<Uint32>(m_Records.size());
+    Header.StringsSize  = static_cast<Uint32>(m_Strings.size());
+    Header.BytecodeHash = BytecodeHash;
+
+    RefCntAutoPtr<IDataBlob> pData{MakeNewRCObj<DataBlobImpl>()(sizeof(Header) + m_Records.size() + m_Strings.size())};
+
+    auto* pDst = static_cast<Uint8*>(pData->GetDataPtr());
+    memcpy(pDst, &Header, sizeof(Header));
+    pDst += sizeof(Header);
+    if (!m_Records.empty())
+        memcpy(pDst, m_Records.data(), m_Records.size());
+    pDst += m_Records.size();
+    if (!m_Strings.empty())
+        memcpy(pDst, m_Strings.data(), m_Strings.size());
+
+    return pData;
+}
+
+ShaderReflectionDataReader::ShaderReflectionDataReader(const void*              pData,
+                                                       size_t                   Size,
+                                                       ShaderReflectionDataType Type,
+                                                       Uint64                   BytecodeHash,
+                                                       const char*              ShaderName)
+{
+    ShaderReflectionDataHeader Header;
+    if (pData == nullptr || Size < sizeof(Header))
+    {
+        LOG_WARNING_MESSAGE("Reflection data of shader '", ShaderName, "' is too small and will be ignored");
+        return;
+    }
+
+    memcpy(&Header, pData, sizeof(Header));
+    if (Header.Magic != ShaderReflectionDataHeader::MagicValue ||
+        Header.Version != ShaderReflectionDataHeader::VersionValue ||
+        Header.Type != static_cast<Uint16>(Type) ||
+        Size != sizeof(Header) + size_t{Header.RecordsSize} + size_t{Header.StringsSize})
+    {
+        LOG_WARNING_MESSAGE("Reflection data of shader '", ShaderName, "' is not valid or was produced by a different version of the engine and will be ignored");
+        return;
+    }
+
+    if (Header.BytecodeHash != BytecodeHash)
+    {
+        LOG_WARNING_MESSAGE("Reflection data of shader '", ShaderName, "' does not match the shader bytecode and will be ignored");
+        return;
+    }
+
+    m_pRecords    = static_cast<const Uint8*>(pData) + sizeof(Header);
+    m_pStrings    = reinterpret_cast<const char*>(m_pRecords + Header.RecordsSize);
+    m_RecordsSize = Header.RecordsSize;
+    m_StringsSize = Header.StringsSize;
+
+    // Every string offset is checked to be within the table, so a terminated
+    // table guarantees that every string is terminated.
+    m_IsValid = m_StringsSize == 0 || m_pStrings[m_StringsSize - 1] == 0;
+    if (!m_IsValid)
+        LOG_WARNING_MESSAGE("String table in reflection data of shader '", ShaderName, "' is not terminated. The data will be ignored");
+}
+
+} // namespace Diligent
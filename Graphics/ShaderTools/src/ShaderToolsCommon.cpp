@@ -28,6 +28,7 @@
 #include "ShaderToolsCommon.hpp"
 #include "DebugUtilities.hpp"
 #include "DataBlobImpl.hpp"
+#include "MappedFileStream.hpp"
 
 namespace Diligent
 {
@@ -126,8 +127,7 @@ const char* ReadShaderSourceFile(const char*                      SourceCode,
                 if (pSourceStream == nullptr)
                     LOG_ERROR_AND_THROW("Failed to load shader source file '", FilePath, '\'');
 
-                pFileData = MakeNewRCObj<DataBlobImpl>{}(0);
-                pSourceStream->ReadBlob(pFileData);
+                pFileData     = ReadFileStreamData(pSourceStream);
                 SourceCode    = reinterpret_cast<char*>(pFileData->GetDataPtr());
                 SourceCodeLen = pFileData->GetSize();
             }
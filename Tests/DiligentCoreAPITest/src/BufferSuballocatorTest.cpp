@@ -68,7 +68,7 @@ TEST(BufferSuballocatorTest, Create)
     pAlloc.Release();
 }
 
-TEST(BufferSuballocatorTest, Allocate)
+void TestAllocate(bool UseTLSF)
 {
     auto* pEnv     = TestingEnvironment::GetInstance();
     auto* pDevice  = pEnv->GetDevice();
@@ -80,6 +80,7 @@ TEST(BufferSuballocatorTest, Allocate)
     CI.Desc.Name          = "Buffer Suballocator Test";
     CI.Desc.BindFlags     = BIND_VERTEX_BUFFER;
     CI.Desc.uiSizeInBytes = 1024;
+    CI.UseTLSF            = UseTLSF;
 
     RefCntAutoPtr<IBufferSuballocator> pAllocator;
     CreateBufferSuballocator(pDevice, CI, &pAllocator);
@@ -149,4 +150,115 @@ TEST(BufferSuballocatorTest, Allocate)
     }
 }
 
+TEST(BufferSuballocatorTest, Allocate)
+{
+    TestAllocate(false);
+}
+
+TEST(BufferSuballocatorTest, AllocateTLSF)
+{
+    TestAllocate(true);
+}
+
+void TestDefragment(bool UseTLSF, Uint32 MaxScratchSize = BufferSuballocatorCreateInfo{}.MaxDefragmentationScratchSize)
+{
+    auto* pEnv     = TestingEnvironment::GetInstance();
+    auto* pDevice  = pEnv->GetDevice();
+    auto* pContext = pEnv->GetDeviceContext();
+
+    TestingEnvironment::ScopedReleaseResources AutoreleaseResources;
+
+    constexpr Uint32 BlockSize = 64;
+    constexpr Uint32 NumBlocks = 8;
+
+    BufferSuballocatorCreateInfo CI;
+    CI.Desc.Name          = "Buffer Suballocator Defragmentation Test";
+    CI.Desc.BindFlags     = BIND_VERTEX_BUFFER;
+    CI.Desc.uiSizeInBytes = BlockSize * NumBlocks;
+    CI.UseTLSF            = UseTLSF;
+
+    CI.MaxDefragmentationScratchSize = MaxScratchSize;
+
+    RefCntAutoPtr<IBufferSuballocator> pAllocator;
+    CreateBufferSuballocator(pDevice, CI, &pAllocator);
+    ASSERT_NE(pAllocator, nullptr);
+
+    std::vector<RefCntAutoPtr<IBufferSuballocation>> pSubAllocations(NumBlocks);
+    for (auto& pAlloc : pSubAllocations)
+    {
+        pAllocator->Allocate(BlockSize, 16, &pAlloc);
+        ASSERT_NE(pAlloc, nullptr);
+    }
+
+    auto* pBuffer = pAllocator->GetBuffer(pDevice, pContext);
+    ASSERT_NE(pBuffer, nullptr);
+    for (Uint32 i = 0; i < NumBlocks; ++i)
+    {
+        std::vector<Uint8> BlockData(BlockSize, static_cast<Uint8>(i + 1));
+        pContext->UpdateBuffer(pBuffer, pSubAllocations[i]->GetOffset(), BlockSize, BlockData.data(), RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+    }
+
+    // Release every other block
+    for (Uint32 i = 0; i < NumBlocks; i += 2)
+        pSubAllocations[i].Release();
+    EXPECT_EQ(pAllocator->GetLargestFreeRegionSize(), BlockSize);
+
+    const auto Version = pAllocator->GetVersion();
+
+    // Move one block only
+    EXPECT_EQ(pAllocator->Defragment(pDevice, pContext, BlockSize), BlockSize);
+    EXPECT_EQ(pSubAllocations[NumBlocks - 1]->GetOffset(), Uint32{0});
+    EXPECT_GT(pAllocator->GetVersion(), Version);
+
+    // Move the remaining blocks
+    EXPECT_GT(pAllocator->Defragment(pDevice, pContext, 0), Uint32{0});
+    EXPECT_EQ(pAllocator->GetLargestFreeRegionSize(), BlockSize * NumBlocks / 2);
+    EXPECT_EQ(pAllocator->Defragment(pDevice, pContext, 0), Uint32{0});
+
+    BufferDesc StagingDesc;
+    StagingDesc.Name           = "Buffer suballocator test staging buffer";
+    StagingDesc.Usage          = USAGE_STAGING;
+    StagingDesc.CPUAccessFlags = CPU_ACCESS_READ;
+    StagingDesc.uiSizeInBytes  = CI.Desc.uiSizeInBytes;
+    StagingDesc.BindFlags      = BIND_NONE;
+
+    RefCntAutoPtr<IBuffer> pStagingBuffer;
+    pDevice->CreateBuffer(StagingDesc, nullptr, &pStagingBuffer);
+    ASSERT_NE(pStagingBuffer, nullptr);
+
+    pContext->CopyBuffer(pAllocator->GetBuffer(pDevice, pContext), 0, RESOURCE_STATE_TRANSITION_MODE_TRANSITION,
+                         pStagingBuffer, 0, StagingDesc.uiSizeInBytes, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+    pContext->WaitForIdle();
+
+    void* pData = nullptr;
+    pContext->MapBuffer(pStagingBuffer, MAP_READ, MAP_FLAG_DO_NOT_WAIT, pData);
+    ASSERT_NE(pData, nullptr);
+    for (Uint32 i = 1; i < NumBlocks; i += 2)
+    {
+        const auto  Offset = pSubAllocations[i]->GetOffset();
+        const auto* pBlock = static_cast<const Uint8*>(pData) + Offset;
+        EXPECT_LT(Offset, BlockSize * NumBlocks / 2);
+        EXPECT_TRUE(std::all_of(pBlock, pBlock + BlockSize, [i](Uint8 b) { return b == i + 1; }))
+            << "Data of block " << i << " was not preserved";
+    }
+    pContext->UnmapBuffer(pStagingBuffer, MAP_READ);
+}
+
+TEST(BufferSuballocatorTest, Defragment)
+{
+    TestDefragment(false);
+}
+
+TEST(BufferSuballocatorTest, DefragmentTLSF)
+{
+    TestDefragment(true);
+}
+
+TEST(BufferSuballocatorTest, DefragmentInBatches)
+{
+    // The scratch buffer only fits one block, so every block is moved in a separate batch
+    TestDefragment(false, 16);
+    TestDefragment(true, 16);
+}
+
 } // namespace
@@ -34,6 +34,7 @@ extern "C"
     int TestRenderDeviceCInterface_Misc(void* pRenderDevice);
     int TestRenderDeviceCInterface_CreateBuffer(void* pRenderDevice);
     int TestRenderDeviceCInterface_CreateShader(void* pRenderDevice);
+    int TestRenderDeviceCInterface_CreateShaders(void* pRenderDevice);
     int TestRenderDeviceCInterface_CreateTexture(void* pRenderDevice);
     int TestRenderDeviceCInterface_CreateSampler(void* pRenderDevice);
     int TestRenderDeviceCInterface_CreateResourceMapping(void* pRenderDevice);
@@ -66,6 +67,12 @@ TEST(RenderDevice_CInterface, CreateShader)
     EXPECT_EQ(TestRenderDeviceCInterface_CreateShader(pDevice), 0);
 }
 
+TEST(RenderDevice_CInterface, CreateShaders)
+{
+    auto* pDevice = TestingEnvironment::GetInstance()->GetDevice();
+    EXPECT_EQ(TestRenderDeviceCInterface_CreateShaders(pDevice), 0);
+}
+
 TEST(RenderDevice_CInterface, CreateTexture)
 {
     auto* pDevice = TestingEnvironment::GetInstance()->GetDevice();
@@ -0,0 +1,310 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <cstring>
+#include <vector>
+
+#include "TestingEnvironment.hpp"
+#include "ShaderGL.h"
+#include "ShaderReflectionData.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using namespace Diligent::Testing;
+
+namespace
+{
+
+// Uses every resource type that ShaderResourcesGL serializes, including arrays
+const char* const ReflectionTest_CS = R"(
+layout(local_size_x = 1, local_size_y = 1, local_size_z = 1) in;
+
+uniform cbConstants
+{
+    vec4 g_Constants;
+};
+
+uniform highp sampler2D   g_Tex2D[2];
+uniform highp samplerCube g_TexCube;
+
+layout(rgba8) uniform writeonly highp image2D g_RWTex[3];
+
+layout(std430) buffer bufInput
+{
+    vec4 Data[4];
+} g_Input[2];
+
+layout(std430) buffer bufOutput
+{
+    vec4 Data[4];
+} g_Output;
+
+void main()
+{
+    vec4 Color = g_Constants;
+    Color += textureLod(g_Tex2D[0], vec2(0.5, 0.5), 0.0) + textureLod(g_Tex2D[1], vec2(0.5, 0.5), 0.0);
+    Color += textureLod(g_TexCube, vec3(0.0, 0.0, 1.0), 0.0);
+    Color += g_Input[0].Data[0] + g_Input[1].Data[1];
+    imageStore(g_RWTex[0], ivec2(0, 0), Color);
+    imageStore(g_RWTex[1], ivec2(0, 0), Color);
+    imageStore(g_RWTex[2], ivec2(0, 0), Color);
+    g_Output.Data[0] = Color;
+}
+)";
+
+bool IsReflectionDataSupported(IRenderDevice* pDevice)
+{
+    const auto& DeviceInfo = pDevice->GetDeviceInfo();
+    return DeviceInfo.IsGLDevice() && DeviceInfo.Features.SeparablePrograms && DeviceInfo.Features.ComputeShaders;
+}
+
+RefCntAutoPtr<IShader> CreateTestShader(IRenderDevice* pDevice, const std::vector<Uint8>* pReflectionData)
+{
+    ShaderCreateInfo ShaderCI;
+    ShaderCI.Source          = ReflectionTest_CS;
+    ShaderCI.SourceLanguage  = SHADER_SOURCE_LANGUAGE_GLSL;
+    ShaderCI.Desc.ShaderType = SHADER_TYPE_COMPUTE;
+    ShaderCI.Desc.Name       = "GL reflection data test";
+    if (pReflectionData != nullptr)
+    {
+        ShaderCI.ReflectionData     = pReflectionData->data();
+        ShaderCI.ReflectionDataSize = pReflectionData->size();
+    }
+
+    RefCntAutoPtr<IShader> pShader;
+    pDevice->CreateShader(ShaderCI, &pShader);
+    return pShader;
+}
+
+std::vector<Uint8> GetReflectionData(IShader* pShader)
+{
+    RefCntAutoPtr<IShaderGL> pShaderGL{pShader, IID_ShaderGL};
+    VERIFY_EXPR(pShaderGL);
+
+    RefCntAutoPtr<IDataBlob> pData;
+    pShaderGL->GetReflectionData(&pData);
+    if (!pData)
+        return {};
+
+    const auto* pBytes = static_cast<const Uint8*>(pData->GetConstDataPtr());
+    return std::vector<Uint8>{pBytes, pBytes + pData->GetSize()};
+}
+
+void CompareResources(IShader* pRefShader, IShader* pShader)
+{
+    ASSERT_EQ(pRefShader->GetResourceCount(), pShader->GetResourceCount());
+    for (Uint32 i = 0; i < pRefShader->GetResourceCount(); ++i)
+    {
+        ShaderResourceDesc RefDesc, Desc;
+        pRefShader->GetResourceDesc(i, RefDesc);
+        pShader->GetResourceDesc(i, Desc);
+        EXPECT_STREQ(RefDesc.Name, Desc.Name);
+        EXPECT_EQ(RefDesc.Type, Desc.Type) << RefDesc.Name;
+        EXPECT_EQ(RefDesc.ArraySize, Desc.ArraySize) << RefDesc.Name;
+    }
+}
+
+TEST(ShaderReflectionDataGL, RoundTrip)
+{
+    auto* const pEnv    = TestingEnvironment::GetInstance();
+    auto* const pDevice = pEnv->GetDevice();
+    if (!IsReflectionDataSupported(pDevice))
+    {
+        GTEST_SKIP() << "Reflection data is only supported by OpenGL devices with separable programs and compute shaders";
+    }
+
+    auto pRefShader = CreateTestShader(pDevice, nullptr);
+    ASSERT_NE(pRefShader, nullptr);
+
+    // clang-format off
+    const struct
+    {
+        const char*          Name;
+        SHADER_RESOURCE_TYPE Type;
+        Uint32               ArraySize;
+    } ExpectedResources[] =
+    {
+        {"cbConstants", SHADER_RESOURCE_TYPE_CONSTANT_BUFFER, 1},
+        {"g_Tex2D",     SHADER_RESOURCE_TYPE_TEXTURE_SRV,     2},
+        {"g_TexCube",   SHADER_RESOURCE_TYPE_TEXTURE_SRV,     1},
+        {"g_RWTex",     SHADER_RESOURCE_TYPE_TEXTURE_UAV,     3},
+        {"bufInput",    SHADER_RESOURCE_TYPE_BUFFER_UAV,      2},
+        {"bufOutput",   SHADER_RESOURCE_TYPE_BUFFER_UAV,      1},
+    };
+    // clang-format on
+    ASSERT_EQ(pRefShader->GetResourceCount(), Uint32{_countof(ExpectedResources)});
+    for (const auto& Expected : ExpectedResources)
+    {
+        bool Found = false;
+        for (Uint32 i = 0; i < pRefShader->GetResourceCount() && !Found; ++i)
+        {
+            ShaderResourceDesc Desc;
+            pRefShader->GetResourceDesc(i, Desc);
+            if (strcmp(Desc.Name, Expected.Name) == 0)
+            {
+                EXPECT_EQ(Desc.Type, Expected.Type) << Expected.Name;
+                EXPECT_EQ(Desc.ArraySize, Expected.ArraySize) << Expected.Name;
+                Found = true;
+            }
+        }
+        EXPECT_TRUE(Found) << Expected.Name;
+    }
+
+    const auto Data = GetReflectionData(pRefShader);
+    ASSERT_FALSE(Data.empty());
+
+    // The shader created from the data produces exactly the same data, so every
+    // GL-specific attribute (block indices, texture and image types) is preserved.
+    auto pShader = CreateTestShader(pDevice, &Data);
+    ASSERT_NE(pShader, nullptr);
+    CompareResources(pRefShader, pShader);
+    EXPECT_EQ(GetReflectionData(pShader), Data);
+
+    // Make sure that the resources are really loaded from the data: the records end with
+    // the array size and the index of the last storage block, and neither is validated
+    // against the program, so the patched array size must be used.
+    {
+        ShaderReflectionDataHeader Header;
+        memcpy(&Header, Data.data(), sizeof(Header));
+        const size_t ArraySizeOffset = sizeof(Header) + Header.RecordsSize - 8;
+
+        auto   PatchedData = Data;
+        Uint32 ArraySize   = 0;
+        memcpy(&ArraySize, &PatchedData[ArraySizeOffset], sizeof(ArraySize));
+        ++ArraySize;
+        memcpy(&PatchedData[ArraySizeOffset], &ArraySize, sizeof(ArraySize));
+
+        auto pPatchedShader = CreateTestShader(pDevice, &PatchedData);
+        ASSERT_NE(pPatchedShader, nullptr);
+        ShaderResourceDesc LastRes;
+        pPatchedShader->GetResourceDesc(pPatchedShader->GetResourceCount() - 1, LastRes);
+        EXPECT_EQ(LastRes.ArraySize, ArraySize);
+    }
+
+    // Truncated data is rejected and the shader is reflected
+    for (size_t Size : {size_t{0}, sizeof(ShaderReflectionDataHeader), Data.size() / 2, Data.size() - 1})
+    {
+        const std::vector<Uint8> TruncatedData{Data.begin(), Data.begin() + Size};
+
+        auto pTruncatedShader = CreateTestShader(pDevice, &TruncatedData);
+        ASSERT_NE(pTruncatedShader, nullptr);
+        CompareResources(pRefShader, pTruncatedShader);
+    }
+}
+
+TEST(ShaderReflectionDataGL, Pipeline)
+{
+    auto* const pEnv    = TestingEnvironment::GetInstance();
+    auto* const pDevice = pEnv->GetDevice();
+    if (!IsReflectionDataSupported(pDevice))
+    {
+        GTEST_SKIP() << "Reflection data is only supported by OpenGL devices with separable programs and compute shaders";
+    }
+
+    TestingEnvironment::ScopedReleaseResources AutoreleaseResources;
+
+    auto pRefShader = CreateTestShader(pDevice, nullptr);
+    ASSERT_NE(pRefShader, nullptr);
+    const auto Data = GetReflectionData(pRefShader);
+    ASSERT_FALSE(Data.empty());
+    auto pShader = CreateTestShader(pDevice, &Data);
+    ASSERT_NE(pShader, nullptr);
+
+    auto CreatePSO = [pDevice](IShader* pCS) {
+        ComputePipelineStateCreateInfo PSOCreateInfo;
+        PSOCreateInfo.PSODesc.Name         = "GL reflection data test";
+        PSOCreateInfo.PSODesc.PipelineType = PIPELINE_TYPE_COMPUTE;
+        PSOCreateInfo.pCS                  = pCS;
+
+        // clang-format off
+        ShaderResourceVariableDesc Variables[] =
+        {
+            {SHADER_TYPE_COMPUTE, "cbConstants", SHADER_RESOURCE_VARIABLE_TYPE_STATIC},
+            {SHADER_TYPE_COMPUTE, "g_RWTex",     SHADER_RESOURCE_VARIABLE_TYPE_DYNAMIC}
+        };
+        // clang-format on
+        PSOCreateInfo.PSODesc.ResourceLayout.DefaultVariableType = SHADER_RESOURCE_VARIABLE_TYPE_MUTABLE;
+        PSOCreateInfo.PSODesc.ResourceLayout.Variables           = Variables;
+        PSOCreateInfo.PSODesc.ResourceLayout.NumVariables        = _countof(Variables);
+
+        RefCntAutoPtr<IPipelineState> pPSO;
+        pDevice->CreateComputePipelineState(PSOCreateInfo, &pPSO);
+        return pPSO;
+    };
+
+    auto pRefPSO = CreatePSO(pRefShader);
+    ASSERT_NE(pRefPSO, nullptr);
+    auto pPSO = CreatePSO(pShader);
+    ASSERT_NE(pPSO, nullptr);
+
+    ASSERT_EQ(pRefPSO->GetResourceSignatureCount(), pPSO->GetResourceSignatureCount());
+    for (Uint32 s = 0; s < pRefPSO->GetResourceSignatureCount(); ++s)
+    {
+        const auto& RefDesc = pRefPSO->GetResourceSignature(s)->GetDesc();
+        const auto& Desc    = pPSO->GetResourceSignature(s)->GetDesc();
+        ASSERT_EQ(RefDesc.NumResources, Desc.NumResources);
+        for (Uint32 r = 0; r < RefDesc.NumResources; ++r)
+        {
+            const auto& RefRes = RefDesc.Resources[r];
+            const auto& Res    = Desc.Resources[r];
+            EXPECT_STREQ(RefRes.Name, Res.Name);
+            EXPECT_EQ(RefRes.ShaderStages, Res.ShaderStages) << RefRes.Name;
+            EXPECT_EQ(RefRes.ArraySize, Res.ArraySize) << RefRes.Name;
+            EXPECT_EQ(RefRes.ResourceType, Res.ResourceType) << RefRes.Name;
+            EXPECT_EQ(RefRes.VarType, Res.VarType) << RefRes.Name;
+            EXPECT_EQ(RefRes.Flags, Res.Flags) << RefRes.Name;
+        }
+    }
+
+    ASSERT_EQ(pRefPSO->GetStaticVariableCount(SHADER_TYPE_COMPUTE), pPSO->GetStaticVariableCount(SHADER_TYPE_COMPUTE));
+    EXPECT_NE(pPSO->GetStaticVariableByName(SHADER_TYPE_COMPUTE, "cbConstants"), nullptr);
+
+    RefCntAutoPtr<IShaderResourceBinding> pRefSRB, pSRB;
+    pRefPSO->CreateShaderResourceBinding(&pRefSRB);
+    pPSO->CreateShaderResourceBinding(&pSRB);
+    ASSERT_TRUE(pRefSRB && pSRB);
+
+    ASSERT_EQ(pRefSRB->GetVariableCount(SHADER_TYPE_COMPUTE), pSRB->GetVariableCount(SHADER_TYPE_COMPUTE));
+    for (Uint32 v = 0; v < pRefSRB->GetVariableCount(SHADER_TYPE_COMPUTE); ++v)
+    {
+        auto* pRefVar = pRefSRB->GetVariableByIndex(SHADER_TYPE_COMPUTE, v);
+        auto* pVar    = pSRB->GetVariableByIndex(SHADER_TYPE_COMPUTE, v);
+        ASSERT_TRUE(pRefVar != nullptr && pVar != nullptr);
+
+        ShaderResourceDesc RefDesc, Desc;
+        pRefVar->GetResourceDesc(RefDesc);
+        pVar->GetResourceDesc(Desc);
+        EXPECT_STREQ(RefDesc.Name, Desc.Name);
+        EXPECT_EQ(RefDesc.Type, Desc.Type) << RefDesc.Name;
+        EXPECT_EQ(RefDesc.ArraySize, Desc.ArraySize) << RefDesc.Name;
+        EXPECT_EQ(pRefVar->GetType(), pVar->GetType()) << RefDesc.Name;
+        EXPECT_EQ(pRefVar->GetIndex(), pVar->GetIndex()) << RefDesc.Name;
+    }
+}
+
+} // namespace
@@ -28,6 +28,8 @@
 #include <thread>
 #include <atomic>
 #include <algorithm>
+#include <string>
+#include <vector>
 
 #include "TestingEnvironment.hpp"
 #include "ThreadSignal.hpp"
@@ -322,4 +324,67 @@ TEST_F(MultithreadedResourceCreationTest, CreateResources)
         t.join();
 }
 
+TEST(MultithreadedShaderCreationTest, CreateShaders)
+{
+    auto* pEnv    = TestingEnvironment::GetInstance();
+    auto* pDevice = pEnv->GetDevice();
+
+    TestingEnvironment::ScopedReleaseResources AutoreleaseResources;
+
+    static const char BrokenShaderSource[] = "void PSMain(out float4 col : SV_TARGET) { col = UndefinedVariable; }";
+
+    constexpr Uint32 NumShaders   = 64;
+    constexpr Uint32 BrokenShader = 37;
+
+    std::vector<ShaderCreateInfo> ShaderCIs(NumShaders);
+    std::vector<std::string>      Names(NumShaders);
+    std::vector<IDataBlob*>       CompilerOutputs(NumShaders);
+    for (Uint32 i = 0; i < NumShaders; ++i)
+    {
+        const bool IsVS = (i % 2) == 0;
+        Names[i]        = std::string{"MT batch shader "} + std::to_string(i);
+
+        auto& ShaderCI                      = ShaderCIs[i];
+        ShaderCI.Source                     = i == BrokenShader ? BrokenShaderSource : g_ShaderSource;
+        ShaderCI.EntryPoint                 = IsVS ? "VSMain" : "PSMain";
+        ShaderCI.Desc.ShaderType            = IsVS ? SHADER_TYPE_VERTEX : SHADER_TYPE_PIXEL;
+        ShaderCI.Desc.Name                  = Names[i].c_str();
+        ShaderCI.SourceLanguage             = SHADER_SOURCE_LANGUAGE_HLSL;
+        ShaderCI.ShaderCompiler             = pEnv->GetDefaultCompiler(ShaderCI.SourceLanguage);
+        ShaderCI.UseCombinedTextureSamplers = true;
+        ShaderCI.ppCompilerOutput           = &CompilerOutputs[i];
+    }
+
+    std::vector<IShader*> pShaders(NumShaders);
+    const auto&           DeviceInfo = pDevice->GetDeviceInfo();
+    pEnv->SetErrorAllowance(DeviceInfo.IsGLDevice() || DeviceInfo.IsD3DDevice() ? 2 : 3, "\n\nNo worries, testing broken shader in a batch...\n\n");
+    pDevice->CreateShaders(NumShaders, ShaderCIs.data(), pShaders.data());
+
+    for (Uint32 i = 0; i < NumShaders; ++i)
+    {
+        if (i == BrokenShader)
+        {
+            EXPECT_EQ(pShaders[i], nullptr);
+            EXPECT_NE(CompilerOutputs[i], nullptr);
+        }
+        else
+        {
+            ASSERT_NE(pShaders[i], nullptr) << Names[i];
+            EXPECT_STREQ(pShaders[i]->GetDesc().Name, Names[i].c_str());
+            EXPECT_EQ(pShaders[i]->GetDesc().ShaderType, ShaderCIs[i].Desc.ShaderType);
+        }
+    }
+
+    for (auto* pShader : pShaders)
+    {
+        if (pShader != nullptr)
+            pShader->Release();
+    }
+    for (auto* pOutput : CompilerOutputs)
+    {
+        if (pOutput != nullptr)
+            pOutput->Release();
+    }
+}
+
 } // namespace
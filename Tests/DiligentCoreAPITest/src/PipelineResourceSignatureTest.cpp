@@ -1812,4 +1812,49 @@ TEST_F(PipelineResourceSignatureTest, RunTimeResourceArray_HLSL)
     TestRunTimeResourceArray(false, pShaderSourceFactory);
 }
 
+TEST_F(PipelineResourceSignatureTest, CreateShaderResourceBindings)
+{
+    auto* const pEnv    = TestingEnvironment::GetInstance();
+    auto* const pDevice = pEnv->GetDevice();
+
+    TestingEnvironment::ScopedReleaseResources AutoreleaseResources;
+
+    const PipelineResourceDesc Resources[] = //
+        {
+            {SHADER_TYPE_PIXEL, "g_Tex2D", 1, SHADER_RESOURCE_TYPE_TEXTURE_SRV, SHADER_RESOURCE_VARIABLE_TYPE_MUTABLE},
+            {SHADER_TYPE_VERTEX | SHADER_TYPE_PIXEL, "ConstBuff", 1, SHADER_RESOURCE_TYPE_CONSTANT_BUFFER, SHADER_RESOURCE_VARIABLE_TYPE_DYNAMIC} //
+        };
+
+    PipelineResourceSignatureDesc PRSDesc;
+    PRSDesc.Name                     = "PRS bulk SRB creation test";
+    PRSDesc.Resources                = Resources;
+    PRSDesc.NumResources             = _countof(Resources);
+    PRSDesc.SRBAllocationGranularity = 16;
+
+    RefCntAutoPtr<IPipelineResourceSignature> pPRS;
+    pDevice->CreatePipelineResourceSignature(PRSDesc, &pPRS);
+    ASSERT_TRUE(pPRS);
+
+    constexpr Uint32 NumSRBs = 100;
+
+    std::vector<IShaderResourceBinding*> pSRBs(NumSRBs);
+    pPRS->CreateShaderResourceBindings(NumSRBs, pSRBs.data(), true);
+    for (Uint32 i = 0; i < NumSRBs; ++i)
+    {
+        ASSERT_NE(pSRBs[i], nullptr);
+        EXPECT_EQ(pSRBs[i]->GetPipelineResourceSignature(), pPRS);
+        EXPECT_TRUE(pSRBs[i]->StaticResourcesInitialized());
+        EXPECT_NE(pSRBs[i]->GetVariableByName(SHADER_TYPE_PIXEL, "g_Tex2D"), nullptr);
+        EXPECT_NE(pSRBs[i]->GetVariableByName(SHADER_TYPE_VERTEX, "ConstBuff"), nullptr);
+        for (Uint32 j = 0; j < i; ++j)
+            EXPECT_NE(pSRBs[i], pSRBs[j]);
+    }
+
+    for (auto* pSRB : pSRBs)
+    {
+        if (pSRB != nullptr)
+            pSRB->Release();
+    }
+}
+
 } // namespace Diligent
@@ -0,0 +1,435 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "SPIRVShaderResources.hpp"
+#include "SPIRVReflection.hpp"
+#include "ShaderReflectionData.hpp"
+#include "DefaultRawMemoryAllocator.hpp"
+#include "TestingEnvironment.hpp"
+#include "ShaderVk.h"
+
+#include "InlineShaders/ComputeShaderTestHLSL.h"
+#include "InlineShaders/DrawCommandTestHLSL.h"
+#include "InlineShaders/DrawCommandTestGLSL.h"
+#include "InlineShaders/GeometryShaderTestHLSL.h"
+#include "InlineShaders/TessellationTestHLSL.h"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using namespace Diligent::Testing;
+
+namespace
+{
+
+const std::string ReflectionTest_PS{R"(
+struct BufferData
+{
+    float4 Data;
+    uint   Flags;
+};
+
+cbuffer cbConstants
+{
+    float4 g_Scale;
+    float4 g_Bias[4];
+}
+
+StructuredBuffer<BufferData>   g_ROBuffer;
+RWStructuredBuffer<BufferData> g_RWBuffer;
+ByteAddressBuffer              g_RawBuffer;
+RWByteAddressBuffer            g_RWRawBuffer;
+Buffer<float4>                 g_FormattedBuffer;
+RWBuffer<float4>               g_RWFormattedBuffer;
+
+Texture2D<float4>        g_Tex2D;
+Texture2D<float4>        g_Tex2DArr[3];
+Texture2DArray<float4>   g_Tex2DArray;
+Texture3D<float4>        g_Tex3D;
+TextureCube<float4>      g_TexCube;
+Texture2DMS<float4>      g_Tex2DMS;
+RWTexture2D<float4>      g_RWTex2D;
+RWTexture2DArray<float4> g_RWTex2DArray;
+
+SamplerState g_Sampler;
+SamplerState g_Samplers[2];
+
+struct PSInput
+{
+    float4 Pos  : SV_POSITION;
+    float2 UV   : TEXCOORD0;
+    float3 Norm : NORMAL;
+};
+
+float4 main(in PSInput PSIn) : SV_Target
+{
+    float4 Color = g_Scale + g_Bias[1];
+    Color += g_ROBuffer[0].Data;
+    g_RWBuffer[0].Data = Color;
+    Color += asfloat(g_RawBuffer.Load4(0));
+    g_RWRawBuffer.Store(0, asuint(Color.x));
+    Color += g_FormattedBuffer.Load(0);
+    g_RWFormattedBuffer[0] = Color;
+    Color += g_Tex2D.Sample(g_Sampler, PSIn.UV);
+    Color += g_Tex2DArr[1].Sample(g_Samplers[1], PSIn.UV);
+    Color += g_Tex2DArray.Sample(g_Sampler, float3(PSIn.UV, 0.0));
+    Color += g_Tex3D.Sample(g_Sampler, PSIn.Norm);
+    Color += g_TexCube.Sample(g_Samplers[0], PSIn.Norm);
+    Color += g_Tex2DMS.Load(int2(0, 0), 0);
+    g_RWTex2D[int2(0, 0)] = Color;
+    g_RWTex2DArray[int3(0, 0, 0)] = Color;
+    return Color;
+}
+)"};
+
+const std::string ReflectionTest_VS{R"(
+cbuffer cbTransform
+{
+    float4x4 g_WorldViewProj;
+}
+
+struct VSInput
+{
+    float3 Pos   : ATTRIB0;
+    float2 UV    : ATTRIB1;
+    float4 Color : ATTRIB2;
+};
+
+void main(in  VSInput VSIn,
+          out float4  Pos   : SV_Position,
+          out float2  UV    : TEX_COORD,
+          out float4  Color : COLOR)
+{
+    Pos   = mul(float4(VSIn.Pos, 1.0), g_WorldViewProj);
+    UV    = VSIn.UV;
+    Color = VSIn.Color;
+}
+)"};
+
+const std::string ReflectionTest_FS{R"(
+#version 450
+
+layout(std140, binding = 0) uniform UniformBlock
+{
+    vec4 g_Color;
+    mat4 g_Transform;
+} g_Uniforms;
+
+layout(std430, binding = 1) readonly buffer ROBuffer
+{
+    vec4 g_ROData[];
+};
+
+layout(std430, binding = 2) buffer RWBuffer
+{
+    uvec4 Header;
+    vec4  Data[];
+} g_RWData;
+
+layout(binding = 3, rgba8) uniform writeonly image2D      g_Image;
+layout(binding = 4, rgba8) uniform writeonly image2DArray g_ImageArray[2];
+layout(binding = 5) uniform sampler2D       g_CombinedSampler;
+layout(binding = 6) uniform sampler3D       g_CombinedSampler3D[4];
+layout(binding = 7) uniform texture2D       g_SeparateImage;
+layout(binding = 8) uniform sampler         g_SeparateSampler;
+layout(binding = 9) uniform samplerBuffer   g_UniformTexelBuffer;
+layout(binding = 10, rgba32f) uniform imageBuffer g_StorageTexelBuffer;
+
+layout(location = 0) in  vec2 in_UV;
+layout(location = 0) out vec4 out_Color;
+
+void main()
+{
+    vec4 Color = g_Uniforms.g_Color * g_Uniforms.g_Transform;
+    Color += g_ROData[0];
+    g_RWData.Data[g_RWData.Header.x] = Color;
+    imageStore(g_Image, ivec2(0, 0), Color);
+    imageStore(g_ImageArray[1], ivec3(0, 0, 0), Color);
+    Color += texture(g_CombinedSampler, in_UV);
+    Color += texture(g_CombinedSampler3D[2], vec3(in_UV, 0.0));
+    Color += texture(sampler2D(g_SeparateImage, g_SeparateSampler), in_UV);
+    Color += texelFetch(g_UniformTexelBuffer, 0);
+    imageStore(g_StorageTexelBuffer, 0, Color);
+    out_Color = Color;
+}
+)"};
+
+void CompareAttribs(const SPIRVShaderResourceAttribs& Ref, const SPIRVShaderResourceAttribs& Res)
+{
+    EXPECT_STREQ(Ref.Name, Res.Name);
+    EXPECT_EQ(Ref.ArraySize, Res.ArraySize) << Ref.Name;
+    EXPECT_EQ(Ref.Type, Res.Type) << Ref.Name;
+    EXPECT_EQ(Ref.GetResourceDimension(), Res.GetResourceDimension()) << Ref.Name;
+    EXPECT_EQ(Ref.IsMultisample(), Res.IsMultisample()) << Ref.Name;
+    EXPECT_EQ(Ref.BindingDecorationOffset, Res.BindingDecorationOffset) << Ref.Name;
+    EXPECT_EQ(Ref.DescriptorSetDecorationOffset, Res.DescriptorSetDecorationOffset) << Ref.Name;
+    EXPECT_EQ(Ref.BufferStaticSize, Res.BufferStaticSize) << Ref.Name;
+    EXPECT_EQ(Ref.BufferStride, Res.BufferStride) << Ref.Name;
+}
+
+void CompareResources(const SPIRVShaderResources& Ref, const SPIRVShaderResources& Res)
+{
+    ASSERT_EQ(Ref.GetNumUBs(), Res.GetNumUBs());
+    ASSERT_EQ(Ref.GetNumSBs(), Res.GetNumSBs());
+    ASSERT_EQ(Ref.GetNumImgs(), Res.GetNumImgs());
+    ASSERT_EQ(Ref.GetNumSmpldImgs(), Res.GetNumSmpldImgs());
+    ASSERT_EQ(Ref.GetNumACs(), Res.GetNumACs());
+    ASSERT_EQ(Ref.GetNumSepSmplrs(), Res.GetNumSepSmplrs());
+    ASSERT_EQ(Ref.GetNumSepImgs(), Res.GetNumSepImgs());
+    ASSERT_EQ(Ref.GetNumInptAtts(), Res.GetNumInptAtts());
+    ASSERT_EQ(Ref.GetNumAccelStructs(), Res.GetNumAccelStructs());
+    ASSERT_EQ(Ref.GetTotalResources(), Res.GetTotalResources());
+
+    // Resources of each type are stored in their respective ranges in the same order,
+    // so comparing resources by index verifies the layout as well.
+    for (Uint32 n = 0; n < Ref.GetTotalResources(); ++n)
+    {
+        CompareAttribs(Ref.GetResource(n), Res.GetResource(n));
+    }
+
+    ASSERT_EQ(Ref.GetNumShaderStageInputs(), Res.GetNumShaderStageInputs());
+    for (Uint32 n = 0; n < Ref.GetNumShaderStageInputs(); ++n)
+    {
+        const auto& RefInput = Ref.GetShaderStageInputAttribs(n);
+        const auto& ResInput = Res.GetShaderStageInputAttribs(n);
+        EXPECT_STREQ(RefInput.Semantic, ResInput.Semantic);
+        EXPECT_EQ(RefInput.LocationDecorationOffset, ResInput.LocationDecorationOffset);
+    }
+
+    EXPECT_EQ(Ref.GetShaderType(), Res.GetShaderType());
+    EXPECT_EQ(Ref.IsHLSLSource(), Res.IsHLSLSource());
+    if (Ref.GetShaderType() == SHADER_TYPE_COMPUTE)
+    {
+        EXPECT_EQ(Ref.GetComputeGroupSize(), Res.GetComputeGroupSize());
+    }
+}
+
+void TestSPIRVResourcesSerialization(const std::vector<uint32_t>& SPIRV,
+                                     const ShaderDesc&            Desc,
+                                     const char*                  CombinedSamplerSuffix,
+                                     bool                         LoadShaderInputs,
+                                     const SPIRVShaderResources&  RefResources,
+                                     const std::string&           RefEntryPoint)
+{
+    auto& Allocator = DefaultRawMemoryAllocator::GetAllocator();
+
+    auto pData = RefResources.Serialize(SPIRV, RefEntryPoint.c_str());
+    ASSERT_NE(pData, nullptr) << Desc.Name;
+    const auto* pBytes = static_cast<const Uint8*>(pData->GetConstDataPtr());
+    const auto  Data   = std::vector<Uint8>{pBytes, pBytes + pData->GetSize()};
+
+    auto Deserialize = [&](const std::vector<Uint8>& SerializedData, std::string& EntryPoint) {
+        // SPIRV-Cross is only used if the data is rejected
+        return std::unique_ptr<const SPIRVShaderResources>{
+            new SPIRVShaderResources{Allocator, SPIRV, Desc, CombinedSamplerSuffix, LoadShaderInputs, EntryPoint,
+                                     SPIRVReflectionMode::SPIRVCross, SerializedData.data(), SerializedData.size()}};
+    };
+
+    {
+        std::string EntryPoint;
+        auto        pResources = Deserialize(Data, EntryPoint);
+        EXPECT_EQ(EntryPoint, RefEntryPoint);
+        CompareResources(RefResources, *pResources);
+        EXPECT_STREQ(RefResources.GetShaderName(), pResources->GetShaderName());
+        if (CombinedSamplerSuffix != nullptr)
+            EXPECT_STREQ(CombinedSamplerSuffix, pResources->GetCombinedSamplerSuffix());
+    }
+
+    // Truncated data is rejected and the resources are reflected from the bytecode
+    for (size_t Size : {size_t{0}, sizeof(ShaderReflectionDataHeader), Data.size() / 2, Data.size() - 1})
+    {
+        std::string EntryPoint;
+        auto        pResources = Deserialize(std::vector<Uint8>{Data.begin(), Data.begin() + Size}, EntryPoint);
+        EXPECT_EQ(EntryPoint, RefEntryPoint);
+        CompareResources(RefResources, *pResources);
+    }
+
+    // Data produced for a different bytecode is rejected
+    {
+        auto OtherSPIRV = SPIRV;
+        OtherSPIRV.push_back(0);
+        auto pOtherData = RefResources.Serialize(OtherSPIRV, RefEntryPoint.c_str());
+
+        const auto* pOtherBytes = static_cast<const Uint8*>(pOtherData->GetConstDataPtr());
+        std::string EntryPoint;
+        auto        pResources = Deserialize(std::vector<Uint8>{pOtherBytes, pOtherBytes + pOtherData->GetSize()}, EntryPoint);
+        CompareResources(RefResources, *pResources);
+    }
+
+    // The records end with the last resource or the last stage input
+    ShaderReflectionDataHeader Header;
+    memcpy(&Header, Data.data(), sizeof(Header));
+    const size_t RecordsEnd = sizeof(Header) + Header.RecordsSize;
+    auto         PatchData  = [&](size_t Offset, Uint32 Value) {
+        auto Patched = Data;
+        memcpy(&Patched[Offset], &Value, sizeof(Value));
+        return Patched;
+    };
+
+    if (RefResources.GetNumShaderStageInputs() > 0)
+    {
+        // Location decoration offset of the last stage input is out of the bytecode range
+        std::string EntryPoint;
+        auto        pResources = Deserialize(PatchData(RecordsEnd - 4, static_cast<Uint32>(SPIRV.size())), EntryPoint);
+        CompareResources(RefResources, *pResources);
+    }
+    else if (RefResources.GetTotalResources() > 0)
+    {
+        const auto& LastRes = RefResources.GetResource(RefResources.GetTotalResources() - 1);
+
+        // Make sure that the resources are really loaded from the data: buffer stride
+        // of the last resource is not validated, so the patched value must be used.
+        {
+            std::string EntryPoint;
+            auto        pResources = Deserialize(PatchData(RecordsEnd - 4, LastRes.BufferStride + 16), EntryPoint);
+            EXPECT_EQ(pResources->GetResource(pResources->GetTotalResources() - 1).BufferStride, LastRes.BufferStride + 16);
+        }
+
+        // Binding and descriptor set decoration offsets out of the bytecode range
+        for (size_t Offset : {RecordsEnd - 16, RecordsEnd - 12})
+        {
+            std::string EntryPoint;
+            auto        pResources = Deserialize(PatchData(Offset, static_cast<Uint32>(SPIRV.size())), EntryPoint);
+            CompareResources(RefResources, *pResources);
+        }
+    }
+}
+
+void TestSPIRVReflection(const char*            Name,
+                         const std::string&     Source,
+                         SHADER_TYPE            ShaderType,
+                         SHADER_SOURCE_LANGUAGE SourceLang)
+{
+    auto* pEnv    = TestingEnvironment::GetInstance();
+    auto* pDevice = pEnv->GetDevice();
+    if (!pDevice->GetDeviceInfo().IsVulkanDevice())
+    {
+        GTEST_SKIP() << "SPIRV reflection test requires Vulkan device";
+    }
+
+    ShaderCreateInfo ShaderCI;
+    ShaderCI.SourceLanguage             = SourceLang;
+    ShaderCI.ShaderCompiler             = pEnv->GetDefaultCompiler(ShaderCI.SourceLanguage);
+    ShaderCI.UseCombinedTextureSamplers = SourceLang == SHADER_SOURCE_LANGUAGE_HLSL;
+    ShaderCI.Desc.ShaderType            = ShaderType;
+    ShaderCI.Desc.Name                  = Name;
+    ShaderCI.EntryPoint                 = "main";
+    ShaderCI.Source                     = Source.c_str();
+
+    RefCntAutoPtr<IShader> pShader;
+    pDevice->CreateShader(ShaderCI, &pShader);
+    ASSERT_NE(pShader, nullptr) << Name;
+
+    RefCntAutoPtr<IShaderVk> pShaderVk{pShader, IID_ShaderVk};
+    ASSERT_NE(pShaderVk, nullptr);
+    const auto& SPIRV = pShaderVk->GetSPIRV();
+
+    // Make sure the direct path handles the module without falling back to SPIRV-Cross
+    SPIRVReflection Reflection;
+    EXPECT_TRUE(ReflectSPIRVModule(SPIRV, ShaderType, Reflection)) << Name;
+
+    const char* CombinedSamplerSuffix = ShaderCI.UseCombinedTextureSamplers ? ShaderCI.CombinedSamplerSuffix : nullptr;
+    const bool  LoadShaderInputs      = ShaderType == SHADER_TYPE_VERTEX;
+    auto&       Allocator             = DefaultRawMemoryAllocator::GetAllocator();
+
+    std::string          RefEntryPoint;
+    SPIRVShaderResources RefResources{Allocator, SPIRV, pShader->GetDesc(), CombinedSamplerSuffix, LoadShaderInputs, RefEntryPoint, SPIRVReflectionMode::SPIRVCross};
+
+    std::string          EntryPoint;
+    SPIRVShaderResources Resources{Allocator, SPIRV, pShader->GetDesc(), CombinedSamplerSuffix, LoadShaderInputs, EntryPoint, SPIRVReflectionMode::Direct};
+
+    EXPECT_EQ(RefEntryPoint, EntryPoint);
+    CompareResources(RefResources, Resources);
+
+    // Validation mode logs an error for every mismatch between the two paths,
+    // which fails the test
+    std::string          ValidateEntryPoint;
+    SPIRVShaderResources ValidatedResources{Allocator, SPIRV, pShader->GetDesc(), CombinedSamplerSuffix, LoadShaderInputs, ValidateEntryPoint, SPIRVReflectionMode::Validate};
+    CompareResources(RefResources, ValidatedResources);
+
+    TestSPIRVResourcesSerialization(SPIRV, pShader->GetDesc(), CombinedSamplerSuffix, LoadShaderInputs, RefResources, RefEntryPoint);
+}
+
+TEST(SPIRVReflectionTest, HLSLResources)
+{
+    TestSPIRVReflection("SPIRV reflection test - HLSL PS", ReflectionTest_PS, SHADER_TYPE_PIXEL, SHADER_SOURCE_LANGUAGE_HLSL);
+}
+
+TEST(SPIRVReflectionTest, HLSLStageInputs)
+{
+    TestSPIRVReflection("SPIRV reflection test - HLSL VS", ReflectionTest_VS, SHADER_TYPE_VERTEX, SHADER_SOURCE_LANGUAGE_HLSL);
+}
+
+TEST(SPIRVReflectionTest, GLSLResources)
+{
+    TestSPIRVReflection("SPIRV reflection test - GLSL FS", ReflectionTest_FS, SHADER_TYPE_PIXEL, SHADER_SOURCE_LANGUAGE_GLSL);
+}
+
+TEST(SPIRVReflectionTest, DrawCommandShaders)
+{
+    TestSPIRVReflection("Draw command test - HLSL VS", HLSL::DrawTest_ProceduralTriangleVS, SHADER_TYPE_VERTEX, SHADER_SOURCE_LANGUAGE_HLSL);
+    TestSPIRVReflection("Draw command test - HLSL PS", HLSL::DrawTest_PS, SHADER_TYPE_PIXEL, SHADER_SOURCE_LANGUAGE_HLSL);
+    TestSPIRVReflection("Input attachment test - HLSL PS", HLSL::InputAttachmentTest_PS, SHADER_TYPE_PIXEL, SHADER_SOURCE_LANGUAGE_HLSL);
+    TestSPIRVReflection("Input attachment test - GLSL FS", GLSL::InputAttachmentTest_FS, SHADER_TYPE_PIXEL, SHADER_SOURCE_LANGUAGE_GLSL);
+}
+
+TEST(SPIRVReflectionTest, ComputeShader)
+{
+    if (!TestingEnvironment::GetInstance()->GetDevice()->GetDeviceInfo().Features.ComputeShaders)
+    {
+        GTEST_SKIP() << "Compute shaders are not supported by this device";
+    }
+
+    TestSPIRVReflection("Compute shader test - HLSL CS", HLSL::FillTextureCS, SHADER_TYPE_COMPUTE, SHADER_SOURCE_LANGUAGE_HLSL);
+}
+
+TEST(SPIRVReflectionTest, GeometryShader)
+{
+    if (!TestingEnvironment::GetInstance()->GetDevice()->GetDeviceInfo().Features.GeometryShaders)
+    {
+        GTEST_SKIP() << "Geometry shaders are not supported by this device";
+    }
+
+    TestSPIRVReflection("Geometry shader test - HLSL GS", HLSL::GSTest_GS, SHADER_TYPE_GEOMETRY, SHADER_SOURCE_LANGUAGE_HLSL);
+}
+
+TEST(SPIRVReflectionTest, TessellationShaders)
+{
+    if (!TestingEnvironment::GetInstance()->GetDevice()->GetDeviceInfo().Features.Tessellation)
+    {
+        GTEST_SKIP() << "Tessellation is not supported by this device";
+    }
+
+    TestSPIRVReflection("Tessellation test - HLSL HS", HLSL::TessTest_HS, SHADER_TYPE_HULL, SHADER_SOURCE_LANGUAGE_HLSL);
+    TestSPIRVReflection("Tessellation test - HLSL DS", HLSL::TessTest_DS, SHADER_TYPE_DOMAIN, SHADER_SOURCE_LANGUAGE_HLSL);
+}
+
+} // namespace
@@ -142,6 +142,44 @@ int TestRenderDeviceCInterface_CreateShader(struct IRenderDevice* pRenderDevice)
     return num_errors;
 }
 
+int TestRenderDeviceCInterface_CreateShaders(struct IRenderDevice* pRenderDevice)
+{
+    static const char* ShaderSources[] =
+        {
+            "float4 main() : SV_Target {return float4(0.0, 0.0, 0.0, 0.0);}",
+            "float4 main() : SV_Target {return float4(1.0, 0.0, 0.0, 1.0);}",
+            "float4 main() : SV_Target {return float4(0.0, 1.0, 0.0, 1.0);}" //
+        };
+    struct ShaderCreateInfo ShaderCIs[3];
+    struct IShader*         pShaders[3] = {NULL, NULL, NULL};
+    int                     i           = 0;
+
+    int num_errors = 0;
+
+    memset(ShaderCIs, 0, sizeof(ShaderCIs));
+    for (i = 0; i < 3; ++i)
+    {
+        ShaderCIs[i].Desc._DeviceObjectAttribs.Name = "Test shader";
+        ShaderCIs[i].Desc.ShaderType                = SHADER_TYPE_PIXEL;
+
+        ShaderCIs[i].SourceLanguage             = SHADER_SOURCE_LANGUAGE_HLSL;
+        ShaderCIs[i].UseCombinedTextureSamplers = true;
+        ShaderCIs[i].EntryPoint                 = "main";
+        ShaderCIs[i].Source                     = ShaderSources[i];
+    }
+
+    IRenderDevice_CreateShaders(pRenderDevice, 3, ShaderCIs, pShaders);
+    for (i = 0; i < 3; ++i)
+    {
+        if (pShaders[i] != NULL)
+            IObject_Release(pShaders[i]);
+        else
+            ++num_errors;
+    }
+
+    return num_errors;
+}
+
 int TestRenderDeviceCInterface_CreateTexture(struct IRenderDevice* pRenderDevice)
 {
     TextureDesc       TexDesc;
@@ -0,0 +1,163 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Minimal micro-benchmark harness used by DiligentCoreBenchmark.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../../../Primitives/interface/BasicTypes.h"
+
+namespace Diligent
+{
+
+namespace Benchmark
+{
+
+/// Benchmark state that is passed to every benchmark function.
+
+/// The benchmark body is expected to run its timed code in a loop:
+///
+///     DILIGENT_BENCHMARK(Common, MyBenchmark)
+///     {
+///         // Setup
+///         while (State.KeepRunning())
+///         {
+///             // Timed code
+///         }
+///     }
+///
+/// Every iteration of the loop is timed individually. The first NumWarmupIterations
+/// iterations are not recorded.
+class BenchmarkState
+{
+public:
+    BenchmarkState(Uint32 NumWarmupIterations, Uint32 NumRepetitions);
+
+    bool KeepRunning();
+
+    /// Excludes the time until the matching ResumeTiming() call from the current iteration.
+    void PauseTiming();
+    void ResumeTiming();
+
+    /// Sets the number of items processed by one iteration, which is used to report throughput.
+    void SetItemsPerIteration(Uint64 NumItems) { m_ItemsPerIteration = NumItems; }
+
+    /// Sets the number of bytes processed by one iteration, which is used to report bandwidth.
+    void SetBytesPerIteration(Uint64 NumBytes) { m_BytesPerIteration = NumBytes; }
+
+    /// Recorded iteration times, in nanoseconds.
+    const std::vector<double>& GetSamples() const { return m_Samples; }
+
+    Uint64 GetItemsPerIteration() const { return m_ItemsPerIteration; }
+    Uint64 GetBytesPerIteration() const { return m_BytesPerIteration; }
+
+private:
+    static Int64 Now();
+
+    const Uint32 m_NumWarmupIterations;
+    const Uint32 m_NumRepetitions;
+
+    Uint32 m_Iteration         = 0;
+    Int64  m_IterationStart    = 0;
+    Int64  m_PauseStart        = 0;
+    Int64  m_PausedTime        = 0;
+    Uint64 m_ItemsPerIteration = 0;
+    Uint64 m_BytesPerIteration = 0;
+
+    std::vector<double> m_Samples;
+};
+
+using BenchmarkFunctionType = void (*)(BenchmarkState& State);
+
+/// Registers a benchmark function. Use DILIGENT_BENCHMARK macro rather than calling this directly.
+struct BenchmarkRegistrar
+{
+    BenchmarkRegistrar(const char* Group, const char* Name, BenchmarkFunctionType Func);
+};
+
+/// Runs all registered benchmarks that match the command line options and returns the process exit code.
+
+/// Supported options:
+///   --filter=<substring>  - only run benchmarks whose full name (Group.Name) contains the substring
+///   --repetitions=<N>     - number of timed iterations of every benchmark (default: 30)
+///   --warmup=<N>          - number of warmup iterations that are not recorded (default: 3)
+///   --json=<path>         - write results to the JSON file
+///   --list                - list registered benchmarks and exit
+int RunBenchmarks(int argc, char** argv);
+
+
+#if defined(__GNUC__) || defined(__clang__)
+
+/// Prevents the compiler from optimizing away the value.
+template <typename T>
+inline void DoNotOptimize(const T& Value)
+{
+    asm volatile(""
+                 :
+                 : "r,m"(Value)
+                 : "memory");
+}
+
+/// Forces the compiler to assume that all memory may have been modified.
+inline void ClobberMemory()
+{
+    asm volatile(""
+                 :
+                 :
+                 : "memory");
+}
+
+#else
+
+void UseCharPointer(const volatile char*);
+
+template <typename T>
+inline void DoNotOptimize(const T& Value)
+{
+    UseCharPointer(&reinterpret_cast<const volatile char&>(Value));
+}
+
+void ClobberMemory();
+
+#endif
+
+} // namespace Benchmark
+
+} // namespace Diligent
+
+// clang-format off
+#define DILIGENT_BENCHMARK(Group, Name)                                                 \
+    static void Group##_##Name##_Benchmark(Diligent::Benchmark::BenchmarkState& State); \
+    static const Diligent::Benchmark::BenchmarkRegistrar Group##_##Name##_Registrar{    \
+        #Group, #Name, Group##_##Name##_Benchmark};                                     \
+    static void Group##_##Name##_Benchmark(Diligent::Benchmark::BenchmarkState& State)
+// clang-format on
@@ -0,0 +1,421 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "BenchmarkHarness.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+namespace Benchmark
+{
+
+BenchmarkState::BenchmarkState(Uint32 NumWarmupIterations, Uint32 NumRepetitions) :
+    // clang-format off
+    m_NumWarmupIterations{NumWarmupIterations},
+    m_NumRepetitions     {NumRepetitions}
+// clang-format on
+{
+    m_Samples.reserve(NumRepetitions);
+}
+
+Int64 BenchmarkState::Now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool BenchmarkState::KeepRunning()
+{
+    const auto CurrTime = Now();
+    if (m_Iteration > 0)
+    {
+        VERIFY(m_PauseStart == 0, "Timing is paused at the end of the iteration. Call ResumeTiming().");
+        if (m_Iteration > m_NumWarmupIterations)
+            m_Samples.push_back(static_cast<double>(CurrTime - m_IterationStart - m_PausedTime));
+    }
+
+    if (m_Iteration >= m_NumWarmupIterations + m_NumRepetitions)
+        return false;
+
+    ++m_Iteration;
+    m_PausedTime = 0;
+    // Read the time again to exclude the bookkeeping above
+    m_IterationStart = Now();
+    return true;
+}
+
+void BenchmarkState::PauseTiming()
+{
+    VERIFY(m_PauseStart == 0, "Timing is already paused");
+    m_PauseStart = Now();
+}
+
+void BenchmarkState::ResumeTiming()
+{
+    VERIFY(m_PauseStart != 0, "Timing is not paused");
+    m_PausedTime += Now() - m_PauseStart;
+    m_PauseStart = 0;
+}
+
+
+#if !(defined(__GNUC__) || defined(__clang__))
+void UseCharPointer(const volatile char*)
+{
+}
+
+void ClobberMemory()
+{
+    std::atomic_signal_fence(std::memory_order_acq_rel);
+}
+#endif
+
+
+namespace
+{
+
+struct BenchmarkInfo
+{
+    std::string           Name;
+    BenchmarkFunctionType Func;
+};
+
+std::vector<BenchmarkInfo>& GetRegistry()
+{
+    static std::vector<BenchmarkInfo> Registry;
+    return Registry;
+}
+
+struct BenchmarkResult
+{
+    std::string Name;
+    size_t      NumSamples = 0;
+
+    // All times are in nanoseconds
+    double Min    = 0;
+    double Max    = 0;
+    double Mean   = 0;
+    double StdDev = 0;
+    double P50    = 0;
+    double P90    = 0;
+    double P99    = 0;
+
+    Uint64 ItemsPerIteration = 0;
+    Uint64 BytesPerIteration = 0;
+
+    double GetItemsPerSecond() const
+    {
+        return P50 > 0 ? static_cast<double>(ItemsPerIteration) * 1e+9 / P50 : 0;
+    }
+
+    double GetBytesPerSecond() const
+    {
+        return P50 > 0 ? static_cast<double>(BytesPerIteration) * 1e+9 / P50 : 0;
+    }
+};
+
+// Nearest-rank percentile of the sorted samples
+double GetPercentile(const std::vector<double>& SortedSamples, double Percentile)
+{
+    VERIFY_EXPR(!SortedSamples.empty());
+    auto Rank = static_cast<size_t>(std::ceil(Percentile / 100.0 * static_cast<double>(SortedSamples.size())));
+    Rank      = std::max(Rank, size_t{1});
+    return SortedSamples[std::min(Rank, SortedSamples.size()) - 1];
+}
+
+BenchmarkResult ComputeResult(const std::string& Name, const BenchmarkState& State)
+{
+    BenchmarkResult Res;
+    Res.Name              = Name;
+    Res.ItemsPerIteration = State.GetItemsPerIteration();
+    Res.BytesPerIteration = State.GetBytesPerIteration();
+
+    auto Samples   = State.GetSamples();
+    Res.NumSamples = Samples.size();
+    if (Samples.empty())
+        return Res;
+
+    std::sort(Samples.begin(), Samples.end());
+    Res.Min = Samples.front();
+    Res.Max = Samples.back();
+
+    double Sum = 0;
+    for (auto s : Samples)
+        Sum += s;
+    Res.Mean = Sum / static_cast<double>(Samples.size());
+
+    double SqDiffSum = 0;
+    for (auto s : Samples)
+        SqDiffSum += (s - Res.Mean) * (s - Res.Mean);
+    Res.StdDev = Samples.size() > 1 ? std::sqrt(SqDiffSum / static_cast<double>(Samples.size() - 1)) : 0;
+
+    Res.P50 = GetPercentile(Samples, 50);
+    Res.P90 = GetPercentile(Samples, 90);
+    Res.P99 = GetPercentile(Samples, 99);
+
+    return Res;
+}
+
+std::string FormatTime(double Ns)
+{
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2);
+    if (Ns < 1e+3)
+        ss << Ns << " ns";
+    else if (Ns < 1e+6)
+        ss << Ns * 1e-3 << " us";
+    else if (Ns < 1e+9)
+        ss << Ns * 1e-6 << " ms";
+    else
+        ss << Ns * 1e-9 << " s";
+    return ss.str();
+}
+
+std::string FormatRate(double Rate, const char* Units)
+{
+    if (Rate <= 0)
+        return "";
+
+    static constexpr const char* Prefixes[] = {"", "k", "M", "G", "T"};
+
+    size_t Prefix = 0;
+    while (Rate >= 1000 && Prefix + 1 < _countof(Prefixes))
+    {
+        Rate /= 1000;
+        ++Prefix;
+    }
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2) << Rate << ' ' << Prefixes[Prefix] << Units;
+    return ss.str();
+}
+
+std::string EscapeJsonString(const std::string& Str)
+{
+    std::string Escaped;
+    Escaped.reserve(Str.length());
+    for (auto c : Str)
+    {
+        switch (c)
+        {
+            case '"': Escaped += "\\\""; break;
+            case '\\': Escaped += "\\\\"; break;
+            case '\n': Escaped += "\\n"; break;
+            case '\t': Escaped += "\\t"; break;
+            default: Escaped += c;
+        }
+    }
+    return Escaped;
+}
+
+bool WriteJson(const char* Path, const std::vector<BenchmarkResult>& Results, Uint32 NumWarmupIterations, Uint32 NumRepetitions)
+{
+    std::ofstream File{Path};
+    if (!File)
+        return false;
+
+    char       DateStr[64] = {};
+    const auto Time        = std::time(nullptr);
+    std::strftime(DateStr, sizeof(DateStr), "%Y-%m-%dT%H:%M:%S", std::localtime(&Time));
+
+    File << std::setprecision(17);
+    File << "{\n";
+    File << "  \"context\": {\n";
+    File << "    \"date\": \"" << DateStr << "\",\n";
+    File << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+#ifdef DILIGENT_DEBUG
+    File << "    \"build_type\": \"debug\",\n";
+#else
+    File << "    \"build_type\": \"release\",\n";
+#endif
+    File << "    \"warmup_iterations\": " << NumWarmupIterations << ",\n";
+    File << "    \"repetitions\": " << NumRepetitions << "\n";
+    File << "  },\n";
+    File << "  \"benchmarks\": [";
+    for (size_t i = 0; i < Results.size(); ++i)
+    {
+        const auto& Res = Results[i];
+        File << (i > 0 ? "," : "") << "\n    {\n";
+        File << "      \"name\": \"" << EscapeJsonString(Res.Name) << "\",\n";
+        File << "      \"samples\": " << Res.NumSamples << ",\n";
+        File << "      \"time_unit\": \"ns\",\n";
+        File << "      \"min\": " << Res.Min << ",\n";
+        File << "      \"max\": " << Res.Max << ",\n";
+        File << "      \"mean\": " << Res.Mean << ",\n";
+        File << "      \"stddev\": " << Res.StdDev << ",\n";
+        File << "      \"p50\": " << Res.P50 << ",\n";
+        File << "      \"p90\": " << Res.P90 << ",\n";
+        File << "      \"p99\": " << Res.P99 << ",\n";
+        File << "      \"items_per_second\": " << Res.GetItemsPerSecond() << ",\n";
+        File << "      \"bytes_per_second\": " << Res.GetBytesPerSecond() << "\n";
+        File << "    }";
+    }
+    File << "\n  ]\n";
+    File << "}\n";
+
+    return File.good();
+}
+
+bool ParseUintOption(const char* Arg, const char* Option, Uint32& Value)
+{
+    const auto OptLen = strlen(Option);
+    if (strncmp(Arg, Option, OptLen) != 0)
+        return false;
+
+    Value = static_cast<Uint32>(std::strtoul(Arg + OptLen, nullptr, 10));
+    return true;
+}
+
+} // namespace
+
+
+BenchmarkRegistrar::BenchmarkRegistrar(const char* Group, const char* Name, BenchmarkFunctionType Func)
+{
+    GetRegistry().push_back({std::string{Group} + '.' + Name, Func});
+}
+
+int RunBenchmarks(int argc, char** argv)
+{
+    std::string Filter;
+    std::string JsonPath;
+    Uint32      NumRepetitions      = 30;
+    Uint32      NumWarmupIterations = 3;
+    bool        ListOnly            = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* Arg = argv[i];
+        if (strncmp(Arg, "--filter=", 9) == 0)
+            Filter = Arg + 9;
+        else if (strncmp(Arg, "--json=", 7) == 0)
+            JsonPath = Arg + 7;
+        else if (ParseUintOption(Arg, "--repetitions=", NumRepetitions))
+            continue;
+        else if (ParseUintOption(Arg, "--warmup=", NumWarmupIterations))
+            continue;
+        else if (strcmp(Arg, "--list") == 0)
+            ListOnly = true;
+        else
+        {
+            std::cerr << "Unknown option: " << Arg << "\n"
+                      << "Usage: " << argv[0] << " [--filter=<substring>] [--repetitions=<N>] [--warmup=<N>] [--json=<path>] [--list]\n";
+            return 1;
+        }
+    }
+
+    if (NumRepetitions == 0)
+    {
+        std::cerr << "Number of repetitions must not be zero\n";
+        return 1;
+    }
+
+    auto Benchmarks = GetRegistry();
+    std::sort(Benchmarks.begin(), Benchmarks.end(), [](const BenchmarkInfo& lhs, const BenchmarkInfo& rhs) { return lhs.Name < rhs.Name; });
+
+    if (ListOnly)
+    {
+        for (const auto& Info : Benchmarks)
+        {
+            if (Filter.empty() || Info.Name.find(Filter) != std::string::npos)
+                std::cout << Info.Name << "\n";
+        }
+        return 0;
+    }
+
+#ifdef DILIGENT_DEBUG
+    std::cout << "WARNING: this is a debug build. Timings are not representative.\n\n";
+#endif
+
+    // clang-format off
+    std::cout << std::left  << std::setw(72) << "Benchmark"
+              << std::right << std::setw(12) << "p50"
+                            << std::setw(12) << "p90"
+                            << std::setw(12) << "p99"
+                            << std::setw(12) << "stddev"
+                            << std::setw(16) << "items/s"
+                            << std::setw(14) << "bytes/s" << "\n";
+    // clang-format on
+    std::cout << std::string(72 + 12 * 4 + 16 + 14, '-') << "\n";
+
+    std::vector<BenchmarkResult> Results;
+    for (const auto& Info : Benchmarks)
+    {
+        if (!Filter.empty() && Info.Name.find(Filter) == std::string::npos)
+            continue;
+
+        BenchmarkState State{NumWarmupIterations, NumRepetitions};
+        Info.Func(State);
+        if (State.GetSamples().empty())
+        {
+            std::cerr << Info.Name << ": no samples were recorded. Make sure the benchmark calls State.KeepRunning()\n";
+            continue;
+        }
+
+        Results.emplace_back(ComputeResult(Info.Name, State));
+        const auto& Res = Results.back();
+
+        // clang-format off
+        std::cout << std::left  << std::setw(72) << Res.Name
+                  << std::right << std::setw(12) << FormatTime(Res.P50)
+                                << std::setw(12) << FormatTime(Res.P90)
+                                << std::setw(12) << FormatTime(Res.P99)
+                                << std::setw(12) << FormatTime(Res.StdDev)
+                                << std::setw(16) << FormatRate(Res.GetItemsPerSecond(), "/s")
+                                << std::setw(14) << FormatRate(Res.GetBytesPerSecond(), "B/s") << std::endl;
+        // clang-format on
+    }
+
+    if (!JsonPath.empty())
+    {
+        if (!WriteJson(JsonPath.c_str(), Results, NumWarmupIterations, NumRepetitions))
+        {
+            std::cerr << "Failed to write benchmark results to " << JsonPath << "\n";
+            return 1;
+        }
+        std::cout << "\nResults were written to " << JsonPath << "\n";
+    }
+
+    return 0;
+}
+
+} // namespace Benchmark
+
+} // namespace Diligent
@@ -0,0 +1,309 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "DefaultRawMemoryAllocator.hpp"
+#include "FixedBlockMemoryAllocator.hpp"
+#include "DynamicLinearAllocator.hpp"
+#include "FrameArena.hpp"
+#include "TrackingMemoryAllocator.hpp"
+#include "FastRand.hpp"
+
+#include "BenchmarkHarness.hpp"
+
+using namespace Diligent;
+using namespace Diligent::Benchmark;
+
+namespace
+{
+
+constexpr size_t NumFBAAllocations = 4096;
+
+void FixedBlockAllocatorChurn(BenchmarkState& State, FixedBlockAllocatorMode Mode)
+{
+    FixedBlockMemoryAllocator FBA{DefaultRawMemoryAllocator::GetAllocator(), 64, 256, Mode};
+
+    std::vector<void*> Ptrs(NumFBAAllocations);
+    State.SetItemsPerIteration(NumFBAAllocations * 2);
+    while (State.KeepRunning())
+    {
+        for (auto& Ptr : Ptrs)
+            Ptr = FBA.Allocate(64, "FBA benchmark", __FILE__, __LINE__);
+        DoNotOptimize(Ptrs.data());
+        for (auto* Ptr : Ptrs)
+            FBA.Free(Ptr);
+    }
+}
+
+void FixedBlockAllocatorMultithreadedChurn(BenchmarkState& State, FixedBlockAllocatorMode Mode, bool Prefetch = false)
+{
+    FixedBlockMemoryAllocator FBA{DefaultRawMemoryAllocator::GetAllocator(), 64, 256, Mode};
+
+    constexpr size_t NumThreads = 4;
+    State.SetItemsPerIteration(NumThreads * NumFBAAllocations * 2);
+    while (State.KeepRunning())
+    {
+        std::vector<std::thread> Threads;
+        for (size_t t = 0; t < NumThreads; ++t)
+        {
+            Threads.emplace_back([&FBA, Prefetch]() {
+                std::vector<void*> Ptrs(NumFBAAllocations);
+                if (Prefetch)
+                    FBA.Prefetch(static_cast<Uint32>(NumFBAAllocations));
+                for (auto& Ptr : Ptrs)
+                    Ptr = FBA.Allocate(64, "FBA benchmark", __FILE__, __LINE__);
+                DoNotOptimize(Ptrs.data());
+                for (auto* Ptr : Ptrs)
+                    FBA.Free(Ptr);
+            });
+        }
+        for (auto& Thread : Threads)
+            Thread.join();
+    }
+}
+
+// Every thread keeps a set of live blocks and randomly replaces them one at a time
+void FixedBlockAllocatorRandomChurn(BenchmarkState& State, FixedBlockAllocatorMode Mode)
+{
+    constexpr Uint32 AllocSize             = 256;
+    constexpr Uint32 NumAllocationsPerPage = 64;
+    constexpr size_t NumLiveAllocations    = 256;
+    constexpr size_t NumIterations         = 20000;
+
+    FixedBlockMemoryAllocator FBA{DefaultRawMemoryAllocator::GetAllocator(), AllocSize, NumAllocationsPerPage, Mode};
+
+    const size_t NumThreads = std::max(std::thread::hardware_concurrency(), 4u);
+    State.SetItemsPerIteration(NumThreads * NumIterations * 2);
+    while (State.KeepRunning())
+    {
+        std::vector<std::thread> Threads;
+        for (size_t t = 0; t < NumThreads; ++t)
+        {
+            Threads.emplace_back(
+                [&FBA](unsigned int Seed) {
+                    FastRandInt        Rnd{Seed, 0, static_cast<int>(NumLiveAllocations - 1)};
+                    std::vector<void*> Ptrs(NumLiveAllocations);
+                    for (auto& Ptr : Ptrs)
+                        Ptr = FBA.Allocate(AllocSize, "FBA benchmark", __FILE__, __LINE__);
+
+                    for (size_t i = 0; i < NumIterations; ++i)
+                    {
+                        auto& Ptr = Ptrs[Rnd()];
+                        FBA.Free(Ptr);
+                        Ptr = FBA.Allocate(AllocSize, "FBA benchmark", __FILE__, __LINE__);
+                    }
+                    DoNotOptimize(Ptrs.data());
+
+                    for (auto* Ptr : Ptrs)
+                        FBA.Free(Ptr);
+                },
+                static_cast<unsigned int>(t));
+        }
+        for (auto& Thread : Threads)
+            Thread.join();
+    }
+}
+
+} // namespace
+
+DILIGENT_BENCHMARK(Common_FixedBlockMemoryAllocator, Locked)
+{
+    FixedBlockAllocatorChurn(State, FixedBlockAllocatorMode::Locked);
+}
+
+DILIGENT_BENCHMARK(Common_FixedBlockMemoryAllocator, ThreadCaching)
+{
+    FixedBlockAllocatorChurn(State, FixedBlockAllocatorMode::ThreadCaching);
+}
+
+DILIGENT_BENCHMARK(Common_FixedBlockMemoryAllocator, LockedMultithreaded)
+{
+    FixedBlockAllocatorMultithreadedChurn(State, FixedBlockAllocatorMode::Locked);
+}
+
+DILIGENT_BENCHMARK(Common_FixedBlockMemoryAllocator, ThreadCachingMultithreaded)
+{
+    FixedBlockAllocatorMultithreadedChurn(State, FixedBlockAllocatorMode::ThreadCaching);
+}
+
+DILIGENT_BENCHMARK(Common_FixedBlockMemoryAllocator, ThreadCachingMultithreadedPrefetch)
+{
+    FixedBlockAllocatorMultithreadedChurn(State, FixedBlockAllocatorMode::ThreadCaching, true);
+}
+
+DILIGENT_BENCHMARK(Common_FixedBlockMemoryAllocator, LockedRandomChurnMultithreaded)
+{
+    FixedBlockAllocatorRandomChurn(State, FixedBlockAllocatorMode::Locked);
+}
+
+DILIGENT_BENCHMARK(Common_FixedBlockMemoryAllocator, ThreadCachingRandomChurnMultithreaded)
+{
+    FixedBlockAllocatorRandomChurn(State, FixedBlockAllocatorMode::ThreadCaching);
+}
+
+DILIGENT_BENCHMARK(Common_DynamicLinearAllocator, SmallAllocations)
+{
+    DynamicLinearAllocator Allocator{DefaultRawMemoryAllocator::GetAllocator(), 64 << 10};
+
+    constexpr size_t NumAllocations = 4096;
+
+    std::vector<size_t> Sizes(NumAllocations);
+    FastRandInt         Rnd{0, 1, 256};
+    for (auto& Size : Sizes)
+        Size = static_cast<size_t>(Rnd());
+
+    State.SetItemsPerIteration(NumAllocations);
+    while (State.KeepRunning())
+    {
+        for (auto Size : Sizes)
+            DoNotOptimize(Allocator.Allocate(Size, 16));
+        Allocator.Discard();
+    }
+}
+
+DILIGENT_BENCHMARK(Common_DynamicLinearAllocator, CopyString)
+{
+    DynamicLinearAllocator Allocator{DefaultRawMemoryAllocator::GetAllocator(), 64 << 10};
+
+    constexpr size_t NumStrings = 1024;
+    State.SetItemsPerIteration(NumStrings);
+    while (State.KeepRunning())
+    {
+        for (size_t i = 0; i < NumStrings; ++i)
+            DoNotOptimize(Allocator.CopyString("g_Texture_DiffuseMap"));
+        Allocator.Discard();
+    }
+}
+
+namespace
+{
+
+// Simulates temporary arrays that are built while recording commands, e.g. barriers or descriptor writes
+template <typename VectorType, typename CreateVectorType>
+void RunTransientVectorsBenchmark(BenchmarkState& State, CreateVectorType&& CreateVector)
+{
+    constexpr Uint32 NumVectors = 256;
+
+    State.SetItemsPerIteration(NumVectors);
+    while (State.KeepRunning())
+    {
+        for (Uint32 i = 0; i < NumVectors; ++i)
+        {
+            VectorType Vec = CreateVector();
+            for (Uint32 j = 0; j < 4 + i % 16; ++j)
+                Vec.push_back(j);
+            DoNotOptimize(Vec.data());
+        }
+    }
+}
+
+} // namespace
+
+DILIGENT_BENCHMARK(Common_FrameArena, TransientVectors_Heap)
+{
+    RunTransientVectorsBenchmark<std::vector<Uint64>>(State, []() { return std::vector<Uint64>{}; });
+}
+
+DILIGENT_BENCHMARK(Common_FrameArena, TransientVectors_FrameArena)
+{
+    FrameArena Arena{DefaultRawMemoryAllocator::GetAllocator()};
+    Uint32     NumVectors = 0;
+    RunTransientVectorsBenchmark<FrameVector<Uint64>>(State, [&Arena, &NumVectors]() {
+        // Every benchmark iteration simulates one frame
+        if (NumVectors++ % 256 == 0)
+            Arena.Reset();
+        return FrameVector<Uint64>{Arena};
+    });
+}
+
+namespace
+{
+
+constexpr size_t NumTrackedAllocations = 4096;
+
+void TrackedAllocationChurn(BenchmarkState& State, IMemoryAllocator& Allocator, size_t NumThreads)
+{
+    static constexpr char const* Tags[] = {"Textures", "Buffers", "Shaders", "Pipelines"};
+
+    auto Churn = [&Allocator]() {
+        std::vector<void*> Ptrs(NumTrackedAllocations);
+        for (size_t i = 0; i < NumTrackedAllocations; ++i)
+            Ptrs[i] = Allocator.Allocate(16 + (i % 64) * 8, Tags[i % 4], __FILE__, __LINE__);
+        DoNotOptimize(Ptrs.data());
+        for (auto* Ptr : Ptrs)
+            Allocator.Free(Ptr);
+    };
+
+    State.SetItemsPerIteration(NumThreads * NumTrackedAllocations * 2);
+    while (State.KeepRunning())
+    {
+        if (NumThreads == 1)
+        {
+            Churn();
+            continue;
+        }
+
+        std::vector<std::thread> Threads;
+        for (size_t t = 0; t < NumThreads; ++t)
+            Threads.emplace_back(Churn);
+        for (auto& Thread : Threads)
+            Thread.join();
+    }
+}
+
+} // namespace
+
+DILIGENT_BENCHMARK(Common_TrackingMemoryAllocator, Raw)
+{
+    TrackedAllocationChurn(State, DefaultRawMemoryAllocator::GetAllocator(), 1);
+}
+
+DILIGENT_BENCHMARK(Common_TrackingMemoryAllocator, Tracking)
+{
+    TrackingMemoryAllocator Tracker{DefaultRawMemoryAllocator::GetAllocator()};
+    TrackedAllocationChurn(State, Tracker, 1);
+}
+
+DILIGENT_BENCHMARK(Common_TrackingMemoryAllocator, TrackingExactPeaks)
+{
+    TrackingMemoryAllocator Tracker{DefaultRawMemoryAllocator::GetAllocator(), 0};
+    TrackedAllocationChurn(State, Tracker, 1);
+}
+
+DILIGENT_BENCHMARK(Common_TrackingMemoryAllocator, RawMultithreaded)
+{
+    TrackedAllocationChurn(State, DefaultRawMemoryAllocator::GetAllocator(), 4);
+}
+
+DILIGENT_BENCHMARK(Common_TrackingMemoryAllocator, TrackingMultithreaded)
+{
+    TrackingMemoryAllocator Tracker{DefaultRawMemoryAllocator::GetAllocator()};
+    TrackedAllocationChurn(State, Tracker, 4);
+}
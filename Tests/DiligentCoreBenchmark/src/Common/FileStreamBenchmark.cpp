@@ -0,0 +1,85 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <cstdio>
+#include <string>
+
+#include "BasicFileStream.hpp"
+#include "MappedFileStream.hpp"
+#include "DataBlobImpl.hpp"
+
+#include "BenchmarkHarness.hpp"
+
+using namespace Diligent;
+using namespace Diligent::Benchmark;
+
+namespace
+{
+
+const char* CreateTestFile(size_t Size)
+{
+    static const char* FileName = "FileStreamBenchmark.tmp";
+
+    const std::string Data(Size, 'x');
+    FILE*             pFile = fopen(FileName, "wb");
+    fwrite(Data.data(), 1, Data.size(), pFile);
+    fclose(pFile);
+    return FileName;
+}
+
+constexpr size_t TestFileSize = 1 << 20;
+
+} // namespace
+
+DILIGENT_BENCHMARK(Common_FileStream, BasicFileStream_ReadBlob)
+{
+    const auto* FileName = CreateTestFile(TestFileSize);
+
+    State.SetBytesPerIteration(TestFileSize);
+    while (State.KeepRunning())
+    {
+        RefCntAutoPtr<BasicFileStream> pStream{MakeNewRCObj<BasicFileStream>()(FileName, EFileAccessMode::Read)};
+        RefCntAutoPtr<IDataBlob>       pData{MakeNewRCObj<DataBlobImpl>()(0)};
+        pStream->ReadBlob(pData);
+        DoNotOptimize(pData->GetConstDataPtr());
+    }
+    remove(FileName);
+}
+
+DILIGENT_BENCHMARK(Common_FileStream, MappedFileStream_ReadData)
+{
+    const auto* FileName = CreateTestFile(TestFileSize);
+
+    State.SetBytesPerIteration(TestFileSize);
+    while (State.KeepRunning())
+    {
+        RefCntAutoPtr<MappedFileStream> pStream{MakeNewRCObj<MappedFileStream>()(FileName)};
+        RefCntAutoPtr<IDataBlob>        pData = ReadFileStreamData(pStream);
+        DoNotOptimize(pData->GetConstDataPtr());
+    }
+    remove(FileName);
+}
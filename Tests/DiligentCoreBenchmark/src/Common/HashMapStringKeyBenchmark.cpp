@@ -0,0 +1,170 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "HashUtils.hpp"
+
+#include "BenchmarkHarness.hpp"
+
+using namespace Diligent;
+using namespace Diligent::Benchmark;
+
+namespace
+{
+
+// Generates names that resemble shader resource variable names
+std::vector<std::string> GenerateNames(size_t NumNames)
+{
+    static constexpr const char* Prefixes[] = {"g_Texture", "g_Buffer", "g_Sampler", "cbCamera", "g_tex2DShadowMap", "g_RWStructuredBuffer"};
+    static constexpr const char* Suffixes[] = {"", "_sampler", "Albedo", "NormalMap", "Data"};
+
+    std::vector<std::string> Names;
+    Names.reserve(NumNames);
+    for (size_t i = 0; i < NumNames; ++i)
+    {
+        Names.emplace_back(std::string{Prefixes[i % _countof(Prefixes)]} + Suffixes[(i / _countof(Prefixes)) % _countof(Suffixes)] + std::to_string(i));
+    }
+    return Names;
+}
+
+using StringKeyMap = std::unordered_map<HashMapStringKey, Uint32, HashMapStringKey::Hasher>;
+
+// sdbm hash that was previously used by CStringHash, kept as a baseline
+size_t ComputeSdbmHash(const char* Str)
+{
+    size_t Seed = 0;
+    while (size_t Ch = static_cast<unsigned char>(*(Str++)))
+        Seed = Seed * 65599 + Ch;
+    return Seed;
+}
+
+template <typename HashFuncType>
+void RunStringHashBenchmark(BenchmarkState& State, size_t Len, HashFuncType&& HashFunc)
+{
+    constexpr size_t NumStrings = 256;
+
+    std::vector<std::string> Strings(NumStrings);
+    size_t                   TotalBytes = 0;
+    for (size_t i = 0; i < NumStrings; ++i)
+    {
+        Strings[i] = std::to_string(i) + "_";
+        while (Strings[i].length() < Len)
+            Strings[i].push_back(static_cast<char>('a' + (Strings[i].length() * 7 + i) % 26));
+        TotalBytes += Strings[i].length();
+    }
+
+    State.SetItemsPerIteration(NumStrings);
+    State.SetBytesPerIteration(TotalBytes);
+    while (State.KeepRunning())
+    {
+        for (const auto& Str : Strings)
+            DoNotOptimize(HashFunc(Str.c_str()));
+    }
+}
+
+} // namespace
+
+DILIGENT_BENCHMARK(Common_HashMapStringKey, ComputeHash)
+{
+    const auto Names = GenerateNames(1024);
+
+    State.SetItemsPerIteration(Names.size());
+    while (State.KeepRunning())
+    {
+        for (const auto& Name : Names)
+            DoNotOptimize(CStringHash<char>{}(Name.c_str()));
+    }
+}
+
+// clang-format off
+DILIGENT_BENCHMARK(Common_HashMapStringKey, StringHash_Len8)     { RunStringHashBenchmark(State,    8, CStringHash<char>{}); }
+DILIGENT_BENCHMARK(Common_HashMapStringKey, StringHash_Len32)    { RunStringHashBenchmark(State,   32, CStringHash<char>{}); }
+DILIGENT_BENCHMARK(Common_HashMapStringKey, StringHash_Len128)   { RunStringHashBenchmark(State,  128, CStringHash<char>{}); }
+DILIGENT_BENCHMARK(Common_HashMapStringKey, StringHash_Len1024)  { RunStringHashBenchmark(State, 1024, CStringHash<char>{}); }
+DILIGENT_BENCHMARK(Common_HashMapStringKey, SdbmHash_Len8)       { RunStringHashBenchmark(State,    8, ComputeSdbmHash); }
+DILIGENT_BENCHMARK(Common_HashMapStringKey, SdbmHash_Len32)      { RunStringHashBenchmark(State,   32, ComputeSdbmHash); }
+DILIGENT_BENCHMARK(Common_HashMapStringKey, SdbmHash_Len128)     { RunStringHashBenchmark(State,  128, ComputeSdbmHash); }
+DILIGENT_BENCHMARK(Common_HashMapStringKey, SdbmHash_Len1024)    { RunStringHashBenchmark(State, 1024, ComputeSdbmHash); }
+// clang-format on
+
+DILIGENT_BENCHMARK(Common_HashMapStringKey, Insert)
+{
+    const auto Names = GenerateNames(1024);
+
+    State.SetItemsPerIteration(Names.size());
+    while (State.KeepRunning())
+    {
+        StringKeyMap Map;
+        for (Uint32 i = 0; i < Names.size(); ++i)
+            Map.emplace(HashMapStringKey{Names[i].c_str(), true}, i);
+        DoNotOptimize(Map);
+
+        // Exclude deallocation from the timing
+        State.PauseTiming();
+        Map.clear();
+        State.ResumeTiming();
+    }
+}
+
+DILIGENT_BENCHMARK(Common_HashMapStringKey, Find)
+{
+    const auto Names = GenerateNames(1024);
+
+    StringKeyMap Map;
+    for (Uint32 i = 0; i < Names.size(); ++i)
+        Map.emplace(HashMapStringKey{Names[i].c_str(), true}, i);
+
+    State.SetItemsPerIteration(Names.size());
+    while (State.KeepRunning())
+    {
+        for (const auto& Name : Names)
+            DoNotOptimize(Map.find(Name.c_str()));
+    }
+}
+
+DILIGENT_BENCHMARK(Common_HashMapStringKey, FindPrecomputedHash)
+{
+    const auto Names = GenerateNames(1024);
+
+    StringKeyMap        Map;
+    std::vector<size_t> Hashes(Names.size());
+    for (Uint32 i = 0; i < Names.size(); ++i)
+    {
+        Map.emplace(HashMapStringKey{Names[i].c_str(), true}, i);
+        Hashes[i] = ComputeStringHash(Names[i].c_str());
+    }
+
+    State.SetItemsPerIteration(Names.size());
+    while (State.KeepRunning())
+    {
+        for (size_t i = 0; i < Names.size(); ++i)
+            DoNotOptimize(Map.find(HashMapStringKey{Names[i].c_str(), Hashes[i]}));
+    }
+}
@@ -0,0 +1,270 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <vector>
+
+#include "BasicMath.hpp"
+#include "AdvancedMath.hpp"
+#include "FastRand.hpp"
+
+#include "BenchmarkHarness.hpp"
+
+using namespace Diligent;
+using namespace Diligent::Benchmark;
+
+namespace
+{
+
+constexpr size_t NumMathElements = 4096;
+
+std::vector<float4x4> GenerateMatrices(size_t NumMatrices, FastRand::StateType Seed)
+{
+    FastRandFloat Rnd{Seed, -1.f, 1.f};
+
+    std::vector<float4x4> Matrices(NumMatrices);
+    for (auto& Mat : Matrices)
+    {
+        Mat = float4x4::RotationArbitrary(float3{Rnd(), Rnd(), Rnd() + 2.f}, Rnd() * PI_F) *
+            float4x4::Scale(Rnd() + 2.f) *
+            float4x4::Translation(Rnd(), Rnd(), Rnd());
+    }
+    return Matrices;
+}
+
+std::vector<float4> GenerateVectors(size_t NumVectors, FastRand::StateType Seed)
+{
+    FastRandFloat Rnd{Seed, -10.f, 10.f};
+
+    std::vector<float4> Vectors(NumVectors);
+    for (auto& Vec : Vectors)
+        Vec = float4{Rnd(), Rnd(), Rnd(), 1.f};
+    return Vectors;
+}
+
+std::vector<BoundBox> GenerateBoxes(size_t NumBoxes, FastRand::StateType Seed)
+{
+    FastRandFloat Rnd{Seed, -100.f, 100.f};
+    FastRandFloat RndSize{Seed + 1, 0.1f, 10.f};
+
+    std::vector<BoundBox> Boxes(NumBoxes);
+    for (auto& Box : Boxes)
+    {
+        Box.Min = float3{Rnd(), Rnd(), Rnd()};
+        Box.Max = Box.Min + float3{RndSize(), RndSize(), RndSize()};
+    }
+    return Boxes;
+}
+
+float4x4 GetViewProjMatrix()
+{
+    return float4x4::Translation(0.f, 0.f, 50.f) * float4x4::Projection(PI_F / 3.f, 1.5f, 1.f, 200.f, false);
+}
+
+} // namespace
+
+DILIGENT_BENCHMARK(Common_BasicMath, MatrixMultiply)
+{
+    const auto Matrices = GenerateMatrices(NumMathElements, 0);
+
+    std::vector<float4x4> Results(Matrices.size());
+    State.SetItemsPerIteration(Matrices.size());
+    while (State.KeepRunning())
+    {
+        for (size_t i = 0; i < Matrices.size(); ++i)
+            Results[i] = Matrices[i] * Matrices[(i + 1) % Matrices.size()];
+        DoNotOptimize(Results.data());
+        ClobberMemory();
+    }
+}
+
+DILIGENT_BENCHMARK(Common_BasicMath, MatrixInverse)
+{
+    const auto Matrices = GenerateMatrices(NumMathElements, 1);
+
+    std::vector<float4x4> Results(Matrices.size());
+    State.SetItemsPerIteration(Matrices.size());
+    while (State.KeepRunning())
+    {
+        for (size_t i = 0; i < Matrices.size(); ++i)
+            Results[i] = Matrices[i].Inverse();
+        DoNotOptimize(Results.data());
+        ClobberMemory();
+    }
+}
+
+DILIGENT_BENCHMARK(Common_BasicMath, VectorTransform)
+{
+    const auto Vectors = GenerateVectors(NumMathElements, 2);
+    const auto Matrix  = GenerateMatrices(1, 3)[0];
+
+    std::vector<float4> Results(Vectors.size());
+    State.SetItemsPerIteration(Vectors.size());
+    State.SetBytesPerIteration(Vectors.size() * sizeof(float4));
+    while (State.KeepRunning())
+    {
+        for (size_t i = 0; i < Vectors.size(); ++i)
+            Results[i] = Vectors[i] * Matrix;
+        DoNotOptimize(Results.data());
+        ClobberMemory();
+    }
+}
+
+DILIGENT_BENCHMARK(Common_BasicMath, TransformVectorsBulk)
+{
+    const auto Vectors = GenerateVectors(NumMathElements, 2);
+    const auto Matrix  = GenerateMatrices(1, 3)[0];
+
+    std::vector<float4> Results(Vectors.size());
+    State.SetItemsPerIteration(Vectors.size());
+    State.SetBytesPerIteration(Vectors.size() * sizeof(float4));
+    while (State.KeepRunning())
+    {
+        TransformVectors(Vectors.data(), Results.data(), Vectors.size(), Matrix);
+        DoNotOptimize(Results.data());
+        ClobberMemory();
+    }
+}
+
+DILIGENT_BENCHMARK(Common_BasicMath, MultiplyMatricesBulk)
+{
+    const auto Matrices = GenerateMatrices(NumMathElements, 0);
+    const auto ViewProj = GenerateMatrices(1, 3)[0];
+
+    std::vector<float4x4> Results(Matrices.size());
+    State.SetItemsPerIteration(Matrices.size());
+    while (State.KeepRunning())
+    {
+        MultiplyMatrices(Matrices.data(), ViewProj, Results.data(), Matrices.size());
+        DoNotOptimize(Results.data());
+        ClobberMemory();
+    }
+}
+
+DILIGENT_BENCHMARK(Common_BasicMath, QuaternionRotateVector)
+{
+    std::vector<float3> Vectors;
+    for (const auto& Vec : GenerateVectors(NumMathElements, 4))
+        Vectors.emplace_back(Vec.x, Vec.y, Vec.z);
+
+    std::vector<float3> Results(Vectors.size());
+
+    const auto Rotation = Quaternion::RotationFromAxisAngle(float3{1, 2, 3}, 0.75f);
+    State.SetItemsPerIteration(Vectors.size());
+    while (State.KeepRunning())
+    {
+        for (size_t i = 0; i < Vectors.size(); ++i)
+            Results[i] = Rotation.RotateVector(Vectors[i]);
+        DoNotOptimize(Results.data());
+        ClobberMemory();
+    }
+}
+
+DILIGENT_BENCHMARK(Common_AdvancedMath, ExtractViewFrustumPlanes)
+{
+    const auto Matrices = GenerateMatrices(NumMathElements, 5);
+
+    ViewFrustumExt Frustum;
+    State.SetItemsPerIteration(Matrices.size());
+    while (State.KeepRunning())
+    {
+        for (const auto& Mat : Matrices)
+        {
+            ExtractViewFrustumPlanesFromMatrix(Mat, Frustum, false);
+            DoNotOptimize(Frustum);
+        }
+    }
+}
+
+DILIGENT_BENCHMARK(Common_AdvancedMath, GetBoxVisibility)
+{
+    const auto Boxes = GenerateBoxes(NumMathElements, 6);
+
+    ViewFrustum Frustum;
+    ExtractViewFrustumPlanesFromMatrix(GetViewProjMatrix(), Frustum, false);
+
+    State.SetItemsPerIteration(Boxes.size());
+    while (State.KeepRunning())
+    {
+        Uint32 NumVisible = 0;
+        for (const auto& Box : Boxes)
+            NumVisible += GetBoxVisibility(Frustum, Box) != BoxVisibility::Invisible ? 1 : 0;
+        DoNotOptimize(NumVisible);
+    }
+}
+
+DILIGENT_BENCHMARK(Common_AdvancedMath, GetBoxVisibilityExt)
+{
+    const auto Boxes = GenerateBoxes(NumMathElements, 6);
+
+    ViewFrustumExt Frustum;
+    ExtractViewFrustumPlanesFromMatrix(GetViewProjMatrix(), Frustum, false);
+
+    State.SetItemsPerIteration(Boxes.size());
+    while (State.KeepRunning())
+    {
+        Uint32 NumVisible = 0;
+        for (const auto& Box : Boxes)
+            NumVisible += GetBoxVisibility(Frustum, Box) != BoxVisibility::Invisible ? 1 : 0;
+        DoNotOptimize(NumVisible);
+    }
+}
+
+DILIGENT_BENCHMARK(Common_AdvancedMath, CullBoxesSoA)
+{
+    const auto Boxes = GenerateBoxes(NumMathElements, 6);
+
+    std::vector<float> MinX, MinY, MinZ, MaxX, MaxY, MaxZ;
+    for (const auto& Box : Boxes)
+    {
+        MinX.push_back(Box.Min.x);
+        MinY.push_back(Box.Min.y);
+        MinZ.push_back(Box.Min.z);
+        MaxX.push_back(Box.Max.x);
+        MaxY.push_back(Box.Max.y);
+        MaxZ.push_back(Box.Max.z);
+    }
+
+    BoundBoxSoA BoxesSoA;
+    BoxesSoA.MinX     = MinX.data();
+    BoxesSoA.MinY     = MinY.data();
+    BoxesSoA.MinZ     = MinZ.data();
+    BoxesSoA.MaxX     = MaxX.data();
+    BoxesSoA.MaxY     = MaxY.data();
+    BoxesSoA.MaxZ     = MaxZ.data();
+    BoxesSoA.NumBoxes = static_cast<Uint32>(Boxes.size());
+
+    ViewFrustumExt Frustum;
+    ExtractViewFrustumPlanesFromMatrix(GetViewProjMatrix(), Frustum, false);
+
+    std::vector<Uint32> VisibleIndices(Boxes.size());
+    State.SetItemsPerIteration(Boxes.size());
+    while (State.KeepRunning())
+    {
+        DoNotOptimize(CullBoxes(Frustum, BoxesSoA, VisibleIndices.data()));
+        ClobberMemory();
+    }
+}
@@ -0,0 +1,104 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <thread>
+#include <vector>
+
+#include "RefCntAutoPtr.hpp"
+#include "RefCountedObjectImpl.hpp"
+
+#include "BenchmarkHarness.hpp"
+
+using namespace Diligent;
+using namespace Diligent::Benchmark;
+
+namespace
+{
+
+class TestObject : public RefCountedObject<IObject>
+{
+public:
+    TestObject(IReferenceCounters* pRefCounters) :
+        RefCountedObject<IObject>{pRefCounters}
+    {}
+
+    virtual void DILIGENT_CALL_TYPE QueryInterface(const INTERFACE_ID& IID, IObject** ppInterface) override final
+    {
+        *ppInterface = nullptr;
+        if (IID == IID_Unknown)
+        {
+            *ppInterface = this;
+            (*ppInterface)->AddRef();
+        }
+    }
+};
+
+constexpr size_t NumLocksPerThread = 4096;
+
+void LockWeakPtr(RefCntWeakPtr<TestObject>& wpObject)
+{
+    for (size_t i = 0; i < NumLocksPerThread; ++i)
+    {
+        auto pObject = wpObject.Lock();
+        DoNotOptimize(pObject.RawPtr());
+    }
+}
+
+} // namespace
+
+DILIGENT_BENCHMARK(Common_RefCntWeakPtr, Lock)
+{
+    RefCntAutoPtr<TestObject> pObject{MakeNewRCObj<TestObject>{}()};
+    RefCntWeakPtr<TestObject> wpObject{pObject};
+
+    State.SetItemsPerIteration(NumLocksPerThread);
+    while (State.KeepRunning())
+    {
+        LockWeakPtr(wpObject);
+    }
+}
+
+DILIGENT_BENCHMARK(Common_RefCntWeakPtr, LockMultithreaded)
+{
+    RefCntAutoPtr<TestObject> pObject{MakeNewRCObj<TestObject>{}()};
+
+    constexpr size_t NumThreads = 4;
+    State.SetItemsPerIteration(NumThreads * NumLocksPerThread);
+    while (State.KeepRunning())
+    {
+        std::vector<std::thread> Threads;
+        for (size_t t = 0; t < NumThreads; ++t)
+        {
+            Threads.emplace_back([&pObject]() {
+                RefCntWeakPtr<TestObject> wpObject{pObject};
+                LockWeakPtr(wpObject);
+            });
+        }
+        for (auto& Thread : Threads)
+            Thread.join();
+    }
+}
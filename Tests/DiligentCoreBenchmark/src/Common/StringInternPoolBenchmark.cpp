@@ -0,0 +1,85 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <string>
+#include <vector>
+
+#include "StringInternPool.hpp"
+#include "DefaultRawMemoryAllocator.hpp"
+
+#include "BenchmarkHarness.hpp"
+
+using namespace Diligent;
+using namespace Diligent::Benchmark;
+
+namespace
+{
+
+std::vector<std::string> GenerateNames(size_t NumNames)
+{
+    std::vector<std::string> Names;
+    Names.reserve(NumNames);
+    for (size_t i = 0; i < NumNames; ++i)
+        Names.emplace_back("g_ShaderResource" + std::to_string(i));
+    return Names;
+}
+
+} // namespace
+
+DILIGENT_BENCHMARK(Common_StringInternPool, InternNew)
+{
+    const auto Names = GenerateNames(1024);
+
+    State.SetItemsPerIteration(Names.size());
+    while (State.KeepRunning())
+    {
+        StringInternPool Pool{DefaultRawMemoryAllocator::GetAllocator()};
+        for (const auto& Name : Names)
+            DoNotOptimize(Pool.Intern(Name));
+
+        // Exclude deallocation from the timing
+        State.PauseTiming();
+        Pool.Clear();
+        State.ResumeTiming();
+    }
+}
+
+DILIGENT_BENCHMARK(Common_StringInternPool, InternExisting)
+{
+    const auto Names = GenerateNames(1024);
+
+    StringInternPool Pool{DefaultRawMemoryAllocator::GetAllocator()};
+    for (const auto& Name : Names)
+        Pool.Intern(Name);
+
+    State.SetItemsPerIteration(Names.size());
+    while (State.KeepRunning())
+    {
+        for (const auto& Name : Names)
+            DoNotOptimize(Pool.Intern(Name));
+    }
+}
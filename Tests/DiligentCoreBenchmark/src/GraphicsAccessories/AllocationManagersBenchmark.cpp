@@ -0,0 +1,359 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <mutex>
+
+#include "VariableSizeAllocationsManager.hpp"
+#include "TLSFAllocationsManager.hpp"
+#include "RingBuffer.hpp"
+#include "ConcurrentRingBuffer.hpp"
+#include "DynamicAtlasManager.hpp"
+#include "DefaultRawMemoryAllocator.hpp"
+#include "FastRand.hpp"
+
+#include "BenchmarkHarness.hpp"
+
+using namespace Diligent;
+using namespace Diligent::Benchmark;
+
+namespace
+{
+
+template <typename AllocationsManagerType>
+void RandomAllocateFree(BenchmarkState& State)
+{
+    constexpr size_t NumAllocations = 4096;
+
+    AllocationsManagerType Mgr{64 << 20, DefaultRawMemoryAllocator::GetAllocator()};
+
+    std::vector<size_t> Sizes(NumAllocations);
+    std::vector<size_t> FreeOrder(NumAllocations);
+    {
+        FastRandInt Rnd{0, 1, 4096};
+        for (auto& Size : Sizes)
+            Size = static_cast<size_t>(Rnd());
+
+        // Release allocations in a shuffled order to fragment the free list
+        for (size_t i = 0; i < NumAllocations; ++i)
+            FreeOrder[i] = i;
+        FastRandInt RndIdx{1, 0, 0x7FFF};
+        for (size_t i = NumAllocations - 1; i > 0; --i)
+            std::swap(FreeOrder[i], FreeOrder[static_cast<size_t>(RndIdx()) % (i + 1)]);
+    }
+
+    std::vector<typename AllocationsManagerType::Allocation> Allocations(NumAllocations);
+    State.SetItemsPerIteration(NumAllocations * 2);
+    while (State.KeepRunning())
+    {
+        for (size_t i = 0; i < NumAllocations; ++i)
+            Allocations[i] = Mgr.Allocate(Sizes[i], 16);
+        for (auto Idx : FreeOrder)
+            Mgr.Free(std::move(Allocations[Idx]));
+    }
+}
+
+// Keeps a large number of live allocations and replaces random ones, which is
+// the typical pattern for long-lived suballocations in a shared buffer.
+template <typename AllocationsManagerType>
+void FragmentedChurn(BenchmarkState& State, const char* MgrName)
+{
+    constexpr size_t NumLiveAllocations = 32768;
+    constexpr size_t NumOpsPerIteration = 4096;
+
+    AllocationsManagerType Mgr{128 << 20, DefaultRawMemoryAllocator::GetAllocator()};
+
+    std::vector<typename AllocationsManagerType::Allocation> Allocations(NumLiveAllocations);
+
+    FastRandInt Rnd{0, 1, 4096};
+    for (auto& Alloc : Allocations)
+        Alloc = Mgr.Allocate(static_cast<size_t>(Rnd()), 16);
+
+    FastRandInt RndIdx{1, 0, 0x7FFF};
+    size_t      NumFailed = 0;
+    State.SetItemsPerIteration(NumOpsPerIteration * 2);
+    while (State.KeepRunning())
+    {
+        for (size_t i = 0; i < NumOpsPerIteration; ++i)
+        {
+            auto& Alloc = Allocations[static_cast<size_t>(RndIdx()) % NumLiveAllocations];
+            if (Alloc.IsValid())
+                Mgr.Free(std::move(Alloc));
+            Alloc = Mgr.Allocate(static_cast<size_t>(Rnd()), 16);
+            if (!Alloc.IsValid())
+                ++NumFailed;
+        }
+    }
+
+    LOG_INFO_MESSAGE(MgrName, " fragmentation: ", Mgr.GetNumFreeBlocks(), " free blocks, ",
+                     Mgr.GetFreeSize() / 1024, " KB free, ", NumFailed, " failed allocations");
+
+    for (auto& Alloc : Allocations)
+    {
+        if (Alloc.IsValid())
+            Mgr.Free(std::move(Alloc));
+    }
+}
+
+} // namespace
+
+DILIGENT_BENCHMARK(GraphicsAccessories_VariableSizeAllocationsManager, RandomAllocateFree)
+{
+    RandomAllocateFree<VariableSizeAllocationsManager>(State);
+}
+
+DILIGENT_BENCHMARK(GraphicsAccessories_TLSFAllocationsManager, RandomAllocateFree)
+{
+    RandomAllocateFree<TLSFAllocationsManager>(State);
+}
+
+DILIGENT_BENCHMARK(GraphicsAccessories_VariableSizeAllocationsManager, FragmentedChurn)
+{
+    FragmentedChurn<VariableSizeAllocationsManager>(State, "VariableSizeAllocationsManager");
+}
+
+DILIGENT_BENCHMARK(GraphicsAccessories_TLSFAllocationsManager, FragmentedChurn)
+{
+    FragmentedChurn<TLSFAllocationsManager>(State, "TLSFAllocationsManager");
+}
+
+DILIGENT_BENCHMARK(GraphicsAccessories_RingBuffer, AllocateFrames)
+{
+    constexpr size_t NumFramesInFlight      = 3;
+    constexpr size_t NumAllocationsPerFrame = 1024;
+
+    RingBuffer RB{16 << 20, DefaultRawMemoryAllocator::GetAllocator()};
+
+    Uint64 FenceValue = 0;
+    State.SetItemsPerIteration(NumAllocationsPerFrame);
+    while (State.KeepRunning())
+    {
+        for (size_t i = 0; i < NumAllocationsPerFrame; ++i)
+            DoNotOptimize(RB.Allocate(256 + (i % 7) * 64, 256));
+
+        RB.FinishCurrentFrame(++FenceValue);
+        if (FenceValue > NumFramesInFlight)
+            RB.ReleaseCompletedFrames(FenceValue - NumFramesInFlight);
+    }
+    RB.ReleaseCompletedFrames(FenceValue);
+}
+
+namespace
+{
+
+// Records one frame on several threads in parallel, each thread making NumAllocationsPerThread allocations.
+// Every thread owns a ConcurrentRingBuffer::ThreadChunk that allocation functions are free to ignore.
+template <typename AllocateFuncType, typename FinishFrameFuncType>
+void ParallelAllocateFrames(BenchmarkState& State, AllocateFuncType&& Allocate, FinishFrameFuncType&& FinishFrame)
+{
+    constexpr size_t NumThreads              = 4;
+    constexpr size_t NumAllocationsPerThread = 1024;
+
+    State.SetItemsPerIteration(NumThreads * NumAllocationsPerThread);
+    while (State.KeepRunning())
+    {
+        std::vector<std::thread> Threads;
+        Threads.reserve(NumThreads);
+        for (size_t t = 0; t < NumThreads; ++t)
+        {
+            Threads.emplace_back([&Allocate]() {
+                ConcurrentRingBuffer::ThreadChunk Chunk;
+                for (size_t i = 0; i < NumAllocationsPerThread; ++i)
+                    DoNotOptimize(Allocate(Chunk, 256 + (i % 7) * 64, 256));
+            });
+        }
+        for (auto& Thread : Threads)
+            Thread.join();
+
+        FinishFrame();
+    }
+}
+
+} // namespace
+
+DILIGENT_BENCHMARK(GraphicsAccessories_RingBuffer, ParallelAllocateFrames_Mutex)
+{
+    constexpr Uint64 NumFramesInFlight = 3;
+
+    RingBuffer RB{16 << 20, DefaultRawMemoryAllocator::GetAllocator()};
+    std::mutex Mtx;
+    Uint64     FenceValue = 0;
+    ParallelAllocateFrames(
+        State,
+        [&](ConcurrentRingBuffer::ThreadChunk& Chunk, size_t Size, size_t Alignment) {
+            std::lock_guard<std::mutex> Lock{Mtx};
+            return RB.Allocate(Size, Alignment);
+        },
+        [&]() {
+            RB.FinishCurrentFrame(++FenceValue);
+            if (FenceValue > NumFramesInFlight)
+                RB.ReleaseCompletedFrames(FenceValue - NumFramesInFlight);
+        });
+    RB.ReleaseCompletedFrames(FenceValue);
+}
+
+DILIGENT_BENCHMARK(GraphicsAccessories_ConcurrentRingBuffer, ParallelAllocateFrames)
+{
+    constexpr Uint64 NumFramesInFlight = 3;
+
+    ConcurrentRingBuffer RB{16 << 20, DefaultRawMemoryAllocator::GetAllocator()};
+    Uint64               FenceValue = 0;
+    ParallelAllocateFrames(
+        State,
+        [&](ConcurrentRingBuffer::ThreadChunk& Chunk, size_t Size, size_t Alignment) {
+            return RB.Allocate(Size, Alignment);
+        },
+        [&]() {
+            RB.FinishCurrentFrame(++FenceValue);
+            if (FenceValue > NumFramesInFlight)
+                RB.ReleaseCompletedFrames(FenceValue - NumFramesInFlight);
+        });
+    RB.ReleaseCompletedFrames(FenceValue);
+}
+
+DILIGENT_BENCHMARK(GraphicsAccessories_ConcurrentRingBuffer, ParallelAllocateFrames_ThreadChunks)
+{
+    constexpr Uint64 NumFramesInFlight = 3;
+
+    ConcurrentRingBuffer RB{16 << 20, DefaultRawMemoryAllocator::GetAllocator(), 64 << 10};
+    Uint64               FenceValue = 0;
+    ParallelAllocateFrames(
+        State,
+        [&](ConcurrentRingBuffer::ThreadChunk& Chunk, size_t Size, size_t Alignment) {
+            return RB.Allocate(Chunk, Size, Alignment);
+        },
+        [&]() {
+            RB.FinishCurrentFrame(++FenceValue);
+            if (FenceValue > NumFramesInFlight)
+                RB.ReleaseCompletedFrames(FenceValue - NumFramesInFlight);
+        });
+    RB.ReleaseCompletedFrames(FenceValue);
+}
+
+namespace
+{
+
+void AtlasAllocateFree(BenchmarkState& State, DynamicAtlasManager::PackingAlgorithm Algorithm)
+{
+    constexpr size_t NumRegions = 1024;
+
+    DynamicAtlasManager Mgr{4096, 4096, Algorithm};
+
+    std::vector<Uint32> Sizes(NumRegions * 2);
+    {
+        FastRandInt Rnd{0, 1, 64};
+        for (auto& Size : Sizes)
+            Size = static_cast<Uint32>(Rnd());
+    }
+
+    std::vector<DynamicAtlasManager::Region> Regions(NumRegions);
+    State.SetItemsPerIteration(NumRegions * 2);
+    while (State.KeepRunning())
+    {
+        for (size_t i = 0; i < NumRegions; ++i)
+            Regions[i] = Mgr.Allocate(Sizes[i * 2], Sizes[i * 2 + 1]);
+        // Free in reverse order to exercise region merging
+        for (size_t i = NumRegions; i > 0; --i)
+        {
+            if (!Regions[i - 1].IsEmpty())
+                Mgr.Free(std::move(Regions[i - 1]));
+        }
+    }
+}
+
+// Fills the atlas with glyph-sized regions and reports the occupancy reached
+void AtlasFillGlyphs(BenchmarkState& State, DynamicAtlasManager::PackingAlgorithm Algorithm, bool Batch, const char* Name)
+{
+    constexpr size_t NumRegions = 8192;
+
+    std::vector<DynamicAtlasManager::Region> Sizes(NumRegions);
+    {
+        FastRandInt RndW{0, 4, 24};
+        FastRandInt RndH{1, 12, 20};
+        for (auto& R : Sizes)
+            R = DynamicAtlasManager::Region{0, 0, static_cast<Uint32>(RndW()), static_cast<Uint32>(RndH())};
+    }
+
+    std::vector<DynamicAtlasManager::Region> Regions(NumRegions);
+
+    float Occupancy = 0;
+    State.SetItemsPerIteration(NumRegions);
+    while (State.KeepRunning())
+    {
+        DynamicAtlasManager Mgr{1024, 1024, Algorithm};
+        if (Batch)
+        {
+            Regions = Sizes;
+            Mgr.Allocate(Regions.data(), static_cast<Uint32>(Regions.size()));
+        }
+        else
+        {
+            for (size_t i = 0; i < NumRegions; ++i)
+                Regions[i] = Mgr.Allocate(Sizes[i].width, Sizes[i].height);
+        }
+
+        State.PauseTiming();
+        Occupancy = Mgr.GetOccupancy();
+        for (auto& R : Regions)
+        {
+            if (!R.IsEmpty())
+                Mgr.Free(std::move(R));
+        }
+        State.ResumeTiming();
+    }
+
+    LOG_INFO_MESSAGE(Name, " occupancy: ", Occupancy * 100.f, "%");
+}
+
+} // namespace
+
+DILIGENT_BENCHMARK(GraphicsAccessories_DynamicAtlasManager, AllocateFree)
+{
+    AtlasAllocateFree(State, DynamicAtlasManager::PackingAlgorithm::Guillotine);
+}
+
+DILIGENT_BENCHMARK(GraphicsAccessories_DynamicAtlasManager, Skyline_AllocateFree)
+{
+    AtlasAllocateFree(State, DynamicAtlasManager::PackingAlgorithm::Skyline);
+}
+
+DILIGENT_BENCHMARK(GraphicsAccessories_DynamicAtlasManager, FillGlyphs)
+{
+    AtlasFillGlyphs(State, DynamicAtlasManager::PackingAlgorithm::Guillotine, false, "Guillotine");
+}
+
+DILIGENT_BENCHMARK(GraphicsAccessories_DynamicAtlasManager, Skyline_FillGlyphs)
+{
+    AtlasFillGlyphs(State, DynamicAtlasManager::PackingAlgorithm::Skyline, false, "Skyline");
+}
+
+DILIGENT_BENCHMARK(GraphicsAccessories_DynamicAtlasManager, Skyline_FillGlyphsBatch)
+{
+    AtlasFillGlyphs(State, DynamicAtlasManager::PackingAlgorithm::Skyline, true, "Skyline (batch)");
+}
@@ -0,0 +1,91 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <thread>
+#include <vector>
+#include <memory>
+
+#include "ResourceReleaseQueue.hpp"
+#include "DefaultRawMemoryAllocator.hpp"
+
+#include "BenchmarkHarness.hpp"
+
+using namespace Diligent;
+using namespace Diligent::Benchmark;
+
+namespace
+{
+
+constexpr size_t NumResourcesPerThread = 4096;
+
+struct DummyResource
+{
+    Uint64 Handle = 0;
+};
+
+// Releases resources from several threads in parallel, then retires them the way
+// the render device does when a command list is submitted and its fence completes.
+void ReleaseAndPurge(BenchmarkState& State, size_t NumThreads)
+{
+    ResourceReleaseQueue<DynamicStaleResourceWrapper> Queue{DefaultRawMemoryAllocator::GetAllocator()};
+
+    Uint64 CmdListNumber = 0;
+    State.SetItemsPerIteration(NumThreads * NumResourcesPerThread);
+    while (State.KeepRunning())
+    {
+        std::vector<std::thread> Threads;
+        for (size_t t = 0; t < NumThreads; ++t)
+        {
+            Threads.emplace_back([&Queue, CmdListNumber]() {
+                for (size_t i = 0; i < NumResourcesPerThread; ++i)
+                    Queue.SafeReleaseResource(DummyResource{i}, CmdListNumber);
+            });
+        }
+        for (auto& Thread : Threads)
+            Thread.join();
+
+        Queue.DiscardStaleResources(CmdListNumber, CmdListNumber + 1);
+        Queue.Purge(CmdListNumber + 1);
+        ++CmdListNumber;
+    }
+
+    const auto Stats = Queue.GetStatistics();
+    LOG_INFO_MESSAGE("Released ", Stats.NumReleasedResources, " resources, average latency: ", Stats.AvgReleaseLatency * 1e6,
+                     " us, max latency: ", Stats.MaxReleaseLatency * 1e6, " us");
+}
+
+} // namespace
+
+DILIGENT_BENCHMARK(GraphicsAccessories_ResourceReleaseQueue, ReleaseAndPurge_1Thread)
+{
+    ReleaseAndPurge(State, 1);
+}
+
+DILIGENT_BENCHMARK(GraphicsAccessories_ResourceReleaseQueue, ReleaseAndPurge_4Threads)
+{
+    ReleaseAndPurge(State, 4);
+}
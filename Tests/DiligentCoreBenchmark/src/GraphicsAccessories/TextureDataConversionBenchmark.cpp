@@ -0,0 +1,115 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <vector>
+
+#include "TextureDataConversion.hpp"
+
+#include "BenchmarkHarness.hpp"
+
+using namespace Diligent;
+using namespace Diligent::Benchmark;
+
+namespace
+{
+
+constexpr Uint32 TextureWidth  = 1024;
+constexpr Uint32 TextureHeight = 1024;
+
+void ConvertTexture(BenchmarkState& State,
+                    TEXTURE_FORMAT  SrcFormat,
+                    Uint32          SrcTexelSize,
+                    TEXTURE_FORMAT  DstFormat,
+                    Uint32          DstTexelSize,
+                    Uint32          SrcComponentCount = 0,
+                    Uint32          NumThreads        = 1)
+{
+    std::vector<Uint8> SrcData(size_t{TextureWidth} * TextureHeight * SrcTexelSize);
+    std::vector<Uint8> DstData(size_t{TextureWidth} * TextureHeight * DstTexelSize);
+    for (size_t i = 0; i < SrcData.size(); ++i)
+        SrcData[i] = static_cast<Uint8>(i * 37);
+
+    TextureDataConversionAttribs Attribs;
+    Attribs.SrcFormat         = SrcFormat;
+    Attribs.DstFormat         = DstFormat;
+    Attribs.SrcComponentCount = SrcComponentCount;
+    Attribs.pSrcData          = SrcData.data();
+    Attribs.pDstData          = DstData.data();
+    Attribs.Width             = TextureWidth;
+    Attribs.Height            = TextureHeight;
+    Attribs.NumThreads        = NumThreads;
+
+    State.SetItemsPerIteration(size_t{TextureWidth} * TextureHeight);
+    while (State.KeepRunning())
+    {
+        ConvertTextureData(Attribs);
+        DoNotOptimize(DstData.data());
+    }
+}
+
+} // namespace
+
+DILIGENT_BENCHMARK(GraphicsAccessories_TextureDataConversion, RGB8ToRGBA8)
+{
+    ConvertTexture(State, TEX_FORMAT_RGBA8_UNORM, 3, TEX_FORMAT_RGBA8_UNORM, 4, 3);
+}
+
+DILIGENT_BENCHMARK(GraphicsAccessories_TextureDataConversion, RGBA8ToBGRA8)
+{
+    ConvertTexture(State, TEX_FORMAT_RGBA8_UNORM, 4, TEX_FORMAT_BGRA8_UNORM, 4);
+}
+
+DILIGENT_BENCHMARK(GraphicsAccessories_TextureDataConversion, SRGB8ToLinear8)
+{
+    ConvertTexture(State, TEX_FORMAT_RGBA8_UNORM_SRGB, 4, TEX_FORMAT_RGBA8_UNORM, 4);
+}
+
+DILIGENT_BENCHMARK(GraphicsAccessories_TextureDataConversion, RGBA8ToFloat32)
+{
+    ConvertTexture(State, TEX_FORMAT_RGBA8_UNORM, 4, TEX_FORMAT_RGBA32_FLOAT, 16);
+}
+
+DILIGENT_BENCHMARK(GraphicsAccessories_TextureDataConversion, Float32ToFloat16)
+{
+    ConvertTexture(State, TEX_FORMAT_RGBA32_FLOAT, 16, TEX_FORMAT_RGBA16_FLOAT, 8);
+}
+
+DILIGENT_BENCHMARK(GraphicsAccessories_TextureDataConversion, Float16ToFloat32)
+{
+    ConvertTexture(State, TEX_FORMAT_RGBA16_FLOAT, 8, TEX_FORMAT_RGBA32_FLOAT, 16);
+}
+
+DILIGENT_BENCHMARK(GraphicsAccessories_TextureDataConversion, RGBA8ToRG16SNorm)
+{
+    // No fast path: goes through the generic float conversion
+    ConvertTexture(State, TEX_FORMAT_RGBA8_UNORM, 4, TEX_FORMAT_RG16_SNORM, 4);
+}
+
+DILIGENT_BENCHMARK(GraphicsAccessories_TextureDataConversion, RGBA8ToRG16SNorm_4Threads)
+{
+    ConvertTexture(State, TEX_FORMAT_RGBA8_UNORM, 4, TEX_FORMAT_RG16_SNORM, 4, 0, 4);
+}
@@ -0,0 +1,173 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include "GraphicsUtilities.h"
+#include "GraphicsAccessories.hpp"
+#include "FastRand.hpp"
+
+#include "BenchmarkHarness.hpp"
+
+using namespace Diligent;
+using namespace Diligent::Benchmark;
+
+namespace
+{
+
+void ComputeMipLevelRGBA8(BenchmarkState& State, TEXTURE_FORMAT Fmt)
+{
+    constexpr Uint32 Width  = 1024;
+    constexpr Uint32 Height = 1024;
+
+    std::vector<Uint8> FineLevel(Width * Height * 4);
+    std::vector<Uint8> CoarseLevel((Width / 2) * (Height / 2) * 4);
+
+    FastRandInt Rnd{0, 0, 255};
+    for (auto& Val : FineLevel)
+        Val = static_cast<Uint8>(Rnd());
+
+    State.SetBytesPerIteration(FineLevel.size());
+    while (State.KeepRunning())
+    {
+        ComputeMipLevel(Width, Height, Fmt, FineLevel.data(), Width * 4, CoarseLevel.data(), (Width / 2) * 4);
+        DoNotOptimize(CoarseLevel.data());
+        ClobberMemory();
+    }
+}
+
+// Full mip chain of a 2048x2048 texture
+class MipChainRGBA8
+{
+public:
+    static constexpr Uint32 Width  = 2048;
+    static constexpr Uint32 Height = 2048;
+
+    MipChainRGBA8()
+    {
+        FastRandInt Rnd{0, 0, 255};
+        FineLevel.resize(Width * Height * 4);
+        for (auto& Val : FineLevel)
+            Val = static_cast<Uint8>(Rnd());
+
+        const Uint32 NumCoarseLevels = ComputeMipLevelsCount(Width, Height) - 1;
+        CoarseLevels.resize(NumCoarseLevels);
+        pCoarseLevels.resize(NumCoarseLevels);
+        for (Uint32 Level = 0; Level < NumCoarseLevels; ++Level)
+        {
+            CoarseLevels[Level].resize(GetLevelWidth(Level + 1) * GetLevelHeight(Level + 1) * 4);
+            pCoarseLevels[Level] = CoarseLevels[Level].data();
+        }
+    }
+
+    static Uint32 GetLevelWidth(Uint32 Level) { return std::max(Width >> Level, 1u); }
+    static Uint32 GetLevelHeight(Uint32 Level) { return std::max(Height >> Level, 1u); }
+
+    std::vector<Uint8>              FineLevel;
+    std::vector<std::vector<Uint8>> CoarseLevels;
+    std::vector<void*>              pCoarseLevels;
+};
+
+void ComputeMipChainLevelByLevel(BenchmarkState& State, TEXTURE_FORMAT Fmt)
+{
+    MipChainRGBA8 Chain;
+
+    State.SetBytesPerIteration(Chain.FineLevel.size());
+    while (State.KeepRunning())
+    {
+        for (Uint32 Level = 0; Level < Chain.CoarseLevels.size(); ++Level)
+        {
+            const void* pFineData = Level == 0 ? Chain.FineLevel.data() : Chain.CoarseLevels[Level - 1].data();
+            ComputeMipLevel(Chain.GetLevelWidth(Level), Chain.GetLevelHeight(Level), Fmt, pFineData, Chain.GetLevelWidth(Level) * 4,
+                            Chain.CoarseLevels[Level].data(), Chain.GetLevelWidth(Level + 1) * 4);
+        }
+        DoNotOptimize(Chain.CoarseLevels.back().data());
+        ClobberMemory();
+    }
+}
+
+void ComputeMipChain(BenchmarkState& State, TEXTURE_FORMAT Fmt, MIP_FILTER_TYPE FilterType, Uint32 NumThreads = 1)
+{
+    MipChainRGBA8 Chain;
+
+    ComputeMipChainAttribs Attribs;
+    Attribs.Format             = Fmt;
+    Attribs.FineLevelWidth     = Chain.Width;
+    Attribs.FineLevelHeight    = Chain.Height;
+    Attribs.pFineLevelData     = Chain.FineLevel.data();
+    Attribs.FineLevelStride    = Chain.Width * 4;
+    Attribs.NumCoarseLevels    = static_cast<Uint32>(Chain.CoarseLevels.size());
+    Attribs.ppCoarseLevelsData = Chain.pCoarseLevels.data();
+    Attribs.FilterType         = FilterType;
+    Attribs.NumThreads         = NumThreads;
+
+    State.SetBytesPerIteration(Chain.FineLevel.size());
+    while (State.KeepRunning())
+    {
+        ComputeMipChain(Attribs);
+        DoNotOptimize(Chain.CoarseLevels.back().data());
+        ClobberMemory();
+    }
+}
+
+} // namespace
+
+DILIGENT_BENCHMARK(GraphicsTools_ComputeMipChain, RGBA8_UNORM_LevelByLevel)
+{
+    ComputeMipChainLevelByLevel(State, TEX_FORMAT_RGBA8_UNORM);
+}
+
+DILIGENT_BENCHMARK(GraphicsTools_ComputeMipChain, RGBA8_UNORM_Box)
+{
+    ComputeMipChain(State, TEX_FORMAT_RGBA8_UNORM, MIP_FILTER_TYPE_BOX);
+}
+
+DILIGENT_BENCHMARK(GraphicsTools_ComputeMipChain, RGBA8_UNORM_Box_4Threads)
+{
+    ComputeMipChain(State, TEX_FORMAT_RGBA8_UNORM, MIP_FILTER_TYPE_BOX, 4);
+}
+
+DILIGENT_BENCHMARK(GraphicsTools_ComputeMipChain, RGBA8_UNORM_SRGB_Box)
+{
+    ComputeMipChain(State, TEX_FORMAT_RGBA8_UNORM_SRGB, MIP_FILTER_TYPE_BOX);
+}
+
+DILIGENT_BENCHMARK(GraphicsTools_ComputeMipChain, RGBA8_UNORM_Kaiser)
+{
+    ComputeMipChain(State, TEX_FORMAT_RGBA8_UNORM, MIP_FILTER_TYPE_KAISER);
+}
+
+DILIGENT_BENCHMARK(GraphicsTools_ComputeMipLevel, RGBA8_UNORM)
+{
+    ComputeMipLevelRGBA8(State, TEX_FORMAT_RGBA8_UNORM);
+}
+
+DILIGENT_BENCHMARK(GraphicsTools_ComputeMipLevel, RGBA8_UNORM_SRGB)
+{
+    ComputeMipLevelRGBA8(State, TEX_FORMAT_RGBA8_UNORM_SRGB);
+}
@@ -0,0 +1,151 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <string>
+#include <vector>
+
+#include "GLSLangUtils.hpp"
+#include "ThreadPool.hpp"
+#include "DebugUtilities.hpp"
+
+#include "BenchmarkHarness.hpp"
+
+using namespace Diligent;
+using namespace Diligent::Benchmark;
+
+namespace
+{
+
+// Material shader whose variants differ by the number of lights and detail layers
+const char* const ParallelCompilationBenchmark_PS = R"(
+cbuffer cbMaterialAttribs
+{
+    float4 g_BaseColorFactor;
+    float4 g_LightDirs[NUM_LIGHTS];
+    float4 g_LightColors[NUM_LIGHTS];
+}
+
+Texture2D<float4>   g_BaseColorMap;
+Texture2D<float4>   g_NormalMap;
+Texture2D<float4>   g_DetailMaps[NUM_DETAIL_LAYERS];
+TextureCube<float4> g_IrradianceMap;
+SamplerState        g_LinearSampler;
+
+struct PSInput
+{
+    float4 Pos    : SV_POSITION;
+    float3 Normal : NORMAL;
+    float2 UV     : TEXCOORD0;
+};
+
+float4 main(in PSInput PSIn) : SV_Target
+{
+    float4 BaseColor = g_BaseColorMap.Sample(g_LinearSampler, PSIn.UV) * g_BaseColorFactor;
+    float3 Normal    = normalize(PSIn.Normal + g_NormalMap.Sample(g_LinearSampler, PSIn.UV).xyz);
+    for (int d = 0; d < NUM_DETAIL_LAYERS; ++d)
+        BaseColor.rgb *= g_DetailMaps[d].Sample(g_LinearSampler, PSIn.UV * float(d + 2)).rgb;
+
+    float3 Color = g_IrradianceMap.Sample(g_LinearSampler, Normal).rgb * BaseColor.rgb;
+    for (int i = 0; i < NUM_LIGHTS; ++i)
+        Color += g_LightColors[i].rgb * BaseColor.rgb * saturate(dot(Normal, -g_LightDirs[i].xyz));
+    return float4(Color, BaseColor.a);
+}
+)";
+
+constexpr Uint32 NumShaderVariants = 64;
+
+// Compiles NumShaderVariants shader variants per iteration using the given pool, or
+// the calling thread only if the pool is null.
+void CompileShaders(BenchmarkState& State, ThreadPool* pPool)
+{
+    GLSLangUtils::InitializeGlslang();
+
+    std::vector<std::string> MacroValues(NumShaderVariants * 2);
+    std::vector<ShaderMacro> Macros(NumShaderVariants * 3);
+    for (Uint32 i = 0; i < NumShaderVariants; ++i)
+    {
+        MacroValues[i * 2 + 0] = std::to_string(1 + i % 8);
+        MacroValues[i * 2 + 1] = std::to_string(1 + i / 8);
+
+        Macros[i * 3 + 0] = {"NUM_LIGHTS", MacroValues[i * 2 + 0].c_str()};
+        Macros[i * 3 + 1] = {"NUM_DETAIL_LAYERS", MacroValues[i * 2 + 1].c_str()};
+        Macros[i * 3 + 2] = {nullptr, nullptr};
+    }
+
+    auto CompileVariant = [&Macros](Uint32 i) {
+        ShaderCreateInfo ShaderCI;
+        ShaderCI.SourceLanguage  = SHADER_SOURCE_LANGUAGE_HLSL;
+        ShaderCI.Desc.ShaderType = SHADER_TYPE_PIXEL;
+        ShaderCI.Desc.Name       = "Parallel compilation benchmark";
+        ShaderCI.EntryPoint      = "main";
+        ShaderCI.Source          = ParallelCompilationBenchmark_PS;
+        ShaderCI.Macros          = &Macros[i * 3];
+
+        auto Bytecode = GLSLangUtils::HLSLtoSPIRV(ShaderCI, nullptr, nullptr);
+        VERIFY(!Bytecode.empty(), "Failed to compile the benchmark shader");
+        DoNotOptimize(Bytecode.data());
+    };
+
+    State.SetItemsPerIteration(NumShaderVariants);
+    while (State.KeepRunning())
+    {
+        if (pPool != nullptr)
+        {
+            pPool->ParallelFor(NumShaderVariants, CompileVariant);
+        }
+        else
+        {
+            for (Uint32 i = 0; i < NumShaderVariants; ++i)
+                CompileVariant(i);
+        }
+    }
+
+    GLSLangUtils::FinalizeGlslang();
+}
+
+} // namespace
+
+DILIGENT_BENCHMARK(ShaderTools_ParallelCompilation, SingleThread)
+{
+    CompileShaders(State, nullptr);
+}
+
+// Compared with SingleThread, shows how the batch compilation in IRenderDevice::CreateShaders
+// scales with the number of cores
+DILIGENT_BENCHMARK(ShaderTools_ParallelCompilation, ThreadPool)
+{
+    // Same setup as the Vulkan device shader compilation pool
+    ThreadPool::CreateInfo PoolCI;
+    PoolCI.OnThreadStarted = [](Uint32) {
+        GLSLangUtils::InitializeGlslang();
+    };
+    PoolCI.OnThreadExiting = [](Uint32) {
+        GLSLangUtils::FinalizeGlslang();
+    };
+    ThreadPool Pool{PoolCI};
+    CompileShaders(State, &Pool);
+}
@@ -0,0 +1,174 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <string>
+#include <vector>
+
+#include "SPIRVShaderResources.hpp"
+#include "GLSLangUtils.hpp"
+#include "DefaultRawMemoryAllocator.hpp"
+#include "DebugUtilities.hpp"
+
+#include "BenchmarkHarness.hpp"
+
+using namespace Diligent;
+using namespace Diligent::Benchmark;
+
+namespace
+{
+
+// Pixel shader with a resource set typical for a material shader
+const char* const ReflectionBenchmark_PS = R"(
+struct LightAttribs
+{
+    float4 Direction;
+    float4 Color;
+    float4 Params;
+};
+
+cbuffer cbCameraAttribs
+{
+    float4x4 g_ViewProj;
+    float4x4 g_ViewProjInv;
+    float4   g_CameraPos;
+}
+
+cbuffer cbMaterialAttribs
+{
+    float4 g_BaseColorFactor;
+    float4 g_EmissiveFactor;
+    float4 g_MetallicRoughness;
+}
+
+StructuredBuffer<LightAttribs> g_Lights;
+RWStructuredBuffer<uint>       g_Counters;
+Buffer<float4>                 g_InstanceData;
+
+Texture2D<float4>      g_BaseColorMap;
+Texture2D<float4>      g_NormalMap;
+Texture2D<float4>      g_PhysicalDescriptorMap;
+Texture2D<float4>      g_OcclusionMap;
+Texture2D<float4>      g_EmissiveMap;
+TextureCube<float4>    g_IrradianceMap;
+TextureCube<float4>    g_PrefilteredEnvMap;
+Texture2D<float2>      g_BRDF_LUT;
+Texture2DArray<float>  g_ShadowMap;
+Texture2D<float4>      g_DetailMaps[4];
+RWTexture2D<float4>    g_DebugOutput;
+
+SamplerState           g_LinearSampler;
+SamplerState           g_PointSampler;
+SamplerComparisonState g_ShadowSampler;
+
+struct PSInput
+{
+    float4 Pos    : SV_POSITION;
+    float3 WPos   : WORLD_POS;
+    float3 Normal : NORMAL;
+    float2 UV     : TEXCOORD0;
+};
+
+float4 main(in PSInput PSIn) : SV_Target
+{
+    float4 BaseColor = g_BaseColorMap.Sample(g_LinearSampler, PSIn.UV) * g_BaseColorFactor;
+    float3 Normal    = normalize(PSIn.Normal + g_NormalMap.Sample(g_LinearSampler, PSIn.UV).xyz);
+    float4 Physical  = g_PhysicalDescriptorMap.Sample(g_LinearSampler, PSIn.UV) * g_MetallicRoughness;
+    float  AO        = g_OcclusionMap.Sample(g_LinearSampler, PSIn.UV).r;
+    float3 Emissive  = g_EmissiveMap.Sample(g_LinearSampler, PSIn.UV).rgb * g_EmissiveFactor.rgb;
+
+    float3 Color = g_IrradianceMap.Sample(g_LinearSampler, Normal).rgb * BaseColor.rgb * AO;
+    float3 View  = normalize(g_CameraPos.xyz - PSIn.WPos);
+    float3 Refl  = reflect(-View, Normal);
+    float2 BRDF  = g_BRDF_LUT.Sample(g_PointSampler, float2(saturate(dot(Normal, View)), Physical.g));
+    Color += g_PrefilteredEnvMap.SampleLevel(g_LinearSampler, Refl, Physical.g * 8.0).rgb * (BRDF.x + BRDF.y);
+
+    float4 ShadowPos = mul(float4(PSIn.WPos, 1.0), g_ViewProj);
+    float  Shadow    = g_ShadowMap.SampleCmpLevelZero(g_ShadowSampler, float3(ShadowPos.xy, 0.0), ShadowPos.z);
+    for (uint i = 0; i < 4; ++i)
+    {
+        LightAttribs Light = g_Lights[i];
+        Color += Light.Color.rgb * saturate(dot(Normal, -Light.Direction.xyz)) * Shadow;
+        Color *= g_DetailMaps[i].Sample(g_LinearSampler, PSIn.UV * Light.Params.x).rgb;
+    }
+    Color += Emissive + g_InstanceData.Load(0).rgb;
+
+    InterlockedAdd(g_Counters[0], 1);
+    g_DebugOutput[uint2(PSIn.Pos.xy)] = float4(Color, 1.0);
+    return float4(Color, BaseColor.a);
+}
+)";
+
+const std::vector<uint32_t>& GetSPIRV()
+{
+    static const std::vector<uint32_t> SPIRV = []() {
+        GLSLangUtils::InitializeGlslang();
+
+        ShaderCreateInfo ShaderCI;
+        ShaderCI.SourceLanguage  = SHADER_SOURCE_LANGUAGE_HLSL;
+        ShaderCI.Desc.ShaderType = SHADER_TYPE_PIXEL;
+        ShaderCI.Desc.Name       = "SPIRV reflection benchmark";
+        ShaderCI.EntryPoint      = "main";
+        ShaderCI.Source          = ReflectionBenchmark_PS;
+
+        auto Bytecode = GLSLangUtils::HLSLtoSPIRV(ShaderCI, nullptr, nullptr);
+        VERIFY(!Bytecode.empty(), "Failed to compile the benchmark shader");
+
+        GLSLangUtils::FinalizeGlslang();
+        return std::vector<uint32_t>{Bytecode.begin(), Bytecode.end()};
+    }();
+    return SPIRV;
+}
+
+void LoadResources(BenchmarkState& State, SPIRVReflectionMode Mode)
+{
+    const auto& SPIRV     = GetSPIRV();
+    auto&       Allocator = DefaultRawMemoryAllocator::GetAllocator();
+
+    ShaderDesc Desc;
+    Desc.Name       = "SPIRV reflection benchmark";
+    Desc.ShaderType = SHADER_TYPE_PIXEL;
+
+    State.SetBytesPerIteration(SPIRV.size() * sizeof(uint32_t));
+    while (State.KeepRunning())
+    {
+        std::string          EntryPoint;
+        SPIRVShaderResources Resources{Allocator, SPIRV, Desc, "_sampler", false, EntryPoint, Mode};
+        DoNotOptimize(Resources.GetTotalResources());
+    }
+}
+
+} // namespace
+
+DILIGENT_BENCHMARK(ShaderTools_SPIRVShaderResources, Direct)
+{
+    LoadResources(State, SPIRVReflectionMode::Direct);
+}
+
+DILIGENT_BENCHMARK(ShaderTools_SPIRVShaderResources, SPIRVCross)
+{
+    LoadResources(State, SPIRVReflectionMode::SPIRVCross);
+}
@@ -0,0 +1,83 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <cstdio>
+#include <string>
+
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+namespace Testing
+{
+
+/// Writes the data to the file, replacing its contents.
+inline void WriteFile(const char* Path, const std::string& Data)
+{
+    FILE* pFile = fopen(Path, "wb");
+    VERIFY_EXPR(pFile != nullptr);
+    if (pFile == nullptr)
+        return;
+    if (!Data.empty())
+        fwrite(Data.data(), 1, Data.size(), pFile);
+    fclose(pFile);
+}
+
+/// Creates a file in the working directory and removes it when the object is destroyed.
+class TempFile
+{
+public:
+    TempFile(const char* Name, const std::string& Data) :
+        m_Path{Name}
+    {
+        WriteFile(Name, Data);
+    }
+
+    ~TempFile()
+    {
+        remove(m_Path.c_str());
+    }
+
+    // clang-format off
+    TempFile           (const TempFile&)  = delete;
+    TempFile           (      TempFile&&) = delete;
+    TempFile& operator=(const TempFile&)  = delete;
+    TempFile& operator=(      TempFile&&) = delete;
+    // clang-format on
+
+    const char* GetPath() const { return m_Path.c_str(); }
+
+private:
+    const std::string m_Path;
+};
+
+} // namespace Testing
+
+} // namespace Diligent
@@ -25,12 +25,20 @@
  *  of the possibility of such damages.
  */
 
+#include <algorithm>
 #include <array>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include <unordered_set>
 
 #include "DefaultRawMemoryAllocator.hpp"
 #include "FixedBlockMemoryAllocator.hpp"
 #include "FixedLinearAllocator.hpp"
 #include "DynamicLinearAllocator.hpp"
+#include "FrameArena.hpp"
+#include "FastRand.hpp"
+#include "TrackingMemoryAllocator.hpp"
 
 #include "gtest/gtest.h"
 
@@ -39,6 +47,39 @@ using namespace Diligent;
 namespace
 {
 
+// Allocates a block in a new thread and releases it, together with one more allocation, in the
+// destructor of a thread-local object that is destroyed after the allocator's thread table
+void AllocateAtThreadExit(IMemoryAllocator& Allocator, size_t Size, const char* Description)
+{
+    struct ThreadExitUser
+    {
+        ~ThreadExitUser()
+        {
+            if (pAllocator == nullptr)
+                return;
+
+            pAllocator->Free(pBlock);
+            pAllocator->Free(pAllocator->Allocate(Size, Description, __FILE__, __LINE__));
+        }
+
+        IMemoryAllocator* pAllocator  = nullptr;
+        size_t            Size        = 0;
+        const char*       Description = nullptr;
+        void*             pBlock      = nullptr;
+    };
+
+    std::thread Thread{
+        [&]() {
+            // Constructed before the thread table of the allocator, so destroyed after it
+            static thread_local ThreadExitUser User;
+            User.pAllocator  = &Allocator;
+            User.Size        = Size;
+            User.Description = Description;
+            User.pBlock      = Allocator.Allocate(Size, Description, __FILE__, __LINE__);
+        }};
+    Thread.join();
+}
+
 TEST(Common_FixedBlockMemoryAllocator, AllocDealloc)
 {
     constexpr Uint32 AllocSize             = 32;
@@ -124,6 +165,245 @@ TEST(Common_FixedBlockMemoryAllocator, UnalignedSize)
     }
 }
 
+TEST(Common_FixedBlockMemoryAllocator, ThreadCaching)
+{
+    constexpr Uint32 AllocSize             = 24;
+    constexpr Uint32 NumAllocationsPerPage = 16;
+
+    FixedBlockMemoryAllocator TestAllocator(DefaultRawMemoryAllocator::GetAllocator(), AllocSize, NumAllocationsPerPage, FixedBlockAllocatorMode::ThreadCaching);
+    EXPECT_EQ(TestAllocator.GetMode(), FixedBlockAllocatorMode::ThreadCaching);
+
+    for (int iter = 0; iter < 3; ++iter)
+    {
+        std::vector<void*>        Allocations;
+        std::unordered_set<void*> UniqueAllocations;
+        constexpr Uint32          NumAllocations = NumAllocationsPerPage * 5 + 3;
+        for (Uint32 i = 0; i < NumAllocations; ++i)
+        {
+            auto* Ptr = TestAllocator.Allocate(AllocSize, "Thread-caching fixed block allocator test", __FILE__, __LINE__);
+            ASSERT_NE(Ptr, nullptr);
+            EXPECT_EQ(reinterpret_cast<size_t>(Ptr) % sizeof(void*), size_t{0});
+            EXPECT_TRUE(UniqueAllocations.insert(Ptr).second);
+            memset(Ptr, static_cast<int>(i & 0xFF), AllocSize);
+            Allocations.push_back(Ptr);
+        }
+
+        for (Uint32 i = 0; i < NumAllocations; ++i)
+        {
+            const auto* Ptr = reinterpret_cast<const Uint8*>(Allocations[i]);
+            for (Uint32 b = 0; b < AllocSize; ++b)
+                EXPECT_EQ(Ptr[b], static_cast<Uint8>(i & 0xFF));
+        }
+
+        // Release every other block first
+        for (size_t i = 0; i < Allocations.size(); i += 2)
+            TestAllocator.Free(Allocations[i]);
+        for (size_t i = 1; i < Allocations.size(); i += 2)
+            TestAllocator.Free(Allocations[i]);
+    }
+}
+
+TEST(Common_FixedBlockMemoryAllocator, ThreadCachingMemoryOverhead)
+{
+    constexpr Uint32 AllocSize             = 64;
+    constexpr Uint32 NumAllocationsPerPage = 16;
+    constexpr size_t NumAllocations        = 1000;
+
+    TrackingMemoryAllocator Tracker{DefaultRawMemoryAllocator::GetAllocator()};
+    {
+        FixedBlockMemoryAllocator TestAllocator(Tracker, AllocSize, NumAllocationsPerPage, FixedBlockAllocatorMode::ThreadCaching);
+
+        std::vector<void*> Allocations(NumAllocations);
+        for (auto& Ptr : Allocations)
+        {
+            Ptr = TestAllocator.Allocate(AllocSize, "Thread-caching fixed block allocator overhead test", __FILE__, __LINE__);
+            ASSERT_NE(Ptr, nullptr);
+        }
+
+        // Pages are carved from larger chunks and use all the space of the aligned page,
+        // so the overhead must be well below the page alignment overhead.
+        const auto LiveBytes = Tracker.GetSnapshot().Total.LiveBytes;
+        EXPECT_LT(static_cast<double>(LiveBytes), NumAllocations * AllocSize * 1.5);
+
+        for (auto* Ptr : Allocations)
+            TestAllocator.Free(Ptr);
+    }
+    EXPECT_EQ(Tracker.GetSnapshot().Total.LiveBytes, 0);
+}
+
+TEST(Common_FixedBlockMemoryAllocator, ThreadCachingThreadExit)
+{
+    constexpr Uint32 AllocSize = 32;
+
+    TrackingMemoryAllocator Tracker{DefaultRawMemoryAllocator::GetAllocator()};
+    {
+        FixedBlockMemoryAllocator TestAllocator(Tracker, AllocSize, 16, FixedBlockAllocatorMode::ThreadCaching);
+        AllocateAtThreadExit(TestAllocator, AllocSize, "Fixed block allocator thread exit test");
+
+        // The blocks released by the exiting thread are available to other threads
+        auto* Ptr = TestAllocator.Allocate(AllocSize, "Fixed block allocator thread exit test", __FILE__, __LINE__);
+        EXPECT_NE(Ptr, nullptr);
+        TestAllocator.Free(Ptr);
+    }
+    EXPECT_EQ(Tracker.GetSnapshot().Total.LiveBytes, 0);
+}
+
+TEST(Common_FixedBlockMemoryAllocator, Prefetch)
+{
+    constexpr Uint32 AllocSize             = 32;
+    constexpr Uint32 NumAllocationsPerPage = 256;
+    constexpr Uint32 NumAllocations        = 200;
+
+    for (auto Mode : {FixedBlockAllocatorMode::Locked, FixedBlockAllocatorMode::ThreadCaching})
+    {
+        FixedBlockMemoryAllocator TestAllocator(DefaultRawMemoryAllocator::GetAllocator(), AllocSize, NumAllocationsPerPage, Mode);
+        TestAllocator.Prefetch(NumAllocations);
+
+        std::vector<Uint8*> Allocations(NumAllocations);
+        for (auto& Ptr : Allocations)
+        {
+            Ptr = static_cast<Uint8*>(TestAllocator.Allocate(AllocSize, "Fixed block allocator prefetch test", __FILE__, __LINE__));
+            ASSERT_NE(Ptr, nullptr);
+        }
+
+        // Blocks of a fresh page are given out contiguously
+        std::sort(Allocations.begin(), Allocations.end());
+        for (size_t i = 1; i < Allocations.size(); ++i)
+            EXPECT_EQ(Allocations[i] - Allocations[i - 1], ptrdiff_t{AllocSize});
+
+        for (auto* Ptr : Allocations)
+            TestAllocator.Free(Ptr);
+    }
+}
+
+TEST(Common_FixedBlockMemoryAllocator, ThreadCachingMultithreaded)
+{
+    constexpr Uint32 AllocSize             = 64;
+    constexpr Uint32 NumAllocationsPerPage = 32;
+    constexpr size_t NumThreads            = 4;
+    constexpr size_t NumAllocations        = 2000;
+
+    FixedBlockMemoryAllocator TestAllocator(DefaultRawMemoryAllocator::GetAllocator(), AllocSize, NumAllocationsPerPage, FixedBlockAllocatorMode::ThreadCaching);
+
+    // Every thread allocates blocks, then the blocks are released by another thread
+    std::vector<std::vector<void*>> Allocations(NumThreads);
+
+    std::vector<std::thread> Threads(NumThreads);
+    for (size_t t = 0; t < NumThreads; ++t)
+    {
+        Threads[t] = std::thread{
+            [&](size_t ThreadId) //
+            {
+                auto& ThreadAllocations = Allocations[ThreadId];
+                for (size_t i = 0; i < NumAllocations; ++i)
+                {
+                    auto* Ptr = TestAllocator.Allocate(AllocSize, "Thread-caching fixed block allocator test", __FILE__, __LINE__);
+                    memset(Ptr, static_cast<int>(ThreadId + 1), AllocSize);
+                    ThreadAllocations.push_back(Ptr);
+
+                    // Release some blocks right away
+                    if ((i % 3) == 0)
+                    {
+                        auto* LastPtr = ThreadAllocations.back();
+                        ThreadAllocations.pop_back();
+                        TestAllocator.Free(LastPtr);
+                    }
+                }
+            },
+            t};
+    }
+    for (auto& Thread : Threads)
+        Thread.join();
+
+    std::unordered_set<void*> UniqueAllocations;
+    for (size_t t = 0; t < NumThreads; ++t)
+    {
+        for (auto* Ptr : Allocations[t])
+        {
+            EXPECT_TRUE(UniqueAllocations.insert(Ptr).second);
+            EXPECT_EQ(*reinterpret_cast<const Uint8*>(Ptr), static_cast<Uint8>(t + 1));
+        }
+    }
+
+    for (size_t t = 0; t < NumThreads; ++t)
+    {
+        Threads[t] = std::thread{
+            [&](size_t ThreadId) //
+            {
+                for (auto* Ptr : Allocations[(ThreadId + 1) % NumThreads])
+                    TestAllocator.Free(Ptr);
+            },
+            t};
+    }
+    for (auto& Thread : Threads)
+        Thread.join();
+}
+
+TEST(Common_FixedBlockMemoryAllocator, MultithreadedRandomChurn)
+{
+    constexpr Uint32 AllocSize             = 64;
+    constexpr Uint32 NumAllocationsPerPage = 16;
+    constexpr size_t NumThreads            = 4;
+    constexpr size_t NumLiveAllocations    = 64;
+    constexpr size_t NumIterations         = 2000;
+
+    for (auto Mode : {FixedBlockAllocatorMode::Locked, FixedBlockAllocatorMode::ThreadCaching})
+    {
+        FixedBlockMemoryAllocator TestAllocator(DefaultRawMemoryAllocator::GetAllocator(), AllocSize, NumAllocationsPerPage, Mode);
+
+        // Every thread randomly replaces its live blocks and checks that no other thread
+        // has written to them in the meantime
+        std::vector<size_t>      NumCorruptedBlocks(NumThreads);
+        std::vector<std::thread> Threads(NumThreads);
+        for (size_t t = 0; t < NumThreads; ++t)
+        {
+            Threads[t] = std::thread{
+                [&](size_t ThreadId) //
+                {
+                    const auto Pattern = static_cast<Uint8>(ThreadId + 1);
+
+                    auto Allocate = [&]() {
+                        auto* Ptr = static_cast<Uint8*>(TestAllocator.Allocate(AllocSize, "Fixed block allocator random churn test", __FILE__, __LINE__));
+                        memset(Ptr, Pattern, AllocSize);
+                        return Ptr;
+                    };
+                    auto Free = [&](Uint8* Ptr) {
+                        for (Uint32 i = 0; i < AllocSize; ++i)
+                        {
+                            if (Ptr[i] != Pattern)
+                            {
+                                ++NumCorruptedBlocks[ThreadId];
+                                break;
+                            }
+                        }
+                        TestAllocator.Free(Ptr);
+                    };
+
+                    FastRandInt         Rnd{static_cast<unsigned int>(ThreadId), 0, static_cast<int>(NumLiveAllocations - 1)};
+                    std::vector<Uint8*> Allocations(NumLiveAllocations);
+                    for (auto& Ptr : Allocations)
+                        Ptr = Allocate();
+
+                    for (size_t i = 0; i < NumIterations; ++i)
+                    {
+                        auto& Ptr = Allocations[Rnd()];
+                        Free(Ptr);
+                        Ptr = Allocate();
+                    }
+
+                    for (auto* Ptr : Allocations)
+                        Free(Ptr);
+                },
+                t};
+        }
+        for (auto& Thread : Threads)
+            Thread.join();
+
+        for (size_t t = 0; t < NumThreads; ++t)
+            EXPECT_EQ(NumCorruptedBlocks[t], size_t{0}) << "Thread " << t;
+    }
+}
+
 TEST(Common_FixedLinearAllocator, EmptyAllocator)
 {
     FixedLinearAllocator Allocator{DefaultRawMemoryAllocator::GetAllocator()};
@@ -229,4 +509,375 @@ TEST(Common_DynamicLinearAllocator, ObjectConstruction)
     EXPECT_TRUE(reinterpret_cast<size_t>(Allocator.Allocate(200, 64)) % 64 == 0);
 }
 
+TEST(Common_FrameArena, AllocateAndRewind)
+{
+    FrameArena Arena{DefaultRawMemoryAllocator::GetAllocator(), 256};
+
+    EXPECT_EQ(Arena.Allocate(0, 16), nullptr);
+    EXPECT_EQ(Arena.GetUsedSize(), 0u);
+
+    auto* Ptr0 = Arena.Allocate(10, 16);
+    EXPECT_TRUE(reinterpret_cast<size_t>(Ptr0) % 16 == 0);
+    EXPECT_TRUE(reinterpret_cast<size_t>(Arena.Allocate(20, 64)) % 64 == 0);
+
+    const auto Marker   = Arena.GetMarker();
+    const auto UsedSize = Arena.GetUsedSize();
+
+    auto* Ptr1 = Arena.Allocate(100, 8);
+    // Does not fit into the first page
+    auto* Ptr2 = Arena.Allocate(1000, 8);
+    EXPECT_NE(Ptr2, nullptr);
+    EXPECT_EQ(Arena.GetNumPages(), 2u);
+
+    Arena.Rewind(Marker);
+    EXPECT_EQ(Arena.GetUsedSize(), UsedSize);
+    EXPECT_EQ(Arena.Allocate(100, 8), Ptr1);
+
+    const auto UsedSize1 = Arena.GetUsedSize();
+    {
+        FrameArena::ScopedMarker ScopedMarker{Arena};
+        for (size_t i = 0; i < 100; ++i)
+            EXPECT_STREQ(Arena.CopyString(std::to_string(i)), std::to_string(i).c_str());
+    }
+    EXPECT_EQ(Arena.GetUsedSize(), UsedSize1);
+
+    // The last allocation can be released
+    auto* Ptr3 = Arena.Allocate(16, 8);
+    Arena.Deallocate(Ptr3, 16);
+    EXPECT_EQ(Arena.Allocate(16, 8), Ptr3);
+    // Other allocations are not released
+    Arena.Deallocate(Ptr1, 100);
+    EXPECT_NE(Arena.Allocate(16, 8), Ptr1);
+
+    Arena.Reset();
+    EXPECT_EQ(Arena.GetUsedSize(), 0u);
+}
+
+TEST(Common_FrameArena, Reset)
+{
+    FrameArena Arena{DefaultRawMemoryAllocator::GetAllocator(), 256};
+
+    for (size_t i = 0; i < 64; ++i)
+        EXPECT_NE(Arena.Allocate(64, 16), nullptr);
+    EXPECT_GT(Arena.GetNumPages(), 1u);
+
+    // Pages are merged when the arena is reset
+    Arena.Reset();
+    EXPECT_EQ(Arena.GetNumPages(), 1u);
+    EXPECT_EQ(Arena.GetUsedSize(), 0u);
+    const auto Capacity = Arena.GetCapacity();
+    EXPECT_GE(Capacity, 64u * 64u);
+    auto* Ptr = Arena.Allocate(64, 16);
+
+    // The steady state does not require new pages
+    Arena.Reset();
+    for (size_t i = 0; i < 64; ++i)
+        EXPECT_NE(Arena.Allocate(64, 16), nullptr);
+    EXPECT_EQ(Arena.GetNumPages(), 1u);
+    EXPECT_EQ(Arena.GetCapacity(), Capacity);
+
+    Arena.Reset();
+    EXPECT_EQ(Arena.Allocate(64, 16), Ptr);
+}
+
+TEST(Common_FrameArena, STLAllocator)
+{
+    FrameArena Arena{DefaultRawMemoryAllocator::GetAllocator(), 256};
+
+    {
+        FrameArena::ScopedMarker Marker{Arena};
+
+        FrameVector<Uint32> Vec{Arena};
+        for (Uint32 i = 0; i < 1000; ++i)
+            Vec.push_back(i);
+        for (Uint32 i = 0; i < 1000; ++i)
+            EXPECT_EQ(Vec[i], i);
+
+        FrameVector<std::string> Strings{Arena};
+        Strings.emplace_back("Test string");
+        EXPECT_EQ(Strings[0], "Test string");
+    }
+    EXPECT_EQ(Arena.GetUsedSize(), 0u);
+}
+
+const TrackingAllocatorTagStats* FindTag(const TrackingAllocatorSnapshot& Snapshot, const char* Description)
+{
+    for (const auto& Tag : Snapshot.Tags)
+    {
+        if (Tag.Description == Description)
+            return &Tag;
+    }
+    return nullptr;
+}
+
+TEST(Common_TrackingMemoryAllocator, LiveAndPeakBytes)
+{
+    TrackingMemoryAllocator Tracker{DefaultRawMemoryAllocator::GetAllocator(), 0};
+
+    static constexpr char TexturesTag[] = "Textures";
+    static constexpr char BuffersTag[]  = "Buffers";
+
+    void* pTex0 = Tracker.Allocate(1000, TexturesTag, __FILE__, __LINE__);
+    void* pTex1 = Tracker.Allocate(3000, TexturesTag, __FILE__, __LINE__);
+    void* pBuff = Tracker.Allocate(100, BuffersTag, __FILE__, __LINE__);
+    void* pNull = Tracker.Allocate(10, nullptr, nullptr, 0);
+    ASSERT_NE(pTex0, nullptr);
+    ASSERT_NE(pTex1, nullptr);
+    ASSERT_NE(pBuff, nullptr);
+    ASSERT_NE(pNull, nullptr);
+    EXPECT_EQ(reinterpret_cast<size_t>(pTex0) % 16, 0u);
+    memset(pTex1, 0xCD, 3000);
+
+    Tracker.Free(pTex1);
+
+    {
+        const auto Snapshot = Tracker.GetSnapshot();
+        EXPECT_EQ(Snapshot.Total.LiveBytes, 1110);
+        EXPECT_EQ(Snapshot.Total.LiveAllocations, 3);
+        EXPECT_EQ(Snapshot.Total.PeakBytes, 4110);
+        EXPECT_EQ(Snapshot.Total.TotalAllocations, 4u);
+        EXPECT_EQ(Snapshot.Total.TotalBytes, 4110u);
+
+        ASSERT_EQ(Snapshot.Tags.size(), 3u);
+        // Tags are sorted by live bytes
+        EXPECT_EQ(Snapshot.Tags[0].Description, "Textures");
+        EXPECT_EQ(Snapshot.Tags[1].Description, "Buffers");
+        EXPECT_EQ(Snapshot.Tags[2].Description, "<unnamed>");
+
+        const auto& Textures = Snapshot.Tags[0];
+        EXPECT_EQ(Textures.LiveBytes, 1000);
+        EXPECT_EQ(Textures.LiveAllocations, 1);
+        EXPECT_EQ(Textures.PeakBytes, 4000);
+        EXPECT_EQ(Textures.TotalAllocations, 2u);
+        EXPECT_EQ(Textures.TotalBytes, 4000u);
+        EXPECT_NE(Textures.FirstAllocationSource.find("AllocatorTest.cpp:"), std::string::npos);
+    }
+
+    Tracker.Free(pTex0);
+    Tracker.Free(pBuff);
+    Tracker.Free(pNull);
+    Tracker.Free(nullptr);
+
+    const auto Snapshot = Tracker.GetSnapshot();
+    EXPECT_EQ(Snapshot.Total.LiveBytes, 0);
+    EXPECT_EQ(Snapshot.Total.LiveAllocations, 0);
+    EXPECT_EQ(Snapshot.Total.PeakBytes, 4110);
+}
+
+TEST(Common_TrackingMemoryAllocator, DescriptionText)
+{
+    TrackingMemoryAllocator Tracker{DefaultRawMemoryAllocator::GetAllocator()};
+
+    // Descriptions with equal text at different addresses share the tag
+    const std::string Desc0{"Dynamic description"};
+    const std::string Desc1{Desc0};
+    void*             p0 = Tracker.Allocate(8, Desc0.c_str(), __FILE__, __LINE__);
+    void*             p1 = Tracker.Allocate(8, Desc1.c_str(), __FILE__, __LINE__);
+
+    const auto Snapshot = Tracker.GetSnapshot();
+    ASSERT_EQ(Snapshot.Tags.size(), 1u);
+    EXPECT_EQ(Snapshot.Tags[0].TotalAllocations, 2u);
+
+    Tracker.Free(p0);
+    Tracker.Free(p1);
+}
+
+TEST(Common_TrackingMemoryAllocator, ReusedDescriptionBuffer)
+{
+    TrackingMemoryAllocator Tracker{DefaultRawMemoryAllocator::GetAllocator()};
+
+    // The same buffer holds different descriptions
+    char  Desc[32] = "Description A";
+    void* p0       = Tracker.Allocate(8, Desc, __FILE__, __LINE__);
+    Desc[12]       = 'B';
+    void* p1       = Tracker.Allocate(16, Desc, __FILE__, __LINE__);
+
+    const auto Snapshot = Tracker.GetSnapshot();
+    ASSERT_EQ(Snapshot.Tags.size(), 2u);
+
+    const auto* pTagA = FindTag(Snapshot, "Description A");
+    const auto* pTagB = FindTag(Snapshot, "Description B");
+    ASSERT_NE(pTagA, nullptr);
+    ASSERT_NE(pTagB, nullptr);
+    EXPECT_EQ(pTagA->LiveBytes, 8);
+    EXPECT_EQ(pTagB->LiveBytes, 16);
+
+    Tracker.Free(p0);
+    Tracker.Free(p1);
+}
+
+TEST(Common_TrackingMemoryAllocator, ThreadExit)
+{
+    TrackingMemoryAllocator Tracker{DefaultRawMemoryAllocator::GetAllocator()};
+
+    AllocateAtThreadExit(Tracker, 64, "Thread exit");
+
+    const auto  Snapshot = Tracker.GetSnapshot();
+    const auto* pTag     = FindTag(Snapshot, "Thread exit");
+    ASSERT_NE(pTag, nullptr);
+    EXPECT_EQ(pTag->TotalAllocations, 2u);
+    EXPECT_EQ(pTag->TotalBytes, 128u);
+    EXPECT_EQ(pTag->LiveAllocations, 0);
+    EXPECT_EQ(pTag->LiveBytes, 0);
+    EXPECT_EQ(pTag->PeakBytes, 64);
+}
+
+TEST(Common_TrackingMemoryAllocator, SizeHistogram)
+{
+    TrackingMemoryAllocator Tracker{DefaultRawMemoryAllocator::GetAllocator()};
+
+    const size_t Sizes[] = {1, 16, 17, 32, 33, 1024, 1025, size_t{1} << 28};
+    // Size classes: (0, 16], (16, 32], (32, 64], ..., (512, 1024], (1024, 2048], ..., the last class
+    const Uint32 ExpectedClasses[] = {0, 0, 1, 1, 2, 6, 7, TrackingAllocatorTagStats::NumSizeClasses - 1};
+
+    std::vector<void*> Ptrs;
+    for (auto Size : Sizes)
+        Ptrs.push_back(Tracker.Allocate(Size, "Histogram", __FILE__, __LINE__));
+
+    std::array<Uint64, TrackingAllocatorTagStats::NumSizeClasses> ExpectedHistogram = {};
+    for (auto SizeClass : ExpectedClasses)
+        ++ExpectedHistogram[SizeClass];
+
+    const auto Snapshot = Tracker.GetSnapshot();
+    EXPECT_EQ(Snapshot.Total.SizeHistogram, ExpectedHistogram);
+
+    for (auto* Ptr : Ptrs)
+        Tracker.Free(Ptr);
+}
+
+TEST(Common_TrackingMemoryAllocator, Multithreaded)
+{
+    TrackingMemoryAllocator Tracker{DefaultRawMemoryAllocator::GetAllocator()};
+
+    constexpr size_t NumThreads         = 4;
+    constexpr size_t NumAllocations     = 1000;
+    constexpr size_t NumLiveAllocations = 10;
+
+    std::vector<std::vector<void*>> LivePtrs(NumThreads);
+    std::vector<std::thread>        Threads;
+    for (size_t t = 0; t < NumThreads; ++t)
+    {
+        Threads.emplace_back([&Tracker, &LivePtrs, t]() {
+            const char*        Tags[] = {"Thread tag 0", "Thread tag 1"};
+            std::vector<void*> Ptrs;
+            for (size_t i = 0; i < NumAllocations; ++i)
+                Ptrs.push_back(Tracker.Allocate(64, Tags[i % 2], __FILE__, __LINE__));
+            for (size_t i = NumLiveAllocations; i < NumAllocations; ++i)
+                Tracker.Free(Ptrs[i]);
+            Ptrs.resize(NumLiveAllocations);
+            LivePtrs[t] = std::move(Ptrs);
+        });
+    }
+    for (auto& Thread : Threads)
+        Thread.join();
+
+    // Counters of the exited threads are retained by the allocator
+    {
+        const auto Snapshot = Tracker.GetSnapshot();
+        EXPECT_EQ(Snapshot.Total.TotalAllocations, NumThreads * NumAllocations);
+        EXPECT_EQ(Snapshot.Total.LiveAllocations, static_cast<Int64>(NumThreads * NumLiveAllocations));
+        EXPECT_EQ(Snapshot.Total.LiveBytes, static_cast<Int64>(NumThreads * NumLiveAllocations * 64));
+        EXPECT_GE(Snapshot.Total.PeakBytes, Snapshot.Total.LiveBytes);
+        EXPECT_LE(Snapshot.Total.PeakBytes, static_cast<Int64>(NumThreads * NumAllocations * 64));
+        ASSERT_EQ(Snapshot.Tags.size(), 2u);
+        EXPECT_EQ(Snapshot.Tags[0].TotalAllocations, NumThreads * NumAllocations / 2);
+    }
+
+    // Release the memory in other threads
+    Threads.clear();
+    for (size_t t = 0; t < NumThreads; ++t)
+    {
+        Threads.emplace_back([&Tracker, &LivePtrs, t]() {
+            for (auto* Ptr : LivePtrs[(t + 1) % NumThreads])
+                Tracker.Free(Ptr);
+        });
+    }
+    for (auto& Thread : Threads)
+        Thread.join();
+
+    const auto Snapshot = Tracker.GetSnapshot();
+    EXPECT_EQ(Snapshot.Total.LiveAllocations, 0);
+    EXPECT_EQ(Snapshot.Total.LiveBytes, 0);
+    for (const auto& Tag : Snapshot.Tags)
+        EXPECT_EQ(Tag.LiveBytes, 0);
+}
+
+TEST(Common_TrackingMemoryAllocator, Diff)
+{
+    TrackingMemoryAllocator Tracker{DefaultRawMemoryAllocator::GetAllocator()};
+
+    void* pStatic = Tracker.Allocate(256, "Static", __FILE__, __LINE__);
+    void* pOld    = Tracker.Allocate(128, "Transient", __FILE__, __LINE__);
+
+    const auto Before = Tracker.GetSnapshot();
+
+    void* pNew = Tracker.Allocate(512, "Frame", __FILE__, __LINE__);
+    Tracker.Free(pOld);
+
+    const auto Diff = Tracker.GetSnapshot().Diff(Before);
+    EXPECT_EQ(Diff.Total.LiveBytes, 512 - 128);
+    EXPECT_EQ(Diff.Total.LiveAllocations, 0);
+    EXPECT_EQ(Diff.Total.TotalAllocations, 1u);
+
+    // The static tag has not changed
+    EXPECT_EQ(FindTag(Diff, "Static"), nullptr);
+
+    const auto* pFrame = FindTag(Diff, "Frame");
+    ASSERT_NE(pFrame, nullptr);
+    EXPECT_EQ(pFrame->LiveBytes, 512);
+    EXPECT_EQ(pFrame->TotalAllocations, 1u);
+
+    const auto* pTransient = FindTag(Diff, "Transient");
+    ASSERT_NE(pTransient, nullptr);
+    EXPECT_EQ(pTransient->LiveBytes, -128);
+    EXPECT_EQ(pTransient->LiveAllocations, -1);
+    EXPECT_EQ(pTransient->TotalAllocations, 0u);
+
+    EXPECT_EQ(Diff.Tags.front().Description, "Frame");
+    EXPECT_EQ(Diff.Tags.back().Description, "Transient");
+
+    Tracker.Free(pStatic);
+    Tracker.Free(pNew);
+}
+
+TEST(Common_TrackingMemoryAllocator, ToJSON)
+{
+    TrackingMemoryAllocator Tracker{DefaultRawMemoryAllocator::GetAllocator()};
+
+    EXPECT_NE(Tracker.GetSnapshot().ToJSON().find("\"Tags\": []"), std::string::npos);
+
+    void* Ptr = Tracker.Allocate(100, "Quoted \"tag\"\\", "File.cpp", 42);
+
+    const auto JSON = Tracker.GetSnapshot().ToJSON();
+    EXPECT_NE(JSON.find("\"Description\": \"Quoted \\\"tag\\\"\\\\\""), std::string::npos) << JSON;
+    EXPECT_NE(JSON.find("\"FirstAllocationSource\": \"File.cpp:42\""), std::string::npos) << JSON;
+    EXPECT_NE(JSON.find("\"LiveBytes\": 100"), std::string::npos) << JSON;
+    EXPECT_NE(JSON.find("\"SizeHistogram\": [0, 0, 0, 1, 0"), std::string::npos) << JSON;
+    EXPECT_EQ(std::count(JSON.begin(), JSON.end(), '{'), std::count(JSON.begin(), JSON.end(), '}'));
+    EXPECT_EQ(std::count(JSON.begin(), JSON.end(), '['), std::count(JSON.begin(), JSON.end(), ']'));
+
+    Tracker.Free(Ptr);
+}
+
+TEST(Common_TrackingMemoryAllocator, Nested)
+{
+    TrackingMemoryAllocator Tracker{DefaultRawMemoryAllocator::GetAllocator()};
+    {
+        FixedBlockMemoryAllocator FBA{Tracker, 64, 16};
+        void*                     Ptr = FBA.Allocate(64, "Block", __FILE__, __LINE__);
+
+        const auto Snapshot = Tracker.GetSnapshot();
+        EXPECT_GT(Snapshot.Total.LiveBytes, 64 * 16);
+        EXPECT_GE(Snapshot.Total.LiveAllocations, 1);
+
+        FBA.Free(Ptr);
+    }
+    EXPECT_EQ(Tracker.GetSnapshot().Total.LiveBytes, 0);
+
+    // Two allocators use different thread cache slots
+    TrackingMemoryAllocator Tracker2{DefaultRawMemoryAllocator::GetAllocator()};
+    Tracker2.Free(Tracker2.Allocate(32, "Tracker2", __FILE__, __LINE__));
+    EXPECT_EQ(Tracker2.GetSnapshot().Total.TotalAllocations, 1u);
+}
+
 } // namespace
@@ -25,7 +25,11 @@
  *  of the possibility of such damages.
  */
 
+#include <algorithm>
+#include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "HashUtils.hpp"
 
@@ -116,4 +120,99 @@ TEST(Common_HashUtils, HashMapStringKey)
     }
 }
 
+TEST(Common_HashUtils, ComputeStringHash)
+{
+    constexpr size_t TextureNameHash = ComputeStringHash("g_Texture");
+    static_assert(TextureNameHash == ComputeStringHash("g_Texture"), "Hash must be computable at compile time");
+
+    const std::string TextureName{"g_Texture"};
+    EXPECT_EQ(TextureNameHash, ComputeStringHash(TextureName.c_str()));
+    EXPECT_EQ(TextureNameHash, CStringHash<char>{}(TextureName.c_str()));
+    EXPECT_NE(TextureNameHash, ComputeStringHash("g_Texture2"));
+    EXPECT_NE(ComputeStringHash(""), ComputeStringHash("a"));
+
+    // Test all code paths of the hash function (0, 1-3, 4-16, 17-48 and more than 48 bytes), and make sure
+    // that the hash does not depend on the data alignment.
+    std::unordered_set<Uint64> Hashes;
+    std::string                Str;
+    for (size_t Len = 0; Len <= 200; ++Len)
+    {
+        Str.push_back(static_cast<char>('a' + Len % 26));
+
+        const auto Hash = ComputeHash64(Str.c_str(), Len);
+        EXPECT_TRUE(Hashes.insert(Hash).second) << "Len=" << Len;
+
+        for (size_t Offset = 1; Offset < 8; ++Offset)
+        {
+            const std::string OffsetStr = std::string(Offset, ' ') + Str;
+            EXPECT_EQ(ComputeHash64(OffsetStr.c_str() + Offset, Len), Hash) << "Len=" << Len << ", Offset=" << Offset;
+        }
+
+        EXPECT_NE(ComputeHash64(Str.c_str(), Len, 1), Hash) << "Len=" << Len;
+    }
+}
+
+TEST(Common_HashUtils, StringHashQuality)
+{
+    // Names that differ only in a few characters are typical for shader variables
+    constexpr size_t NumNames   = 1 << 16;
+    constexpr size_t NumBuckets = 1 << 12;
+
+    std::unordered_set<Uint64> Hashes;
+    std::vector<Uint32>        BucketCounts(NumBuckets);
+    for (size_t i = 0; i < NumNames; ++i)
+    {
+        const auto Name = "g_Texture" + std::to_string(i);
+        const auto Hash = ComputeHash64(Name.c_str(), Name.length());
+        EXPECT_TRUE(Hashes.insert(Hash).second) << Name;
+
+        // Standard containers use the low bits of the hash
+        ++BucketCounts[Hash % NumBuckets];
+    }
+
+    // The expected bucket load is 16 with the standard deviation of 4
+    const auto MinMax = std::minmax_element(BucketCounts.begin(), BucketCounts.end());
+    EXPECT_GE(*MinMax.first, 1u);
+    EXPECT_LE(*MinMax.second, 40u);
+}
+
+TEST(Common_HashUtils, HashMapStringKeyPrecomputedHash)
+{
+    constexpr size_t Str1Hash = ComputeStringHash("String1");
+    constexpr size_t Str2Hash = ComputeStringHash("String2");
+
+    std::unordered_map<HashMapStringKey, int, HashMapStringKey::Hasher> TestMap;
+    TestMap.emplace(HashMapStringKey{"String1", Str1Hash, true}, 1);
+    TestMap.emplace(std::string{"String2"}, 2);
+
+    HashMapStringKey Key1{"String1", Str1Hash};
+    EXPECT_EQ(Key1, HashMapStringKey{"String1"});
+    EXPECT_EQ(Key1.GetHash(), HashMapStringKey{"String1"}.GetHash());
+
+    auto it = TestMap.find(Key1);
+    ASSERT_NE(it, TestMap.end());
+    EXPECT_EQ(it->second, 1);
+
+    it = TestMap.find(HashMapStringKey{"String2", Str2Hash});
+    ASSERT_NE(it, TestMap.end());
+    EXPECT_EQ(it->second, 2);
+
+    it = TestMap.find(HashMapStringKey{"String3", ComputeStringHash("String3")});
+    EXPECT_EQ(it, TestMap.end());
+}
+
+TEST(Common_HashUtils, ComputeHash)
+{
+    EXPECT_EQ(ComputeHash(1, 2.f, 3u), ComputeHash(1, 2.f, 3u));
+    EXPECT_NE(ComputeHash(1, 2), ComputeHash(2, 1));
+    EXPECT_NE(ComputeHash(0), ComputeHash(0, 0));
+
+    std::unordered_set<size_t> Hashes;
+    for (int i = 0; i < 256; ++i)
+    {
+        for (int j = 0; j < 256; ++j)
+            EXPECT_TRUE(Hashes.insert(ComputeHash(i, j)).second) << i << ' ' << j;
+    }
+}
+
 } // namespace
@@ -0,0 +1,151 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+
+#include "LockHelper.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace ThreadingTools;
+
+namespace
+{
+
+TEST(Common_LockHelper, TryLock)
+{
+    LockFlag Flag;
+
+    LockHelper Lock0;
+    EXPECT_TRUE(Lock0.TryLock(Flag));
+    EXPECT_EQ(static_cast<Atomics::Long>(Flag), LockFlag::LOCK_FLAG_LOCKED);
+
+    LockHelper Lock1;
+    EXPECT_FALSE(Lock1.TryLock(Flag));
+
+    Lock0.Unlock();
+    EXPECT_EQ(static_cast<Atomics::Long>(Flag), LockFlag::LOCK_FLAG_UNLOCKED);
+    EXPECT_TRUE(Lock1.TryLock(Flag));
+
+    LockHelper Lock2{std::move(Lock1)};
+    EXPECT_FALSE(Lock0.TryLock(Flag));
+    Lock2.Unlock();
+    EXPECT_TRUE(Lock0.TryLock(Flag));
+}
+
+TEST(Common_LockHelper, MutualExclusion)
+{
+    LockFlag Flag;
+
+    const auto NumThreads = std::max(std::thread::hardware_concurrency(), 4u);
+
+    constexpr size_t NumIterations = 10000;
+
+    size_t                   Counter = 0;
+    std::vector<std::thread> Threads(NumThreads);
+    for (auto& Thread : Threads)
+    {
+        Thread = std::thread{
+            [&]() {
+                for (size_t i = 0; i < NumIterations; ++i)
+                {
+                    LockHelper Lock{Flag};
+                    ++Counter;
+                }
+            }};
+    }
+    for (auto& Thread : Threads)
+        Thread.join();
+
+    EXPECT_EQ(Counter, NumThreads * NumIterations);
+    EXPECT_EQ(static_cast<Atomics::Long>(Flag), LockFlag::LOCK_FLAG_UNLOCKED);
+}
+
+TEST(Common_LockHelper, Statistics)
+{
+    ResetLockStatistics();
+    EnableLockStatistics(true);
+
+    LockFlag Flag0{"Common_LockHelper.Statistics"};
+    // Locks with the same name share statistics
+    LockFlag Flag1{"Common_LockHelper.Statistics"};
+
+    {
+        LockHelper Lock{Flag0};
+    }
+    {
+        LockHelper Lock;
+        EXPECT_TRUE(Lock.TryLock(Flag1));
+    }
+
+    // Hold the lock long enough for the waiting thread to be put to sleep
+    std::atomic_bool WaitStarted{false};
+    std::thread      Thread;
+    {
+        LockHelper Lock{Flag0};
+
+        Thread = std::thread{
+            [&]() {
+                WaitStarted = true;
+                LockHelper Lock{Flag0};
+            }};
+        while (!WaitStarted)
+            std::this_thread::yield();
+        std::this_thread::sleep_for(std::chrono::milliseconds{20});
+    }
+    Thread.join();
+
+    EnableLockStatistics(false);
+    {
+        // Not counted
+        LockHelper Lock{Flag0};
+    }
+
+    const auto AllStats = GetLockStatistics();
+    auto       it       = std::find_if(AllStats.begin(), AllStats.end(), [](const LockStatisticsSnapshot& Stats) { return Stats.Name == "Common_LockHelper.Statistics"; });
+    ASSERT_NE(it, AllStats.end());
+    EXPECT_EQ(it->NumAcquisitions, 4u);
+    EXPECT_EQ(it->NumContentions, 1u);
+    EXPECT_GT(it->NumSpins, 0u);
+    EXPECT_GE(it->NumParks, 1u);
+    EXPECT_GE(it->TotalHoldTimeNs, 20000000u);
+
+    DumpLockStatistics();
+
+    ResetLockStatistics();
+    for (const auto& Stats : GetLockStatistics())
+    {
+        EXPECT_EQ(Stats.NumAcquisitions, 0u);
+        EXPECT_EQ(Stats.TotalHoldTimeNs, 0u);
+    }
+}
+
+} // namespace
@@ -0,0 +1,125 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "MappedFileStream.hpp"
+#include "DataBlobImpl.hpp"
+
+#include "TempFile.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using Diligent::Testing::TempFile;
+
+namespace
+{
+
+TEST(Common_MappedFileStream, Read)
+{
+    const std::string Data{"void main()\n{\n}\n"};
+    TempFile          File{"MappedFileStreamTest_Read.txt", Data};
+
+    RefCntAutoPtr<MappedFileStream> pStream{MakeNewRCObj<MappedFileStream>()(File.GetPath())};
+    ASSERT_TRUE(pStream->IsValid());
+    EXPECT_EQ(pStream->GetSize(), Data.size());
+
+    char Buffer[64] = {};
+    EXPECT_TRUE(pStream->Read(Buffer, 4));
+    EXPECT_EQ(std::string(Buffer, 4), "void");
+
+    RefCntAutoPtr<IDataBlob> pBlob{MakeNewRCObj<DataBlobImpl>()(0)};
+    pStream->ReadBlob(pBlob);
+    ASSERT_EQ(pBlob->GetSize(), Data.size() - 4);
+    EXPECT_EQ(memcmp(pBlob->GetConstDataPtr(), Data.data() + 4, pBlob->GetSize()), 0);
+
+    // The stream is at the end
+    EXPECT_FALSE(pStream->Read(Buffer, 1));
+    EXPECT_FALSE(pStream->Write(Buffer, 1));
+}
+
+TEST(Common_MappedFileStream, ZeroCopyBlob)
+{
+    const std::string Data{"#include \"Structures.fxh\"\n"};
+    TempFile          File{"MappedFileStreamTest_ZeroCopy.txt", Data};
+
+    RefCntAutoPtr<MappedFileStream> pStream{MakeNewRCObj<MappedFileStream>()(File.GetPath())};
+    ASSERT_TRUE(pStream->IsValid());
+
+    RefCntAutoPtr<IDataBlob> pBlob = ReadFileStreamData(pStream);
+    ASSERT_TRUE(pBlob);
+    ASSERT_EQ(pBlob->GetSize(), Data.size());
+    EXPECT_EQ(pBlob->GetConstDataPtr(), pStream->GetMappedData());
+    EXPECT_EQ(memcmp(pBlob->GetConstDataPtr(), Data.data(), Data.size()), 0);
+
+    // The blob keeps the mapping alive
+    pStream.Release();
+    EXPECT_EQ(memcmp(pBlob->GetConstDataPtr(), Data.data(), Data.size()), 0);
+
+    // Writing to the blob must not modify the file
+    static_cast<char*>(pBlob->GetDataPtr())[0] = '/';
+    {
+        RefCntAutoPtr<MappedFileStream> pStream2{MakeNewRCObj<MappedFileStream>()(File.GetPath())};
+        EXPECT_EQ(static_cast<const char*>(pStream2->GetMappedData())[0], '#');
+    }
+
+    // Shrinking the blob does not copy the data
+    const void* pMappedData = pBlob->GetConstDataPtr();
+    pBlob->Resize(8);
+    EXPECT_EQ(pBlob->GetSize(), size_t{8});
+    EXPECT_EQ(pBlob->GetConstDataPtr(), pMappedData);
+
+    // Growing the blob copies the data
+    pBlob->Resize(Data.size() + 1);
+    EXPECT_EQ(pBlob->GetSize(), Data.size() + 1);
+    EXPECT_NE(pBlob->GetConstDataPtr(), pMappedData);
+    EXPECT_EQ(memcmp(pBlob->GetConstDataPtr(), "/include", 8), 0);
+}
+
+TEST(Common_MappedFileStream, EmptyFile)
+{
+    TempFile File{"MappedFileStreamTest_Empty.txt", ""};
+
+    RefCntAutoPtr<MappedFileStream> pStream{MakeNewRCObj<MappedFileStream>()(File.GetPath())};
+    ASSERT_TRUE(pStream->IsValid());
+    EXPECT_EQ(pStream->GetSize(), size_t{0});
+
+    RefCntAutoPtr<IDataBlob> pBlob = ReadFileStreamData(pStream);
+    ASSERT_TRUE(pBlob);
+    EXPECT_EQ(pBlob->GetSize(), size_t{0});
+}
+
+TEST(Common_MappedFileStream, MissingFile)
+{
+    RefCntAutoPtr<MappedFileStream> pStream{MakeNewRCObj<MappedFileStream>()("MappedFileStreamTest_Missing.txt")};
+    EXPECT_FALSE(pStream->IsValid());
+}
+
+} // namespace
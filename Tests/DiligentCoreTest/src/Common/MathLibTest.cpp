@@ -26,10 +26,15 @@
  */
 
 #include <climits>
+#include <cstring>
+#include <functional>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 #include "BasicMath.hpp"
 #include "AdvancedMath.hpp"
+#include "FastRand.hpp"
 
 #include "gtest/gtest.h"
 
@@ -2194,4 +2199,296 @@ TEST(Common_AdvancedMath, CheckBox2DBox2DOverlap)
     // clang-format on
 }
 
+// The tests below verify that SIMD implementation (when DILIGENT_SIMD_MATH_LEVEL > 0)
+// produces results that are bitwise identical to the scalar code.
+
+template <typename T>
+bool IsBitwiseEqual(const T& lhs, const T& rhs)
+{
+    return memcmp(&lhs, &rhs, sizeof(T)) == 0;
+}
+
+float4 TransformVectorScalar(const float4& v, const float4x4& m)
+{
+    return float4{
+        v.x * m[0][0] + v.y * m[1][0] + v.z * m[2][0] + v.w * m[3][0],
+        v.x * m[0][1] + v.y * m[1][1] + v.z * m[2][1] + v.w * m[3][1],
+        v.x * m[0][2] + v.y * m[1][2] + v.z * m[2][2] + v.w * m[3][2],
+        v.x * m[0][3] + v.y * m[1][3] + v.z * m[2][3] + v.w * m[3][3] //
+    };
+}
+
+float3 TransformPointScalar(const float3& p, const float4x4& m)
+{
+    float4 p4 = TransformVectorScalar(float4{p, 1}, m);
+    return float3{p4.x / p4.w, p4.y / p4.w, p4.z / p4.w};
+}
+
+std::vector<float4x4> GenerateRandomMatrices(size_t Count, FastRand::StateType Seed)
+{
+    FastRandFloat Rnd{Seed, -10.f, 10.f};
+
+    std::vector<float4x4> Matrices;
+    Matrices.reserve(Count + 3);
+    Matrices.push_back(float4x4::Identity());
+    Matrices.push_back(float4x4::Translation(1, -2, 3) * float4x4::Projection(PI_F / 4.f, 1.5f, 0.1f, 100.f, false));
+    Matrices.push_back(float4x4::RotationX(1.f) * float4x4::Scale(-1.f, 2.f, 0.5f));
+    for (size_t i = 0; i < Count; ++i)
+    {
+        float4x4 m;
+        for (int j = 0; j < 16; ++j)
+            m.Data()[j] = Rnd();
+        Matrices.push_back(m);
+    }
+    return Matrices;
+}
+
+TEST(Common_BasicMath, SIMDMatrixMultiply)
+{
+    const auto Matrices = GenerateRandomMatrices(256, 0);
+    for (size_t i = 0; i < Matrices.size(); ++i)
+    {
+        const auto& m1 = Matrices[i];
+        const auto& m2 = Matrices[(i * 7 + 3) % Matrices.size()];
+        EXPECT_TRUE(IsBitwiseEqual(m1 * m2, float4x4::MulScalar(m1, m2))) << "i=" << i;
+
+        auto m3 = m1;
+        m3 *= m2;
+        EXPECT_TRUE(IsBitwiseEqual(m3, float4x4::MulScalar(m1, m2))) << "i=" << i;
+    }
+}
+
+TEST(Common_BasicMath, SIMDMatrixInverse)
+{
+    const auto Matrices = GenerateRandomMatrices(256, 1);
+    for (size_t i = 0; i < Matrices.size(); ++i)
+    {
+        const auto& m = Matrices[i];
+        EXPECT_TRUE(IsBitwiseEqual(m.Inverse(), m.InverseScalar())) << "i=" << i;
+    }
+
+    const auto& m  = Matrices[1];
+    const auto  Id = m * m.Inverse();
+    for (int r = 0; r < 4; ++r)
+    {
+        for (int c = 0; c < 4; ++c)
+            EXPECT_NEAR(Id[r][c], r == c ? 1.f : 0.f, 1e-5f);
+    }
+}
+
+TEST(Common_BasicMath, SIMDVectorTransform)
+{
+    const auto Matrices = GenerateRandomMatrices(16, 2);
+
+    FastRandFloat Rnd{3, -100.f, 100.f};
+
+    // Use odd count to test the tail processing
+    constexpr size_t    NumVectors = 255;
+    std::vector<float4> Vectors(NumVectors);
+    std::vector<float3> Points(NumVectors);
+    for (size_t i = 0; i < NumVectors; ++i)
+    {
+        Vectors[i] = float4{Rnd(), Rnd(), Rnd(), Rnd()};
+        Points[i]  = float3{Rnd(), Rnd(), Rnd()};
+    }
+
+    for (const auto& m : Matrices)
+    {
+        std::vector<float4> TransformedVectors(NumVectors);
+        TransformVectors(Vectors.data(), TransformedVectors.data(), NumVectors, m);
+
+        std::vector<float3> TransformedPoints(NumVectors);
+        TransformPoints(Points.data(), TransformedPoints.data(), NumVectors, m);
+
+        for (size_t i = 0; i < NumVectors; ++i)
+        {
+            const auto RefVector = TransformVectorScalar(Vectors[i], m);
+            EXPECT_TRUE(IsBitwiseEqual(Vectors[i] * m, RefVector)) << "i=" << i;
+            EXPECT_TRUE(IsBitwiseEqual(TransformedVectors[i], RefVector)) << "i=" << i;
+
+            const auto RefPoint = TransformPointScalar(Points[i], m);
+            EXPECT_TRUE(IsBitwiseEqual(Points[i] * m, RefPoint)) << "i=" << i;
+            EXPECT_TRUE(IsBitwiseEqual(TransformedPoints[i], RefPoint)) << "i=" << i;
+        }
+
+        // In-place transform
+        auto InPlaceVectors = Vectors;
+        TransformVectors(InPlaceVectors.data(), InPlaceVectors.data(), NumVectors, m);
+        EXPECT_EQ(InPlaceVectors, TransformedVectors);
+
+        auto InPlacePoints = Points;
+        TransformPoints(InPlacePoints.data(), InPlacePoints.data(), NumVectors, m);
+        EXPECT_EQ(InPlacePoints, TransformedPoints);
+    }
+
+    TransformVectors(nullptr, nullptr, 0, Matrices[0]);
+    TransformPoints(nullptr, nullptr, 0, Matrices[0]);
+}
+
+TEST(Common_BasicMath, SIMDMultiplyMatrices)
+{
+    const auto Matrices1 = GenerateRandomMatrices(100, 4);
+    const auto Matrices2 = GenerateRandomMatrices(100, 5);
+    const auto Count     = Matrices1.size();
+
+    {
+        std::vector<float4x4> Products(Count);
+        MultiplyMatrices(Matrices1.data(), Matrices2.data(), Products.data(), Count);
+        for (size_t i = 0; i < Count; ++i)
+            EXPECT_TRUE(IsBitwiseEqual(Products[i], float4x4::MulScalar(Matrices1[i], Matrices2[i]))) << "i=" << i;
+
+        auto InPlaceProducts = Matrices1;
+        MultiplyMatrices(InPlaceProducts.data(), Matrices2.data(), InPlaceProducts.data(), Count);
+        EXPECT_EQ(InPlaceProducts, Products);
+
+        InPlaceProducts = Matrices2;
+        MultiplyMatrices(Matrices1.data(), InPlaceProducts.data(), InPlaceProducts.data(), Count);
+        EXPECT_EQ(InPlaceProducts, Products);
+    }
+
+    {
+        const auto& ViewProj = Matrices2[1];
+
+        std::vector<float4x4> Products(Count);
+        MultiplyMatrices(Matrices1.data(), ViewProj, Products.data(), Count);
+        for (size_t i = 0; i < Count; ++i)
+            EXPECT_TRUE(IsBitwiseEqual(Products[i], float4x4::MulScalar(Matrices1[i], ViewProj))) << "i=" << i;
+
+        auto InPlaceProducts = Matrices1;
+        MultiplyMatrices(InPlaceProducts.data(), ViewProj, InPlaceProducts.data(), Count);
+        EXPECT_EQ(InPlaceProducts, Products);
+    }
+}
+
+TEST(Common_AdvancedMath, GetBoxVisibilityMask)
+{
+    // Use box count that is not a multiple of 32 and 4
+    constexpr Uint32 NumBoxes = 1000;
+
+    std::vector<float>    MinX(NumBoxes), MinY(NumBoxes), MinZ(NumBoxes);
+    std::vector<float>    MaxX(NumBoxes), MaxY(NumBoxes), MaxZ(NumBoxes);
+    std::vector<BoundBox> AoSBoxes(NumBoxes);
+
+    FastRandFloat Rnd{0, -100.f, 100.f};
+    FastRandFloat RndSize{1, 0.f, 20.f};
+    for (Uint32 i = 0; i < NumBoxes; ++i)
+    {
+        auto& Box = AoSBoxes[i];
+        Box.Min   = float3{Rnd(), Rnd(), Rnd()};
+        Box.Max   = Box.Min + float3{RndSize(), RndSize(), RndSize()};
+
+        MinX[i] = Box.Min.x;
+        MinY[i] = Box.Min.y;
+        MinZ[i] = Box.Min.z;
+        MaxX[i] = Box.Max.x;
+        MaxY[i] = Box.Max.y;
+        MaxZ[i] = Box.Max.z;
+    }
+
+    BoundBoxSoA Boxes;
+    Boxes.MinX     = MinX.data();
+    Boxes.MinY     = MinY.data();
+    Boxes.MinZ     = MinZ.data();
+    Boxes.MaxX     = MaxX.data();
+    Boxes.MaxY     = MaxY.data();
+    Boxes.MaxZ     = MaxZ.data();
+    Boxes.NumBoxes = NumBoxes;
+
+    const float4x4 ViewProj = float4x4::RotationY(0.5f) * float4x4::Translation(0, 0, 60) * float4x4::Projection(PI_F / 3.f, 1.5f, 1.f, 150.f, false);
+
+    ViewFrustumExt FrustumExt;
+    ExtractViewFrustumPlanesFromMatrix(ViewProj, FrustumExt, false);
+    const ViewFrustum& Frustum = FrustumExt;
+
+    const FRUSTUM_PLANE_FLAGS PlaneFlags[] = {FRUSTUM_PLANE_FLAG_FULL_FRUSTUM, FRUSTUM_PLANE_FLAG_OPEN_NEAR, FRUSTUM_PLANE_FLAG_NONE};
+    for (auto Flags : PlaneFlags)
+    {
+        std::vector<Uint32> VisibleMask(GetBoxVisibilityMaskSize(NumBoxes));
+        std::vector<Uint32> FullyVisibleMask(GetBoxVisibilityMaskSize(NumBoxes));
+        std::vector<Uint32> VisibleMaskExt(GetBoxVisibilityMaskSize(NumBoxes));
+        std::vector<Uint32> FullyVisibleMaskExt(GetBoxVisibilityMaskSize(NumBoxes));
+        GetBoxVisibilityMask(Frustum, Boxes, VisibleMask.data(), FullyVisibleMask.data(), Flags);
+        GetBoxVisibilityMask(FrustumExt, Boxes, VisibleMaskExt.data(), FullyVisibleMaskExt.data(), Flags);
+
+        Uint32 NumVisible         = 0;
+        Uint32 NumVisibleExt      = 0;
+        Uint32 NumFullyVisible    = 0;
+        Uint32 NumIntersecting    = 0;
+        Uint32 NumIntersectingExt = 0;
+
+        std::vector<Uint32> RefIndices;
+        std::vector<Uint32> RefIndicesExt;
+        for (Uint32 i = 0; i < NumBoxes; ++i)
+        {
+            const auto Vis    = GetBoxVisibility(Frustum, AoSBoxes[i], Flags);
+            const auto VisExt = GetBoxVisibility(FrustumExt, AoSBoxes[i], Flags);
+
+            const bool IsVisible    = (VisibleMask[i / 32] & (1u << (i % 32))) != 0;
+            const bool IsVisibleExt = (VisibleMaskExt[i / 32] & (1u << (i % 32))) != 0;
+            EXPECT_EQ(IsVisible, Vis != BoxVisibility::Invisible) << "Box " << i;
+            EXPECT_EQ(IsVisibleExt, VisExt != BoxVisibility::Invisible) << "Box " << i;
+            EXPECT_EQ((FullyVisibleMask[i / 32] & (1u << (i % 32))) != 0, Vis == BoxVisibility::FullyVisible) << "Box " << i;
+            EXPECT_EQ((FullyVisibleMaskExt[i / 32] & (1u << (i % 32))) != 0, VisExt == BoxVisibility::FullyVisible) << "Box " << i;
+
+            if (Vis != BoxVisibility::Invisible)
+            {
+                ++NumVisible;
+                RefIndices.push_back(i);
+            }
+            if (VisExt != BoxVisibility::Invisible)
+            {
+                ++NumVisibleExt;
+                RefIndicesExt.push_back(i);
+            }
+            NumFullyVisible += Vis == BoxVisibility::FullyVisible ? 1 : 0;
+            NumIntersecting += Vis == BoxVisibility::Intersecting ? 1 : 0;
+            NumIntersectingExt += VisExt == BoxVisibility::Intersecting ? 1 : 0;
+        }
+
+        if (Flags != FRUSTUM_PLANE_FLAG_NONE)
+        {
+            // Make sure that the test covers all cases
+            EXPECT_GT(NumVisible, 0u);
+            EXPECT_LT(NumVisible, NumBoxes);
+            EXPECT_GT(NumFullyVisible, 0u);
+            EXPECT_GT(NumIntersecting, 0u);
+        }
+        if (Flags == FRUSTUM_PLANE_FLAG_FULL_FRUSTUM)
+        {
+            // Some intersecting boxes must be culled by the frustum corners test
+            EXPECT_LT(NumIntersectingExt, NumIntersecting);
+        }
+
+        // Unused bits of the last word must be zero
+        EXPECT_EQ(VisibleMask.back() >> (NumBoxes % 32), 0u);
+
+        std::vector<Uint32> Indices(NumBoxes);
+        Indices.resize(CullBoxes(Frustum, Boxes, Indices.data(), Flags));
+        EXPECT_EQ(Indices, RefIndices);
+
+        std::vector<Uint32> IndicesExt(NumBoxes);
+        IndicesExt.resize(CullBoxes(FrustumExt, Boxes, IndicesExt.data(), Flags));
+        EXPECT_EQ(IndicesExt, RefIndicesExt);
+
+        std::vector<Uint32> CompactedIndices(NumBoxes);
+        CompactedIndices.resize(CompactVisibilityMask(VisibleMask.data(), NumBoxes, CompactedIndices.data()));
+        EXPECT_EQ(CompactedIndices, RefIndices);
+
+        // Parallel culling
+        const auto ParallelFor = [](Uint32 NumTasks, const std::function<void(Uint32)>& Task) {
+            std::vector<std::thread> Threads;
+            for (Uint32 i = 0; i < NumTasks; ++i)
+                Threads.emplace_back(Task, i);
+            for (auto& Thread : Threads)
+                Thread.join();
+        };
+
+        std::vector<Uint32> ParallelVisibleMask(GetBoxVisibilityMaskSize(NumBoxes));
+        std::vector<Uint32> ParallelFullyVisibleMask(GetBoxVisibilityMaskSize(NumBoxes));
+        GetBoxVisibilityMaskParallel(FrustumExt, Boxes, ParallelVisibleMask.data(), ParallelFullyVisibleMask.data(), Flags, ParallelFor, 100);
+        EXPECT_EQ(ParallelVisibleMask, VisibleMaskExt);
+        EXPECT_EQ(ParallelFullyVisibleMask, FullyVisibleMaskExt);
+    }
+}
+
 } // namespace
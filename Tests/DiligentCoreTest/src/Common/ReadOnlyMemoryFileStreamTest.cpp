@@ -0,0 +1,86 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <cstring>
+
+#include "ReadOnlyMemoryFileStream.hpp"
+#include "MappedFileStream.hpp"
+#include "DataBlobImpl.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+RefCntAutoPtr<IDataBlob> CreateBlob(const char* Data)
+{
+    RefCntAutoPtr<IDataBlob> pBlob{MakeNewRCObj<DataBlobImpl>()(strlen(Data))};
+    memcpy(pBlob->GetDataPtr(), Data, strlen(Data));
+    return pBlob;
+}
+
+TEST(Common_ReadOnlyMemoryFileStream, Read)
+{
+    auto pData = CreateBlob("float4 Color;");
+
+    RefCntAutoPtr<ReadOnlyMemoryFileStream> pStream{MakeNewRCObj<ReadOnlyMemoryFileStream>()(pData)};
+    ASSERT_TRUE(pStream->IsValid());
+    EXPECT_EQ(pStream->GetSize(), pData->GetSize());
+
+    char Buffer[16] = {};
+    EXPECT_TRUE(pStream->Read(Buffer, 7));
+    EXPECT_EQ(memcmp(Buffer, "float4 ", 7), 0);
+
+    // The remaining data is copied
+    RefCntAutoPtr<IDataBlob> pRemaining = ReadFileStreamData(pStream);
+    ASSERT_EQ(pRemaining->GetSize(), size_t{6});
+    EXPECT_NE(pRemaining->GetConstDataPtr(), pData->GetConstDataPtr());
+    EXPECT_EQ(memcmp(pRemaining->GetConstDataPtr(), "Color;", 6), 0);
+
+    // The stream is at the end
+    EXPECT_FALSE(pStream->Read(Buffer, 1));
+    EXPECT_FALSE(pStream->Write(Buffer, 1));
+    EXPECT_EQ(pData->GetSize(), size_t{13});
+}
+
+TEST(Common_ReadOnlyMemoryFileStream, SharedBlob)
+{
+    auto pData = CreateBlob("#define SHARED 1\n");
+
+    for (int i = 0; i < 2; ++i)
+    {
+        RefCntAutoPtr<ReadOnlyMemoryFileStream> pStream{MakeNewRCObj<ReadOnlyMemoryFileStream>()(pData)};
+
+        RefCntAutoPtr<IDataBlob> pBlob = ReadFileStreamData(pStream);
+        EXPECT_EQ(pBlob, pData);
+        EXPECT_FALSE(pStream->Read(&i, 1));
+    }
+}
+
+} // namespace
@@ -30,6 +30,7 @@
 #include <mutex>
 #include <condition_variable>
 #include <algorithm>
+#include <vector>
 
 #include "DefaultRawMemoryAllocator.hpp"
 #include "RefCntAutoPtr.hpp"
@@ -350,6 +351,112 @@ TEST(Common_RefCntWeakPtr, Lock)
     }
 }
 
+TEST(Common_RefCntWeakPtr, ContendedLock)
+{
+    class CountedObject : public Object
+    {
+    public:
+        CountedObject(IReferenceCounters* pRefCounters, std::atomic_int& NumDestroyed) :
+            Object{pRefCounters},
+            m_NumDestroyed{NumDestroyed}
+        {}
+
+        ~CountedObject()
+        {
+            ++m_NumDestroyed;
+        }
+
+    private:
+        std::atomic_int& m_NumDestroyed;
+    };
+
+    const auto NumThreads = std::max(std::thread::hardware_concurrency(), 4u);
+
+    constexpr int NumIterations = 200;
+
+    std::atomic_int NumDestroyed{0};
+    for (int i = 0; i < NumIterations; ++i)
+    {
+        RefCntAutoPtr<CountedObject> pObj{MakeNewRCObj<CountedObject>{}(NumDestroyed)};
+        RefCntWeakPtr<CountedObject> wpObj{pObj};
+
+        std::atomic_int  NumStarted{0};
+        std::atomic_bool ObjectReleased{false};
+
+        std::vector<std::thread> Threads(NumThreads);
+        for (auto& Thread : Threads)
+        {
+            Thread = std::thread{
+                [&]() {
+                    ++NumStarted;
+                    // Every thread makes its own weak pointer copy and keeps promoting it
+                    // while the main thread releases the last strong reference.
+                    RefCntWeakPtr<CountedObject> wpLocal{wpObj};
+                    for (Uint32 NumLocks = 1;; ++NumLocks)
+                    {
+                        {
+                            auto pLocked = wpLocal.Lock();
+                            if (!pLocked)
+                                break;
+                            pLocked->m_Value++;
+                            pLocked->m_Value--;
+                        }
+
+                        // Let the main thread run if there are fewer cores than threads
+                        if (NumLocks % 64 == 0)
+                            std::this_thread::yield();
+                    }
+
+                    // Once the object is expired, it must never be resurrected
+                    EXPECT_TRUE(ObjectReleased);
+                    EXPECT_FALSE(wpLocal.Lock());
+                }};
+        }
+
+        while (NumStarted < static_cast<int>(NumThreads))
+            std::this_thread::yield();
+
+        ObjectReleased = true;
+        pObj.Release();
+
+        for (auto& Thread : Threads)
+            Thread.join();
+
+        EXPECT_FALSE(wpObj.IsValid());
+        EXPECT_FALSE(wpObj.Lock());
+        EXPECT_EQ(NumDestroyed, i + 1);
+    }
+    EXPECT_EQ(NumDestroyed, NumIterations);
+}
+
+TEST(Common_RefCntWeakPtr, RefCounters)
+{
+    SmartPtr SP{MakeNewObj<Object>()};
+
+    auto* pRefCounters = SP->GetReferenceCounters();
+    EXPECT_EQ(pRefCounters->GetNumStrongRefs(), 1);
+    EXPECT_EQ(pRefCounters->GetNumWeakRefs(), 0);
+
+    {
+        WeakPtr WP0{SP};
+        EXPECT_EQ(pRefCounters->GetNumWeakRefs(), 1);
+        WeakPtr WP1{WP0};
+        EXPECT_EQ(pRefCounters->GetNumWeakRefs(), 2);
+
+        auto SP2 = WP1.Lock();
+        EXPECT_EQ(pRefCounters->GetNumStrongRefs(), 2);
+    }
+    EXPECT_EQ(pRefCounters->GetNumStrongRefs(), 1);
+    EXPECT_EQ(pRefCounters->GetNumWeakRefs(), 0);
+
+    WeakPtr WP{SP};
+    SP.Release();
+    // The reference counters are kept alive by the weak pointer
+    EXPECT_EQ(pRefCounters->GetNumStrongRefs(), 0);
+    EXPECT_EQ(pRefCounters->GetNumWeakRefs(), 1);
+    EXPECT_FALSE(WP.Lock());
+}
+
 TEST(Common_RefCntAutoPtr, Misc)
 {
     {
@@ -0,0 +1,145 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "StringInternPool.hpp"
+#include "DefaultRawMemoryAllocator.hpp"
+#include "TrackingMemoryAllocator.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+TEST(Common_StringInternPool, Intern)
+{
+    StringInternPool Pool{DefaultRawMemoryAllocator::GetAllocator(), 64};
+
+    EXPECT_EQ(Pool.Intern(nullptr), nullptr);
+
+    const auto* Str0 = Pool.Intern("g_Texture");
+    ASSERT_NE(Str0, nullptr);
+    EXPECT_STREQ(Str0, "g_Texture");
+
+    const std::string Str{"g_Texture"};
+    EXPECT_NE(Str0, Str.c_str());
+    EXPECT_EQ(Pool.Intern(Str), Str0);
+    EXPECT_EQ(Pool.Intern(Str.c_str()), Str0);
+    EXPECT_EQ(Pool.Intern("g_Texture_sampler", 9), Str0);
+
+    const auto* Str1 = Pool.Intern("g_Texture_sampler");
+    EXPECT_NE(Str1, Str0);
+    EXPECT_STREQ(Str1, "g_Texture_sampler");
+
+    const auto* Empty = Pool.Intern("");
+    ASSERT_NE(Empty, nullptr);
+    EXPECT_STREQ(Empty, "");
+    EXPECT_EQ(Pool.Intern(std::string{}), Empty);
+
+    EXPECT_EQ(Pool.GetNumStrings(), 3u);
+    EXPECT_EQ(Pool.GetMemorySize(), sizeof("g_Texture") + sizeof("g_Texture_sampler") + 1);
+
+    EXPECT_EQ(Pool.Find("g_Texture"), Str0);
+    EXPECT_EQ(Pool.Find("g_Buffer"), nullptr);
+    EXPECT_EQ(Pool.Find(nullptr), nullptr);
+
+    Pool.Clear();
+    EXPECT_EQ(Pool.GetNumStrings(), 0u);
+    EXPECT_EQ(Pool.GetMemorySize(), 0u);
+    EXPECT_EQ(Pool.Find("g_Texture"), nullptr);
+    EXPECT_STREQ(Pool.Intern("g_Texture"), "g_Texture");
+}
+
+TEST(Common_StringInternPool, Growth)
+{
+    StringInternPool Pool{DefaultRawMemoryAllocator::GetAllocator(), 64};
+
+    // Pointers must remain valid when the pool allocates new pages
+    std::vector<std::string> Strings;
+    std::vector<const Char*> Interned;
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        Strings.emplace_back("Name" + std::to_string(i) + std::string(i % 100, 'x'));
+        Interned.emplace_back(Pool.Intern(Strings.back()));
+    }
+    EXPECT_EQ(Pool.GetNumStrings(), Strings.size());
+
+    for (size_t i = 0; i < Strings.size(); ++i)
+    {
+        EXPECT_STREQ(Interned[i], Strings[i].c_str());
+        EXPECT_EQ(Pool.Intern(Strings[i]), Interned[i]);
+    }
+}
+
+TEST(Common_StringInternPool, Allocator)
+{
+    TrackingMemoryAllocator Tracker{DefaultRawMemoryAllocator::GetAllocator()};
+    {
+        StringInternPool Pool{Tracker, 4096};
+        for (size_t i = 0; i < 100; ++i)
+            Pool.Intern("Name" + std::to_string(i));
+
+        // All strings fit into one page, other allocations are made by the hash table
+        const auto Snapshot = Tracker.GetSnapshot();
+        EXPECT_GT(Snapshot.Total.LiveAllocations, Int64{1});
+    }
+    EXPECT_EQ(Tracker.GetSnapshot().Total.LiveAllocations, Int64{0});
+}
+
+TEST(Common_StringInternPool, MultiThreaded)
+{
+    StringInternPool Pool{DefaultRawMemoryAllocator::GetAllocator()};
+
+    constexpr size_t NumStrings = 1000;
+
+    std::vector<std::thread>              Threads(4);
+    std::vector<std::vector<const Char*>> Results(Threads.size());
+    for (size_t t = 0; t < Threads.size(); ++t)
+    {
+        Threads[t] = std::thread{
+            [&Pool, &Results, t]() {
+                for (size_t i = 0; i < NumStrings; ++i)
+                    Results[t].emplace_back(Pool.Intern("Name" + std::to_string((i + t * 100) % NumStrings)));
+            }};
+    }
+    for (auto& Thread : Threads)
+        Thread.join();
+
+    EXPECT_EQ(Pool.GetNumStrings(), NumStrings);
+    for (size_t t = 0; t < Threads.size(); ++t)
+    {
+        for (size_t i = 0; i < NumStrings; ++i)
+            EXPECT_EQ(Results[t][i], Results[0][(i + t * 100) % NumStrings]);
+    }
+}
+
+} // namespace
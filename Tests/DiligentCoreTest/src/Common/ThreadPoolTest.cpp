@@ -0,0 +1,175 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <set>
+
+#include "ThreadPool.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+TEST(Common_ThreadPool, ParallelFor)
+{
+    ThreadPool::CreateInfo CI;
+    CI.NumThreads = 4;
+    ThreadPool Pool{CI};
+    EXPECT_EQ(Pool.GetNumThreads(), 4u);
+
+    for (Uint32 Count : {0u, 1u, 2u, 5u, 1000u})
+    {
+        std::vector<std::atomic<Uint32>> Visits(Count);
+        for (auto& v : Visits)
+            v.store(0);
+
+        Pool.ParallelFor(Count, [&](Uint32 i) { Visits[i].fetch_add(1); });
+        for (Uint32 i = 0; i < Count; ++i)
+            EXPECT_EQ(Visits[i].load(), 1u) << "Count: " << Count << ", i: " << i;
+    }
+}
+
+TEST(Common_ThreadPool, DefaultThreadCount)
+{
+    // Default-constructed info must give a working pool on any machine
+    ThreadPool Pool{ThreadPool::CreateInfo{}};
+
+    std::atomic<Uint32> Sum{0};
+    Pool.ParallelFor(100, [&](Uint32 i) { Sum.fetch_add(i); });
+    EXPECT_EQ(Sum.load(), 4950u);
+}
+
+TEST(Common_ThreadPool, UsesWorkerThreads)
+{
+    ThreadPool::CreateInfo CI;
+    CI.NumThreads = 3;
+
+    std::mutex                StartedMtx;
+    std::set<std::thread::id> StartedThreads;
+    std::atomic<Uint32>       NumExited{0};
+    CI.OnThreadStarted = [&](Uint32) {
+        std::lock_guard<std::mutex> Lock{StartedMtx};
+        StartedThreads.insert(std::this_thread::get_id());
+    };
+    CI.OnThreadExiting = [&](Uint32) {
+        NumExited.fetch_add(1);
+    };
+
+    {
+        ThreadPool Pool{CI};
+
+        // Block every iteration until all threads have joined the loop
+        std::atomic<Uint32>       NumInside{0};
+        std::mutex                IdsMtx;
+        std::set<std::thread::id> LoopThreads;
+        Pool.ParallelFor(4, [&](Uint32) {
+            {
+                std::lock_guard<std::mutex> Lock{IdsMtx};
+                LoopThreads.insert(std::this_thread::get_id());
+            }
+            NumInside.fetch_add(1);
+            while (NumInside.load() < 4)
+                std::this_thread::yield();
+        });
+        EXPECT_EQ(LoopThreads.size(), 4u);
+        EXPECT_EQ(LoopThreads.count(std::this_thread::get_id()), 1u);
+
+        std::lock_guard<std::mutex> Lock{StartedMtx};
+        EXPECT_EQ(StartedThreads.size(), 3u);
+        for (const auto& Id : LoopThreads)
+        {
+            if (Id != std::this_thread::get_id())
+            {
+                EXPECT_EQ(StartedThreads.count(Id), 1u);
+            }
+        }
+    }
+    EXPECT_EQ(NumExited.load(), 3u);
+}
+
+TEST(Common_ThreadPool, ConcurrentLoops)
+{
+    ThreadPool::CreateInfo CI;
+    CI.NumThreads = 4;
+    ThreadPool Pool{CI};
+
+    constexpr Uint32 NumCallers = 4;
+    constexpr Uint32 Count      = 2000;
+
+    std::vector<std::atomic<Uint32>> Visits(NumCallers * Count);
+    for (auto& v : Visits)
+        v.store(0);
+
+    std::vector<std::thread> Callers;
+    for (Uint32 c = 0; c < NumCallers; ++c)
+    {
+        Callers.emplace_back([&, c]() {
+            for (Uint32 Rep = 0; Rep < 10; ++Rep)
+                Pool.ParallelFor(Count, [&](Uint32 i) { Visits[c * Count + i].fetch_add(1); });
+        });
+    }
+    for (auto& Caller : Callers)
+        Caller.join();
+
+    for (const auto& v : Visits)
+        EXPECT_EQ(v.load(), 10u);
+}
+
+TEST(Common_ThreadPool, ParallelForRanges)
+{
+    for (Uint32 NumItems : {0u, 1u, 3u, 1000u})
+    {
+        for (Uint32 NumThreads : {0u, 1u, 4u, 16u})
+        {
+            std::vector<std::atomic<Uint32>> Visits(NumItems);
+            for (auto& v : Visits)
+                v.store(0);
+
+            std::atomic<Uint32> NumRanges{0};
+            ParallelForRanges(NumItems, NumThreads, [&](Uint32 StartItem, Uint32 EndItem) {
+                EXPECT_LT(StartItem, EndItem);
+                NumRanges.fetch_add(1);
+                for (Uint32 i = StartItem; i < EndItem; ++i)
+                    Visits[i].fetch_add(1);
+            });
+
+            // Every item is processed exactly once, and there are no empty ranges
+            for (Uint32 i = 0; i < NumItems; ++i)
+                EXPECT_EQ(Visits[i].load(), 1u) << "NumItems: " << NumItems << ", NumThreads: " << NumThreads << ", i: " << i;
+            EXPECT_EQ(NumRanges.load(), NumItems != 0 ? std::max(std::min(NumThreads, NumItems), 1u) : 0u);
+        }
+    }
+}
+
+} // namespace
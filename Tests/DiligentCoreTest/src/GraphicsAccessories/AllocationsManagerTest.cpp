@@ -0,0 +1,96 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+
+#include "VariableSizeAllocationsManager.hpp"
+#include "TLSFAllocationsManager.hpp"
+#include "DefaultRawMemoryAllocator.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+// Tests that are shared by all allocations managers
+template <typename ManagerType>
+class GraphicsAccessories_AllocationsManager : public ::testing::Test
+{
+};
+
+using AllocationsManagerTypes = ::testing::Types<VariableSizeAllocationsManager, TLSFAllocationsManager>;
+TYPED_TEST_SUITE(GraphicsAccessories_AllocationsManager, AllocationsManagerTypes);
+
+TYPED_TEST(GraphicsAccessories_AllocationsManager, AllocateFirstFit)
+{
+    using ManagerType = TypeParam;
+    using OffsetType  = typename ManagerType::OffsetType;
+
+    ManagerType Mgr{256, DefaultRawMemoryAllocator::GetAllocator()};
+
+    typename ManagerType::Allocation a[4];
+    for (size_t i = 0; i < 4; ++i)
+    {
+        a[i] = Mgr.Allocate(64, 1);
+        EXPECT_EQ(a[i].UnalignedOffset, OffsetType{64 * i});
+    }
+    EXPECT_EQ(Mgr.GetLargestFreeBlockSize(), OffsetType{0});
+
+    Mgr.Free(std::move(a[0]));
+    Mgr.Free(std::move(a[2]));
+    EXPECT_EQ(Mgr.GetLargestFreeBlockSize(), OffsetType{64});
+
+    // The block with the lowest offset is used
+    auto f0 = Mgr.AllocateFirstFit(32, 16, 192);
+    EXPECT_EQ(f0.UnalignedOffset, OffsetType{0});
+    EXPECT_EQ(f0.Size, OffsetType{32});
+
+    // [32, 64) is too small
+    auto f1 = Mgr.AllocateFirstFit(48, 1, 192);
+    EXPECT_EQ(f1.UnalignedOffset, OffsetType{128});
+    EXPECT_EQ(f1.Size, OffsetType{48});
+
+    // The allocation must end before the end offset
+    EXPECT_FALSE(Mgr.AllocateFirstFit(32, 1, 48).IsValid());
+    auto f2 = Mgr.AllocateFirstFit(32, 32, 64);
+    EXPECT_EQ(f2.UnalignedOffset, OffsetType{32});
+    EXPECT_EQ(f2.Size, OffsetType{32});
+
+    EXPECT_FALSE(Mgr.AllocateFirstFit(16, 1, 128).IsValid());
+    EXPECT_EQ(Mgr.GetLargestFreeBlockSize(), OffsetType{16});
+
+    Mgr.Free(std::move(f0));
+    Mgr.Free(std::move(f1));
+    Mgr.Free(std::move(f2));
+    Mgr.Free(std::move(a[1]));
+    Mgr.Free(std::move(a[3]));
+    EXPECT_TRUE(Mgr.IsEmpty());
+    EXPECT_EQ(Mgr.GetLargestFreeBlockSize(), OffsetType{256});
+}
+
+} // namespace
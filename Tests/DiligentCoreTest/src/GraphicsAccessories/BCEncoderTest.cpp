@@ -0,0 +1,553 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "BCEncoder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "GraphicsAccessories.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+// Reference decoders
+
+void DecodeBC1ColorBlock(const Uint8* pBlock, bool IsBC3, Uint8 Texels[16][4])
+{
+    const Uint32 Color0  = pBlock[0] | (pBlock[1] << 8);
+    const Uint32 Color1  = pBlock[2] | (pBlock[3] << 8);
+    const Uint32 Indices = pBlock[4] | (pBlock[5] << 8) | (pBlock[6] << 16) | (Uint32{pBlock[7]} << 24);
+
+    Uint32 Palette[4][4] = {};
+    for (Uint32 e = 0; e < 2; ++e)
+    {
+        const Uint32 Color = e == 0 ? Color0 : Color1;
+        const Uint32 r     = (Color >> 11) & 0x1F;
+        const Uint32 g     = (Color >> 5) & 0x3F;
+        const Uint32 b     = Color & 0x1F;
+        Palette[e][0]      = (r << 3) | (r >> 2);
+        Palette[e][1]      = (g << 2) | (g >> 4);
+        Palette[e][2]      = (b << 3) | (b >> 2);
+        Palette[e][3]      = 255;
+    }
+    const bool FourColors = IsBC3 || Color0 > Color1;
+    for (Uint32 c = 0; c < 3; ++c)
+    {
+        if (FourColors)
+        {
+            Palette[2][c] = (2 * Palette[0][c] + Palette[1][c] + 1) / 3;
+            Palette[3][c] = (Palette[0][c] + 2 * Palette[1][c] + 1) / 3;
+        }
+        else
+        {
+            Palette[2][c] = (Palette[0][c] + Palette[1][c] + 1) / 2;
+        }
+    }
+    Palette[2][3] = 255;
+    Palette[3][3] = FourColors ? 255 : 0;
+
+    for (Uint32 i = 0; i < 16; ++i)
+    {
+        for (Uint32 c = 0; c < 4; ++c)
+            Texels[i][c] = static_cast<Uint8>(Palette[(Indices >> (i * 2)) & 3][c]);
+    }
+}
+
+void DecodeBC4Block(const Uint8* pBlock, Uint32 Ch, Uint8 Texels[16][4])
+{
+    const Uint32 v0 = pBlock[0];
+    const Uint32 v1 = pBlock[1];
+
+    Uint32 Palette[8] = {v0, v1};
+    if (v0 > v1)
+    {
+        for (Uint32 i = 1; i < 7; ++i)
+            Palette[i + 1] = ((7 - i) * v0 + i * v1 + 3) / 7;
+    }
+    else
+    {
+        for (Uint32 i = 1; i < 5; ++i)
+            Palette[i + 1] = ((5 - i) * v0 + i * v1 + 2) / 5;
+        Palette[6] = 0;
+        Palette[7] = 255;
+    }
+
+    Uint64 Indices = 0;
+    for (Uint32 i = 0; i < 6; ++i)
+        Indices |= Uint64{pBlock[2 + i]} << (i * 8);
+    for (Uint32 i = 0; i < 16; ++i)
+        Texels[i][Ch] = static_cast<Uint8>(Palette[(Indices >> (i * 3)) & 7]);
+}
+
+// Texel masks of the second subset of the two-subset partitions
+constexpr Uint16 BC7Partitions2[64] = {
+    0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80, 0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+    0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE, 0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+    0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A, 0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+    0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C, 0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22,
+};
+
+// Anchor texels of the second subset of the two-subset partitions
+constexpr Uint8 BC7Anchors2[64] = {
+    15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+    15, 2, 8, 2, 2, 8, 8, 15, 2, 8, 2, 2, 8, 8, 2, 2,
+    15, 15, 6, 8, 2, 8, 15, 15, 2, 8, 2, 2, 2, 15, 15, 6,
+    6, 2, 6, 8, 15, 15, 2, 2, 15, 15, 15, 15, 15, 2, 2, 15,
+};
+
+// Only decodes modes 1, 3 and 6 that are used by the encoder
+void DecodeBC7Block(const Uint8* pBlock, Uint8 Texels[16][4])
+{
+    Uint32 Pos      = 0;
+    auto   ReadBits = [&](Uint32 NumBits) {
+        Uint32 Value = 0;
+        for (Uint32 i = 0; i < NumBits; ++i, ++Pos)
+            Value |= ((pBlock[Pos / 8] >> (Pos % 8)) & 1u) << i;
+        return Value;
+    };
+
+    Uint32 Mode = 0;
+    while (Mode < 8 && ReadBits(1) == 0)
+        ++Mode;
+    if (Mode != 1 && Mode != 3 && Mode != 6)
+    {
+        ADD_FAILURE() << "Only modes 1, 3 and 6 are expected";
+        return;
+    }
+
+    const Uint32 NumSubsets   = Mode == 6 ? 1 : 2;
+    const Uint32 NumCh        = Mode == 6 ? 4 : 3;
+    const Uint32 EndpointBits = Mode == 1 ? 6 : 7;
+    const Uint32 IndexBits    = Mode == 1 ? 3 : (Mode == 3 ? 2 : 4);
+    const Uint32 Partition    = NumSubsets > 1 ? ReadBits(6) : 0;
+
+    Uint32 Endpoints[4][4] = {};
+    for (Uint32 c = 0; c < NumCh; ++c)
+    {
+        for (Uint32 e = 0; e < NumSubsets * 2; ++e)
+            Endpoints[e][c] = ReadBits(EndpointBits);
+    }
+
+    // Mode 1 shares the P-bit between the endpoints of a subset
+    Uint32 PBits[4] = {};
+    for (Uint32 e = 0; e < NumSubsets * 2; ++e)
+        PBits[e] = Mode == 1 && (e & 1) ? PBits[e - 1] : ReadBits(1);
+
+    const Uint32 NumBits = EndpointBits + 1;
+    for (Uint32 e = 0; e < NumSubsets * 2; ++e)
+    {
+        for (Uint32 c = 0; c < 4; ++c)
+        {
+            const Uint32 Value = (Endpoints[e][c] << 1) | PBits[e];
+            Endpoints[e][c]    = c >= NumCh ? 255 : (NumBits < 8 ? (Value << (8 - NumBits)) | (Value >> (2 * NumBits - 8)) : Value);
+        }
+    }
+
+    static constexpr Uint32 Weights2[] = {0, 21, 43, 64};
+    static constexpr Uint32 Weights3[] = {0, 9, 18, 27, 37, 46, 55, 64};
+    static constexpr Uint32 Weights4[] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+    const Uint32* Weights = IndexBits == 2 ? Weights2 : (IndexBits == 3 ? Weights3 : Weights4);
+    for (Uint32 i = 0; i < 16; ++i)
+    {
+        const Uint32 Subset   = NumSubsets > 1 ? (BC7Partitions2[Partition] >> i) & 1u : 0;
+        const bool   IsAnchor = i == 0 || (NumSubsets > 1 && i == BC7Anchors2[Partition]);
+        const Uint32 Idx      = ReadBits(IsAnchor ? IndexBits - 1 : IndexBits);
+        for (Uint32 c = 0; c < 4; ++c)
+            Texels[i][c] = static_cast<Uint8>(((64 - Weights[Idx]) * Endpoints[Subset * 2][c] + Weights[Idx] * Endpoints[Subset * 2 + 1][c] + 32) >> 6);
+    }
+}
+
+// Decodes the blocks to RGBA8; the channels that are not encoded by the format are set to (0, 0, 0, 255)
+std::vector<Uint8> Decode(TEXTURE_FORMAT Format, const std::vector<Uint8>& Blocks, Uint32 Width, Uint32 Height)
+{
+    const Uint32 BlockSize  = GetTextureFormatAttribs(Format).ComponentSize;
+    const Uint32 NumBlocksX = (Width + 3) / 4;
+    const Uint32 NumBlocksY = (Height + 3) / 4;
+
+    std::vector<Uint8> Texels(size_t{Width} * Height * 4);
+    for (Uint32 by = 0; by < NumBlocksY; ++by)
+    {
+        for (Uint32 bx = 0; bx < NumBlocksX; ++bx)
+        {
+            const Uint8* pBlock = &Blocks[(size_t{by} * NumBlocksX + bx) * BlockSize];
+
+            Uint8 BlockTexels[16][4] = {};
+            for (auto& Texel : BlockTexels)
+                Texel[3] = 255;
+            switch (Format)
+            {
+                case TEX_FORMAT_BC1_UNORM:
+                case TEX_FORMAT_BC1_UNORM_SRGB:
+                    DecodeBC1ColorBlock(pBlock, false, BlockTexels);
+                    break;
+
+                case TEX_FORMAT_BC3_UNORM:
+                case TEX_FORMAT_BC3_UNORM_SRGB:
+                    DecodeBC1ColorBlock(pBlock + 8, true, BlockTexels);
+                    DecodeBC4Block(pBlock, 3, BlockTexels);
+                    break;
+
+                case TEX_FORMAT_BC4_UNORM:
+                    DecodeBC4Block(pBlock, 0, BlockTexels);
+                    break;
+
+                case TEX_FORMAT_BC5_UNORM:
+                    DecodeBC4Block(pBlock, 0, BlockTexels);
+                    DecodeBC4Block(pBlock + 8, 1, BlockTexels);
+                    break;
+
+                case TEX_FORMAT_BC7_UNORM:
+                case TEX_FORMAT_BC7_UNORM_SRGB:
+                    DecodeBC7Block(pBlock, BlockTexels);
+                    break;
+
+                default:
+                    ADD_FAILURE() << "Unexpected format";
+            }
+
+            for (Uint32 y = 0; y < 4 && by * 4 + y < Height; ++y)
+            {
+                for (Uint32 x = 0; x < 4 && bx * 4 + x < Width; ++x)
+                {
+                    for (Uint32 c = 0; c < 4; ++c)
+                        Texels[((size_t{by} * 4 + y) * Width + bx * 4 + x) * 4 + c] = BlockTexels[y * 4 + x][c];
+                }
+            }
+        }
+    }
+    return Texels;
+}
+
+std::vector<Uint8> Encode(TEXTURE_FORMAT Format, const std::vector<Uint8>& Texels, Uint32 Width, Uint32 Height, BC_ENCODE_QUALITY Quality, Uint32 NumThreads = 1)
+{
+    const Uint32 BlockSize = GetTextureFormatAttribs(Format).ComponentSize;
+
+    std::vector<Uint8> Blocks(size_t{(Width + 3) / 4} * ((Height + 3) / 4) * BlockSize);
+
+    BCEncodeAttribs Attribs;
+    Attribs.Format     = Format;
+    Attribs.Width      = Width;
+    Attribs.Height     = Height;
+    Attribs.pSrcData   = Texels.data();
+    Attribs.pDstData   = Blocks.data();
+    Attribs.Quality    = Quality;
+    Attribs.NumThreads = NumThreads;
+    EXPECT_TRUE(EncodeBC(Attribs));
+    return Blocks;
+}
+
+double ComputePSNR(const std::vector<Uint8>& Ref, const std::vector<Uint8>& Texels, Uint32 FirstCh, Uint32 NumCh)
+{
+    double SqErr = 0;
+    for (size_t i = 0; i < Ref.size(); i += 4)
+    {
+        for (Uint32 c = FirstCh; c < FirstCh + NumCh; ++c)
+        {
+            const double Diff = static_cast<double>(Ref[i + c]) - static_cast<double>(Texels[i + c]);
+            SqErr += Diff * Diff;
+        }
+    }
+    const double MSE = SqErr / static_cast<double>(Ref.size() / 4 * NumCh);
+    return MSE > 0 ? 10.0 * std::log10(255.0 * 255.0 / MSE) : 100.0;
+}
+
+// Smooth gradients with hard edges and mild noise
+std::vector<Uint8> GenerateImage(Uint32 Width, Uint32 Height)
+{
+    std::vector<Uint8> Texels(size_t{Width} * Height * 4);
+
+    Uint32 Seed = 12345;
+    for (Uint32 y = 0; y < Height; ++y)
+    {
+        for (Uint32 x = 0; x < Width; ++x)
+        {
+            Seed = Seed * 1664525u + 1013904223u;
+
+            const float u     = static_cast<float>(x) / static_cast<float>(Width);
+            const float v     = static_cast<float>(y) / static_cast<float>(Height);
+            const float Noise = static_cast<float>((Seed >> 24) & 7) - 3.5f;
+            const bool  Disk  = (u - 0.5f) * (u - 0.5f) + (v - 0.5f) * (v - 0.5f) < 0.09f;
+
+            float Color[4] = {
+                255.f * u,
+                255.f * (0.5f + 0.5f * std::sin(v * 7.f + u * 3.f)),
+                Disk ? 40.f : 200.f * v,
+                255.f * (0.5f + 0.5f * std::cos(u * 5.f - v * 4.f)),
+            };
+
+            Uint8* pTexel = &Texels[(size_t{y} * Width + x) * 4];
+            for (Uint32 c = 0; c < 4; ++c)
+                pTexel[c] = static_cast<Uint8>(std::min(std::max(Color[c] + Noise, 0.f), 255.f));
+        }
+    }
+    return Texels;
+}
+
+TEST(GraphicsTools_BCEncoder, IsSupported)
+{
+    EXPECT_TRUE(IsBCEncodingSupported(TEX_FORMAT_BC1_UNORM));
+    EXPECT_TRUE(IsBCEncodingSupported(TEX_FORMAT_BC1_UNORM_SRGB));
+    EXPECT_TRUE(IsBCEncodingSupported(TEX_FORMAT_BC3_UNORM));
+    EXPECT_TRUE(IsBCEncodingSupported(TEX_FORMAT_BC3_UNORM_SRGB));
+    EXPECT_TRUE(IsBCEncodingSupported(TEX_FORMAT_BC4_UNORM));
+    EXPECT_TRUE(IsBCEncodingSupported(TEX_FORMAT_BC5_UNORM));
+    EXPECT_TRUE(IsBCEncodingSupported(TEX_FORMAT_BC7_UNORM));
+    EXPECT_TRUE(IsBCEncodingSupported(TEX_FORMAT_BC7_UNORM_SRGB));
+
+    EXPECT_FALSE(IsBCEncodingSupported(TEX_FORMAT_BC1_TYPELESS));
+    EXPECT_FALSE(IsBCEncodingSupported(TEX_FORMAT_BC2_UNORM));
+    EXPECT_FALSE(IsBCEncodingSupported(TEX_FORMAT_BC4_SNORM));
+    EXPECT_FALSE(IsBCEncodingSupported(TEX_FORMAT_BC6H_UF16));
+    EXPECT_FALSE(IsBCEncodingSupported(TEX_FORMAT_RGBA8_UNORM));
+}
+
+TEST(GraphicsTools_BCEncoder, Quality)
+{
+    constexpr Uint32 Width  = 130;
+    constexpr Uint32 Height = 66;
+
+    const auto Texels = GenerateImage(Width, Height);
+
+    // BC1 encodes texels with alpha below 128 as transparent black
+    auto OpaqueTexels = Texels;
+    for (size_t i = 3; i < OpaqueTexels.size(); i += 4)
+        OpaqueTexels[i] = 255;
+
+    struct TestInfo
+    {
+        TEXTURE_FORMAT Format;
+        Uint32         FirstCh;
+        Uint32         NumCh;
+        double         MinPSNR[2]; // Fast, normal
+    };
+    const TestInfo Tests[] = {
+        {TEX_FORMAT_BC1_UNORM, 0, 3, {35, 37}},
+        {TEX_FORMAT_BC3_UNORM, 0, 4, {36, 38}},
+        {TEX_FORMAT_BC4_UNORM, 0, 1, {50, 50}},
+        {TEX_FORMAT_BC5_UNORM, 0, 2, {45, 46}},
+        {TEX_FORMAT_BC7_UNORM, 0, 4, {38, 38}},
+    };
+
+    for (const auto& Test : Tests)
+    {
+        double PSNR[2] = {};
+        for (Uint32 q = 0; q < 2; ++q)
+        {
+            const auto  Quality = q == 0 ? BC_ENCODE_QUALITY_FAST : BC_ENCODE_QUALITY_NORMAL;
+            const auto& Src     = Test.Format == TEX_FORMAT_BC1_UNORM ? OpaqueTexels : Texels;
+            const auto  Decoded = Decode(Test.Format, Encode(Test.Format, Src, Width, Height, Quality), Width, Height);
+
+            PSNR[q] = ComputePSNR(Src, Decoded, Test.FirstCh, Test.NumCh);
+            EXPECT_GE(PSNR[q], Test.MinPSNR[q]) << GetTextureFormatAttribs(Test.Format).Name << (q == 0 ? " fast" : " normal");
+        }
+        EXPECT_GE(PSNR[1], PSNR[0]) << GetTextureFormatAttribs(Test.Format).Name;
+    }
+}
+
+TEST(GraphicsTools_BCEncoder, SolidColor)
+{
+    constexpr Uint32 Width  = 8;
+    constexpr Uint32 Height = 4;
+
+    for (Uint32 Color : {0x00000000u, 0xFFFFFFFFu, 0x80402010u, 0x7F3FC1E7u, 0x12345678u})
+    {
+        std::vector<Uint8> Texels(Width * Height * 4);
+        for (size_t i = 0; i < Texels.size(); ++i)
+            Texels[i] = static_cast<Uint8>(Color >> ((i % 4) * 8));
+        // Make alpha opaque for BC1
+        auto OpaqueTexels = Texels;
+        for (size_t i = 3; i < OpaqueTexels.size(); i += 4)
+            OpaqueTexels[i] = 255;
+
+        for (auto Quality : {BC_ENCODE_QUALITY_FAST, BC_ENCODE_QUALITY_NORMAL})
+        {
+            // BC4, BC5 and BC7 encode solid colors exactly
+            for (auto Format : {TEX_FORMAT_BC4_UNORM, TEX_FORMAT_BC5_UNORM, TEX_FORMAT_BC7_UNORM})
+            {
+                const Uint32 NumCh   = Uint32{GetTextureFormatAttribs(Format).NumComponents};
+                const auto   Decoded = Decode(Format, Encode(Format, Texels, Width, Height, Quality), Width, Height);
+                for (size_t i = 0; i < Texels.size(); i += 4)
+                {
+                    for (Uint32 c = 0; c < NumCh; ++c)
+                        ASSERT_EQ(Decoded[i + c], Texels[i + c]) << GetTextureFormatAttribs(Format).Name << " color " << std::hex << Color;
+                }
+            }
+
+            // BC1 solid colors are encoded with the optimal endpoints
+            const auto Decoded = Decode(TEX_FORMAT_BC1_UNORM, Encode(TEX_FORMAT_BC1_UNORM, OpaqueTexels, Width, Height, Quality), Width, Height);
+            for (size_t i = 0; i < Texels.size(); ++i)
+                ASSERT_NEAR(Decoded[i], OpaqueTexels[i], 2) << "color " << std::hex << Color;
+        }
+    }
+}
+
+TEST(GraphicsTools_BCEncoder, BC7TwoSubsets)
+{
+    constexpr Uint32 Width  = 8;
+    constexpr Uint32 Height = 8;
+
+    // Opaque blocks with two color ramps that do not lie on one line
+    std::vector<Uint8> Texels(Width * Height * 4);
+    for (Uint32 y = 0; y < Height; ++y)
+    {
+        for (Uint32 x = 0; x < Width; ++x)
+        {
+            const bool Right  = (x % 4) >= 2;
+            Uint8*     pTexel = &Texels[(y * Width + x) * 4];
+            pTexel[0]         = static_cast<Uint8>(Right ? 20 + y * 8 : 230 - y * 10);
+            pTexel[1]         = static_cast<Uint8>(Right ? 60 + x * 5 : 40 + y * 6);
+            pTexel[2]         = static_cast<Uint8>(Right ? 220 - y * 12 : 30);
+            pTexel[3]         = 255;
+        }
+    }
+
+    const auto Fast   = Encode(TEX_FORMAT_BC7_UNORM, Texels, Width, Height, BC_ENCODE_QUALITY_FAST);
+    const auto Normal = Encode(TEX_FORMAT_BC7_UNORM, Texels, Width, Height, BC_ENCODE_QUALITY_NORMAL);
+
+    // Fast quality only uses mode 6, normal quality selects mode 1 or 3 for these blocks
+    for (size_t i = 0; i < Normal.size(); i += 16)
+    {
+        EXPECT_EQ(Fast[i] & 0x7Fu, 1u << 6);
+        EXPECT_TRUE((Normal[i] & 0x3u) == (1u << 1) || (Normal[i] & 0xFu) == (1u << 3));
+    }
+
+    const double FastPSNR   = ComputePSNR(Texels, Decode(TEX_FORMAT_BC7_UNORM, Fast, Width, Height), 0, 4);
+    const double NormalPSNR = ComputePSNR(Texels, Decode(TEX_FORMAT_BC7_UNORM, Normal, Width, Height), 0, 4);
+    EXPECT_GE(NormalPSNR, 45.0);
+    EXPECT_GT(NormalPSNR, FastPSNR + 5.0);
+}
+
+TEST(GraphicsTools_BCEncoder, BC1Transparency)
+{
+    constexpr Uint32 Width  = 12;
+    constexpr Uint32 Height = 8;
+
+    auto Texels = GenerateImage(Width, Height);
+    for (Uint32 i = 0; i < Width * Height; ++i)
+    {
+        // Left block is fully transparent, middle block is partially transparent, right block is opaque
+        const Uint32 x    = i % Width;
+        Texels[i * 4 + 3] = x < 4 || (x < 8 && (i % 3) == 0) ? 0 : 255;
+    }
+
+    for (auto Quality : {BC_ENCODE_QUALITY_FAST, BC_ENCODE_QUALITY_NORMAL})
+    {
+        const auto Decoded = Decode(TEX_FORMAT_BC1_UNORM, Encode(TEX_FORMAT_BC1_UNORM, Texels, Width, Height, Quality), Width, Height);
+        for (size_t i = 0; i < Texels.size(); i += 4)
+        {
+            EXPECT_EQ(Decoded[i + 3], Texels[i + 3]);
+            if (Texels[i + 3] == 0)
+            {
+                EXPECT_EQ(Decoded[i + 0], 0);
+                EXPECT_EQ(Decoded[i + 1], 0);
+                EXPECT_EQ(Decoded[i + 2], 0);
+            }
+        }
+        EXPECT_GE(ComputePSNR(Texels, Decoded, 0, 3), 8.0);
+    }
+}
+
+TEST(GraphicsTools_BCEncoder, Threads)
+{
+    constexpr Uint32 Width  = 61;
+    constexpr Uint32 Height = 93;
+
+    const auto Texels = GenerateImage(Width, Height);
+    for (auto Format : {TEX_FORMAT_BC1_UNORM, TEX_FORMAT_BC3_UNORM, TEX_FORMAT_BC5_UNORM, TEX_FORMAT_BC7_UNORM})
+    {
+        const auto Ref = Encode(Format, Texels, Width, Height, BC_ENCODE_QUALITY_NORMAL, 1);
+        for (Uint32 NumThreads : {2u, 3u, 64u})
+            EXPECT_EQ(Encode(Format, Texels, Width, Height, BC_ENCODE_QUALITY_NORMAL, NumThreads), Ref) << GetTextureFormatAttribs(Format).Name;
+    }
+}
+
+TEST(GraphicsTools_BCEncoder, StridedRegion)
+{
+    constexpr Uint32 Width     = 21;
+    constexpr Uint32 Height    = 10;
+    constexpr Uint32 SrcStride = Width * 4 + 12;
+    constexpr Uint32 BlockSize = 16;
+    constexpr Uint32 RowSize   = (Width + 3) / 4 * BlockSize;
+    constexpr Uint32 DstStride = RowSize + 40;
+
+    const auto Texels = GenerateImage(Width, Height);
+
+    std::vector<Uint8> PaddedTexels(SrcStride * Height, 0xCD);
+    for (Uint32 y = 0; y < Height; ++y)
+        std::copy_n(&Texels[y * Width * 4], Width * 4, &PaddedTexels[y * SrcStride]);
+
+    const Uint32       NumBlockRows = (Height + 3) / 4;
+    std::vector<Uint8> Blocks(DstStride * NumBlockRows, 0xAB);
+
+    BCEncodeAttribs Attribs;
+    Attribs.Format    = TEX_FORMAT_BC7_UNORM;
+    Attribs.Width     = Width;
+    Attribs.Height    = Height;
+    Attribs.pSrcData  = PaddedTexels.data();
+    Attribs.SrcStride = SrcStride;
+    Attribs.pDstData  = Blocks.data();
+    Attribs.DstStride = DstStride;
+    ASSERT_TRUE(EncodeBC(Attribs));
+
+    const auto Ref = Encode(TEX_FORMAT_BC7_UNORM, Texels, Width, Height, BC_ENCODE_QUALITY_NORMAL);
+    for (Uint32 row = 0; row < NumBlockRows; ++row)
+    {
+        EXPECT_TRUE(std::equal(&Ref[row * RowSize], &Ref[row * RowSize] + RowSize, &Blocks[row * DstStride]));
+        for (Uint32 i = RowSize; i < DstStride; ++i)
+            EXPECT_EQ(Blocks[row * DstStride + i], 0xAB);
+    }
+}
+
+TEST(GraphicsTools_BCEncoder, InvalidArguments)
+{
+    Uint8 Data[64] = {};
+
+    BCEncodeAttribs Attribs;
+    Attribs.Format   = TEX_FORMAT_BC2_UNORM;
+    Attribs.Width    = 4;
+    Attribs.Height   = 4;
+    Attribs.pSrcData = Data;
+    Attribs.pDstData = Data;
+    EXPECT_FALSE(EncodeBC(Attribs));
+
+    Attribs.Format    = TEX_FORMAT_BC1_UNORM;
+    Attribs.SrcStride = 8;
+    EXPECT_FALSE(EncodeBC(Attribs));
+
+    Attribs.SrcStride = 0;
+    Attribs.pDstData  = nullptr;
+    EXPECT_FALSE(EncodeBC(Attribs));
+}
+
+} // namespace
@@ -0,0 +1,214 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <thread>
+#include <vector>
+#include <atomic>
+
+#include "ConcurrentRingBuffer.hpp"
+#include "DefaultRawMemoryAllocator.hpp"
+#include "FastRand.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+TEST(GraphicsAccessories_ConcurrentRingBuffer, AllocDealloc)
+{
+    // Need to define local variable to avoid vexing linker errors
+    const auto InvalidOffset = ConcurrentRingBuffer::InvalidOffset;
+    using OffsetType         = ConcurrentRingBuffer::OffsetType;
+
+    ConcurrentRingBuffer RB{1024, DefaultRawMemoryAllocator::GetAllocator()};
+
+    EXPECT_EQ(RB.Allocate(120, 16), OffsetType{0});
+    EXPECT_EQ(RB.Allocate(10, 1), OffsetType{128});
+    EXPECT_EQ(RB.Allocate(10, 32), OffsetType{160});
+    EXPECT_EQ(RB.Allocate(64, 64), OffsetType{192});
+    RB.FinishCurrentFrame(1);
+    EXPECT_EQ(RB.GetUsedSize(), OffsetType{256});
+
+    EXPECT_EQ(RB.Allocate(512, 1), OffsetType{256});
+    RB.FinishCurrentFrame(2);
+    // 256 bytes remaining at the end
+    EXPECT_EQ(RB.Allocate(512, 1), InvalidOffset);
+
+    RB.ReleaseCompletedFrames(1);
+    EXPECT_EQ(RB.GetUsedSize(), OffsetType{512});
+    EXPECT_EQ(RB.Allocate(200, 1), OffsetType{768});
+    // Not enough space at the end - the remaining 56 bytes are skipped
+    EXPECT_EQ(RB.Allocate(100, 4), OffsetType{0});
+    EXPECT_EQ(RB.GetUsedSize(), OffsetType{868});
+    EXPECT_EQ(RB.Allocate(100, 1), OffsetType{100});
+    EXPECT_EQ(RB.Allocate(100, 1), InvalidOffset);
+    EXPECT_EQ(RB.Allocate(56, 1), OffsetType{200});
+    EXPECT_TRUE(RB.IsFull());
+    RB.FinishCurrentFrame(3);
+
+    // Empty frames are ignored
+    RB.FinishCurrentFrame(4);
+
+    RB.ReleaseCompletedFrames(2);
+    EXPECT_EQ(RB.GetUsedSize(), OffsetType{512});
+    RB.ReleaseCompletedFrames(4);
+    EXPECT_TRUE(RB.IsEmpty());
+}
+
+TEST(GraphicsAccessories_ConcurrentRingBuffer, ThreadChunks)
+{
+    using OffsetType = ConcurrentRingBuffer::OffsetType;
+
+    ConcurrentRingBuffer RB{4096, DefaultRawMemoryAllocator::GetAllocator(), 256};
+
+    ConcurrentRingBuffer::ThreadChunk Chunk0, Chunk1;
+    EXPECT_EQ(RB.Allocate(Chunk0, 16, 16), OffsetType{0});
+    EXPECT_EQ(RB.Allocate(Chunk1, 16, 16), OffsetType{256});
+    EXPECT_EQ(RB.Allocate(Chunk0, 20, 4), OffsetType{16});
+    EXPECT_EQ(RB.Allocate(Chunk0, 16, 32), OffsetType{64});
+    EXPECT_EQ(RB.Allocate(Chunk1, 100, 1), OffsetType{272});
+    // Large allocations bypass the chunk
+    EXPECT_EQ(RB.Allocate(Chunk0, 1024, 1), OffsetType{512});
+    EXPECT_EQ(RB.Allocate(Chunk0, 16, 1), OffsetType{80});
+    EXPECT_EQ(RB.Allocate(Chunk1, 100, 1), OffsetType{372});
+    // Chunk is exhausted - a new one is reserved
+    EXPECT_EQ(RB.Allocate(Chunk1, 100, 1), OffsetType{1536});
+    EXPECT_EQ(RB.GetUsedSize(), OffsetType{1536 + 256});
+
+    RB.FinishCurrentFrame(1);
+    // The chunk is invalidated by the new frame even though it has free space
+    EXPECT_EQ(RB.Allocate(Chunk0, 16, 1), OffsetType{1792});
+    EXPECT_EQ(RB.Allocate(Chunk0, 16, 1), OffsetType{1808});
+    RB.FinishCurrentFrame(2);
+
+    RB.ReleaseCompletedFrames(1);
+    EXPECT_EQ(RB.GetUsedSize(), OffsetType{256});
+    RB.ReleaseCompletedFrames(2);
+    EXPECT_TRUE(RB.IsEmpty());
+}
+
+TEST(GraphicsAccessories_ConcurrentRingBuffer, MultithreadedStress)
+{
+    using OffsetType = ConcurrentRingBuffer::OffsetType;
+
+    constexpr size_t     NumThreads        = 4;
+    constexpr size_t     NumFrames         = 64;
+    constexpr Uint64     NumFramesInFlight = 3;
+    constexpr OffsetType BufferSize        = 256 << 10;
+
+    ConcurrentRingBuffer RB{BufferSize, DefaultRawMemoryAllocator::GetAllocator(), 1024};
+
+    // Every byte of the buffer is tagged with the id of the allocation that owns it.
+    // Any overlap between live allocations is detected when the tag is overwritten.
+    std::vector<std::atomic<Uint32>> Owners(BufferSize);
+    for (auto& Owner : Owners)
+        Owner.store(0);
+
+    struct AllocationInfo
+    {
+        OffsetType Offset;
+        OffsetType Size;
+    };
+    std::vector<std::vector<AllocationInfo>> FrameAllocations(NumFrames + 1);
+    std::vector<std::vector<AllocationInfo>> ThreadAllocations(NumThreads);
+
+    std::atomic<Uint32> NextId{1};
+    std::atomic<Uint32> NumErrors{0};
+
+    auto ReleaseFrames = [&](Uint64 CompletedFence) {
+        RB.ReleaseCompletedFrames(CompletedFence);
+        for (Uint64 f = 1; f <= CompletedFence; ++f)
+        {
+            for (const auto& Alloc : FrameAllocations[f])
+            {
+                for (OffsetType i = Alloc.Offset; i < Alloc.Offset + Alloc.Size; ++i)
+                    Owners[i].store(0);
+            }
+            FrameAllocations[f].clear();
+        }
+    };
+
+    Uint64 FenceValue = 0;
+    for (size_t frame = 0; frame < NumFrames; ++frame)
+    {
+        std::vector<std::thread> Threads;
+        for (size_t t = 0; t < NumThreads; ++t)
+        {
+            Threads.emplace_back([&, t]() {
+                FastRandInt Rnd{static_cast<unsigned int>(frame * NumThreads + t), 1, 512};
+
+                ConcurrentRingBuffer::ThreadChunk Chunk;
+                auto&                             Allocs = ThreadAllocations[t];
+                for (size_t i = 0; i < 128; ++i)
+                {
+                    const OffsetType Size      = static_cast<OffsetType>(Rnd());
+                    const OffsetType Alignment = OffsetType{1} << (i % 6);
+
+                    const OffsetType Offset = (i % 3 == 0) ?
+                        RB.Allocate(Size, Alignment) :
+                        RB.Allocate(Chunk, Size, Alignment);
+                    if (Offset == ConcurrentRingBuffer::InvalidOffset)
+                        continue;
+
+                    if (Offset % Alignment != 0 || Offset + Size > BufferSize)
+                        NumErrors.fetch_add(1);
+
+                    const Uint32 Id = NextId.fetch_add(1);
+                    for (OffsetType b = Offset; b < Offset + Size; ++b)
+                    {
+                        if (Owners[b].exchange(Id) != 0)
+                            NumErrors.fetch_add(1);
+                    }
+                    Allocs.push_back({Offset, Size});
+
+                    if ((i % 16) == 0)
+                        std::this_thread::yield();
+                }
+            });
+        }
+        for (auto& Thread : Threads)
+            Thread.join();
+
+        RB.FinishCurrentFrame(++FenceValue);
+        for (auto& Allocs : ThreadAllocations)
+        {
+            FrameAllocations[FenceValue].insert(FrameAllocations[FenceValue].end(), Allocs.begin(), Allocs.end());
+            Allocs.clear();
+        }
+
+        if (FenceValue > NumFramesInFlight)
+            ReleaseFrames(FenceValue - NumFramesInFlight);
+    }
+    ReleaseFrames(FenceValue);
+
+    EXPECT_EQ(NumErrors.load(), Uint32{0});
+    EXPECT_TRUE(RB.IsEmpty());
+}
+
+} // namespace
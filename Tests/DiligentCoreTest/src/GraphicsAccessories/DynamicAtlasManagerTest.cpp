@@ -441,9 +441,112 @@ TEST(GraphicsAccessories_DynamicAtlasManager, Allocate)
 #endif
 }
 
-TEST(GraphicsAccessories_DynamicAtlasManager, AllocateRandom)
+TEST(GraphicsAccessories_DynamicAtlasManager, Skyline_Allocate)
+{
+    DynamicAtlasManager Mgr{32, 32, DynamicAtlasManager::PackingAlgorithm::Skyline};
+    EXPECT_EQ(Mgr.GetFreeRegionCount(), 1U);
+
+    auto R0 = Mgr.Allocate(8, 16);
+    EXPECT_EQ(R0, Region(0, 0, 8, 16));
+
+    auto R1 = Mgr.Allocate(16, 8);
+    EXPECT_EQ(R1, Region(8, 0, 16, 8));
+
+    auto R2 = Mgr.Allocate(8, 4);
+    EXPECT_EQ(R2, Region(24, 0, 8, 4));
+
+    //  _______________________________
+    // |                               |
+    // |                               |
+    // |_______                        |
+    // |       |                       |
+    // |  R0   |_______________        |
+    // |       |               |_______|
+    // |       |      R1       |  R2   |
+    // |_______|_______________|_______|
+    //
+    auto R3 = Mgr.Allocate(24, 8);
+    EXPECT_EQ(R3, Region(8, 8, 24, 8));
+    // The space above R2 is below the skyline and is reused
+    EXPECT_EQ(Mgr.GetFreeRegionCount(), 2U);
+    auto R4 = Mgr.Allocate(8, 4);
+    EXPECT_EQ(R4, Region(24, 4, 8, 4));
+    EXPECT_EQ(Mgr.GetFreeRegionCount(), 1U);
+
+    EXPECT_EQ(Mgr.GetAllocatedArea(), Uint64{8 * 16 + 16 * 8 + 8 * 4 + 24 * 8 + 8 * 4});
+    EXPECT_FLOAT_EQ(Mgr.GetOccupancy(), 0.5f);
+    EXPECT_FLOAT_EQ(Mgr.GetFragmentation(), 0.f);
+
+    EXPECT_TRUE(Mgr.Allocate(33, 1).IsEmpty());
+    EXPECT_TRUE(Mgr.Allocate(32, 17).IsEmpty());
+
+    // Freeing a region below the skyline creates a hole
+    Mgr.Free(std::move(R1));
+    EXPECT_EQ(Mgr.GetFreeRegionCount(), 2U);
+    EXPECT_GT(Mgr.GetFragmentation(), 0.f);
+
+    // Freeing the top regions lowers the skyline
+    Mgr.Free(std::move(R3));
+    Mgr.Free(std::move(R4));
+    EXPECT_EQ(Mgr.GetFreeRegionCount(), 3U);
+
+    auto R5 = Mgr.Allocate(24, 24);
+    EXPECT_EQ(R5, Region(8, 4, 24, 24));
+
+    Mgr.Free(std::move(R0));
+    Mgr.Free(std::move(R2));
+    Mgr.Free(std::move(R5));
+    EXPECT_EQ(Mgr.GetFreeRegionCount(), 1U);
+    EXPECT_EQ(Mgr.GetAllocatedArea(), Uint64{0});
+}
+
+TEST(GraphicsAccessories_DynamicAtlasManager, BatchAllocate)
 {
-    DynamicAtlasManager Mgr{256, 256};
+    for (auto Algorithm : {DynamicAtlasManager::PackingAlgorithm::Guillotine, DynamicAtlasManager::PackingAlgorithm::Skyline})
+    {
+        DynamicAtlasManager Mgr{64, 64, Algorithm};
+
+        std::vector<Region> Regions;
+        FastRandInt         rnd{0, 1, 8};
+        for (Uint32 i = 0; i < 64; ++i)
+            Regions.emplace_back(0, 0, rnd(), rnd());
+        Regions.emplace_back(0, 0, 65, 1);
+
+        Uint64 TotalArea = 0;
+        for (size_t i = 0; i + 1 < Regions.size(); ++i)
+            TotalArea += Regions[i].width * Regions[i].height;
+
+        const auto Requested = Regions;
+        EXPECT_EQ(Mgr.Allocate(Regions.data(), static_cast<Uint32>(Regions.size())), static_cast<Uint32>(Regions.size() - 1));
+        EXPECT_TRUE(Regions.back().IsEmpty());
+        Regions.pop_back();
+
+        for (size_t i = 0; i < Regions.size(); ++i)
+        {
+            EXPECT_EQ(Regions[i].width, Requested[i].width);
+            EXPECT_EQ(Regions[i].height, Requested[i].height);
+            for (size_t j = i + 1; j < Regions.size(); ++j)
+            {
+                const auto& R0 = Regions[i];
+                const auto& R1 = Regions[j];
+                const bool  Overlap =
+                    R0.x < R1.x + R1.width && R1.x < R0.x + R0.width &&
+                    R0.y < R1.y + R1.height && R1.y < R0.y + R0.height;
+                EXPECT_FALSE(Overlap) << R0 << " overlaps " << R1;
+            }
+        }
+        EXPECT_EQ(Mgr.GetAllocatedArea(), TotalArea);
+
+        for (auto& R : Regions)
+            Mgr.Free(std::move(R));
+        EXPECT_EQ(Mgr.GetFreeRegionCount(), 1U);
+        EXPECT_FLOAT_EQ(Mgr.GetFragmentation(), 0.f);
+    }
+}
+
+void TestAllocateRandom(DynamicAtlasManager::PackingAlgorithm Algorithm)
+{
+    DynamicAtlasManager Mgr{256, 256, Algorithm};
     const Uint32        NumIterations = 10;
     for (Uint32 i = 0; i < NumIterations; ++i)
     {
@@ -461,4 +564,14 @@ TEST(GraphicsAccessories_DynamicAtlasManager, AllocateRandom)
     }
 }
 
+TEST(GraphicsAccessories_DynamicAtlasManager, AllocateRandom)
+{
+    TestAllocateRandom(DynamicAtlasManager::PackingAlgorithm::Guillotine);
+}
+
+TEST(GraphicsAccessories_DynamicAtlasManager, Skyline_AllocateRandom)
+{
+    TestAllocateRandom(DynamicAtlasManager::PackingAlgorithm::Skyline);
+}
+
 } // namespace
@@ -26,11 +26,15 @@
  */
 
 #include "GraphicsUtilities.h"
+#include "GraphicsAccessories.hpp"
 #include "FastRand.hpp"
 #include "ColorConversion.h"
 
 #include <vector>
 #include <array>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
 #include "gtest/gtest.h"
 
@@ -501,4 +505,294 @@ TEST(GraphicsTools_CalculateMipLevel, sRGB)
     EXPECT_TRUE(CoarseData == RefCoarseData);
 }
 
+
+// Reference 2x2 box filter that computes one level from the previous one
+template <typename ChannelType, typename AverageFuncType>
+std::vector<ChannelType> ComputeReferenceMip(const std::vector<ChannelType>& FineData, Uint32 FineWidth, Uint32 FineHeight, Uint32 NumChannels, AverageFuncType Average)
+{
+    const Uint32 CoarseWidth  = std::max(FineWidth / 2, 1u);
+    const Uint32 CoarseHeight = std::max(FineHeight / 2, 1u);
+
+    std::vector<ChannelType> CoarseData(size_t{CoarseWidth} * CoarseHeight * NumChannels);
+    for (Uint32 y = 0; y < CoarseHeight; ++y)
+    {
+        const Uint32 y0 = y * 2;
+        const Uint32 y1 = std::min(y * 2 + 1, FineHeight - 1);
+        for (Uint32 x = 0; x < CoarseWidth; ++x)
+        {
+            const Uint32 x0 = x * 2;
+            const Uint32 x1 = std::min(x * 2 + 1, FineWidth - 1);
+            for (Uint32 c = 0; c < NumChannels; ++c)
+            {
+                CoarseData[(x + y * CoarseWidth) * NumChannels + c] =
+                    Average(FineData[(x0 + y0 * FineWidth) * NumChannels + c],
+                            FineData[(x1 + y0 * FineWidth) * NumChannels + c],
+                            FineData[(x0 + y1 * FineWidth) * NumChannels + c],
+                            FineData[(x1 + y1 * FineWidth) * NumChannels + c]);
+            }
+        }
+    }
+    return CoarseData;
+}
+
+template <typename ChannelType, typename AverageFuncType>
+void TestBoxMipChain(TEXTURE_FORMAT Fmt, int MinVal, int MaxVal, AverageFuncType Average)
+{
+    const Uint32 NumChannels = GetTextureFormatAttribs(Fmt).NumComponents;
+
+    const std::array<std::array<Uint32, 2>, 5> Sizes = //
+        {{
+            {300, 77},
+            {257, 1},
+            {1, 129},
+            {515, 390},
+            {2, 2} //
+        }};
+
+    FastRandInt rnd{static_cast<unsigned int>(Fmt), MinVal, MaxVal};
+    for (const auto& Size : Sizes)
+    {
+        const Uint32 Width  = Size[0];
+        const Uint32 Height = Size[1];
+
+        std::vector<ChannelType> FineData(size_t{Width} * Height * NumChannels);
+        for (auto& c : FineData)
+            c = static_cast<ChannelType>(rnd());
+
+        const Uint32 NumCoarseLevels = ComputeMipLevelsCount(Width, Height) - 1;
+
+        std::vector<std::vector<ChannelType>> RefLevels(NumCoarseLevels);
+        for (Uint32 Level = 0, LevelWidth = Width, LevelHeight = Height; Level < NumCoarseLevels; ++Level)
+        {
+            RefLevels[Level] = ComputeReferenceMip(Level == 0 ? FineData : RefLevels[Level - 1], LevelWidth, LevelHeight, NumChannels, Average);
+            LevelWidth       = std::max(LevelWidth / 2, 1u);
+            LevelHeight      = std::max(LevelHeight / 2, 1u);
+        }
+
+        for (Uint32 NumThreads : {1u, 3u})
+        {
+            // Odd levels use padded rows
+            std::vector<std::vector<Uint8>> Levels(NumCoarseLevels);
+            std::vector<void*>              pLevels(NumCoarseLevels);
+            std::vector<Uint32>             Strides(NumCoarseLevels);
+            for (Uint32 Level = 0; Level < NumCoarseLevels; ++Level)
+            {
+                const Uint32 LevelWidth  = std::max(Width >> (Level + 1), 1u);
+                const Uint32 LevelHeight = std::max(Height >> (Level + 1), 1u);
+
+                Strides[Level] = static_cast<Uint32>(LevelWidth * NumChannels * sizeof(ChannelType)) + (Level % 2) * 12;
+                Levels[Level].resize(size_t{Strides[Level]} * LevelHeight);
+                pLevels[Level] = Levels[Level].data();
+            }
+
+            ComputeMipChainAttribs Attribs;
+            Attribs.Format              = Fmt;
+            Attribs.FineLevelWidth      = Width;
+            Attribs.FineLevelHeight     = Height;
+            Attribs.pFineLevelData      = FineData.data();
+            Attribs.FineLevelStride     = static_cast<Uint32>(Width * NumChannels * sizeof(ChannelType));
+            Attribs.NumCoarseLevels     = NumCoarseLevels;
+            Attribs.ppCoarseLevelsData  = pLevels.data();
+            Attribs.pCoarseLevelStrides = Strides.data();
+            Attribs.NumThreads          = NumThreads;
+            ComputeMipChain(Attribs);
+
+            for (Uint32 Level = 0; Level < NumCoarseLevels; ++Level)
+            {
+                const Uint32 LevelWidth  = std::max(Width >> (Level + 1), 1u);
+                const Uint32 LevelHeight = std::max(Height >> (Level + 1), 1u);
+                const size_t RowSize     = LevelWidth * NumChannels * sizeof(ChannelType);
+                for (Uint32 y = 0; y < LevelHeight; ++y)
+                {
+                    EXPECT_EQ(memcmp(&Levels[Level][y * Strides[Level]], &RefLevels[Level][y * LevelWidth * NumChannels], RowSize), 0)
+                        << "Format: " << GetTextureFormatAttribs(Fmt).Name << ", size: " << Width << "x" << Height << ", level " << Level + 1 << ", row " << y;
+                }
+            }
+        }
+    }
+}
+
+TEST(GraphicsTools_ComputeMipChain, Box)
+{
+    auto UIntAverage = [](Uint32 c0, Uint32 c1, Uint32 c2, Uint32 c3) {
+        return (c0 + c1 + c2 + c3) >> 2;
+    };
+    TestBoxMipChain<Uint8>(TEX_FORMAT_RGBA8_UNORM, 0, 255, UIntAverage);
+    TestBoxMipChain<Uint8>(TEX_FORMAT_RG8_UNORM, 0, 255, UIntAverage);
+    TestBoxMipChain<Uint8>(TEX_FORMAT_R8_UINT, 0, 255, UIntAverage);
+    TestBoxMipChain<Uint16>(TEX_FORMAT_RGBA16_UNORM, 0, 30000, UIntAverage);
+
+    TestBoxMipChain<Int8>(TEX_FORMAT_RGBA8_SNORM, -128, 127, [](Int32 c0, Int32 c1, Int32 c2, Int32 c3) {
+        return (c0 + c1 + c2 + c3) / 4;
+    });
+
+    auto FloatAverage = [](float c0, float c1, float c2, float c3) {
+        return (c0 + c1 + c2 + c3) * 0.25f;
+    };
+    TestBoxMipChain<float>(TEX_FORMAT_RGBA32_FLOAT, -1000, 1000, FloatAverage);
+    TestBoxMipChain<float>(TEX_FORMAT_RG32_FLOAT, -1000, 1000, FloatAverage);
+
+    TestBoxMipChain<Uint8>(TEX_FORMAT_RGBA8_UNORM_SRGB, 0, 255, [](Uint8 c0, Uint8 c1, Uint8 c2, Uint8 c3) {
+        const float fLinearAverage = (FastSRGBToLinear(c0 * (1.f / 255.f)) +
+                                      FastSRGBToLinear(c1 * (1.f / 255.f)) +
+                                      FastSRGBToLinear(c2 * (1.f / 255.f)) +
+                                      FastSRGBToLinear(c3 * (1.f / 255.f))) *
+            0.25f;
+        const float fSRGB = FastLinearToSRGB(fLinearAverage) * 255.f;
+        return static_cast<Uint8>(std::min(std::max(fSRGB, 0.f), 255.f));
+    });
+}
+
+std::vector<std::vector<Uint8>> ComputeRGBA8MipChain(const std::vector<Uint8>& FineData,
+                                                     Uint32                    Width,
+                                                     Uint32                    Height,
+                                                     TEXTURE_FORMAT            Fmt,
+                                                     MIP_FILTER_TYPE           FilterType,
+                                                     float                     AlphaCutoff = 0,
+                                                     Uint32                    NumThreads  = 1,
+                                                     Uint32                    FineStride  = ~0u)
+{
+    const Uint32 NumCoarseLevels = ComputeMipLevelsCount(Width, Height) - 1;
+
+    std::vector<std::vector<Uint8>> Levels(NumCoarseLevels);
+    std::vector<void*>              pLevels(NumCoarseLevels);
+    for (Uint32 Level = 0; Level < NumCoarseLevels; ++Level)
+    {
+        Levels[Level].resize(size_t{std::max(Width >> (Level + 1), 1u)} * std::max(Height >> (Level + 1), 1u) * 4);
+        pLevels[Level] = Levels[Level].data();
+    }
+
+    ComputeMipChainAttribs Attribs;
+    Attribs.Format             = Fmt;
+    Attribs.FineLevelWidth     = Width;
+    Attribs.FineLevelHeight    = Height;
+    Attribs.pFineLevelData     = FineData.data();
+    Attribs.FineLevelStride    = FineStride != ~0u ? FineStride : Width * 4;
+    Attribs.NumCoarseLevels    = NumCoarseLevels;
+    Attribs.ppCoarseLevelsData = pLevels.data();
+    Attribs.FilterType         = FilterType;
+    Attribs.AlphaCutoff        = AlphaCutoff;
+    Attribs.NumThreads         = NumThreads;
+    ComputeMipChain(Attribs);
+
+    return Levels;
+}
+
+TEST(GraphicsTools_ComputeMipChain, KaiserLanczos)
+{
+    constexpr Uint32 Width  = 97;
+    constexpr Uint32 Height = 64;
+
+    for (auto FilterType : {MIP_FILTER_TYPE_KAISER, MIP_FILTER_TYPE_LANCZOS})
+    {
+        for (auto Fmt : {TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_RGBA8_UNORM_SRGB})
+        {
+            // Constant image remains constant
+            {
+                std::vector<Uint8> FineData(Width * Height * 4);
+                for (size_t i = 0; i < FineData.size(); ++i)
+                    FineData[i] = static_cast<Uint8>(40 + (i % 4) * 50);
+
+                const auto Levels = ComputeRGBA8MipChain(FineData, Width, Height, Fmt, FilterType);
+                for (const auto& Level : Levels)
+                {
+                    for (size_t i = 0; i < Level.size(); ++i)
+                        EXPECT_NEAR(Level[i], FineData[i % 4], 1);
+                }
+            }
+
+            // Horizontal gradient remains monotonic away from the edges
+            {
+                std::vector<Uint8> FineData(Width * Height * 4);
+                for (Uint32 y = 0; y < Height; ++y)
+                {
+                    for (Uint32 x = 0; x < Width; ++x)
+                    {
+                        for (Uint32 c = 0; c < 4; ++c)
+                            FineData[(x + y * Width) * 4 + c] = static_cast<Uint8>(x * 2);
+                    }
+                }
+
+                const auto   Levels = ComputeRGBA8MipChain(FineData, Width, Height, Fmt, FilterType);
+                const auto&  Level1 = Levels[0];
+                const Uint32 Width1 = Width / 2;
+                for (Uint32 x = 4; x + 4 < Width1; ++x)
+                    EXPECT_LT(Level1[x * 4], Level1[(x + 1) * 4]);
+            }
+
+            // Random image: results do not depend on the number of threads
+            {
+                std::vector<Uint8> FineData(Width * Height * 4);
+
+                FastRandInt rnd{1, 0, 255};
+                for (auto& c : FineData)
+                    c = static_cast<Uint8>(rnd());
+
+                const auto Levels1 = ComputeRGBA8MipChain(FineData, Width, Height, Fmt, FilterType, 0, 1);
+                const auto Levels4 = ComputeRGBA8MipChain(FineData, Width, Height, Fmt, FilterType, 0, 4);
+                EXPECT_TRUE(Levels1 == Levels4);
+            }
+        }
+    }
+}
+
+TEST(GraphicsTools_ComputeMipChain, AlphaCoverage)
+{
+    constexpr Uint32 Width       = 256;
+    constexpr Uint32 Height      = 256;
+    constexpr float  AlphaCutoff = 0.5f;
+
+    // Small opaque blobs with soft edges: the coverage vanishes in coarse levels without the correction
+    std::vector<Uint8> FineData(Width * Height * 4, 0);
+    for (Uint32 y = 0; y < Height; ++y)
+    {
+        for (Uint32 x = 0; x < Width; ++x)
+        {
+            const float Wave  = (std::sin(static_cast<float>(x) * 0.9f + static_cast<float>(y) * 0.137f) * std::sin(static_cast<float>(y) * 0.8f + static_cast<float>(x) * 0.071f) + 1.f) * 0.5f;
+            const float Alpha = std::min(std::max((Wave - 0.6f) * 5.f, 0.f), 1.f);
+
+            FineData[(x + y * Width) * 4 + 3] = static_cast<Uint8>(Alpha * 255.f);
+        }
+    }
+
+    auto GetCoverage = [AlphaCutoff](const std::vector<Uint8>& Data) {
+        size_t NumPassed = 0;
+        for (size_t i = 3; i < Data.size(); i += 4)
+            NumPassed += (Data[i] > AlphaCutoff * 255.f) ? 1 : 0;
+        return static_cast<float>(NumPassed) / static_cast<float>(Data.size() / 4);
+    };
+    const float FineCoverage = GetCoverage(FineData);
+
+    for (auto FilterType : {MIP_FILTER_TYPE_BOX, MIP_FILTER_TYPE_KAISER})
+    {
+        const auto Levels          = ComputeRGBA8MipChain(FineData, Width, Height, TEX_FORMAT_RGBA8_UNORM, FilterType);
+        const auto PreservedLevels = ComputeRGBA8MipChain(FineData, Width, Height, TEX_FORMAT_RGBA8_UNORM, FilterType, AlphaCutoff);
+
+        EXPECT_LT(GetCoverage(Levels[2]), FineCoverage * 0.5f);
+        // Coarse alpha values are quantized, so the coverage can only be matched approximately
+        for (Uint32 Level = 0; Level < 5; ++Level)
+            EXPECT_NEAR(GetCoverage(PreservedLevels[Level]), FineCoverage, 0.05f) << "Level " << Level + 1;
+    }
+}
+
+TEST(GraphicsTools_ComputeMipChain, TightFineStride)
+{
+    constexpr Uint32 Width  = 37;
+    constexpr Uint32 Height = 21;
+
+    std::vector<Uint8> FineData(Width * Height * 4);
+
+    FastRandInt rnd{2, 0, 255};
+    for (auto& c : FineData)
+        c = static_cast<Uint8>(rnd());
+
+    // Zero fine level stride means tightly packed rows
+    for (auto FilterType : {MIP_FILTER_TYPE_BOX, MIP_FILTER_TYPE_KAISER})
+    {
+        const auto RefLevels  = ComputeRGBA8MipChain(FineData, Width, Height, TEX_FORMAT_RGBA8_UNORM, FilterType);
+        const auto TestLevels = ComputeRGBA8MipChain(FineData, Width, Height, TEX_FORMAT_RGBA8_UNORM, FilterType, 0, 1, 0);
+        EXPECT_TRUE(RefLevels == TestLevels);
+    }
+}
+
 } // namespace
@@ -26,9 +26,13 @@
  */
 
 #include <memory>
+#include <atomic>
+#include <thread>
+#include <vector>
 
 #include "ResourceReleaseQueue.hpp"
 #include "DefaultRawMemoryAllocator.hpp"
+#include "TrackingMemoryAllocator.hpp"
 
 #include "gtest/gtest.h"
 
@@ -128,4 +132,160 @@ TEST(GraphicsAccessories_ResourceReleaseQueue, GetFilterTypeLiteralName)
     }
 }
 
+// Resource that counts how many times it has been destroyed
+class CountedResource
+{
+public:
+    explicit CountedResource(std::atomic<int>& Counter) :
+        m_pCounter{&Counter}
+    {}
+
+    CountedResource(CountedResource&& rhs) noexcept :
+        m_pCounter{rhs.m_pCounter}
+    {
+        rhs.m_pCounter = nullptr;
+    }
+
+    // clang-format off
+    CountedResource             (const CountedResource&) = delete;
+    CountedResource& operator = (const CountedResource&) = delete;
+    CountedResource& operator = (CountedResource&&)      = delete;
+    // clang-format on
+
+    ~CountedResource()
+    {
+        if (m_pCounter != nullptr)
+            m_pCounter->fetch_add(1);
+    }
+
+private:
+    std::atomic<int>* m_pCounter;
+};
+
+TEST(GraphicsAccessories_ResourceReleaseQueue, FenceBuckets)
+{
+    ResourceReleaseQueue<DynamicStaleResourceWrapper> Queue(DefaultRawMemoryAllocator::GetAllocator());
+
+    std::atomic<int> Fence1{0}, Fence2{0}, Fence3{0};
+
+    Queue.SafeReleaseResource(CountedResource{Fence2}, 1);
+    Queue.SafeReleaseResource(CountedResource{Fence3}, 2);
+    Queue.DiscardResource(CountedResource{Fence3}, 3);
+    Queue.DiscardResource(CountedResource{Fence1}, 1);
+    Queue.SafeReleaseResource(CountedResource{Fence2}, 0);
+    EXPECT_EQ(Queue.GetStaleResourceCount(), size_t{3});
+    EXPECT_EQ(Queue.GetPendingReleaseResourceCount(), size_t{2});
+
+    // Only the resources released before command list 1 was submitted are moved to the release queue
+    Queue.DiscardStaleResources(1, 2);
+    EXPECT_EQ(Queue.GetStaleResourceCount(), size_t{1});
+    EXPECT_EQ(Queue.GetPendingReleaseResourceCount(), size_t{4});
+
+    Queue.Purge(0);
+    EXPECT_EQ(Queue.GetPendingReleaseResourceCount(), size_t{4});
+
+    Queue.DiscardStaleResources(2, 3);
+    EXPECT_EQ(Queue.GetStaleResourceCount(), size_t{0});
+
+    Queue.Purge(1);
+    EXPECT_EQ(Fence1.load(), 1);
+    EXPECT_EQ(Fence2.load(), 0);
+    EXPECT_EQ(Queue.GetPendingReleaseResourceCount(), size_t{4});
+
+    Queue.Purge(2);
+    EXPECT_EQ(Fence2.load(), 2);
+    EXPECT_EQ(Fence3.load(), 0);
+
+    Queue.Purge(3);
+    EXPECT_EQ(Fence3.load(), 2);
+    EXPECT_EQ(Queue.GetPendingReleaseResourceCount(), size_t{0});
+
+    const auto Stats = Queue.GetStatistics();
+    EXPECT_EQ(Stats.NumReleasedResources, Uint64{5});
+    EXPECT_GE(Stats.MaxReleaseLatency, Stats.AvgReleaseLatency);
+}
+
+TEST(GraphicsAccessories_ResourceReleaseQueue, NodeAllocator)
+{
+    TrackingMemoryAllocator Tracker{DefaultRawMemoryAllocator::GetAllocator()};
+
+    auto GetNodePageAllocations = [&Tracker]() {
+        const auto Snapshot = Tracker.GetSnapshot();
+        for (const auto& Tag : Snapshot.Tags)
+        {
+            if (Tag.Description == "FixedBlockMemoryAllocator aligned page chunk")
+                return Tag.LiveAllocations;
+        }
+        return Int64{0};
+    };
+
+    {
+        ResourceReleaseQueue<DynamicStaleResourceWrapper> Queue(Tracker);
+
+        std::atomic<int> Fence{0};
+        Queue.SafeReleaseResource(CountedResource{Fence}, 0);
+        Queue.DiscardResource(CountedResource{Fence}, 1);
+
+        // The nodes are allocated from the allocator passed to the queue
+        EXPECT_GT(GetNodePageAllocations(), 0);
+
+        Queue.DiscardStaleResources(0, 1);
+        Queue.Purge(1);
+        EXPECT_EQ(Fence.load(), 2);
+    }
+
+    EXPECT_EQ(Tracker.GetSnapshot().Total.LiveAllocations, 0);
+}
+
+TEST(GraphicsAccessories_ResourceReleaseQueue, MultithreadedRelease)
+{
+    constexpr size_t NumThreads            = 4;
+    constexpr int    NumResourcesPerThread = 2048;
+
+    ResourceReleaseQueue<DynamicStaleResourceWrapper> Queue(DefaultRawMemoryAllocator::GetAllocator());
+
+    std::atomic<int>    NumDestroyed{0};
+    std::atomic<Uint64> NextCmdListNumber{0};
+    std::atomic<size_t> NumFinishedThreads{0};
+
+    std::vector<std::thread> Threads;
+    for (size_t t = 0; t < NumThreads; ++t)
+    {
+        Threads.emplace_back([&, t]() {
+            for (int i = 0; i < NumResourcesPerThread; ++i)
+            {
+                if (i % 2 == 0)
+                    Queue.SafeReleaseResource(CountedResource{NumDestroyed}, NextCmdListNumber.load());
+                else
+                    Queue.DiscardResource(CountedResource{NumDestroyed}, NextCmdListNumber.load());
+
+                if (i % 64 == 0)
+                    std::this_thread::yield();
+            }
+            NumFinishedThreads.fetch_add(1);
+        });
+    }
+
+    // Submit command lists and retire resources while the threads are releasing them
+    Uint64 FenceValue = 0;
+    while (NumFinishedThreads.load() < NumThreads)
+    {
+        const auto CmdListNumber = NextCmdListNumber.fetch_add(1);
+        Queue.DiscardStaleResources(CmdListNumber, ++FenceValue);
+        if (FenceValue > 2)
+            Queue.Purge(FenceValue - 2);
+        std::this_thread::yield();
+    }
+
+    for (auto& Thread : Threads)
+        Thread.join();
+
+    Queue.DiscardStaleResources(NextCmdListNumber.load(), ++FenceValue);
+    EXPECT_EQ(Queue.GetStaleResourceCount(), size_t{0});
+    Queue.Purge(FenceValue);
+    EXPECT_EQ(Queue.GetPendingReleaseResourceCount(), size_t{0});
+    EXPECT_EQ(NumDestroyed.load(), static_cast<int>(NumThreads) * NumResourcesPerThread);
+    EXPECT_EQ(Queue.GetStatistics().NumReleasedResources, Uint64{NumThreads * NumResourcesPerThread});
+}
+
 } // namespace
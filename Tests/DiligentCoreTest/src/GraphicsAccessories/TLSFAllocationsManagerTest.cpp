@@ -0,0 +1,209 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <vector>
+
+#include "TLSFAllocationsManager.hpp"
+#include "DefaultRawMemoryAllocator.hpp"
+#include "FastRand.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+using OffsetType = TLSFAllocationsManager::OffsetType;
+
+TEST(GraphicsAccessories_TLSFAllocationsManager, AllocateFree)
+{
+    TLSFAllocationsManager Mgr{128, DefaultRawMemoryAllocator::GetAllocator()};
+    EXPECT_EQ(Mgr.GetNumFreeBlocks(), size_t{1});
+
+    auto a1 = Mgr.Allocate(17, 4);
+    EXPECT_EQ(a1.UnalignedOffset, OffsetType{0});
+    EXPECT_EQ(a1.Size, OffsetType{20});
+    EXPECT_EQ(Mgr.GetNumFreeBlocks(), size_t{1});
+
+    auto a2 = Mgr.Allocate(17, 8);
+    EXPECT_EQ(a2.UnalignedOffset, OffsetType{20});
+    EXPECT_EQ(a2.Size, OffsetType{28});
+
+    auto a3 = Mgr.Allocate(16, 16);
+    EXPECT_EQ(a3.UnalignedOffset, OffsetType{48});
+    EXPECT_EQ(a3.Size, OffsetType{16});
+
+    auto a4 = Mgr.Allocate(128, 1);
+    EXPECT_FALSE(a4.IsValid());
+
+    a4 = Mgr.Allocate(64, 1);
+    EXPECT_EQ(a4.UnalignedOffset, OffsetType{64});
+    EXPECT_EQ(a4.Size, OffsetType{64});
+    EXPECT_EQ(Mgr.GetNumFreeBlocks(), size_t{0});
+    EXPECT_TRUE(Mgr.IsFull());
+
+    Mgr.Free(std::move(a2));
+    EXPECT_FALSE(a2.IsValid());
+    EXPECT_EQ(Mgr.GetNumFreeBlocks(), size_t{1});
+
+    Mgr.Free(a4.UnalignedOffset, a4.Size);
+    EXPECT_EQ(Mgr.GetNumFreeBlocks(), size_t{2});
+
+    // Merge with the previous block
+    Mgr.Free(std::move(a3));
+    EXPECT_EQ(Mgr.GetNumFreeBlocks(), size_t{1});
+    EXPECT_EQ(Mgr.GetFreeSize(), OffsetType{108});
+
+    // Merge with the next block
+    Mgr.Free(std::move(a1));
+    EXPECT_EQ(Mgr.GetNumFreeBlocks(), size_t{1});
+    EXPECT_TRUE(Mgr.IsEmpty());
+
+    auto a5 = Mgr.Allocate(128, 1);
+    EXPECT_EQ(a5.UnalignedOffset, OffsetType{0});
+    EXPECT_EQ(a5.Size, OffsetType{128});
+    Mgr.Free(std::move(a5));
+}
+
+TEST(GraphicsAccessories_TLSFAllocationsManager, Extend)
+{
+    TLSFAllocationsManager Mgr{0, DefaultRawMemoryAllocator::GetAllocator()};
+    EXPECT_EQ(Mgr.GetNumFreeBlocks(), size_t{0});
+    EXPECT_FALSE(Mgr.Allocate(16, 1).IsValid());
+
+    Mgr.Extend(64);
+    auto a1 = Mgr.Allocate(48, 1);
+    EXPECT_EQ(a1.UnalignedOffset, OffsetType{0});
+
+    // The last free block is extended
+    Mgr.Extend(64);
+    EXPECT_EQ(Mgr.GetNumFreeBlocks(), size_t{1});
+    auto a2 = Mgr.Allocate(80, 1);
+    EXPECT_EQ(a2.UnalignedOffset, OffsetType{48});
+
+    // A new block is added
+    Mgr.Extend(32);
+    EXPECT_EQ(Mgr.GetNumFreeBlocks(), size_t{1});
+    EXPECT_EQ(Mgr.GetMaxSize(), OffsetType{160});
+    EXPECT_EQ(Mgr.GetFreeSize(), OffsetType{32});
+
+    Mgr.Free(std::move(a1));
+    Mgr.Free(std::move(a2));
+    EXPECT_TRUE(Mgr.IsEmpty());
+    EXPECT_EQ(Mgr.GetNumFreeBlocks(), size_t{1});
+}
+
+TEST(GraphicsAccessories_TLSFAllocationsManager, RandomAllocations)
+{
+    constexpr OffsetType MaxSize = 1 << 16;
+
+    TLSFAllocationsManager Mgr{MaxSize, DefaultRawMemoryAllocator::GetAllocator()};
+
+    std::vector<bool>                               Used(MaxSize);
+    std::vector<TLSFAllocationsManager::Allocation> Allocations;
+    OffsetType                                      UsedSize = 0;
+
+    FastRandInt Rnd{0, 0, 1023};
+    for (int i = 0; i < 20000; ++i)
+    {
+        if (Allocations.empty() || Rnd() < 576)
+        {
+            const auto Size      = static_cast<OffsetType>(Rnd() % 300 + 1);
+            const auto Alignment = OffsetType{1} << (Rnd() % 6);
+
+            auto Alloc = Mgr.Allocate(Size, Alignment);
+            if (!Alloc.IsValid())
+                continue;
+
+            ASSERT_LE(Alloc.UnalignedOffset + Alloc.Size, MaxSize);
+            const auto AlignedOffset = AlignUp(Alloc.UnalignedOffset, Alignment);
+            ASSERT_LE(AlignedOffset + Size, Alloc.UnalignedOffset + Alloc.Size);
+            for (auto b = Alloc.UnalignedOffset; b < Alloc.UnalignedOffset + Alloc.Size; ++b)
+            {
+                ASSERT_FALSE(Used[b]) << "Allocations overlap";
+                Used[b] = true;
+            }
+            UsedSize += Alloc.Size;
+            Allocations.push_back(Alloc);
+        }
+        else
+        {
+            const auto Idx   = static_cast<size_t>(Rnd()) % Allocations.size();
+            auto       Alloc = Allocations[Idx];
+            Allocations[Idx] = Allocations.back();
+            Allocations.pop_back();
+
+            for (auto b = Alloc.UnalignedOffset; b < Alloc.UnalignedOffset + Alloc.Size; ++b)
+                Used[b] = false;
+            UsedSize -= Alloc.Size;
+            Mgr.Free(std::move(Alloc));
+        }
+
+        ASSERT_EQ(Mgr.GetUsedSize(), UsedSize);
+    }
+
+    for (auto& Alloc : Allocations)
+        Mgr.Free(std::move(Alloc));
+    EXPECT_TRUE(Mgr.IsEmpty());
+    EXPECT_EQ(Mgr.GetNumFreeBlocks(), size_t{1});
+
+    auto Alloc = Mgr.Allocate(MaxSize, 1);
+    EXPECT_TRUE(Alloc.IsValid());
+    Mgr.Free(std::move(Alloc));
+}
+
+TEST(GraphicsAccessories_TLSFAllocationsManager, MoveAssignment)
+{
+    TLSFAllocationsManager Mgr{0, DefaultRawMemoryAllocator::GetAllocator()};
+    {
+        TLSFAllocationsManager Src{128, DefaultRawMemoryAllocator::GetAllocator()};
+        auto                   a1 = Src.Allocate(32, 1);
+        auto                   a2 = Src.Allocate(32, 1);
+        Src.Free(std::move(a1));
+        EXPECT_EQ(Src.GetNumFreeBlocks(), size_t{2});
+
+        Mgr = std::move(Src);
+        EXPECT_EQ(Src.GetNumFreeBlocks(), size_t{0});
+        EXPECT_EQ(Src.GetMaxSize(), OffsetType{0});
+        EXPECT_FALSE(Src.Allocate(16, 1).IsValid());
+
+        EXPECT_EQ(Mgr.GetNumFreeBlocks(), size_t{2});
+        EXPECT_EQ(Mgr.GetMaxSize(), OffsetType{128});
+        EXPECT_EQ(Mgr.GetFreeSize(), OffsetType{96});
+        Mgr.Free(std::move(a2));
+        // Source manager is destroyed here and must be in a consistent empty state
+    }
+    EXPECT_TRUE(Mgr.IsEmpty());
+    EXPECT_EQ(Mgr.GetNumFreeBlocks(), size_t{1});
+
+    auto a3 = Mgr.Allocate(128, 1);
+    EXPECT_EQ(a3.UnalignedOffset, OffsetType{0});
+    Mgr.Free(std::move(a3));
+}
+
+} // namespace
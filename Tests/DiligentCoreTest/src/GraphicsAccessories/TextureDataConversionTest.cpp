@@ -0,0 +1,379 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "TextureDataConversion.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "ColorConversion.h"
+#include "GraphicsAccessories.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+template <typename SrcType, typename DstType>
+std::vector<DstType> Convert(TEXTURE_FORMAT              SrcFormat,
+                             TEXTURE_FORMAT              DstFormat,
+                             const std::vector<SrcType>& SrcData,
+                             Uint32                      Width,
+                             Uint32                      SrcComponentCount = 0,
+                             Uint32                      DstComponentCount = 0)
+{
+    const auto DstNumComponents = DstComponentCount != 0 ? DstComponentCount : Uint32{GetTextureFormatAttribs(DstFormat).NumComponents};
+
+    std::vector<DstType> DstData(size_t{Width} * DstNumComponents);
+
+    TextureDataConversionAttribs Attribs;
+    Attribs.SrcFormat         = SrcFormat;
+    Attribs.DstFormat         = DstFormat;
+    Attribs.SrcComponentCount = SrcComponentCount;
+    Attribs.DstComponentCount = DstComponentCount;
+    Attribs.pSrcData          = SrcData.data();
+    Attribs.pDstData          = DstData.data();
+    Attribs.Width             = Width;
+    EXPECT_TRUE(ConvertTextureData(Attribs));
+    return DstData;
+}
+
+Uint16 FloatToHalfBits(float f)
+{
+    return Convert<float, Uint16>(TEX_FORMAT_R32_FLOAT, TEX_FORMAT_R16_FLOAT, {f}, 1)[0];
+}
+
+TEST(GraphicsAccessories_TextureDataConversion, IsSupported)
+{
+    EXPECT_TRUE(IsTextureDataConversionSupported(TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_RGBA32_FLOAT));
+    EXPECT_TRUE(IsTextureDataConversionSupported(TEX_FORMAT_BGRA8_UNORM_SRGB, TEX_FORMAT_RG16_SNORM));
+    EXPECT_TRUE(IsTextureDataConversionSupported(TEX_FORMAT_A8_UNORM, TEX_FORMAT_R32_UINT));
+    EXPECT_FALSE(IsTextureDataConversionSupported(TEX_FORMAT_BC1_UNORM, TEX_FORMAT_RGBA8_UNORM));
+    EXPECT_FALSE(IsTextureDataConversionSupported(TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_RGB10A2_UNORM));
+    EXPECT_FALSE(IsTextureDataConversionSupported(TEX_FORMAT_RGBA8_TYPELESS, TEX_FORMAT_RGBA8_UNORM));
+    EXPECT_FALSE(IsTextureDataConversionSupported(TEX_FORMAT_D24_UNORM_S8_UINT, TEX_FORMAT_RGBA8_UNORM));
+}
+
+TEST(GraphicsAccessories_TextureDataConversion, RGB8ToRGBA8)
+{
+    constexpr Uint32 Width = 37;
+
+    std::vector<Uint8> RGB(Width * 3);
+    for (size_t i = 0; i < RGB.size(); ++i)
+        RGB[i] = static_cast<Uint8>(i * 7);
+
+    for (auto DstFormat : {TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_BGRA8_UNORM})
+    {
+        const bool SwapRB = DstFormat == TEX_FORMAT_BGRA8_UNORM;
+        const auto RGBA   = Convert<Uint8, Uint8>(TEX_FORMAT_RGBA8_UNORM, DstFormat, RGB, Width, 3);
+        for (Uint32 x = 0; x < Width; ++x)
+        {
+            EXPECT_EQ(RGBA[x * 4 + 0], RGB[x * 3 + (SwapRB ? 2 : 0)]);
+            EXPECT_EQ(RGBA[x * 4 + 1], RGB[x * 3 + 1]);
+            EXPECT_EQ(RGBA[x * 4 + 2], RGB[x * 3 + (SwapRB ? 0 : 2)]);
+            EXPECT_EQ(RGBA[x * 4 + 3], 0xFF);
+        }
+    }
+}
+
+TEST(GraphicsAccessories_TextureDataConversion, SwapRB)
+{
+    constexpr Uint32 Width = 41;
+
+    std::vector<Uint8> RGBA(Width * 4);
+    for (size_t i = 0; i < RGBA.size(); ++i)
+        RGBA[i] = static_cast<Uint8>(i * 13);
+
+    const auto BGRA = Convert<Uint8, Uint8>(TEX_FORMAT_RGBA8_UNORM_SRGB, TEX_FORMAT_BGRA8_UNORM_SRGB, RGBA, Width);
+    for (Uint32 x = 0; x < Width; ++x)
+    {
+        EXPECT_EQ(BGRA[x * 4 + 0], RGBA[x * 4 + 2]);
+        EXPECT_EQ(BGRA[x * 4 + 1], RGBA[x * 4 + 1]);
+        EXPECT_EQ(BGRA[x * 4 + 2], RGBA[x * 4 + 0]);
+        EXPECT_EQ(BGRA[x * 4 + 3], RGBA[x * 4 + 3]);
+    }
+
+    // General path: BGRA -> RGB
+    const auto RGB = Convert<Uint8, Uint8>(TEX_FORMAT_BGRA8_UNORM_SRGB, TEX_FORMAT_RGBA8_UNORM_SRGB, BGRA, Width, 0, 3);
+    for (Uint32 x = 0; x < Width; ++x)
+    {
+        for (Uint32 c = 0; c < 3; ++c)
+            EXPECT_EQ(RGB[x * 3 + c], RGBA[x * 4 + c]);
+    }
+}
+
+TEST(GraphicsAccessories_TextureDataConversion, SRGB)
+{
+    std::vector<Uint8> Data(256 * 4);
+    for (Uint32 i = 0; i < 256; ++i)
+    {
+        for (Uint32 c = 0; c < 4; ++c)
+            Data[i * 4 + c] = static_cast<Uint8>(i);
+    }
+
+    const auto Linear8  = Convert<Uint8, Uint8>(TEX_FORMAT_RGBA8_UNORM_SRGB, TEX_FORMAT_RGBA8_UNORM, Data, 256);
+    const auto Linear32 = Convert<Uint8, float>(TEX_FORMAT_RGBA8_UNORM_SRGB, TEX_FORMAT_RGBA32_FLOAT, Data, 256);
+    const auto SRGB8    = Convert<Uint8, Uint8>(TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_RGBA8_UNORM_SRGB, Data, 256);
+    // The general path must produce the same results as the table-based paths
+    const auto Linear16 = Convert<Uint8, Uint16>(TEX_FORMAT_RGBA8_UNORM_SRGB, TEX_FORMAT_RGBA16_UNORM, Data, 256);
+    const auto SRGB8RGB = Convert<Uint8, Uint8>(TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_RGBA8_UNORM_SRGB, Data, 256, 0, 3);
+    for (Uint32 i = 0; i < 256; ++i)
+    {
+        const auto Val = static_cast<Uint8>(i);
+        for (Uint32 c = 0; c < 3; ++c)
+        {
+            EXPECT_EQ(Linear32[i * 4 + c], SRGBToLinear(Val));
+            EXPECT_EQ(Linear8[i * 4 + c], static_cast<Uint8>(std::round(SRGBToLinear(Val) * 255.f)));
+            EXPECT_NEAR(Linear16[i * 4 + c] / 65535.f, Linear8[i * 4 + c] / 255.f, 0.5f / 255.f);
+            EXPECT_EQ(SRGB8[i * 4 + c], static_cast<Uint8>(std::round(LinearToSRGB(static_cast<float>(i) / 255.f) * 255.f)));
+            EXPECT_EQ(SRGB8RGB[i * 3 + c], SRGB8[i * 4 + c]);
+        }
+        // Alpha is linear
+        EXPECT_EQ(Linear8[i * 4 + 3], Val);
+        EXPECT_EQ(SRGB8[i * 4 + 3], Val);
+        EXPECT_EQ(Linear32[i * 4 + 3], static_cast<float>(i) * (1.f / 255.f));
+    }
+
+    // sRGB -> linear -> sRGB is lossless
+    const auto SRGBRoundTrip = Convert<float, Uint8>(TEX_FORMAT_RGBA32_FLOAT, TEX_FORMAT_RGBA8_UNORM_SRGB, Linear32, 256);
+    EXPECT_EQ(SRGBRoundTrip, Data);
+}
+
+TEST(GraphicsAccessories_TextureDataConversion, UNormToFloat)
+{
+    constexpr Uint32 Width = 333;
+
+    std::vector<Uint16> Data16(Width * 2);
+    std::vector<Uint8>  Data8(Width * 2);
+    for (Uint32 i = 0; i < Width * 2; ++i)
+    {
+        Data16[i] = static_cast<Uint16>(i * 197);
+        Data8[i]  = static_cast<Uint8>(i);
+    }
+
+    const auto Float16 = Convert<Uint16, float>(TEX_FORMAT_RG16_UNORM, TEX_FORMAT_RG32_FLOAT, Data16, Width);
+    const auto Float8  = Convert<Uint8, float>(TEX_FORMAT_RG8_UNORM, TEX_FORMAT_RG32_FLOAT, Data8, Width);
+    for (Uint32 i = 0; i < Width * 2; ++i)
+    {
+        EXPECT_EQ(Float16[i], static_cast<float>(Data16[i]) * (1.f / 65535.f));
+        EXPECT_EQ(Float8[i], static_cast<float>(Data8[i]) * (1.f / 255.f));
+    }
+
+    // Float -> UNORM rounds to nearest and clamps
+    const auto UNorm8 = Convert<float, Uint8>(TEX_FORMAT_R32_FLOAT, TEX_FORMAT_R8_UNORM, {-1.f, 0.f, 0.5f, 1.f, 2.f, 100.f / 255.f + 0.4f / 255.f}, 6);
+    EXPECT_EQ(UNorm8, (std::vector<Uint8>{0, 0, 128, 255, 255, 100}));
+}
+
+TEST(GraphicsAccessories_TextureDataConversion, Float16)
+{
+    EXPECT_EQ(FloatToHalfBits(0.f), 0x0000);
+    EXPECT_EQ(FloatToHalfBits(-0.f), 0x8000);
+    EXPECT_EQ(FloatToHalfBits(1.f), 0x3C00);
+    EXPECT_EQ(FloatToHalfBits(-2.f), 0xC000);
+    EXPECT_EQ(FloatToHalfBits(65504.f), 0x7BFF);
+    EXPECT_EQ(FloatToHalfBits(65520.f), 0x7C00); // Rounds to infinity
+    EXPECT_EQ(FloatToHalfBits(std::ldexp(1.f, -24)), 0x0001);
+    EXPECT_EQ(FloatToHalfBits(std::ldexp(1.f, -26)), 0x0000);
+    EXPECT_EQ(FloatToHalfBits(1.f + std::ldexp(1.f, -11)), 0x3C00); // Tie rounds to even
+    EXPECT_EQ(FloatToHalfBits(1.f + 3.f * std::ldexp(1.f, -11)), 0x3C02);
+    EXPECT_EQ(FloatToHalfBits(INFINITY), 0x7C00);
+    EXPECT_EQ(FloatToHalfBits(NAN) & 0x7C00, 0x7C00);
+    EXPECT_NE(FloatToHalfBits(NAN) & 0x03FF, 0);
+
+    // All half values survive the round trip
+    std::vector<Uint16> Halves(65536);
+    for (Uint32 i = 0; i < Halves.size(); ++i)
+        Halves[i] = static_cast<Uint16>(i);
+
+    const auto Floats = Convert<Uint16, float>(TEX_FORMAT_RGBA16_FLOAT, TEX_FORMAT_RGBA32_FLOAT, Halves, 65536 / 4);
+    EXPECT_EQ(Floats[0x3C00], 1.f);
+    EXPECT_EQ(Floats[0x0001], std::ldexp(1.f, -24));
+    EXPECT_EQ(Floats[0xFBFF], -65504.f);
+
+    const auto RoundTrip = Convert<float, Uint16>(TEX_FORMAT_RGBA32_FLOAT, TEX_FORMAT_RGBA16_FLOAT, Floats, 65536 / 4);
+    for (Uint32 i = 0; i < Halves.size(); ++i)
+    {
+        const bool IsNaN = (i & 0x7C00) == 0x7C00 && (i & 0x03FF) != 0;
+        if (IsNaN)
+        {
+            EXPECT_TRUE(std::isnan(Floats[i]));
+            EXPECT_EQ(RoundTrip[i] & 0x7C00, 0x7C00);
+            EXPECT_NE(RoundTrip[i] & 0x03FF, 0);
+        }
+        else
+        {
+            EXPECT_EQ(RoundTrip[i], Halves[i]) << "Half value 0x" << std::hex << i;
+        }
+    }
+
+    // Vectorized path matches the scalar conversion of individual values
+    std::vector<float> Values;
+    for (int e = -30; e <= 17; ++e)
+    {
+        for (float m : {1.f, 1.0004883f, 1.0009766f, 1.3333333f, 1.5f, 1.9995117f, 1.9999999f})
+        {
+            Values.push_back(std::ldexp(m, e));
+            Values.push_back(-std::ldexp(m, e));
+        }
+    }
+    const auto Converted = Convert<float, Uint16>(TEX_FORMAT_R32_FLOAT, TEX_FORMAT_R16_FLOAT, Values, static_cast<Uint32>(Values.size()));
+    for (size_t i = 0; i < Values.size(); ++i)
+        EXPECT_EQ(Converted[i], FloatToHalfBits(Values[i])) << Values[i];
+}
+
+TEST(GraphicsAccessories_TextureDataConversion, IntegerFormats)
+{
+    const auto SNorm = Convert<Int8, float>(TEX_FORMAT_R8_SNORM, TEX_FORMAT_R32_FLOAT, {-128, -127, 0, 127}, 4);
+    EXPECT_EQ(SNorm, (std::vector<float>{-1.f, -1.f, 0.f, 1.f}));
+
+    const auto UInt = Convert<float, Uint8>(TEX_FORMAT_R32_FLOAT, TEX_FORMAT_R8_UINT, {-1.f, 2.5f, 254.4f, 1000.f}, 4);
+    EXPECT_EQ(UInt, (std::vector<Uint8>{0, 3, 254, 255}));
+
+    const auto SInt = Convert<Int32, Int16>(TEX_FORMAT_R32_SINT, TEX_FORMAT_R16_SINT, {-100000, -5, 7, 100000}, 4);
+    EXPECT_EQ(SInt, (std::vector<Int16>{-32768, -5, 7, 32767}));
+
+    // Missing components are set to (0, 0, 0, 1)
+    const auto RGBA = Convert<Uint8, Uint16>(TEX_FORMAT_R8_UINT, TEX_FORMAT_RGBA16_UINT, {42}, 1);
+    EXPECT_EQ(RGBA, (std::vector<Uint16>{42, 0, 0, 1}));
+
+    const auto Alpha = Convert<Uint8, Uint8>(TEX_FORMAT_A8_UNORM, TEX_FORMAT_RGBA8_UNORM, {200}, 1);
+    EXPECT_EQ(Alpha, (std::vector<Uint8>{0, 0, 0, 200}));
+}
+
+TEST(GraphicsAccessories_TextureDataConversion, LargeIntegers)
+{
+    // Values that cannot be represented by float must be preserved exactly
+    const auto UInt = Convert<Uint32, Uint32>(TEX_FORMAT_R32_UINT, TEX_FORMAT_RG32_UINT, {0xFFFFFFFFu, 16777217u}, 2);
+    EXPECT_EQ(UInt, (std::vector<Uint32>{0xFFFFFFFFu, 0, 16777217u, 0}));
+
+    const auto UIntToRGBA = Convert<Uint32, Uint32>(TEX_FORMAT_R32_UINT, TEX_FORMAT_RGBA32_UINT, {16777217u}, 1);
+    EXPECT_EQ(UIntToRGBA, (std::vector<Uint32>{16777217u, 0, 0, 1}));
+
+    const auto SInt = Convert<Int32, Int32>(TEX_FORMAT_R32_SINT, TEX_FORMAT_RG32_SINT, {-16777217, 16777217}, 2);
+    EXPECT_EQ(SInt, (std::vector<Int32>{-16777217, 0, 16777217, 0}));
+
+    // Values are clamped to the destination range
+    const auto UIntToSInt = Convert<Uint32, Int32>(TEX_FORMAT_R32_UINT, TEX_FORMAT_R32_SINT, {0xFFFFFFFFu, 16777217u}, 2);
+    EXPECT_EQ(UIntToSInt, (std::vector<Int32>{0x7FFFFFFF, 16777217}));
+
+    const auto SIntToUInt = Convert<Int32, Uint32>(TEX_FORMAT_R32_SINT, TEX_FORMAT_R32_UINT, {-1, 16777217}, 2);
+    EXPECT_EQ(SIntToUInt, (std::vector<Uint32>{0, 16777217u}));
+
+    const auto UIntToUShort = Convert<Uint32, Uint16>(TEX_FORMAT_R32_UINT, TEX_FORMAT_R16_UINT, {0xFFFFFFFFu, 16777217u}, 2);
+    EXPECT_EQ(UIntToUShort, (std::vector<Uint16>{0xFFFF, 0xFFFF}));
+}
+
+TEST(GraphicsAccessories_TextureDataConversion, StridedRegion)
+{
+    constexpr Uint32 Width  = 19;
+    constexpr Uint32 Height = 7;
+    constexpr Uint32 Depth  = 3;
+
+    constexpr Uint32 SrcStride      = Width * 3 + 5;
+    constexpr Uint32 SrcDepthStride = SrcStride * Height + 11;
+    constexpr Uint32 DstStride      = Width * 8 + 16;
+    constexpr Uint32 DstDepthStride = DstStride * (Height + 1);
+
+    std::vector<Uint8> Src(SrcDepthStride * Depth);
+    for (size_t i = 0; i < Src.size(); ++i)
+        Src[i] = static_cast<Uint8>(i * 31);
+
+    constexpr Uint8 Padding = 0xCD;
+
+    for (Uint32 NumThreads : {1u, 4u, 100u})
+    {
+        std::vector<Uint8> Dst(DstDepthStride * Depth, Padding);
+
+        TextureDataConversionAttribs Attribs;
+        Attribs.SrcFormat         = TEX_FORMAT_RGBA8_UNORM;
+        Attribs.SrcComponentCount = 3;
+        Attribs.DstFormat         = TEX_FORMAT_RGBA16_FLOAT;
+        Attribs.pSrcData          = Src.data();
+        Attribs.SrcStride         = SrcStride;
+        Attribs.SrcDepthStride    = SrcDepthStride;
+        Attribs.pDstData          = Dst.data();
+        Attribs.DstStride         = DstStride;
+        Attribs.DstDepthStride    = DstDepthStride;
+        Attribs.Width             = Width;
+        Attribs.Height            = Height;
+        Attribs.Depth             = Depth;
+        Attribs.NumThreads        = NumThreads;
+        ASSERT_TRUE(ConvertTextureData(Attribs));
+
+        for (Uint32 z = 0; z < Depth; ++z)
+        {
+            for (Uint32 y = 0; y < Height + 1; ++y)
+            {
+                for (Uint32 x = 0; x < DstStride; ++x)
+                {
+                    const auto DstOffset = z * DstDepthStride + y * DstStride + x;
+                    if (y == Height || x >= Width * 8)
+                    {
+                        EXPECT_EQ(Dst[DstOffset], Padding);
+                        continue;
+                    }
+                    if (x % 2 != 0)
+                        continue;
+
+                    Uint16 Half = 0;
+                    memcpy(&Half, &Dst[DstOffset], sizeof(Half));
+
+                    const auto c        = (x / 2) % 4;
+                    const auto Expected = c < 3 ? static_cast<float>(Src[z * SrcDepthStride + y * SrcStride + (x / 8) * 3 + c]) * (1.f / 255.f) : 1.f;
+                    EXPECT_EQ(Half, FloatToHalfBits(Expected));
+                }
+            }
+        }
+    }
+}
+
+TEST(GraphicsAccessories_TextureDataConversion, InvalidArguments)
+{
+    Uint8 Data[16] = {};
+
+    TextureDataConversionAttribs Attribs;
+    Attribs.SrcFormat = TEX_FORMAT_BC1_UNORM;
+    Attribs.DstFormat = TEX_FORMAT_RGBA8_UNORM;
+    Attribs.pSrcData  = Data;
+    Attribs.pDstData  = Data;
+    Attribs.Width     = 1;
+    EXPECT_FALSE(ConvertTextureData(Attribs));
+
+    Attribs.SrcFormat         = TEX_FORMAT_RG8_UNORM;
+    Attribs.SrcComponentCount = 3;
+    EXPECT_FALSE(ConvertTextureData(Attribs));
+
+    Attribs.SrcComponentCount = 0;
+    Attribs.Width             = 4;
+    Attribs.SrcStride         = 4;
+    EXPECT_FALSE(ConvertTextureData(Attribs));
+}
+
+} // namespace
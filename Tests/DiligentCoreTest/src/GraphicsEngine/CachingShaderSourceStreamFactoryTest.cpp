@@ -0,0 +1,310 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CachingShaderSourceStreamFactory.hpp"
+#include "DefaultShaderSourceStreamFactory.h"
+#include "MappedFileStream.hpp"
+#include "ObjectBase.hpp"
+
+#include "TempFile.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using Diligent::Testing::TempFile;
+using Diligent::Testing::WriteFile;
+
+namespace
+{
+
+RefCntAutoPtr<ICachingShaderSourceStreamFactory> CreateCachingFactory()
+{
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pBaseFactory;
+    CreateDefaultShaderSourceStreamFactory(nullptr, &pBaseFactory);
+    VERIFY_EXPR(pBaseFactory);
+
+    RefCntAutoPtr<ICachingShaderSourceStreamFactory> pFactory;
+    CreateCachingShaderSourceStreamFactory(pBaseFactory, &pFactory);
+    return pFactory;
+}
+
+RefCntAutoPtr<IDataBlob> LoadFile(IShaderSourceInputStreamFactory* pFactory, const char* Name)
+{
+    RefCntAutoPtr<IFileStream> pStream;
+    pFactory->CreateInputStream2(Name, CREATE_SHADER_SOURCE_INPUT_STREAM_FLAG_SILENT, &pStream);
+    return pStream ? ReadFileStreamData(pStream) : RefCntAutoPtr<IDataBlob>{};
+}
+
+TEST(GraphicsEngine_CachingShaderSourceStreamFactory, SharedData)
+{
+    TempFile Shader{"CachingFactoryTest_Shared.psh", "#include \"CachingFactoryTest_Shared.fxh\"\n"};
+    TempFile Header{"CachingFactoryTest_Shared.fxh", "float4 Color;\n"};
+
+    auto pFactory = CreateCachingFactory();
+    ASSERT_TRUE(pFactory);
+
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pSourceFactory{pFactory, IID_IShaderSourceInputStreamFactory};
+    EXPECT_TRUE(pSourceFactory);
+
+    auto pShaderData = LoadFile(pFactory, "CachingFactoryTest_Shared.psh");
+    auto pHeaderData = LoadFile(pFactory, "CachingFactoryTest_Shared.fxh");
+    ASSERT_TRUE(pShaderData);
+    ASSERT_TRUE(pHeaderData);
+    ASSERT_EQ(pHeaderData->GetSize(), size_t{14});
+    EXPECT_EQ(memcmp(pHeaderData->GetConstDataPtr(), "float4 Color;\n", 14), 0);
+
+    // All streams share the same data
+    for (int i = 0; i < 3; ++i)
+    {
+        EXPECT_EQ(LoadFile(pFactory, "CachingFactoryTest_Shared.psh"), pShaderData);
+        EXPECT_EQ(LoadFile(pFactory, "CachingFactoryTest_Shared.fxh"), pHeaderData);
+    }
+
+    // Missing files are cached too
+    EXPECT_FALSE(LoadFile(pFactory, "CachingFactoryTest_Missing.fxh"));
+    EXPECT_FALSE(LoadFile(pFactory, "CachingFactoryTest_Missing.fxh"));
+
+    auto Stats = pFactory->GetStats();
+    EXPECT_EQ(Stats.Misses, Uint64{3});
+    EXPECT_EQ(Stats.Hits, Uint64{7});
+    EXPECT_EQ(Stats.NumFiles, Uint32{3});
+    EXPECT_EQ(Stats.Size, pShaderData->GetSize() + pHeaderData->GetSize());
+
+    pFactory->Clear();
+    EXPECT_EQ(pFactory->GetStats().NumFiles, Uint32{0});
+    EXPECT_NE(LoadFile(pFactory, "CachingFactoryTest_Shared.fxh"), pHeaderData);
+}
+
+TEST(GraphicsEngine_CachingShaderSourceStreamFactory, Dependencies)
+{
+    TempFile Shader{"CachingFactoryTest_Deps.psh",
+                    "#include \"CachingFactoryTest_Deps1.fxh\"\n"
+                    "  #  include <CachingFactoryTest_Deps2.fxh>\n"
+                    "// #include \"CachingFactoryTest_Commented.fxh\"\n"
+                    "#include \"./CachingFactoryTest_Deps1.fxh\"\n"
+                    "void main() {}\n"};
+    TempFile Header1{"CachingFactoryTest_Deps1.fxh", "#include \"CachingFactoryTest_Deps3.fxh\""};
+    TempFile Header2{"CachingFactoryTest_Deps2.fxh", "#include \"CachingFactoryTest_Deps1.fxh\"\n"};
+    TempFile Header3{"CachingFactoryTest_Deps3.fxh", "#define VALUE 1\n"};
+
+    auto pFactory = CreateCachingFactory();
+    ASSERT_TRUE(pFactory);
+
+    for (const char* Name : {"CachingFactoryTest_Deps.psh", "CachingFactoryTest_Deps1.fxh", "CachingFactoryTest_Deps2.fxh", "CachingFactoryTest_Deps3.fxh"})
+        EXPECT_TRUE(LoadFile(pFactory, Name));
+
+    std::vector<String> Dependencies;
+    pFactory->GetDependencies("CachingFactoryTest_Deps.psh", Dependencies);
+    const std::vector<String> RefDependencies{"CachingFactoryTest_Deps1.fxh", "CachingFactoryTest_Deps2.fxh", "CachingFactoryTest_Deps3.fxh"};
+    EXPECT_EQ(Dependencies, RefDependencies);
+
+    pFactory->GetDependencies("CachingFactoryTest_Deps3.fxh", Dependencies);
+    EXPECT_TRUE(Dependencies.empty());
+}
+
+TEST(GraphicsEngine_CachingShaderSourceStreamFactory, InvalidateModifiedFiles)
+{
+    TempFile Header1{"CachingFactoryTest_Modified.fxh", "#define VALUE 1\n"};
+    TempFile Header2{"CachingFactoryTest_Unmodified.fxh", "#define VALUE 2\n"};
+
+    auto pFactory = CreateCachingFactory();
+    ASSERT_TRUE(pFactory);
+
+    auto pModifiedData   = LoadFile(pFactory, "CachingFactoryTest_Modified.fxh");
+    auto pUnmodifiedData = LoadFile(pFactory, "CachingFactoryTest_Unmodified.fxh");
+    ASSERT_TRUE(pModifiedData);
+    ASSERT_TRUE(pUnmodifiedData);
+    EXPECT_FALSE(LoadFile(pFactory, "CachingFactoryTest_Created.fxh"));
+
+    std::vector<String> ModifiedFiles;
+    // The file that is still missing stays in the cache
+    EXPECT_EQ(pFactory->InvalidateModifiedFiles(&ModifiedFiles), Uint32{0});
+    EXPECT_TRUE(ModifiedFiles.empty());
+    EXPECT_FALSE(LoadFile(pFactory, "CachingFactoryTest_Created.fxh"));
+
+    TempFile Created{"CachingFactoryTest_Created.fxh", "#define VALUE 3\n"};
+    // The file that was missing and now exists is reported
+    EXPECT_EQ(pFactory->InvalidateModifiedFiles(&ModifiedFiles), Uint32{1});
+    ASSERT_EQ(ModifiedFiles.size(), size_t{1});
+    EXPECT_EQ(ModifiedFiles[0], "CachingFactoryTest_Created.fxh");
+    EXPECT_TRUE(LoadFile(pFactory, "CachingFactoryTest_Created.fxh"));
+    ModifiedFiles.clear();
+
+    WriteFile("CachingFactoryTest_Modified.fxh", "#define VALUE 10\n");
+    EXPECT_EQ(pFactory->InvalidateModifiedFiles(&ModifiedFiles), Uint32{1});
+    ASSERT_EQ(ModifiedFiles.size(), size_t{1});
+    EXPECT_EQ(ModifiedFiles[0], "CachingFactoryTest_Modified.fxh");
+
+    auto pNewData = LoadFile(pFactory, "CachingFactoryTest_Modified.fxh");
+    ASSERT_TRUE(pNewData);
+    ASSERT_EQ(pNewData->GetSize(), size_t{17});
+    EXPECT_EQ(memcmp(pNewData->GetConstDataPtr(), "#define VALUE 10\n", 17), 0);
+    // The data of the old version is still valid
+    EXPECT_EQ(memcmp(pModifiedData->GetConstDataPtr(), "#define VALUE 1\n", 16), 0);
+
+    EXPECT_EQ(LoadFile(pFactory, "CachingFactoryTest_Unmodified.fxh"), pUnmodifiedData);
+}
+
+// Stream that overwrites its file after the data has been read
+class ModifyingFileStream final : public ObjectBase<IFileStream>
+{
+public:
+    using TBase = ObjectBase<IFileStream>;
+
+    ModifyingFileStream(IReferenceCounters* pRefCounters, IFileStream* pStream, const String& Path) :
+        TBase{pRefCounters},
+        m_pStream{pStream},
+        m_Path{Path}
+    {}
+
+    IMPLEMENT_QUERY_INTERFACE_IN_PLACE(IID_FileStream, TBase)
+
+    virtual void DILIGENT_CALL_TYPE ReadBlob(IDataBlob* pData) override final
+    {
+        m_pStream->ReadBlob(pData);
+        WriteFile(m_Path.c_str(), "#define VALUE 100\n");
+    }
+
+    virtual bool DILIGENT_CALL_TYPE   Read(void* Data, size_t Size) override final { return m_pStream->Read(Data, Size); }
+    virtual bool DILIGENT_CALL_TYPE   Write(const void* Data, size_t Size) override final { return m_pStream->Write(Data, Size); }
+    virtual size_t DILIGENT_CALL_TYPE GetSize() override final { return m_pStream->GetSize(); }
+    virtual bool DILIGENT_CALL_TYPE   IsValid() override final { return m_pStream->IsValid(); }
+
+private:
+    RefCntAutoPtr<IFileStream> m_pStream;
+    const String               m_Path;
+};
+
+// Factory that simulates a file being modified while the caching factory reads it
+class ModifyingFileStreamFactory final : public ObjectBase<IShaderSourceFileStreamFactory>
+{
+public:
+    using TBase = ObjectBase<IShaderSourceFileStreamFactory>;
+
+    ModifyingFileStreamFactory(IReferenceCounters* pRefCounters, IShaderSourceFileStreamFactory* pBaseFactory) :
+        TBase{pRefCounters},
+        m_pBaseFactory{pBaseFactory}
+    {}
+
+    virtual void DILIGENT_CALL_TYPE QueryInterface(const INTERFACE_ID& IID, IObject** ppInterface) override final
+    {
+        if (ppInterface == nullptr)
+            return;
+
+        if (IID == IID_IShaderSourceInputStreamFactory || IID == IID_ShaderSourceFileStreamFactory)
+        {
+            *ppInterface = this;
+            (*ppInterface)->AddRef();
+        }
+        else
+        {
+            TBase::QueryInterface(IID, ppInterface);
+        }
+    }
+
+    virtual void DILIGENT_CALL_TYPE CreateInputStream(const Char* Name, IFileStream** ppStream) override final
+    {
+        CreateInputStream2(Name, CREATE_SHADER_SOURCE_INPUT_STREAM_FLAG_NONE, ppStream);
+    }
+
+    virtual void DILIGENT_CALL_TYPE CreateInputStream2(const Char* Name, CREATE_SHADER_SOURCE_INPUT_STREAM_FLAGS Flags, IFileStream** ppStream) override final
+    {
+        String FullPath;
+        CreateFileInputStream(Name, Flags, ppStream, FullPath);
+    }
+
+    virtual void DILIGENT_CALL_TYPE CreateFileInputStream(const Char* Name, CREATE_SHADER_SOURCE_INPUT_STREAM_FLAGS Flags, IFileStream** ppStream, String& FullPath) override final
+    {
+        RefCntAutoPtr<IFileStream> pStream;
+        m_pBaseFactory->CreateFileInputStream(Name, Flags, &pStream, FullPath);
+        if (pStream)
+            *ppStream = MakeNewRCObj<ModifyingFileStream>()(pStream, FullPath);
+        if (*ppStream != nullptr)
+            (*ppStream)->AddRef();
+    }
+
+private:
+    RefCntAutoPtr<IShaderSourceFileStreamFactory> m_pBaseFactory;
+};
+
+TEST(GraphicsEngine_CachingShaderSourceStreamFactory, ModifiedWhileReading)
+{
+    TempFile Header{"CachingFactoryTest_ModifiedWhileReading.fxh", "#define VALUE 1\n"};
+
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pDefaultFactory;
+    CreateDefaultShaderSourceStreamFactory(nullptr, &pDefaultFactory);
+    RefCntAutoPtr<IShaderSourceFileStreamFactory> pDefaultFileFactory{pDefaultFactory, IID_ShaderSourceFileStreamFactory};
+    ASSERT_TRUE(pDefaultFileFactory);
+
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pBaseFactory{MakeNewRCObj<ModifyingFileStreamFactory>()(pDefaultFileFactory)};
+
+    RefCntAutoPtr<ICachingShaderSourceStreamFactory> pFactory;
+    CreateCachingShaderSourceStreamFactory(pBaseFactory, &pFactory);
+    ASSERT_TRUE(pFactory);
+
+    // The data is returned, but is not cached as the file was modified while it was being read
+    auto pData = LoadFile(pFactory, "CachingFactoryTest_ModifiedWhileReading.fxh");
+    ASSERT_TRUE(pData);
+    ASSERT_EQ(pData->GetSize(), size_t{16});
+    EXPECT_EQ(memcmp(pData->GetConstDataPtr(), "#define VALUE 1\n", 16), 0);
+    EXPECT_EQ(pFactory->GetStats().NumFiles, Uint32{0});
+}
+
+TEST(GraphicsEngine_CachingShaderSourceStreamFactory, Multithreading)
+{
+    TempFile Shader{"CachingFactoryTest_MT.psh", "#include \"CachingFactoryTest_MT.fxh\"\n"};
+    TempFile Header{"CachingFactoryTest_MT.fxh", "#define VALUE 1\n"};
+
+    auto pFactory = CreateCachingFactory();
+    ASSERT_TRUE(pFactory);
+
+    std::vector<std::thread> Threads;
+    for (size_t t = 0; t < 8; ++t)
+    {
+        Threads.emplace_back([&pFactory, t]() {
+            for (size_t i = 0; i < 100; ++i)
+            {
+                EXPECT_TRUE(LoadFile(pFactory, (i + t) % 2 == 0 ? "CachingFactoryTest_MT.psh" : "CachingFactoryTest_MT.fxh"));
+                if (i % 25 == t)
+                    pFactory->Clear();
+            }
+        });
+    }
+    for (auto& Thread : Threads)
+        Thread.join();
+
+    auto Stats = pFactory->GetStats();
+    EXPECT_EQ(Stats.Hits + Stats.Misses, Uint64{800});
+}
+
+} // namespace
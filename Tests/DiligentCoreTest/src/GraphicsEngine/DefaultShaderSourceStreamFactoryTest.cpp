@@ -0,0 +1,75 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "DefaultShaderSourceStreamFactory.h"
+#include "MappedFileStream.hpp"
+
+#include "TempFile.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using Diligent::Testing::TempFile;
+
+namespace
+{
+
+TEST(GraphicsEngine_DefaultShaderSourceStreamFactory, MapFile)
+{
+    const std::string Data = "float4 Color;\n";
+    TempFile          File{"DefaultFactoryTest_MapFile.fxh", Data};
+
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pFactory;
+    CreateDefaultShaderSourceStreamFactory(nullptr, &pFactory);
+    ASSERT_TRUE(pFactory);
+
+    // Files are only mapped when explicitly requested
+    for (auto Flags : {CREATE_SHADER_SOURCE_INPUT_STREAM_FLAG_NONE, CREATE_SHADER_SOURCE_INPUT_STREAM_FLAG_MAP_FILE})
+    {
+        RefCntAutoPtr<IFileStream> pStream;
+        pFactory->CreateInputStream2("DefaultFactoryTest_MapFile.fxh", Flags, &pStream);
+        ASSERT_TRUE(pStream);
+
+        // The factory falls back to buffered reads on platforms that do not support mapping
+        RefCntAutoPtr<MappedFileStream> pMappedStream{pStream, IID_MappedFileStream};
+        if (Flags == CREATE_SHADER_SOURCE_INPUT_STREAM_FLAG_NONE)
+        {
+            EXPECT_FALSE(pMappedStream);
+        }
+
+        auto pBlob = ReadFileStreamData(pStream);
+        ASSERT_TRUE(pBlob);
+        ASSERT_EQ(pBlob->GetSize(), Data.size());
+        EXPECT_EQ(memcmp(pBlob->GetConstDataPtr(), Data.data(), Data.size()), 0);
+    }
+}
+
+} // namespace
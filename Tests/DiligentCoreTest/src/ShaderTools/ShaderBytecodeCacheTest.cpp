@@ -0,0 +1,404 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "ShaderBytecodeCache.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "DefaultShaderSourceStreamFactory.h"
+#if GLSLANG_SUPPORTED
+#    include "GLSLangUtils.hpp"
+#endif
+#if DXC_SUPPORTED
+#    include "DXCompiler.hpp"
+#endif
+
+#include "TempFile.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using Diligent::Testing::TempFile;
+using Diligent::Testing::WriteFile;
+
+namespace
+{
+
+std::string KeyToString(const ShaderBytecodeKey& Key)
+{
+    static constexpr char HexDigits[] = "0123456789abcdef";
+
+    std::string Str;
+    for (auto Byte : Key)
+    {
+        Str.push_back(HexDigits[Byte >> 4]);
+        Str.push_back(HexDigits[Byte & 0xF]);
+    }
+    return Str;
+}
+
+ShaderBytecodeKey MakeKey(Uint32 Id)
+{
+    return ShaderBytecodeKeyBuilder{}.AddString("ShaderBytecodeCacheTest").AddUint(Id).Finish();
+}
+
+std::vector<Uint32> MakeBytecode(Uint32 Id, size_t Size)
+{
+    std::vector<Uint32> Bytecode(Size);
+    for (size_t i = 0; i < Size; ++i)
+        Bytecode[i] = Id * 7919u + static_cast<Uint32>(i);
+    return Bytecode;
+}
+
+// Creates the cache in an empty directory
+std::unique_ptr<ShaderBytecodeCache> CreateEmptyCache(const char* Directory, Uint64 MaxSize = Uint64{256} << 20)
+{
+    // The cache with zero size limit removes all entries when it is created
+    ShaderBytecodeCache::CreateInfo CI;
+    CI.Directory = Directory;
+    CI.MaxSize   = 0;
+    ShaderBytecodeCache{CI};
+
+    CI.MaxSize = MaxSize;
+    return std::unique_ptr<ShaderBytecodeCache>{new ShaderBytecodeCache{CI}};
+}
+
+bool IsBytecodeEqual(IDataBlob* pBlob, const std::vector<Uint32>& Bytecode)
+{
+    return pBlob != nullptr &&
+        pBlob->GetSize() == Bytecode.size() * sizeof(Uint32) &&
+        memcmp(pBlob->GetConstDataPtr(), Bytecode.data(), pBlob->GetSize()) == 0;
+}
+
+TEST(ShaderTools_ShaderBytecodeCache, KeyBuilder)
+{
+    EXPECT_EQ(KeyToString(ShaderBytecodeKeyBuilder{}.Finish()),
+              "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    // SHA-256 of the 8-byte length followed by the string
+    EXPECT_EQ(KeyToString(ShaderBytecodeKeyBuilder{}.AddString("abc").Finish()),
+              "ce91dc5eec0139adf091900d225971d6ad246a845bad791b5693a9d0d55dd391");
+    EXPECT_EQ(KeyToString(ShaderBytecodeKeyBuilder{}.AddString(std::string(1000, 'a')).Finish()),
+              "853b74abfcd932e3e88590b70c8680d543d6dd75ee327ecd6c36ff6b406f738b");
+
+    // Values are length-prefixed
+    EXPECT_NE(ShaderBytecodeKeyBuilder{}.AddString("ab").AddString("c").Finish(),
+              ShaderBytecodeKeyBuilder{}.AddString("a").AddString("bc").Finish());
+    EXPECT_NE(ShaderBytecodeKeyBuilder{}.AddString(nullptr).Finish(),
+              ShaderBytecodeKeyBuilder{}.AddString("").Finish());
+    EXPECT_EQ(ShaderBytecodeKeyBuilder{}.AddString("main").AddUint(1).Finish(),
+              ShaderBytecodeKeyBuilder{}.AddString(std::string{"main"}).AddUint(1).Finish());
+}
+
+TEST(ShaderTools_ShaderBytecodeCache, StoreAndLoad)
+{
+    auto pCache = CreateEmptyCache("ShaderBytecodeCacheTest/StoreAndLoad");
+
+    const auto Key      = MakeKey(0);
+    const auto Bytecode = MakeBytecode(0, 1000);
+    EXPECT_EQ(pCache->Load(Key), nullptr);
+    EXPECT_TRUE(pCache->Store(Key, Bytecode.data(), Bytecode.size() * sizeof(Uint32)));
+    EXPECT_TRUE(IsBytecodeEqual(pCache->Load(Key), Bytecode));
+    EXPECT_EQ(pCache->Load(MakeKey(1)), nullptr);
+
+    // Every entry is stored with a 56-byte header
+    constexpr Uint64 EntryHeaderSize = 56;
+    EXPECT_EQ(pCache->GetStats().Size, EntryHeaderSize + Bytecode.size() * sizeof(Uint32));
+
+    // Storing an existing entry replaces it
+    const auto NewBytecode = MakeBytecode(1, 100);
+    EXPECT_TRUE(pCache->Store(Key, NewBytecode.data(), NewBytecode.size() * sizeof(Uint32)));
+    EXPECT_TRUE(IsBytecodeEqual(pCache->Load(Key), NewBytecode));
+    // The size of the replaced entry is not counted
+    EXPECT_EQ(pCache->GetStats().Size, EntryHeaderSize + NewBytecode.size() * sizeof(Uint32));
+
+    const auto Stats = pCache->GetStats();
+    EXPECT_EQ(Stats.Hits, 2u);
+    EXPECT_EQ(Stats.Misses, 2u);
+    EXPECT_EQ(Stats.Stores, 2u);
+    EXPECT_EQ(Stats.Evictions, 0u);
+
+    // Entries persist across cache instances
+    ShaderBytecodeCache::CreateInfo CI;
+    CI.Directory = pCache->GetDirectory().c_str();
+    ShaderBytecodeCache Cache2{CI};
+    EXPECT_TRUE(IsBytecodeEqual(Cache2.Load(Key), NewBytecode));
+    EXPECT_GT(Cache2.GetStats().Size, NewBytecode.size() * sizeof(Uint32));
+}
+
+TEST(ShaderTools_ShaderBytecodeCache, DamagedEntry)
+{
+    auto pCache = CreateEmptyCache("ShaderBytecodeCacheTest/DamagedEntry");
+
+    const auto Key      = MakeKey(0);
+    const auto Bytecode = MakeBytecode(0, 256);
+    ASSERT_TRUE(pCache->Store(Key, Bytecode.data(), Bytecode.size() * sizeof(Uint32)));
+
+    const auto Path = pCache->GetDirectory() + "/" + KeyToString(Key) + ".bin";
+    {
+        // Corrupt the last byte of the bytecode
+        FILE* pFile = fopen(Path.c_str(), "r+b");
+        ASSERT_NE(pFile, nullptr);
+        fseek(pFile, -1, SEEK_END);
+        fputc(0x5A, pFile);
+        fclose(pFile);
+    }
+    EXPECT_EQ(pCache->Load(Key), nullptr);
+    EXPECT_EQ(pCache->GetStats().Misses, 1u);
+
+    // The damaged entry is removed
+    FILE* pFile = fopen(Path.c_str(), "rb");
+    EXPECT_EQ(pFile, nullptr);
+    if (pFile != nullptr)
+        fclose(pFile);
+
+    // Truncated entry
+    ASSERT_TRUE(pCache->Store(Key, Bytecode.data(), Bytecode.size() * sizeof(Uint32)));
+    pFile = fopen(Path.c_str(), "wb");
+    ASSERT_NE(pFile, nullptr);
+    fputs("DSBC", pFile);
+    fclose(pFile);
+    EXPECT_EQ(pCache->Load(Key), nullptr);
+}
+
+TEST(ShaderTools_ShaderBytecodeCache, Eviction)
+{
+    constexpr size_t BytecodeSize = 1024;
+    constexpr Uint64 MaxSize      = 10 * (BytecodeSize * sizeof(Uint32) + 256);
+
+    auto pCache = CreateEmptyCache("ShaderBytecodeCacheTest/Eviction", MaxSize);
+
+    constexpr Uint32 NumEntries = 40;
+    for (Uint32 i = 0; i < NumEntries; ++i)
+    {
+        const auto Bytecode = MakeBytecode(i, BytecodeSize);
+        EXPECT_TRUE(pCache->Store(MakeKey(i), Bytecode.data(), Bytecode.size() * sizeof(Uint32)));
+        EXPECT_LE(pCache->GetStats().Size, MaxSize);
+    }
+
+    const auto Stats = pCache->GetStats();
+    EXPECT_EQ(Stats.Stores, NumEntries);
+    EXPECT_GT(Stats.Evictions, 0u);
+
+    Uint32 NumValidEntries = 0;
+    for (Uint32 i = 0; i < NumEntries; ++i)
+    {
+        if (auto pBytecode = pCache->Load(MakeKey(i)))
+        {
+            EXPECT_TRUE(IsBytecodeEqual(pBytecode, MakeBytecode(i, BytecodeSize)));
+            ++NumValidEntries;
+        }
+    }
+    EXPECT_EQ(NumValidEntries, NumEntries - Stats.Evictions);
+    EXPECT_LE(NumValidEntries, 10u);
+}
+
+TEST(ShaderTools_ShaderBytecodeCache, Multithreaded)
+{
+    auto pCache = CreateEmptyCache("ShaderBytecodeCacheTest/Multithreaded");
+
+    constexpr Uint32 NumThreads = 4;
+    constexpr Uint32 NumKeys    = 16;
+
+    std::vector<std::thread> Threads;
+    for (Uint32 t = 0; t < NumThreads; ++t)
+    {
+        Threads.emplace_back([&pCache, t]() {
+            for (Uint32 i = 0; i < NumKeys * 4; ++i)
+            {
+                const auto Id       = (i + t) % NumKeys;
+                const auto Bytecode = MakeBytecode(Id, 64 + Id);
+                if (auto pBytecode = pCache->Load(MakeKey(Id)))
+                    EXPECT_TRUE(IsBytecodeEqual(pBytecode, Bytecode));
+                else
+                    EXPECT_TRUE(pCache->Store(MakeKey(Id), Bytecode.data(), Bytecode.size() * sizeof(Uint32)));
+            }
+        });
+    }
+    for (auto& Thread : Threads)
+        Thread.join();
+
+    const auto Stats = pCache->GetStats();
+    EXPECT_EQ(Stats.Hits + Stats.Misses, NumThreads * NumKeys * 4);
+    for (Uint32 Id = 0; Id < NumKeys; ++Id)
+        EXPECT_TRUE(IsBytecodeEqual(pCache->Load(MakeKey(Id)), MakeBytecode(Id, 64 + Id)));
+}
+
+#if GLSLANG_SUPPORTED || DXC_SUPPORTED
+
+using CompileShaderFuncType = std::function<std::vector<Uint32>(ShaderBytecodeCache& Cache, IShaderSourceInputStreamFactory* pFactory)>;
+
+// Compiles the shader that includes the header twice, then edits the header and compiles the shader twice again.
+// The second compilation of every version must load the bytecode from the cache.
+void TestCompilerCache(const char*                  CacheDirectory,
+                       const char*                  HeaderName,
+                       const char*                  Header0,
+                       const char*                  Header1,
+                       const CompileShaderFuncType& CompileShader)
+{
+    auto pCache = CreateEmptyCache(CacheDirectory);
+
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pFactory;
+    CreateDefaultShaderSourceStreamFactory(nullptr, &pFactory);
+    ASSERT_TRUE(pFactory);
+
+    TempFile Header{HeaderName, Header0};
+
+    const auto Bytecode0 = CompileShader(*pCache, pFactory);
+    ASSERT_FALSE(Bytecode0.empty());
+    auto Stats = pCache->GetStats();
+    EXPECT_EQ(Stats.Hits, 0u);
+    EXPECT_EQ(Stats.Misses, 1u);
+    EXPECT_EQ(Stats.Stores, 1u);
+
+    EXPECT_EQ(CompileShader(*pCache, pFactory), Bytecode0);
+    Stats = pCache->GetStats();
+    EXPECT_EQ(Stats.Hits, 1u);
+    EXPECT_EQ(Stats.Stores, 1u);
+
+    // Editing the included file invalidates the entry
+    WriteFile(HeaderName, Header1);
+    const auto Bytecode1 = CompileShader(*pCache, pFactory);
+    ASSERT_FALSE(Bytecode1.empty());
+    EXPECT_NE(Bytecode1, Bytecode0);
+    Stats = pCache->GetStats();
+    EXPECT_EQ(Stats.Hits, 1u);
+    EXPECT_EQ(Stats.Misses, 2u);
+    EXPECT_EQ(Stats.Stores, 2u);
+
+    EXPECT_EQ(CompileShader(*pCache, pFactory), Bytecode1);
+    Stats = pCache->GetStats();
+    EXPECT_EQ(Stats.Hits, 2u);
+    EXPECT_EQ(Stats.Stores, 2u);
+}
+
+const char* const HLSLHeaderName = "ShaderBytecodeCacheTest.fxh";
+const char* const HLSLHeader0    = "#define COLOR float4(1.0, 0.0, 0.0, 1.0)\n";
+const char* const HLSLHeader1    = "#define COLOR float4(0.0, 1.0, 0.0, 1.0)\n";
+
+const char* const HLSLSource = R"(
+#include "ShaderBytecodeCacheTest.fxh"
+
+float4 main() : SV_Target
+{
+    return COLOR;
+}
+)";
+
+#if GLSLANG_SUPPORTED
+
+TEST(ShaderTools_ShaderBytecodeCache, GLSLtoSPIRV)
+{
+    static constexpr char Source[] = R"(
+#version 450
+#extension GL_GOOGLE_include_directive : enable
+#include "ShaderBytecodeCacheTest.glsl"
+
+layout(location = 0) out vec4 out_Color;
+
+void main()
+{
+    out_Color = COLOR;
+}
+)";
+
+    GLSLangUtils::InitializeGlslang();
+    TestCompilerCache("ShaderBytecodeCacheTest/GLSLtoSPIRV", "ShaderBytecodeCacheTest.glsl",
+                      "#define COLOR vec4(1.0, 0.0, 0.0, 1.0)\n",
+                      "#define COLOR vec4(0.0, 1.0, 0.0, 1.0)\n",
+                      [&](ShaderBytecodeCache& Cache, IShaderSourceInputStreamFactory* pFactory) {
+                          GLSLangUtils::GLSLtoSPIRVAttribs Attribs;
+                          Attribs.ShaderType                 = SHADER_TYPE_PIXEL;
+                          Attribs.ShaderSource               = Source;
+                          Attribs.SourceCodeLen              = static_cast<int>(sizeof(Source) - 1);
+                          Attribs.pShaderSourceStreamFactory = pFactory;
+                          Attribs.pBytecodeCache             = &Cache;
+
+                          const auto SPIRV = GLSLangUtils::GLSLtoSPIRV(Attribs);
+                          return std::vector<Uint32>{SPIRV.begin(), SPIRV.end()};
+                      });
+    GLSLangUtils::FinalizeGlslang();
+}
+
+TEST(ShaderTools_ShaderBytecodeCache, HLSLtoSPIRV)
+{
+    GLSLangUtils::InitializeGlslang();
+    TestCompilerCache("ShaderBytecodeCacheTest/HLSLtoSPIRV", HLSLHeaderName, HLSLHeader0, HLSLHeader1,
+                      [](ShaderBytecodeCache& Cache, IShaderSourceInputStreamFactory* pFactory) {
+                          ShaderCreateInfo ShaderCI;
+                          ShaderCI.Source                     = HLSLSource;
+                          ShaderCI.EntryPoint                 = "main";
+                          ShaderCI.SourceLanguage             = SHADER_SOURCE_LANGUAGE_HLSL;
+                          ShaderCI.Desc.ShaderType            = SHADER_TYPE_PIXEL;
+                          ShaderCI.Desc.Name                  = "Bytecode cache test";
+                          ShaderCI.pShaderSourceStreamFactory = pFactory;
+
+                          const auto SPIRV = GLSLangUtils::HLSLtoSPIRV(ShaderCI, nullptr, nullptr, &Cache);
+                          return std::vector<Uint32>{SPIRV.begin(), SPIRV.end()};
+                      });
+    GLSLangUtils::FinalizeGlslang();
+}
+
+#endif
+
+#if DXC_SUPPORTED
+
+TEST(ShaderTools_ShaderBytecodeCache, DXCompiler)
+{
+    auto pDXC = CreateDXCompiler(DXCompilerTarget::Vulkan, 0, nullptr);
+    if (!pDXC || !pDXC->IsLoaded())
+    {
+        GTEST_SKIP() << "DXC is not available";
+    }
+
+    TestCompilerCache("ShaderBytecodeCacheTest/DXCompiler", HLSLHeaderName, HLSLHeader0, HLSLHeader1,
+                      [&](ShaderBytecodeCache& Cache, IShaderSourceInputStreamFactory* pFactory) {
+                          ShaderCreateInfo ShaderCI;
+                          ShaderCI.Source                     = HLSLSource;
+                          ShaderCI.EntryPoint                 = "main";
+                          ShaderCI.SourceLanguage             = SHADER_SOURCE_LANGUAGE_HLSL;
+                          ShaderCI.Desc.ShaderType            = SHADER_TYPE_PIXEL;
+                          ShaderCI.Desc.Name                  = "Bytecode cache test";
+                          ShaderCI.pShaderSourceStreamFactory = pFactory;
+
+                          pDXC->SetBytecodeCache(&Cache);
+                          std::vector<Uint32> Bytecode;
+                          pDXC->Compile(ShaderCI, ShaderVersion{}, nullptr, nullptr, &Bytecode, nullptr);
+                          pDXC->SetBytecodeCache(nullptr);
+                          return Bytecode;
+                      });
+}
+
+#endif
+
+#endif
+
+} // namespace
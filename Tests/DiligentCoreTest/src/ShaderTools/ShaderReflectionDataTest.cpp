@@ -0,0 +1,270 @@
+/*
+ *  Copyright 2019-2021 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <cstring>
+#include <vector>
+
+#include "ShaderReflectionData.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+constexpr Uint64 TestBytecodeHash = 0x0123456789ABCDEFull;
+
+enum class TestEnum : Uint8
+{
+    Value0,
+    Value1
+};
+
+std::vector<Uint8> GetBlobData(IDataBlob* pBlob)
+{
+    const auto* pData = static_cast<const Uint8*>(pBlob->GetConstDataPtr());
+    return std::vector<Uint8>{pData, pData + pBlob->GetSize()};
+}
+
+ShaderReflectionDataHeader GetHeader(const std::vector<Uint8>& Data)
+{
+    ShaderReflectionDataHeader Header;
+    memcpy(&Header, Data.data(), sizeof(Header));
+    return Header;
+}
+
+void SetHeader(std::vector<Uint8>& Data, const ShaderReflectionDataHeader& Header)
+{
+    memcpy(Data.data(), &Header, sizeof(Header));
+}
+
+bool IsValidData(const std::vector<Uint8>& Data, ShaderReflectionDataType Type = ShaderReflectionDataType::SPIRV, Uint64 Hash = TestBytecodeHash)
+{
+    ShaderReflectionDataReader Reader{Data.data(), Data.size(), Type, Hash, "Test shader"};
+    return Reader.IsValid();
+}
+
+RefCntAutoPtr<IDataBlob> WriteTestData()
+{
+    ShaderReflectionDataWriter Writer;
+    Writer.Write(Uint32{0xDEADBEEF});
+    Writer.WriteString("First");
+    Writer.Write(Uint8{17});
+    Writer.Write(Uint16{0xABCD});
+    Writer.WriteString("");
+    Writer.Write(TestEnum::Value1);
+    Writer.Write(Uint64{TestBytecodeHash});
+    Writer.WriteString("Second");
+    return Writer.Finish(ShaderReflectionDataType::SPIRV, TestBytecodeHash);
+}
+
+TEST(ShaderTools_ShaderReflectionData, WriteRead)
+{
+    auto pBlob = WriteTestData();
+    ASSERT_TRUE(pBlob);
+
+    const auto Data   = GetBlobData(pBlob);
+    const auto Header = GetHeader(Data);
+    EXPECT_EQ(Header.Magic, Uint32{ShaderReflectionDataHeader::MagicValue});
+    EXPECT_EQ(Header.Version, Uint16{ShaderReflectionDataHeader::VersionValue});
+    EXPECT_EQ(Header.Type, static_cast<Uint16>(ShaderReflectionDataType::SPIRV));
+    EXPECT_EQ(Header.RecordsSize, Uint32{4 + 4 + 1 + 2 + 4 + 1 + 8 + 4});
+    EXPECT_EQ(Header.StringsSize, Uint32{sizeof("First") + sizeof("") + sizeof("Second")});
+    EXPECT_EQ(Header.BytecodeHash, TestBytecodeHash);
+    EXPECT_EQ(Data.size(), sizeof(Header) + Header.RecordsSize + Header.StringsSize);
+
+    ShaderReflectionDataReader Reader{Data.data(), Data.size(), ShaderReflectionDataType::SPIRV, TestBytecodeHash, "Test shader"};
+    ASSERT_TRUE(Reader.IsValid());
+    EXPECT_EQ(Reader.GetRemainingSize(), size_t{Header.RecordsSize});
+    EXPECT_EQ(Reader.GetStringsSize(), size_t{Header.StringsSize});
+
+    Uint32   U32       = 0;
+    Uint32   FirstStr  = 0;
+    Uint8    U8        = 0;
+    Uint16   U16       = 0;
+    Uint32   EmptyStr  = 0;
+    TestEnum Enum      = TestEnum::Value0;
+    Uint64   U64       = 0;
+    Uint32   SecondStr = 0;
+    EXPECT_TRUE(Reader.Read(U32));
+    EXPECT_TRUE(Reader.ReadString(FirstStr));
+    EXPECT_TRUE(Reader.Read(U8));
+    EXPECT_TRUE(Reader.Read(U16));
+    EXPECT_TRUE(Reader.ReadString(EmptyStr));
+    EXPECT_TRUE(Reader.Read(Enum));
+    EXPECT_TRUE(Reader.Read(U64));
+    EXPECT_TRUE(Reader.ReadString(SecondStr));
+    EXPECT_TRUE(Reader.IsValid());
+    EXPECT_EQ(Reader.GetRemainingSize(), size_t{0});
+
+    EXPECT_EQ(U32, Uint32{0xDEADBEEF});
+    EXPECT_EQ(U8, Uint8{17});
+    EXPECT_EQ(U16, Uint16{0xABCD});
+    EXPECT_EQ(Enum, TestEnum::Value1);
+    EXPECT_EQ(U64, TestBytecodeHash);
+    EXPECT_STREQ(Reader.GetStrings() + FirstStr, "First");
+    EXPECT_STREQ(Reader.GetStrings() + EmptyStr, "");
+    EXPECT_STREQ(Reader.GetStrings() + SecondStr, "Second");
+
+    // Reading past the end of the records invalidates the reader
+    Uint8 Extra = 0;
+    EXPECT_FALSE(Reader.Read(Extra));
+    EXPECT_FALSE(Reader.IsValid());
+    EXPECT_EQ(Reader.GetRemainingSize(), size_t{0});
+}
+
+TEST(ShaderTools_ShaderReflectionData, EmptyData)
+{
+    ShaderReflectionDataWriter Writer;
+
+    auto pBlob = Writer.Finish(ShaderReflectionDataType::GL, TestBytecodeHash);
+    ASSERT_TRUE(pBlob);
+    EXPECT_EQ(pBlob->GetSize(), sizeof(ShaderReflectionDataHeader));
+
+    const auto                 Data = GetBlobData(pBlob);
+    ShaderReflectionDataReader Reader{Data.data(), Data.size(), ShaderReflectionDataType::GL, TestBytecodeHash, "Test shader"};
+    EXPECT_TRUE(Reader.IsValid());
+    EXPECT_EQ(Reader.GetRemainingSize(), size_t{0});
+    EXPECT_EQ(Reader.GetStringsSize(), size_t{0});
+
+    Uint32 Value = 0;
+    EXPECT_FALSE(Reader.Read(Value));
+    EXPECT_FALSE(Reader.IsValid());
+}
+
+TEST(ShaderTools_ShaderReflectionData, InvalidData)
+{
+    const auto Data = GetBlobData(WriteTestData());
+    ASSERT_TRUE(IsValidData(Data));
+
+    {
+        ShaderReflectionDataReader Reader{nullptr, Data.size(), ShaderReflectionDataType::SPIRV, TestBytecodeHash, "Test shader"};
+        EXPECT_FALSE(Reader.IsValid());
+    }
+
+    // Truncated data
+    for (size_t Size = 0; Size < Data.size(); ++Size)
+    {
+        std::vector<Uint8> Truncated{Data.begin(), Data.begin() + Size};
+        EXPECT_FALSE(IsValidData(Truncated)) << "Size: " << Size;
+    }
+
+    // Trailing data
+    {
+        auto Extended = Data;
+        Extended.push_back(0);
+        EXPECT_FALSE(IsValidData(Extended));
+    }
+
+    // Wrong magic
+    {
+        auto Damaged = Data;
+        auto Header  = GetHeader(Damaged);
+        Header.Magic ^= 1;
+        SetHeader(Damaged, Header);
+        EXPECT_FALSE(IsValidData(Damaged));
+    }
+
+    // Wrong version
+    {
+        auto Damaged   = Data;
+        auto Header    = GetHeader(Damaged);
+        Header.Version = ShaderReflectionDataHeader::VersionValue + 1;
+        SetHeader(Damaged, Header);
+        EXPECT_FALSE(IsValidData(Damaged));
+    }
+
+    // Wrong type
+    EXPECT_FALSE(IsValidData(Data, ShaderReflectionDataType::GL));
+
+    // Wrong bytecode hash
+    EXPECT_FALSE(IsValidData(Data, ShaderReflectionDataType::SPIRV, TestBytecodeHash + 1));
+
+    // Records and strings sizes that do not match the data size
+    {
+        auto Damaged = Data;
+        auto Header  = GetHeader(Damaged);
+        Header.RecordsSize += 1;
+        SetHeader(Damaged, Header);
+        EXPECT_FALSE(IsValidData(Damaged));
+
+        Header = GetHeader(Data);
+        Header.StringsSize -= 1;
+        SetHeader(Damaged, Header);
+        EXPECT_FALSE(IsValidData(Damaged));
+    }
+
+    // Unterminated string table
+    {
+        auto Damaged = Data;
+        Damaged.back() = 'x';
+        EXPECT_FALSE(IsValidData(Damaged));
+    }
+}
+
+TEST(ShaderTools_ShaderReflectionData, StringOffsetOutOfRange)
+{
+    ShaderReflectionDataWriter Writer;
+    Writer.WriteString("Name");
+    // Offset that points right past the end of the string table
+    Writer.Write(Uint32{sizeof("Name")});
+    Writer.Write(Uint32{0xFFFFFFFFu});
+
+    const auto Data = GetBlobData(Writer.Finish(ShaderReflectionDataType::SPIRV, TestBytecodeHash));
+
+    {
+        ShaderReflectionDataReader Reader{Data.data(), Data.size(), ShaderReflectionDataType::SPIRV, TestBytecodeHash, "Test shader"};
+        ASSERT_TRUE(Reader.IsValid());
+
+        Uint32 Offset = 0;
+        EXPECT_TRUE(Reader.ReadString(Offset));
+        EXPECT_EQ(Offset, Uint32{0});
+
+        EXPECT_FALSE(Reader.ReadString(Offset));
+        EXPECT_FALSE(Reader.IsValid());
+
+        // The reader stays invalid even though there is data left
+        EXPECT_FALSE(Reader.ReadString(Offset));
+        Uint32 Value = 0;
+        EXPECT_FALSE(Reader.Read(Value));
+    }
+
+    {
+        ShaderReflectionDataReader Reader{Data.data(), Data.size(), ShaderReflectionDataType::SPIRV, TestBytecodeHash, "Test shader"};
+
+        Uint32 Value = 0;
+        EXPECT_TRUE(Reader.Read(Value));
+        EXPECT_TRUE(Reader.Read(Value));
+
+        Uint32 Offset = 0;
+        EXPECT_FALSE(Reader.ReadString(Offset));
+        EXPECT_FALSE(Reader.IsValid());
+    }
+}
+
+} // namespace